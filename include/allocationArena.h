@@ -0,0 +1,105 @@
+#ifndef _ALLOCATION_ARENA_H
+#define _ALLOCATION_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+using namespace std;
+
+#ifndef _WIN32
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wpadded"
+#endif /* _WIN32 */
+
+namespace testing
+{
+
+/** AllocationArena の統計。 */
+struct AllocationArenaStats
+{
+    uint64_t allocations = 0;   ///< reset() 以降の確保回数
+    uint64_t bytes = 0;         ///< reset() 以降に確保したバイト数 (ヘッダーを除く)
+    uint64_t chunks = 0;        ///< 使用中のチャンク数 (reset() 後も保持中のものを除く)
+    uint64_t resets = 0;        ///< reset() の呼び出し回数
+    uint64_t quarantined = 0;   ///< reset() 後にアクセス不可として保持しているチャンク数
+    uint64_t invalid_frees = 0; ///< reset() 後または二重の free / realloc の回数
+};
+
+/** reset() で解放した領域の扱い。 */
+enum AllocationArenaResetMode
+{
+    ARENA_RESET_QUARANTINE, ///< アクセス不可にする (reset() 後の使用を検出する)
+    ARENA_RESET_RECYCLE     ///< 以降の確保に再利用する (ページ フォールトが減る。reset() 後の使用は検出しない)
+};
+
+struct AllocationArenaState;
+
+/**
+ * mock_malloc / mock_calloc / mock_realloc の確保先をテスト用の領域に切り替える。
+ * 確保はチャンクの先頭から順に切り出すのみで、free は記録のみ行い領域を再利用しない。
+ * reset() で全体をまとめて解放する。ARENA_RESET_QUARANTINE では解放した領域をアクセス不可にするため、
+ * reset() 後の使用は SIGSEGV (Windows はアクセス違反) で、reset() 後の free / realloc は失敗として検出する。
+ * 生存期間中のみ有効で、同時に生成できるのは 1 個のみ。Mock_stdlib で malloc 等を設定した場合はそちらを優先する。
+ * 破棄後に領域を free してはならない (領域を返却済みのため)。
+ *
+ * 使用例:
+ *   class ParserTest : public Test
+ *   {
+ *     protected:
+ *       void TearDown() override
+ *       {
+ *           allocation_arena.reset();
+ *       }
+ *
+ *       AllocationArena allocation_arena;
+ *   };
+ */
+class AllocationArena
+{
+  public:
+    /** 既定のチャンク サイズ。これより大きい確保は専用のチャンクを使用する。 */
+    static constexpr size_t DEFAULT_CHUNK_SIZE = 1024 * 1024;
+
+    explicit AllocationArena(size_t chunk_size = DEFAULT_CHUNK_SIZE,
+                             AllocationArenaResetMode reset_mode = ARENA_RESET_QUARANTINE);
+    ~AllocationArena();
+
+    AllocationArena(const AllocationArena &) = delete;
+    AllocationArena &operator=(const AllocationArena &) = delete;
+
+    /** 確保した領域をすべて解放し、reset_mode に従ってアクセス不可にするか再利用する。 */
+    void reset();
+
+    AllocationArenaStats stats() const;
+
+  private:
+    unique_ptr<AllocationArenaState> state_;
+};
+
+/**
+ * 各テストの実行中 (SetUp から TearDown まで) の確保先を AllocationArena とし、
+ * テストの終了時に reset() する Google Test のイベント リスナーを登録する。RUN_ALL_TESTS() の前に呼び出す。
+ * テスト間 (SetUpTestSuite 等) の確保は本物の malloc を使用する。
+ */
+extern void installAllocationArenaListener(size_t chunk_size = AllocationArena::DEFAULT_CHUNK_SIZE,
+                                           AllocationArenaResetMode reset_mode = ARENA_RESET_QUARANTINE);
+
+/**
+ * mock 関数本体から呼び出す。AllocationArena が無い場合は atomic ロード 1 回のみで false を返す。
+ * allocateFromArena / callocFromArena: 確保した場合は true を返す。
+ * reallocateFromArena: ptr が NULL または AllocationArena の領域の場合に処理して true を返す。
+ * freeToArena: ptr が AllocationArena の領域の場合に処理して true を返す。
+ */
+extern bool allocateFromArena(size_t size, void **allocated);
+extern bool callocFromArena(size_t nmemb, size_t size, void **allocated);
+extern bool reallocateFromArena(void *ptr, size_t size, void **allocated);
+extern bool freeToArena(void *ptr);
+
+} // namespace testing
+
+#ifndef _WIN32
+    #pragma GCC diagnostic pop
+#endif /* _WIN32 */
+
+#endif // _ALLOCATION_ARENA_H
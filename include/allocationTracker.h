@@ -0,0 +1,140 @@
+#ifndef _ALLOCATION_TRACKER_H
+#define _ALLOCATION_TRACKER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+#ifndef _WIN32
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wpadded"
+#endif /* _WIN32 */
+
+namespace testing
+{
+
+/** mock_malloc / mock_calloc / mock_realloc / mock_strdup で確保したメモリーの集計。 */
+struct AllocationStats
+{
+    uint64_t allocations = 0;      ///< 確保回数 (realloc を含む)
+    uint64_t frees = 0;            ///< 解放回数 (追跡中のメモリーのみ)
+    uint64_t allocated_bytes = 0;  ///< 確保したバイト数の合計
+    uint64_t live_allocations = 0; ///< 未解放の確保数
+    uint64_t live_bytes = 0;       ///< 未解放のバイト数
+    uint64_t peak_bytes = 0;       ///< resetAllocationPeak() 以降の未解放バイト数の最大値
+};
+
+/** 確保元 (ファイル, 行, 呼び出し元関数) ごとの集計。 */
+struct AllocationSiteStats
+{
+    string file;                   ///< 確保元ファイル
+    int line = 0;                  ///< 確保元行番号
+    string caller;                 ///< 確保元関数
+    uint64_t allocations = 0;      ///< 確保回数
+    uint64_t allocated_bytes = 0;  ///< 確保したバイト数の合計
+    uint64_t live_allocations = 0; ///< 未解放の確保数
+    uint64_t live_bytes = 0;       ///< 未解放のバイト数
+};
+
+/** 未解放のメモリー。 */
+struct LiveAllocation
+{
+    const void *ptr;   ///< アドレス
+    size_t size;       ///< 要求サイズ
+    string file;       ///< 確保元ファイル
+    int line;          ///< 確保元行番号
+    string caller;     ///< 確保元関数
+    uint64_t sequence; ///< 確保の通し番号 (getAllocationSequence() と比較する)
+};
+
+/** リスナーが検出した問題の扱い。 */
+enum AllocationCheckAction
+{
+    ALLOCATION_CHECK_IGNORE, ///< 何もしない
+    ALLOCATION_CHECK_WARN,   ///< 警告を出力する
+    ALLOCATION_CHECK_FAIL    ///< テストを失敗させる
+};
+
+/** installAllocationTrackerListener() の設定。 */
+struct AllocationCheckOptions
+{
+    AllocationCheckAction leak_action = ALLOCATION_CHECK_FAIL; ///< テスト中に確保して未解放のメモリーがある場合
+    uint64_t peak_limit_bytes = 0;                             ///< テスト中の未解放バイト数の増分の上限 (0 は確認しない)
+    AllocationCheckAction peak_action = ALLOCATION_CHECK_FAIL; ///< peak_limit_bytes を超えた場合
+    size_t max_reported = 10;                                  ///< 報告する確保元の最大数
+};
+
+/**
+ * メモリー確保の追跡を有効/無効にする (既定は無効)。
+ * 無効の間、mock 関数での追加コストは有効判定の読み込み 1 回のみ。
+ * 有効にする前に確保したメモリーの解放は無視する。
+ */
+extern void setAllocationTrackingEnabled(bool enabled);
+extern bool isAllocationTrackingEnabled();
+
+/** 追跡中の集計を返す。 */
+extern AllocationStats getAllocationStats();
+
+/** 確保元ごとの集計を、確保したバイト数の降順で返す。 */
+extern vector<AllocationSiteStats> getAllocationSites();
+
+/** 通し番号が since_sequence 以上の未解放メモリーを、確保順で返す。 */
+extern vector<LiveAllocation> getLiveAllocations(uint64_t since_sequence = 0);
+
+/** 次に確保するメモリーの通し番号。テスト開始時に保存し、getLiveAllocations() に渡す。 */
+extern uint64_t getAllocationSequence();
+
+/** ピークを現在の未解放バイト数に戻す。 */
+extern void resetAllocationPeak();
+
+/** 追跡中の情報をすべて破棄する (破棄したメモリーの解放は以後無視する)。 */
+extern void clearAllocationTracking();
+
+/** 未解放メモリーを確保元ごとにまとめて出力する。 */
+extern void printLiveAllocations(FILE *out = stdout, uint64_t since_sequence = 0, size_t max_reported = 10);
+
+/**
+ * 追跡を有効にし、各テストの終了時にリークとピークを確認する
+ * Google Test のイベント リスナーを登録する。RUN_ALL_TESTS() の前に呼び出す。
+ */
+extern void installAllocationTrackerListener(const AllocationCheckOptions &options = AllocationCheckOptions());
+
+/**
+ * mock 関数本体から呼び出す。追跡が無効の場合は何もしない。
+ * trackAllocation: 確保したメモリーを記録する (ptr が NULL の場合は何もしない)。
+ *                  追跡の有無に関わらず、現在のスレッドの AllocationBudget にも数える。
+ * trackFree: 解放前に呼び出し、記録を削除する。
+ */
+extern void trackAllocation(const void *ptr, size_t size, const char *file, int line, const char *caller);
+extern void trackFree(const void *ptr);
+
+/**
+ * mock_realloc 本体から呼び出す。
+ * 委譲前に beginTrackReallocation で元の記録を取り出し (解放されたアドレスを別スレッドが再取得しても競合しないため)、
+ * 委譲後に endTrackReallocation で結果に応じて新しい記録の追加または元の記録の復元を行う。
+ */
+struct TrackedReallocation
+{
+    const void *ptr = nullptr;
+    size_t size = 0;
+    const char *file = nullptr;
+    int line = 0;
+    const char *caller = nullptr;
+    uint64_t sequence = 0;
+    bool tracked = false;
+};
+extern TrackedReallocation beginTrackReallocation(const void *ptr);
+extern void endTrackReallocation(const TrackedReallocation &previous, const void *new_ptr, size_t size,
+                                 const char *file, int line, const char *caller);
+
+} // namespace testing
+
+#ifndef _WIN32
+    #pragma GCC diagnostic pop
+#endif /* _WIN32 */
+
+#endif // _ALLOCATION_TRACKER_H
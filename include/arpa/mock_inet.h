@@ -31,6 +31,7 @@ extern "C"
         #pragma GCC diagnostic push
         #pragma GCC diagnostic ignored "-Wpadded"
         #include <gmock/gmock.h>
+        #include <mock_instance.h>
         #pragma GCC diagnostic pop
 
 extern int delegate_real_inet_pton(const char *, const int, const char *, int, const char *, void *);
@@ -46,7 +47,7 @@ class Mock_arpa_inet
     ~Mock_arpa_inet();
 };
 
-extern Mock_arpa_inet *_mock_arpa_inet;
+extern testfw::MockSlot<Mock_arpa_inet> _mock_arpa_inet;
 
     #endif // _IN_OVERRIDE_HEADER_ARPA_INET_H
 
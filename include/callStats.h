@@ -0,0 +1,119 @@
+#ifndef _CALL_STATS_H
+#define _CALL_STATS_H
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+#ifndef _WIN32
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wpadded"
+#endif /* _WIN32 */
+
+namespace testing
+{
+
+/** レイテンシ ヒストグラムのバケット数。バケット i は [2^i, 2^(i+1)) ns (バケット 0 は 0 ns を含む)。 */
+constexpr size_t CALL_STATS_HISTOGRAM_BUCKETS = 40;
+
+/** mock 関数の呼び出し元 (関数名, ファイル, 行, 呼び出し元関数) ごとの統計。 */
+struct CallSiteStats
+{
+    string function;                                       ///< mock 対象の関数名 ("read" 等)
+    string file;                                           ///< 呼び出し元ファイル
+    int line = 0;                                          ///< 呼び出し元行番号
+    string caller;                                         ///< 呼び出し元関数
+    uint64_t calls = 0;                                    ///< 呼び出し回数
+    uint64_t errors = 0;                                   ///< エラーを返した回数
+    uint64_t total_ns = 0;                                 ///< 呼び出しの合計時間 (ns)
+    uint64_t max_ns = 0;                                   ///< 呼び出しの最大時間 (ns)
+    uint64_t histogram[CALL_STATS_HISTOGRAM_BUCKETS] = {}; ///< 呼び出し時間の log2 ヒストグラム
+
+    /** ヒストグラムから求めた q 分位点 (0.0 - 1.0) の上限値 (ns) */
+    uint64_t percentileNs(double q) const;
+};
+
+/**
+ * mock 関数での呼び出し統計の収集を有効/無効にする (既定は無効)。
+ * 無効の間、mock 関数での追加コストは有効判定の読み込み 1 回のみ。
+ */
+extern void setCallStatsEnabled(bool enabled);
+extern bool isCallStatsEnabled();
+
+/**
+ * 収集した統計をスレッドごとのシャードから集計して返す。合計時間の降順。
+ * function_name を指定した場合はその関数の呼び出し元のみを返す。
+ */
+extern vector<CallSiteStats> getCallStats(const string &function_name = "");
+
+/** 収集した統計を破棄する。 */
+extern void resetCallStats();
+
+/** 合計時間の上位 top_n 件の呼び出し元を表形式で出力する。 */
+extern void printCallStats(FILE *out = stdout, size_t top_n = 20);
+
+/**
+ * 統計の収集を有効にし、テスト プログラムの終了時に printCallStats を出力する
+ * Google Test のイベント リスナーを登録する。RUN_ALL_TESTS() の前に呼び出す。
+ */
+extern void installCallStatsListener(size_t top_n = 20);
+
+/** mock 関数本体から呼び出す。統計の 1 件を呼び出し元スレッドのシャードへ記録する。 */
+extern void recordCallStats(const char *function_name, const char *file, int line, const char *caller,
+                            uint64_t elapsed_ns, bool is_error);
+
+/**
+ * mock 関数本体で、委譲先の呼び出し時間を計測する。
+ * 統計が無効の場合は時刻を取得しない。
+ *
+ * 使用例:
+ *   CallStatsTimer call_stats("read", file, line, func);
+ *   mock_ret = ...;
+ *   call_stats.finish(mock_ret == -1);
+ */
+class CallStatsTimer
+{
+  public:
+    CallStatsTimer(const char *function_name, const char *file, int line, const char *caller)
+        : function_name_(function_name), file_(file), line_(line), caller_(caller), enabled_(isCallStatsEnabled())
+    {
+        if (enabled_)
+        {
+            start_ = chrono::steady_clock::now();
+        }
+    }
+
+    CallStatsTimer(const CallStatsTimer &) = delete;
+    CallStatsTimer &operator=(const CallStatsTimer &) = delete;
+
+    void finish(bool is_error)
+    {
+        if (!enabled_)
+        {
+            return;
+        }
+        enabled_ = false;
+        const auto elapsed = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start_);
+        recordCallStats(function_name_, file_, line_, caller_, (uint64_t)elapsed.count(), is_error);
+    }
+
+  private:
+    const char *function_name_;
+    const char *file_;
+    int line_;
+    const char *caller_;
+    bool enabled_;
+    chrono::steady_clock::time_point start_;
+};
+
+} // namespace testing
+
+#ifndef _WIN32
+    #pragma GCC diagnostic pop
+#endif /* _WIN32 */
+
+#endif // _CALL_STATS_H
@@ -1,6 +1,7 @@
 #ifndef _EXPORT_CHECK_H
 #define _EXPORT_CHECK_H
 
+#include <cstdint>
 #include <map>
 #include <set>
 #include <string>
@@ -9,9 +10,30 @@
 
 using namespace std;
 
+#ifndef _WIN32
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wpadded"
+#endif /* _WIN32 */
+
 namespace testing
 {
 
+/**
+ * エクスポート シンボルの詳細 (getActualExportNames の details 出力の要素)。
+ * Linux では ELF の動的シンボル表から取得した値を格納する。
+ * Windows (dumpbin /exports) では name のみを格納し、その他は空文字列・0 とする。
+ */
+struct ExportSymbolInfo
+{
+    string name;                  ///< シンボル名 (バージョン接尾辞なし)
+    string type;                  ///< 種別 ("FUNC" / "OBJECT" / "TLS" / "IFUNC" / "NOTYPE" 等)
+    string binding;               ///< バインディング ("GLOBAL" / "WEAK" / "UNIQUE" / "LOCAL")
+    string visibility;            ///< 可視性 ("DEFAULT" / "PROTECTED" 等)
+    uint64_t size = 0;            ///< シンボルのサイズ (バイト)
+    string version;               ///< シンボル バージョン名 (バージョン定義がない場合は空)
+    bool default_version = false; ///< 既定バージョン (nm の "@@") か
+};
+
 /**
  * EXPORT_ENTRY マクロ テーブルのエントリからシグネチャの static_assert を生成する。
  * GetProcAddress/dlsym 等でアドレスを取得するのではなく、公開ヘッダーの宣言が
@@ -40,13 +62,20 @@ extern string joinNames(const vector<string> &names);
 /**
  * 実際にビルドされた DLL (Windows) / SO (Linux) から、エクスポートされている
  * シンボル名の一覧を取得する。
- * Windows では dumpbin /exports、Linux では nm -D --defined-only を内部で実行する。
+ * Windows では dumpbin /exports を内部で実行する。
+ * Linux では SO を mmap し、ELF の動的シンボル表 (.dynsym / .dynstr、セクション ヘッダーが
+ * ない場合は PT_DYNAMIC と DT_GNU_HASH / DT_HASH) をプロセス内で直接走査する。
+ * 結果は nm -D --defined-only --without-symbol-versions と同じ集合となる。
+ * シンボル名にはバージョンの接尾辞 ("@@VER" / "@VER") を付けないため (nm -D の既定の出力とは異なる)、
+ * 複数のバージョンを定義したシンボルも 1 個の名前となる。バージョンは details の version / default_version で確認する。
  * プラットフォーム分岐はこの関数の内部に閉じ込められており、呼び出し側で
  * #if defined(PLATFORM_WINDOWS) 等を書く必要はない。
  *
  * @param dll_or_so_path  検査対象の DLL/SO の絶対パス
+ * @param details         nullptr 以外を渡すと、シンボルごとの種別・バインディング・可視性・
+ *                        サイズ・バージョンを格納する (Windows では名前のみ)。
  */
-extern set<string> getActualExportNames(const string &dll_or_so_path);
+extern set<string> getActualExportNames(const string &dll_or_so_path, vector<ExportSymbolInfo> *details = nullptr);
 
 /**
  * 期待シンボル名一覧 (EXPORT_ENTRY マクロ テーブルから生成) と、実際のエクスポート一覧を突き合わせる。
@@ -62,12 +91,58 @@ extern set<string> getActualExportNames(const string &dll_or_so_path);
 extern void expectExportNamesMatch(const set<string> &expected, const set<string> &actual,
                                    const map<string, string> &signatures = {});
 
+/** verifyExportNames / expectAllExportNamesMatch の検査対象 (DLL/SO と期待シンボル名の組) */
+struct ExportCheckTarget
+{
+    string dll_or_so_path;          ///< 検査対象の DLL/SO の絶対パス
+    set<string> expected;           ///< 期待シンボル名 (EXPORT_ENTRY マクロ テーブルから生成)
+    map<string, string> signatures; ///< 省略可。名前 → シグネチャ文字列 (不足の報告に併記する)
+};
+
+/** verifyExportNames の検査結果 (targets と同じ順序で返る) */
+struct ExportCheckResult
+{
+    string dll_or_so_path;   ///< 検査対象の DLL/SO のパス
+    bool ok = false;         ///< 読み取りに成功し、過不足がない
+    vector<string> missing;  ///< 不足しているエクスポート (シグネチャがあれば "名前 [シグネチャ]")
+    vector<string> extra;    ///< 想定外のエクスポート
+    string diagnostic;       ///< 読み取りに失敗した場合の理由
+    size_t actual_count = 0; ///< 実際のシンボル数 (リンカー合成シンボルを除く)
+    bool cache_hit = false;  ///< エクスポート表のキャッシュを利用したか
+};
+
+/**
+ * 複数の DLL/SO のエクスポートを、スレッド プールで並列に検査する。
+ * 判定条件は expectExportNamesMatch と同じ (リンカー合成シンボルを除いた過不足なしの完全一致)。
+ * 読み取ったエクスポート表はプロセス内でキャッシュし、(パス, デバイス, i-node, サイズ, 更新日時) が
+ * 一致する間はファイルを開かずに再利用する。一致しない場合は Linux の NT_GNU_BUILD_ID を読み取り、
+ * サイズとビルド ID が一致すれば (内容が同じまま再生成された SO) 再読み取りしない。
+ * stdout への出力や gtest への失敗報告は行わない。
+ *
+ * @param targets      検査対象の一覧
+ * @param max_threads  ワーカー スレッド数の上限 (0 の場合は std::thread::hardware_concurrency())
+ */
+extern vector<ExportCheckResult> verifyExportNames(const vector<ExportCheckTarget> &targets, size_t max_threads = 0);
+
+/**
+ * verifyExportNames で検査し、不一致のある DLL/SO ごとに EXPECT_TRUE で報告する。
+ * 1 シンボル 1 行の出力は行わず、すべて一致した場合はサマリー 1 行、
+ * 不一致がある場合は該当 DLL/SO の不足・想定外のみを出力する。
+ */
+extern void expectAllExportNamesMatch(const vector<ExportCheckTarget> &targets, size_t max_threads = 0);
+
+/** verifyExportNames のエクスポート表キャッシュを破棄する。 */
+extern void clearExportNamesCache();
+
 /**
  * include_dir 配下のヘッダー (*.h) から、export_macro_name を伴わない
  * 「extern <型> <名前>;」形式のファイル スコープ変数宣言を検出する。
- * 関数宣言 ('(' を含む行) と extern "C" ブロックの開始行は対象外とする。
+ * ヘッダーは行単位ではなく宣言単位で字句解析するため、複数行にまたがる宣言も検出し、
+ * コメント・文字列リテラル・プリプロセッサ行の中の extern は無視する。
+ * 関数宣言 ('(' を含む宣言) と extern "C" 宣言は対象外とする。
  * テンプレートやマクロ展開後にしか判定できない宣言のように、複雑なものは対象外とする
  * (誤検出より見逃しを許容する)。
+ * ヘッダーは並列に走査するが、結果はパスの辞書順で返す。
  *
  * static 専用ライブラリ (DLL/SO を生成しない include サブツリー) には export マクロが
  * そもそも不要なため、呼び出し側は DLL/SO エクスポートに対応する include サブディレクトリ
@@ -94,4 +169,8 @@ extern string identManifestSymbolName(const string &target);
 
 } // namespace testing
 
+#ifndef _WIN32
+    #pragma GCC diagnostic pop
+#endif /* _WIN32 */
+
 #endif // _EXPORT_CHECK_H
@@ -0,0 +1,205 @@
+#ifndef TESTFW_FAKE_FUNCTION_H
+#define TESTFW_FAKE_FUNCTION_H
+
+#include <mock_instance.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifndef _WIN32
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wpadded"
+#endif /* _WIN32 */
+
+namespace testfw
+{
+
+/** FakeDispatch が記録した 1 回分の呼び出し。 */
+template <typename... Args> struct FakeCall
+{
+    const char *file;                       ///< 呼び出し元ファイル
+    int line;                               ///< 呼び出し元行番号
+    const char *func;                       ///< 呼び出し元関数
+    std::tuple<std::decay_t<Args>...> args; ///< 引数 (ポインターはアドレスのみ)
+};
+
+template <typename Signature> class FakeDispatch;
+
+/**
+ * gmock を経由しない fake の呼び出し先。関数ポインターまたはラムダ式へ直接委譲する。
+ * 呼び出し回数を計数し、記録数を指定した場合は生成時に確保した領域へ呼び出しを記録する
+ * (呼び出し時のメモリー確保・ロックはない)。
+ * 期待値の検証が必要な関数は Mock_<lib> を、大量に呼ばれる関数の差し替えのみが必要な場合は
+ * Fake_<func> (FakeFunction) を使用する。
+ */
+template <typename R, typename... Args> class FakeDispatch<R(Args...)>
+{
+  public:
+    using Function = R (*)(Args...);
+    using Call = FakeCall<Args...>;
+
+    FakeDispatch(const FakeDispatch &) = delete;
+    FakeDispatch &operator=(const FakeDispatch &) = delete;
+
+    /**
+     * 関数ポインターを差し替える。呼び出し中の他スレッドとは atomic に切り替わる。
+     * nullptr を指定した場合は、生成時に指定した関数ポインターまたはラムダ式へ戻す。
+     */
+    void setFunction(Function function)
+    {
+        function_.store(function, std::memory_order_release);
+    }
+
+    /** fake が呼び出された回数 */
+    std::uint64_t callCount() const
+    {
+        return call_count_.load(std::memory_order_relaxed);
+    }
+
+    /** 記録領域が不足して記録できなかった呼び出しの回数 */
+    std::uint64_t droppedCount() const
+    {
+        const std::uint64_t count = callCount();
+        return count > record_capacity_ ? count - record_capacity_ : 0U;
+    }
+
+    /**
+     * 記録した呼び出し (呼び出し順)。
+     * fake を呼び出すスレッドがすべて停止 (join 等) してから参照すること。
+     */
+    std::vector<Call> calls() const
+    {
+        const std::uint64_t count = std::min<std::uint64_t>(next_record_.load(std::memory_order_acquire),
+                                                            record_capacity_);
+        return std::vector<Call>(records_.get(), records_.get() + count);
+    }
+
+    /** 呼び出し回数と記録を破棄する。 */
+    void clearCalls()
+    {
+        call_count_.store(0U, std::memory_order_relaxed);
+        next_record_.store(0U, std::memory_order_release);
+    }
+
+    /** mock 関数本体から呼び出す。 */
+    R call(const char *file, int line, const char *func, Args... args)
+    {
+        call_count_.fetch_add(1U, std::memory_order_relaxed);
+        if (record_capacity_ != 0U)
+        {
+            const std::uint64_t index = next_record_.fetch_add(1U, std::memory_order_acq_rel);
+            if (index < record_capacity_)
+            {
+                records_[index] = Call{file, line, func, std::make_tuple(args...)};
+            }
+        }
+
+        Function function = function_.load(std::memory_order_acquire);
+        if (function != nullptr)
+        {
+            return function(args...);
+        }
+        return callable_(args...);
+    }
+
+  protected:
+    FakeDispatch(Function function, std::size_t record_capacity)
+        : function_(function), callable_(function), record_capacity_(record_capacity),
+          records_(makeRecords(record_capacity))
+    {
+    }
+
+    FakeDispatch(std::function<R(Args...)> callable, std::size_t record_capacity)
+        : function_(nullptr), callable_(std::move(callable)), record_capacity_(record_capacity),
+          records_(makeRecords(record_capacity))
+    {
+    }
+
+    ~FakeDispatch() = default;
+
+  private:
+    static std::unique_ptr<Call[]> makeRecords(std::size_t record_capacity)
+    {
+        return record_capacity != 0U ? std::unique_ptr<Call[]>(new Call[record_capacity]()) : nullptr;
+    }
+
+    std::atomic<Function> function_;
+    std::function<R(Args...)> callable_;
+    std::atomic<std::uint64_t> call_count_{0U};
+    std::atomic<std::uint64_t> next_record_{0U};
+    const std::uint64_t record_capacity_;
+    std::unique_ptr<Call[]> records_;
+};
+
+/** fake の登録先 (_fake_<func>)。mock 関数本体は lock() で取得したガード経由で呼び出す。 */
+template <typename Signature> using FakeSlot = MockSlot<FakeDispatch<Signature>>;
+
+/**
+ * テストが生成する fake。生存期間中、slot を通じて mock 関数の呼び出しを受ける。
+ * 各 mock ヘッダーで Fake_<func> として別名を定義する。
+ *
+ * 使用例:
+ *   Fake_memset fake_memset([](void *s, int, size_t) { return s; }, 16);
+ *   ...
+ *   EXPECT_EQ(1U, fake_memset.callCount());
+ */
+template <typename Signature, FakeSlot<Signature> &slot> class FakeFunction : public FakeDispatch<Signature>
+{
+    using Base = FakeDispatch<Signature>;
+
+  public:
+    /** function へ委譲する fake を登録する。record_capacity 件まで呼び出しを記録する。 */
+    explicit FakeFunction(typename Base::Function function, std::size_t record_capacity = 0U)
+        : Base(function, record_capacity)
+    {
+        install();
+    }
+
+    /** ラムダ式等へ委譲する fake を登録する。 */
+    template <typename Callable,
+              typename = std::enable_if_t<!std::is_convertible<Callable, typename Base::Function>::value>>
+    explicit FakeFunction(Callable callable, std::size_t record_capacity = 0U)
+        : Base(std::function<Signature>(std::move(callable)), record_capacity)
+    {
+        install();
+    }
+
+    ~FakeFunction()
+    {
+        if (installed_ && !slot.retire(this, internal::kMockRetireTimeout))
+        {
+            ADD_FAILURE() << "Fake calls did not finish within " << internal::kMockRetireTimeout.count()
+                          << " ms while destroying the fake.";
+        }
+    }
+
+  private:
+    void install()
+    {
+        // 同時に生成された fake のうち 1 個のみが登録され、他は失敗として報告する
+        if (!slot.tryPublish(this))
+        {
+            ADD_FAILURE() << "Only one fake may be installed for the same function at a time.";
+            return;
+        }
+        installed_ = true;
+    }
+
+    bool installed_ = false;
+};
+
+} // namespace testfw
+
+#ifndef _WIN32
+    #pragma GCC diagnostic pop
+#endif /* _WIN32 */
+
+#endif // TESTFW_FAKE_FUNCTION_H
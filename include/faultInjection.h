@@ -0,0 +1,128 @@
+#ifndef _FAULT_INJECTION_H
+#define _FAULT_INJECTION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+#ifndef _WIN32
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wpadded"
+#endif /* _WIN32 */
+
+namespace testing
+{
+
+/** 障害注入に対応している mock 関数。 */
+enum FaultFunction
+{
+    FAULT_MALLOC,
+    FAULT_CALLOC,
+    FAULT_REALLOC,
+    FAULT_OPEN,
+    FAULT_CLOSE,
+    FAULT_READ,
+    FAULT_WRITE,
+    FAULT_FSYNC,
+    FAULT_UNLINK,
+    FAULT_FOPEN,
+    FAULT_FCLOSE,
+    FAULT_FREAD,
+    FAULT_FWRITE,
+    FAULT_FFLUSH,
+    FAULT_FUNCTION_COUNT
+};
+
+/**
+ * 障害注入の規則。設定した条件 (0 / 空以外) をすべて満たす呼び出しを失敗させる。
+ * 呼び出し回数と累積バイト数は、FaultInjection の生成以降の対象関数ごとの値。
+ */
+struct FaultRule
+{
+    string function;           ///< 対象関数名 ("write" 等)
+    int error_number = 0;      ///< 失敗時に設定する errno
+    uint64_t every_nth = 0;    ///< N 回ごとの呼び出しで失敗
+    uint64_t nth_call = 0;     ///< N 回目の呼び出しのみ失敗
+    uint64_t bytes_over = 0;   ///< 累積バイト数 (今回の呼び出しを含む) が値を超えたら失敗
+    string path_glob;          ///< パスが一致したら失敗 ('*' / '?' を使用可)
+    double probability = 0.0;  ///< この確率で失敗 (seed から決定的に算出)
+    uint64_t max_failures = 0; ///< この規則で失敗させる回数の上限 (0 は無制限)
+};
+
+/** 注入した障害の記録。replay() に渡すと同じ呼び出しを失敗させる。 */
+struct InjectedFault
+{
+    string function;     ///< 対象関数名
+    uint64_t call_index; ///< 対象関数の何回目の呼び出しか (1 始まり)
+    size_t rule_index;   ///< 一致した規則の追加順の番号
+    int error_number;    ///< 設定した errno
+};
+
+struct FaultInjectionState;
+
+/**
+ * 規則に基づいて mock 関数を失敗させる。EXPECT_CALL を記述せずにエラー経路を試験する。
+ * 生存期間中のみ有効で、同時に生成できるのは 1 個のみ。
+ * 規則の判定はロックを取得しない (注入した障害の記録時のみロックを取得する)。
+ * probability の判定は seed と呼び出し回数から決まるため、同じ seed と同じ呼び出し順で再現する。
+ *
+ * 使用例:
+ *   FaultInjection fault_injection(seed);
+ *   fault_injection.failEveryNth("write", 1000, ENOSPC);
+ *   fault_injection.failAfterBytes("malloc", 1024 * 1024, ENOMEM);
+ *   fault_injection.failPath("fopen", "*.conf", EACCES);
+ */
+class FaultInjection
+{
+  public:
+    explicit FaultInjection(uint64_t seed = 0);
+    ~FaultInjection();
+
+    FaultInjection(const FaultInjection &) = delete;
+    FaultInjection &operator=(const FaultInjection &) = delete;
+
+    /** 規則を追加する。追加順に判定し、最初に一致した規則で失敗させる。 */
+    FaultInjection &addRule(const FaultRule &rule);
+
+    FaultInjection &failEveryNth(const string &function, uint64_t every_nth, int error_number);
+    FaultInjection &failNthCall(const string &function, uint64_t nth_call, int error_number);
+    FaultInjection &failAfterBytes(const string &function, uint64_t bytes_over, int error_number);
+    FaultInjection &failPath(const string &function, const string &path_glob, int error_number);
+    FaultInjection &failWithProbability(const string &function, double probability, int error_number);
+
+    /** 以前に注入した障害を、同じ呼び出しに再度注入する規則を追加する。 */
+    FaultInjection &replay(const vector<InjectedFault> &faults);
+
+    /** 注入した障害 (注入順) */
+    vector<InjectedFault> injectedFaults() const;
+
+    /** 対象関数の呼び出し回数 */
+    uint64_t callCount(const string &function) const;
+
+    uint64_t seed() const;
+
+  private:
+    unique_ptr<FaultInjectionState> state_;
+};
+
+/** 関数名から FaultFunction を返す。対応していない場合は FAULT_FUNCTION_COUNT を返す。 */
+extern FaultFunction findFaultFunction(const string &function);
+
+/**
+ * mock 関数本体から呼び出す。障害を注入する場合は errno を設定して true を返す。
+ * FaultInjection が無い場合は atomic ロード 1 回のみで false を返す。
+ * bytes は要求サイズ、path は対象パス (該当しない関数は 0 / NULL)。
+ */
+extern bool shouldInjectFault(FaultFunction function, uint64_t bytes = 0, const char *path = nullptr);
+
+} // namespace testing
+
+#ifndef _WIN32
+    #pragma GCC diagnostic pop
+#endif /* _WIN32 */
+
+#endif // _FAULT_INJECTION_H
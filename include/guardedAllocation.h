@@ -0,0 +1,97 @@
+#ifndef _GUARDED_ALLOCATION_H
+#define _GUARDED_ALLOCATION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+using namespace std;
+
+#ifndef _WIN32
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wpadded"
+#endif /* _WIN32 */
+
+namespace testing
+{
+
+/** ガード ページ付きの確保の統計 (すべての GuardedAllocation の合計)。 */
+struct GuardedAllocationStats
+{
+    uint64_t allocations = 0;   ///< ガード ページ付きで確保した回数
+    uint64_t live = 0;          ///< 未解放の確保数
+    uint64_t quarantined = 0;   ///< 解放後にアクセス不可として保持している確保数
+    uint64_t invalid_frees = 0; ///< 二重の free / realloc の回数
+    uint64_t fallbacks = 0;     ///< 管理表が満杯のため通常の確保とした回数
+};
+
+struct GuardedAllocationState;
+
+/**
+ * 確保元が site_pattern に一致する mock_malloc / mock_calloc / mock_realloc の確保を、
+ * 確保ごとの領域の末尾に右詰めで配置し、直後にアクセス不可のガード ページを置く (electric fence 方式)。
+ * 末尾を超えるアクセスと解放後のアクセスは SIGSEGV (Windows はアクセス違反) となり、
+ * 異常終了の前に確保元 (および解放元) の file:line を標準エラー出力に出力する。
+ * 解放した領域はアクセス不可にして一定数保持する。
+ *
+ * site_pattern は確保元の "ファイル:行" と照合する ('*' / '?' を使用可。":行" を省略した場合は全行)。
+ * alignment は返すアドレスの境界。1 にすると 1 バイトの超過も検出するが、アドレスは揃わない。
+ * 生存期間中のみ有効で、同時に生成できるのは 1 個のみ。確保した領域は破棄後も有効で、free できる。
+ * Mock_stdlib で malloc 等を設定した場合や障害注入で失敗させる場合はそちらを優先し、AllocationArena より優先する。
+ *
+ * 使用例:
+ *   TEST_F(ParserTest, parse_long_token)
+ *   {
+ *       GuardedAllocation guarded("*parser.c");
+ *       ...
+ *   }
+ */
+class GuardedAllocation
+{
+  public:
+    static constexpr size_t DEFAULT_ALIGNMENT = 16;
+
+    explicit GuardedAllocation(const string &site_pattern = "*", size_t alignment = DEFAULT_ALIGNMENT);
+    ~GuardedAllocation();
+
+    GuardedAllocation(const GuardedAllocation &) = delete;
+    GuardedAllocation &operator=(const GuardedAllocation &) = delete;
+
+  private:
+    unique_ptr<GuardedAllocationState> state_;
+};
+
+/** ガード ページ付きの確保の統計を返す。 */
+extern GuardedAllocationStats getGuardedAllocationStats();
+
+/**
+ * テスト名 ("スイート名.テスト名") が test_pattern に一致するテストの実行中 (SetUp から TearDown まで)、
+ * GuardedAllocation(site_pattern, alignment) を有効にする Google Test のイベント リスナーを登録する。
+ * RUN_ALL_TESTS() の前に呼び出す。
+ */
+extern void installGuardedAllocationListener(const string &test_pattern, const string &site_pattern = "*",
+                                             size_t alignment = GuardedAllocation::DEFAULT_ALIGNMENT);
+
+/**
+ * mock 関数本体から呼び出す。
+ * allocateGuarded / callocGuarded: GuardedAllocation があり確保元が一致する場合に確保して true を返す
+ *                                  (無い場合は atomic ロード 1 回のみ)。
+ * reallocateGuarded: ptr がガード ページ付きの領域の場合、または ptr が NULL で allocateGuarded の条件を
+ *                    満たす場合に処理して true を返す。
+ * freeGuarded: ptr がガード ページ付きの領域の場合に処理して true を返す (領域が無い場合は atomic ロード 1 回のみ)。
+ */
+extern bool allocateGuarded(size_t size, const char *file, int line, const char *caller, void **allocated);
+extern bool callocGuarded(size_t nmemb, size_t size, const char *file, int line, const char *caller,
+                          void **allocated);
+extern bool reallocateGuarded(void *ptr, size_t size, const char *file, int line, const char *caller,
+                              void **allocated);
+extern bool freeGuarded(void *ptr, const char *file, int line);
+
+} // namespace testing
+
+#ifndef _WIN32
+    #pragma GCC diagnostic pop
+#endif /* _WIN32 */
+
+#endif // _GUARDED_ALLOCATION_H
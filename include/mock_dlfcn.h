@@ -34,6 +34,7 @@ extern "C"
         #pragma GCC diagnostic push
         #pragma GCC diagnostic ignored "-Wpadded"
         #include <gmock/gmock.h>
+        #include <mock_instance.h>
         #pragma GCC diagnostic pop
 
 extern void *delegate_real_dlopen(const char *, const int, const char *, const char *, int);
@@ -53,7 +54,7 @@ class Mock_dlfcn
     ~Mock_dlfcn();
 };
 
-extern Mock_dlfcn *_mock_dlfcn;
+extern testfw::MockSlot<Mock_dlfcn> _mock_dlfcn;
 
     #endif // _IN_OVERRIDE_HEADER_DLFCN_H
 
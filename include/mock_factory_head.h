@@ -218,10 +218,10 @@
         Mock_##name(); \
         ~Mock_##name(); \
     }; \
-    extern Mock_##name *_mock_##name;
+    extern testfw::MockSlot<Mock_##name> _mock_##name;
 
 #define MOCK_C_METHOD0_NONVOID_CC(ret, name, default_lambda) \
-    Mock_##name *_mock_##name = nullptr; \
+    testfw::MockSlot<Mock_##name> _mock_##name; \
     Mock_##name::Mock_##name() \
     { \
         ON_CALL(*this, name()).WillByDefault(Invoke(default_lambda)); \
@@ -233,7 +233,8 @@
     } \
     ret name() \
     { \
-        return _mock_##name ? _mock_##name->name() : default_lambda(); \
+        auto locked_##name = _mock_##name.lock(); \
+        return locked_##name ? locked_##name->name() : default_lambda(); \
     }
 
 // 1 引数 非 void 戻り値
@@ -245,10 +246,10 @@
         Mock_##name(); \
         ~Mock_##name(); \
     }; \
-    extern Mock_##name *_mock_##name;
+    extern testfw::MockSlot<Mock_##name> _mock_##name;
 
 #define MOCK_C_METHOD1_NONVOID_CC(ret, name, A1, default_lambda) \
-    Mock_##name *_mock_##name = nullptr; \
+    testfw::MockSlot<Mock_##name> _mock_##name; \
     Mock_##name::Mock_##name() \
     { \
         ON_CALL(*this, name(_)).WillByDefault(Invoke(default_lambda)); \
@@ -260,7 +261,8 @@
     } \
     ret name(A1 _1) \
     { \
-        return _mock_##name ? _mock_##name->name(_1) : default_lambda(_1); \
+        auto locked_##name = _mock_##name.lock(); \
+        return locked_##name ? locked_##name->name(_1) : default_lambda(_1); \
     }
 
 // 2 引数 非 void 戻り値
@@ -272,10 +274,10 @@
         Mock_##name(); \
         ~Mock_##name(); \
     }; \
-    extern Mock_##name *_mock_##name;
+    extern testfw::MockSlot<Mock_##name> _mock_##name;
 
 #define MOCK_C_METHOD2_NONVOID_CC(ret, name, A1, A2, default_lambda) \
-    Mock_##name *_mock_##name = nullptr; \
+    testfw::MockSlot<Mock_##name> _mock_##name; \
     Mock_##name::Mock_##name() \
     { \
         ON_CALL(*this, name(_, _)).WillByDefault(Invoke(default_lambda)); \
@@ -287,7 +289,8 @@
     } \
     ret name(A1 _1, A2 _2) \
     { \
-        return _mock_##name ? _mock_##name->name(_1, _2) : default_lambda(_1, _2); \
+        auto locked_##name = _mock_##name.lock(); \
+        return locked_##name ? locked_##name->name(_1, _2) : default_lambda(_1, _2); \
     }
 
 // 3 引数 非 void 戻り値
@@ -299,10 +302,10 @@
         Mock_##name(); \
         ~Mock_##name(); \
     }; \
-    extern Mock_##name *_mock_##name;
+    extern testfw::MockSlot<Mock_##name> _mock_##name;
 
 #define MOCK_C_METHOD3_NONVOID_CC(ret, name, A1, A2, A3, default_lambda) \
-    Mock_##name *_mock_##name = nullptr; \
+    testfw::MockSlot<Mock_##name> _mock_##name; \
     Mock_##name::Mock_##name() \
     { \
         ON_CALL(*this, name(_, _, _)).WillByDefault(Invoke(default_lambda)); \
@@ -314,7 +317,8 @@
     } \
     ret name(A1 _1, A2 _2, A3 _3) \
     { \
-        return _mock_##name ? _mock_##name->name(_1, _2, _3) : default_lambda(_1, _2, _3); \
+        auto locked_##name = _mock_##name.lock(); \
+        return locked_##name ? locked_##name->name(_1, _2, _3) : default_lambda(_1, _2, _3); \
     }
 
 // 4 引数 非 void 戻り値
@@ -326,10 +330,10 @@
         Mock_##name(); \
         ~Mock_##name(); \
     }; \
-    extern Mock_##name *_mock_##name;
+    extern testfw::MockSlot<Mock_##name> _mock_##name;
 
 #define MOCK_C_METHOD4_NONVOID_CC(ret, name, A1, A2, A3, A4, default_lambda) \
-    Mock_##name *_mock_##name = nullptr; \
+    testfw::MockSlot<Mock_##name> _mock_##name; \
     Mock_##name::Mock_##name() \
     { \
         ON_CALL(*this, name(_, _, _, _)).WillByDefault(Invoke(default_lambda)); \
@@ -341,7 +345,8 @@
     } \
     ret name(A1 _1, A2 _2, A3 _3, A4 _4) \
     { \
-        return _mock_##name ? _mock_##name->name(_1, _2, _3, _4) : default_lambda(_1, _2, _3, _4); \
+        auto locked_##name = _mock_##name.lock(); \
+        return locked_##name ? locked_##name->name(_1, _2, _3, _4) : default_lambda(_1, _2, _3, _4); \
     }
 
 // 5 引数 非 void 戻り値
@@ -353,10 +358,10 @@
         Mock_##name(); \
         ~Mock_##name(); \
     }; \
-    extern Mock_##name *_mock_##name;
+    extern testfw::MockSlot<Mock_##name> _mock_##name;
 
 #define MOCK_C_METHOD5_NONVOID_CC(ret, name, A1, A2, A3, A4, A5, default_lambda) \
-    Mock_##name *_mock_##name = nullptr; \
+    testfw::MockSlot<Mock_##name> _mock_##name; \
     Mock_##name::Mock_##name() \
     { \
         ON_CALL(*this, name(_, _, _, _, _)).WillByDefault(Invoke(default_lambda)); \
@@ -368,7 +373,8 @@
     } \
     ret name(A1 _1, A2 _2, A3 _3, A4 _4, A5 _5) \
     { \
-        return _mock_##name ? _mock_##name->name(_1, _2, _3, _4, _5) : default_lambda(_1, _2, _3, _4, _5); \
+        auto locked_##name = _mock_##name.lock(); \
+        return locked_##name ? locked_##name->name(_1, _2, _3, _4, _5) : default_lambda(_1, _2, _3, _4, _5); \
     }
 
 // 6 引数 非 void 戻り値
@@ -380,10 +386,10 @@
         Mock_##name(); \
         ~Mock_##name(); \
     }; \
-    extern Mock_##name *_mock_##name;
+    extern testfw::MockSlot<Mock_##name> _mock_##name;
 
 #define MOCK_C_METHOD6_NONVOID_CC(ret, name, A1, A2, A3, A4, A5, A6, default_lambda) \
-    Mock_##name *_mock_##name = nullptr; \
+    testfw::MockSlot<Mock_##name> _mock_##name; \
     Mock_##name::Mock_##name() \
     { \
         ON_CALL(*this, name(_, _, _, _, _, _)).WillByDefault(Invoke(default_lambda)); \
@@ -395,7 +401,8 @@
     } \
     ret name(A1 _1, A2 _2, A3 _3, A4 _4, A5 _5, A6 _6) \
     { \
-        return _mock_##name ? _mock_##name->name(_1, _2, _3, _4, _5, _6) : default_lambda(_1, _2, _3, _4, _5, _6); \
+        auto locked_##name = _mock_##name.lock(); \
+        return locked_##name ? locked_##name->name(_1, _2, _3, _4, _5, _6) : default_lambda(_1, _2, _3, _4, _5, _6); \
     }
 
 // 7 引数 非 void 戻り値
@@ -407,10 +414,10 @@
         Mock_##name(); \
         ~Mock_##name(); \
     }; \
-    extern Mock_##name *_mock_##name;
+    extern testfw::MockSlot<Mock_##name> _mock_##name;
 
 #define MOCK_C_METHOD7_NONVOID_CC(ret, name, A1, A2, A3, A4, A5, A6, A7, default_lambda) \
-    Mock_##name *_mock_##name = nullptr; \
+    testfw::MockSlot<Mock_##name> _mock_##name; \
     Mock_##name::Mock_##name() \
     { \
         ON_CALL(*this, name(_, _, _, _, _, _, _)).WillByDefault(Invoke(default_lambda)); \
@@ -422,8 +429,9 @@
     } \
     ret name(A1 _1, A2 _2, A3 _3, A4 _4, A5 _5, A6 _6, A7 _7) \
     { \
-        return _mock_##name ? _mock_##name->name(_1, _2, _3, _4, _5, _6, _7) \
-                            : default_lambda(_1, _2, _3, _4, _5, _6, _7); \
+        auto locked_##name = _mock_##name.lock(); \
+        return locked_##name ? locked_##name->name(_1, _2, _3, _4, _5, _6, _7) \
+                             : default_lambda(_1, _2, _3, _4, _5, _6, _7); \
     }
 
 // 8 引数 非 void 戻り値
@@ -435,10 +443,10 @@
         Mock_##name(); \
         ~Mock_##name(); \
     }; \
-    extern Mock_##name *_mock_##name;
+    extern testfw::MockSlot<Mock_##name> _mock_##name;
 
 #define MOCK_C_METHOD8_NONVOID_CC(ret, name, A1, A2, A3, A4, A5, A6, A7, A8, default_lambda) \
-    Mock_##name *_mock_##name = nullptr; \
+    testfw::MockSlot<Mock_##name> _mock_##name; \
     Mock_##name::Mock_##name() \
     { \
         ON_CALL(*this, name(_, _, _, _, _, _, _, _)).WillByDefault(Invoke(default_lambda)); \
@@ -450,8 +458,9 @@
     } \
     ret name(A1 _1, A2 _2, A3 _3, A4 _4, A5 _5, A6 _6, A7 _7, A8 _8) \
     { \
-        return _mock_##name ? _mock_##name->name(_1, _2, _3, _4, _5, _6, _7, _8) \
-                            : default_lambda(_1, _2, _3, _4, _5, _6, _7, _8); \
+        auto locked_##name = _mock_##name.lock(); \
+        return locked_##name ? locked_##name->name(_1, _2, _3, _4, _5, _6, _7, _8) \
+                             : default_lambda(_1, _2, _3, _4, _5, _6, _7, _8); \
     }
 
 // 9 引数 非 void 戻り値
@@ -463,10 +472,10 @@
         Mock_##name(); \
         ~Mock_##name(); \
     }; \
-    extern Mock_##name *_mock_##name;
+    extern testfw::MockSlot<Mock_##name> _mock_##name;
 
 #define MOCK_C_METHOD9_NONVOID_CC(ret, name, A1, A2, A3, A4, A5, A6, A7, A8, A9, default_lambda) \
-    Mock_##name *_mock_##name = nullptr; \
+    testfw::MockSlot<Mock_##name> _mock_##name; \
     Mock_##name::Mock_##name() \
     { \
         ON_CALL(*this, name(_, _, _, _, _, _, _, _, _)).WillByDefault(Invoke(default_lambda)); \
@@ -478,8 +487,9 @@
     } \
     ret name(A1 _1, A2 _2, A3 _3, A4 _4, A5 _5, A6 _6, A7 _7, A8 _8, A9 _9) \
     { \
-        return _mock_##name ? _mock_##name->name(_1, _2, _3, _4, _5, _6, _7, _8, _9) \
-                            : default_lambda(_1, _2, _3, _4, _5, _6, _7, _8, _9); \
+        auto locked_##name = _mock_##name.lock(); \
+        return locked_##name ? locked_##name->name(_1, _2, _3, _4, _5, _6, _7, _8, _9) \
+                             : default_lambda(_1, _2, _3, _4, _5, _6, _7, _8, _9); \
     }
 
 // 10 引数 非 void 戻り値
@@ -491,10 +501,10 @@
         Mock_##name(); \
         ~Mock_##name(); \
     }; \
-    extern Mock_##name *_mock_##name;
+    extern testfw::MockSlot<Mock_##name> _mock_##name;
 
 #define MOCK_C_METHOD10_NONVOID_CC(ret, name, A1, A2, A3, A4, A5, A6, A7, A8, A9, A10, default_lambda) \
-    Mock_##name *_mock_##name = nullptr; \
+    testfw::MockSlot<Mock_##name> _mock_##name; \
     Mock_##name::Mock_##name() \
     { \
         ON_CALL(*this, name(_, _, _, _, _, _, _, _, _, _)).WillByDefault(Invoke(default_lambda)); \
@@ -506,8 +516,9 @@
     } \
     ret name(A1 _1, A2 _2, A3 _3, A4 _4, A5 _5, A6 _6, A7 _7, A8 _8, A9 _9, A10 _10) \
     { \
-        return _mock_##name ? _mock_##name->name(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10) \
-                            : default_lambda(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10); \
+        auto locked_##name = _mock_##name.lock(); \
+        return locked_##name ? locked_##name->name(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10) \
+                             : default_lambda(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10); \
     }
 
 // 0 引数 void 戻り値
@@ -519,10 +530,10 @@
         Mock_##name(); \
         ~Mock_##name(); \
     }; \
-    extern Mock_##name *_mock_##name;
+    extern testfw::MockSlot<Mock_##name> _mock_##name;
 
 #define MOCK_C_METHOD0_VOID_CC(ret, name) \
-    Mock_##name *_mock_##name = nullptr; \
+    testfw::MockSlot<Mock_##name> _mock_##name; \
     Mock_##name::Mock_##name() \
     { \
         TESTFW_REGISTER_MOCK_INSTANCE(_mock_##name); \
@@ -533,8 +544,8 @@
     } \
     ret name() \
     { \
-        if (_mock_##name) \
-            _mock_##name->name(); \
+        if (auto locked_##name = _mock_##name.lock()) \
+            locked_##name->name(); \
     }
 
 // 1 引数 void 戻り値
@@ -546,10 +557,10 @@
         Mock_##name(); \
         ~Mock_##name(); \
     }; \
-    extern Mock_##name *_mock_##name;
+    extern testfw::MockSlot<Mock_##name> _mock_##name;
 
 #define MOCK_C_METHOD1_VOID_CC(ret, name, A1) \
-    Mock_##name *_mock_##name = nullptr; \
+    testfw::MockSlot<Mock_##name> _mock_##name; \
     Mock_##name::Mock_##name() \
     { \
         TESTFW_REGISTER_MOCK_INSTANCE(_mock_##name); \
@@ -560,8 +571,8 @@
     } \
     ret name(A1 _1) \
     { \
-        if (_mock_##name) \
-            _mock_##name->name(_1); \
+        if (auto locked_##name = _mock_##name.lock()) \
+            locked_##name->name(_1); \
     }
 
 // 2 引数 void 戻り値
@@ -573,10 +584,10 @@
         Mock_##name(); \
         ~Mock_##name(); \
     }; \
-    extern Mock_##name *_mock_##name;
+    extern testfw::MockSlot<Mock_##name> _mock_##name;
 
 #define MOCK_C_METHOD2_VOID_CC(ret, name, A1, A2) \
-    Mock_##name *_mock_##name = nullptr; \
+    testfw::MockSlot<Mock_##name> _mock_##name; \
     Mock_##name::Mock_##name() \
     { \
         TESTFW_REGISTER_MOCK_INSTANCE(_mock_##name); \
@@ -587,8 +598,8 @@
     } \
     ret name(A1 _1, A2 _2) \
     { \
-        if (_mock_##name) \
-            _mock_##name->name(_1, _2); \
+        if (auto locked_##name = _mock_##name.lock()) \
+            locked_##name->name(_1, _2); \
     }
 
 // 3 引数 void 戻り値
@@ -600,10 +611,10 @@
         Mock_##name(); \
         ~Mock_##name(); \
     }; \
-    extern Mock_##name *_mock_##name;
+    extern testfw::MockSlot<Mock_##name> _mock_##name;
 
 #define MOCK_C_METHOD3_VOID_CC(ret, name, A1, A2, A3) \
-    Mock_##name *_mock_##name = nullptr; \
+    testfw::MockSlot<Mock_##name> _mock_##name; \
     Mock_##name::Mock_##name() \
     { \
         TESTFW_REGISTER_MOCK_INSTANCE(_mock_##name); \
@@ -614,8 +625,8 @@
     } \
     ret name(A1 _1, A2 _2, A3 _3) \
     { \
-        if (_mock_##name) \
-            _mock_##name->name(_1, _2, _3); \
+        if (auto locked_##name = _mock_##name.lock()) \
+            locked_##name->name(_1, _2, _3); \
     }
 
 // 4 引数 void 戻り値
@@ -627,10 +638,10 @@
         Mock_##name(); \
         ~Mock_##name(); \
     }; \
-    extern Mock_##name *_mock_##name;
+    extern testfw::MockSlot<Mock_##name> _mock_##name;
 
 #define MOCK_C_METHOD4_VOID_CC(ret, name, A1, A2, A3, A4) \
-    Mock_##name *_mock_##name = nullptr; \
+    testfw::MockSlot<Mock_##name> _mock_##name; \
     Mock_##name::Mock_##name() \
     { \
         TESTFW_REGISTER_MOCK_INSTANCE(_mock_##name); \
@@ -641,8 +652,8 @@
     } \
     ret name(A1 _1, A2 _2, A3 _3, A4 _4) \
     { \
-        if (_mock_##name) \
-            _mock_##name->name(_1, _2, _3, _4); \
+        if (auto locked_##name = _mock_##name.lock()) \
+            locked_##name->name(_1, _2, _3, _4); \
     }
 
 // 5 引数 void 戻り値
@@ -654,10 +665,10 @@
         Mock_##name(); \
         ~Mock_##name(); \
     }; \
-    extern Mock_##name *_mock_##name;
+    extern testfw::MockSlot<Mock_##name> _mock_##name;
 
 #define MOCK_C_METHOD5_VOID_CC(ret, name, A1, A2, A3, A4, A5) \
-    Mock_##name *_mock_##name = nullptr; \
+    testfw::MockSlot<Mock_##name> _mock_##name; \
     Mock_##name::Mock_##name() \
     { \
         TESTFW_REGISTER_MOCK_INSTANCE(_mock_##name); \
@@ -668,8 +679,8 @@
     } \
     ret name(A1 _1, A2 _2, A3 _3, A4 _4, A5 _5) \
     { \
-        if (_mock_##name) \
-            _mock_##name->name(_1, _2, _3, _4, _5); \
+        if (auto locked_##name = _mock_##name.lock()) \
+            locked_##name->name(_1, _2, _3, _4, _5); \
     }
 
 // 6 引数 void 戻り値
@@ -681,10 +692,10 @@
         Mock_##name(); \
         ~Mock_##name(); \
     }; \
-    extern Mock_##name *_mock_##name;
+    extern testfw::MockSlot<Mock_##name> _mock_##name;
 
 #define MOCK_C_METHOD6_VOID_CC(ret, name, A1, A2, A3, A4, A5, A6) \
-    Mock_##name *_mock_##name = nullptr; \
+    testfw::MockSlot<Mock_##name> _mock_##name; \
     Mock_##name::Mock_##name() \
     { \
         TESTFW_REGISTER_MOCK_INSTANCE(_mock_##name); \
@@ -695,8 +706,8 @@
     } \
     ret name(A1 _1, A2 _2, A3 _3, A4 _4, A5 _5, A6 _6) \
     { \
-        if (_mock_##name) \
-            _mock_##name->name(_1, _2, _3, _4, _5, _6); \
+        if (auto locked_##name = _mock_##name.lock()) \
+            locked_##name->name(_1, _2, _3, _4, _5, _6); \
     }
 
 // 7 引数 void 戻り値
@@ -708,10 +719,10 @@
         Mock_##name(); \
         ~Mock_##name(); \
     }; \
-    extern Mock_##name *_mock_##name;
+    extern testfw::MockSlot<Mock_##name> _mock_##name;
 
 #define MOCK_C_METHOD7_VOID_CC(ret, name, A1, A2, A3, A4, A5, A6, A7) \
-    Mock_##name *_mock_##name = nullptr; \
+    testfw::MockSlot<Mock_##name> _mock_##name; \
     Mock_##name::Mock_##name() \
     { \
         TESTFW_REGISTER_MOCK_INSTANCE(_mock_##name); \
@@ -722,8 +733,8 @@
     } \
     ret name(A1 _1, A2 _2, A3 _3, A4 _4, A5 _5, A6 _6, A7 _7) \
     { \
-        if (_mock_##name) \
-            _mock_##name->name(_1, _2, _3, _4, _5, _6, _7); \
+        if (auto locked_##name = _mock_##name.lock()) \
+            locked_##name->name(_1, _2, _3, _4, _5, _6, _7); \
     }
 
 // 8 引数 void 戻り値
@@ -735,10 +746,10 @@
         Mock_##name(); \
         ~Mock_##name(); \
     }; \
-    extern Mock_##name *_mock_##name;
+    extern testfw::MockSlot<Mock_##name> _mock_##name;
 
 #define MOCK_C_METHOD8_VOID_CC(ret, name, A1, A2, A3, A4, A5, A6, A7, A8) \
-    Mock_##name *_mock_##name = nullptr; \
+    testfw::MockSlot<Mock_##name> _mock_##name; \
     Mock_##name::Mock_##name() \
     { \
         TESTFW_REGISTER_MOCK_INSTANCE(_mock_##name); \
@@ -749,8 +760,8 @@
     } \
     ret name(A1 _1, A2 _2, A3 _3, A4 _4, A5 _5, A6 _6, A7 _7, A8 _8) \
     { \
-        if (_mock_##name) \
-            _mock_##name->name(_1, _2, _3, _4, _5, _6, _7, _8); \
+        if (auto locked_##name = _mock_##name.lock()) \
+            locked_##name->name(_1, _2, _3, _4, _5, _6, _7, _8); \
     }
 
 // 9 引数 void 戻り値
@@ -762,10 +773,10 @@
         Mock_##name(); \
         ~Mock_##name(); \
     }; \
-    extern Mock_##name *_mock_##name;
+    extern testfw::MockSlot<Mock_##name> _mock_##name;
 
 #define MOCK_C_METHOD9_VOID_CC(ret, name, A1, A2, A3, A4, A5, A6, A7, A8, A9) \
-    Mock_##name *_mock_##name = nullptr; \
+    testfw::MockSlot<Mock_##name> _mock_##name; \
     Mock_##name::Mock_##name() \
     { \
         TESTFW_REGISTER_MOCK_INSTANCE(_mock_##name); \
@@ -776,8 +787,8 @@
     } \
     ret name(A1 _1, A2 _2, A3 _3, A4 _4, A5 _5, A6 _6, A7 _7, A8 _8, A9 _9) \
     { \
-        if (_mock_##name) \
-            _mock_##name->name(_1, _2, _3, _4, _5, _6, _7, _8, _9); \
+        if (auto locked_##name = _mock_##name.lock()) \
+            locked_##name->name(_1, _2, _3, _4, _5, _6, _7, _8, _9); \
     }
 
 // 10 引数 void 戻り値
@@ -789,10 +800,10 @@
         Mock_##name(); \
         ~Mock_##name(); \
     }; \
-    extern Mock_##name *_mock_##name;
+    extern testfw::MockSlot<Mock_##name> _mock_##name;
 
 #define MOCK_C_METHOD10_VOID_CC(ret, name, A1, A2, A3, A4, A5, A6, A7, A8, A9, A10) \
-    Mock_##name *_mock_##name = nullptr; \
+    testfw::MockSlot<Mock_##name> _mock_##name; \
     Mock_##name::Mock_##name() \
     { \
         TESTFW_REGISTER_MOCK_INSTANCE(_mock_##name); \
@@ -803,6 +814,815 @@
     } \
     ret name(A1 _1, A2 _2, A3 _3, A4 _4, A5 _5, A6 _6, A7 _7, A8 _8, A9 _9, A10 _10) \
     { \
-        if (_mock_##name) \
-            _mock_##name->name(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10); \
+        if (auto locked_##name = _mock_##name.lock()) \
+            locked_##name->name(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10); \
+    }
+
+// ---------------------------------------------------------------------------
+// 高速版 (FAST_C_METHOD)
+//
+// 引数と Mock_<関数名> クラスは MOCK_C_METHOD と同じ。
+// mock 未生成時の関数本体は atomic な関数ポインターの relaxed ロード 1 回と分岐のみで、
+// デフォルトのラムダ式をインライン展開する (MockCallGuard の生成や gmock を経由しない)。
+// mock の生成中のみ関数ポインターに gmock 経由の関数 (非インライン) を設定する。
+// 重複して生成され登録を拒否された mock は、関数ポインターを設定も解除もしない。
+// ループ内で頻繁に呼ばれる関数に使用する。
+//
+// FAST_C_METHOD(int, checksum_byte, int, unsigned char, [](int sum, unsigned char c)
+//               { return sum + c; });
+
+#define FAST_DISPATCH_VOID_NONVOID(isvoid, count, ...) \
+    CAT4(FAST_C_METHOD, CAT(BOOL_TO_VOIDNONVOID(isvoid), _COUNT)(count), _, BOOL_TO_VOIDNONVOID(isvoid))(__VA_ARGS__)
+
+// エントリ ポイント
+#define FAST_C_METHOD(ret, name, ...) \
+    FAST_DISPATCH_VOID_NONVOID(IS_VOID(ret), VA_NARGS(__VA_ARGS__), ret, name, __VA_ARGS__)
+
+// mock 呼び出しを行う関数を分岐予測・コード配置上の例外側とする
+#if defined(__GNUC__)
+    #define FAST_C_METHOD_MOCKED(fast) __builtin_expect((fast) != nullptr, 0)
+    #define FAST_C_METHOD_COLD         __attribute__((noinline, cold))
+#else
+    #define FAST_C_METHOD_MOCKED(fast) ((fast) != nullptr)
+    #define FAST_C_METHOD_COLD         __declspec(noinline)
+#endif
+
+// .h と .cc の内容セレクター
+#ifndef _IN_MOCK_FACTORY_SRC_
+
+    #define FAST_C_METHOD0_NONVOID(ret, name, default_lambda) MOCK_C_METHOD0_NONVOID_H(ret, name, default_lambda)
+    #define FAST_C_METHOD0_VOID(ret, name, _) MOCK_C_METHOD0_VOID_H(ret, name)
+    #define FAST_C_METHOD1_NONVOID(ret, name, A1, default_lambda) \
+        MOCK_C_METHOD1_NONVOID_H(ret, name, A1, default_lambda)
+    #define FAST_C_METHOD1_VOID(ret, name, A1) MOCK_C_METHOD1_VOID_H(ret, name, A1)
+    #define FAST_C_METHOD2_NONVOID(ret, name, A1, A2, default_lambda) \
+        MOCK_C_METHOD2_NONVOID_H(ret, name, A1, A2, default_lambda)
+    #define FAST_C_METHOD2_VOID(ret, name, A1, A2) MOCK_C_METHOD2_VOID_H(ret, name, A1, A2)
+    #define FAST_C_METHOD3_NONVOID(ret, name, A1, A2, A3, default_lambda) \
+        MOCK_C_METHOD3_NONVOID_H(ret, name, A1, A2, A3, default_lambda)
+    #define FAST_C_METHOD3_VOID(ret, name, A1, A2, A3) MOCK_C_METHOD3_VOID_H(ret, name, A1, A2, A3)
+    #define FAST_C_METHOD4_NONVOID(ret, name, A1, A2, A3, A4, default_lambda) \
+        MOCK_C_METHOD4_NONVOID_H(ret, name, A1, A2, A3, A4, default_lambda)
+    #define FAST_C_METHOD4_VOID(ret, name, A1, A2, A3, A4) MOCK_C_METHOD4_VOID_H(ret, name, A1, A2, A3, A4)
+    #define FAST_C_METHOD5_NONVOID(ret, name, A1, A2, A3, A4, A5, default_lambda) \
+        MOCK_C_METHOD5_NONVOID_H(ret, name, A1, A2, A3, A4, A5, default_lambda)
+    #define FAST_C_METHOD5_VOID(ret, name, A1, A2, A3, A4, A5) MOCK_C_METHOD5_VOID_H(ret, name, A1, A2, A3, A4, A5)
+    #define FAST_C_METHOD6_NONVOID(ret, name, A1, A2, A3, A4, A5, A6, default_lambda) \
+        MOCK_C_METHOD6_NONVOID_H(ret, name, A1, A2, A3, A4, A5, A6, default_lambda)
+    #define FAST_C_METHOD6_VOID(ret, name, A1, A2, A3, A4, A5, A6) \
+        MOCK_C_METHOD6_VOID_H(ret, name, A1, A2, A3, A4, A5, A6)
+    #define FAST_C_METHOD7_NONVOID(ret, name, A1, A2, A3, A4, A5, A6, A7, default_lambda) \
+        MOCK_C_METHOD7_NONVOID_H(ret, name, A1, A2, A3, A4, A5, A6, A7, default_lambda)
+    #define FAST_C_METHOD7_VOID(ret, name, A1, A2, A3, A4, A5, A6, A7) \
+        MOCK_C_METHOD7_VOID_H(ret, name, A1, A2, A3, A4, A5, A6, A7)
+    #define FAST_C_METHOD8_NONVOID(ret, name, A1, A2, A3, A4, A5, A6, A7, A8, default_lambda) \
+        MOCK_C_METHOD8_NONVOID_H(ret, name, A1, A2, A3, A4, A5, A6, A7, A8, default_lambda)
+    #define FAST_C_METHOD8_VOID(ret, name, A1, A2, A3, A4, A5, A6, A7, A8) \
+        MOCK_C_METHOD8_VOID_H(ret, name, A1, A2, A3, A4, A5, A6, A7, A8)
+    #define FAST_C_METHOD9_NONVOID(ret, name, A1, A2, A3, A4, A5, A6, A7, A8, A9, default_lambda) \
+        MOCK_C_METHOD9_NONVOID_H(ret, name, A1, A2, A3, A4, A5, A6, A7, A8, A9, default_lambda)
+    #define FAST_C_METHOD9_VOID(ret, name, A1, A2, A3, A4, A5, A6, A7, A8, A9) \
+        MOCK_C_METHOD9_VOID_H(ret, name, A1, A2, A3, A4, A5, A6, A7, A8, A9)
+    #define FAST_C_METHOD10_NONVOID(ret, name, A1, A2, A3, A4, A5, A6, A7, A8, A9, A10, default_lambda) \
+        MOCK_C_METHOD10_NONVOID_H(ret, name, A1, A2, A3, A4, A5, A6, A7, A8, A9, A10, default_lambda)
+    #define FAST_C_METHOD10_VOID(ret, name, A1, A2, A3, A4, A5, A6, A7, A8, A9, A10) \
+        MOCK_C_METHOD10_VOID_H(ret, name, A1, A2, A3, A4, A5, A6, A7, A8, A9, A10)
+
+#else // _IN_MOCK_FACTORY_SRC_
+
+    #define FAST_C_METHOD0_NONVOID(ret, name, default_lambda) \
+        MOCK_C_METHOD0_NONVOID_H(ret, name, default_lambda) \
+        FAST_C_METHOD0_NONVOID_CC(ret, name, default_lambda)
+    #define FAST_C_METHOD0_VOID(ret, name, _) \
+        MOCK_C_METHOD0_VOID_H(ret, name) \
+        FAST_C_METHOD0_VOID_CC(ret, name)
+    #define FAST_C_METHOD1_NONVOID(ret, name, A1, default_lambda) \
+        MOCK_C_METHOD1_NONVOID_H(ret, name, A1, default_lambda) \
+        FAST_C_METHOD1_NONVOID_CC(ret, name, A1, default_lambda)
+    #define FAST_C_METHOD1_VOID(ret, name, A1) \
+        MOCK_C_METHOD1_VOID_H(ret, name, A1) \
+        FAST_C_METHOD1_VOID_CC(ret, name, A1)
+    #define FAST_C_METHOD2_NONVOID(ret, name, A1, A2, default_lambda) \
+        MOCK_C_METHOD2_NONVOID_H(ret, name, A1, A2, default_lambda) \
+        FAST_C_METHOD2_NONVOID_CC(ret, name, A1, A2, default_lambda)
+    #define FAST_C_METHOD2_VOID(ret, name, A1, A2) \
+        MOCK_C_METHOD2_VOID_H(ret, name, A1, A2) \
+        FAST_C_METHOD2_VOID_CC(ret, name, A1, A2)
+    #define FAST_C_METHOD3_NONVOID(ret, name, A1, A2, A3, default_lambda) \
+        MOCK_C_METHOD3_NONVOID_H(ret, name, A1, A2, A3, default_lambda) \
+        FAST_C_METHOD3_NONVOID_CC(ret, name, A1, A2, A3, default_lambda)
+    #define FAST_C_METHOD3_VOID(ret, name, A1, A2, A3) \
+        MOCK_C_METHOD3_VOID_H(ret, name, A1, A2, A3) \
+        FAST_C_METHOD3_VOID_CC(ret, name, A1, A2, A3)
+    #define FAST_C_METHOD4_NONVOID(ret, name, A1, A2, A3, A4, default_lambda) \
+        MOCK_C_METHOD4_NONVOID_H(ret, name, A1, A2, A3, A4, default_lambda) \
+        FAST_C_METHOD4_NONVOID_CC(ret, name, A1, A2, A3, A4, default_lambda)
+    #define FAST_C_METHOD4_VOID(ret, name, A1, A2, A3, A4) \
+        MOCK_C_METHOD4_VOID_H(ret, name, A1, A2, A3, A4) \
+        FAST_C_METHOD4_VOID_CC(ret, name, A1, A2, A3, A4)
+    #define FAST_C_METHOD5_NONVOID(ret, name, A1, A2, A3, A4, A5, default_lambda) \
+        MOCK_C_METHOD5_NONVOID_H(ret, name, A1, A2, A3, A4, A5, default_lambda) \
+        FAST_C_METHOD5_NONVOID_CC(ret, name, A1, A2, A3, A4, A5, default_lambda)
+    #define FAST_C_METHOD5_VOID(ret, name, A1, A2, A3, A4, A5) \
+        MOCK_C_METHOD5_VOID_H(ret, name, A1, A2, A3, A4, A5) \
+        FAST_C_METHOD5_VOID_CC(ret, name, A1, A2, A3, A4, A5)
+    #define FAST_C_METHOD6_NONVOID(ret, name, A1, A2, A3, A4, A5, A6, default_lambda) \
+        MOCK_C_METHOD6_NONVOID_H(ret, name, A1, A2, A3, A4, A5, A6, default_lambda) \
+        FAST_C_METHOD6_NONVOID_CC(ret, name, A1, A2, A3, A4, A5, A6, default_lambda)
+    #define FAST_C_METHOD6_VOID(ret, name, A1, A2, A3, A4, A5, A6) \
+        MOCK_C_METHOD6_VOID_H(ret, name, A1, A2, A3, A4, A5, A6) \
+        FAST_C_METHOD6_VOID_CC(ret, name, A1, A2, A3, A4, A5, A6)
+    #define FAST_C_METHOD7_NONVOID(ret, name, A1, A2, A3, A4, A5, A6, A7, default_lambda) \
+        MOCK_C_METHOD7_NONVOID_H(ret, name, A1, A2, A3, A4, A5, A6, A7, default_lambda) \
+        FAST_C_METHOD7_NONVOID_CC(ret, name, A1, A2, A3, A4, A5, A6, A7, default_lambda)
+    #define FAST_C_METHOD7_VOID(ret, name, A1, A2, A3, A4, A5, A6, A7) \
+        MOCK_C_METHOD7_VOID_H(ret, name, A1, A2, A3, A4, A5, A6, A7) \
+        FAST_C_METHOD7_VOID_CC(ret, name, A1, A2, A3, A4, A5, A6, A7)
+    #define FAST_C_METHOD8_NONVOID(ret, name, A1, A2, A3, A4, A5, A6, A7, A8, default_lambda) \
+        MOCK_C_METHOD8_NONVOID_H(ret, name, A1, A2, A3, A4, A5, A6, A7, A8, default_lambda) \
+        FAST_C_METHOD8_NONVOID_CC(ret, name, A1, A2, A3, A4, A5, A6, A7, A8, default_lambda)
+    #define FAST_C_METHOD8_VOID(ret, name, A1, A2, A3, A4, A5, A6, A7, A8) \
+        MOCK_C_METHOD8_VOID_H(ret, name, A1, A2, A3, A4, A5, A6, A7, A8) \
+        FAST_C_METHOD8_VOID_CC(ret, name, A1, A2, A3, A4, A5, A6, A7, A8)
+    #define FAST_C_METHOD9_NONVOID(ret, name, A1, A2, A3, A4, A5, A6, A7, A8, A9, default_lambda) \
+        MOCK_C_METHOD9_NONVOID_H(ret, name, A1, A2, A3, A4, A5, A6, A7, A8, A9, default_lambda) \
+        FAST_C_METHOD9_NONVOID_CC(ret, name, A1, A2, A3, A4, A5, A6, A7, A8, A9, default_lambda)
+    #define FAST_C_METHOD9_VOID(ret, name, A1, A2, A3, A4, A5, A6, A7, A8, A9) \
+        MOCK_C_METHOD9_VOID_H(ret, name, A1, A2, A3, A4, A5, A6, A7, A8, A9) \
+        FAST_C_METHOD9_VOID_CC(ret, name, A1, A2, A3, A4, A5, A6, A7, A8, A9)
+    #define FAST_C_METHOD10_NONVOID(ret, name, A1, A2, A3, A4, A5, A6, A7, A8, A9, A10, default_lambda) \
+        MOCK_C_METHOD10_NONVOID_H(ret, name, A1, A2, A3, A4, A5, A6, A7, A8, A9, A10, default_lambda) \
+        FAST_C_METHOD10_NONVOID_CC(ret, name, A1, A2, A3, A4, A5, A6, A7, A8, A9, A10, default_lambda)
+    #define FAST_C_METHOD10_VOID(ret, name, A1, A2, A3, A4, A5, A6, A7, A8, A9, A10) \
+        MOCK_C_METHOD10_VOID_H(ret, name, A1, A2, A3, A4, A5, A6, A7, A8, A9, A10) \
+        FAST_C_METHOD10_VOID_CC(ret, name, A1, A2, A3, A4, A5, A6, A7, A8, A9, A10)
+
+#endif // _IN_MOCK_FACTORY_SRC_
+
+// 0 引数 非 void 戻り値 (高速版)
+#define FAST_C_METHOD0_NONVOID_CC(ret, name, default_lambda) \
+    testfw::MockSlot<Mock_##name> _mock_##name; \
+    static std::atomic<ret (*)()> _fast_##name(nullptr); \
+    static FAST_C_METHOD_COLD ret _fast_mock_##name() \
+    { \
+        auto locked_##name = _mock_##name.lock(); \
+        return locked_##name ? locked_##name->name() : default_lambda(); \
+    } \
+    Mock_##name::Mock_##name() \
+    { \
+        ON_CALL(*this, name()).WillByDefault(Invoke(default_lambda)); \
+        TESTFW_REGISTER_MOCK_INSTANCE(_mock_##name); \
+        if (_mock_##name.get() == this) \
+            _fast_##name.store(_fast_mock_##name, std::memory_order_release); \
+    } \
+    Mock_##name::~Mock_##name() \
+    { \
+        if (_mock_##name.get() == this) \
+            _fast_##name.store(nullptr, std::memory_order_relaxed); \
+        TESTFW_UNREGISTER_MOCK_INSTANCE(_mock_##name); \
+    } \
+    ret name() \
+    { \
+        ret (*const fast_##name)() = _fast_##name.load(std::memory_order_relaxed); \
+        if (FAST_C_METHOD_MOCKED(fast_##name)) \
+        { \
+            return fast_##name(); \
+        } \
+        return default_lambda(); \
+    }
+
+// 0 引数 void 戻り値 (高速版)
+#define FAST_C_METHOD0_VOID_CC(ret, name) \
+    testfw::MockSlot<Mock_##name> _mock_##name; \
+    static std::atomic<ret (*)()> _fast_##name(nullptr); \
+    static FAST_C_METHOD_COLD ret _fast_mock_##name() \
+    { \
+        if (auto locked_##name = _mock_##name.lock()) \
+            locked_##name->name(); \
+    } \
+    Mock_##name::Mock_##name() \
+    { \
+        TESTFW_REGISTER_MOCK_INSTANCE(_mock_##name); \
+        if (_mock_##name.get() == this) \
+            _fast_##name.store(_fast_mock_##name, std::memory_order_release); \
+    } \
+    Mock_##name::~Mock_##name() \
+    { \
+        if (_mock_##name.get() == this) \
+            _fast_##name.store(nullptr, std::memory_order_relaxed); \
+        TESTFW_UNREGISTER_MOCK_INSTANCE(_mock_##name); \
+    } \
+    ret name() \
+    { \
+        ret (*const fast_##name)() = _fast_##name.load(std::memory_order_relaxed); \
+        if (FAST_C_METHOD_MOCKED(fast_##name)) \
+            fast_##name(); \
+    }
+
+// 1 引数 非 void 戻り値 (高速版)
+#define FAST_C_METHOD1_NONVOID_CC(ret, name, A1, default_lambda) \
+    testfw::MockSlot<Mock_##name> _mock_##name; \
+    static std::atomic<ret (*)(A1)> _fast_##name(nullptr); \
+    static FAST_C_METHOD_COLD ret _fast_mock_##name(A1 _1) \
+    { \
+        auto locked_##name = _mock_##name.lock(); \
+        return locked_##name ? locked_##name->name(_1) : default_lambda(_1); \
+    } \
+    Mock_##name::Mock_##name() \
+    { \
+        ON_CALL(*this, name(_)).WillByDefault(Invoke(default_lambda)); \
+        TESTFW_REGISTER_MOCK_INSTANCE(_mock_##name); \
+        if (_mock_##name.get() == this) \
+            _fast_##name.store(_fast_mock_##name, std::memory_order_release); \
+    } \
+    Mock_##name::~Mock_##name() \
+    { \
+        if (_mock_##name.get() == this) \
+            _fast_##name.store(nullptr, std::memory_order_relaxed); \
+        TESTFW_UNREGISTER_MOCK_INSTANCE(_mock_##name); \
+    } \
+    ret name(A1 _1) \
+    { \
+        ret (*const fast_##name)(A1) = _fast_##name.load(std::memory_order_relaxed); \
+        if (FAST_C_METHOD_MOCKED(fast_##name)) \
+        { \
+            return fast_##name(_1); \
+        } \
+        return default_lambda(_1); \
+    }
+
+// 1 引数 void 戻り値 (高速版)
+#define FAST_C_METHOD1_VOID_CC(ret, name, A1) \
+    testfw::MockSlot<Mock_##name> _mock_##name; \
+    static std::atomic<ret (*)(A1)> _fast_##name(nullptr); \
+    static FAST_C_METHOD_COLD ret _fast_mock_##name(A1 _1) \
+    { \
+        if (auto locked_##name = _mock_##name.lock()) \
+            locked_##name->name(_1); \
+    } \
+    Mock_##name::Mock_##name() \
+    { \
+        TESTFW_REGISTER_MOCK_INSTANCE(_mock_##name); \
+        if (_mock_##name.get() == this) \
+            _fast_##name.store(_fast_mock_##name, std::memory_order_release); \
+    } \
+    Mock_##name::~Mock_##name() \
+    { \
+        if (_mock_##name.get() == this) \
+            _fast_##name.store(nullptr, std::memory_order_relaxed); \
+        TESTFW_UNREGISTER_MOCK_INSTANCE(_mock_##name); \
+    } \
+    ret name(A1 _1) \
+    { \
+        ret (*const fast_##name)(A1) = _fast_##name.load(std::memory_order_relaxed); \
+        if (FAST_C_METHOD_MOCKED(fast_##name)) \
+            fast_##name(_1); \
+    }
+
+// 2 引数 非 void 戻り値 (高速版)
+#define FAST_C_METHOD2_NONVOID_CC(ret, name, A1, A2, default_lambda) \
+    testfw::MockSlot<Mock_##name> _mock_##name; \
+    static std::atomic<ret (*)(A1, A2)> _fast_##name(nullptr); \
+    static FAST_C_METHOD_COLD ret _fast_mock_##name(A1 _1, A2 _2) \
+    { \
+        auto locked_##name = _mock_##name.lock(); \
+        return locked_##name ? locked_##name->name(_1, _2) : default_lambda(_1, _2); \
+    } \
+    Mock_##name::Mock_##name() \
+    { \
+        ON_CALL(*this, name(_, _)).WillByDefault(Invoke(default_lambda)); \
+        TESTFW_REGISTER_MOCK_INSTANCE(_mock_##name); \
+        if (_mock_##name.get() == this) \
+            _fast_##name.store(_fast_mock_##name, std::memory_order_release); \
+    } \
+    Mock_##name::~Mock_##name() \
+    { \
+        if (_mock_##name.get() == this) \
+            _fast_##name.store(nullptr, std::memory_order_relaxed); \
+        TESTFW_UNREGISTER_MOCK_INSTANCE(_mock_##name); \
+    } \
+    ret name(A1 _1, A2 _2) \
+    { \
+        ret (*const fast_##name)(A1, A2) = _fast_##name.load(std::memory_order_relaxed); \
+        if (FAST_C_METHOD_MOCKED(fast_##name)) \
+        { \
+            return fast_##name(_1, _2); \
+        } \
+        return default_lambda(_1, _2); \
+    }
+
+// 2 引数 void 戻り値 (高速版)
+#define FAST_C_METHOD2_VOID_CC(ret, name, A1, A2) \
+    testfw::MockSlot<Mock_##name> _mock_##name; \
+    static std::atomic<ret (*)(A1, A2)> _fast_##name(nullptr); \
+    static FAST_C_METHOD_COLD ret _fast_mock_##name(A1 _1, A2 _2) \
+    { \
+        if (auto locked_##name = _mock_##name.lock()) \
+            locked_##name->name(_1, _2); \
+    } \
+    Mock_##name::Mock_##name() \
+    { \
+        TESTFW_REGISTER_MOCK_INSTANCE(_mock_##name); \
+        if (_mock_##name.get() == this) \
+            _fast_##name.store(_fast_mock_##name, std::memory_order_release); \
+    } \
+    Mock_##name::~Mock_##name() \
+    { \
+        if (_mock_##name.get() == this) \
+            _fast_##name.store(nullptr, std::memory_order_relaxed); \
+        TESTFW_UNREGISTER_MOCK_INSTANCE(_mock_##name); \
+    } \
+    ret name(A1 _1, A2 _2) \
+    { \
+        ret (*const fast_##name)(A1, A2) = _fast_##name.load(std::memory_order_relaxed); \
+        if (FAST_C_METHOD_MOCKED(fast_##name)) \
+            fast_##name(_1, _2); \
+    }
+
+// 3 引数 非 void 戻り値 (高速版)
+#define FAST_C_METHOD3_NONVOID_CC(ret, name, A1, A2, A3, default_lambda) \
+    testfw::MockSlot<Mock_##name> _mock_##name; \
+    static std::atomic<ret (*)(A1, A2, A3)> _fast_##name(nullptr); \
+    static FAST_C_METHOD_COLD ret _fast_mock_##name(A1 _1, A2 _2, A3 _3) \
+    { \
+        auto locked_##name = _mock_##name.lock(); \
+        return locked_##name ? locked_##name->name(_1, _2, _3) : default_lambda(_1, _2, _3); \
+    } \
+    Mock_##name::Mock_##name() \
+    { \
+        ON_CALL(*this, name(_, _, _)).WillByDefault(Invoke(default_lambda)); \
+        TESTFW_REGISTER_MOCK_INSTANCE(_mock_##name); \
+        if (_mock_##name.get() == this) \
+            _fast_##name.store(_fast_mock_##name, std::memory_order_release); \
+    } \
+    Mock_##name::~Mock_##name() \
+    { \
+        if (_mock_##name.get() == this) \
+            _fast_##name.store(nullptr, std::memory_order_relaxed); \
+        TESTFW_UNREGISTER_MOCK_INSTANCE(_mock_##name); \
+    } \
+    ret name(A1 _1, A2 _2, A3 _3) \
+    { \
+        ret (*const fast_##name)(A1, A2, A3) = _fast_##name.load(std::memory_order_relaxed); \
+        if (FAST_C_METHOD_MOCKED(fast_##name)) \
+        { \
+            return fast_##name(_1, _2, _3); \
+        } \
+        return default_lambda(_1, _2, _3); \
+    }
+
+// 3 引数 void 戻り値 (高速版)
+#define FAST_C_METHOD3_VOID_CC(ret, name, A1, A2, A3) \
+    testfw::MockSlot<Mock_##name> _mock_##name; \
+    static std::atomic<ret (*)(A1, A2, A3)> _fast_##name(nullptr); \
+    static FAST_C_METHOD_COLD ret _fast_mock_##name(A1 _1, A2 _2, A3 _3) \
+    { \
+        if (auto locked_##name = _mock_##name.lock()) \
+            locked_##name->name(_1, _2, _3); \
+    } \
+    Mock_##name::Mock_##name() \
+    { \
+        TESTFW_REGISTER_MOCK_INSTANCE(_mock_##name); \
+        if (_mock_##name.get() == this) \
+            _fast_##name.store(_fast_mock_##name, std::memory_order_release); \
+    } \
+    Mock_##name::~Mock_##name() \
+    { \
+        if (_mock_##name.get() == this) \
+            _fast_##name.store(nullptr, std::memory_order_relaxed); \
+        TESTFW_UNREGISTER_MOCK_INSTANCE(_mock_##name); \
+    } \
+    ret name(A1 _1, A2 _2, A3 _3) \
+    { \
+        ret (*const fast_##name)(A1, A2, A3) = _fast_##name.load(std::memory_order_relaxed); \
+        if (FAST_C_METHOD_MOCKED(fast_##name)) \
+            fast_##name(_1, _2, _3); \
+    }
+
+// 4 引数 非 void 戻り値 (高速版)
+#define FAST_C_METHOD4_NONVOID_CC(ret, name, A1, A2, A3, A4, default_lambda) \
+    testfw::MockSlot<Mock_##name> _mock_##name; \
+    static std::atomic<ret (*)(A1, A2, A3, A4)> _fast_##name(nullptr); \
+    static FAST_C_METHOD_COLD ret _fast_mock_##name(A1 _1, A2 _2, A3 _3, A4 _4) \
+    { \
+        auto locked_##name = _mock_##name.lock(); \
+        return locked_##name ? locked_##name->name(_1, _2, _3, _4) : default_lambda(_1, _2, _3, _4); \
+    } \
+    Mock_##name::Mock_##name() \
+    { \
+        ON_CALL(*this, name(_, _, _, _)).WillByDefault(Invoke(default_lambda)); \
+        TESTFW_REGISTER_MOCK_INSTANCE(_mock_##name); \
+        if (_mock_##name.get() == this) \
+            _fast_##name.store(_fast_mock_##name, std::memory_order_release); \
+    } \
+    Mock_##name::~Mock_##name() \
+    { \
+        if (_mock_##name.get() == this) \
+            _fast_##name.store(nullptr, std::memory_order_relaxed); \
+        TESTFW_UNREGISTER_MOCK_INSTANCE(_mock_##name); \
+    } \
+    ret name(A1 _1, A2 _2, A3 _3, A4 _4) \
+    { \
+        ret (*const fast_##name)(A1, A2, A3, A4) = _fast_##name.load(std::memory_order_relaxed); \
+        if (FAST_C_METHOD_MOCKED(fast_##name)) \
+        { \
+            return fast_##name(_1, _2, _3, _4); \
+        } \
+        return default_lambda(_1, _2, _3, _4); \
+    }
+
+// 4 引数 void 戻り値 (高速版)
+#define FAST_C_METHOD4_VOID_CC(ret, name, A1, A2, A3, A4) \
+    testfw::MockSlot<Mock_##name> _mock_##name; \
+    static std::atomic<ret (*)(A1, A2, A3, A4)> _fast_##name(nullptr); \
+    static FAST_C_METHOD_COLD ret _fast_mock_##name(A1 _1, A2 _2, A3 _3, A4 _4) \
+    { \
+        if (auto locked_##name = _mock_##name.lock()) \
+            locked_##name->name(_1, _2, _3, _4); \
+    } \
+    Mock_##name::Mock_##name() \
+    { \
+        TESTFW_REGISTER_MOCK_INSTANCE(_mock_##name); \
+        if (_mock_##name.get() == this) \
+            _fast_##name.store(_fast_mock_##name, std::memory_order_release); \
+    } \
+    Mock_##name::~Mock_##name() \
+    { \
+        if (_mock_##name.get() == this) \
+            _fast_##name.store(nullptr, std::memory_order_relaxed); \
+        TESTFW_UNREGISTER_MOCK_INSTANCE(_mock_##name); \
+    } \
+    ret name(A1 _1, A2 _2, A3 _3, A4 _4) \
+    { \
+        ret (*const fast_##name)(A1, A2, A3, A4) = _fast_##name.load(std::memory_order_relaxed); \
+        if (FAST_C_METHOD_MOCKED(fast_##name)) \
+            fast_##name(_1, _2, _3, _4); \
+    }
+
+// 5 引数 非 void 戻り値 (高速版)
+#define FAST_C_METHOD5_NONVOID_CC(ret, name, A1, A2, A3, A4, A5, default_lambda) \
+    testfw::MockSlot<Mock_##name> _mock_##name; \
+    static std::atomic<ret (*)(A1, A2, A3, A4, A5)> _fast_##name(nullptr); \
+    static FAST_C_METHOD_COLD ret _fast_mock_##name(A1 _1, A2 _2, A3 _3, A4 _4, A5 _5) \
+    { \
+        auto locked_##name = _mock_##name.lock(); \
+        return locked_##name ? locked_##name->name(_1, _2, _3, _4, _5) : default_lambda(_1, _2, _3, _4, _5); \
+    } \
+    Mock_##name::Mock_##name() \
+    { \
+        ON_CALL(*this, name(_, _, _, _, _)).WillByDefault(Invoke(default_lambda)); \
+        TESTFW_REGISTER_MOCK_INSTANCE(_mock_##name); \
+        if (_mock_##name.get() == this) \
+            _fast_##name.store(_fast_mock_##name, std::memory_order_release); \
+    } \
+    Mock_##name::~Mock_##name() \
+    { \
+        if (_mock_##name.get() == this) \
+            _fast_##name.store(nullptr, std::memory_order_relaxed); \
+        TESTFW_UNREGISTER_MOCK_INSTANCE(_mock_##name); \
+    } \
+    ret name(A1 _1, A2 _2, A3 _3, A4 _4, A5 _5) \
+    { \
+        ret (*const fast_##name)(A1, A2, A3, A4, A5) = _fast_##name.load(std::memory_order_relaxed); \
+        if (FAST_C_METHOD_MOCKED(fast_##name)) \
+        { \
+            return fast_##name(_1, _2, _3, _4, _5); \
+        } \
+        return default_lambda(_1, _2, _3, _4, _5); \
+    }
+
+// 5 引数 void 戻り値 (高速版)
+#define FAST_C_METHOD5_VOID_CC(ret, name, A1, A2, A3, A4, A5) \
+    testfw::MockSlot<Mock_##name> _mock_##name; \
+    static std::atomic<ret (*)(A1, A2, A3, A4, A5)> _fast_##name(nullptr); \
+    static FAST_C_METHOD_COLD ret _fast_mock_##name(A1 _1, A2 _2, A3 _3, A4 _4, A5 _5) \
+    { \
+        if (auto locked_##name = _mock_##name.lock()) \
+            locked_##name->name(_1, _2, _3, _4, _5); \
+    } \
+    Mock_##name::Mock_##name() \
+    { \
+        TESTFW_REGISTER_MOCK_INSTANCE(_mock_##name); \
+        if (_mock_##name.get() == this) \
+            _fast_##name.store(_fast_mock_##name, std::memory_order_release); \
+    } \
+    Mock_##name::~Mock_##name() \
+    { \
+        if (_mock_##name.get() == this) \
+            _fast_##name.store(nullptr, std::memory_order_relaxed); \
+        TESTFW_UNREGISTER_MOCK_INSTANCE(_mock_##name); \
+    } \
+    ret name(A1 _1, A2 _2, A3 _3, A4 _4, A5 _5) \
+    { \
+        ret (*const fast_##name)(A1, A2, A3, A4, A5) = _fast_##name.load(std::memory_order_relaxed); \
+        if (FAST_C_METHOD_MOCKED(fast_##name)) \
+            fast_##name(_1, _2, _3, _4, _5); \
+    }
+
+// 6 引数 非 void 戻り値 (高速版)
+#define FAST_C_METHOD6_NONVOID_CC(ret, name, A1, A2, A3, A4, A5, A6, default_lambda) \
+    testfw::MockSlot<Mock_##name> _mock_##name; \
+    static std::atomic<ret (*)(A1, A2, A3, A4, A5, A6)> _fast_##name(nullptr); \
+    static FAST_C_METHOD_COLD ret _fast_mock_##name(A1 _1, A2 _2, A3 _3, A4 _4, A5 _5, A6 _6) \
+    { \
+        auto locked_##name = _mock_##name.lock(); \
+        return locked_##name ? locked_##name->name(_1, _2, _3, _4, _5, _6) : default_lambda(_1, _2, _3, _4, _5, _6); \
+    } \
+    Mock_##name::Mock_##name() \
+    { \
+        ON_CALL(*this, name(_, _, _, _, _, _)).WillByDefault(Invoke(default_lambda)); \
+        TESTFW_REGISTER_MOCK_INSTANCE(_mock_##name); \
+        if (_mock_##name.get() == this) \
+            _fast_##name.store(_fast_mock_##name, std::memory_order_release); \
+    } \
+    Mock_##name::~Mock_##name() \
+    { \
+        if (_mock_##name.get() == this) \
+            _fast_##name.store(nullptr, std::memory_order_relaxed); \
+        TESTFW_UNREGISTER_MOCK_INSTANCE(_mock_##name); \
+    } \
+    ret name(A1 _1, A2 _2, A3 _3, A4 _4, A5 _5, A6 _6) \
+    { \
+        ret (*const fast_##name)(A1, A2, A3, A4, A5, A6) = _fast_##name.load(std::memory_order_relaxed); \
+        if (FAST_C_METHOD_MOCKED(fast_##name)) \
+        { \
+            return fast_##name(_1, _2, _3, _4, _5, _6); \
+        } \
+        return default_lambda(_1, _2, _3, _4, _5, _6); \
+    }
+
+// 6 引数 void 戻り値 (高速版)
+#define FAST_C_METHOD6_VOID_CC(ret, name, A1, A2, A3, A4, A5, A6) \
+    testfw::MockSlot<Mock_##name> _mock_##name; \
+    static std::atomic<ret (*)(A1, A2, A3, A4, A5, A6)> _fast_##name(nullptr); \
+    static FAST_C_METHOD_COLD ret _fast_mock_##name(A1 _1, A2 _2, A3 _3, A4 _4, A5 _5, A6 _6) \
+    { \
+        if (auto locked_##name = _mock_##name.lock()) \
+            locked_##name->name(_1, _2, _3, _4, _5, _6); \
+    } \
+    Mock_##name::Mock_##name() \
+    { \
+        TESTFW_REGISTER_MOCK_INSTANCE(_mock_##name); \
+        if (_mock_##name.get() == this) \
+            _fast_##name.store(_fast_mock_##name, std::memory_order_release); \
+    } \
+    Mock_##name::~Mock_##name() \
+    { \
+        if (_mock_##name.get() == this) \
+            _fast_##name.store(nullptr, std::memory_order_relaxed); \
+        TESTFW_UNREGISTER_MOCK_INSTANCE(_mock_##name); \
+    } \
+    ret name(A1 _1, A2 _2, A3 _3, A4 _4, A5 _5, A6 _6) \
+    { \
+        ret (*const fast_##name)(A1, A2, A3, A4, A5, A6) = _fast_##name.load(std::memory_order_relaxed); \
+        if (FAST_C_METHOD_MOCKED(fast_##name)) \
+            fast_##name(_1, _2, _3, _4, _5, _6); \
+    }
+
+// 7 引数 非 void 戻り値 (高速版)
+#define FAST_C_METHOD7_NONVOID_CC(ret, name, A1, A2, A3, A4, A5, A6, A7, default_lambda) \
+    testfw::MockSlot<Mock_##name> _mock_##name; \
+    static std::atomic<ret (*)(A1, A2, A3, A4, A5, A6, A7)> _fast_##name(nullptr); \
+    static FAST_C_METHOD_COLD ret _fast_mock_##name(A1 _1, A2 _2, A3 _3, A4 _4, A5 _5, A6 _6, A7 _7) \
+    { \
+        auto locked_##name = _mock_##name.lock(); \
+        return locked_##name ? locked_##name->name(_1, _2, _3, _4, _5, _6, _7) \
+                             : default_lambda(_1, _2, _3, _4, _5, _6, _7); \
+    } \
+    Mock_##name::Mock_##name() \
+    { \
+        ON_CALL(*this, name(_, _, _, _, _, _, _)).WillByDefault(Invoke(default_lambda)); \
+        TESTFW_REGISTER_MOCK_INSTANCE(_mock_##name); \
+        if (_mock_##name.get() == this) \
+            _fast_##name.store(_fast_mock_##name, std::memory_order_release); \
+    } \
+    Mock_##name::~Mock_##name() \
+    { \
+        if (_mock_##name.get() == this) \
+            _fast_##name.store(nullptr, std::memory_order_relaxed); \
+        TESTFW_UNREGISTER_MOCK_INSTANCE(_mock_##name); \
+    } \
+    ret name(A1 _1, A2 _2, A3 _3, A4 _4, A5 _5, A6 _6, A7 _7) \
+    { \
+        ret (*const fast_##name)(A1, A2, A3, A4, A5, A6, A7) = _fast_##name.load(std::memory_order_relaxed); \
+        if (FAST_C_METHOD_MOCKED(fast_##name)) \
+        { \
+            return fast_##name(_1, _2, _3, _4, _5, _6, _7); \
+        } \
+        return default_lambda(_1, _2, _3, _4, _5, _6, _7); \
+    }
+
+// 7 引数 void 戻り値 (高速版)
+#define FAST_C_METHOD7_VOID_CC(ret, name, A1, A2, A3, A4, A5, A6, A7) \
+    testfw::MockSlot<Mock_##name> _mock_##name; \
+    static std::atomic<ret (*)(A1, A2, A3, A4, A5, A6, A7)> _fast_##name(nullptr); \
+    static FAST_C_METHOD_COLD ret _fast_mock_##name(A1 _1, A2 _2, A3 _3, A4 _4, A5 _5, A6 _6, A7 _7) \
+    { \
+        if (auto locked_##name = _mock_##name.lock()) \
+            locked_##name->name(_1, _2, _3, _4, _5, _6, _7); \
+    } \
+    Mock_##name::Mock_##name() \
+    { \
+        TESTFW_REGISTER_MOCK_INSTANCE(_mock_##name); \
+        if (_mock_##name.get() == this) \
+            _fast_##name.store(_fast_mock_##name, std::memory_order_release); \
+    } \
+    Mock_##name::~Mock_##name() \
+    { \
+        if (_mock_##name.get() == this) \
+            _fast_##name.store(nullptr, std::memory_order_relaxed); \
+        TESTFW_UNREGISTER_MOCK_INSTANCE(_mock_##name); \
+    } \
+    ret name(A1 _1, A2 _2, A3 _3, A4 _4, A5 _5, A6 _6, A7 _7) \
+    { \
+        ret (*const fast_##name)(A1, A2, A3, A4, A5, A6, A7) = _fast_##name.load(std::memory_order_relaxed); \
+        if (FAST_C_METHOD_MOCKED(fast_##name)) \
+            fast_##name(_1, _2, _3, _4, _5, _6, _7); \
+    }
+
+// 8 引数 非 void 戻り値 (高速版)
+#define FAST_C_METHOD8_NONVOID_CC(ret, name, A1, A2, A3, A4, A5, A6, A7, A8, default_lambda) \
+    testfw::MockSlot<Mock_##name> _mock_##name; \
+    static std::atomic<ret (*)(A1, A2, A3, A4, A5, A6, A7, A8)> _fast_##name(nullptr); \
+    static FAST_C_METHOD_COLD ret _fast_mock_##name(A1 _1, A2 _2, A3 _3, A4 _4, A5 _5, A6 _6, A7 _7, A8 _8) \
+    { \
+        auto locked_##name = _mock_##name.lock(); \
+        return locked_##name ? locked_##name->name(_1, _2, _3, _4, _5, _6, _7, _8) \
+                             : default_lambda(_1, _2, _3, _4, _5, _6, _7, _8); \
+    } \
+    Mock_##name::Mock_##name() \
+    { \
+        ON_CALL(*this, name(_, _, _, _, _, _, _, _)).WillByDefault(Invoke(default_lambda)); \
+        TESTFW_REGISTER_MOCK_INSTANCE(_mock_##name); \
+        if (_mock_##name.get() == this) \
+            _fast_##name.store(_fast_mock_##name, std::memory_order_release); \
+    } \
+    Mock_##name::~Mock_##name() \
+    { \
+        if (_mock_##name.get() == this) \
+            _fast_##name.store(nullptr, std::memory_order_relaxed); \
+        TESTFW_UNREGISTER_MOCK_INSTANCE(_mock_##name); \
+    } \
+    ret name(A1 _1, A2 _2, A3 _3, A4 _4, A5 _5, A6 _6, A7 _7, A8 _8) \
+    { \
+        ret (*const fast_##name)(A1, A2, A3, A4, A5, A6, A7, A8) = _fast_##name.load(std::memory_order_relaxed); \
+        if (FAST_C_METHOD_MOCKED(fast_##name)) \
+        { \
+            return fast_##name(_1, _2, _3, _4, _5, _6, _7, _8); \
+        } \
+        return default_lambda(_1, _2, _3, _4, _5, _6, _7, _8); \
+    }
+
+// 8 引数 void 戻り値 (高速版)
+#define FAST_C_METHOD8_VOID_CC(ret, name, A1, A2, A3, A4, A5, A6, A7, A8) \
+    testfw::MockSlot<Mock_##name> _mock_##name; \
+    static std::atomic<ret (*)(A1, A2, A3, A4, A5, A6, A7, A8)> _fast_##name(nullptr); \
+    static FAST_C_METHOD_COLD ret _fast_mock_##name(A1 _1, A2 _2, A3 _3, A4 _4, A5 _5, A6 _6, A7 _7, A8 _8) \
+    { \
+        if (auto locked_##name = _mock_##name.lock()) \
+            locked_##name->name(_1, _2, _3, _4, _5, _6, _7, _8); \
+    } \
+    Mock_##name::Mock_##name() \
+    { \
+        TESTFW_REGISTER_MOCK_INSTANCE(_mock_##name); \
+        if (_mock_##name.get() == this) \
+            _fast_##name.store(_fast_mock_##name, std::memory_order_release); \
+    } \
+    Mock_##name::~Mock_##name() \
+    { \
+        if (_mock_##name.get() == this) \
+            _fast_##name.store(nullptr, std::memory_order_relaxed); \
+        TESTFW_UNREGISTER_MOCK_INSTANCE(_mock_##name); \
+    } \
+    ret name(A1 _1, A2 _2, A3 _3, A4 _4, A5 _5, A6 _6, A7 _7, A8 _8) \
+    { \
+        ret (*const fast_##name)(A1, A2, A3, A4, A5, A6, A7, A8) = _fast_##name.load(std::memory_order_relaxed); \
+        if (FAST_C_METHOD_MOCKED(fast_##name)) \
+            fast_##name(_1, _2, _3, _4, _5, _6, _7, _8); \
+    }
+
+// 9 引数 非 void 戻り値 (高速版)
+#define FAST_C_METHOD9_NONVOID_CC(ret, name, A1, A2, A3, A4, A5, A6, A7, A8, A9, default_lambda) \
+    testfw::MockSlot<Mock_##name> _mock_##name; \
+    static std::atomic<ret (*)(A1, A2, A3, A4, A5, A6, A7, A8, A9)> _fast_##name(nullptr); \
+    static FAST_C_METHOD_COLD ret _fast_mock_##name(A1 _1, A2 _2, A3 _3, A4 _4, A5 _5, A6 _6, A7 _7, A8 _8, A9 _9) \
+    { \
+        auto locked_##name = _mock_##name.lock(); \
+        return locked_##name ? locked_##name->name(_1, _2, _3, _4, _5, _6, _7, _8, _9) \
+                             : default_lambda(_1, _2, _3, _4, _5, _6, _7, _8, _9); \
+    } \
+    Mock_##name::Mock_##name() \
+    { \
+        ON_CALL(*this, name(_, _, _, _, _, _, _, _, _)).WillByDefault(Invoke(default_lambda)); \
+        TESTFW_REGISTER_MOCK_INSTANCE(_mock_##name); \
+        if (_mock_##name.get() == this) \
+            _fast_##name.store(_fast_mock_##name, std::memory_order_release); \
+    } \
+    Mock_##name::~Mock_##name() \
+    { \
+        if (_mock_##name.get() == this) \
+            _fast_##name.store(nullptr, std::memory_order_relaxed); \
+        TESTFW_UNREGISTER_MOCK_INSTANCE(_mock_##name); \
+    } \
+    ret name(A1 _1, A2 _2, A3 _3, A4 _4, A5 _5, A6 _6, A7 _7, A8 _8, A9 _9) \
+    { \
+        ret (*const fast_##name)(A1, A2, A3, A4, A5, A6, A7, A8, A9) = _fast_##name.load(std::memory_order_relaxed); \
+        if (FAST_C_METHOD_MOCKED(fast_##name)) \
+        { \
+            return fast_##name(_1, _2, _3, _4, _5, _6, _7, _8, _9); \
+        } \
+        return default_lambda(_1, _2, _3, _4, _5, _6, _7, _8, _9); \
+    }
+
+// 9 引数 void 戻り値 (高速版)
+#define FAST_C_METHOD9_VOID_CC(ret, name, A1, A2, A3, A4, A5, A6, A7, A8, A9) \
+    testfw::MockSlot<Mock_##name> _mock_##name; \
+    static std::atomic<ret (*)(A1, A2, A3, A4, A5, A6, A7, A8, A9)> _fast_##name(nullptr); \
+    static FAST_C_METHOD_COLD ret _fast_mock_##name(A1 _1, A2 _2, A3 _3, A4 _4, A5 _5, A6 _6, A7 _7, A8 _8, A9 _9) \
+    { \
+        if (auto locked_##name = _mock_##name.lock()) \
+            locked_##name->name(_1, _2, _3, _4, _5, _6, _7, _8, _9); \
+    } \
+    Mock_##name::Mock_##name() \
+    { \
+        TESTFW_REGISTER_MOCK_INSTANCE(_mock_##name); \
+        if (_mock_##name.get() == this) \
+            _fast_##name.store(_fast_mock_##name, std::memory_order_release); \
+    } \
+    Mock_##name::~Mock_##name() \
+    { \
+        if (_mock_##name.get() == this) \
+            _fast_##name.store(nullptr, std::memory_order_relaxed); \
+        TESTFW_UNREGISTER_MOCK_INSTANCE(_mock_##name); \
+    } \
+    ret name(A1 _1, A2 _2, A3 _3, A4 _4, A5 _5, A6 _6, A7 _7, A8 _8, A9 _9) \
+    { \
+        ret (*const fast_##name)(A1, A2, A3, A4, A5, A6, A7, A8, A9) = _fast_##name.load(std::memory_order_relaxed); \
+        if (FAST_C_METHOD_MOCKED(fast_##name)) \
+            fast_##name(_1, _2, _3, _4, _5, _6, _7, _8, _9); \
+    }
+
+// 10 引数 非 void 戻り値 (高速版)
+#define FAST_C_METHOD10_NONVOID_CC(ret, name, A1, A2, A3, A4, A5, A6, A7, A8, A9, A10, default_lambda) \
+    testfw::MockSlot<Mock_##name> _mock_##name; \
+    static std::atomic<ret (*)(A1, A2, A3, A4, A5, A6, A7, A8, A9, A10)> _fast_##name(nullptr); \
+    static FAST_C_METHOD_COLD ret \
+    _fast_mock_##name(A1 _1, A2 _2, A3 _3, A4 _4, A5 _5, A6 _6, A7 _7, A8 _8, A9 _9, A10 _10) \
+    { \
+        auto locked_##name = _mock_##name.lock(); \
+        return locked_##name ? locked_##name->name(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10) \
+                             : default_lambda(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10); \
+    } \
+    Mock_##name::Mock_##name() \
+    { \
+        ON_CALL(*this, name(_, _, _, _, _, _, _, _, _, _)).WillByDefault(Invoke(default_lambda)); \
+        TESTFW_REGISTER_MOCK_INSTANCE(_mock_##name); \
+        if (_mock_##name.get() == this) \
+            _fast_##name.store(_fast_mock_##name, std::memory_order_release); \
+    } \
+    Mock_##name::~Mock_##name() \
+    { \
+        if (_mock_##name.get() == this) \
+            _fast_##name.store(nullptr, std::memory_order_relaxed); \
+        TESTFW_UNREGISTER_MOCK_INSTANCE(_mock_##name); \
+    } \
+    ret name(A1 _1, A2 _2, A3 _3, A4 _4, A5 _5, A6 _6, A7 _7, A8 _8, A9 _9, A10 _10) \
+    { \
+        ret (*const fast_##name)(A1, A2, A3, A4, A5, A6, A7, A8, A9, A10) = \
+            _fast_##name.load(std::memory_order_relaxed); \
+        if (FAST_C_METHOD_MOCKED(fast_##name)) \
+        { \
+            return fast_##name(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10); \
+        } \
+        return default_lambda(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10); \
+    }
+
+// 10 引数 void 戻り値 (高速版)
+#define FAST_C_METHOD10_VOID_CC(ret, name, A1, A2, A3, A4, A5, A6, A7, A8, A9, A10) \
+    testfw::MockSlot<Mock_##name> _mock_##name; \
+    static std::atomic<ret (*)(A1, A2, A3, A4, A5, A6, A7, A8, A9, A10)> _fast_##name(nullptr); \
+    static FAST_C_METHOD_COLD ret \
+    _fast_mock_##name(A1 _1, A2 _2, A3 _3, A4 _4, A5 _5, A6 _6, A7 _7, A8 _8, A9 _9, A10 _10) \
+    { \
+        if (auto locked_##name = _mock_##name.lock()) \
+            locked_##name->name(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10); \
+    } \
+    Mock_##name::Mock_##name() \
+    { \
+        TESTFW_REGISTER_MOCK_INSTANCE(_mock_##name); \
+        if (_mock_##name.get() == this) \
+            _fast_##name.store(_fast_mock_##name, std::memory_order_release); \
+    } \
+    Mock_##name::~Mock_##name() \
+    { \
+        if (_mock_##name.get() == this) \
+            _fast_##name.store(nullptr, std::memory_order_relaxed); \
+        TESTFW_UNREGISTER_MOCK_INSTANCE(_mock_##name); \
+    } \
+    ret name(A1 _1, A2 _2, A3 _3, A4 _4, A5 _5, A6 _6, A7 _7, A8 _8, A9 _9, A10 _10) \
+    { \
+        ret (*const fast_##name)(A1, A2, A3, A4, A5, A6, A7, A8, A9, A10) = \
+            _fast_##name.load(std::memory_order_relaxed); \
+        if (FAST_C_METHOD_MOCKED(fast_##name)) \
+            fast_##name(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10); \
     }
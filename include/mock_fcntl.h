@@ -41,6 +41,7 @@ extern "C"
         #pragma GCC diagnostic push
         #pragma GCC diagnostic ignored "-Wpadded"
         #include <gmock/gmock.h>
+        #include <mock_instance.h>
         #pragma GCC diagnostic pop
 
 extern int delegate_real_open(const char *, const int, const char *, const char *, int, int);
@@ -56,7 +57,7 @@ class Mock_fcntl
     ~Mock_fcntl();
 };
 
-extern Mock_fcntl *_mock_fcntl;
+extern testfw::MockSlot<Mock_fcntl> _mock_fcntl;
 
     #endif // _IN_OVERRIDE_HEADER_FCNTL_H
 
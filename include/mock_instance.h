@@ -3,59 +3,440 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <utility>
 
 namespace testfw
 {
+
+template <typename MockType> class MockSlot;
+
+/**
+ * MockSlot::lock() が返す、mock 呼び出し中であることを示すガード。
+ * ガードが生存している間、MockSlot の登録解除 (mock のデストラクター) は呼び出しの完了を待つ。
+ */
+template <typename MockType> class MockCallGuard
+{
+  public:
+    MockCallGuard() = default;
+
+    MockCallGuard(MockCallGuard &&other) noexcept : in_flight_(other.in_flight_), mock_(other.mock_)
+    {
+        other.in_flight_ = nullptr;
+        other.mock_ = nullptr;
+    }
+
+    MockCallGuard(const MockCallGuard &) = delete;
+    MockCallGuard &operator=(const MockCallGuard &) = delete;
+    MockCallGuard &operator=(MockCallGuard &&) = delete;
+
+    ~MockCallGuard()
+    {
+        if (in_flight_ != nullptr)
+        {
+            in_flight_->fetch_sub(1U, std::memory_order_release);
+        }
+    }
+
+    explicit operator bool() const
+    {
+        return mock_ != nullptr;
+    }
+
+    MockType *operator->() const
+    {
+        return mock_;
+    }
+
+    MockType &operator*() const
+    {
+        return *mock_;
+    }
+
+    MockType *get() const
+    {
+        return mock_;
+    }
+
+  private:
+    friend class MockSlot<MockType>;
+
+    MockCallGuard(std::atomic<std::size_t> *in_flight, MockType *mock) : in_flight_(in_flight), mock_(mock)
+    {
+    }
+
+    std::atomic<std::size_t> *in_flight_ = nullptr;
+    MockType *mock_ = nullptr;
+};
+
+/**
+ * mock オブジェクトの登録先 (_mock_<lib>)。
+ * 登録は release で公開し、mock 関数本体は lock() で取得したガード経由で呼び出す。
+ * mock 未生成時の lock() は relaxed ロード 1 回のみで空のガードを返す。
+ * 登録解除は、すでに lock() で取得済みの呼び出しがすべて完了するまで待機する
+ * (テスト対象コードのワーカー スレッドが mock を呼び出している最中に mock を破棄しない)。
+ *
+ * mock 関数本体での使用例:
+ *   if (auto locked_sample = _mock_sample.lock())
+ *   {
+ *       mock_ret = locked_sample->sample_func(...);
+ *   }
+ *
+ * TESTFW_TRACK_MOCK_METHOD でメソッドを追跡する mock では lock(method_bit) を使用する。
+ * 既定ではすべてのメソッドを gmock 経由とし (StrictMock / NaggyMock の未設定の呼び出しの検出を維持する)、
+ * bypassUnconfigured() の後は、EXPECT_CALL / ON_CALL を設定していないメソッドは gmock を経由せず本物へ委譲する。
+ */
+template <typename MockType> class MockSlot
+{
+  public:
+    constexpr MockSlot() noexcept : mock_(nullptr), in_flight_(0U), intercepted_(0U), configured_(0U)
+    {
+    }
+
+    MockSlot(const MockSlot &) = delete;
+    MockSlot &operator=(const MockSlot &) = delete;
+
+    MockCallGuard<MockType> lock()
+    {
+        if (mock_.load(std::memory_order_relaxed) == nullptr)
+        {
+            return MockCallGuard<MockType>();
+        }
+
+        // 呼び出し中の計数を先に増やしてから登録を読み直す。
+        // 登録解除側は nullptr を書き込んでから計数を読むため、両者を seq_cst とすることで
+        // 「解除済みを読む」か「解除側が計数の増加を観測する」のいずれかが必ず成立する。
+        in_flight_.fetch_add(1U, std::memory_order_seq_cst);
+        MockType *mock = mock_.load(std::memory_order_seq_cst);
+        if (mock == nullptr)
+        {
+            in_flight_.fetch_sub(1U, std::memory_order_release);
+            return MockCallGuard<MockType>();
+        }
+
+        return MockCallGuard<MockType>(&in_flight_, mock);
+    }
+
+    /**
+     * method_bit のメソッドを gmock 経由とする場合のみ lock() する (bypassUnconfigured() の前はすべてのメソッド)。
+     * 対象外の場合 (mock 未生成時を含む) は acquire ロード 1 回のみで空のガードを返す。
+     */
+    MockCallGuard<MockType> lock(std::uint64_t method_bit)
+    {
+        if ((intercepted_.load(std::memory_order_acquire) & method_bit) == 0U)
+        {
+            return MockCallGuard<MockType>();
+        }
+
+        return lock();
+    }
+
+    /**
+     * mock の method_bits のメソッドに EXPECT_CALL / ON_CALL が設定されたことを記録する。
+     * 登録中の mock 以外 (多重生成で登録されなかったインスタンスや、登録前のコンストラクター) の設定は記録しない。
+     */
+    void markIntercepted(const MockType *mock, std::uint64_t method_bits)
+    {
+        if (mock_.load(std::memory_order_acquire) != mock)
+        {
+            return;
+        }
+        configured_.fetch_or(method_bits, std::memory_order_relaxed);
+        intercepted_.fetch_or(method_bits, std::memory_order_release);
+    }
+
+    /**
+     * 以降、EXPECT_CALL / ON_CALL を設定していないメソッドは gmock を経由せず本物へ委譲する (opt-in)。
+     * すでに設定したメソッドは gmock 経由のまま。mock が登録中の mock でない場合は何もしない。
+     * 未設定のメソッドの呼び出しは gmock に届かないため、StrictMock / NaggyMock では使用しないこと。
+     */
+    void bypassUnconfigured(const MockType *mock)
+    {
+        if (mock_.load(std::memory_order_acquire) != mock)
+        {
+            return;
+        }
+        intercepted_.store(configured_.load(std::memory_order_relaxed), std::memory_order_release);
+    }
+
+    /** 登録中の mock オブジェクト (ガードを伴わない参照。テストでの確認用)。 */
+    MockType *get() const
+    {
+        return mock_.load(std::memory_order_acquire);
+    }
+
+    explicit operator bool() const
+    {
+        return mock_.load(std::memory_order_relaxed) != nullptr;
+    }
+
+    bool operator==(std::nullptr_t) const
+    {
+        return !static_cast<bool>(*this);
+    }
+
+    bool operator!=(std::nullptr_t) const
+    {
+        return static_cast<bool>(*this);
+    }
+
+    /** 登録する。mock の構築 (ON_CALL 等) の完了後に呼び出すこと。 */
+    void publish(MockType *mock)
+    {
+        // 既定ではすべてのメソッドを gmock 経由とする。コンストラクターの既定動作 (本物への委譲) の設定は、
+        // 登録前のため設定として記録されない。
+        configured_.store(0U, std::memory_order_relaxed);
+        intercepted_.store(~std::uint64_t{0}, std::memory_order_relaxed);
+        mock_.store(mock, std::memory_order_release);
+    }
+
+    /**
+     * 未登録の場合のみ登録する (nullptr からの compare_exchange)。
+     * 同時に登録を試みたスレッドのうち 1 個のみが true を得る。他の mock が登録済みの場合は false を返す。
+     */
+    bool tryPublish(MockType *mock)
+    {
+        MockType *expected = nullptr;
+        if (!mock_.compare_exchange_strong(expected, mock, std::memory_order_acq_rel))
+        {
+            return false;
+        }
+        configured_.store(0U, std::memory_order_relaxed);
+        intercepted_.store(~std::uint64_t{0}, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * 登録を解除し、lock() 済みの呼び出しの完了を待つ。
+     * timeout を過ぎても完了しない場合は false を返す (mock の中でブロックしているスレッドがある)。
+     */
+    bool retire(MockType *mock, std::chrono::milliseconds timeout)
+    {
+        MockType *expected = mock;
+        if (!mock_.compare_exchange_strong(expected, nullptr, std::memory_order_seq_cst))
+        {
+            return true;
+        }
+        intercepted_.store(0U, std::memory_order_relaxed);
+        configured_.store(0U, std::memory_order_relaxed);
+
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (in_flight_.load(std::memory_order_seq_cst) != 0U)
+        {
+            if (std::chrono::steady_clock::now() >= deadline)
+            {
+                return false;
+            }
+            std::this_thread::yield();
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        return true;
+    }
+
+  private:
+    std::atomic<MockType *> mock_;
+    std::atomic<std::size_t> in_flight_;
+    std::atomic<std::uint64_t> intercepted_; ///< gmock 経由とするメソッドのビット集合
+    std::atomic<std::uint64_t> configured_;  ///< EXPECT_CALL / ON_CALL が設定されたメソッドのビット集合
+};
+
 namespace internal
 {
 
-template <typename MockType> inline std::size_t &mockInstanceCount()
+/** 登録解除時に、mock の呼び出し中のスレッドを待つ上限時間。 */
+constexpr std::chrono::milliseconds kMockRetireTimeout{5000};
+
+/** I 番目の引数の型。範囲外の場合は MockArgumentOutOfRange とする (引数の数が異なるオーバーロードの除外用)。 */
+struct MockArgumentOutOfRange
+{
+};
+
+template <std::size_t I, typename... Args> struct MockArgumentAt
+{
+    using type = MockArgumentOutOfRange;
+};
+
+template <typename First, typename... Rest> struct MockArgumentAt<0U, First, Rest...>
 {
-    static std::size_t count = 0U;
+    using type = First;
+};
+
+template <std::size_t I, typename First, typename... Rest> struct MockArgumentAt<I, First, Rest...>
+{
+    using type = typename MockArgumentAt<I - 1U, Rest...>::type;
+};
+
+/** MOCK_METHOD で宣言したメソッドの関数型と、I 番目の引数の Matcher の型。 */
+template <typename Method> struct MockMethodMatchers;
+
+template <typename Class, typename Result, typename... Args> struct MockMethodMatchers<Result (Class::*)(Args...)>
+{
+    using function = Result(Args...);
+    template <std::size_t I> using matcher = ::testing::Matcher<typename MockArgumentAt<I, Args...>::type>;
+};
+
+template <typename MockType> inline std::atomic<std::size_t> &mockInstanceCount()
+{
+    static std::atomic<std::size_t> count{0U};
 
     return count;
 }
 
 template <typename MockType>
-inline void registerMockInstance(MockType *&registered_mock, MockType *instance, const char *slot_name,
-                                 const char *file, int line)
+inline bool acquireMockInstanceCount(const char *slot_name, const char *file, int line)
 {
-    std::size_t &count = mockInstanceCount<MockType>();
-
-    if (count != 0U)
+    if (mockInstanceCount<MockType>().fetch_add(1U, std::memory_order_acq_rel) != 0U)
     {
         ADD_FAILURE_AT(file, line) << "Only one mock instance may exist for " << slot_name << " at a time.";
+        return false;
     }
-    else
+    return true;
+}
+
+template <typename MockType> inline bool releaseMockInstanceCount(const char *slot_name, const char *file, int line)
+{
+    std::atomic<std::size_t> &count = mockInstanceCount<MockType>();
+    std::size_t current = count.load(std::memory_order_acquire);
+
+    do
+    {
+        if (current == 0U)
+        {
+            ADD_FAILURE_AT(file, line) << "Mock instance count is already zero for " << slot_name << ".";
+            return false;
+        }
+    } while (!count.compare_exchange_weak(current, current - 1U, std::memory_order_acq_rel));
+
+    return true;
+}
+
+template <typename MockType>
+inline void registerMockInstance(MockType *&registered_mock, MockType *instance, const char *slot_name,
+                                 const char *file, int line)
+{
+    if (acquireMockInstanceCount<MockType>(slot_name, file, line))
     {
         registered_mock = instance;
     }
-    ++count;
 }
 
 template <typename MockType>
 inline void unregisterMockInstance(MockType *&registered_mock, MockType *instance, const char *slot_name,
                                    const char *file, int line)
 {
-    std::size_t &count = mockInstanceCount<MockType>();
-
-    if (count == 0U)
+    if (!releaseMockInstanceCount<MockType>(slot_name, file, line))
     {
-        ADD_FAILURE_AT(file, line) << "Mock instance count is already zero for " << slot_name << ".";
         return;
     }
 
-    --count;
     if (registered_mock == instance)
     {
         registered_mock = nullptr;
     }
 }
 
+template <typename MockType>
+inline void registerMockInstance(MockSlot<MockType> &registered_mock, MockType *instance, const char *slot_name,
+                                 const char *file, int line)
+{
+    if (acquireMockInstanceCount<MockType>(slot_name, file, line))
+    {
+        registered_mock.publish(instance);
+    }
+}
+
+template <typename MockType>
+inline void unregisterMockInstance(MockSlot<MockType> &registered_mock, MockType *instance, const char *slot_name,
+                                   const char *file, int line)
+{
+    if (!releaseMockInstanceCount<MockType>(slot_name, file, line))
+    {
+        return;
+    }
+
+    if (!registered_mock.retire(instance, kMockRetireTimeout))
+    {
+        ADD_FAILURE_AT(file, line) << "Mock calls through " << slot_name << " did not finish within "
+                                   << kMockRetireTimeout.count() << " ms while destroying the mock instance.";
+    }
+}
+
 } // namespace internal
 } // namespace testfw
 
+/**
+ * MOCK_METHOD で宣言したメソッドへの EXPECT_CALL / ON_CALL を mock_slot に記録する。
+ * MOCK_METHOD は基底クラス base に宣言し、本マクロは派生クラス (テストが生成する Mock_<lib>) の public 部に記述する。
+ * Mock_<lib>::METHOD_<method> が mock 関数本体で lock() に渡すビットとなる (bit_index は 0 から 63)。
+ * gmock が生成する gmock_<method> と同じく、引数は型付きの Matcher で受け取る (引数の変換は呼び出し元で行う)。
+ * 引数の数ごとのオーバーロードを定義し、引数の数が異なるものは呼び出しの候補から外れる (引数は 1 個から 9 個まで)。
+ */
+#define TESTFW_TRACK_MOCK_METHOD(mock_slot, base, method, bit_index) \
+    static constexpr std::uint64_t METHOD_##method = std::uint64_t{1} << (bit_index); \
+    TESTFW_INTERNAL_TRACK_MATCHERS(mock_slot, base, method, (TESTFW_INTERNAL_MATCHER(0)), (m0)) \
+    TESTFW_INTERNAL_TRACK_MATCHERS(mock_slot, base, method, (TESTFW_INTERNAL_MATCHER(0), TESTFW_INTERNAL_MATCHER(1)), \
+                                   (m0, m1)) \
+    TESTFW_INTERNAL_TRACK_MATCHERS(mock_slot, base, method, \
+                                   (TESTFW_INTERNAL_MATCHER(0), TESTFW_INTERNAL_MATCHER(1), \
+                                    TESTFW_INTERNAL_MATCHER(2)), \
+                                   (m0, m1, m2)) \
+    TESTFW_INTERNAL_TRACK_MATCHERS(mock_slot, base, method, \
+                                   (TESTFW_INTERNAL_MATCHER(0), TESTFW_INTERNAL_MATCHER(1), \
+                                    TESTFW_INTERNAL_MATCHER(2), TESTFW_INTERNAL_MATCHER(3)), \
+                                   (m0, m1, m2, m3)) \
+    TESTFW_INTERNAL_TRACK_MATCHERS(mock_slot, base, method, \
+                                   (TESTFW_INTERNAL_MATCHER(0), TESTFW_INTERNAL_MATCHER(1), \
+                                    TESTFW_INTERNAL_MATCHER(2), TESTFW_INTERNAL_MATCHER(3), \
+                                    TESTFW_INTERNAL_MATCHER(4)), \
+                                   (m0, m1, m2, m3, m4)) \
+    TESTFW_INTERNAL_TRACK_MATCHERS(mock_slot, base, method, \
+                                   (TESTFW_INTERNAL_MATCHER(0), TESTFW_INTERNAL_MATCHER(1), \
+                                    TESTFW_INTERNAL_MATCHER(2), TESTFW_INTERNAL_MATCHER(3), \
+                                    TESTFW_INTERNAL_MATCHER(4), TESTFW_INTERNAL_MATCHER(5)), \
+                                   (m0, m1, m2, m3, m4, m5)) \
+    TESTFW_INTERNAL_TRACK_MATCHERS(mock_slot, base, method, \
+                                   (TESTFW_INTERNAL_MATCHER(0), TESTFW_INTERNAL_MATCHER(1), \
+                                    TESTFW_INTERNAL_MATCHER(2), TESTFW_INTERNAL_MATCHER(3), \
+                                    TESTFW_INTERNAL_MATCHER(4), TESTFW_INTERNAL_MATCHER(5), \
+                                    TESTFW_INTERNAL_MATCHER(6)), \
+                                   (m0, m1, m2, m3, m4, m5, m6)) \
+    TESTFW_INTERNAL_TRACK_MATCHERS(mock_slot, base, method, \
+                                   (TESTFW_INTERNAL_MATCHER(0), TESTFW_INTERNAL_MATCHER(1), \
+                                    TESTFW_INTERNAL_MATCHER(2), TESTFW_INTERNAL_MATCHER(3), \
+                                    TESTFW_INTERNAL_MATCHER(4), TESTFW_INTERNAL_MATCHER(5), \
+                                    TESTFW_INTERNAL_MATCHER(6), TESTFW_INTERNAL_MATCHER(7)), \
+                                   (m0, m1, m2, m3, m4, m5, m6, m7)) \
+    TESTFW_INTERNAL_TRACK_MATCHERS(mock_slot, base, method, \
+                                   (TESTFW_INTERNAL_MATCHER(0), TESTFW_INTERNAL_MATCHER(1), \
+                                    TESTFW_INTERNAL_MATCHER(2), TESTFW_INTERNAL_MATCHER(3), \
+                                    TESTFW_INTERNAL_MATCHER(4), TESTFW_INTERNAL_MATCHER(5), \
+                                    TESTFW_INTERNAL_MATCHER(6), TESTFW_INTERNAL_MATCHER(7), \
+                                    TESTFW_INTERNAL_MATCHER(8)), \
+                                   (m0, m1, m2, m3, m4, m5, m6, m7, m8)) \
+    decltype(auto) gmock_##method(const ::testing::internal::WithoutMatchers &without_matchers, \
+                                  ::testing::internal::Function<typename ::testfw::internal::MockMethodMatchers< \
+                                      decltype(&base::method)>::function> *function) \
+    { \
+        (mock_slot).markIntercepted(this, METHOD_##method); \
+        return base::gmock_##method(without_matchers, function); \
+    }
+
+// TESTFW_TRACK_MOCK_METHOD の引数の数ごとのオーバーロード。Matcher の型はメソッドの型から導出する
+// (既定のテンプレート引数に依存させ、引数の数が異なるオーバーロードの型を呼び出しまで確定させない)。
+#define TESTFW_INTERNAL_MATCHER(index) const typename Matchers::template matcher<index> &m##index
+#define TESTFW_INTERNAL_TRACK_MATCHERS(mock_slot, base, method, params, args) \
+    template <typename Matchers = ::testfw::internal::MockMethodMatchers<decltype(&base::method)>> \
+    decltype(auto) gmock_##method params \
+    { \
+        (mock_slot).markIntercepted(this, METHOD_##method); \
+        return base::gmock_##method args; \
+    }
+
 #define TESTFW_REGISTER_MOCK_INSTANCE(mock_slot) \
     ::testfw::internal::registerMockInstance((mock_slot), this, #mock_slot, __FILE__, __LINE__)
 #define TESTFW_UNREGISTER_MOCK_INSTANCE(mock_slot) \
@@ -23,6 +23,7 @@ extern "C"
         #pragma GCC diagnostic push
         #pragma GCC diagnostic ignored "-Wpadded"
         #include <gmock/gmock.h>
+        #include <mock_instance.h>
         #pragma GCC diagnostic pop
 
 extern int delegate_real_ioctl(const char *, const int, const char *, int, unsigned long, void *);
@@ -36,7 +37,7 @@ class Mock_ioctl
     ~Mock_ioctl();
 };
 
-extern Mock_ioctl *_mock_ioctl;
+extern testfw::MockSlot<Mock_ioctl> _mock_ioctl;
 
     #endif // _IN_OVERRIDE_HEADER_SYS_IOCTL_H
 
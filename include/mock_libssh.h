@@ -124,6 +124,15 @@ extern "C"
     #define SSH_FILEXFER_TYPE_UNKNOWN   5
 #endif
 
+/* SFTP 属性フラグ定義 */
+#ifndef SFTP_ATTR_FLAGS_DEFINED
+    #define SFTP_ATTR_FLAGS_DEFINED
+    #define SSH_FILEXFER_ATTR_SIZE        0x00000001
+    #define SSH_FILEXFER_ATTR_UIDGID      0x00000002
+    #define SSH_FILEXFER_ATTR_PERMISSIONS 0x00000004
+    #define SSH_FILEXFER_ATTR_ACMODTIME   0x00000008
+#endif
+
 /* SFTP アクセス フラグ定義 */
 #ifndef SFTP_FLAGS_DEFINED
     #define SFTP_FLAGS_DEFINED
@@ -380,6 +389,7 @@ extern "C"
         #pragma GCC diagnostic ignored "-Wpadded"
     #endif // _WIN32
     #include <gmock/gmock.h>
+    #include <mock_instance.h>
     #ifndef _WIN32
         #pragma GCC diagnostic pop
     #endif // _WIN32
@@ -602,7 +612,7 @@ class Mock_libssh
     ~Mock_libssh();
 };
 
-extern Mock_libssh *_mock_libssh;
+extern testfw::MockSlot<Mock_libssh> _mock_libssh;
 
 #endif // _IN_OVERRIDE_HEADER_LIBSSH_H
 
@@ -33,6 +33,7 @@ extern "C"
         #pragma GCC diagnostic push
         #pragma GCC diagnostic ignored "-Wpadded"
         #include <gmock/gmock.h>
+        #include <mock_instance.h>
         #pragma GCC diagnostic pop
 
 extern int delegate_real_getaddrinfo(const char *, const int, const char *, const char *, const char *, const struct addrinfo *, struct addrinfo **);
@@ -50,7 +51,7 @@ class Mock_netdb
     ~Mock_netdb();
 };
 
-extern Mock_netdb *_mock_netdb;
+extern testfw::MockSlot<Mock_netdb> _mock_netdb;
 
     #endif // _IN_OVERRIDE_HEADER_NETDB_H
 
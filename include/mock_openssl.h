@@ -65,6 +65,7 @@ extern "C"
     #pragma GCC diagnostic push
     #pragma GCC diagnostic ignored "-Wpadded"
     #include <gmock/gmock.h>
+    #include <mock_instance.h>
     #pragma GCC diagnostic pop
 
 extern EVP_CIPHER_CTX *delegate_real_EVP_CIPHER_CTX_new(const char *, const int, const char *);
@@ -126,7 +127,7 @@ class Mock_openssl
     ~Mock_openssl();
 };
 
-extern Mock_openssl *_mock_openssl;
+extern testfw::MockSlot<Mock_openssl> _mock_openssl;
 
 #endif // _IN_OVERRIDE_HEADER_OPENSSL_H
 
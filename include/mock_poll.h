@@ -28,6 +28,7 @@ extern "C"
         #pragma GCC diagnostic push
         #pragma GCC diagnostic ignored "-Wpadded"
         #include <gmock/gmock.h>
+        #include <mock_instance.h>
         #pragma GCC diagnostic pop
 
 extern int delegate_real_poll(const char *, const int, const char *, struct pollfd *, nfds_t, int);
@@ -41,7 +42,7 @@ class Mock_poll
     ~Mock_poll();
 };
 
-extern Mock_poll *_mock_poll;
+extern testfw::MockSlot<Mock_poll> _mock_poll;
 
     #endif // _IN_OVERRIDE_HEADER_POLL_H
 
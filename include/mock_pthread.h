@@ -77,6 +77,8 @@ extern "C"
         #pragma GCC diagnostic push
         #pragma GCC diagnostic ignored "-Wpadded"
         #include <gmock/gmock.h>
+        #include <mock_instance.h>
+        #include <fake_function.h>
         #pragma GCC diagnostic pop
 
 extern int delegate_real_pthread_mutex_init(const char *, const int, const char *, pthread_mutex_t *,
@@ -145,7 +147,15 @@ class Mock_pthread
     ~Mock_pthread();
 };
 
-extern Mock_pthread *_mock_pthread;
+extern testfw::MockSlot<Mock_pthread> _mock_pthread;
+
+// gmock を経由しない fake (大量に呼ばれる箇所の差し替え用)
+extern testfw::FakeSlot<int(pthread_mutex_t *)> _fake_pthread_mutex_lock;
+extern testfw::FakeSlot<int(pthread_mutex_t *)> _fake_pthread_mutex_trylock;
+extern testfw::FakeSlot<int(pthread_mutex_t *)> _fake_pthread_mutex_unlock;
+using Fake_pthread_mutex_lock = testfw::FakeFunction<int(pthread_mutex_t *), _fake_pthread_mutex_lock>;
+using Fake_pthread_mutex_trylock = testfw::FakeFunction<int(pthread_mutex_t *), _fake_pthread_mutex_trylock>;
+using Fake_pthread_mutex_unlock = testfw::FakeFunction<int(pthread_mutex_t *), _fake_pthread_mutex_unlock>;
 
     #endif // _IN_OVERRIDE_HEADER_PTHREAD_H
 
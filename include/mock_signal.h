@@ -31,6 +31,7 @@ extern "C"
         #pragma GCC diagnostic push
         #pragma GCC diagnostic ignored "-Wpadded"
         #include <gmock/gmock.h>
+        #include <mock_instance.h>
         #pragma GCC diagnostic pop
 
 extern int delegate_real_sigaction(const char *, const int, const char *, int, const struct sigaction *,
@@ -52,7 +53,7 @@ class Mock_signal
     ~Mock_signal();
 };
 
-extern Mock_signal *_mock_signal;
+extern testfw::MockSlot<Mock_signal> _mock_signal;
 
     #endif // _IN_OVERRIDE_HEADER_SIGNAL_H
 
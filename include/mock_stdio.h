@@ -102,6 +102,7 @@ extern __int64 mock__ftelli64(const char *, const int, const char *, FILE *);
         #pragma GCC diagnostic ignored "-Wpadded"
     #endif // _WIN32
     #include <gmock/gmock.h>
+    #include <mock_instance.h>
     #ifndef _WIN32
         #pragma GCC diagnostic pop
     #endif // _WIN32
@@ -165,7 +166,11 @@ extern __int64 delegate_real__ftelli64(const char *, const int, const char *, FI
 extern __int64 delegate_fake__ftelli64(const char *, const int, const char *, FILE *);
     #endif
 
-class Mock_stdio
+class Mock_stdio;
+extern testfw::MockSlot<Mock_stdio> _mock_stdio;
+
+// gmock のメソッド宣言。EXPECT_CALL / ON_CALL は派生クラス Mock_stdio に対して設定する。
+class Mock_stdio_methods
 {
   public:
     MOCK_METHOD(int, access, (const char *, const int, const char *, const char *, int));
@@ -186,10 +191,6 @@ class Mock_stdio
     MOCK_METHOD(char *, fgets, (const char *, const int, const char *, char *, int, FILE *));
     MOCK_METHOD(size_t, fread, (const char *, const int, const char *, void *, size_t, size_t, FILE *));
     MOCK_METHOD(size_t, fwrite, (const char *, const int, const char *, const void *, size_t, size_t, FILE *));
-
-    void switch_to_real_fileio();
-    void switch_to_mock_fileio();
-
     MOCK_METHOD(int, printf, (const char *, const int, const char *, const char *));
     MOCK_METHOD(int, scanf, (const char *, const int, const char *, const char *, va_list));
     MOCK_METHOD(int, vscanf, (const char *, const int, const char *, const char *, va_list));
@@ -205,13 +206,59 @@ class Mock_stdio
     MOCK_METHOD(int, _fseeki64, (const char *, const int, const char *, FILE *, __int64, int));
     MOCK_METHOD(__int64, _ftelli64, (const char *, const int, const char *, FILE *));
     #endif
+};
+
+class Mock_stdio : public Mock_stdio_methods
+{
+  public:
+    TESTFW_TRACK_MOCK_METHOD(_mock_stdio, Mock_stdio_methods, access, 0)
+    TESTFW_TRACK_MOCK_METHOD(_mock_stdio, Mock_stdio_methods, fclose, 1)
+    TESTFW_TRACK_MOCK_METHOD(_mock_stdio, Mock_stdio_methods, feof, 2)
+    TESTFW_TRACK_MOCK_METHOD(_mock_stdio, Mock_stdio_methods, ferror, 3)
+    TESTFW_TRACK_MOCK_METHOD(_mock_stdio, Mock_stdio_methods, fflush, 4)
+    TESTFW_TRACK_MOCK_METHOD(_mock_stdio, Mock_stdio_methods, fopen, 5)
+    #ifdef _WIN32
+    TESTFW_TRACK_MOCK_METHOD(_mock_stdio, Mock_stdio_methods, fopen_s, 6)
+    TESTFW_TRACK_MOCK_METHOD(_mock_stdio, Mock_stdio_methods, _wfopen_s, 7)
+    TESTFW_TRACK_MOCK_METHOD(_mock_stdio, Mock_stdio_methods, _wfsopen, 8)
+    #endif
+    TESTFW_TRACK_MOCK_METHOD(_mock_stdio, Mock_stdio_methods, fprintf, 9)
+    TESTFW_TRACK_MOCK_METHOD(_mock_stdio, Mock_stdio_methods, vfprintf, 10)
+    TESTFW_TRACK_MOCK_METHOD(_mock_stdio, Mock_stdio_methods, snprintf, 11)
+    TESTFW_TRACK_MOCK_METHOD(_mock_stdio, Mock_stdio_methods, vsnprintf, 12)
+    TESTFW_TRACK_MOCK_METHOD(_mock_stdio, Mock_stdio_methods, fgets, 13)
+    TESTFW_TRACK_MOCK_METHOD(_mock_stdio, Mock_stdio_methods, fread, 14)
+    TESTFW_TRACK_MOCK_METHOD(_mock_stdio, Mock_stdio_methods, fwrite, 15)
+
+    void switch_to_real_fileio();
+    void switch_to_mock_fileio();
+
+    TESTFW_TRACK_MOCK_METHOD(_mock_stdio, Mock_stdio_methods, printf, 16)
+    TESTFW_TRACK_MOCK_METHOD(_mock_stdio, Mock_stdio_methods, scanf, 17)
+    TESTFW_TRACK_MOCK_METHOD(_mock_stdio, Mock_stdio_methods, vscanf, 18)
+    TESTFW_TRACK_MOCK_METHOD(_mock_stdio, Mock_stdio_methods, vfscanf, 19)
+    TESTFW_TRACK_MOCK_METHOD(_mock_stdio, Mock_stdio_methods, freopen, 20)
+    TESTFW_TRACK_MOCK_METHOD(_mock_stdio, Mock_stdio_methods, remove, 21)
+    TESTFW_TRACK_MOCK_METHOD(_mock_stdio, Mock_stdio_methods, rename, 22)
+    #ifndef _WIN32
+    TESTFW_TRACK_MOCK_METHOD(_mock_stdio, Mock_stdio_methods, fdopen, 23)
+    TESTFW_TRACK_MOCK_METHOD(_mock_stdio, Mock_stdio_methods, fseeko, 24)
+    TESTFW_TRACK_MOCK_METHOD(_mock_stdio, Mock_stdio_methods, ftello, 25)
+    #else
+    TESTFW_TRACK_MOCK_METHOD(_mock_stdio, Mock_stdio_methods, _fseeki64, 26)
+    TESTFW_TRACK_MOCK_METHOD(_mock_stdio, Mock_stdio_methods, _ftelli64, 27)
+    #endif
+
+    /**
+     * 以降、EXPECT_CALL / ON_CALL を設定していないメソッドは gmock を経由せず本物へ委譲する (既定はすべて gmock 経由)。
+     * 未設定の呼び出しが gmock に届かなくなるため、StrictMock / NaggyMock では呼び出さないこと。
+     */
+    void bypass_unconfigured_methods();
 
     Mock_stdio();
     ~Mock_stdio();
 };
 
-extern Mock_stdio *_mock_stdio;
-
 #endif // _IN_OVERRIDE_HEADER_STDIO_H
 
 #endif // _MOCK_STDIO_H
@@ -17,6 +17,7 @@ extern "C"
     extern void *mock_malloc(const char *, const int, const char *, size_t);
     extern void *mock_realloc(const char *, const int, const char *, void *, size_t);
     extern void *mock_calloc(const char *, const int, const char *, size_t, size_t);
+    extern void mock_free(const char *, const int, const char *, void *);
     extern char *mock_getenv(const char *, const int, const char *, const char *);
     extern int mock_atexit(const char *, const int, const char *, mock_atexit_fn);
 #ifndef _WIN32
@@ -35,11 +36,35 @@ extern "C"
 
 #ifdef _IN_OVERRIDE_HEADER_STDLIB_H
 
-    #define malloc(__size)          mock_malloc(__FILE__, __LINE__, __func__, __size)
-    #define realloc(__ptr, __size)  mock_realloc(__FILE__, __LINE__, __func__, __ptr, __size)
-    #define calloc(__nmemb, __size) mock_calloc(__FILE__, __LINE__, __func__, __nmemb, __size)
-    #define getenv(__name)          mock_getenv(__FILE__, __LINE__, __func__, __name)
-    #define atexit(__function)      mock_atexit(__FILE__, __LINE__, __func__, __function)
+    #if defined(__cplusplus) && (__cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L))
+/*
+ * 関数形式のマクロのため、std::free(p) / ::free(p) は std::invoke(...) / ::invoke(...) に置き換わる。
+ * std::invoke は標準の関数のため、std:: 付きの呼び出しも std に宣言を追加せずに mock 関数を経由させる。
+ * 引数は std::invoke で転送されるため、NULL を渡すポインターの引数は void * へ変換してから渡す。
+ * メンバー関数の obj.free(p) も置き換わるため、(obj.free)(p) と記述してマクロの展開を避ける。
+ * C++17 より前の規格では std::invoke が無いため C と同じ置き換えとなり、std:: 付きの呼び出しはコンパイル エラーとなる。
+ */
+extern "C++"
+{
+        #include <functional>
+}
+using std::invoke;
+
+        #define malloc(__size)          invoke(::mock_malloc, __FILE__, __LINE__, __func__, __size)
+        #define realloc(__ptr, __size) \
+            invoke(::mock_realloc, __FILE__, __LINE__, __func__, static_cast<void *>(__ptr), __size)
+        #define calloc(__nmemb, __size) invoke(::mock_calloc, __FILE__, __LINE__, __func__, __nmemb, __size)
+        #define free(__ptr)             invoke(::mock_free, __FILE__, __LINE__, __func__, static_cast<void *>(__ptr))
+        #define getenv(__name)          invoke(::mock_getenv, __FILE__, __LINE__, __func__, __name)
+        #define atexit(__function)      invoke(::mock_atexit, __FILE__, __LINE__, __func__, __function)
+    #else // __cplusplus
+        #define malloc(__size)          mock_malloc(__FILE__, __LINE__, __func__, __size)
+        #define realloc(__ptr, __size)  mock_realloc(__FILE__, __LINE__, __func__, __ptr, __size)
+        #define calloc(__nmemb, __size) mock_calloc(__FILE__, __LINE__, __func__, __nmemb, __size)
+        #define free(__ptr)             mock_free(__FILE__, __LINE__, __func__, __ptr)
+        #define getenv(__name)          mock_getenv(__FILE__, __LINE__, __func__, __name)
+        #define atexit(__function)      mock_atexit(__FILE__, __LINE__, __func__, __function)
+    #endif // __cplusplus
     #ifndef _WIN32
         #define realpath(__path, __resolved) mock_realpath(__FILE__, __LINE__, __func__, __path, __resolved)
     #endif // _WIN32
@@ -56,6 +81,7 @@ extern "C"
         #pragma GCC diagnostic ignored "-Wpadded"
     #endif // _WIN32
     #include <gmock/gmock.h>
+    #include <mock_instance.h>
     #ifndef _WIN32
         #pragma GCC diagnostic pop
     #endif // _WIN32
@@ -63,6 +89,7 @@ extern "C"
 extern void *delegate_real_malloc(const char *, const int, const char *, size_t);
 extern void *delegate_real_realloc(const char *, const int, const char *, void *, size_t);
 extern void *delegate_real_calloc(const char *, const int, const char *, size_t, size_t);
+extern void delegate_real_free(const char *, const int, const char *, void *);
 extern char *delegate_real_getenv(const char *, const int, const char *, const char *);
 extern int delegate_real_atexit(const char *, const int, const char *, mock_atexit_fn);
     #ifndef _WIN32
@@ -73,12 +100,17 @@ extern int delegate_real_setenv(const char *, const int, const char *, const cha
 extern int delegate_real_unsetenv(const char *, const int, const char *, const char *);
     #endif // _WIN32
 
-class Mock_stdlib
+class Mock_stdlib;
+extern testfw::MockSlot<Mock_stdlib> _mock_stdlib;
+
+// gmock のメソッド宣言。EXPECT_CALL / ON_CALL は派生クラス Mock_stdlib に対して設定する。
+class Mock_stdlib_methods
 {
   public:
     MOCK_METHOD(void *, malloc, (const char *, const int, const char *, size_t));
     MOCK_METHOD(void *, realloc, (const char *, const int, const char *, void *, size_t));
     MOCK_METHOD(void *, calloc, (const char *, const int, const char *, size_t, size_t));
+    MOCK_METHOD(void, free, (const char *, const int, const char *, void *));
     MOCK_METHOD(char *, getenv, (const char *, const int, const char *, const char *));
     MOCK_METHOD(int, atexit, (const char *, const int, const char *, mock_atexit_fn));
     #ifndef _WIN32
@@ -88,13 +120,35 @@ class Mock_stdlib
     MOCK_METHOD(int, setenv, (const char *, const int, const char *, const char *, const char *, int));
     MOCK_METHOD(int, unsetenv, (const char *, const int, const char *, const char *));
     #endif // _WIN32
+};
+
+class Mock_stdlib : public Mock_stdlib_methods
+{
+  public:
+    TESTFW_TRACK_MOCK_METHOD(_mock_stdlib, Mock_stdlib_methods, malloc, 0)
+    TESTFW_TRACK_MOCK_METHOD(_mock_stdlib, Mock_stdlib_methods, realloc, 1)
+    TESTFW_TRACK_MOCK_METHOD(_mock_stdlib, Mock_stdlib_methods, calloc, 2)
+    TESTFW_TRACK_MOCK_METHOD(_mock_stdlib, Mock_stdlib_methods, getenv, 3)
+    TESTFW_TRACK_MOCK_METHOD(_mock_stdlib, Mock_stdlib_methods, atexit, 4)
+    #ifndef _WIN32
+    TESTFW_TRACK_MOCK_METHOD(_mock_stdlib, Mock_stdlib_methods, realpath, 5)
+    #endif // _WIN32
+    #ifndef _WIN32
+    TESTFW_TRACK_MOCK_METHOD(_mock_stdlib, Mock_stdlib_methods, setenv, 6)
+    TESTFW_TRACK_MOCK_METHOD(_mock_stdlib, Mock_stdlib_methods, unsetenv, 7)
+    #endif // _WIN32
+    TESTFW_TRACK_MOCK_METHOD(_mock_stdlib, Mock_stdlib_methods, free, 8)
+
+    /**
+     * 以降、EXPECT_CALL / ON_CALL を設定していないメソッドは gmock を経由せず本物へ委譲する (既定はすべて gmock 経由)。
+     * 未設定の呼び出しが gmock に届かなくなるため、StrictMock / NaggyMock では呼び出さないこと。
+     */
+    void bypass_unconfigured_methods();
 
     Mock_stdlib();
     ~Mock_stdlib();
 };
 
-extern Mock_stdlib *_mock_stdlib;
-
 #endif // _IN_OVERRIDE_HEADER_STDLIB_H
 
 #endif // _MOCK_STDLIB_H
@@ -34,6 +34,8 @@ extern "C"
         #pragma GCC diagnostic ignored "-Wpadded"
     #endif // _WIN32
     #include <gmock/gmock.h>
+    #include <mock_instance.h>
+    #include <fake_function.h>
     #ifndef _WIN32
         #pragma GCC diagnostic pop
     #endif // _WIN32
@@ -57,7 +59,11 @@ class Mock_string
     ~Mock_string();
 };
 
-extern Mock_string *_mock_string;
+extern testfw::MockSlot<Mock_string> _mock_string;
+
+// gmock を経由しない fake (大量に呼ばれる箇所の差し替え用)
+extern testfw::FakeSlot<void *(void *, int, size_t)> _fake_memset;
+using Fake_memset = testfw::FakeFunction<void *(void *, int, size_t), _fake_memset>;
 
 #endif // _IN_OVERRIDE_HEADER_STRING_H
 
@@ -28,6 +28,7 @@ extern "C"
         #pragma GCC diagnostic push
         #pragma GCC diagnostic ignored "-Wpadded"
         #include <gmock/gmock.h>
+        #include <mock_instance.h>
         #pragma GCC diagnostic pop
 
 extern int delegate_real_tcgetattr(const char *, const int, const char *, int, struct termios *);
@@ -43,7 +44,7 @@ class Mock_termios
     ~Mock_termios();
 };
 
-extern Mock_termios *_mock_termios;
+extern testfw::MockSlot<Mock_termios> _mock_termios;
 
     #endif // _IN_OVERRIDE_HEADER_TERMIOS_H
 
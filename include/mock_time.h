@@ -48,6 +48,7 @@ extern errno_t mock_ctime_s(const char *, const int, const char *, char *, size_
         #pragma GCC diagnostic ignored "-Wpadded"
     #endif // _WIN32
     #include <gmock/gmock.h>
+    #include <mock_instance.h>
     #ifndef _WIN32
         #pragma GCC diagnostic pop
     #endif // _WIN32
@@ -102,7 +103,7 @@ class Mock_time
 };
     #endif
 
-extern Mock_time *_mock_time;
+extern testfw::MockSlot<Mock_time> _mock_time;
 
 #endif // _IN_OVERRIDE_HEADER_TIME_H
 
@@ -98,10 +98,15 @@ extern int mock__write(const char *, const int, const char *, int, const void *,
         #pragma GCC diagnostic ignored "-Wpadded"
     #endif // _WIN32
     #include <gmock/gmock.h>
+    #include <mock_instance.h>
+    #include <fake_function.h>
     #ifndef _WIN32
         #pragma GCC diagnostic pop
     #endif // _WIN32
 
+class Mock_unistd;
+extern testfw::MockSlot<Mock_unistd> _mock_unistd;
+
     #ifndef _WIN32
 extern int delegate_real_access(const char *, const int, const char *, const char *, int);
 extern char *delegate_real_getcwd(const char *, const int, const char *, char *, size_t);
@@ -128,7 +133,8 @@ extern int delegate_real_sched_yield(const char *, const int, const char *);
 extern int delegate_real_rmdir(const char *, const int, const char *, const char *);
 extern int delegate_real_isatty(const char *, const int, const char *, int);
 
-class Mock_unistd
+// gmock のメソッド宣言。EXPECT_CALL / ON_CALL は派生クラス Mock_unistd に対して設定する。
+class Mock_unistd_methods
 {
   public:
     MOCK_METHOD(int, access, (const char *, const int, const char *, const char *, int));
@@ -155,10 +161,52 @@ class Mock_unistd
     MOCK_METHOD(int, sched_yield, (const char *, const int, const char *));
     MOCK_METHOD(int, rmdir, (const char *, const int, const char *, const char *));
     MOCK_METHOD(int, isatty, (const char *, const int, const char *, int));
+};
+
+class Mock_unistd : public Mock_unistd_methods
+{
+  public:
+    TESTFW_TRACK_MOCK_METHOD(_mock_unistd, Mock_unistd_methods, access, 0)
+    TESTFW_TRACK_MOCK_METHOD(_mock_unistd, Mock_unistd_methods, getcwd, 1)
+    TESTFW_TRACK_MOCK_METHOD(_mock_unistd, Mock_unistd_methods, ftruncate, 2)
+    TESTFW_TRACK_MOCK_METHOD(_mock_unistd, Mock_unistd_methods, fsync, 3)
+    TESTFW_TRACK_MOCK_METHOD(_mock_unistd, Mock_unistd_methods, fork, 4)
+    TESTFW_TRACK_MOCK_METHOD(_mock_unistd, Mock_unistd_methods, mkstemp, 5)
+    TESTFW_TRACK_MOCK_METHOD(_mock_unistd, Mock_unistd_methods, mkostemp, 6)
+    TESTFW_TRACK_MOCK_METHOD(_mock_unistd, Mock_unistd_methods, unlink, 7)
+    TESTFW_TRACK_MOCK_METHOD(_mock_unistd, Mock_unistd_methods, lseek, 8)
+    TESTFW_TRACK_MOCK_METHOD(_mock_unistd, Mock_unistd_methods, close, 9)
+    TESTFW_TRACK_MOCK_METHOD(_mock_unistd, Mock_unistd_methods, dup, 10)
+    TESTFW_TRACK_MOCK_METHOD(_mock_unistd, Mock_unistd_methods, dup2, 11)
+    TESTFW_TRACK_MOCK_METHOD(_mock_unistd, Mock_unistd_methods, read, 12)
+    TESTFW_TRACK_MOCK_METHOD(_mock_unistd, Mock_unistd_methods, write, 13)
+    TESTFW_TRACK_MOCK_METHOD(_mock_unistd, Mock_unistd_methods, geteuid, 14)
+    TESTFW_TRACK_MOCK_METHOD(_mock_unistd, Mock_unistd_methods, getpid, 15)
+    TESTFW_TRACK_MOCK_METHOD(_mock_unistd, Mock_unistd_methods, kill, 16)
+    TESTFW_TRACK_MOCK_METHOD(_mock_unistd, Mock_unistd_methods, pipe, 17)
+    TESTFW_TRACK_MOCK_METHOD(_mock_unistd, Mock_unistd_methods, execve, 18)
+    TESTFW_TRACK_MOCK_METHOD(_mock_unistd, Mock_unistd_methods, readlink, 19)
+    TESTFW_TRACK_MOCK_METHOD(_mock_unistd, Mock_unistd_methods, usleep, 20)
+    TESTFW_TRACK_MOCK_METHOD(_mock_unistd, Mock_unistd_methods, sched_yield, 21)
+    TESTFW_TRACK_MOCK_METHOD(_mock_unistd, Mock_unistd_methods, rmdir, 22)
+    TESTFW_TRACK_MOCK_METHOD(_mock_unistd, Mock_unistd_methods, isatty, 23)
+
+    /**
+     * 以降、EXPECT_CALL / ON_CALL を設定していないメソッドは gmock を経由せず本物へ委譲する (既定はすべて gmock 経由)。
+     * 未設定の呼び出しが gmock に届かなくなるため、StrictMock / NaggyMock では呼び出さないこと。
+     */
+    void bypass_unconfigured_methods();
 
     Mock_unistd();
     ~Mock_unistd();
 };
+
+// gmock を経由しない fake (大量に呼ばれる箇所の差し替え用)
+extern testfw::FakeSlot<ssize_t(int, void *, size_t)> _fake_read;
+extern testfw::FakeSlot<ssize_t(int, const void *, size_t)> _fake_write;
+using Fake_read = testfw::FakeFunction<ssize_t(int, void *, size_t), _fake_read>;
+using Fake_write = testfw::FakeFunction<ssize_t(int, const void *, size_t), _fake_write>;
+
     #else  // _WIN32
 extern __int64 delegate_real__lseeki64(const char *, const int, const char *, int, __int64, int);
 extern int delegate_real__close(const char *, const int, const char *, int);
@@ -167,7 +215,8 @@ extern int delegate_real__dup2(const char *, const int, const char *, int, int);
 extern int delegate_real__read(const char *, const int, const char *, int, void *, unsigned int);
 extern int delegate_real__write(const char *, const int, const char *, int, const void *, unsigned int);
 
-class Mock_unistd
+// gmock のメソッド宣言。EXPECT_CALL / ON_CALL は派生クラス Mock_unistd に対して設定する。
+class Mock_unistd_methods
 {
   public:
     MOCK_METHOD(__int64, _lseeki64, (const char *, const int, const char *, int, __int64, int));
@@ -176,14 +225,29 @@ class Mock_unistd
     MOCK_METHOD(int, _dup2, (const char *, const int, const char *, int, int));
     MOCK_METHOD(int, _read, (const char *, const int, const char *, int, void *, unsigned int));
     MOCK_METHOD(int, _write, (const char *, const int, const char *, int, const void *, unsigned int));
+};
+
+class Mock_unistd : public Mock_unistd_methods
+{
+  public:
+    TESTFW_TRACK_MOCK_METHOD(_mock_unistd, Mock_unistd_methods, _lseeki64, 24)
+    TESTFW_TRACK_MOCK_METHOD(_mock_unistd, Mock_unistd_methods, _close, 25)
+    TESTFW_TRACK_MOCK_METHOD(_mock_unistd, Mock_unistd_methods, _dup, 26)
+    TESTFW_TRACK_MOCK_METHOD(_mock_unistd, Mock_unistd_methods, _dup2, 27)
+    TESTFW_TRACK_MOCK_METHOD(_mock_unistd, Mock_unistd_methods, _read, 28)
+    TESTFW_TRACK_MOCK_METHOD(_mock_unistd, Mock_unistd_methods, _write, 29)
+
+    /**
+     * 以降、EXPECT_CALL / ON_CALL を設定していないメソッドは gmock を経由せず本物へ委譲する (既定はすべて gmock 経由)。
+     * 未設定の呼び出しが gmock に届かなくなるため、StrictMock / NaggyMock では呼び出さないこと。
+     */
+    void bypass_unconfigured_methods();
 
     Mock_unistd();
     ~Mock_unistd();
 };
     #endif // _WIN32
 
-extern Mock_unistd *_mock_unistd;
-
 #endif // _IN_OVERRIDE_HEADER_UNISTD_H || _IN_OVERRIDE_HEADER_IO_H
 
 #endif // _MOCK_UNISTD_H
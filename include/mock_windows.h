@@ -112,6 +112,7 @@ extern "C"
         #else // _IN_OVERRIDE_HEADER_WINDOWS_H
 
             #include <gmock/gmock.h>
+            #include <mock_instance.h>
 
 extern ULONGLONG delegate_real_GetTickCount64(const char *, const int, const char *);
 extern ULONGLONG delegate_fake_GetTickCount64(const char *, const int, const char *);
@@ -194,7 +195,7 @@ class Mock_windows
     ~Mock_windows();
 };
 
-extern Mock_windows *_mock_windows;
+extern testfw::MockSlot<Mock_windows> _mock_windows;
 
         #endif // _IN_OVERRIDE_HEADER_WINDOWS_H
 
@@ -84,6 +84,7 @@ extern "C"
         #else // _IN_OVERRIDE_HEADER_WINSOCK_H || !__cplusplus
 
             #include <gmock/gmock.h>
+            #include <mock_instance.h>
 
 extern int delegate_real_WSAStartup(const char *, const int, const char *, WORD, LPWSADATA);
 extern int delegate_real_WSACleanup(const char *, const int, const char *);
@@ -138,7 +139,7 @@ class Mock_winsock
     ~Mock_winsock();
 };
 
-extern Mock_winsock *_mock_winsock;
+extern testfw::MockSlot<Mock_winsock> _mock_winsock;
 
         #endif // _IN_OVERRIDE_HEADER_WINSOCK_H || !__cplusplus
 
@@ -35,6 +35,7 @@ extern "C"
     #pragma GCC diagnostic push
     #pragma GCC diagnostic ignored "-Wpadded"
     #include <gmock/gmock.h>
+    #include <mock_instance.h>
     #pragma GCC diagnostic pop
 
 extern int delegate_real_deflateInit2_(const char *, const int, const char *, z_streamp, int, int, int, int, int,
@@ -52,7 +53,7 @@ class Mock_zlib
     ~Mock_zlib();
 };
 
-extern Mock_zlib *_mock_zlib;
+extern testfw::MockSlot<Mock_zlib> _mock_zlib;
 
 #endif // _IN_OVERRIDE_HEADER_ZLIB_H
 
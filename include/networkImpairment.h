@@ -0,0 +1,134 @@
+#ifndef _NETWORK_IMPAIRMENT_H
+#define _NETWORK_IMPAIRMENT_H
+
+#ifndef _WIN32
+
+    #include <chrono>
+    #include <cstddef>
+    #include <cstdint>
+    #include <functional>
+    #include <memory>
+    #include <string>
+
+    #include <sys/socket.h>
+    #include <sys/types.h>
+
+using namespace std;
+
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wpadded"
+
+namespace testing
+{
+
+/** 障害を適用する方向。 */
+enum ImpairmentDirection
+{
+    IMPAIR_SEND = 1, ///< send / sendto
+    IMPAIR_RECV = 2, ///< recv / recvfrom
+    IMPAIR_BOTH = 3
+};
+
+/**
+ * ネットワーク障害の規則。対象 (fd / address / direction) に一致する送受信に、設定した障害 (0 以外) をすべて適用する。
+ * 複数の規則に一致した場合は、遅延は合計し、分割は最も小さい値とし、その他は規則ごとに判定する。
+ */
+struct ImpairmentRule
+{
+    int fd = -1;                               ///< 対象のソケット (-1 はすべてのソケット)
+    string address;                            ///< 対象の相手のアドレス ("127.0.0.1:8080" / "[::1]:*" / UNIX パス、'*' / '?' を使用可。空はすべて)
+    ImpairmentDirection direction = IMPAIR_BOTH;
+    uint64_t bandwidth = 0;                    ///< 帯域 (バイト / 秒)。規則ごとのトークン バケットを一致するソケットで共有する
+    uint64_t burst = 0;                        ///< トークン バケットの容量 (0 は bandwidth の 1/20 秒分)
+    chrono::nanoseconds latency{0};            ///< 送受信ごとの遅延
+    chrono::nanoseconds jitter{0};             ///< 遅延に加える 0 以上 jitter 未満の揺らぎ
+    size_t max_chunk = 0;                      ///< ストリームの 1 回の送受信の最大バイト数 (部分的な送受信)
+    double partial_probability = 0.0;          ///< ストリームの送受信を、この確率で 1 バイト以上のランダムな長さに短縮する
+    double eagain_probability = 0.0;           ///< ノンブロッキングの送受信で、この確率で EAGAIN の連続を開始する
+    uint32_t eagain_burst = 1;                 ///< EAGAIN を連続して返す回数
+    double loss = 0.0;                         ///< データグラムを破棄する確率
+    double reorder = 0.0;                      ///< 送信するデータグラムを、同じソケットの次のデータグラムの後に送る確率
+};
+
+/** 適用した障害の統計。 */
+struct ImpairmentStats
+{
+    uint64_t delayed_calls = 0;              ///< 遅延 (latency / bandwidth) させた送受信の数
+    chrono::nanoseconds total_delay{0};      ///< 遅延の合計
+    uint64_t partial_transfers = 0;          ///< 短縮した送受信の数
+    uint64_t eagain = 0;                     ///< 返した EAGAIN の数
+    uint64_t dropped_datagrams = 0;          ///< 破棄したデータグラムの数
+    uint64_t reordered_datagrams = 0;        ///< 順序を入れ替えたデータグラムの数
+};
+
+struct NetworkImpairmentState;
+
+/**
+ * send / recv / sendto / recvfrom の mock 関数で、遅延・帯域制限・部分的な送受信・EAGAIN・データグラムの損失と入れ替えを注入する。
+ * 本物のソケットと VirtualNetwork のソケットのどちらにも適用し、送受信は Mock_sys_socket / 委譲先をそのまま使用する。
+ * 確率の判定は seed・規則・ソケットごとの呼び出し回数から決まるため、同じ seed と同じ呼び出し順で再現する。
+ * 遅延はスリープで行い、VirtualClock がある場合は仮想時刻で待つ。
+ * 生存期間中のみ有効で、同時に生成できるのは 1 個のみ。
+ *
+ * 使用例:
+ *   NetworkImpairment impairment(seed);
+ *   impairment.limitBandwidth("127.0.0.1:8080", 64 * 1024).addLatency("127.0.0.1:8080", chrono::milliseconds(40));
+ *   impairment.dropDatagrams("*:53", 0.2);
+ */
+class NetworkImpairment
+{
+  public:
+    explicit NetworkImpairment(uint64_t seed = 0);
+    ~NetworkImpairment();
+
+    NetworkImpairment(const NetworkImpairment &) = delete;
+    NetworkImpairment &operator=(const NetworkImpairment &) = delete;
+
+    /** 規則を追加する。 */
+    NetworkImpairment &addRule(const ImpairmentRule &rule);
+
+    NetworkImpairment &limitBandwidth(const string &address, uint64_t bytes_per_second);
+    NetworkImpairment &addLatency(const string &address, chrono::nanoseconds latency,
+                                  chrono::nanoseconds jitter = chrono::nanoseconds(0));
+    NetworkImpairment &splitTransfers(const string &address, size_t max_chunk);
+    NetworkImpairment &injectEagain(const string &address, double probability, uint32_t burst);
+    NetworkImpairment &dropDatagrams(const string &address, double probability);
+    NetworkImpairment &reorderDatagrams(const string &address, double probability);
+
+    /** 適用した障害の統計。 */
+    ImpairmentStats stats() const;
+
+    uint64_t seed() const;
+
+  private:
+    unique_ptr<NetworkImpairmentState> state_;
+};
+
+/** 送受信を行う関数 (mock 関数の委譲先の呼び出し)。 */
+using ImpairedSend = function<ssize_t(const void *buf, size_t len, const struct sockaddr *dest_addr, socklen_t addrlen)>;
+using ImpairedRecv = function<ssize_t(void *buf, size_t len)>;
+
+/**
+ * NetworkImpairment が生成されているか (atomic ロード 1 回のみ)。
+ * mock 関数本体は、true の場合のみ送受信を ImpairedSend / ImpairedRecv にまとめて impairSend / impairRecv を呼び出す。
+ */
+extern bool networkImpairmentActive();
+
+/**
+ * mock 関数本体から呼び出す。一致する規則がある場合に transfer を (必要に応じて複数回 / 0 回) 呼び出して true を返し、
+ * *result に戻り値を設定する (失敗時は errno も設定する)。一致する規則が無い場合は transfer を呼び出さずに false を返す。
+ */
+extern bool impairSend(int sockfd, const void *buf, size_t len, int flags, const struct sockaddr *dest_addr,
+                       socklen_t addrlen, const ImpairedSend &transfer, ssize_t *result);
+extern bool impairRecv(int sockfd, void *buf, size_t len, int flags, const ImpairedRecv &transfer, ssize_t *result);
+
+/** close の mock 関数本体から呼び出す。fd の状態 (入れ替えのため保持しているデータグラム等) を破棄する。 */
+extern void forgetImpairedSocket(int fd);
+
+} // namespace testing
+
+    #pragma GCC diagnostic pop
+
+#endif // _WIN32
+
+#endif // _NETWORK_IMPAIRMENT_H
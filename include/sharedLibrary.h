@@ -1,7 +1,14 @@
 #ifndef _SHARED_LIBRARY_H
 #define _SHARED_LIBRARY_H
 
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <mutex>
 #include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #if defined(__linux__)
     #define TESTFW_SHARED_LIBRARY_EXTENSION ".so"
@@ -11,6 +18,11 @@
     #error "unsupported platform"
 #endif
 
+#ifndef _WIN32
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wpadded"
+#endif /* _WIN32 */
+
 namespace testing
 {
 
@@ -20,10 +32,167 @@ struct SharedSymbolResult
     std::string diagnostic;
 };
 
+/** preloadSharedLibrary のロード フラグ。 */
+enum SharedLibraryLoadFlags
+{
+    /** 遅延バインド (Linux: RTLD_LAZY)。tryResolveSharedSymbol と同じ。 */
+    SHARED_LIBRARY_BIND_LAZY = 0,
+    /** 即時バインド (Linux: RTLD_NOW)。Windows の LoadLibraryW は常に即時バインドのため区別しない。 */
+    SHARED_LIBRARY_BIND_NOW = 1
+};
+
+/** preloadSharedLibrary() の返値 */
+struct SharedLibraryPreloadResult
+{
+    bool loaded = false;                   ///< ライブラリのロードに成功したか
+    std::map<std::string, void *> symbols; ///< 解決できたシンボル名 → アドレス
+    std::vector<std::string> missing;      ///< 解決できなかったシンボル名
+    bool bind_now = false;                 ///< 即時バインドでロードしたか (ロード済みのライブラリは false)
+    std::string diagnostic;                ///< 失敗時・遅延バインドのままの場合の診断メッセージ (改行区切り)
+};
+
+/** ライブラリごとのロード・シンボル解決の計測値 (getSharedLibraryStats() の返値の要素) */
+struct SharedLibraryStats
+{
+    std::string lib_name;          ///< ライブラリ名 (tryResolveSharedSymbol 等に渡した文字列)
+    uint64_t load_time_ns = 0;     ///< dlopen / LoadLibraryW に要した時間
+    bool bind_now = false;         ///< 即時バインドでロード済みか
+    size_t symbol_count = 0;       ///< 解決したシンボル数 (キャッシュ ヒットは含まない)
+    uint64_t total_resolve_ns = 0; ///< dlsym / GetProcAddress に要した時間の合計
+    uint64_t max_resolve_ns = 0;   ///< dlsym / GetProcAddress に要した時間の最大値
+};
+
 extern SharedSymbolResult tryResolveSharedSymbol(const std::string &lib_name, const std::string &symbol_name);
 
 extern void *resolveSharedSymbolOrExit(const std::string &lib_name, const std::string &symbol_name);
 
+/**
+ * 共有ライブラリをロードし、指定したシンボルを 1 回のロック区間でまとめて解決する。
+ * 解決結果は tryResolveSharedSymbol と同じキャッシュに登録されるため、
+ * 計測区間の前に呼び出しておくと、計測区間内の初回呼び出しで解決・バインドのコストを払わずに済む。
+ * SHARED_LIBRARY_BIND_NOW はプロセスが未ロードのライブラリにのみ有効。依存ライブラリ等としてロード済みのライブラリは
+ * 再配置されないため、返値の bind_now を false とし、diagnostic にその旨を設定する。
+ *
+ * @param lib_name      ライブラリ名
+ * @param symbol_names  解決するシンボル名の一覧
+ * @param flags         SharedLibraryLoadFlags
+ */
+extern SharedLibraryPreloadResult preloadSharedLibrary(const std::string &lib_name,
+                                                       const std::vector<std::string> &symbol_names,
+                                                       int flags = SHARED_LIBRARY_BIND_NOW);
+
+/** これまでにロードしたライブラリごとの計測値をライブラリ名順で取得する。 */
+extern std::vector<SharedLibraryStats> getSharedLibraryStats();
+
+/** 計測値をリセットする (ロード済みのハンドルとシンボルのキャッシュは維持する)。 */
+extern void resetSharedLibraryStats();
+
+/** 計測値を一覧形式で出力する。 */
+extern void printSharedLibraryStats(FILE *fp = stdout);
+
+/**
+ * 共有ライブラリのシンボルを型付きで保持するハンドル。
+ * 初回呼び出し時に 1 度だけ resolveSharedSymbolOrExit で解決し (std::call_once)、
+ * 以降はキャッシュした関数ポインターを直接呼び出す。
+ * 呼び出しのたびに mutex と map 検索を伴う resolveSharedSymbolOrExit を経由しないため、
+ * ループ内で繰り返し呼び出す用途に向く。
+ *
+ * @tparam Fn  関数型 (例: int(int, const char *))。関数ポインター型ではない。
+ *
+ * 使用例:
+ *   static SharedSymbol<int(int)> mylib_open("libmylib.so", "mylib_open");
+ *   int rc = mylib_open(0);
+ */
+template <typename Fn> class SharedSymbol
+{
+    static_assert(std::is_function<Fn>::value, "SharedSymbol の型引数には関数型を指定してください");
+
+  public:
+    SharedSymbol(const std::string &lib_name, const std::string &symbol_name)
+        : lib_name_(lib_name), symbol_name_(symbol_name)
+    {
+    }
+
+    SharedSymbol(const SharedSymbol &) = delete;
+    SharedSymbol &operator=(const SharedSymbol &) = delete;
+
+    /** 解決済みの関数ポインターを返す。未解決の場合はここで解決する (失敗時は exit)。 */
+    Fn *get() const
+    {
+        std::call_once(once_, [this]() {
+            fn_ = reinterpret_cast<Fn *>(resolveSharedSymbolOrExit(lib_name_, symbol_name_));
+        });
+        return fn_;
+    }
+
+    template <typename... Args>
+    auto operator()(Args &&...args) const -> decltype(std::declval<Fn *>()(std::forward<Args>(args)...))
+    {
+        return get()(std::forward<Args>(args)...);
+    }
+
+    const std::string &libName() const
+    {
+        return lib_name_;
+    }
+
+    const std::string &symbolName() const
+    {
+        return symbol_name_;
+    }
+
+  private:
+    std::string lib_name_;
+    std::string symbol_name_;
+    mutable std::once_flag once_;
+    mutable Fn *fn_ = nullptr;
+};
+
+/**
+ * 関数型から例外指定を除いた型。
+ * C++17 以降は noexcept が関数型に含まれ、glibc の宣言 (例: getpid) は C++ では noexcept となるため、比較の前に除く。
+ */
+template <typename Fn> struct SharedSymbolRemoveNoexcept
+{
+    using type = Fn;
+};
+
+#ifdef __cpp_noexcept_function_type
+template <typename R, typename... Args> struct SharedSymbolRemoveNoexcept<R(Args...) noexcept>
+{
+    using type = R(Args...);
+};
+
+template <typename R, typename... Args> struct SharedSymbolRemoveNoexcept<R(Args..., ...) noexcept>
+{
+    using type = R(Args..., ...);
+};
+#endif // __cpp_noexcept_function_type
+
+/**
+ * 宣言済みのプロトタイプと SharedSymbol の関数型が一致するかをコンパイル時に検証する。
+ * TESTFW_EXPORT_STATIC_ASSERT_ENTRY と同様に、関数は呼び出さない。例外指定 (noexcept) の有無は比較しない。
+ *
+ * @param name  公開ヘッダーで宣言されている関数名
+ * @param fn    SharedSymbol に指定する関数型
+ */
+#define TESTFW_SHARED_SYMBOL_STATIC_ASSERT(name, fn) \
+    static_assert(std::is_same<::testing::SharedSymbolRemoveNoexcept<decltype(name)>::type, \
+                               ::testing::SharedSymbolRemoveNoexcept<fn>::type>::value, \
+                  #name " のプロトタイプが SharedSymbol の型と一致しません");
+
+/**
+ * 公開ヘッダーの宣言から型を導出して SharedSymbol を生成する。
+ * プロトタイプの変更は型不一致としてコンパイル時に検出される。
+ *
+ *   static auto s_mylib_open = TESTFW_SHARED_SYMBOL("libmylib.so", mylib_open);
+ */
+#define TESTFW_SHARED_SYMBOL(lib_name, name) ::testing::SharedSymbol<decltype(name)>((lib_name), #name)
+
 } // namespace testing
 
+#ifndef _WIN32
+    #pragma GCC diagnostic pop
+#endif /* _WIN32 */
+
 #endif // _SHARED_LIBRARY_H
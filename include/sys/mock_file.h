@@ -25,6 +25,7 @@ extern "C"
         #pragma GCC diagnostic push
         #pragma GCC diagnostic ignored "-Wpadded"
         #include <gmock/gmock.h>
+        #include <mock_instance.h>
         #pragma GCC diagnostic pop
 
 extern int delegate_real_flock(const char *, const int, const char *, int, int);
@@ -38,7 +39,7 @@ class Mock_sys_file
     ~Mock_sys_file();
 };
 
-extern Mock_sys_file *_mock_sys_file;
+extern testfw::MockSlot<Mock_sys_file> _mock_sys_file;
 
     #endif // _IN_OVERRIDE_HEADER_SYS_FILE_H
 
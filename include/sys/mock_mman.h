@@ -41,6 +41,7 @@ extern "C"
         #pragma GCC diagnostic push
         #pragma GCC diagnostic ignored "-Wpadded"
         #include <gmock/gmock.h>
+        #include <mock_instance.h>
         #pragma GCC diagnostic pop
 
 extern void *delegate_real_mmap(const char *, const int, const char *, void *, size_t, int, int, int, off_t);
@@ -66,7 +67,7 @@ class Mock_sys_mman
     ~Mock_sys_mman();
 };
 
-extern Mock_sys_mman *_mock_sys_mman;
+extern testfw::MockSlot<Mock_sys_mman> _mock_sys_mman;
 
     #endif // _IN_OVERRIDE_HEADER_SYS_MMAN_H
 
@@ -27,6 +27,7 @@ extern "C"
         #pragma GCC diagnostic push
         #pragma GCC diagnostic ignored "-Wpadded"
         #include <gmock/gmock.h>
+        #include <mock_instance.h>
         #pragma GCC diagnostic pop
 
 extern int delegate_real_select(const char *, const int, const char *, int, fd_set *, fd_set *, fd_set *,
@@ -42,7 +43,7 @@ class Mock_sys_select
     ~Mock_sys_select();
 };
 
-extern Mock_sys_select *_mock_sys_select;
+extern testfw::MockSlot<Mock_sys_select> _mock_sys_select;
 
     #endif // _IN_OVERRIDE_HEADER_SYS_SELECT_H
 
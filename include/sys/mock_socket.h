@@ -62,6 +62,7 @@ extern "C"
         #pragma GCC diagnostic push
         #pragma GCC diagnostic ignored "-Wpadded"
         #include <gmock/gmock.h>
+        #include <mock_instance.h>
         #pragma GCC diagnostic pop
 
 extern int delegate_real_socket(const char *, const int, const char *, int, int, int);
@@ -97,7 +98,7 @@ class Mock_sys_socket
     ~Mock_sys_socket();
 };
 
-extern Mock_sys_socket *_mock_sys_socket;
+extern testfw::MockSlot<Mock_sys_socket> _mock_sys_socket;
 
     #endif // _IN_OVERRIDE_HEADER_SYS_SOCKET_H
 
@@ -43,6 +43,7 @@ extern "C"
         #pragma GCC diagnostic ignored "-Wpadded"
     #endif // _WIN32
     #include <gmock/gmock.h>
+    #include <mock_instance.h>
     #ifndef _WIN32
         #pragma GCC diagnostic pop
     #endif // _WIN32
@@ -76,7 +77,7 @@ class Mock_sys_stat
     ~Mock_sys_stat();
 };
 
-extern Mock_sys_stat *_mock_sys_stat;
+extern testfw::MockSlot<Mock_sys_stat> _mock_sys_stat;
 
 #endif // _IN_OVERRIDE_HEADER_STAT_H
 
@@ -26,6 +26,7 @@ extern "C"
             #pragma GCC diagnostic push
             #pragma GCC diagnostic ignored "-Wpadded"
             #include <gmock/gmock.h>
+            #include <mock_instance.h>
             #pragma GCC diagnostic pop
 
 extern pid_t delegate_real_waitpid(const char *, const int, const char *, pid_t, int *, int);
@@ -39,7 +40,7 @@ class Mock_sys_wait
     ~Mock_sys_wait();
 };
 
-extern Mock_sys_wait *_mock_sys_wait;
+extern testfw::MockSlot<Mock_sys_wait> _mock_sys_wait;
 
         #endif // _IN_OVERRIDE_HEADER_WAIT_H
 
@@ -4,6 +4,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdarg.h>
+#include <stdint.h>
 #include <format_attr.h>
 
 #ifndef _WIN32
@@ -36,6 +37,68 @@ extern void setDefaultTraceLevel(int);
 extern void setTraceLevel(const char *, int);
 
 extern string findWorkspaceRoot();
+
+/**
+ * スコープ内で現在のスレッドが mock 関数 (malloc / calloc / realloc / strdup) で確保した回数とバイト数を数え、
+ * 破棄時に上限を超えていれば確保元とともに失敗を報告する。Mock_stdlib のインスタンスは不要。
+ * 通常は ALLOCATION_BUDGET / EXPECT_MAX_ALLOCATIONS / EXPECT_NO_ALLOCATIONS を使用する。
+ */
+#ifndef _WIN32
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wpadded"
+#endif // _WIN32
+class AllocationBudget
+{
+  public:
+    /** 報告する確保元の最大数。超えた分は件数のみ数える。 */
+    static constexpr size_t MAX_SITES = 16;
+
+    struct Site
+    {
+        const char *file;
+        int line;
+        const char *caller;
+        uint64_t allocations;
+        uint64_t bytes;
+    };
+
+    AllocationBudget(const char *file, int line, uint64_t max_allocations, uint64_t max_bytes = UINT64_MAX);
+    ~AllocationBudget();
+
+    AllocationBudget(const AllocationBudget &) = delete;
+    AllocationBudget &operator=(const AllocationBudget &) = delete;
+
+    uint64_t allocations() const
+    {
+        return allocations_;
+    }
+
+    uint64_t bytes() const
+    {
+        return bytes_;
+    }
+
+    /** 確保を数える。外側のスコープにも数える。 */
+    void record(size_t size, const char *file, int line, const char *caller);
+
+  private:
+    const char *file_;
+    int line_;
+    uint64_t max_allocations_;
+    uint64_t max_bytes_;
+    uint64_t allocations_ = 0;
+    uint64_t bytes_ = 0;
+    uint64_t other_site_allocations_ = 0;
+    size_t site_count_ = 0;
+    Site sites_[MAX_SITES];
+    AllocationBudget *outer_;
+};
+#ifndef _WIN32
+    #pragma GCC diagnostic pop
+#endif // _WIN32
+
+/** mock 関数本体から呼び出す。現在のスレッドに AllocationBudget が無い場合は何もしない。 */
+extern void countAllocationBudget(size_t size, const char *file, int line, const char *caller);
 } // namespace testing
 
 #define EXPECT_FILE_NOT_EXISTS(file_path) EXPECT_TRUE(FileNotExists(file_path))
@@ -46,4 +109,21 @@ extern string findWorkspaceRoot();
 
 #define getTraceLevel() _getTraceLevel(__func__)
 
+#define TESTFW_ALLOCATION_BUDGET_NAME2(line) allocation_budget_##line
+#define TESTFW_ALLOCATION_BUDGET_NAME(line)  TESTFW_ALLOCATION_BUDGET_NAME2(line)
+
+/* 以降、囲んでいるスコープの終わりまでの確保回数を max_allocations 以下とする */
+#define ALLOCATION_BUDGET(max_allocations) \
+    ::testing::AllocationBudget TESTFW_ALLOCATION_BUDGET_NAME(__LINE__)(__FILE__, __LINE__, max_allocations)
+
+/* 文の実行中の確保回数を max_allocations 以下とする (文はカンマを含んでもよい) */
+#define EXPECT_MAX_ALLOCATIONS(max_allocations, ...)                                                              \
+    do                                                                                                            \
+    {                                                                                                             \
+        ::testing::AllocationBudget TESTFW_ALLOCATION_BUDGET_NAME(__LINE__)(__FILE__, __LINE__, max_allocations); \
+        __VA_ARGS__;                                                                                              \
+    } while (0)
+
+#define EXPECT_NO_ALLOCATIONS(...) EXPECT_MAX_ALLOCATIONS(0, __VA_ARGS__)
+
 #endif // _TEST_COM_H
@@ -15,9 +15,20 @@
 #include <test_com.h>
 #include <processController.h>
 #include <sharedLibrary.h>
+#include <callStats.h>
+#include <faultInjection.h>
+#include <allocationTracker.h>
+#include <allocationArena.h>
+#include <guardedAllocation.h>
+#include <virtualFileSystem.h>
+#include <virtualClock.h>
+#include <virtualNetwork.h>
+#include <networkImpairment.h>
+#include <virtualResolver.h>
 #include <export_check.h>
 #include <gtest_wrapmain.h>
 #include <mock_instance.h>
+#include <fake_function.h>
 
 using namespace std;
 using namespace testing;
@@ -0,0 +1,154 @@
+#ifndef _VIRTUAL_CLOCK_H
+#define _VIRTUAL_CLOCK_H
+
+#ifndef _WIN32
+
+    #include <chrono>
+    #include <cstddef>
+    #include <cstdint>
+    #include <ctime>
+    #include <functional>
+    #include <memory>
+
+    #include <poll.h>
+    #include <pthread.h>
+    #include <sys/select.h>
+    #include <sys/types.h>
+
+using namespace std;
+
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wpadded"
+
+namespace testing
+{
+
+struct VirtualClockState;
+
+/**
+ * clock_gettime / nanosleep / usleep / pthread_cond_timedwait / poll / select の mock 関数の委譲先 (delegate_real_*) を、
+ * 仮想時刻で動作させる。CLOCK_REALTIME / CLOCK_MONOTONIC / CLOCK_BOOTTIME (および _COARSE / _RAW) が対象で、
+ * すべてのクロックは同じ量だけ進む (setTime で個別に変更できる)。
+ *
+ * 待機中のスレッドは期限を階層型タイマー ホイールに登録して停止する。管理対象のスレッドがすべて待機中になると、
+ * 仮想時刻を最も早い期限まで進め、その期限の待機のみを起床させる。起床したスレッドが再び待機するまで次の期限には進めないため、
+ * キープアライブや再接続のバックオフ等の数時間分の動作を、実行のたびに同じ順序で数秒で実行できる。
+ * 管理対象は、生存期間中に pthread_create で生成したスレッドと attachCurrentThread() を呼び出したスレッド。
+ * 管理対象のスレッドの pthread_join / pthread_cond_wait / 無期限の poll / select も待機中とみなす。
+ * 事象 (シグナル、fd の準備完了) を待つ待機がある間は、実時間で idle wait (既定値 1 ms) の間に状態が変化しないことを
+ * 確認してから仮想時刻を進める。
+ * 生存期間中のみ有効で、同時に生成できるのは 1 個のみ。Mock_time 等で動作を設定した場合はそちらを優先する。
+ *
+ * 使用例:
+ *   VirtualClock clock;
+ *   EXPECT_EQ(-ETIMEDOUT, connect_with_retry(server, 5)); // 失敗ごとに usleep(1000000)
+ *   EXPECT_EQ(5, clock.elapsed() / chrono::seconds(1));
+ */
+class VirtualClock
+{
+  public:
+    static constexpr chrono::nanoseconds DEFAULT_IDLE_WAIT = chrono::milliseconds(1);
+    static constexpr chrono::nanoseconds DEFAULT_WATCHDOG_TIMEOUT = chrono::seconds(30);
+
+    /** 各クロックの初期値は生成時の本物の時刻。 */
+    VirtualClock();
+
+    /** CLOCK_REALTIME の初期値を realtime とする (他のクロックは生成時の本物の時刻)。 */
+    explicit VirtualClock(const struct timespec &realtime);
+
+    ~VirtualClock();
+
+    VirtualClock(const VirtualClock &) = delete;
+    VirtualClock &operator=(const VirtualClock &) = delete;
+
+    /**
+     * すべてのクロックを duration だけ進める。途中の期限ごとに、管理対象のスレッドがすべて待機中になるまで待ってから進める。
+     * 呼び出したスレッドが管理対象の場合、呼び出し中は待機中とみなす。
+     */
+    void advance(chrono::nanoseconds duration);
+
+    /** clock_id のクロックのみ value に変更する (CLOCK_REALTIME の時刻合わせ等)。 */
+    void setTime(clockid_t clock_id, const struct timespec &value);
+
+    /** clock_id のクロックの現在の仮想時刻。 */
+    struct timespec now(clockid_t clock_id = CLOCK_MONOTONIC) const;
+
+    /** 生成後に進んだ時間。 */
+    chrono::nanoseconds elapsed() const;
+
+    /**
+     * 待機中のスレッドが無くなるまで、管理対象のスレッドがすべて待機中になるたびに期限の早い順に仮想時刻を進める。
+     * 周期的に待機を繰り返すスレッドがある場合は戻らないため、advance を使用する。
+     */
+    void runUntilIdle();
+
+    /** タイムアウト付きの待機が、事象を待つ実時間。 */
+    void setIdleWait(chrono::nanoseconds wait);
+
+    /**
+     * 管理対象のスレッドが待機するのを待つ実時間の上限 (ウォッチドッグ)。超えた場合は待機しないスレッドを示して
+     * テストを失敗させ、仮想時刻を進めずに待機 (advance / runUntilIdle を含む) を終える。
+     */
+    void setWatchdogTimeout(chrono::nanoseconds timeout);
+
+    /** 仮想時刻で待機中の数。 */
+    size_t pendingWaiters() const;
+
+    /**
+     * 呼び出したスレッドを管理対象にする。管理対象のスレッドが実行中の間は仮想時刻を進めない。
+     * pthread_create 以外 (std::thread 等) で生成したスレッドや、テスト本体のスレッドに使用する。
+     */
+    void attachCurrentThread();
+
+    /** 呼び出したスレッドを管理対象から外す。スレッドの終了時は自動的に外す。 */
+    void detachCurrentThread();
+
+    /** 管理対象のスレッドの数。 */
+    size_t attachedThreads() const;
+
+  private:
+    unique_ptr<VirtualClockState> state_;
+};
+
+/** 生成中の VirtualClock (無い場合は nullptr)。 */
+extern VirtualClock *getVirtualClock();
+
+/**
+ * delegate_real_* から呼び出す。VirtualClock が無い場合は atomic ロード 1 回のみで false を返す。
+ * 仮想時刻で処理した場合に true を返し、*result に本物の関数と同じ戻り値を設定する (失敗時は errno も設定する)。
+ * virtualCondTimedwait の abstime は、CLOCK_REALTIME と CLOCK_MONOTONIC のうち仮想時刻が近い方の時刻とみなす。
+ * 期限の無い待機 (virtualCondWait / virtualPthreadJoin / 無期限の virtualPoll / virtualSelect) は、
+ * 管理対象のスレッドの場合のみ処理する。
+ */
+extern bool virtualClockGettime(clockid_t clock_id, struct timespec *tp, int *result);
+extern bool virtualNanosleep(const struct timespec *req, struct timespec *rem, int *result);
+extern bool virtualUsleep(useconds_t usec, int *result);
+extern bool virtualCondTimedwait(pthread_cond_t *cond, pthread_mutex_t *mutex, const struct timespec *abstime,
+                                 int *result);
+extern bool virtualCondWait(pthread_cond_t *cond, pthread_mutex_t *mutex, int *result);
+extern bool virtualPoll(struct pollfd *fds, nfds_t nfds, int timeout, int *result);
+extern bool virtualSelect(int nfds, fd_set *readfds, fd_set *writefds, fd_set *exceptfds, struct timeval *timeout,
+                          int *result);
+/** VirtualClock の生存期間中に生成したスレッドを管理対象にする。 */
+extern bool virtualPthreadCreate(pthread_t *thread, const pthread_attr_t *attr, void *(*start_routine)(void *),
+                                 void *arg, int *result);
+extern bool virtualPthreadJoin(pthread_t thread, void **value, int *result);
+
+/**
+ * 委譲先で独自に待機する機能 (VirtualNetwork 等) から呼び出す。VirtualClock が無い場合は false を返す。
+ * 仮想時刻で timeout だけ待ち、その間は wait_event (実時間で最大 wait だけ事象を待ち、発生した場合に true を返す) を
+ * 繰り返し呼び出す。*happened に事象が発生したか否かを設定する。
+ */
+extern bool virtualWaitFor(chrono::nanoseconds timeout, const function<bool(chrono::nanoseconds)> &wait_event,
+                           bool *happened);
+
+/** 期限の無い待機 wait を、管理対象のスレッドの待機として実行する。管理対象のスレッドでない場合は false を返す。 */
+extern bool virtualUntimedWait(const function<void()> &wait);
+
+} // namespace testing
+
+    #pragma GCC diagnostic pop
+
+#endif // _WIN32
+
+#endif // _VIRTUAL_CLOCK_H
@@ -0,0 +1,203 @@
+#ifndef _VIRTUAL_FILE_SYSTEM_H
+#define _VIRTUAL_FILE_SYSTEM_H
+
+#ifndef _WIN32
+
+    #include <cstddef>
+    #include <cstdint>
+    #include <cstdio>
+    #include <functional>
+    #include <memory>
+    #include <string>
+    #include <vector>
+
+    #include <sys/stat.h>
+    #include <sys/types.h>
+
+using namespace std;
+
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wpadded"
+
+namespace testing
+{
+
+struct VirtualFileSystemState;
+
+/** VirtualFileSystem のファイルの mmap の統計。 */
+struct VirtualMappingStats
+{
+    uint64_t maps = 0;               ///< mmap の回数
+    uint64_t unmaps = 0;             ///< munmap の回数
+    uint64_t mapped_bytes = 0;       ///< マップ中のバイト数 (ページ単位)
+    uint64_t msyncs = 0;             ///< msync の回数
+    uint64_t written_back_bytes = 0; ///< MAP_SHARED のマッピングからファイルに書き戻したバイト数
+};
+
+/**
+ * VirtualFileSystem::writeSyntheticFile() で作成するファイルの内容。
+ * 内容は読み込み時に位置から生成するため、ファイルの大きさに関わらずメモリーを消費せず、任意の位置に O(1) でシークできる。
+ * 生成は VirtualFileSystem の mutex を保持して行うため、生成する関数から mock 関数を呼び出さないこと。
+ */
+class SyntheticFileContent
+{
+  public:
+    /** レコード番号 index のレコード (record_size バイト) を record に生成する関数。同じ index では同じ内容を生成すること。 */
+    using RecordGenerator = function<void(uint64_t index, char *record)>;
+
+    /** すべて value のバイト。 */
+    static SyntheticFileContent constant(char value);
+
+    /** 8 バイトごとに start から 1 ずつ増える 64 ビットの値 (リトル エンディアン)。 */
+    static SyntheticFileContent counter(uint64_t start = 0);
+
+    /** seed から生成する擬似乱数 (seed と位置が同じ場合は同じ内容)。 */
+    static SyntheticFileContent random(uint64_t seed);
+
+    /** pattern の繰り返し。 */
+    static SyntheticFileContent repeat(const string &pattern);
+
+    /** record_size バイトの固定長のレコードの並び。 */
+    static SyntheticFileContent records(size_t record_size, RecordGenerator generator);
+
+    /** ファイルの offset から length バイトの内容を buf に生成する。 */
+    void generate(uint64_t offset, char *buf, size_t length) const;
+
+  private:
+    using Filler = function<void(uint64_t offset, char *buf, size_t length)>;
+
+    explicit SyntheticFileContent(Filler fill);
+
+    Filler fill_;
+};
+
+/** VirtualFileSystem::snapshot() で保存したファイル ツリー。 */
+struct VirtualFileSystemSnapshot;
+
+/**
+ * stdio / unistd の mock 関数の委譲先 (delegate_real_*) を、メモリー上のファイル ツリーに切り替える。
+ * mount_point 配下の絶対パスと相対パス (作業ディレクトリは既定で mount_point) をメモリー上で処理し、
+ * それ以外のパスと本物のファイル記述子・FILE * は本物の関数で処理する。
+ * ファイル記述子は FD_BASE 以上を返す。FILE * は fopencookie で作成した本物のストリームを返すため、
+ * mock を経由しない stdio 関数 (fgetc 等) でも読み書きできる (fileno は -1 を返す)。
+ * 生存期間中のみ有効で、同時に生成できるのは 1 個のみ。破棄時に開いているファイルはすべて閉じる。
+ * 閉じた FILE * の読み書きは EBADF で失敗し、fclose で解放する (テスト対象コードが保持していても安全に閉じられる)。
+ * Mock_stdio 等で動作を設定した場合や障害注入で失敗させる場合はそちらを優先する。
+ *
+ * 使用例:
+ *   VirtualFileSystem vfs;
+ *   vfs.writeFile("/etc/app.conf", "level=3\n");
+ *   EXPECT_EQ(0, load_config("/etc/app.conf"));
+ */
+class VirtualFileSystem
+{
+  public:
+    /** VirtualFileSystem が返すファイル記述子の最小値 (本物のファイル記述子と重ならない範囲)。 */
+    static constexpr int FD_BASE = 1 << 20;
+
+    /**
+     * 合成ファイルの mmap で 1 回に生成する内容の上限 (バイト)。
+     * mmap は範囲の内容をすべて生成して memfd に書き込むため、上限を超える範囲は ENOMEM で失敗する。
+     */
+    static constexpr uint64_t MAX_SYNTHETIC_MAP_SIZE = uint64_t(256) << 20;
+
+    explicit VirtualFileSystem(const string &mount_point = "/");
+    ~VirtualFileSystem();
+
+    VirtualFileSystem(const VirtualFileSystem &) = delete;
+    VirtualFileSystem &operator=(const VirtualFileSystem &) = delete;
+
+    /** ファイルを作成 (既存の場合は置き換え) する。親ディレクトリも作成する。 */
+    bool writeFile(const string &path, const string &contents, mode_t mode = 0644);
+
+    /**
+     * 大きさ size で、内容を読み込み時に content から生成するファイルを作成 (既存の場合は置き換え) する。
+     * 書き込んだ範囲のみメモリーに保持する。ftruncate で縮めた後に伸ばした範囲は 0 とする。
+     */
+    bool writeSyntheticFile(const string &path, uint64_t size, const SyntheticFileContent &content,
+                            mode_t mode = 0644);
+
+    /** ファイルの内容を取得する。 */
+    bool readFile(const string &path, string *contents) const;
+
+    bool exists(const string &path) const;
+
+    /** ディレクトリを親ディレクトリも含めて作成する。 */
+    bool makeDirectories(const string &path, mode_t mode = 0755);
+
+    /** ディレクトリの要素名を名前順で返す。 */
+    vector<string> listDirectory(const string &path) const;
+
+    /** 相対パスの基準とするディレクトリ (mount_point 配下の絶対パス)。 */
+    void setWorkingDirectory(const string &path);
+
+    /**
+     * 現在のファイル ツリーを保存する。開いているファイルは含まない。
+     * ファイル ツリーを複製せずに共有し (copy-on-write)、以降に変更したファイルとディレクトリのみ複製する。
+     */
+    shared_ptr<const VirtualFileSystemSnapshot> snapshot() const;
+
+    /**
+     * 保存したファイル ツリーに戻す。保存後の変更の量に関わらず、ファイル ツリーの複製は行わない。
+     * 同じスナップショットに何度でも戻せる。開いているファイルは、戻す前のファイルを参照し続ける。
+     */
+    void restore(const shared_ptr<const VirtualFileSystemSnapshot> &snapshot);
+
+    /** 開いているファイル記述子と FILE * の数。 */
+    size_t openFileCount() const;
+
+    /** mmap / munmap / msync の統計。 */
+    VirtualMappingStats mappingStats() const;
+
+  private:
+    unique_ptr<VirtualFileSystemState> state_;
+};
+
+/** 生成中の VirtualFileSystem (無い場合は nullptr)。 */
+extern VirtualFileSystem *getVirtualFileSystem();
+
+/**
+ * VirtualFileSystem(mount_point) を生成し、各テストの開始時にファイル ツリーを保存して、
+ * 終了時にテスト中に開いたファイルを閉じてファイル ツリーを戻す Google Test のイベント リスナーを登録する。
+ * RUN_ALL_TESTS() の前に呼び出す。SetUpTestSuite 等で作成したファイルはテスト間で共有する。
+ */
+extern void installVirtualFileSystemListener(const string &mount_point = "/");
+
+/**
+ * delegate_real_* から呼び出す。VirtualFileSystem が無い場合は atomic ロード 1 回のみで false を返す。
+ * パス / ファイル記述子 / FILE * が VirtualFileSystem の対象の場合に処理して true を返し、
+ * *result に本物の関数と同じ戻り値を設定する (失敗時は errno も設定する)。
+ */
+extern bool virtualOpen(const char *path, int flags, int mode, int *result);
+extern bool virtualClose(int fd, int *result);
+extern bool virtualRead(int fd, void *buf, size_t count, ssize_t *result);
+extern bool virtualWrite(int fd, const void *buf, size_t count, ssize_t *result);
+extern bool virtualLseek(int fd, off_t offset, int whence, off_t *result);
+extern bool virtualFstat(int fd, struct stat *buf, int *result);
+extern bool virtualFsync(int fd, int *result);
+extern bool virtualFtruncate(int fd, off_t length, int *result);
+extern bool virtualStat(const char *path, struct stat *buf, int *result);
+extern bool virtualAccess(const char *path, int amode, int *result);
+extern bool virtualUnlink(const char *path, int *result);
+extern bool virtualRename(const char *oldpath, const char *newpath, int *result);
+extern bool virtualMkdir(const char *path, mode_t mode, int *result);
+extern bool virtualRmdir(const char *path, int *result);
+extern bool virtualRemove(const char *path, int *result);
+/** FILE * の以降の操作は本物の stdio 関数が fopencookie の関数経由で処理する。 */
+extern bool virtualFopen(const char *path, const char *modes, FILE **result);
+/**
+ * VirtualFileSystem のファイル記述子の mmap は、マップする範囲の内容を設定した memfd を本物の mmap でマップする。
+ * MAP_SHARED の変更は msync と munmap でファイルに書き戻す。
+ * 合成ファイルの内容を生成する範囲が VirtualFileSystem::MAX_SYNTHETIC_MAP_SIZE を超える場合は ENOMEM で失敗する。
+ */
+extern bool virtualMmap(void *addr, size_t length, int prot, int flags, int fd, off_t offset, void **result);
+extern bool virtualMunmap(void *addr, size_t length, int *result);
+extern bool virtualMsync(void *addr, size_t length, int flags, int *result);
+
+} // namespace testing
+
+    #pragma GCC diagnostic pop
+
+#endif // _WIN32
+
+#endif // _VIRTUAL_FILE_SYSTEM_H
@@ -0,0 +1,117 @@
+#ifndef _VIRTUAL_NETWORK_H
+#define _VIRTUAL_NETWORK_H
+
+#ifndef _WIN32
+
+    #include <cstddef>
+    #include <cstdint>
+    #include <memory>
+
+    #include <poll.h>
+    #include <sys/select.h>
+    #include <sys/socket.h>
+    #include <sys/types.h>
+
+using namespace std;
+
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wpadded"
+
+namespace testing
+{
+
+struct VirtualNetworkState;
+
+/** VirtualNetwork の通信の統計。 */
+struct VirtualNetworkStats
+{
+    uint64_t connections = 0;       ///< 確立したストリームの接続の数
+    uint64_t refused = 0;           ///< 接続先が無いため失敗した connect の数
+    uint64_t stream_bytes = 0;      ///< ストリームで送信したバイト数
+    uint64_t datagrams = 0;         ///< 配送したデータグラムの数
+    uint64_t dropped_datagrams = 0; ///< 宛先が無い、または受信バッファーが一杯のため破棄したデータグラムの数
+};
+
+/**
+ * sys/socket の mock 関数の委譲先 (delegate_real_*) を、プロセス内のメモリー上のソケットに切り替える。
+ * 生存期間中に作成した AF_INET / AF_INET6 / AF_UNIX の SOCK_STREAM / SOCK_DGRAM のソケットが対象で、
+ * bind したアドレスはプロセス内のアドレス表にのみ登録し、本物のポートは使用しない。
+ * 送受信はリング バッファーで行い、read / write / close / fcntl (O_NONBLOCK) / poll / select も処理する。
+ * select で使用できるよう、ソケットのファイル記述子は本物のファイル記述子 (eventfd) を予約して割り当てる。
+ * VirtualClock がある場合、待機と SO_RCVTIMEO / SO_SNDTIMEO・poll / select のタイムアウトは仮想時刻で動作する。
+ * 生存期間中のみ有効で、同時に生成できるのは 1 個のみ。破棄時に開いているソケットはすべて閉じる。
+ * Mock_sys_socket 等で動作を設定した場合や read / write / close を障害注入で失敗させる場合はそちらを優先する。
+ *
+ * 使用例:
+ *   VirtualNetwork network;
+ *   int server = start_server(8080);            // socket / bind / listen
+ *   EXPECT_EQ(0, client_request("127.0.0.1", 8080));
+ */
+class VirtualNetwork
+{
+  public:
+    /** ストリームの受信バッファー (SO_RCVBUF) とデータグラムの受信キューの既定の大きさ。 */
+    static constexpr size_t DEFAULT_BUFFER_SIZE = 256 * 1024;
+
+    VirtualNetwork();
+    ~VirtualNetwork();
+
+    VirtualNetwork(const VirtualNetwork &) = delete;
+    VirtualNetwork &operator=(const VirtualNetwork &) = delete;
+
+    /** 以降に作成するソケットの受信バッファーの大きさ。 */
+    void setBufferSize(size_t bytes);
+
+    /** 開いているソケットの数 (accept されていない接続を除く)。 */
+    size_t openSocketCount() const;
+
+    /** 通信の統計。 */
+    VirtualNetworkStats stats() const;
+
+  private:
+    unique_ptr<VirtualNetworkState> state_;
+};
+
+/** 生成中の VirtualNetwork (無い場合は nullptr)。 */
+extern VirtualNetwork *getVirtualNetwork();
+
+/**
+ * delegate_real_* から呼び出す。VirtualNetwork が無い場合は atomic ロード 1 回のみで false を返す。
+ * ソケット / ファイル記述子が VirtualNetwork の対象の場合に処理して true を返し、
+ * *result に本物の関数と同じ戻り値を設定する (失敗時は errno も設定する)。
+ * SIGPIPE は発生させない (MSG_NOSIGNAL を指定した場合と同じ)。
+ */
+extern bool virtualNetworkSocket(int domain, int type, int protocol, int *result);
+extern bool virtualNetworkBind(int sockfd, const struct sockaddr *addr, socklen_t addrlen, int *result);
+extern bool virtualNetworkListen(int sockfd, int backlog, int *result);
+extern bool virtualNetworkAccept(int sockfd, struct sockaddr *addr, socklen_t *addrlen, int *result);
+extern bool virtualNetworkConnect(int sockfd, const struct sockaddr *addr, socklen_t addrlen, int *result);
+extern bool virtualNetworkShutdown(int sockfd, int how, int *result);
+extern bool virtualNetworkSetsockopt(int sockfd, int level, int optname, const void *optval, socklen_t optlen,
+                                     int *result);
+extern bool virtualNetworkGetsockopt(int sockfd, int level, int optname, void *optval, socklen_t *optlen, int *result);
+extern bool virtualNetworkSend(int sockfd, const void *buf, size_t len, int flags, ssize_t *result);
+extern bool virtualNetworkRecv(int sockfd, void *buf, size_t len, int flags, ssize_t *result);
+extern bool virtualNetworkSendto(int sockfd, const void *buf, size_t len, int flags, const struct sockaddr *dest_addr,
+                                 socklen_t addrlen, ssize_t *result);
+extern bool virtualNetworkRecvfrom(int sockfd, void *buf, size_t len, int flags, struct sockaddr *src_addr,
+                                   socklen_t *addrlen, ssize_t *result);
+extern bool virtualNetworkClose(int fd, int *result);
+extern bool virtualNetworkRead(int fd, void *buf, size_t count, ssize_t *result);
+extern bool virtualNetworkWrite(int fd, const void *buf, size_t count, ssize_t *result);
+/** getpeername の mock 関数は無いため、他の委譲先の機能 (NetworkImpairment 等) が相手のアドレスの取得に使用する。 */
+extern bool virtualNetworkGetpeername(int sockfd, struct sockaddr *addr, socklen_t *addrlen, int *result);
+/** F_GETFL / F_SETFL のみ処理する (F_GETFD 等は予約した本物のファイル記述子で処理する)。 */
+extern bool virtualNetworkFcntl(int fd, int cmd, intptr_t arg, int *result);
+/** 対象のソケットを含む場合のみ処理する。本物のファイル記述子は 1 ms ごとに確認する。 */
+extern bool virtualNetworkPoll(struct pollfd *fds, nfds_t nfds, int timeout, int *result);
+extern bool virtualNetworkSelect(int nfds, fd_set *readfds, fd_set *writefds, fd_set *exceptfds,
+                                 struct timeval *timeout, int *result);
+
+} // namespace testing
+
+    #pragma GCC diagnostic pop
+
+#endif // _WIN32
+
+#endif // _VIRTUAL_NETWORK_H
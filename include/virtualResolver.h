@@ -0,0 +1,110 @@
+#ifndef _VIRTUAL_RESOLVER_H
+#define _VIRTUAL_RESOLVER_H
+
+#ifndef _WIN32
+
+    #include <chrono>
+    #include <cstddef>
+    #include <cstdint>
+    #include <memory>
+    #include <string>
+
+    #include <netdb.h>
+
+using namespace std;
+
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wpadded"
+
+namespace testing
+{
+
+struct VirtualResolverState;
+
+/**
+ * getaddrinfo / freeaddrinfo の mock 関数の委譲先 (delegate_real_*) を、登録した名前の表で処理する。
+ * 本物のリゾルバー (DNS) を使用しないため、ネットワークの無い環境でも同じ結果を返す。
+ * 名前解決ごとの遅延 (VirtualClock がある場合は仮想時刻) と失敗 (EAI_AGAIN 等) を注入でき、
+ * 接続プールのウォームアップや DNS のキャッシュの試験に使用する。
+ * "localhost" (127.0.0.1 / ::1) は登録済み。結果の addrinfo の連結リストは 1 個のブロックに格納し、ブロックを再利用する。
+ * 生存期間中のみ有効で、同時に生成できるのは 1 個のみ。Mock_netdb で動作を設定した場合はそちらを優先する。
+ *
+ * 使用例:
+ *   VirtualResolver resolver;
+ *   resolver.addHost("db.example.com", "10.0.0.5").failLookups("db.example.com", EAI_AGAIN, 2);
+ *   EXPECT_EQ(0, pool_warm_up("db.example.com"));           // 2 回の EAI_AGAIN の後に成功する
+ *   EXPECT_EQ(3U, resolver.lookupCount("db.example.com"));
+ */
+class VirtualResolver
+{
+  public:
+    /** seed は failWithProbability の判定に使用する。 */
+    explicit VirtualResolver(uint64_t seed = 0);
+    ~VirtualResolver();
+
+    VirtualResolver(const VirtualResolver &) = delete;
+    VirtualResolver &operator=(const VirtualResolver &) = delete;
+
+    /** name に address (IPv4 / IPv6 の数値表記) を追加する。getaddrinfo は追加順に返す。 */
+    VirtualResolver &addHost(const string &name, const string &address);
+
+    /** name の登録を削除する (以降は EAI_NONAME)。 */
+    VirtualResolver &removeHost(const string &name);
+
+    /**
+     * hosts ファイルの形式 ("address 正式名 [別名...]"、'#' 以降はコメント) の text を追加する。
+     * AI_CANONNAME の ai_canonname は正式名。
+     */
+    VirtualResolver &loadHosts(const string &text);
+
+    /** hosts ファイルの形式のファイルを追加する。読み込めない場合は false を返す。 */
+    bool loadHostsFile(const string &path);
+
+    /** 名前解決ごとの遅延 (jitter 未満の揺らぎを加える)。数値表記のアドレスは遅延しない。 */
+    VirtualResolver &setLatency(chrono::nanoseconds latency, chrono::nanoseconds jitter = chrono::nanoseconds(0));
+
+    /** name_glob ('*' / '?' を使用可) に一致する名前の解決を eai_error で失敗させる。count は回数 (0 は無制限)。 */
+    VirtualResolver &failLookups(const string &name_glob, int eai_error, uint64_t count = 0);
+
+    /** name_glob に一致する名前の解決を、確率 probability で eai_error で失敗させる。 */
+    VirtualResolver &failWithProbability(const string &name_glob, int eai_error, double probability);
+
+    /** 表に無い名前を本物のリゾルバーで解決する (既定値は false で、EAI_NONAME を返す)。 */
+    VirtualResolver &setFallbackToSystem(bool fallback);
+
+    /** name の解決の回数 (失敗を含む。数値表記のアドレスは数えない)。 */
+    uint64_t lookupCount(const string &name) const;
+
+    /** すべての名前の解決の回数。 */
+    uint64_t totalLookups() const;
+
+    /** 返した addrinfo のうち freeaddrinfo していない数 (VirtualResolver の生存期間に依らず全体の数)。 */
+    size_t outstandingResults() const;
+
+  private:
+    unique_ptr<VirtualResolverState> state_;
+};
+
+/** 生成中の VirtualResolver (無い場合は nullptr)。 */
+extern VirtualResolver *getVirtualResolver();
+
+/**
+ * delegate_real_getaddrinfo から呼び出す。VirtualResolver が無い場合は atomic ロード 1 回のみで false を返す。
+ * 処理した場合に true を返し、*result に getaddrinfo と同じ戻り値を設定する。
+ */
+extern bool virtualGetaddrinfo(const char *node, const char *service, const struct addrinfo *hints,
+                               struct addrinfo **res, int *result);
+
+/**
+ * delegate_real_freeaddrinfo から呼び出す。virtualGetaddrinfo が返した res の場合に解放して true を返す。
+ * VirtualResolver の破棄後に解放する場合も処理する。
+ */
+extern bool virtualFreeaddrinfo(struct addrinfo *res);
+
+} // namespace testing
+
+    #pragma GCC diagnostic pop
+
+#endif // _WIN32
+
+#endif // _VIRTUAL_RESOLVER_H
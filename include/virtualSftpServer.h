@@ -0,0 +1,135 @@
+#ifndef _VIRTUAL_SFTP_SERVER_H
+#define _VIRTUAL_SFTP_SERVER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <mock_libssh.h>
+
+using namespace std;
+
+#ifndef _WIN32
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wpadded"
+#endif // _WIN32
+
+namespace testing
+{
+
+/** VirtualSftpServer::failOperation() の対象の操作 (ビット和で組み合わせる)。 */
+enum VirtualSftpOperation
+{
+    SFTP_OP_OPEN = 0x0001,    ///< sftp_open
+    SFTP_OP_CLOSE = 0x0002,   ///< sftp_close
+    SFTP_OP_READ = 0x0004,    ///< sftp_read
+    SFTP_OP_WRITE = 0x0008,   ///< sftp_write
+    SFTP_OP_STAT = 0x0010,    ///< sftp_stat / sftp_lstat / sftp_fstat
+    SFTP_OP_OPENDIR = 0x0020, ///< sftp_opendir
+    SFTP_OP_READDIR = 0x0040, ///< sftp_readdir
+    SFTP_OP_MKDIR = 0x0080,   ///< sftp_mkdir
+    SFTP_OP_RMDIR = 0x0100,   ///< sftp_rmdir
+    SFTP_OP_UNLINK = 0x0200,  ///< sftp_unlink
+    SFTP_OP_RENAME = 0x0400,  ///< sftp_rename (元のパスで照合する)
+    SFTP_OP_ALL = 0x07ff,
+};
+
+/** VirtualSftpServer の統計。 */
+struct VirtualSftpStats
+{
+    uint64_t opens = 0;           ///< 成功した sftp_open の回数
+    uint64_t open_handles = 0;    ///< 開いているファイル / ディレクトリのハンドルの数
+    uint64_t read_calls = 0;      ///< 成功した sftp_read の回数
+    uint64_t bytes_read = 0;      ///< sftp_read で読み込んだバイト数
+    uint64_t write_calls = 0;     ///< 成功した sftp_write の回数
+    uint64_t bytes_written = 0;   ///< sftp_write で書き込んだバイト数
+    uint64_t injected_errors = 0; ///< failOperation で失敗させた回数
+};
+
+struct VirtualSftpServerState;
+
+/**
+ * libssh の SFTP の fake 関数 (delegate_fake_sftp_*) を、メモリー上のディレクトリ ツリーで処理する SFTP サーバー。
+ * sftp_open のハンドルはオフセットを持ち (sftp_seek64 / sftp_tell64)、sftp_read / sftp_write でデータを読み書きする。
+ * sftp_stat / sftp_readdir は種類・大きさ・パーミッション・時刻を返し、失敗時は sftp_get_error に SSH_FX_* を設定する。
+ * パーミッションは所有者のビットで判定する。相対パスは "/" からのパスとする。
+ * 生存期間中のみ有効で、同時に生成できるのは 1 個のみ。生成していない場合、fake 関数は従来どおりダミーの値を返す。
+ *
+ * 使用例:
+ *   VirtualSftpServer server;
+ *   server.addDirectory("/upload").addFile("/data/in.bin", payload);
+ *   server.failOperation(SFTP_OP_WRITE, "/upload", SSH_FX_CONNECTION_LOST, 1, 16); // 17 回目の書き込みで切断
+ *   EXPECT_EQ(0, transfer_client(...));
+ *   string uploaded;
+ *   EXPECT_TRUE(server.readFile("/upload/in.bin", &uploaded));
+ */
+class VirtualSftpServer
+{
+  public:
+    VirtualSftpServer();
+    ~VirtualSftpServer();
+
+    VirtualSftpServer(const VirtualSftpServer &) = delete;
+    VirtualSftpServer &operator=(const VirtualSftpServer &) = delete;
+
+    /** ディレクトリを作成する (途中のディレクトリも 0755 で作成する)。 */
+    VirtualSftpServer &addDirectory(const string &path, uint32_t permissions = 0755);
+
+    /** content のファイルを作成する (既存の場合は置き換える。途中のディレクトリも作成する)。 */
+    VirtualSftpServer &addFile(const string &path, const string &content, uint32_t permissions = 0644);
+
+    /** パーミッション (下位 12 ビット) を変更する。path が無い場合は false を返す。 */
+    bool setPermissions(const string &path, uint32_t permissions);
+
+    /** path のファイルの内容を *content に設定する。ファイルが無い場合は false を返す。 */
+    bool readFile(const string &path, string *content) const;
+
+    /** path (ファイル / ディレクトリ) があるか。 */
+    bool exists(const string &path) const;
+
+    /**
+     * path (そのパス、またはその配下。空はすべて) の operations を sftp_error (SSH_FX_*) で失敗させる。
+     * 一致する呼び出しのうち最初の skip 回は失敗させず、その後の count 回 (0 は無制限) を失敗させる。
+     */
+    VirtualSftpServer &failOperation(int operations, const string &path, int sftp_error, uint64_t count = 0,
+                                     uint64_t skip = 0);
+
+    /** 1 回の sftp_read / sftp_write で転送する最大バイト数 (0 は無制限)。 */
+    VirtualSftpServer &limitTransferSize(size_t max_bytes);
+
+    VirtualSftpStats stats() const;
+
+  private:
+    unique_ptr<VirtualSftpServerState> state_;
+};
+
+/*
+ * 以下は delegate_fake_sftp_* から呼び出す。VirtualSftpServer が無い場合 (ハンドルの場合はそのサーバーのハンドルでない場合) は
+ * false を返し、処理した場合に true を返して *result に戻り値を設定する。
+ */
+extern bool virtualSftpGetError(sftp_session sftp, int *result);
+extern void virtualSftpForgetSession(sftp_session sftp);
+extern bool virtualSftpOpen(sftp_session sftp, const char *path, int accesstype, mode_t mode, sftp_file *result);
+extern bool virtualSftpClose(sftp_file file, int *result);
+extern bool virtualSftpRead(sftp_file file, void *buf, size_t count, ssize_t *result);
+extern bool virtualSftpWrite(sftp_file file, const void *buf, size_t count, ssize_t *result);
+extern bool virtualSftpSeek(sftp_file file, uint64_t offset, int *result);
+extern bool virtualSftpTell(sftp_file file, uint64_t *result);
+extern bool virtualSftpFstat(sftp_file file, sftp_attributes *result);
+extern bool virtualSftpOpendir(sftp_session sftp, const char *path, sftp_dir *result);
+extern bool virtualSftpReaddir(sftp_dir dir, sftp_attributes *result);
+extern bool virtualSftpClosedir(sftp_dir dir, int *result);
+extern bool virtualSftpMkdir(sftp_session sftp, const char *path, mode_t mode, int *result);
+extern bool virtualSftpRmdir(sftp_session sftp, const char *path, int *result);
+extern bool virtualSftpUnlink(sftp_session sftp, const char *path, int *result);
+extern bool virtualSftpRename(sftp_session sftp, const char *original, const char *newname, int *result);
+extern bool virtualSftpStat(sftp_session sftp, const char *path, sftp_attributes *result);
+
+} // namespace testing
+
+#ifndef _WIN32
+    #pragma GCC diagnostic pop
+#endif // _WIN32
+
+#endif // _VIRTUAL_SFTP_SERVER_H
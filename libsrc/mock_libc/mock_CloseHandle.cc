@@ -18,9 +18,9 @@ BOOL mock_CloseHandle(const char *file, const int line, const char *func, HANDLE
 {
     BOOL mock_ret;
 
-    if (_mock_windows != nullptr)
+    if (auto locked_windows = _mock_windows.lock())
     {
-        mock_ret = _mock_windows->CloseHandle(file, line, func, handle);
+        mock_ret = locked_windows->CloseHandle(file, line, func, handle);
     }
     else
     {
@@ -22,9 +22,9 @@ HANDLE mock_CreateFileMappingA(const char *file, const int line, const char *fun
 {
     HANDLE mock_ret;
 
-    if (_mock_windows != nullptr)
+    if (auto locked_windows = _mock_windows.lock())
     {
-        mock_ret = _mock_windows->CreateFileMappingA(file, line, func, mapping_file, attributes, protect, size_high,
+        mock_ret = locked_windows->CreateFileMappingA(file, line, func, mapping_file, attributes, protect, size_high,
                                                 size_low, name);
     }
     else
@@ -27,9 +27,9 @@ BOOL mock_CreateProcessW(const char *file, const int line, const char *func, LPC
 {
     BOOL mock_ret;
 
-    if (_mock_windows != nullptr)
+    if (auto locked_windows = _mock_windows.lock())
     {
-        mock_ret = _mock_windows->CreateProcessW(file, line, func, application_name, command_line, process_attributes,
+        mock_ret = locked_windows->CreateProcessW(file, line, func, application_name, command_line, process_attributes,
                                             thread_attributes, inherit_handles, creation_flags, environment,
                                             current_directory, startup_info, process_information);
     }
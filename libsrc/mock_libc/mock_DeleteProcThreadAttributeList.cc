@@ -18,9 +18,9 @@ void delegate_real_DeleteProcThreadAttributeList(const char *file, const int lin
 void mock_DeleteProcThreadAttributeList(const char *file, const int line, const char *func,
                                         LPPROC_THREAD_ATTRIBUTE_LIST attribute_list)
 {
-    if (_mock_windows != nullptr)
+    if (auto locked_windows = _mock_windows.lock())
     {
-        _mock_windows->DeleteProcThreadAttributeList(file, line, func, attribute_list);
+        locked_windows->DeleteProcThreadAttributeList(file, line, func, attribute_list);
     }
     else
     {
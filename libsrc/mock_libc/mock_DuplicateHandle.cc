@@ -23,9 +23,9 @@ BOOL mock_DuplicateHandle(const char *file, const int line, const char *func, HA
 {
     BOOL mock_ret;
 
-    if (_mock_windows != nullptr)
+    if (auto locked_windows = _mock_windows.lock())
     {
-        mock_ret = _mock_windows->DuplicateHandle(file, line, func, source_process, source_handle, target_process,
+        mock_ret = locked_windows->DuplicateHandle(file, line, func, source_process, source_handle, target_process,
                                              target_handle, desired_access, inherit_handle, options);
     }
     else
@@ -18,9 +18,9 @@ BOOL mock_FlushFileBuffers(const char *file, const int line, const char *func, H
 {
     BOOL mock_ret;
 
-    if (_mock_windows != nullptr)
+    if (auto locked_windows = _mock_windows.lock())
     {
-        mock_ret = _mock_windows->FlushFileBuffers(file, line, func, mapping_file);
+        mock_ret = locked_windows->FlushFileBuffers(file, line, func, mapping_file);
     }
     else
     {
@@ -18,9 +18,9 @@ BOOL mock_FlushViewOfFile(const char *file, const int line, const char *func, LP
 {
     BOOL mock_ret;
 
-    if (_mock_windows != nullptr)
+    if (auto locked_windows = _mock_windows.lock())
     {
-        mock_ret = _mock_windows->FlushViewOfFile(file, line, func, address, bytes);
+        mock_ret = locked_windows->FlushViewOfFile(file, line, func, address, bytes);
     }
     else
     {
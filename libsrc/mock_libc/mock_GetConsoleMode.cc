@@ -20,9 +20,9 @@ BOOL mock_GetConsoleMode(const char *file, const int line, const char *func, HAN
 {
     BOOL mock_ret;
 
-    if (_mock_windows != nullptr)
+    if (auto locked_windows = _mock_windows.lock())
     {
-        mock_ret = _mock_windows->GetConsoleMode(file, line, func, console_handle, mode);
+        mock_ret = locked_windows->GetConsoleMode(file, line, func, console_handle, mode);
     }
     else
     {
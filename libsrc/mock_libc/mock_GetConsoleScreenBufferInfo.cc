@@ -21,9 +21,9 @@ BOOL mock_GetConsoleScreenBufferInfo(const char *file, const int line, const cha
 {
     BOOL mock_ret;
 
-    if (_mock_windows != nullptr)
+    if (auto locked_windows = _mock_windows.lock())
     {
-        mock_ret = _mock_windows->GetConsoleScreenBufferInfo(file, line, func, console_handle, info);
+        mock_ret = locked_windows->GetConsoleScreenBufferInfo(file, line, func, console_handle, info);
     }
     else
     {
@@ -18,9 +18,9 @@ HANDLE mock_GetCurrentProcess(const char *file, const int line, const char *func
 {
     HANDLE mock_ret;
 
-    if (_mock_windows != nullptr)
+    if (auto locked_windows = _mock_windows.lock())
     {
-        mock_ret = _mock_windows->GetCurrentProcess(file, line, func);
+        mock_ret = locked_windows->GetCurrentProcess(file, line, func);
     }
     else
     {
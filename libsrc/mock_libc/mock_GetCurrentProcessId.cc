@@ -18,9 +18,9 @@ DWORD mock_GetCurrentProcessId(const char *file, const int line, const char *fun
 {
     DWORD mock_ret;
 
-    if (_mock_windows != nullptr)
+    if (auto locked_windows = _mock_windows.lock())
     {
-        mock_ret = _mock_windows->GetCurrentProcessId(file, line, func);
+        mock_ret = locked_windows->GetCurrentProcessId(file, line, func);
     }
     else
     {
@@ -19,9 +19,9 @@ BOOL mock_GetExitCodeProcess(const char *file, const int line, const char *func,
 {
     BOOL mock_ret;
 
-    if (_mock_windows != nullptr)
+    if (auto locked_windows = _mock_windows.lock())
     {
-        mock_ret = _mock_windows->GetExitCodeProcess(file, line, func, process, exit_code);
+        mock_ret = locked_windows->GetExitCodeProcess(file, line, func, process, exit_code);
     }
     else
     {
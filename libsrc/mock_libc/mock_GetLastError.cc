@@ -18,9 +18,9 @@ DWORD mock_GetLastError(const char *file, const int line, const char *func)
 {
     DWORD mock_ret;
 
-    if (_mock_windows != nullptr)
+    if (auto locked_windows = _mock_windows.lock())
     {
-        mock_ret = _mock_windows->GetLastError(file, line, func);
+        mock_ret = locked_windows->GetLastError(file, line, func);
     }
     else
     {
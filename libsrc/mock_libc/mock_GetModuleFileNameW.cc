@@ -20,9 +20,9 @@ DWORD mock_GetModuleFileNameW(const char *file, const int line, const char *func
 {
     DWORD mock_ret;
 
-    if (_mock_windows != nullptr)
+    if (auto locked_windows = _mock_windows.lock())
     {
-        mock_ret = _mock_windows->GetModuleFileNameW(file, line, func, module, filename, size);
+        mock_ret = locked_windows->GetModuleFileNameW(file, line, func, module, filename, size);
     }
     else
     {
@@ -19,9 +19,9 @@ HANDLE mock_GetStdHandle(const char *file, const int line, const char *func, DWO
 {
     HANDLE mock_ret;
 
-    if (_mock_windows != nullptr)
+    if (auto locked_windows = _mock_windows.lock())
     {
-        mock_ret = _mock_windows->GetStdHandle(file, line, func, std_handle);
+        mock_ret = locked_windows->GetStdHandle(file, line, func, std_handle);
     }
     else
     {
@@ -32,9 +32,9 @@ void delegate_real_GetSystemTimeAsFileTime(const char *file, const int line, con
 
 void mock_GetSystemTimeAsFileTime(const char *file, const int line, const char *func, LPFILETIME file_time)
 {
-    if (_mock_windows != nullptr)
+    if (auto locked_windows = _mock_windows.lock())
     {
-        _mock_windows->GetSystemTimeAsFileTime(file, line, func, file_time);
+        locked_windows->GetSystemTimeAsFileTime(file, line, func, file_time);
     }
     else
     {
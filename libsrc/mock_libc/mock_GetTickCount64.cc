@@ -29,9 +29,9 @@ ULONGLONG mock_GetTickCount64(const char *file, const int line, const char *func
 {
     ULONGLONG mock_ret;
 
-    if (_mock_windows != nullptr)
+    if (auto locked_windows = _mock_windows.lock())
     {
-        mock_ret = _mock_windows->GetTickCount64(file, line, func);
+        mock_ret = locked_windows->GetTickCount64(file, line, func);
     }
     else
     {
@@ -22,9 +22,9 @@ BOOL mock_InitializeProcThreadAttributeList(const char *file, const int line, co
 {
     BOOL mock_ret;
 
-    if (_mock_windows != nullptr)
+    if (auto locked_windows = _mock_windows.lock())
     {
-        mock_ret = _mock_windows->InitializeProcThreadAttributeList(file, line, func, attribute_list, attribute_count, flags,
+        mock_ret = locked_windows->InitializeProcThreadAttributeList(file, line, func, attribute_list, attribute_count, flags,
                                                                size);
     }
     else
@@ -20,9 +20,9 @@ LPVOID mock_MapViewOfFile(const char *file, const int line, const char *func, HA
 {
     LPVOID mock_ret;
 
-    if (_mock_windows != nullptr)
+    if (auto locked_windows = _mock_windows.lock())
     {
-        mock_ret = _mock_windows->MapViewOfFile(file, line, func, mapping, access, offset_high, offset_low, bytes);
+        mock_ret = locked_windows->MapViewOfFile(file, line, func, mapping, access, offset_high, offset_low, bytes);
     }
     else
     {
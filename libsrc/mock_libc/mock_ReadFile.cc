@@ -21,9 +21,9 @@ BOOL mock_ReadFile(const char *file, const int line, const char *func, HANDLE fi
 {
     BOOL mock_ret;
 
-    if (_mock_windows != nullptr)
+    if (auto locked_windows = _mock_windows.lock())
     {
-        mock_ret = _mock_windows->ReadFile(file, line, func, file_handle, buffer, bytes_to_read, bytes_read, overlapped);
+        mock_ret = locked_windows->ReadFile(file, line, func, file_handle, buffer, bytes_to_read, bytes_read, overlapped);
     }
     else
     {
@@ -18,9 +18,9 @@ BOOL mock_TerminateProcess(const char *file, const int line, const char *func, H
 {
     BOOL mock_ret;
 
-    if (_mock_windows != nullptr)
+    if (auto locked_windows = _mock_windows.lock())
     {
-        mock_ret = _mock_windows->TerminateProcess(file, line, func, process, exit_code);
+        mock_ret = locked_windows->TerminateProcess(file, line, func, process, exit_code);
     }
     else
     {
@@ -18,9 +18,9 @@ BOOL mock_UnmapViewOfFile(const char *file, const int line, const char *func, LP
 {
     BOOL mock_ret;
 
-    if (_mock_windows != nullptr)
+    if (auto locked_windows = _mock_windows.lock())
     {
-        mock_ret = _mock_windows->UnmapViewOfFile(file, line, func, address);
+        mock_ret = locked_windows->UnmapViewOfFile(file, line, func, address);
     }
     else
     {
@@ -23,9 +23,9 @@ BOOL mock_UpdateProcThreadAttribute(const char *file, const int line, const char
 {
     BOOL mock_ret;
 
-    if (_mock_windows != nullptr)
+    if (auto locked_windows = _mock_windows.lock())
     {
-        mock_ret = _mock_windows->UpdateProcThreadAttribute(file, line, func, attribute_list, flags, attribute, value, size,
+        mock_ret = locked_windows->UpdateProcThreadAttribute(file, line, func, attribute_list, flags, attribute, value, size,
                                                        previous, return_size);
     }
     else
@@ -20,9 +20,9 @@ DWORD mock_WaitForSingleObject(const char *file, const int line, const char *fun
 {
     DWORD mock_ret;
 
-    if (_mock_windows != nullptr)
+    if (auto locked_windows = _mock_windows.lock())
     {
-        mock_ret = _mock_windows->WaitForSingleObject(file, line, func, handle, milliseconds);
+        mock_ret = locked_windows->WaitForSingleObject(file, line, func, handle, milliseconds);
     }
     else
     {
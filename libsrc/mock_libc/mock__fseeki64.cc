@@ -32,9 +32,9 @@ int mock__fseeki64(const char *file, const int line, const char *func, FILE *str
 {
     int mock_ret;
 
-    if (_mock_stdio != nullptr)
+    if (auto locked_stdio = _mock_stdio.lock(Mock_stdio::METHOD__fseeki64))
     {
-        mock_ret = _mock_stdio->_fseeki64(file, line, func, stream, offset, whence);
+        mock_ret = locked_stdio->_fseeki64(file, line, func, stream, offset, whence);
     }
     else
     {
@@ -28,9 +28,9 @@ __int64 mock__ftelli64(const char *file, const int line, const char *func, FILE
 {
     __int64 mock_ret;
 
-    if (_mock_stdio != nullptr)
+    if (auto locked_stdio = _mock_stdio.lock(Mock_stdio::METHOD__ftelli64))
     {
-        mock_ret = _mock_stdio->_ftelli64(file, line, func, stream);
+        mock_ret = locked_stdio->_ftelli64(file, line, func, stream);
     }
     else
     {
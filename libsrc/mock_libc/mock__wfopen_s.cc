@@ -47,9 +47,9 @@ errno_t mock__wfopen_s(const char *file, const int line, const char *func, FILE
 {
     errno_t mock_ret;
 
-    if (_mock_stdio != nullptr)
+    if (auto locked_stdio = _mock_stdio.lock(Mock_stdio::METHOD__wfopen_s))
     {
-        mock_ret = _mock_stdio->_wfopen_s(file, line, func, pFile, filename, modes);
+        mock_ret = locked_stdio->_wfopen_s(file, line, func, pFile, filename, modes);
     }
     else
     {
@@ -35,9 +35,9 @@ FILE *mock__wfsopen(const char *file, const int line, const char *func, const wc
 {
     FILE *mock_ret;
 
-    if (_mock_stdio != nullptr)
+    if (auto locked_stdio = _mock_stdio.lock(Mock_stdio::METHOD__wfsopen))
     {
-        mock_ret = _mock_stdio->_wfsopen(file, line, func, filename, modes, shflag);
+        mock_ret = locked_stdio->_wfsopen(file, line, func, filename, modes, shflag);
     }
     else
     {
@@ -1,6 +1,8 @@
 #ifndef _WIN32
 
     #include <test_com.h>
+    #include <virtualFileSystem.h>
+#include <callStats.h>
     #include <mock_unistd.h>
 
 using namespace testing;
@@ -12,6 +14,12 @@ int delegate_real_access(const char *file, const int line, const char *func, con
     (void)line;
     (void)func;
 
+    int virtual_ret;
+    if (virtualAccess(path, amode, &virtual_ret))
+    {
+        return virtual_ret;
+    }
+
     return access(path, amode);
 }
 
@@ -19,14 +27,16 @@ int mock_access(const char *file, const int line, const char *func, const char *
 {
     int mock_ret;
 
-    if (_mock_unistd != nullptr)
+    CallStatsTimer call_stats("access", file, line, func);
+    if (auto locked_unistd = _mock_unistd.lock(Mock_unistd::METHOD_access))
     {
-        mock_ret = _mock_unistd->access(file, line, func, path, amode);
+        mock_ret = locked_unistd->access(file, line, func, path, amode);
     }
     else
     {
         mock_ret = delegate_real_access(file, line, func, path, amode);
     }
+    call_stats.finish(mock_ret == -1);
 
     if (getTraceLevel() > TRACE_NONE)
     {
@@ -6,7 +6,7 @@
 
 using namespace testing;
 
-Mock_arpa_inet *_mock_arpa_inet = nullptr;
+testfw::MockSlot<Mock_arpa_inet> _mock_arpa_inet;
 
 Mock_arpa_inet::Mock_arpa_inet()
 {
@@ -35,9 +35,9 @@ int mock_inet_pton(const char *file, const int line, const char *func, int af, c
 {
     int mock_ret;
 
-    if (_mock_arpa_inet != nullptr)
+    if (auto locked_arpa_inet = _mock_arpa_inet.lock())
     {
-        mock_ret = _mock_arpa_inet->inet_pton(file, line, func, af, src, dst);
+        mock_ret = locked_arpa_inet->inet_pton(file, line, func, af, src, dst);
     }
     else
     {
@@ -74,9 +74,9 @@ const char *mock_inet_ntop(const char *file, const int line, const char *func, i
 {
     const char *mock_ret;
 
-    if (_mock_arpa_inet != nullptr)
+    if (auto locked_arpa_inet = _mock_arpa_inet.lock())
     {
-        mock_ret = _mock_arpa_inet->inet_ntop(file, line, func, af, src, dst, size);
+        mock_ret = locked_arpa_inet->inet_ntop(file, line, func, af, src, dst, size);
     }
     else
     {
@@ -17,9 +17,9 @@ int mock_atexit(const char *file, const int line, const char *func, mock_atexit_
 {
     int mock_ret;
 
-    if (_mock_stdlib != nullptr)
+    if (auto locked_stdlib = _mock_stdlib.lock(Mock_stdlib::METHOD_atexit))
     {
-        mock_ret = _mock_stdlib->atexit(file, line, func, callback);
+        mock_ret = locked_stdlib->atexit(file, line, func, callback);
     }
     else
     {
@@ -1,30 +1,47 @@
 #include <test_com.h>
+#include <faultInjection.h>
+#include <guardedAllocation.h>
+#include <allocationArena.h>
+#include <allocationTracker.h>
 #include <mock_stdlib.h>
 
 using namespace testing;
 
 void *delegate_real_calloc(const char *file, const int line, const char *func, size_t __nmemb, size_t __size)
 {
-    // avoid -Wunused-parameter
-    (void)file;
-    (void)line;
-    (void)func;
-
-    return calloc(__nmemb, __size);
+    // Mock_stdlib の既定の動作も、Mock_stdlib が無い場合と同じくガード ページ付き・AllocationArena から確保する
+    void *allocated = NULL;
+    if (!callocGuarded(__nmemb, __size, file, line, func, &allocated) &&
+        !callocFromArena(__nmemb, __size, &allocated))
+    {
+        allocated = calloc(__nmemb, __size);
+    }
+    return allocated;
 }
 
 void *mock_calloc(const char *file, const int line, const char *func, size_t __nmemb, size_t __size)
 {
     void *mock_ret = NULL;
+    // 乗算が桁あふれする要求は UINT64_MAX として判定する (失敗は本物の calloc の ENOMEM に任せる)
+    uint64_t request_bytes = 0U;
+    if (__builtin_mul_overflow((uint64_t)__nmemb, (uint64_t)__size, &request_bytes))
+    {
+        request_bytes = UINT64_MAX;
+    }
 
-    if (_mock_stdlib != nullptr)
+    if (shouldInjectFault(FAULT_CALLOC, request_bytes))
+    {
+        mock_ret = NULL;
+    }
+    else if (auto locked_stdlib = _mock_stdlib.lock(Mock_stdlib::METHOD_calloc))
     {
-        mock_ret = _mock_stdlib->calloc(file, line, func, __nmemb, __size);
+        mock_ret = locked_stdlib->calloc(file, line, func, __nmemb, __size);
     }
     else
     {
         mock_ret = delegate_real_calloc(file, line, func, __nmemb, __size);
     }
+    trackAllocation(mock_ret, __nmemb * __size, file, line, func);
 
     if (getTraceLevel() > TRACE_NONE)
     {
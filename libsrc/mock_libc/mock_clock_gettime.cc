@@ -2,6 +2,7 @@
 
     #include <test_com.h>
     #include <mock_time.h>
+    #include <virtualClock.h>
 
 using namespace testing;
 
@@ -33,6 +34,12 @@ int delegate_real_clock_gettime(const char *file, const int line, const char *fu
     (void)line;
     (void)func;
 
+    int virtual_ret;
+    if (virtualClockGettime(clk_id, tp, &virtual_ret))
+    {
+        return virtual_ret;
+    }
+
     return clock_gettime(clk_id, tp);
 }
 
@@ -40,9 +47,9 @@ int mock_clock_gettime(const char *file, const int line, const char *func, clock
 {
     int mock_ret;
 
-    if (_mock_time != nullptr)
+    if (auto locked_time = _mock_time.lock())
     {
-        mock_ret = _mock_time->clock_gettime(file, line, func, clk_id, tp);
+        mock_ret = locked_time->clock_gettime(file, line, func, clk_id, tp);
     }
     else
     {
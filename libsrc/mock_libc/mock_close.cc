@@ -1,4 +1,9 @@
 #include <test_com.h>
+#include <virtualFileSystem.h>
+#include <virtualNetwork.h>
+#include <networkImpairment.h>
+#include <callStats.h>
+#include <faultInjection.h>
 #include <mock_unistd.h>
 
 using namespace testing;
@@ -12,6 +17,16 @@ int delegate_real_close(const char *file, const int line, const char *func, int
     (void)line;
     (void)func;
 
+    int virtual_ret;
+    if (virtualClose(fd, &virtual_ret))
+    {
+        return virtual_ret;
+    }
+    if (virtualNetworkClose(fd, &virtual_ret))
+    {
+        return virtual_ret;
+    }
+
     return close(fd);
 }
 
@@ -19,14 +34,25 @@ int mock_close(const char *file, const int line, const char *func, int fd)
 {
     int mock_ret;
 
-    if (_mock_unistd != nullptr)
+    CallStatsTimer call_stats("close", file, line, func);
+    if (shouldInjectFault(FAULT_CLOSE))
     {
-        mock_ret = _mock_unistd->close(file, line, func, fd);
+        mock_ret = -1;
     }
     else
     {
-        mock_ret = delegate_real_close(file, line, func, fd);
+        // 障害注入で失敗させた close は fd を閉じないため、障害の状態は閉じる場合のみ (fd の再利用前に) 破棄する
+        forgetImpairedSocket(fd);
+        if (auto locked_unistd = _mock_unistd.lock(Mock_unistd::METHOD_close))
+        {
+            mock_ret = locked_unistd->close(file, line, func, fd);
+        }
+        else
+        {
+            mock_ret = delegate_real_close(file, line, func, fd);
+        }
     }
+    call_stats.finish(mock_ret == -1);
 
     if (getTraceLevel() > TRACE_NONE)
     {
@@ -60,9 +86,9 @@ int mock__close(const char *file, const int line, const char *func, int fd)
 {
     int mock_ret;
 
-    if (_mock_unistd != nullptr)
+    if (auto locked_unistd = _mock_unistd.lock(Mock_unistd::METHOD__close))
     {
-        mock_ret = _mock_unistd->_close(file, line, func, fd);
+        mock_ret = locked_unistd->_close(file, line, func, fd);
     }
     else
     {
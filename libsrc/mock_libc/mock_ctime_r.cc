@@ -39,9 +39,9 @@ char *mock_ctime_r(const char *file, const int line, const char *func, const tim
 {
     char *mock_ret;
 
-    if (_mock_time != nullptr)
+    if (auto locked_time = _mock_time.lock())
     {
-        mock_ret = _mock_time->ctime_r(file, line, func, timep, buf);
+        mock_ret = locked_time->ctime_r(file, line, func, timep, buf);
     }
     else
     {
@@ -40,9 +40,9 @@ errno_t mock_ctime_s(const char *file, const int line, const char *func, char *b
 {
     errno_t mock_ret;
 
-    if (_mock_time != nullptr)
+    if (auto locked_time = _mock_time.lock())
     {
-        mock_ret = _mock_time->ctime_s(file, line, func, buf, size, timep);
+        mock_ret = locked_time->ctime_s(file, line, func, buf, size, timep);
     }
     else
     {
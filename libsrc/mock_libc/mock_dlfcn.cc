@@ -6,7 +6,7 @@
 
 using namespace testing;
 
-Mock_dlfcn *_mock_dlfcn = nullptr;
+testfw::MockSlot<Mock_dlfcn> _mock_dlfcn;
 
 Mock_dlfcn::Mock_dlfcn()
 {
@@ -37,9 +37,9 @@ void *mock_dlopen(const char *file, const int line, const char *func, const char
 {
     void *mock_ret;
 
-    if (_mock_dlfcn != nullptr)
+    if (auto locked_dlfcn = _mock_dlfcn.lock())
     {
-        mock_ret = _mock_dlfcn->dlopen(file, line, func, filename, flags);
+        mock_ret = locked_dlfcn->dlopen(file, line, func, filename, flags);
     }
     else
     {
@@ -75,9 +75,9 @@ void *mock_dlsym(const char *file, const int line, const char *func, void *handl
 {
     void *mock_ret;
 
-    if (_mock_dlfcn != nullptr)
+    if (auto locked_dlfcn = _mock_dlfcn.lock())
     {
-        mock_ret = _mock_dlfcn->dlsym(file, line, func, handle, symbol);
+        mock_ret = locked_dlfcn->dlsym(file, line, func, handle, symbol);
     }
     else
     {
@@ -113,9 +113,9 @@ int mock_dlclose(const char *file, const int line, const char *func, void *handl
 {
     int mock_ret;
 
-    if (_mock_dlfcn != nullptr)
+    if (auto locked_dlfcn = _mock_dlfcn.lock())
     {
-        mock_ret = _mock_dlfcn->dlclose(file, line, func, handle);
+        mock_ret = locked_dlfcn->dlclose(file, line, func, handle);
     }
     else
     {
@@ -151,9 +151,9 @@ int mock_dladdr(const char *file, const int line, const char *func, const void *
 {
     int mock_ret;
 
-    if (_mock_dlfcn != nullptr)
+    if (auto locked_dlfcn = _mock_dlfcn.lock())
     {
-        mock_ret = _mock_dlfcn->dladdr(file, line, func, address, info);
+        mock_ret = locked_dlfcn->dladdr(file, line, func, address, info);
     }
     else
     {
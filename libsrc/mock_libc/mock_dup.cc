@@ -19,9 +19,9 @@ int mock_dup(const char *file, const int line, const char *func, int fd)
 {
     int mock_ret;
 
-    if (_mock_unistd != nullptr)
+    if (auto locked_unistd = _mock_unistd.lock(Mock_unistd::METHOD_dup))
     {
-        mock_ret = _mock_unistd->dup(file, line, func, fd);
+        mock_ret = locked_unistd->dup(file, line, func, fd);
     }
     else
     {
@@ -60,9 +60,9 @@ int mock__dup(const char *file, const int line, const char *func, int fd)
 {
     int mock_ret;
 
-    if (_mock_unistd != nullptr)
+    if (auto locked_unistd = _mock_unistd.lock(Mock_unistd::METHOD__dup))
     {
-        mock_ret = _mock_unistd->_dup(file, line, func, fd);
+        mock_ret = locked_unistd->_dup(file, line, func, fd);
     }
     else
     {
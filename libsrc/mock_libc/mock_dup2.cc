@@ -19,9 +19,9 @@ int mock_dup2(const char *file, const int line, const char *func, int oldfd, int
 {
     int mock_ret;
 
-    if (_mock_unistd != nullptr)
+    if (auto locked_unistd = _mock_unistd.lock(Mock_unistd::METHOD_dup2))
     {
-        mock_ret = _mock_unistd->dup2(file, line, func, oldfd, newfd);
+        mock_ret = locked_unistd->dup2(file, line, func, oldfd, newfd);
     }
     else
     {
@@ -60,9 +60,9 @@ int mock__dup2(const char *file, const int line, const char *func, int oldfd, in
 {
     int mock_ret;
 
-    if (_mock_unistd != nullptr)
+    if (auto locked_unistd = _mock_unistd.lock(Mock_unistd::METHOD__dup2))
     {
-        mock_ret = _mock_unistd->_dup2(file, line, func, oldfd, newfd);
+        mock_ret = locked_unistd->_dup2(file, line, func, oldfd, newfd);
     }
     else
     {
@@ -15,8 +15,9 @@ int delegate_real_execve(const char *file, const int line, const char *func, con
 int mock_execve(const char *file, const int line, const char *func, const char *path, char *const argv[],
                 char *const envp[])
 {
-    return (_mock_unistd != nullptr) ? _mock_unistd->execve(file, line, func, path, argv, envp)
-                                     : delegate_real_execve(file, line, func, path, argv, envp);
+    auto locked_unistd = _mock_unistd.lock(Mock_unistd::METHOD_execve);
+    return locked_unistd ? locked_unistd->execve(file, line, func, path, argv, envp)
+                         : delegate_real_execve(file, line, func, path, argv, envp);
 }
 
 #endif // _WIN32
@@ -1,4 +1,6 @@
 #include <test_com.h>
+#include <callStats.h>
+#include <faultInjection.h>
 #include <mock_stdio.h>
 
 using namespace testing;
@@ -30,14 +32,20 @@ int mock_fclose(const char *file, const int line, const char *func, FILE *fp)
     int mock_ret;
     void *_fp = fp; // fclose 内にて初期化されるため、退避
 
-    if (_mock_stdio != nullptr)
+    CallStatsTimer call_stats("fclose", file, line, func);
+    if (shouldInjectFault(FAULT_FCLOSE))
     {
-        mock_ret = _mock_stdio->fclose(file, line, func, fp);
+        mock_ret = EOF;
+    }
+    else if (auto locked_stdio = _mock_stdio.lock(Mock_stdio::METHOD_fclose))
+    {
+        mock_ret = locked_stdio->fclose(file, line, func, fp);
     }
     else
     {
         mock_ret = delegate_real_fclose(file, line, func, fp);
     }
+    call_stats.finish(mock_ret == EOF);
 
     if (getTraceLevel() > TRACE_NONE)
     {
@@ -1,12 +1,13 @@
 #include <mock_instance.h>
 #include <test_com.h>
 #include <mock_fcntl.h>
+#include <virtualNetwork.h>
 
 #ifndef _WIN32
 
 using namespace testing;
 
-Mock_fcntl *_mock_fcntl = nullptr;
+testfw::MockSlot<Mock_fcntl> _mock_fcntl;
 
 Mock_fcntl::Mock_fcntl()
 {
@@ -44,6 +45,12 @@ int delegate_real_fcntl(const char *file, const int line, const char *func, int
     (void)line;
     (void)func;
 
+    int virtual_ret;
+    if (virtualNetworkFcntl(fd, cmd, arg, &virtual_ret))
+    {
+        return virtual_ret;
+    }
+
     if (takes_pointer_argument(cmd))
     {
         return fcntl(fd, cmd, (void *)arg);
@@ -56,9 +63,9 @@ int mock_fcntl(const char *file, const int line, const char *func, int fd, int c
 {
     int mock_ret;
 
-    if (_mock_fcntl != nullptr)
+    if (auto locked_fcntl = _mock_fcntl.lock())
     {
-        mock_ret = _mock_fcntl->fcntl(file, line, func, fd, cmd, arg);
+        mock_ret = locked_fcntl->fcntl(file, line, func, fd, cmd, arg);
     }
     else
     {
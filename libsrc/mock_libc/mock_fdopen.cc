@@ -31,9 +31,9 @@ FILE *mock_fdopen(const char *file, const int line, const char *func, int fd, co
 {
     FILE *mock_ret;
 
-    if (_mock_stdio != nullptr)
+    if (auto locked_stdio = _mock_stdio.lock(Mock_stdio::METHOD_fdopen))
     {
-        mock_ret = _mock_stdio->fdopen(file, line, func, fd, modes);
+        mock_ret = locked_stdio->fdopen(file, line, func, fd, modes);
     }
     else
     {
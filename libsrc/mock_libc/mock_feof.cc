@@ -26,9 +26,9 @@ int mock_feof(const char *file, const int line, const char *func, FILE *stream)
 {
     int mock_ret;
 
-    if (_mock_stdio != nullptr)
+    if (auto locked_stdio = _mock_stdio.lock(Mock_stdio::METHOD_feof))
     {
-        mock_ret = _mock_stdio->feof(file, line, func, stream);
+        mock_ret = locked_stdio->feof(file, line, func, stream);
     }
     else
     {
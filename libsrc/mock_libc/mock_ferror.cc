@@ -26,9 +26,9 @@ int mock_ferror(const char *file, const int line, const char *func, FILE *stream
 {
     int mock_ret;
 
-    if (_mock_stdio != nullptr)
+    if (auto locked_stdio = _mock_stdio.lock(Mock_stdio::METHOD_ferror))
     {
-        mock_ret = _mock_stdio->ferror(file, line, func, stream);
+        mock_ret = locked_stdio->ferror(file, line, func, stream);
     }
     else
     {
@@ -1,4 +1,6 @@
 #include <test_com.h>
+#include <callStats.h>
+#include <faultInjection.h>
 #include <mock_stdio.h>
 
 using namespace testing;
@@ -28,14 +30,20 @@ int mock_fflush(const char *file, const int line, const char *func, FILE *fp)
 {
     int mock_ret;
 
-    if (_mock_stdio != nullptr)
+    CallStatsTimer call_stats("fflush", file, line, func);
+    if (shouldInjectFault(FAULT_FFLUSH))
     {
-        mock_ret = _mock_stdio->fflush(file, line, func, fp);
+        mock_ret = EOF;
+    }
+    else if (auto locked_stdio = _mock_stdio.lock(Mock_stdio::METHOD_fflush))
+    {
+        mock_ret = locked_stdio->fflush(file, line, func, fp);
     }
     else
     {
         mock_ret = delegate_real_fflush(file, line, func, fp);
     }
+    call_stats.finish(mock_ret == EOF);
 
     if (getTraceLevel() > TRACE_NONE)
     {
@@ -1,4 +1,5 @@
 #include <test_com.h>
+#include <callStats.h>
 #include <mock_stdio.h>
 
 using namespace testing;
@@ -30,14 +31,16 @@ char *mock_fgets(const char *file, const int line, const char *func, char *s, in
 {
     char *mock_ret;
 
-    if (_mock_stdio != nullptr)
+    CallStatsTimer call_stats("fgets", file, line, func);
+    if (auto locked_stdio = _mock_stdio.lock(Mock_stdio::METHOD_fgets))
     {
-        mock_ret = _mock_stdio->fgets(file, line, func, s, n, stream);
+        mock_ret = locked_stdio->fgets(file, line, func, s, n, stream);
     }
     else
     {
         mock_ret = delegate_real_fgets(file, line, func, s, n, stream);
     }
+    call_stats.finish(mock_ret == NULL);
 
     if (getTraceLevel() > TRACE_NONE)
     {
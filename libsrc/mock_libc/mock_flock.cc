@@ -19,9 +19,9 @@ int mock_flock(const char *file, const int line, const char *func, int fd, int o
 {
     int mock_ret;
 
-    if (_mock_sys_file != nullptr)
+    if (auto locked_sys_file = _mock_sys_file.lock())
     {
-        mock_ret = _mock_sys_file->flock(file, line, func, fd, operation);
+        mock_ret = locked_sys_file->flock(file, line, func, fd, operation);
     }
     else
     {
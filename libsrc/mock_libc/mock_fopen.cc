@@ -1,4 +1,7 @@
 #include <test_com.h>
+#include <virtualFileSystem.h>
+#include <callStats.h>
+#include <faultInjection.h>
 #include <mock_stdio.h>
 
 #include <string.h>
@@ -27,6 +30,12 @@ FILE *delegate_real_fopen(const char *file, const int line, const char *func, co
     (void)func;
 
 #ifndef _WIN32
+    FILE *virtual_ret;
+    if (virtualFopen(filename, modes, &virtual_ret))
+    {
+        return virtual_ret;
+    }
+
     // Linux
     return fopen(filename, modes);
 #else
@@ -45,14 +54,20 @@ FILE *mock_fopen(const char *file, const int line, const char *func, const char
 {
     FILE *mock_ret;
 
-    if (_mock_stdio != nullptr)
+    CallStatsTimer call_stats("fopen", file, line, func);
+    if (shouldInjectFault(FAULT_FOPEN, 0, filename))
+    {
+        mock_ret = NULL;
+    }
+    else if (auto locked_stdio = _mock_stdio.lock(Mock_stdio::METHOD_fopen))
     {
-        mock_ret = _mock_stdio->fopen(file, line, func, filename, modes);
+        mock_ret = locked_stdio->fopen(file, line, func, filename, modes);
     }
     else
     {
         mock_ret = delegate_real_fopen(file, line, func, filename, modes);
     }
+    call_stats.finish(mock_ret == NULL);
 
     if (getTraceLevel() > TRACE_NONE)
     {
@@ -51,9 +51,9 @@ errno_t mock_fopen_s(const char *file, const int line, const char *func, FILE **
 {
     errno_t err;
 
-    if (_mock_stdio != nullptr)
+    if (auto locked_stdio = _mock_stdio.lock(Mock_stdio::METHOD_fopen_s))
     {
-        err = _mock_stdio->fopen_s(file, line, func, pFile, filename, modes);
+        err = locked_stdio->fopen_s(file, line, func, pFile, filename, modes);
     }
     else
     {
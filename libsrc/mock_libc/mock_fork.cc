@@ -19,9 +19,9 @@ pid_t mock_fork(const char *file, const int line, const char *func)
 {
     pid_t mock_ret;
 
-    if (_mock_unistd != nullptr)
+    if (auto locked_unistd = _mock_unistd.lock(Mock_unistd::METHOD_fork))
     {
-        mock_ret = _mock_unistd->fork(file, line, func);
+        mock_ret = locked_unistd->fork(file, line, func);
     }
     else
     {
@@ -42,9 +42,9 @@ int mock_fprintf(const char *file, const int line, const char *func, FILE *strea
     {
         mock_ret = -1;
     }
-    else if (_mock_stdio != nullptr)
+    else if (auto locked_stdio = _mock_stdio.lock(Mock_stdio::METHOD_fprintf))
     {
-        mock_ret = _mock_stdio->fprintf(file, line, func, stream, str);
+        mock_ret = locked_stdio->fprintf(file, line, func, stream, str);
     }
     else
     {
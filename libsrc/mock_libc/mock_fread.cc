@@ -1,4 +1,6 @@
 #include <test_com.h>
+#include <callStats.h>
+#include <faultInjection.h>
 #include <mock_stdio.h>
 
 using namespace testing;
@@ -34,15 +36,27 @@ size_t mock_fread(const char *file, const int line, const char *func, void *ptr,
                   FILE *stream)
 {
     size_t mock_ret;
+    bool is_error;
 
-    if (_mock_stdio != nullptr)
+    CallStatsTimer call_stats("fread", file, line, func);
+    if (shouldInjectFault(FAULT_FREAD, (uint64_t)size * count))
     {
-        mock_ret = _mock_stdio->fread(file, line, func, ptr, size, count, stream);
+        mock_ret = 0;
+        is_error = true;
+    }
+    else if (auto locked_stdio = _mock_stdio.lock(Mock_stdio::METHOD_fread))
+    {
+        // stream がテストのダミーの場合があるため、要素数の不足をエラーとする
+        mock_ret = locked_stdio->fread(file, line, func, ptr, size, count, stream);
+        is_error = mock_ret < count;
     }
     else
     {
+        // 要素数の不足は EOF の場合もあるため、ferror で判定する
         mock_ret = delegate_real_fread(file, line, func, ptr, size, count, stream);
+        is_error = mock_ret < count && delegate_real_ferror(file, line, func, stream) != 0;
     }
+    call_stats.finish(is_error);
 
     if (getTraceLevel() > TRACE_NONE)
     {
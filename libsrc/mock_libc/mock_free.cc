@@ -0,0 +1,47 @@
+#include <test_com.h>
+#include <allocationArena.h>
+#include <guardedAllocation.h>
+#include <allocationTracker.h>
+#include <mock_stdlib.h>
+
+using namespace testing;
+
+void delegate_real_free(const char *file, const int line, const char *func, void *__ptr)
+{
+    // avoid -Wunused-parameter
+    (void)func;
+
+    // Mock_stdlib の既定の動作からも呼び出されるため、ガード ページ付き・AllocationArena の領域はアドレスで判定して戻す
+    if (!freeGuarded(__ptr, file, line) && !freeToArena(__ptr))
+    {
+        free(__ptr);
+    }
+}
+
+void mock_free(const char *file, const int line, const char *func, void *__ptr)
+{
+    // 解放後に同じアドレスを別スレッドが再取得するため、委譲前に記録を削除する
+    trackFree(__ptr);
+
+    if (auto locked_stdlib = _mock_stdlib.lock(Mock_stdlib::METHOD_free))
+    {
+        locked_stdlib->free(file, line, func, __ptr);
+    }
+    else
+    {
+        delegate_real_free(file, line, func, __ptr);
+    }
+
+    if (getTraceLevel() > TRACE_NONE)
+    {
+        printf("  > free 0x%p", __ptr);
+        if (getTraceLevel() >= TRACE_DETAIL)
+        {
+            printf(" from %s:%d\n", file, line);
+        }
+        else
+        {
+            printf("\n");
+        }
+    }
+}
@@ -41,9 +41,9 @@ FILE *mock_freopen(const char *file, const int line, const char *func, const cha
 {
     FILE *mock_ret;
 
-    if (_mock_stdio != nullptr)
+    if (auto locked_stdio = _mock_stdio.lock(Mock_stdio::METHOD_freopen))
     {
-        mock_ret = _mock_stdio->freopen(file, line, func, path, modes, stream);
+        mock_ret = locked_stdio->freopen(file, line, func, path, modes, stream);
     }
     else
     {
@@ -1,6 +1,7 @@
 #ifndef _WIN32
 
     #include <test_com.h>
+    #include <callStats.h>
     #include <mock_stdio.h>
 
 using namespace testing;
@@ -30,14 +31,16 @@ int mock_fseeko(const char *file, const int line, const char *func, FILE *stream
 {
     int mock_ret;
 
-    if (_mock_stdio != nullptr)
+    CallStatsTimer call_stats("fseeko", file, line, func);
+    if (auto locked_stdio = _mock_stdio.lock(Mock_stdio::METHOD_fseeko))
     {
-        mock_ret = _mock_stdio->fseeko(file, line, func, stream, offset, whence);
+        mock_ret = locked_stdio->fseeko(file, line, func, stream, offset, whence);
     }
     else
     {
         mock_ret = delegate_real_fseeko(file, line, func, stream, offset, whence);
     }
+    call_stats.finish(mock_ret != 0);
 
     if (getTraceLevel() > TRACE_NONE)
     {
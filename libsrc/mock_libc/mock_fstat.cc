@@ -1,4 +1,5 @@
 #include <test_com.h>
+#include <virtualFileSystem.h>
 #include <sys/mock_stat.h>
 
 #ifndef _WIN32
@@ -12,6 +13,12 @@ int delegate_real_fstat(const char *file, const int line, const char *func, int
     (void)line;
     (void)func;
 
+    int virtual_ret;
+    if (virtualFstat(fd, buf, &virtual_ret))
+    {
+        return virtual_ret;
+    }
+
     return fstat(fd, buf);
 }
 
@@ -19,9 +26,9 @@ int mock_fstat(const char *file, const int line, const char *func, int fd, struc
 {
     int mock_ret;
 
-    if (_mock_sys_stat != nullptr)
+    if (auto locked_sys_stat = _mock_sys_stat.lock())
     {
-        mock_ret = _mock_sys_stat->fstat(file, line, func, fd, buf);
+        mock_ret = locked_sys_stat->fstat(file, line, func, fd, buf);
     }
     else
     {
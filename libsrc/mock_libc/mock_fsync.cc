@@ -1,6 +1,9 @@
 #ifndef _WIN32
 
     #include <test_com.h>
+    #include <virtualFileSystem.h>
+#include <callStats.h>
+#include <faultInjection.h>
     #include <mock_unistd.h>
 
 using namespace testing;
@@ -11,6 +14,12 @@ int delegate_real_fsync(const char *file, const int line, const char *func, int
     (void)line;
     (void)func;
 
+    int virtual_ret;
+    if (virtualFsync(fd, &virtual_ret))
+    {
+        return virtual_ret;
+    }
+
     return fsync(fd);
 }
 
@@ -18,14 +27,20 @@ int mock_fsync(const char *file, const int line, const char *func, int fd)
 {
     int mock_ret;
 
-    if (_mock_unistd != nullptr)
+    CallStatsTimer call_stats("fsync", file, line, func);
+    if (shouldInjectFault(FAULT_FSYNC))
+    {
+        mock_ret = -1;
+    }
+    else if (auto locked_unistd = _mock_unistd.lock(Mock_unistd::METHOD_fsync))
     {
-        mock_ret = _mock_unistd->fsync(file, line, func, fd);
+        mock_ret = locked_unistd->fsync(file, line, func, fd);
     }
     else
     {
         mock_ret = delegate_real_fsync(file, line, func, fd);
     }
+    call_stats.finish(mock_ret == -1);
 
     if (getTraceLevel() > TRACE_NONE)
     {
@@ -1,6 +1,7 @@
 #ifndef _WIN32
 
     #include <test_com.h>
+    #include <callStats.h>
     #include <mock_stdio.h>
 
 using namespace testing;
@@ -28,14 +29,16 @@ off_t mock_ftello(const char *file, const int line, const char *func, FILE *stre
 {
     off_t mock_ret;
 
-    if (_mock_stdio != nullptr)
+    CallStatsTimer call_stats("ftello", file, line, func);
+    if (auto locked_stdio = _mock_stdio.lock(Mock_stdio::METHOD_ftello))
     {
-        mock_ret = _mock_stdio->ftello(file, line, func, stream);
+        mock_ret = locked_stdio->ftello(file, line, func, stream);
     }
     else
     {
         mock_ret = delegate_real_ftello(file, line, func, stream);
     }
+    call_stats.finish(mock_ret == -1);
 
     if (getTraceLevel() > TRACE_NONE)
     {
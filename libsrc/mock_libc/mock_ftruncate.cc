@@ -1,6 +1,8 @@
 #ifndef _WIN32
 
     #include <test_com.h>
+    #include <virtualFileSystem.h>
+#include <callStats.h>
     #include <mock_unistd.h>
 
 using namespace testing;
@@ -12,6 +14,12 @@ int delegate_real_ftruncate(const char *file, const int line, const char *func,
     (void)line;
     (void)func;
 
+    int virtual_ret;
+    if (virtualFtruncate(fd, length, &virtual_ret))
+    {
+        return virtual_ret;
+    }
+
     return ftruncate(fd, length);
 }
 
@@ -19,14 +27,16 @@ int mock_ftruncate(const char *file, const int line, const char *func, int fd, o
 {
     int mock_ret;
 
-    if (_mock_unistd != nullptr)
+    CallStatsTimer call_stats("ftruncate", file, line, func);
+    if (auto locked_unistd = _mock_unistd.lock(Mock_unistd::METHOD_ftruncate))
     {
-        mock_ret = _mock_unistd->ftruncate(file, line, func, fd, length);
+        mock_ret = locked_unistd->ftruncate(file, line, func, fd, length);
     }
     else
     {
         mock_ret = delegate_real_ftruncate(file, line, func, fd, length);
     }
+    call_stats.finish(mock_ret == -1);
 
     if (getTraceLevel() > TRACE_NONE)
     {
@@ -19,9 +19,9 @@ char *mock_getcwd(const char *file, const int line, const char *func, char *buf,
 {
     char *mock_ret;
 
-    if (_mock_unistd != nullptr)
+    if (auto locked_unistd = _mock_unistd.lock(Mock_unistd::METHOD_getcwd))
     {
-        mock_ret = _mock_unistd->getcwd(file, line, func, buf, size);
+        mock_ret = locked_unistd->getcwd(file, line, func, buf, size);
     }
     else
     {
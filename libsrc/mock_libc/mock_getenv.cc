@@ -34,9 +34,9 @@ char *mock_getenv(const char *file, const int line, const char *func, const char
 {
     char *mock_ret;
 
-    if (_mock_stdlib != nullptr)
+    if (auto locked_stdlib = _mock_stdlib.lock(Mock_stdlib::METHOD_getenv))
     {
-        mock_ret = _mock_stdlib->getenv(file, line, func, name);
+        mock_ret = locked_stdlib->getenv(file, line, func, name);
     }
     else
     {
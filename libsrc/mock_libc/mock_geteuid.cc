@@ -13,8 +13,8 @@ uid_t delegate_real_geteuid(const char *file, const int line, const char *func)
 
 uid_t mock_geteuid(const char *file, const int line, const char *func)
 {
-    return (_mock_unistd != nullptr) ? _mock_unistd->geteuid(file, line, func)
-                                     : delegate_real_geteuid(file, line, func);
+    auto locked_unistd = _mock_unistd.lock(Mock_unistd::METHOD_geteuid);
+    return locked_unistd ? locked_unistd->geteuid(file, line, func) : delegate_real_geteuid(file, line, func);
 }
 
 #endif // _WIN32
@@ -13,7 +13,8 @@ pid_t delegate_real_getpid(const char *file, const int line, const char *func)
 
 pid_t mock_getpid(const char *file, const int line, const char *func)
 {
-    return (_mock_unistd != nullptr) ? _mock_unistd->getpid(file, line, func) : delegate_real_getpid(file, line, func);
+    auto locked_unistd = _mock_unistd.lock(Mock_unistd::METHOD_getpid);
+    return locked_unistd ? locked_unistd->getpid(file, line, func) : delegate_real_getpid(file, line, func);
 }
 
 #endif // _WIN32
@@ -41,9 +41,9 @@ struct tm *mock_gmtime_r(const char *file, const int line, const char *func, con
 {
     struct tm *mock_ret;
 
-    if (_mock_time != nullptr)
+    if (auto locked_time = _mock_time.lock())
     {
-        mock_ret = _mock_time->gmtime_r(file, line, func, timep, result);
+        mock_ret = locked_time->gmtime_r(file, line, func, timep, result);
     }
     else
     {
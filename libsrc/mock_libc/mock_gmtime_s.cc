@@ -42,9 +42,9 @@ errno_t mock_gmtime_s(const char *file, const int line, const char *func, struct
 {
     errno_t mock_ret;
 
-    if (_mock_time != nullptr)
+    if (auto locked_time = _mock_time.lock())
     {
-        mock_ret = _mock_time->gmtime_s(file, line, func, utc_tm, timep);
+        mock_ret = locked_time->gmtime_s(file, line, func, utc_tm, timep);
     }
     else
     {
@@ -6,7 +6,7 @@
 
 using namespace testing;
 
-Mock_ioctl *_mock_ioctl = nullptr;
+testfw::MockSlot<Mock_ioctl> _mock_ioctl;
 
 Mock_ioctl::Mock_ioctl()
 {
@@ -29,8 +29,9 @@ int delegate_real_ioctl(const char *file, const int line, const char *func, int
 
 int mock_ioctl(const char *file, const int line, const char *func, int fd, unsigned long request, void *arg)
 {
-    return (_mock_ioctl != nullptr) ? _mock_ioctl->ioctl(file, line, func, fd, request, arg)
-                                    : delegate_real_ioctl(file, line, func, fd, request, arg);
+    auto locked_ioctl = _mock_ioctl.lock();
+    return locked_ioctl ? locked_ioctl->ioctl(file, line, func, fd, request, arg)
+                        : delegate_real_ioctl(file, line, func, fd, request, arg);
 }
 
 #endif // _WIN32
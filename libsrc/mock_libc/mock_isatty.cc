@@ -18,9 +18,9 @@ int mock_isatty(const char *file, const int line, const char *func, int fd)
 {
     int mock_ret;
 
-    if (_mock_unistd != nullptr)
+    if (auto locked_unistd = _mock_unistd.lock(Mock_unistd::METHOD_isatty))
     {
-        mock_ret = _mock_unistd->isatty(file, line, func, fd);
+        mock_ret = locked_unistd->isatty(file, line, func, fd);
     }
     else
     {
@@ -13,8 +13,9 @@ int delegate_real_kill(const char *file, const int line, const char *func, pid_t
 
 int mock_kill(const char *file, const int line, const char *func, pid_t pid, int signal)
 {
-    return (_mock_unistd != nullptr) ? _mock_unistd->kill(file, line, func, pid, signal)
-                                     : delegate_real_kill(file, line, func, pid, signal);
+    auto locked_unistd = _mock_unistd.lock(Mock_unistd::METHOD_kill);
+    return locked_unistd ? locked_unistd->kill(file, line, func, pid, signal)
+                         : delegate_real_kill(file, line, func, pid, signal);
 }
 
 #endif // _WIN32
@@ -38,9 +38,9 @@ struct tm *mock_localtime_r(const char *file, const int line, const char *func,
 {
     struct tm *mock_ret;
 
-    if (_mock_time != nullptr)
+    if (auto locked_time = _mock_time.lock())
     {
-        mock_ret = _mock_time->localtime_r(file, line, func, timep, result);
+        mock_ret = locked_time->localtime_r(file, line, func, timep, result);
     }
     else
     {
@@ -38,9 +38,9 @@ errno_t mock_localtime_s(const char *file, const int line, const char *func, str
 {
     errno_t mock_ret;
 
-    if (_mock_time != nullptr)
+    if (auto locked_time = _mock_time.lock())
     {
-        mock_ret = _mock_time->localtime_s(file, line, func, local_tm, timep);
+        mock_ret = locked_time->localtime_s(file, line, func, local_tm, timep);
     }
     else
     {
@@ -1,4 +1,6 @@
 #include <test_com.h>
+#include <virtualFileSystem.h>
+#include <callStats.h>
 #include <mock_unistd.h>
 
 using namespace testing;
@@ -12,6 +14,12 @@ off_t delegate_real_lseek(const char *file, const int line, const char *func, in
     (void)line;
     (void)func;
 
+    off_t virtual_ret;
+    if (virtualLseek(fd, offset, whence, &virtual_ret))
+    {
+        return virtual_ret;
+    }
+
     return lseek(fd, offset, whence);
 }
 
@@ -19,14 +27,16 @@ off_t mock_lseek(const char *file, const int line, const char *func, int fd, off
 {
     off_t mock_ret;
 
-    if (_mock_unistd != nullptr)
+    CallStatsTimer call_stats("lseek", file, line, func);
+    if (auto locked_unistd = _mock_unistd.lock(Mock_unistd::METHOD_lseek))
     {
-        mock_ret = _mock_unistd->lseek(file, line, func, fd, offset, whence);
+        mock_ret = locked_unistd->lseek(file, line, func, fd, offset, whence);
     }
     else
     {
         mock_ret = delegate_real_lseek(file, line, func, fd, offset, whence);
     }
+    call_stats.finish(mock_ret == -1);
 
     if (getTraceLevel() > TRACE_NONE)
     {
@@ -60,9 +70,9 @@ __int64 mock__lseeki64(const char *file, const int line, const char *func, int f
 {
     __int64 mock_ret;
 
-    if (_mock_unistd != nullptr)
+    if (auto locked_unistd = _mock_unistd.lock(Mock_unistd::METHOD__lseeki64))
     {
-        mock_ret = _mock_unistd->_lseeki64(file, line, func, fd, offset, whence);
+        mock_ret = locked_unistd->_lseeki64(file, line, func, fd, offset, whence);
     }
     else
     {
@@ -1,30 +1,40 @@
 #include <test_com.h>
+#include <faultInjection.h>
+#include <guardedAllocation.h>
+#include <allocationArena.h>
+#include <allocationTracker.h>
 #include <mock_stdlib.h>
 
 using namespace testing;
 
 void *delegate_real_malloc(const char *file, const int line, const char *func, size_t __size)
 {
-    // avoid -Wunused-parameter
-    (void)file;
-    (void)line;
-    (void)func;
-
-    return malloc(__size);
+    // Mock_stdlib の既定の動作も、Mock_stdlib が無い場合と同じくガード ページ付き・AllocationArena から確保する
+    void *allocated = NULL;
+    if (!allocateGuarded(__size, file, line, func, &allocated) && !allocateFromArena(__size, &allocated))
+    {
+        allocated = malloc(__size);
+    }
+    return allocated;
 }
 
 void *mock_malloc(const char *file, const int line, const char *func, size_t __size)
 {
     void *mock_ret = NULL;
 
-    if (_mock_stdlib != nullptr)
+    if (shouldInjectFault(FAULT_MALLOC, __size))
+    {
+        mock_ret = NULL;
+    }
+    else if (auto locked_stdlib = _mock_stdlib.lock(Mock_stdlib::METHOD_malloc))
     {
-        mock_ret = _mock_stdlib->malloc(file, line, func, __size);
+        mock_ret = locked_stdlib->malloc(file, line, func, __size);
     }
     else
     {
         mock_ret = delegate_real_malloc(file, line, func, __size);
     }
+    trackAllocation(mock_ret, __size, file, line, func);
 
     if (getTraceLevel() > TRACE_NONE)
     {
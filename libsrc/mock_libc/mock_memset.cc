@@ -3,6 +3,8 @@
 
 using namespace testing;
 
+testfw::FakeSlot<void *(void *, int, size_t)> _fake_memset;
+
 void *delegate_real_memset(const char *file, const int line, const char *func, void *s, int c, size_t n)
 {
     // avoid -Wunused-parameter
@@ -17,9 +19,13 @@ void *mock_memset(const char *file, const int line, const char *func, void *s, i
 {
     void *mock_ret = NULL;
 
-    if (_mock_string != nullptr)
+    if (auto locked_fake = _fake_memset.lock())
+    {
+        mock_ret = locked_fake->call(file, line, func, s, c, n);
+    }
+    else if (auto locked_string = _mock_string.lock())
     {
-        mock_ret = _mock_string->memset(file, line, func, s, c, n);
+        mock_ret = locked_string->memset(file, line, func, s, c, n);
     }
     else
     {
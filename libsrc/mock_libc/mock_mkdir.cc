@@ -1,6 +1,7 @@
 #ifndef _WIN32
 
     #include <test_com.h>
+    #include <virtualFileSystem.h>
     #include <sys/mock_stat.h>
 
 using namespace testing;
@@ -11,6 +12,12 @@ int delegate_real_mkdir(const char *file, const int line, const char *func, cons
     (void)line;
     (void)func;
 
+    int virtual_ret;
+    if (virtualMkdir(path, mode, &virtual_ret))
+    {
+        return virtual_ret;
+    }
+
     return mkdir(path, mode);
 }
 
@@ -18,9 +25,9 @@ int mock_mkdir(const char *file, const int line, const char *func, const char *p
 {
     int mock_ret;
 
-    if (_mock_sys_stat != nullptr)
+    if (auto locked_sys_stat = _mock_sys_stat.lock())
     {
-        mock_ret = _mock_sys_stat->mkdir(file, line, func, path, mode);
+        mock_ret = locked_sys_stat->mkdir(file, line, func, path, mode);
     }
     else
     {
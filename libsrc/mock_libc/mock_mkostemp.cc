@@ -23,9 +23,9 @@ int mock_mkostemp(const char *file, const int line, const char *func, char *tmpl
 {
     int mock_ret;
 
-    if (_mock_unistd != nullptr)
+    if (auto locked_unistd = _mock_unistd.lock(Mock_unistd::METHOD_mkostemp))
     {
-        mock_ret = _mock_unistd->mkostemp(file, line, func, tmpl, flags);
+        mock_ret = locked_unistd->mkostemp(file, line, func, tmpl, flags);
     }
     else
     {
@@ -19,9 +19,9 @@ int mock_mkstemp(const char *file, const int line, const char *func, char *tmpl)
 {
     int mock_ret;
 
-    if (_mock_unistd != nullptr)
+    if (auto locked_unistd = _mock_unistd.lock(Mock_unistd::METHOD_mkstemp))
     {
-        mock_ret = _mock_unistd->mkstemp(file, line, func, tmpl);
+        mock_ret = locked_unistd->mkstemp(file, line, func, tmpl);
     }
     else
     {
@@ -2,6 +2,7 @@
 
     #include <test_com.h>
     #include <mock_time.h>
+    #include <virtualClock.h>
 
     #include <string.h>
 
@@ -29,6 +30,12 @@ int delegate_real_nanosleep(const char *file, const int line, const char *func,
     (void)line;
     (void)func;
 
+    int virtual_ret;
+    if (virtualNanosleep(req, rem, &virtual_ret))
+    {
+        return virtual_ret;
+    }
+
     return nanosleep(req, rem);
 }
 
@@ -36,9 +43,9 @@ int mock_nanosleep(const char *file, const int line, const char *func, const str
 {
     int mock_ret;
 
-    if (_mock_time != nullptr)
+    if (auto locked_time = _mock_time.lock())
     {
-        mock_ret = _mock_time->nanosleep(file, line, func, req, rem);
+        mock_ret = locked_time->nanosleep(file, line, func, req, rem);
     }
     else
     {
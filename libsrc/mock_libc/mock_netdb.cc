@@ -1,12 +1,13 @@
 #include <mock_instance.h>
 #include <test_com.h>
 #include <mock_netdb.h>
+#include <virtualResolver.h>
 
 #ifndef _WIN32
 
 using namespace testing;
 
-Mock_netdb *_mock_netdb = nullptr;
+testfw::MockSlot<Mock_netdb> _mock_netdb;
 
 Mock_netdb::Mock_netdb()
 {
@@ -29,6 +30,12 @@ int delegate_real_getaddrinfo(const char *file, const int line, const char *func
     (void)line;
     (void)func;
 
+    int virtual_ret;
+    if (virtualGetaddrinfo(node, service, hints, res, &virtual_ret))
+    {
+        return virtual_ret;
+    }
+
     return getaddrinfo(node, service, hints, res);
 }
 
@@ -36,9 +43,9 @@ int mock_getaddrinfo(const char *file, const int line, const char *func, const c
 {
     int mock_ret;
 
-    if (_mock_netdb != nullptr)
+    if (auto locked_netdb = _mock_netdb.lock())
     {
-        mock_ret = _mock_netdb->getaddrinfo(file, line, func, node, service, hints, res);
+        mock_ret = locked_netdb->getaddrinfo(file, line, func, node, service, hints, res);
     }
     else
     {
@@ -68,14 +75,19 @@ void delegate_real_freeaddrinfo(const char *file, const int line, const char *fu
     (void)line;
     (void)func;
 
+    if (virtualFreeaddrinfo(res))
+    {
+        return;
+    }
+
     freeaddrinfo(res);
 }
 
 void mock_freeaddrinfo(const char *file, const int line, const char *func, struct addrinfo *res)
 {
-    if (_mock_netdb != nullptr)
+    if (auto locked_netdb = _mock_netdb.lock())
     {
-        _mock_netdb->freeaddrinfo(file, line, func, res);
+        locked_netdb->freeaddrinfo(file, line, func, res);
     }
     else
     {
@@ -110,9 +122,9 @@ const char *mock_gai_strerror(const char *file, const int line, const char *func
 {
     const char *mock_ret;
 
-    if (_mock_netdb != nullptr)
+    if (auto locked_netdb = _mock_netdb.lock())
     {
-        mock_ret = _mock_netdb->gai_strerror(file, line, func, errcode);
+        mock_ret = locked_netdb->gai_strerror(file, line, func, errcode);
     }
     else
     {
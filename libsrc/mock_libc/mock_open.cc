@@ -1,4 +1,7 @@
 #include <test_com.h>
+#include <virtualFileSystem.h>
+#include <callStats.h>
+#include <faultInjection.h>
 #include <mock_fcntl.h>
 
 #ifndef _WIN32
@@ -11,6 +14,12 @@ int delegate_real_open(const char *file, const int line, const char *func, const
     (void)line;
     (void)func;
 
+    int virtual_ret;
+    if (virtualOpen(path, flags, mode, &virtual_ret))
+    {
+        return virtual_ret;
+    }
+
     return open(path, flags, (mode_t)mode);
 }
 
@@ -18,14 +27,20 @@ int mock_open(const char *file, const int line, const char *func, const char *pa
 {
     int mock_ret;
 
-    if (_mock_fcntl != nullptr)
+    CallStatsTimer call_stats("open", file, line, func);
+    if (shouldInjectFault(FAULT_OPEN, 0, path))
+    {
+        mock_ret = -1;
+    }
+    else if (auto locked_fcntl = _mock_fcntl.lock())
     {
-        mock_ret = _mock_fcntl->open(file, line, func, path, flags, mode);
+        mock_ret = locked_fcntl->open(file, line, func, path, flags, mode);
     }
     else
     {
         mock_ret = delegate_real_open(file, line, func, path, flags, mode);
     }
+    call_stats.finish(mock_ret == -1);
 
     if (getTraceLevel() > TRACE_NONE)
     {
@@ -13,8 +13,8 @@ int delegate_real_pipe(const char *file, const int line, const char *func, int p
 
 int mock_pipe(const char *file, const int line, const char *func, int pipefd[2])
 {
-    return (_mock_unistd != nullptr) ? _mock_unistd->pipe(file, line, func, pipefd)
-                                     : delegate_real_pipe(file, line, func, pipefd);
+    auto locked_unistd = _mock_unistd.lock(Mock_unistd::METHOD_pipe);
+    return locked_unistd ? locked_unistd->pipe(file, line, func, pipefd) : delegate_real_pipe(file, line, func, pipefd);
 }
 
 #endif // _WIN32
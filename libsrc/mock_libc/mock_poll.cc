@@ -1,12 +1,15 @@
 #include <mock_instance.h>
 #include <test_com.h>
+#include <callStats.h>
 #include <mock_poll.h>
+#include <virtualClock.h>
+#include <virtualNetwork.h>
 
 #ifndef _WIN32
 
 using namespace testing;
 
-Mock_poll *_mock_poll = nullptr;
+testfw::MockSlot<Mock_poll> _mock_poll;
 
 Mock_poll::Mock_poll()
 {
@@ -27,6 +30,16 @@ int delegate_real_poll(const char *file, const int line, const char *func, struc
     (void)line;
     (void)func;
 
+    int virtual_ret;
+    if (virtualNetworkPoll(fds, nfds, timeout, &virtual_ret))
+    {
+        return virtual_ret;
+    }
+    if (virtualPoll(fds, nfds, timeout, &virtual_ret))
+    {
+        return virtual_ret;
+    }
+
     return poll(fds, nfds, timeout);
 }
 
@@ -34,14 +47,16 @@ int mock_poll(const char *file, const int line, const char *func, struct pollfd
 {
     int mock_ret;
 
-    if (_mock_poll != nullptr)
+    CallStatsTimer call_stats("poll", file, line, func);
+    if (auto locked_poll = _mock_poll.lock())
     {
-        mock_ret = _mock_poll->poll(file, line, func, fds, nfds, timeout);
+        mock_ret = locked_poll->poll(file, line, func, fds, nfds, timeout);
     }
     else
     {
         mock_ret = delegate_real_poll(file, line, func, fds, nfds, timeout);
     }
+    call_stats.finish(mock_ret == -1);
 
     if (getTraceLevel() > TRACE_NONE)
     {
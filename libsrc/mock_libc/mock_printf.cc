@@ -31,9 +31,9 @@ int mock_printf(const char *file, const int line, const char *func, const char *
     {
         mock_ret = -1;
     }
-    else if (_mock_stdio != nullptr)
+    else if (auto locked_stdio = _mock_stdio.lock(Mock_stdio::METHOD_printf))
     {
-        mock_ret = _mock_stdio->printf(file, line, func, str);
+        mock_ret = locked_stdio->printf(file, line, func, str);
     }
     else
     {
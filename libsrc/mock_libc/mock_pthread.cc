@@ -6,7 +6,7 @@
 
 using namespace testing;
 
-Mock_pthread *_mock_pthread = nullptr;
+testfw::MockSlot<Mock_pthread> _mock_pthread;
 
 Mock_pthread::Mock_pthread()
 {
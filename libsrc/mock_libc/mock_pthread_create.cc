@@ -1,5 +1,6 @@
 #include <test_com.h>
 #include <mock_pthread.h>
+#include <virtualClock.h>
 
 #ifndef _WIN32
 
@@ -13,6 +14,12 @@ int delegate_real_pthread_create(const char *file, const int line, const char *f
     (void)line;
     (void)func;
 
+    int virtual_ret;
+    if (virtualPthreadCreate(thread, attr, start_routine, arg, &virtual_ret))
+    {
+        return virtual_ret;
+    }
+
     return pthread_create(thread, attr, start_routine, arg);
 }
 
@@ -21,9 +28,9 @@ int mock_pthread_create(const char *file, const int line, const char *func, pthr
 {
     int mock_ret;
 
-    if (_mock_pthread != nullptr)
+    if (auto locked_pthread = _mock_pthread.lock())
     {
-        mock_ret = _mock_pthread->pthread_create(file, line, func, thread, attr, start_routine, arg);
+        mock_ret = locked_pthread->pthread_create(file, line, func, thread, attr, start_routine, arg);
     }
     else
     {
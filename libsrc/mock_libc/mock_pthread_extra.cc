@@ -1,5 +1,6 @@
 #include <test_com.h>
 #include <mock_pthread.h>
+#include <virtualClock.h>
 
 #ifndef _WIN32
 
@@ -15,8 +16,9 @@ int delegate_real_pthread_mutex_destroy(const char *file, const int line, const
 
 int mock_pthread_mutex_destroy(const char *file, const int line, const char *func, pthread_mutex_t *mutex)
 {
-    return (_mock_pthread != nullptr) ? _mock_pthread->pthread_mutex_destroy(file, line, func, mutex)
-                                      : delegate_real_pthread_mutex_destroy(file, line, func, mutex);
+    auto locked_pthread = _mock_pthread.lock();
+    return locked_pthread ? locked_pthread->pthread_mutex_destroy(file, line, func, mutex)
+                          : delegate_real_pthread_mutex_destroy(file, line, func, mutex);
 }
 
     #define DEFINE_PTHREAD_MUTEX_OP(name) \
@@ -27,10 +29,16 @@ int mock_pthread_mutex_destroy(const char *file, const int line, const char *fun
             (void)func; \
             return name(mutex); \
         } \
+        testfw::FakeSlot<int(pthread_mutex_t *)> _fake_##name; \
         int mock_##name(const char *file, const int line, const char *func, pthread_mutex_t *mutex) \
         { \
-            return (_mock_pthread != nullptr) ? _mock_pthread->name(file, line, func, mutex) \
-                                              : delegate_real_##name(file, line, func, mutex); \
+            if (auto locked_fake = _fake_##name.lock()) \
+            { \
+                return locked_fake->call(file, line, func, mutex); \
+            } \
+            auto locked_pthread = _mock_pthread.lock(); \
+            return locked_pthread ? locked_pthread->name(file, line, func, mutex) \
+                                  : delegate_real_##name(file, line, func, mutex); \
         }
 
 DEFINE_PTHREAD_MUTEX_OP(pthread_mutex_lock)
@@ -47,8 +55,9 @@ int delegate_real_pthread_condattr_init(const char *file, const int line, const
 
 int mock_pthread_condattr_init(const char *file, const int line, const char *func, pthread_condattr_t *attr)
 {
-    return (_mock_pthread != nullptr) ? _mock_pthread->pthread_condattr_init(file, line, func, attr)
-                                      : delegate_real_pthread_condattr_init(file, line, func, attr);
+    auto locked_pthread = _mock_pthread.lock();
+    return locked_pthread ? locked_pthread->pthread_condattr_init(file, line, func, attr)
+                          : delegate_real_pthread_condattr_init(file, line, func, attr);
 }
 
 int delegate_real_pthread_condattr_setclock(const char *file, const int line, const char *func,
@@ -63,8 +72,9 @@ int delegate_real_pthread_condattr_setclock(const char *file, const int line, co
 int mock_pthread_condattr_setclock(const char *file, const int line, const char *func, pthread_condattr_t *attr,
                                    clockid_t clock_id)
 {
-    return (_mock_pthread != nullptr) ? _mock_pthread->pthread_condattr_setclock(file, line, func, attr, clock_id)
-                                      : delegate_real_pthread_condattr_setclock(file, line, func, attr, clock_id);
+    auto locked_pthread = _mock_pthread.lock();
+    return locked_pthread ? locked_pthread->pthread_condattr_setclock(file, line, func, attr, clock_id)
+                          : delegate_real_pthread_condattr_setclock(file, line, func, attr, clock_id);
 }
 
 int delegate_real_pthread_condattr_destroy(const char *file, const int line, const char *func, pthread_condattr_t *attr)
@@ -77,8 +87,9 @@ int delegate_real_pthread_condattr_destroy(const char *file, const int line, con
 
 int mock_pthread_condattr_destroy(const char *file, const int line, const char *func, pthread_condattr_t *attr)
 {
-    return (_mock_pthread != nullptr) ? _mock_pthread->pthread_condattr_destroy(file, line, func, attr)
-                                      : delegate_real_pthread_condattr_destroy(file, line, func, attr);
+    auto locked_pthread = _mock_pthread.lock();
+    return locked_pthread ? locked_pthread->pthread_condattr_destroy(file, line, func, attr)
+                          : delegate_real_pthread_condattr_destroy(file, line, func, attr);
 }
 
     #define DEFINE_PTHREAD_COND_OP(name, call) \
@@ -91,8 +102,9 @@ int mock_pthread_condattr_destroy(const char *file, const int line, const char *
         } \
         int mock_##name(const char *file, const int line, const char *func, pthread_cond_t *cond) \
         { \
-            return (_mock_pthread != nullptr) ? _mock_pthread->name(file, line, func, cond) \
-                                              : delegate_real_##name(file, line, func, cond); \
+            auto locked_pthread = _mock_pthread.lock(); \
+            return locked_pthread ? locked_pthread->name(file, line, func, cond) \
+                                  : delegate_real_##name(file, line, func, cond); \
         }
 
 DEFINE_PTHREAD_COND_OP(pthread_cond_destroy, pthread_cond_destroy(cond))
@@ -111,8 +123,9 @@ int delegate_real_pthread_cond_init(const char *file, const int line, const char
 int mock_pthread_cond_init(const char *file, const int line, const char *func, pthread_cond_t *cond,
                            const pthread_condattr_t *attr)
 {
-    return (_mock_pthread != nullptr) ? _mock_pthread->pthread_cond_init(file, line, func, cond, attr)
-                                      : delegate_real_pthread_cond_init(file, line, func, cond, attr);
+    auto locked_pthread = _mock_pthread.lock();
+    return locked_pthread ? locked_pthread->pthread_cond_init(file, line, func, cond, attr)
+                          : delegate_real_pthread_cond_init(file, line, func, cond, attr);
 }
 
 int delegate_real_pthread_cond_wait(const char *file, const int line, const char *func, pthread_cond_t *cond,
@@ -121,14 +134,22 @@ int delegate_real_pthread_cond_wait(const char *file, const int line, const char
     (void)file;
     (void)line;
     (void)func;
+
+    int virtual_ret;
+    if (virtualCondWait(cond, mutex, &virtual_ret))
+    {
+        return virtual_ret;
+    }
+
     return pthread_cond_wait(cond, mutex);
 }
 
 int mock_pthread_cond_wait(const char *file, const int line, const char *func, pthread_cond_t *cond,
                            pthread_mutex_t *mutex)
 {
-    return (_mock_pthread != nullptr) ? _mock_pthread->pthread_cond_wait(file, line, func, cond, mutex)
-                                      : delegate_real_pthread_cond_wait(file, line, func, cond, mutex);
+    auto locked_pthread = _mock_pthread.lock();
+    return locked_pthread ? locked_pthread->pthread_cond_wait(file, line, func, cond, mutex)
+                          : delegate_real_pthread_cond_wait(file, line, func, cond, mutex);
 }
 
 int delegate_real_pthread_cond_timedwait(const char *file, const int line, const char *func, pthread_cond_t *cond,
@@ -137,14 +158,22 @@ int delegate_real_pthread_cond_timedwait(const char *file, const int line, const
     (void)file;
     (void)line;
     (void)func;
+
+    int virtual_ret;
+    if (virtualCondTimedwait(cond, mutex, abstime, &virtual_ret))
+    {
+        return virtual_ret;
+    }
+
     return pthread_cond_timedwait(cond, mutex, abstime);
 }
 
 int mock_pthread_cond_timedwait(const char *file, const int line, const char *func, pthread_cond_t *cond,
                                 pthread_mutex_t *mutex, const struct timespec *abstime)
 {
-    return (_mock_pthread != nullptr) ? _mock_pthread->pthread_cond_timedwait(file, line, func, cond, mutex, abstime)
-                                      : delegate_real_pthread_cond_timedwait(file, line, func, cond, mutex, abstime);
+    auto locked_pthread = _mock_pthread.lock();
+    return locked_pthread ? locked_pthread->pthread_cond_timedwait(file, line, func, cond, mutex, abstime)
+                          : delegate_real_pthread_cond_timedwait(file, line, func, cond, mutex, abstime);
 }
 
     #define DEFINE_PTHREAD_THREAD_OP(name, call) \
@@ -157,11 +186,33 @@ int mock_pthread_cond_timedwait(const char *file, const int line, const char *fu
         } \
         int mock_##name(const char *file, const int line, const char *func, pthread_t thread, void **value) \
         { \
-            return (_mock_pthread != nullptr) ? _mock_pthread->name(file, line, func, thread, value) \
-                                              : delegate_real_##name(file, line, func, thread, value); \
+            auto locked_pthread = _mock_pthread.lock(); \
+            return locked_pthread ? locked_pthread->name(file, line, func, thread, value) \
+                                  : delegate_real_##name(file, line, func, thread, value); \
         }
 
-DEFINE_PTHREAD_THREAD_OP(pthread_join, pthread_join(thread, value))
+int delegate_real_pthread_join(const char *file, const int line, const char *func, pthread_t thread, void **value)
+{
+    (void)file;
+    (void)line;
+    (void)func;
+
+    int virtual_ret;
+    if (virtualPthreadJoin(thread, value, &virtual_ret))
+    {
+        return virtual_ret;
+    }
+
+    return pthread_join(thread, value);
+}
+
+int mock_pthread_join(const char *file, const int line, const char *func, pthread_t thread, void **value)
+{
+    auto locked_pthread = _mock_pthread.lock();
+    return locked_pthread ? locked_pthread->pthread_join(file, line, func, thread, value)
+                          : delegate_real_pthread_join(file, line, func, thread, value);
+}
+
 DEFINE_PTHREAD_THREAD_OP(pthread_tryjoin_np, pthread_tryjoin_np(thread, value))
 
 int delegate_real_pthread_detach(const char *file, const int line, const char *func, pthread_t thread)
@@ -174,8 +225,9 @@ int delegate_real_pthread_detach(const char *file, const int line, const char *f
 
 int mock_pthread_detach(const char *file, const int line, const char *func, pthread_t thread)
 {
-    return (_mock_pthread != nullptr) ? _mock_pthread->pthread_detach(file, line, func, thread)
-                                      : delegate_real_pthread_detach(file, line, func, thread);
+    auto locked_pthread = _mock_pthread.lock();
+    return locked_pthread ? locked_pthread->pthread_detach(file, line, func, thread)
+                          : delegate_real_pthread_detach(file, line, func, thread);
 }
 
 int delegate_real_pthread_getattr_np(const char *file, const int line, const char *func, pthread_t thread,
@@ -189,8 +241,9 @@ int delegate_real_pthread_getattr_np(const char *file, const int line, const cha
 
 int mock_pthread_getattr_np(const char *file, const int line, const char *func, pthread_t thread, pthread_attr_t *attr)
 {
-    return (_mock_pthread != nullptr) ? _mock_pthread->pthread_getattr_np(file, line, func, thread, attr)
-                                      : delegate_real_pthread_getattr_np(file, line, func, thread, attr);
+    auto locked_pthread = _mock_pthread.lock();
+    return locked_pthread ? locked_pthread->pthread_getattr_np(file, line, func, thread, attr)
+                          : delegate_real_pthread_getattr_np(file, line, func, thread, attr);
 }
 
 int delegate_real_pthread_attr_getstack(const char *file, const int line, const char *func, const pthread_attr_t *attr,
@@ -205,9 +258,9 @@ int delegate_real_pthread_attr_getstack(const char *file, const int line, const
 int mock_pthread_attr_getstack(const char *file, const int line, const char *func, const pthread_attr_t *attr,
                                void **stackaddr, size_t *stacksize)
 {
-    return (_mock_pthread != nullptr)
-               ? _mock_pthread->pthread_attr_getstack(file, line, func, attr, stackaddr, stacksize)
-               : delegate_real_pthread_attr_getstack(file, line, func, attr, stackaddr, stacksize);
+    auto locked_pthread = _mock_pthread.lock();
+    return locked_pthread ? locked_pthread->pthread_attr_getstack(file, line, func, attr, stackaddr, stacksize)
+                          : delegate_real_pthread_attr_getstack(file, line, func, attr, stackaddr, stacksize);
 }
 
 int delegate_real_pthread_attr_destroy(const char *file, const int line, const char *func, pthread_attr_t *attr)
@@ -220,8 +273,9 @@ int delegate_real_pthread_attr_destroy(const char *file, const int line, const c
 
 int mock_pthread_attr_destroy(const char *file, const int line, const char *func, pthread_attr_t *attr)
 {
-    return (_mock_pthread != nullptr) ? _mock_pthread->pthread_attr_destroy(file, line, func, attr)
-                                      : delegate_real_pthread_attr_destroy(file, line, func, attr);
+    auto locked_pthread = _mock_pthread.lock();
+    return locked_pthread ? locked_pthread->pthread_attr_destroy(file, line, func, attr)
+                          : delegate_real_pthread_attr_destroy(file, line, func, attr);
 }
 
 pthread_t delegate_real_pthread_self(const char *file, const int line, const char *func)
@@ -234,8 +288,9 @@ pthread_t delegate_real_pthread_self(const char *file, const int line, const cha
 
 pthread_t mock_pthread_self(const char *file, const int line, const char *func)
 {
-    return (_mock_pthread != nullptr) ? _mock_pthread->pthread_self(file, line, func)
-                                      : delegate_real_pthread_self(file, line, func);
+    auto locked_pthread = _mock_pthread.lock();
+    return locked_pthread ? locked_pthread->pthread_self(file, line, func)
+                          : delegate_real_pthread_self(file, line, func);
 }
 
     #undef DEFINE_PTHREAD_MUTEX_OP
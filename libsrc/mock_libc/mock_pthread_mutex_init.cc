@@ -21,9 +21,9 @@ int mock_pthread_mutex_init(const char *file, const int line, const char *func,
 {
     int mock_ret;
 
-    if (_mock_pthread != nullptr)
+    if (auto locked_pthread = _mock_pthread.lock())
     {
-        mock_ret = _mock_pthread->pthread_mutex_init(file, line, func, mutex, attr);
+        mock_ret = locked_pthread->pthread_mutex_init(file, line, func, mutex, attr);
     }
     else
     {
@@ -1,10 +1,16 @@
 #include <test_com.h>
+#include <virtualFileSystem.h>
+#include <virtualNetwork.h>
+#include <callStats.h>
+#include <faultInjection.h>
 #include <mock_unistd.h>
 
 using namespace testing;
 
 #ifndef _WIN32
 
+testfw::FakeSlot<ssize_t(int, void *, size_t)> _fake_read;
+
 ssize_t delegate_real_read(const char *file, const int line, const char *func, int fd, void *buf, size_t count)
 {
     // avoid -Wunused-parameter
@@ -12,6 +18,16 @@ ssize_t delegate_real_read(const char *file, const int line, const char *func, i
     (void)line;
     (void)func;
 
+    ssize_t virtual_ret;
+    if (virtualRead(fd, buf, count, &virtual_ret))
+    {
+        return virtual_ret;
+    }
+    if (virtualNetworkRead(fd, buf, count, &virtual_ret))
+    {
+        return virtual_ret;
+    }
+
     return read(fd, buf, count);
 }
 
@@ -19,14 +35,24 @@ ssize_t mock_read(const char *file, const int line, const char *func, int fd, vo
 {
     ssize_t mock_ret;
 
-    if (_mock_unistd != nullptr)
+    CallStatsTimer call_stats("read", file, line, func);
+    if (shouldInjectFault(FAULT_READ, count))
+    {
+        mock_ret = -1;
+    }
+    else if (auto locked_fake = _fake_read.lock())
+    {
+        mock_ret = locked_fake->call(file, line, func, fd, buf, count);
+    }
+    else if (auto locked_unistd = _mock_unistd.lock(Mock_unistd::METHOD_read))
     {
-        mock_ret = _mock_unistd->read(file, line, func, fd, buf, count);
+        mock_ret = locked_unistd->read(file, line, func, fd, buf, count);
     }
     else
     {
         mock_ret = delegate_real_read(file, line, func, fd, buf, count);
     }
+    call_stats.finish(mock_ret == -1);
 
     if (getTraceLevel() > TRACE_NONE)
     {
@@ -60,9 +86,9 @@ int mock__read(const char *file, const int line, const char *func, int fd, void
 {
     int mock_ret;
 
-    if (_mock_unistd != nullptr)
+    if (auto locked_unistd = _mock_unistd.lock(Mock_unistd::METHOD__read))
     {
-        mock_ret = _mock_unistd->_read(file, line, func, fd, buf, count);
+        mock_ret = locked_unistd->_read(file, line, func, fd, buf, count);
     }
     else
     {
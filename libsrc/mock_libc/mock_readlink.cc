@@ -14,8 +14,9 @@ ssize_t delegate_real_readlink(const char *file, const int line, const char *fun
 
 ssize_t mock_readlink(const char *file, const int line, const char *func, const char *path, char *buf, size_t size)
 {
-    return (_mock_unistd != nullptr) ? _mock_unistd->readlink(file, line, func, path, buf, size)
-                                     : delegate_real_readlink(file, line, func, path, buf, size);
+    auto locked_unistd = _mock_unistd.lock(Mock_unistd::METHOD_readlink);
+    return locked_unistd ? locked_unistd->readlink(file, line, func, path, buf, size)
+                         : delegate_real_readlink(file, line, func, path, buf, size);
 }
 
 #endif // _WIN32
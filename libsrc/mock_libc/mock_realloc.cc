@@ -1,30 +1,42 @@
 #include <test_com.h>
+#include <faultInjection.h>
+#include <guardedAllocation.h>
+#include <allocationArena.h>
+#include <allocationTracker.h>
 #include <mock_stdlib.h>
 
 using namespace testing;
 
 void *delegate_real_realloc(const char *file, const int line, const char *func, void *__ptr, size_t __size)
 {
-    // avoid -Wunused-parameter
-    (void)file;
-    (void)line;
-    (void)func;
-
-    return realloc(__ptr, __size);
+    // Mock_stdlib の既定の動作からも呼び出されるため、ガード ページ付き・AllocationArena の領域はアドレスで判定して戻す
+    void *resized = NULL;
+    if (!reallocateGuarded(__ptr, __size, file, line, func, &resized) &&
+        !reallocateFromArena(__ptr, __size, &resized))
+    {
+        resized = realloc(__ptr, __size);
+    }
+    return resized;
 }
 
 void *mock_realloc(const char *file, const int line, const char *func, void *__ptr, size_t __size)
 {
     void *mock_ret = NULL;
 
-    if (_mock_stdlib != nullptr)
+    const TrackedReallocation previous = beginTrackReallocation(__ptr);
+    if (shouldInjectFault(FAULT_REALLOC, __size))
+    {
+        mock_ret = NULL;
+    }
+    else if (auto locked_stdlib = _mock_stdlib.lock(Mock_stdlib::METHOD_realloc))
     {
-        mock_ret = _mock_stdlib->realloc(file, line, func, __ptr, __size);
+        mock_ret = locked_stdlib->realloc(file, line, func, __ptr, __size);
     }
     else
     {
         mock_ret = delegate_real_realloc(file, line, func, __ptr, __size);
     }
+    endTrackReallocation(previous, mock_ret, __size, file, line, func);
 
     if (getTraceLevel() > TRACE_NONE)
     {
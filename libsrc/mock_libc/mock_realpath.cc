@@ -19,9 +19,9 @@ char *mock_realpath(const char *file, const int line, const char *func, const ch
 {
     char *mock_ret;
 
-    if (_mock_stdlib != nullptr)
+    if (auto locked_stdlib = _mock_stdlib.lock(Mock_stdlib::METHOD_realpath))
     {
-        mock_ret = _mock_stdlib->realpath(file, line, func, path, resolved);
+        mock_ret = locked_stdlib->realpath(file, line, func, path, resolved);
     }
     else
     {
@@ -1,4 +1,5 @@
 #include <test_com.h>
+#include <virtualFileSystem.h>
 #include <mock_stdio.h>
 
 using namespace testing;
@@ -19,6 +20,14 @@ int delegate_real_remove(const char *file, const int line, const char *func, con
     (void)line;
     (void)func;
 
+#ifndef _WIN32
+    int virtual_ret;
+    if (virtualRemove(path, &virtual_ret))
+    {
+        return virtual_ret;
+    }
+#endif
+
     return ::remove(path);
 }
 
@@ -26,9 +35,9 @@ int mock_remove(const char *file, const int line, const char *func, const char *
 {
     int mock_ret;
 
-    if (_mock_stdio != nullptr)
+    if (auto locked_stdio = _mock_stdio.lock(Mock_stdio::METHOD_remove))
     {
-        mock_ret = _mock_stdio->remove(file, line, func, path);
+        mock_ret = locked_stdio->remove(file, line, func, path);
     }
     else
     {
@@ -1,4 +1,5 @@
 #include <test_com.h>
+#include <virtualFileSystem.h>
 #include <mock_stdio.h>
 
 using namespace testing;
@@ -20,6 +21,14 @@ int delegate_real_rename(const char *file, const int line, const char *func, con
     (void)line;
     (void)func;
 
+#ifndef _WIN32
+    int virtual_ret;
+    if (virtualRename(oldpath, newpath, &virtual_ret))
+    {
+        return virtual_ret;
+    }
+#endif
+
     return ::rename(oldpath, newpath);
 }
 
@@ -27,9 +36,9 @@ int mock_rename(const char *file, const int line, const char *func, const char *
 {
     int mock_ret;
 
-    if (_mock_stdio != nullptr)
+    if (auto locked_stdio = _mock_stdio.lock(Mock_stdio::METHOD_rename))
     {
-        mock_ret = _mock_stdio->rename(file, line, func, oldpath, newpath);
+        mock_ret = locked_stdio->rename(file, line, func, oldpath, newpath);
     }
     else
     {
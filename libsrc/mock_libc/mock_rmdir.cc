@@ -1,6 +1,7 @@
 #ifndef _WIN32
 
     #include <test_com.h>
+    #include <virtualFileSystem.h>
     #include <mock_unistd.h>
 
 using namespace testing;
@@ -11,6 +12,12 @@ int delegate_real_rmdir(const char *file, const int line, const char *func, cons
     (void)line;
     (void)func;
 
+    int virtual_ret;
+    if (virtualRmdir(path, &virtual_ret))
+    {
+        return virtual_ret;
+    }
+
     return rmdir(path);
 }
 
@@ -18,9 +25,9 @@ int mock_rmdir(const char *file, const int line, const char *func, const char *p
 {
     int mock_ret;
 
-    if (_mock_unistd != nullptr)
+    if (auto locked_unistd = _mock_unistd.lock(Mock_unistd::METHOD_rmdir))
     {
-        mock_ret = _mock_unistd->rmdir(file, line, func, path);
+        mock_ret = locked_unistd->rmdir(file, line, func, path);
     }
     else
     {
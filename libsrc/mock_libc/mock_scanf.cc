@@ -23,9 +23,9 @@ int mock_scanf(const char *file, const int line, const char *func, const char *f
     // 可変引数リストを初期化
     va_start(args, fmt);
 
-    if (_mock_stdio != nullptr)
+    if (auto locked_stdio = _mock_stdio.lock(Mock_stdio::METHOD_scanf))
     {
-        mock_ret = _mock_stdio->scanf(file, line, func, fmt, args);
+        mock_ret = locked_stdio->scanf(file, line, func, fmt, args);
     }
     else
     {
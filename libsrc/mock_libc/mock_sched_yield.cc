@@ -13,8 +13,8 @@ int delegate_real_sched_yield(const char *file, const int line, const char *func
 
 int mock_sched_yield(const char *file, const int line, const char *func)
 {
-    return (_mock_unistd != nullptr) ? _mock_unistd->sched_yield(file, line, func)
-                                     : delegate_real_sched_yield(file, line, func);
+    auto locked_unistd = _mock_unistd.lock(Mock_unistd::METHOD_sched_yield);
+    return locked_unistd ? locked_unistd->sched_yield(file, line, func) : delegate_real_sched_yield(file, line, func);
 }
 
 #endif // _WIN32
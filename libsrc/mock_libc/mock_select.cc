@@ -1,5 +1,7 @@
 #include <test_com.h>
 #include <sys/mock_select.h>
+#include <virtualClock.h>
+#include <virtualNetwork.h>
 
 #ifndef _WIN32
 
@@ -13,6 +15,16 @@ int delegate_real_select(const char *file, const int line, const char *func, int
     (void)line;
     (void)func;
 
+    int virtual_ret;
+    if (virtualNetworkSelect(nfds, readfds, writefds, exceptfds, timeout, &virtual_ret))
+    {
+        return virtual_ret;
+    }
+    if (virtualSelect(nfds, readfds, writefds, exceptfds, timeout, &virtual_ret))
+    {
+        return virtual_ret;
+    }
+
     return select(nfds, readfds, writefds, exceptfds, timeout);
 }
 
@@ -21,9 +33,9 @@ int mock_select(const char *file, const int line, const char *func, int nfds, fd
 {
     int mock_ret;
 
-    if (_mock_sys_select != nullptr)
+    if (auto locked_sys_select = _mock_sys_select.lock())
     {
-        mock_ret = _mock_sys_select->select(file, line, func, nfds, readfds, writefds, exceptfds, timeout);
+        mock_ret = locked_sys_select->select(file, line, func, nfds, readfds, writefds, exceptfds, timeout);
     }
     else
     {
@@ -20,9 +20,9 @@ int mock_setenv(const char *file, const int line, const char *func, const char *
 {
     int mock_ret;
 
-    if (_mock_stdlib != nullptr)
+    if (auto locked_stdlib = _mock_stdlib.lock(Mock_stdlib::METHOD_setenv))
     {
-        mock_ret = _mock_stdlib->setenv(file, line, func, name, value, overwrite);
+        mock_ret = locked_stdlib->setenv(file, line, func, name, value, overwrite);
     }
     else
     {
@@ -6,7 +6,7 @@
 
 using namespace testing;
 
-Mock_signal *_mock_signal = nullptr;
+testfw::MockSlot<Mock_signal> _mock_signal;
 
 Mock_signal::Mock_signal()
 {
@@ -34,8 +34,9 @@ int delegate_real_sigaction(const char *file, const int line, const char *func,
 int mock_sigaction(const char *file, const int line, const char *func, int signum, const struct sigaction *act,
                    struct sigaction *oldact)
 {
-    int mock_ret = (_mock_signal != nullptr) ? _mock_signal->sigaction(file, line, func, signum, act, oldact)
-                                           : delegate_real_sigaction(file, line, func, signum, act, oldact);
+    auto locked_signal = _mock_signal.lock();
+    int mock_ret = locked_signal ? locked_signal->sigaction(file, line, func, signum, act, oldact)
+                                 : delegate_real_sigaction(file, line, func, signum, act, oldact);
     return mock_ret;
 }
 
@@ -49,8 +50,9 @@ int delegate_real_sigemptyset(const char *file, const int line, const char *func
 
 int mock_sigemptyset(const char *file, const int line, const char *func, sigset_t *set)
 {
-    return (_mock_signal != nullptr) ? _mock_signal->sigemptyset(file, line, func, set)
-                                     : delegate_real_sigemptyset(file, line, func, set);
+    auto locked_signal = _mock_signal.lock();
+    return locked_signal ? locked_signal->sigemptyset(file, line, func, set)
+                         : delegate_real_sigemptyset(file, line, func, set);
 }
 
 void (*delegate_real_signal(const char *file, const int line, const char *func, int signum, void (*handler)(int)))(int)
@@ -63,8 +65,9 @@ void (*delegate_real_signal(const char *file, const int line, const char *func,
 
 void (*mock_signal(const char *file, const int line, const char *func, int signum, void (*handler)(int)))(int)
 {
-    return (_mock_signal != nullptr) ? _mock_signal->signal(file, line, func, signum, handler)
-                                     : delegate_real_signal(file, line, func, signum, handler);
+    auto locked_signal = _mock_signal.lock();
+    return locked_signal ? locked_signal->signal(file, line, func, signum, handler)
+                         : delegate_real_signal(file, line, func, signum, handler);
 }
 
 int delegate_real_raise(const char *file, const int line, const char *func, int signum)
@@ -77,8 +80,9 @@ int delegate_real_raise(const char *file, const int line, const char *func, int
 
 int mock_raise(const char *file, const int line, const char *func, int signum)
 {
-    return (_mock_signal != nullptr) ? _mock_signal->raise(file, line, func, signum)
-                                     : delegate_real_raise(file, line, func, signum);
+    auto locked_signal = _mock_signal.lock();
+    return locked_signal ? locked_signal->raise(file, line, func, signum)
+                         : delegate_real_raise(file, line, func, signum);
 }
 
 #endif // _WIN32
@@ -33,9 +33,9 @@ int mock_snprintf(const char *file, const int line, const char *func, char *s, c
     {
         mock_ret = -1;
     }
-    else if (_mock_stdio != nullptr)
+    else if (auto locked_stdio = _mock_stdio.lock(Mock_stdio::METHOD_snprintf))
     {
-        mock_ret = _mock_stdio->snprintf(file, line, func, s, n, str);
+        mock_ret = locked_stdio->snprintf(file, line, func, s, n, str);
     }
     else
     {
@@ -1,4 +1,5 @@
 #include <test_com.h>
+#include <virtualFileSystem.h>
 #include <sys/mock_stat.h>
 
 using namespace testing;
@@ -10,6 +11,14 @@ int delegate_real_stat(const char *file, const int line, const char *func, const
     (void)line;
     (void)func;
 
+#ifndef _WIN32
+    int virtual_ret;
+    if (virtualStat(path, buf, &virtual_ret))
+    {
+        return virtual_ret;
+    }
+#endif
+
     return stat(path, buf);
 }
 
@@ -17,9 +26,9 @@ int mock_stat(const char *file, const int line, const char *func, const char *pa
 {
     int mock_ret;
 
-    if (_mock_sys_stat != nullptr)
+    if (auto locked_sys_stat = _mock_sys_stat.lock())
     {
-        mock_ret = _mock_sys_stat->stat(file, line, func, path, buf);
+        mock_ret = locked_sys_stat->stat(file, line, func, path, buf);
     }
     else
     {
@@ -57,9 +66,9 @@ int mock_stat64(const char *file, const int line, const char *func, const char *
 {
     int mock_ret;
 
-    if (_mock_sys_stat != nullptr)
+    if (auto locked_sys_stat = _mock_sys_stat.lock())
     {
-        mock_ret = _mock_sys_stat->stat64(file, line, func, path, buf);
+        mock_ret = locked_sys_stat->stat64(file, line, func, path, buf);
     }
     else
     {
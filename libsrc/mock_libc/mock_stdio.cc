@@ -3,7 +3,7 @@
 
 using namespace testing;
 
-Mock_stdio *_mock_stdio = nullptr;
+testfw::MockSlot<Mock_stdio> _mock_stdio;
 
 Mock_stdio::Mock_stdio()
 {
@@ -123,6 +123,11 @@ void Mock_stdio::switch_to_real_fileio()
 #endif
 }
 
+void Mock_stdio::bypass_unconfigured_methods()
+{
+    _mock_stdio.bypassUnconfigured(this);
+}
+
 Mock_stdio::~Mock_stdio()
 {
     TESTFW_UNREGISTER_MOCK_INSTANCE(_mock_stdio);
@@ -3,13 +3,14 @@
 
 using namespace testing;
 
-Mock_stdlib *_mock_stdlib = nullptr;
+testfw::MockSlot<Mock_stdlib> _mock_stdlib;
 
 Mock_stdlib::Mock_stdlib()
 {
     ON_CALL(*this, malloc(_, _, _, _)).WillByDefault(Invoke(delegate_real_malloc));
     ON_CALL(*this, realloc(_, _, _, _, _)).WillByDefault(Invoke(delegate_real_realloc));
     ON_CALL(*this, calloc(_, _, _, _, _)).WillByDefault(Invoke(delegate_real_calloc));
+    ON_CALL(*this, free(_, _, _, _)).WillByDefault(Invoke(delegate_real_free));
     ON_CALL(*this, getenv(_, _, _, _)).WillByDefault(Invoke(delegate_real_getenv));
     ON_CALL(*this, atexit(_, _, _, _)).WillByDefault(Invoke(delegate_real_atexit));
 #ifndef _WIN32
@@ -23,6 +24,11 @@ Mock_stdlib::Mock_stdlib()
     TESTFW_REGISTER_MOCK_INSTANCE(_mock_stdlib);
 }
 
+void Mock_stdlib::bypass_unconfigured_methods()
+{
+    _mock_stdlib.bypassUnconfigured(this);
+}
+
 Mock_stdlib::~Mock_stdlib()
 {
     TESTFW_UNREGISTER_MOCK_INSTANCE(_mock_stdlib);
@@ -1,4 +1,5 @@
 #include <test_com.h>
+#include <allocationTracker.h>
 #include <mock_string.h>
 
 #ifndef _WIN32
@@ -19,14 +20,18 @@ char *mock_strdup(const char *file, const int line, const char *func, const char
 {
     char *mock_ret = NULL;
 
-    if (_mock_string != nullptr)
+    if (auto locked_string = _mock_string.lock())
     {
-        mock_ret = _mock_string->strdup(file, line, func, s);
+        mock_ret = locked_string->strdup(file, line, func, s);
     }
     else
     {
         mock_ret = delegate_real_strdup(file, line, func, s);
     }
+    if (mock_ret != NULL)
+    {
+        trackAllocation(mock_ret, strlen(mock_ret) + 1U, file, line, func);
+    }
 
     if (getTraceLevel() > TRACE_NONE)
     {
@@ -60,9 +60,9 @@ int mock_strerror_r(const char *file, const int line, const char *func, int errn
 {
     int mock_ret;
 
-    if (_mock_string != nullptr)
+    if (auto locked_string = _mock_string.lock())
     {
-        mock_ret = _mock_string->strerror_r(file, line, func, errnum, buf, buflen);
+        mock_ret = locked_string->strerror_r(file, line, func, errnum, buf, buflen);
     }
     else
     {
@@ -3,7 +3,7 @@
 
 using namespace testing;
 
-Mock_string *_mock_string = nullptr;
+testfw::MockSlot<Mock_string> _mock_string;
 
 Mock_string::Mock_string()
 {
@@ -6,7 +6,7 @@
 
 using namespace testing;
 
-Mock_sys_file *_mock_sys_file = nullptr;
+testfw::MockSlot<Mock_sys_file> _mock_sys_file;
 
 Mock_sys_file::Mock_sys_file()
 {
@@ -1,12 +1,13 @@
 #include <mock_instance.h>
 #include <test_com.h>
+#include <virtualFileSystem.h>
 #include <sys/mock_mman.h>
 
 #ifndef _WIN32
 
 using namespace testing;
 
-Mock_sys_mman *_mock_sys_mman = nullptr;
+testfw::MockSlot<Mock_sys_mman> _mock_sys_mman;
 
 Mock_sys_mman::Mock_sys_mman()
 {
@@ -34,6 +35,12 @@ void *delegate_real_mmap(const char *file, const int line, const char *func, voi
     (void)line;
     (void)func;
 
+    void *virtual_ret;
+    if (virtualMmap(addr, length, prot, flags, fd, offset, &virtual_ret))
+    {
+        return virtual_ret;
+    }
+
     return mmap(addr, length, prot, flags, fd, offset);
 }
 
@@ -42,9 +49,9 @@ void *mock_mmap(const char *file, const int line, const char *func, void *addr,
 {
     void *mock_ret;
 
-    if (_mock_sys_mman != nullptr)
+    if (auto locked_sys_mman = _mock_sys_mman.lock())
     {
-        mock_ret = _mock_sys_mman->mmap(file, line, func, addr, length, prot, flags, fd, offset);
+        mock_ret = locked_sys_mman->mmap(file, line, func, addr, length, prot, flags, fd, offset);
     }
     else
     {
@@ -73,6 +80,12 @@ int delegate_real_munmap(const char *file, const int line, const char *func, voi
     (void)line;
     (void)func;
 
+    int virtual_ret;
+    if (virtualMunmap(addr, length, &virtual_ret))
+    {
+        return virtual_ret;
+    }
+
     return munmap(addr, length);
 }
 
@@ -80,9 +93,9 @@ int mock_munmap(const char *file, const int line, const char *func, void *addr,
 {
     int mock_ret;
 
-    if (_mock_sys_mman != nullptr)
+    if (auto locked_sys_mman = _mock_sys_mman.lock())
     {
-        mock_ret = _mock_sys_mman->munmap(file, line, func, addr, length);
+        mock_ret = locked_sys_mman->munmap(file, line, func, addr, length);
     }
     else
     {
@@ -111,6 +124,12 @@ int delegate_real_msync(const char *file, const int line, const char *func, void
     (void)line;
     (void)func;
 
+    int virtual_ret;
+    if (virtualMsync(addr, length, flags, &virtual_ret))
+    {
+        return virtual_ret;
+    }
+
     return msync(addr, length, flags);
 }
 
@@ -118,9 +137,9 @@ int mock_msync(const char *file, const int line, const char *func, void *addr, s
 {
     int mock_ret;
 
-    if (_mock_sys_mman != nullptr)
+    if (auto locked_sys_mman = _mock_sys_mman.lock())
     {
-        mock_ret = _mock_sys_mman->msync(file, line, func, addr, length, flags);
+        mock_ret = locked_sys_mman->msync(file, line, func, addr, length, flags);
     }
     else
     {
@@ -153,9 +172,9 @@ int delegate_real_mlock(const char *file, const int line, const char *func, cons
 
 int mock_mlock(const char *file, const int line, const char *func, const void *addr, size_t length)
 {
-    if (_mock_sys_mman != nullptr)
+    if (auto locked_sys_mman = _mock_sys_mman.lock())
     {
-        return _mock_sys_mman->mlock(file, line, func, addr, length);
+        return locked_sys_mman->mlock(file, line, func, addr, length);
     }
     return delegate_real_mlock(file, line, func, addr, length);
 }
@@ -170,9 +189,9 @@ int delegate_real_munlock(const char *file, const int line, const char *func, co
 
 int mock_munlock(const char *file, const int line, const char *func, const void *addr, size_t length)
 {
-    if (_mock_sys_mman != nullptr)
+    if (auto locked_sys_mman = _mock_sys_mman.lock())
     {
-        return _mock_sys_mman->munlock(file, line, func, addr, length);
+        return locked_sys_mman->munlock(file, line, func, addr, length);
     }
     return delegate_real_munlock(file, line, func, addr, length);
 }
@@ -187,9 +206,9 @@ int delegate_real_mlockall(const char *file, const int line, const char *func, i
 
 int mock_mlockall(const char *file, const int line, const char *func, int flags)
 {
-    if (_mock_sys_mman != nullptr)
+    if (auto locked_sys_mman = _mock_sys_mman.lock())
     {
-        return _mock_sys_mman->mlockall(file, line, func, flags);
+        return locked_sys_mman->mlockall(file, line, func, flags);
     }
     return delegate_real_mlockall(file, line, func, flags);
 }
@@ -204,9 +223,9 @@ int delegate_real_munlockall(const char *file, const int line, const char *func)
 
 int mock_munlockall(const char *file, const int line, const char *func)
 {
-    if (_mock_sys_mman != nullptr)
+    if (auto locked_sys_mman = _mock_sys_mman.lock())
     {
-        return _mock_sys_mman->munlockall(file, line, func);
+        return locked_sys_mman->munlockall(file, line, func);
     }
     return delegate_real_munlockall(file, line, func);
 }
@@ -6,7 +6,7 @@
 
 using namespace testing;
 
-Mock_sys_select *_mock_sys_select = nullptr;
+testfw::MockSlot<Mock_sys_select> _mock_sys_select;
 
 Mock_sys_select::Mock_sys_select()
 {
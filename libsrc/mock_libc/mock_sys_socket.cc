@@ -1,12 +1,14 @@
 #include <mock_instance.h>
 #include <test_com.h>
 #include <sys/mock_socket.h>
+#include <networkImpairment.h>
+#include <virtualNetwork.h>
 
 #ifndef _WIN32
 
 using namespace testing;
 
-Mock_sys_socket *_mock_sys_socket = nullptr;
+testfw::MockSlot<Mock_sys_socket> _mock_sys_socket;
 
 Mock_sys_socket::Mock_sys_socket()
 {
@@ -56,6 +58,12 @@ int delegate_real_socket(const char *file, const int line, const char *func, int
     (void)line;
     (void)func;
 
+    int virtual_ret;
+    if (virtualNetworkSocket(domain, type, protocol, &virtual_ret))
+    {
+        return virtual_ret;
+    }
+
     return socket(domain, type, protocol);
 }
 
@@ -63,9 +71,9 @@ int mock_socket(const char *file, const int line, const char *func, int domain,
 {
     int mock_ret;
 
-    if (_mock_sys_socket != nullptr)
+    if (auto locked_sys_socket = _mock_sys_socket.lock())
     {
-        mock_ret = _mock_sys_socket->socket(file, line, func, domain, type, protocol);
+        mock_ret = locked_sys_socket->socket(file, line, func, domain, type, protocol);
     }
     else
     {
@@ -84,6 +92,12 @@ int delegate_real_bind(const char *file, const int line, const char *func, int s
     (void)line;
     (void)func;
 
+    int virtual_ret;
+    if (virtualNetworkBind(sockfd, addr, addrlen, &virtual_ret))
+    {
+        return virtual_ret;
+    }
+
     return bind(sockfd, addr, addrlen);
 }
 
@@ -91,9 +105,9 @@ int mock_bind(const char *file, const int line, const char *func, int sockfd, co
 {
     int mock_ret;
 
-    if (_mock_sys_socket != nullptr)
+    if (auto locked_sys_socket = _mock_sys_socket.lock())
     {
-        mock_ret = _mock_sys_socket->bind(file, line, func, sockfd, addr, addrlen);
+        mock_ret = locked_sys_socket->bind(file, line, func, sockfd, addr, addrlen);
     }
     else
     {
@@ -112,6 +126,12 @@ int delegate_real_listen(const char *file, const int line, const char *func, int
     (void)line;
     (void)func;
 
+    int virtual_ret;
+    if (virtualNetworkListen(sockfd, backlog, &virtual_ret))
+    {
+        return virtual_ret;
+    }
+
     return listen(sockfd, backlog);
 }
 
@@ -119,9 +139,9 @@ int mock_listen(const char *file, const int line, const char *func, int sockfd,
 {
     int mock_ret;
 
-    if (_mock_sys_socket != nullptr)
+    if (auto locked_sys_socket = _mock_sys_socket.lock())
     {
-        mock_ret = _mock_sys_socket->listen(file, line, func, sockfd, backlog);
+        mock_ret = locked_sys_socket->listen(file, line, func, sockfd, backlog);
     }
     else
     {
@@ -140,6 +160,12 @@ int delegate_real_accept(const char *file, const int line, const char *func, int
     (void)line;
     (void)func;
 
+    int virtual_ret;
+    if (virtualNetworkAccept(sockfd, addr, addrlen, &virtual_ret))
+    {
+        return virtual_ret;
+    }
+
     return accept(sockfd, addr, addrlen);
 }
 
@@ -147,9 +173,9 @@ int mock_accept(const char *file, const int line, const char *func, int sockfd,
 {
     int mock_ret;
 
-    if (_mock_sys_socket != nullptr)
+    if (auto locked_sys_socket = _mock_sys_socket.lock())
     {
-        mock_ret = _mock_sys_socket->accept(file, line, func, sockfd, addr, addrlen);
+        mock_ret = locked_sys_socket->accept(file, line, func, sockfd, addr, addrlen);
     }
     else
     {
@@ -168,6 +194,12 @@ int delegate_real_connect(const char *file, const int line, const char *func, in
     (void)line;
     (void)func;
 
+    int virtual_ret;
+    if (virtualNetworkConnect(sockfd, addr, addrlen, &virtual_ret))
+    {
+        return virtual_ret;
+    }
+
     return connect(sockfd, addr, addrlen);
 }
 
@@ -175,9 +207,9 @@ int mock_connect(const char *file, const int line, const char *func, int sockfd,
 {
     int mock_ret;
 
-    if (_mock_sys_socket != nullptr)
+    if (auto locked_sys_socket = _mock_sys_socket.lock())
     {
-        mock_ret = _mock_sys_socket->connect(file, line, func, sockfd, addr, addrlen);
+        mock_ret = locked_sys_socket->connect(file, line, func, sockfd, addr, addrlen);
     }
     else
     {
@@ -196,6 +228,12 @@ int delegate_real_shutdown(const char *file, const int line, const char *func, i
     (void)line;
     (void)func;
 
+    int virtual_ret;
+    if (virtualNetworkShutdown(sockfd, how, &virtual_ret))
+    {
+        return virtual_ret;
+    }
+
     return shutdown(sockfd, how);
 }
 
@@ -203,9 +241,9 @@ int mock_shutdown(const char *file, const int line, const char *func, int sockfd
 {
     int mock_ret;
 
-    if (_mock_sys_socket != nullptr)
+    if (auto locked_sys_socket = _mock_sys_socket.lock())
     {
-        mock_ret = _mock_sys_socket->shutdown(file, line, func, sockfd, how);
+        mock_ret = locked_sys_socket->shutdown(file, line, func, sockfd, how);
     }
     else
     {
@@ -224,6 +262,12 @@ int delegate_real_setsockopt(const char *file, const int line, const char *func,
     (void)line;
     (void)func;
 
+    int virtual_ret;
+    if (virtualNetworkSetsockopt(sockfd, level, optname, optval, optlen, &virtual_ret))
+    {
+        return virtual_ret;
+    }
+
     return setsockopt(sockfd, level, optname, optval, optlen);
 }
 
@@ -231,9 +275,9 @@ int mock_setsockopt(const char *file, const int line, const char *func, int sock
 {
     int mock_ret;
 
-    if (_mock_sys_socket != nullptr)
+    if (auto locked_sys_socket = _mock_sys_socket.lock())
     {
-        mock_ret = _mock_sys_socket->setsockopt(file, line, func, sockfd, level, optname, optval, optlen);
+        mock_ret = locked_sys_socket->setsockopt(file, line, func, sockfd, level, optname, optval, optlen);
     }
     else
     {
@@ -252,6 +296,12 @@ int delegate_real_getsockopt(const char *file, const int line, const char *func,
     (void)line;
     (void)func;
 
+    int virtual_ret;
+    if (virtualNetworkGetsockopt(sockfd, level, optname, optval, optlen, &virtual_ret))
+    {
+        return virtual_ret;
+    }
+
     return getsockopt(sockfd, level, optname, optval, optlen);
 }
 
@@ -259,9 +309,9 @@ int mock_getsockopt(const char *file, const int line, const char *func, int sock
 {
     int mock_ret;
 
-    if (_mock_sys_socket != nullptr)
+    if (auto locked_sys_socket = _mock_sys_socket.lock())
     {
-        mock_ret = _mock_sys_socket->getsockopt(file, line, func, sockfd, level, optname, optval, optlen);
+        mock_ret = locked_sys_socket->getsockopt(file, line, func, sockfd, level, optname, optval, optlen);
     }
     else
     {
@@ -280,6 +330,12 @@ ssize_t delegate_real_send(const char *file, const int line, const char *func, i
     (void)line;
     (void)func;
 
+    ssize_t virtual_ret;
+    if (virtualNetworkSend(sockfd, buf, len, flags, &virtual_ret))
+    {
+        return virtual_ret;
+    }
+
     return send(sockfd, buf, len, flags);
 }
 
@@ -287,13 +343,16 @@ ssize_t mock_send(const char *file, const int line, const char *func, int sockfd
 {
     ssize_t mock_ret;
 
-    if (_mock_sys_socket != nullptr)
-    {
-        mock_ret = _mock_sys_socket->send(file, line, func, sockfd, buf, len, flags);
-    }
-    else
+    const auto transfer = [&](const void *data, size_t size, const struct sockaddr *, socklen_t) -> ssize_t {
+        if (auto locked_sys_socket = _mock_sys_socket.lock())
+        {
+            return locked_sys_socket->send(file, line, func, sockfd, data, size, flags);
+        }
+        return delegate_real_send(file, line, func, sockfd, data, size, flags);
+    };
+    if (!networkImpairmentActive() || !impairSend(sockfd, buf, len, flags, nullptr, 0, transfer, &mock_ret))
     {
-        mock_ret = delegate_real_send(file, line, func, sockfd, buf, len, flags);
+        mock_ret = transfer(buf, len, nullptr, 0);
     }
 
     TRACE_SOCKET_CALL(send);
@@ -308,6 +367,12 @@ ssize_t delegate_real_recv(const char *file, const int line, const char *func, i
     (void)line;
     (void)func;
 
+    ssize_t virtual_ret;
+    if (virtualNetworkRecv(sockfd, buf, len, flags, &virtual_ret))
+    {
+        return virtual_ret;
+    }
+
     return recv(sockfd, buf, len, flags);
 }
 
@@ -315,13 +380,16 @@ ssize_t mock_recv(const char *file, const int line, const char *func, int sockfd
 {
     ssize_t mock_ret;
 
-    if (_mock_sys_socket != nullptr)
-    {
-        mock_ret = _mock_sys_socket->recv(file, line, func, sockfd, buf, len, flags);
-    }
-    else
+    const auto transfer = [&](void *data, size_t size) -> ssize_t {
+        if (auto locked_sys_socket = _mock_sys_socket.lock())
+        {
+            return locked_sys_socket->recv(file, line, func, sockfd, data, size, flags);
+        }
+        return delegate_real_recv(file, line, func, sockfd, data, size, flags);
+    };
+    if (!networkImpairmentActive() || !impairRecv(sockfd, buf, len, flags, transfer, &mock_ret))
     {
-        mock_ret = delegate_real_recv(file, line, func, sockfd, buf, len, flags);
+        mock_ret = transfer(buf, len);
     }
 
     TRACE_SOCKET_CALL(recv);
@@ -336,6 +404,12 @@ ssize_t delegate_real_sendto(const char *file, const int line, const char *func,
     (void)line;
     (void)func;
 
+    ssize_t virtual_ret;
+    if (virtualNetworkSendto(sockfd, buf, len, flags, dest_addr, addrlen, &virtual_ret))
+    {
+        return virtual_ret;
+    }
+
     return sendto(sockfd, buf, len, flags, dest_addr, addrlen);
 }
 
@@ -343,13 +417,17 @@ ssize_t mock_sendto(const char *file, const int line, const char *func, int sock
 {
     ssize_t mock_ret;
 
-    if (_mock_sys_socket != nullptr)
-    {
-        mock_ret = _mock_sys_socket->sendto(file, line, func, sockfd, buf, len, flags, dest_addr, addrlen);
-    }
-    else
+    const auto transfer = [&](const void *data, size_t size, const struct sockaddr *dest, socklen_t destlen) -> ssize_t {
+        if (auto locked_sys_socket = _mock_sys_socket.lock())
+        {
+            return locked_sys_socket->sendto(file, line, func, sockfd, data, size, flags, dest, destlen);
+        }
+        return delegate_real_sendto(file, line, func, sockfd, data, size, flags, dest, destlen);
+    };
+    if (!networkImpairmentActive() ||
+        !impairSend(sockfd, buf, len, flags, dest_addr, addrlen, transfer, &mock_ret))
     {
-        mock_ret = delegate_real_sendto(file, line, func, sockfd, buf, len, flags, dest_addr, addrlen);
+        mock_ret = transfer(buf, len, dest_addr, addrlen);
     }
 
     TRACE_SOCKET_CALL(sendto);
@@ -364,6 +442,12 @@ ssize_t delegate_real_recvfrom(const char *file, const int line, const char *fun
     (void)line;
     (void)func;
 
+    ssize_t virtual_ret;
+    if (virtualNetworkRecvfrom(sockfd, buf, len, flags, src_addr, addrlen, &virtual_ret))
+    {
+        return virtual_ret;
+    }
+
     return recvfrom(sockfd, buf, len, flags, src_addr, addrlen);
 }
 
@@ -371,13 +455,16 @@ ssize_t mock_recvfrom(const char *file, const int line, const char *func, int so
 {
     ssize_t mock_ret;
 
-    if (_mock_sys_socket != nullptr)
-    {
-        mock_ret = _mock_sys_socket->recvfrom(file, line, func, sockfd, buf, len, flags, src_addr, addrlen);
-    }
-    else
+    const auto transfer = [&](void *data, size_t size) -> ssize_t {
+        if (auto locked_sys_socket = _mock_sys_socket.lock())
+        {
+            return locked_sys_socket->recvfrom(file, line, func, sockfd, data, size, flags, src_addr, addrlen);
+        }
+        return delegate_real_recvfrom(file, line, func, sockfd, data, size, flags, src_addr, addrlen);
+    };
+    if (!networkImpairmentActive() || !impairRecv(sockfd, buf, len, flags, transfer, &mock_ret))
     {
-        mock_ret = delegate_real_recvfrom(file, line, func, sockfd, buf, len, flags, src_addr, addrlen);
+        mock_ret = transfer(buf, len);
     }
 
     TRACE_SOCKET_CALL(recvfrom);
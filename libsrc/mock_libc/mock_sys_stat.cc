@@ -3,7 +3,7 @@
 
 using namespace testing;
 
-Mock_sys_stat *_mock_sys_stat = nullptr;
+testfw::MockSlot<Mock_sys_stat> _mock_sys_stat;
 
 Mock_sys_stat::Mock_sys_stat()
 {
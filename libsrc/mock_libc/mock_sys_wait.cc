@@ -5,7 +5,7 @@
 
 using namespace testing;
 
-Mock_sys_wait *_mock_sys_wait = nullptr;
+testfw::MockSlot<Mock_sys_wait> _mock_sys_wait;
 
 Mock_sys_wait::Mock_sys_wait()
 {
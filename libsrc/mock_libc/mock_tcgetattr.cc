@@ -19,9 +19,9 @@ int mock_tcgetattr(const char *file, const int line, const char *func, int fd, s
 {
     int mock_ret;
 
-    if (_mock_termios != nullptr)
+    if (auto locked_termios = _mock_termios.lock())
     {
-        mock_ret = _mock_termios->tcgetattr(file, line, func, fd, termios_p);
+        mock_ret = locked_termios->tcgetattr(file, line, func, fd, termios_p);
     }
     else
     {
@@ -21,9 +21,9 @@ int mock_tcsetattr(const char *file, const int line, const char *func, int fd, i
 {
     int mock_ret;
 
-    if (_mock_termios != nullptr)
+    if (auto locked_termios = _mock_termios.lock())
     {
-        mock_ret = _mock_termios->tcsetattr(file, line, func, fd, optional_actions, termios_p);
+        mock_ret = locked_termios->tcsetattr(file, line, func, fd, optional_actions, termios_p);
     }
     else
     {
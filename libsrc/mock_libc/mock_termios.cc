@@ -6,7 +6,7 @@
 
 using namespace testing;
 
-Mock_termios *_mock_termios = nullptr;
+testfw::MockSlot<Mock_termios> _mock_termios;
 
 Mock_termios::Mock_termios()
 {
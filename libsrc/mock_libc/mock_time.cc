@@ -3,7 +3,7 @@
 
 using namespace testing;
 
-Mock_time *_mock_time = nullptr;
+testfw::MockSlot<Mock_time> _mock_time;
 
 Mock_time::Mock_time()
 {
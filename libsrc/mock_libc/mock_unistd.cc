@@ -3,7 +3,7 @@
 
 using namespace testing;
 
-Mock_unistd *_mock_unistd = nullptr;
+testfw::MockSlot<Mock_unistd> _mock_unistd;
 
 #ifndef _WIN32
 
@@ -53,6 +53,11 @@ Mock_unistd::Mock_unistd()
 
 #endif // _WIN32
 
+void Mock_unistd::bypass_unconfigured_methods()
+{
+    _mock_unistd.bypassUnconfigured(this);
+}
+
 Mock_unistd::~Mock_unistd()
 {
     TESTFW_UNREGISTER_MOCK_INSTANCE(_mock_unistd);
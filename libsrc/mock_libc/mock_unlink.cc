@@ -1,6 +1,9 @@
 #ifndef _WIN32
 
     #include <test_com.h>
+    #include <virtualFileSystem.h>
+#include <callStats.h>
+#include <faultInjection.h>
     #include <mock_unistd.h>
 
 using namespace testing;
@@ -11,6 +14,12 @@ int delegate_real_unlink(const char *file, const int line, const char *func, con
     (void)line;
     (void)func;
 
+    int virtual_ret;
+    if (virtualUnlink(path, &virtual_ret))
+    {
+        return virtual_ret;
+    }
+
     return ::unlink(path);
 }
 
@@ -18,14 +27,20 @@ int mock_unlink(const char *file, const int line, const char *func, const char *
 {
     int mock_ret;
 
-    if (_mock_unistd != nullptr)
+    CallStatsTimer call_stats("unlink", file, line, func);
+    if (shouldInjectFault(FAULT_UNLINK, 0, path))
+    {
+        mock_ret = -1;
+    }
+    else if (auto locked_unistd = _mock_unistd.lock(Mock_unistd::METHOD_unlink))
     {
-        mock_ret = _mock_unistd->unlink(file, line, func, path);
+        mock_ret = locked_unistd->unlink(file, line, func, path);
     }
     else
     {
         mock_ret = delegate_real_unlink(file, line, func, path);
     }
+    call_stats.finish(mock_ret == -1);
 
     if (getTraceLevel() > TRACE_NONE)
     {
@@ -19,9 +19,9 @@ int mock_unsetenv(const char *file, const int line, const char *func, const char
 {
     int mock_ret;
 
-    if (_mock_stdlib != nullptr)
+    if (auto locked_stdlib = _mock_stdlib.lock(Mock_stdlib::METHOD_unsetenv))
     {
-        mock_ret = _mock_stdlib->unsetenv(file, line, func, name);
+        mock_ret = locked_stdlib->unsetenv(file, line, func, name);
     }
     else
     {
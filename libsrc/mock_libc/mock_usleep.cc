@@ -1,20 +1,30 @@
 #include <test_com.h>
 #include <mock_unistd.h>
+#include <virtualClock.h>
 
 #ifndef _WIN32
 
+using namespace testing;
+
 int delegate_real_usleep(const char *file, const int line, const char *func, useconds_t usec)
 {
     (void)file;
     (void)line;
     (void)func;
+
+    int virtual_ret;
+    if (virtualUsleep(usec, &virtual_ret))
+    {
+        return virtual_ret;
+    }
+
     return usleep(usec);
 }
 
 int mock_usleep(const char *file, const int line, const char *func, useconds_t usec)
 {
-    return (_mock_unistd != nullptr) ? _mock_unistd->usleep(file, line, func, usec)
-                                     : delegate_real_usleep(file, line, func, usec);
+    auto locked_unistd = _mock_unistd.lock(Mock_unistd::METHOD_usleep);
+    return locked_unistd ? locked_unistd->usleep(file, line, func, usec) : delegate_real_usleep(file, line, func, usec);
 }
 
 #endif // _WIN32
@@ -40,9 +40,9 @@ int mock_vfprintf(const char *file, const int line, const char *func, FILE *stre
     {
         mock_ret = -1;
     }
-    else if (_mock_stdio != nullptr)
+    else if (auto locked_stdio = _mock_stdio.lock(Mock_stdio::METHOD_vfprintf))
     {
-        mock_ret = _mock_stdio->vfprintf(file, line, func, stream, str);
+        mock_ret = locked_stdio->vfprintf(file, line, func, stream, str);
     }
     else
     {
@@ -19,9 +19,9 @@ int mock_vfscanf(const char *file, const int line, const char *func, FILE *strea
 {
     int mock_ret;
 
-    if (_mock_stdio != nullptr)
+    if (auto locked_stdio = _mock_stdio.lock(Mock_stdio::METHOD_vfscanf))
     {
-        mock_ret = _mock_stdio->vfscanf(file, line, func, stream, format, arg_ptr);
+        mock_ret = locked_stdio->vfscanf(file, line, func, stream, format, arg_ptr);
     }
     else
     {
@@ -18,9 +18,9 @@ int mock_vscanf(const char *file, const int line, const char *func, const char *
 {
     int mock_ret;
 
-    if (_mock_stdio != nullptr)
+    if (auto locked_stdio = _mock_stdio.lock(Mock_stdio::METHOD_vscanf))
     {
-        mock_ret = _mock_stdio->vscanf(file, line, func, format, arg_ptr);
+        mock_ret = locked_stdio->vscanf(file, line, func, format, arg_ptr);
     }
     else
     {
@@ -43,9 +43,9 @@ int mock_vsnprintf(const char *file, const int line, const char *func, char *s,
     {
         mock_ret = -1;
     }
-    else if (_mock_stdio != nullptr)
+    else if (auto locked_stdio = _mock_stdio.lock(Mock_stdio::METHOD_vsnprintf))
     {
-        mock_ret = _mock_stdio->vsnprintf(file, line, func, s, n, str);
+        mock_ret = locked_stdio->vsnprintf(file, line, func, s, n, str);
     }
     else
     {
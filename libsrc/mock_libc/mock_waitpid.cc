@@ -19,9 +19,9 @@ pid_t mock_waitpid(const char *file, const int line, const char *func, pid_t pid
 {
     pid_t mock_ret;
 
-    if (_mock_sys_wait != nullptr)
+    if (auto locked_sys_wait = _mock_sys_wait.lock())
     {
-        mock_ret = _mock_sys_wait->waitpid(file, line, func, pid, stat_loc, options);
+        mock_ret = locked_sys_wait->waitpid(file, line, func, pid, stat_loc, options);
     }
     else
     {
@@ -5,7 +5,7 @@
 
 using namespace testing;
 
-Mock_windows *_mock_windows = nullptr;
+testfw::MockSlot<Mock_windows> _mock_windows;
 
 Mock_windows::Mock_windows()
 {
@@ -8,7 +8,7 @@
 
 using namespace testing;
 
-Mock_winsock *_mock_winsock = nullptr;
+testfw::MockSlot<Mock_winsock> _mock_winsock;
 
 Mock_winsock::Mock_winsock()
 {
@@ -75,9 +75,9 @@ int mock_WSAStartup(const char *file, const int line, const char *func, WORD ver
 {
     int mock_ret;
 
-    if (_mock_winsock != nullptr)
+    if (auto locked_winsock = _mock_winsock.lock())
     {
-        mock_ret = _mock_winsock->WSAStartup(file, line, func, version_required, wsa_data);
+        mock_ret = locked_winsock->WSAStartup(file, line, func, version_required, wsa_data);
     }
     else
     {
@@ -103,9 +103,9 @@ int mock_WSACleanup(const char *file, const int line, const char *func)
 {
     int mock_ret;
 
-    if (_mock_winsock != nullptr)
+    if (auto locked_winsock = _mock_winsock.lock())
     {
-        mock_ret = _mock_winsock->WSACleanup(file, line, func);
+        mock_ret = locked_winsock->WSACleanup(file, line, func);
     }
     else
     {
@@ -131,9 +131,9 @@ int mock_WSAGetLastError(const char *file, const int line, const char *func)
 {
     int mock_ret;
 
-    if (_mock_winsock != nullptr)
+    if (auto locked_winsock = _mock_winsock.lock())
     {
-        mock_ret = _mock_winsock->WSAGetLastError(file, line, func);
+        mock_ret = locked_winsock->WSAGetLastError(file, line, func);
     }
     else
     {
@@ -163,9 +163,9 @@ int mock_WSAPoll(const char *file, const int line, const char *func, LPWSAPOLLFD
 {
     int mock_ret;
 
-    if (_mock_winsock != nullptr)
+    if (auto locked_winsock = _mock_winsock.lock())
     {
-        mock_ret = _mock_winsock->WSAPoll(file, line, func, fd_array, fds, timeout);
+        mock_ret = locked_winsock->WSAPoll(file, line, func, fd_array, fds, timeout);
     }
     else
     {
@@ -191,9 +191,9 @@ SOCKET mock_socket(const char *file, const int line, const char *func, int af, i
 {
     SOCKET mock_ret;
 
-    if (_mock_winsock != nullptr)
+    if (auto locked_winsock = _mock_winsock.lock())
     {
-        mock_ret = _mock_winsock->socket(file, line, func, af, type, protocol);
+        mock_ret = locked_winsock->socket(file, line, func, af, type, protocol);
     }
     else
     {
@@ -219,9 +219,9 @@ int mock_bind(const char *file, const int line, const char *func, SOCKET s, cons
 {
     int mock_ret;
 
-    if (_mock_winsock != nullptr)
+    if (auto locked_winsock = _mock_winsock.lock())
     {
-        mock_ret = _mock_winsock->bind(file, line, func, s, name, namelen);
+        mock_ret = locked_winsock->bind(file, line, func, s, name, namelen);
     }
     else
     {
@@ -247,9 +247,9 @@ int mock_listen(const char *file, const int line, const char *func, SOCKET s, in
 {
     int mock_ret;
 
-    if (_mock_winsock != nullptr)
+    if (auto locked_winsock = _mock_winsock.lock())
     {
-        mock_ret = _mock_winsock->listen(file, line, func, s, backlog);
+        mock_ret = locked_winsock->listen(file, line, func, s, backlog);
     }
     else
     {
@@ -275,9 +275,9 @@ SOCKET mock_accept(const char *file, const int line, const char *func, SOCKET s,
 {
     SOCKET mock_ret;
 
-    if (_mock_winsock != nullptr)
+    if (auto locked_winsock = _mock_winsock.lock())
     {
-        mock_ret = _mock_winsock->accept(file, line, func, s, addr, addrlen);
+        mock_ret = locked_winsock->accept(file, line, func, s, addr, addrlen);
     }
     else
     {
@@ -303,9 +303,9 @@ int mock_connect(const char *file, const int line, const char *func, SOCKET s, c
 {
     int mock_ret;
 
-    if (_mock_winsock != nullptr)
+    if (auto locked_winsock = _mock_winsock.lock())
     {
-        mock_ret = _mock_winsock->connect(file, line, func, s, name, namelen);
+        mock_ret = locked_winsock->connect(file, line, func, s, name, namelen);
     }
     else
     {
@@ -331,9 +331,9 @@ int mock_shutdown(const char *file, const int line, const char *func, SOCKET s,
 {
     int mock_ret;
 
-    if (_mock_winsock != nullptr)
+    if (auto locked_winsock = _mock_winsock.lock())
     {
-        mock_ret = _mock_winsock->shutdown(file, line, func, s, how);
+        mock_ret = locked_winsock->shutdown(file, line, func, s, how);
     }
     else
     {
@@ -359,9 +359,9 @@ int mock_closesocket(const char *file, const int line, const char *func, SOCKET
 {
     int mock_ret;
 
-    if (_mock_winsock != nullptr)
+    if (auto locked_winsock = _mock_winsock.lock())
     {
-        mock_ret = _mock_winsock->closesocket(file, line, func, s);
+        mock_ret = locked_winsock->closesocket(file, line, func, s);
     }
     else
     {
@@ -387,9 +387,9 @@ int mock_ioctlsocket(const char *file, const int line, const char *func, SOCKET
 {
     int mock_ret;
 
-    if (_mock_winsock != nullptr)
+    if (auto locked_winsock = _mock_winsock.lock())
     {
-        mock_ret = _mock_winsock->ioctlsocket(file, line, func, s, cmd, argp);
+        mock_ret = locked_winsock->ioctlsocket(file, line, func, s, cmd, argp);
     }
     else
     {
@@ -415,9 +415,9 @@ int mock_setsockopt(const char *file, const int line, const char *func, SOCKET s
 {
     int mock_ret;
 
-    if (_mock_winsock != nullptr)
+    if (auto locked_winsock = _mock_winsock.lock())
     {
-        mock_ret = _mock_winsock->setsockopt(file, line, func, s, level, optname, optval, optlen);
+        mock_ret = locked_winsock->setsockopt(file, line, func, s, level, optname, optval, optlen);
     }
     else
     {
@@ -443,9 +443,9 @@ int mock_getsockopt(const char *file, const int line, const char *func, SOCKET s
 {
     int mock_ret;
 
-    if (_mock_winsock != nullptr)
+    if (auto locked_winsock = _mock_winsock.lock())
     {
-        mock_ret = _mock_winsock->getsockopt(file, line, func, s, level, optname, optval, optlen);
+        mock_ret = locked_winsock->getsockopt(file, line, func, s, level, optname, optval, optlen);
     }
     else
     {
@@ -471,9 +471,9 @@ int mock_send(const char *file, const int line, const char *func, SOCKET s, cons
 {
     int mock_ret;
 
-    if (_mock_winsock != nullptr)
+    if (auto locked_winsock = _mock_winsock.lock())
     {
-        mock_ret = _mock_winsock->send(file, line, func, s, buf, len, flags);
+        mock_ret = locked_winsock->send(file, line, func, s, buf, len, flags);
     }
     else
     {
@@ -499,9 +499,9 @@ int mock_recv(const char *file, const int line, const char *func, SOCKET s, char
 {
     int mock_ret;
 
-    if (_mock_winsock != nullptr)
+    if (auto locked_winsock = _mock_winsock.lock())
     {
-        mock_ret = _mock_winsock->recv(file, line, func, s, buf, len, flags);
+        mock_ret = locked_winsock->recv(file, line, func, s, buf, len, flags);
     }
     else
     {
@@ -527,9 +527,9 @@ int mock_sendto(const char *file, const int line, const char *func, SOCKET s, co
 {
     int mock_ret;
 
-    if (_mock_winsock != nullptr)
+    if (auto locked_winsock = _mock_winsock.lock())
     {
-        mock_ret = _mock_winsock->sendto(file, line, func, s, buf, len, flags, to, tolen);
+        mock_ret = locked_winsock->sendto(file, line, func, s, buf, len, flags, to, tolen);
     }
     else
     {
@@ -555,9 +555,9 @@ int mock_recvfrom(const char *file, const int line, const char *func, SOCKET s,
 {
     int mock_ret;
 
-    if (_mock_winsock != nullptr)
+    if (auto locked_winsock = _mock_winsock.lock())
     {
-        mock_ret = _mock_winsock->recvfrom(file, line, func, s, buf, len, flags, from, fromlen);
+        mock_ret = locked_winsock->recvfrom(file, line, func, s, buf, len, flags, from, fromlen);
     }
     else
     {
@@ -583,9 +583,9 @@ INT mock_inet_pton(const char *file, const int line, const char *func, INT famil
 {
     INT mock_ret;
 
-    if (_mock_winsock != nullptr)
+    if (auto locked_winsock = _mock_winsock.lock())
     {
-        mock_ret = _mock_winsock->inet_pton(file, line, func, family, addr_string, addr_buf);
+        mock_ret = locked_winsock->inet_pton(file, line, func, family, addr_string, addr_buf);
     }
     else
     {
@@ -611,9 +611,9 @@ PCSTR mock_inet_ntop(const char *file, const int line, const char *func, INT fam
 {
     PCSTR mock_ret;
 
-    if (_mock_winsock != nullptr)
+    if (auto locked_winsock = _mock_winsock.lock())
     {
-        mock_ret = _mock_winsock->inet_ntop(file, line, func, family, addr, string_buf, string_buf_size);
+        mock_ret = locked_winsock->inet_ntop(file, line, func, family, addr, string_buf, string_buf_size);
     }
     else
     {
@@ -639,9 +639,9 @@ INT mock_getaddrinfo(const char *file, const int line, const char *func, PCSTR n
 {
     INT mock_ret;
 
-    if (_mock_winsock != nullptr)
+    if (auto locked_winsock = _mock_winsock.lock())
     {
-        mock_ret = _mock_winsock->getaddrinfo(file, line, func, node_name, service_name, hints, result_out);
+        mock_ret = locked_winsock->getaddrinfo(file, line, func, node_name, service_name, hints, result_out);
     }
     else
     {
@@ -665,9 +665,9 @@ void delegate_real_freeaddrinfo(const char *file, const int line, const char *fu
 
 void mock_freeaddrinfo(const char *file, const int line, const char *func, PADDRINFOA addr_info)
 {
-    if (_mock_winsock != nullptr)
+    if (auto locked_winsock = _mock_winsock.lock())
     {
-        _mock_winsock->freeaddrinfo(file, line, func, addr_info);
+        locked_winsock->freeaddrinfo(file, line, func, addr_info);
     }
     else
     {
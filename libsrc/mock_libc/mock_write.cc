@@ -1,10 +1,16 @@
 #include <test_com.h>
+#include <virtualFileSystem.h>
+#include <virtualNetwork.h>
+#include <callStats.h>
+#include <faultInjection.h>
 #include <mock_unistd.h>
 
 using namespace testing;
 
 #ifndef _WIN32
 
+testfw::FakeSlot<ssize_t(int, const void *, size_t)> _fake_write;
+
 ssize_t delegate_real_write(const char *file, const int line, const char *func, int fd, const void *buf, size_t count)
 {
     // avoid -Wunused-parameter
@@ -12,6 +18,16 @@ ssize_t delegate_real_write(const char *file, const int line, const char *func,
     (void)line;
     (void)func;
 
+    ssize_t virtual_ret;
+    if (virtualWrite(fd, buf, count, &virtual_ret))
+    {
+        return virtual_ret;
+    }
+    if (virtualNetworkWrite(fd, buf, count, &virtual_ret))
+    {
+        return virtual_ret;
+    }
+
     return write(fd, buf, count);
 }
 
@@ -19,14 +35,24 @@ ssize_t mock_write(const char *file, const int line, const char *func, int fd, c
 {
     ssize_t mock_ret;
 
-    if (_mock_unistd != nullptr)
+    CallStatsTimer call_stats("write", file, line, func);
+    if (shouldInjectFault(FAULT_WRITE, count))
+    {
+        mock_ret = -1;
+    }
+    else if (auto locked_fake = _fake_write.lock())
+    {
+        mock_ret = locked_fake->call(file, line, func, fd, buf, count);
+    }
+    else if (auto locked_unistd = _mock_unistd.lock(Mock_unistd::METHOD_write))
     {
-        mock_ret = _mock_unistd->write(file, line, func, fd, buf, count);
+        mock_ret = locked_unistd->write(file, line, func, fd, buf, count);
     }
     else
     {
         mock_ret = delegate_real_write(file, line, func, fd, buf, count);
     }
+    call_stats.finish(mock_ret == -1);
 
     if (getTraceLevel() > TRACE_NONE)
     {
@@ -61,9 +87,9 @@ int mock__write(const char *file, const int line, const char *func, int fd, cons
 {
     int mock_ret;
 
-    if (_mock_unistd != nullptr)
+    if (auto locked_unistd = _mock_unistd.lock(Mock_unistd::METHOD__write))
     {
-        mock_ret = _mock_unistd->_write(file, line, func, fd, buf, count);
+        mock_ret = locked_unistd->_write(file, line, func, fd, buf, count);
     }
     else
     {
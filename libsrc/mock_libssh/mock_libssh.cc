@@ -3,7 +3,7 @@
 
 using namespace testing;
 
-Mock_libssh *_mock_libssh = nullptr;
+testfw::MockSlot<Mock_libssh> _mock_libssh;
 
 Mock_libssh::Mock_libssh()
 {
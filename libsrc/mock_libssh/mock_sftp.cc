@@ -1,5 +1,6 @@
 #include <test_com.h>
 #include <mock_libssh.h>
+#include <virtualSftpServer.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -36,9 +37,9 @@ sftp_session mock_sftp_new(const char *file, const int line, const char *func, s
 {
     sftp_session mock_ret;
 
-    if (_mock_libssh != nullptr)
+    if (auto locked_libssh = _mock_libssh.lock())
     {
-        mock_ret = _mock_libssh->sftp_new(file, line, func, session);
+        mock_ret = locked_libssh->sftp_new(file, line, func, session);
     }
     else
     {
@@ -71,6 +72,8 @@ void delegate_fake_sftp_free(const char *file, const int line, const char *func,
     (void)line;
     (void)func;
 
+    virtualSftpForgetSession(sftp);
+
     if (sftp != nullptr)
     {
         free(sftp);
@@ -92,9 +95,9 @@ void delegate_real_sftp_free(const char *file, const int line, const char *func,
 
 void mock_sftp_free(const char *file, const int line, const char *func, sftp_session sftp)
 {
-    if (_mock_libssh != nullptr)
+    if (auto locked_libssh = _mock_libssh.lock())
     {
-        _mock_libssh->sftp_free(file, line, func, sftp);
+        locked_libssh->sftp_free(file, line, func, sftp);
     }
     else
     {
@@ -146,9 +149,9 @@ int mock_sftp_init(const char *file, const int line, const char *func, sftp_sess
 {
     int mock_ret;
 
-    if (_mock_libssh != nullptr)
+    if (auto locked_libssh = _mock_libssh.lock())
     {
-        mock_ret = _mock_libssh->sftp_init(file, line, func, sftp);
+        mock_ret = locked_libssh->sftp_init(file, line, func, sftp);
     }
     else
     {
@@ -180,7 +183,12 @@ int delegate_fake_sftp_get_error(const char *file, const int line, const char *f
     (void)file;
     (void)line;
     (void)func;
-    (void)sftp;
+
+    int virtual_ret;
+    if (virtualSftpGetError(sftp, &virtual_ret))
+    {
+        return virtual_ret;
+    }
 
     return SSH_FX_OK;
 }
@@ -202,9 +210,9 @@ int mock_sftp_get_error(const char *file, const int line, const char *func, sftp
 {
     int mock_ret;
 
-    if (_mock_libssh != nullptr)
+    if (auto locked_libssh = _mock_libssh.lock())
     {
-        mock_ret = _mock_libssh->sftp_get_error(file, line, func, sftp);
+        mock_ret = locked_libssh->sftp_get_error(file, line, func, sftp);
     }
     else
     {
@@ -237,10 +245,12 @@ sftp_file delegate_fake_sftp_open(const char *file, const int line, const char *
     (void)file;
     (void)line;
     (void)func;
-    (void)sftp;
-    (void)filename;
-    (void)accesstype;
-    (void)mode;
+
+    sftp_file virtual_ret;
+    if (virtualSftpOpen(sftp, filename, accesstype, mode, &virtual_ret))
+    {
+        return virtual_ret;
+    }
 
     return (sftp_file)malloc(sizeof(struct sftp_file_struct *));
 }
@@ -264,9 +274,9 @@ sftp_file mock_sftp_open(const char *file, const int line, const char *func, sft
 {
     sftp_file mock_ret;
 
-    if (_mock_libssh != nullptr)
+    if (auto locked_libssh = _mock_libssh.lock())
     {
-        mock_ret = _mock_libssh->sftp_open(file, line, func, sftp, filename, accesstype, mode);
+        mock_ret = locked_libssh->sftp_open(file, line, func, sftp, filename, accesstype, mode);
     }
     else
     {
@@ -299,6 +309,12 @@ int delegate_fake_sftp_close(const char *file, const int line, const char *func,
     (void)line;
     (void)func;
 
+    int virtual_ret;
+    if (virtualSftpClose(sftpfile, &virtual_ret))
+    {
+        return virtual_ret;
+    }
+
     if (sftpfile != nullptr)
     {
         free(sftpfile);
@@ -324,9 +340,9 @@ int mock_sftp_close(const char *file, const int line, const char *func, sftp_fil
 {
     int mock_ret;
 
-    if (_mock_libssh != nullptr)
+    if (auto locked_libssh = _mock_libssh.lock())
     {
-        mock_ret = _mock_libssh->sftp_close(file, line, func, sftpfile);
+        mock_ret = locked_libssh->sftp_close(file, line, func, sftpfile);
     }
     else
     {
@@ -359,9 +375,12 @@ ssize_t delegate_fake_sftp_read(const char *file, const int line, const char *fu
     (void)file;
     (void)line;
     (void)func;
-    (void)sftpfile;
-    (void)buf;
-    (void)count;
+
+    ssize_t virtual_ret;
+    if (virtualSftpRead(sftpfile, buf, count, &virtual_ret))
+    {
+        return virtual_ret;
+    }
 
     return 0; /* EOF */
 }
@@ -384,9 +403,9 @@ ssize_t mock_sftp_read(const char *file, const int line, const char *func, sftp_
 {
     ssize_t mock_ret;
 
-    if (_mock_libssh != nullptr)
+    if (auto locked_libssh = _mock_libssh.lock())
     {
-        mock_ret = _mock_libssh->sftp_read(file, line, func, sftpfile, buf, count);
+        mock_ret = locked_libssh->sftp_read(file, line, func, sftpfile, buf, count);
     }
     else
     {
@@ -419,8 +438,12 @@ ssize_t delegate_fake_sftp_write(const char *file, const int line, const char *f
     (void)file;
     (void)line;
     (void)func;
-    (void)sftpfile;
-    (void)buf;
+
+    ssize_t virtual_ret;
+    if (virtualSftpWrite(sftpfile, buf, count, &virtual_ret))
+    {
+        return virtual_ret;
+    }
 
     return (ssize_t)count;
 }
@@ -444,9 +467,9 @@ ssize_t mock_sftp_write(const char *file, const int line, const char *func, sftp
 {
     ssize_t mock_ret;
 
-    if (_mock_libssh != nullptr)
+    if (auto locked_libssh = _mock_libssh.lock())
     {
-        mock_ret = _mock_libssh->sftp_write(file, line, func, sftpfile, buf, count);
+        mock_ret = locked_libssh->sftp_write(file, line, func, sftpfile, buf, count);
     }
     else
     {
@@ -478,8 +501,12 @@ int delegate_fake_sftp_seek(const char *file, const int line, const char *func,
     (void)file;
     (void)line;
     (void)func;
-    (void)sftpfile;
-    (void)new_offset;
+
+    int virtual_ret;
+    if (virtualSftpSeek(sftpfile, new_offset, &virtual_ret))
+    {
+        return virtual_ret;
+    }
 
     return SSH_OK;
 }
@@ -501,9 +528,9 @@ int mock_sftp_seek(const char *file, const int line, const char *func, sftp_file
 {
     int mock_ret;
 
-    if (_mock_libssh != nullptr)
+    if (auto locked_libssh = _mock_libssh.lock())
     {
-        mock_ret = _mock_libssh->sftp_seek(file, line, func, sftpfile, new_offset);
+        mock_ret = locked_libssh->sftp_seek(file, line, func, sftpfile, new_offset);
     }
     else
     {
@@ -536,8 +563,12 @@ int delegate_fake_sftp_seek64(const char *file, const int line, const char *func
     (void)file;
     (void)line;
     (void)func;
-    (void)sftpfile;
-    (void)new_offset;
+
+    int virtual_ret;
+    if (virtualSftpSeek(sftpfile, new_offset, &virtual_ret))
+    {
+        return virtual_ret;
+    }
 
     return SSH_OK;
 }
@@ -560,9 +591,9 @@ int mock_sftp_seek64(const char *file, const int line, const char *func, sftp_fi
 {
     int mock_ret;
 
-    if (_mock_libssh != nullptr)
+    if (auto locked_libssh = _mock_libssh.lock())
     {
-        mock_ret = _mock_libssh->sftp_seek64(file, line, func, sftpfile, new_offset);
+        mock_ret = locked_libssh->sftp_seek64(file, line, func, sftpfile, new_offset);
     }
     else
     {
@@ -594,7 +625,12 @@ unsigned long delegate_fake_sftp_tell(const char *file, const int line, const ch
     (void)file;
     (void)line;
     (void)func;
-    (void)sftpfile;
+
+    uint64_t virtual_ret;
+    if (virtualSftpTell(sftpfile, &virtual_ret))
+    {
+        return (unsigned long)virtual_ret;
+    }
 
     return 0;
 }
@@ -616,9 +652,9 @@ unsigned long mock_sftp_tell(const char *file, const int line, const char *func,
 {
     unsigned long mock_ret;
 
-    if (_mock_libssh != nullptr)
+    if (auto locked_libssh = _mock_libssh.lock())
     {
-        mock_ret = _mock_libssh->sftp_tell(file, line, func, sftpfile);
+        mock_ret = locked_libssh->sftp_tell(file, line, func, sftpfile);
     }
     else
     {
@@ -650,7 +686,12 @@ uint64_t delegate_fake_sftp_tell64(const char *file, const int line, const char
     (void)file;
     (void)line;
     (void)func;
-    (void)sftpfile;
+
+    uint64_t virtual_ret;
+    if (virtualSftpTell(sftpfile, &virtual_ret))
+    {
+        return virtual_ret;
+    }
 
     return 0;
 }
@@ -672,9 +713,9 @@ uint64_t mock_sftp_tell64(const char *file, const int line, const char *func, sf
 {
     uint64_t mock_ret;
 
-    if (_mock_libssh != nullptr)
+    if (auto locked_libssh = _mock_libssh.lock())
     {
-        mock_ret = _mock_libssh->sftp_tell64(file, line, func, sftpfile);
+        mock_ret = locked_libssh->sftp_tell64(file, line, func, sftpfile);
     }
     else
     {
@@ -706,7 +747,9 @@ void delegate_fake_sftp_rewind(const char *file, const int line, const char *fun
     (void)file;
     (void)line;
     (void)func;
-    (void)sftpfile;
+
+    int virtual_ret;
+    (void)virtualSftpSeek(sftpfile, 0, &virtual_ret);
 }
 
 void delegate_real_sftp_rewind(const char *file, const int line, const char *func, sftp_file sftpfile)
@@ -724,9 +767,9 @@ void delegate_real_sftp_rewind(const char *file, const int line, const char *fun
 
 void mock_sftp_rewind(const char *file, const int line, const char *func, sftp_file sftpfile)
 {
-    if (_mock_libssh != nullptr)
+    if (auto locked_libssh = _mock_libssh.lock())
     {
-        _mock_libssh->sftp_rewind(file, line, func, sftpfile);
+        locked_libssh->sftp_rewind(file, line, func, sftpfile);
     }
     else
     {
@@ -756,7 +799,12 @@ sftp_attributes delegate_fake_sftp_fstat(const char *file, const int line, const
     (void)file;
     (void)line;
     (void)func;
-    (void)sftpfile;
+
+    sftp_attributes virtual_ret;
+    if (virtualSftpFstat(sftpfile, &virtual_ret))
+    {
+        return virtual_ret;
+    }
 
     sftp_attributes attr = (sftp_attributes)calloc(1, sizeof(struct sftp_attributes_struct));
     return attr;
@@ -779,9 +827,9 @@ sftp_attributes mock_sftp_fstat(const char *file, const int line, const char *fu
 {
     sftp_attributes mock_ret;
 
-    if (_mock_libssh != nullptr)
+    if (auto locked_libssh = _mock_libssh.lock())
     {
-        mock_ret = _mock_libssh->sftp_fstat(file, line, func, sftpfile);
+        mock_ret = locked_libssh->sftp_fstat(file, line, func, sftpfile);
     }
     else
     {
@@ -814,8 +862,12 @@ sftp_dir delegate_fake_sftp_opendir(const char *file, const int line, const char
     (void)file;
     (void)line;
     (void)func;
-    (void)sftp;
-    (void)path;
+
+    sftp_dir virtual_ret;
+    if (virtualSftpOpendir(sftp, path, &virtual_ret))
+    {
+        return virtual_ret;
+    }
 
     return (sftp_dir)malloc(sizeof(struct sftp_dir_struct *));
 }
@@ -838,9 +890,9 @@ sftp_dir mock_sftp_opendir(const char *file, const int line, const char *func, s
 {
     sftp_dir mock_ret;
 
-    if (_mock_libssh != nullptr)
+    if (auto locked_libssh = _mock_libssh.lock())
     {
-        mock_ret = _mock_libssh->sftp_opendir(file, line, func, sftp, path);
+        mock_ret = locked_libssh->sftp_opendir(file, line, func, sftp, path);
     }
     else
     {
@@ -874,7 +926,12 @@ sftp_attributes delegate_fake_sftp_readdir(const char *file, const int line, con
     (void)line;
     (void)func;
     (void)sftp;
-    (void)dir;
+
+    sftp_attributes virtual_ret;
+    if (virtualSftpReaddir(dir, &virtual_ret))
+    {
+        return virtual_ret;
+    }
 
     return nullptr; /* End of directory */
 }
@@ -897,9 +954,9 @@ sftp_attributes mock_sftp_readdir(const char *file, const int line, const char *
 {
     sftp_attributes mock_ret;
 
-    if (_mock_libssh != nullptr)
+    if (auto locked_libssh = _mock_libssh.lock())
     {
-        mock_ret = _mock_libssh->sftp_readdir(file, line, func, sftp, dir);
+        mock_ret = locked_libssh->sftp_readdir(file, line, func, sftp, dir);
     }
     else
     {
@@ -932,6 +989,12 @@ int delegate_fake_sftp_closedir(const char *file, const int line, const char *fu
     (void)line;
     (void)func;
 
+    int virtual_ret;
+    if (virtualSftpClosedir(dir, &virtual_ret))
+    {
+        return virtual_ret;
+    }
+
     if (dir != nullptr)
     {
         free(dir);
@@ -957,9 +1020,9 @@ int mock_sftp_closedir(const char *file, const int line, const char *func, sftp_
 {
     int mock_ret;
 
-    if (_mock_libssh != nullptr)
+    if (auto locked_libssh = _mock_libssh.lock())
     {
-        mock_ret = _mock_libssh->sftp_closedir(file, line, func, dir);
+        mock_ret = locked_libssh->sftp_closedir(file, line, func, dir);
     }
     else
     {
@@ -992,9 +1055,12 @@ int delegate_fake_sftp_mkdir(const char *file, const int line, const char *func,
     (void)file;
     (void)line;
     (void)func;
-    (void)sftp;
-    (void)directory;
-    (void)mode;
+
+    int virtual_ret;
+    if (virtualSftpMkdir(sftp, directory, mode, &virtual_ret))
+    {
+        return virtual_ret;
+    }
 
     return SSH_OK;
 }
@@ -1018,9 +1084,9 @@ int mock_sftp_mkdir(const char *file, const int line, const char *func, sftp_ses
 {
     int mock_ret;
 
-    if (_mock_libssh != nullptr)
+    if (auto locked_libssh = _mock_libssh.lock())
     {
-        mock_ret = _mock_libssh->sftp_mkdir(file, line, func, sftp, directory, mode);
+        mock_ret = locked_libssh->sftp_mkdir(file, line, func, sftp, directory, mode);
     }
     else
     {
@@ -1053,8 +1119,12 @@ int delegate_fake_sftp_rmdir(const char *file, const int line, const char *func,
     (void)file;
     (void)line;
     (void)func;
-    (void)sftp;
-    (void)directory;
+
+    int virtual_ret;
+    if (virtualSftpRmdir(sftp, directory, &virtual_ret))
+    {
+        return virtual_ret;
+    }
 
     return SSH_OK;
 }
@@ -1077,9 +1147,9 @@ int mock_sftp_rmdir(const char *file, const int line, const char *func, sftp_ses
 {
     int mock_ret;
 
-    if (_mock_libssh != nullptr)
+    if (auto locked_libssh = _mock_libssh.lock())
     {
-        mock_ret = _mock_libssh->sftp_rmdir(file, line, func, sftp, directory);
+        mock_ret = locked_libssh->sftp_rmdir(file, line, func, sftp, directory);
     }
     else
     {
@@ -1112,8 +1182,12 @@ int delegate_fake_sftp_unlink(const char *file, const int line, const char *func
     (void)file;
     (void)line;
     (void)func;
-    (void)sftp;
-    (void)filename;
+
+    int virtual_ret;
+    if (virtualSftpUnlink(sftp, filename, &virtual_ret))
+    {
+        return virtual_ret;
+    }
 
     return SSH_OK;
 }
@@ -1136,9 +1210,9 @@ int mock_sftp_unlink(const char *file, const int line, const char *func, sftp_se
 {
     int mock_ret;
 
-    if (_mock_libssh != nullptr)
+    if (auto locked_libssh = _mock_libssh.lock())
     {
-        mock_ret = _mock_libssh->sftp_unlink(file, line, func, sftp, filename);
+        mock_ret = locked_libssh->sftp_unlink(file, line, func, sftp, filename);
     }
     else
     {
@@ -1171,9 +1245,12 @@ int delegate_fake_sftp_rename(const char *file, const int line, const char *func
     (void)file;
     (void)line;
     (void)func;
-    (void)sftp;
-    (void)original;
-    (void)newname;
+
+    int virtual_ret;
+    if (virtualSftpRename(sftp, original, newname, &virtual_ret))
+    {
+        return virtual_ret;
+    }
 
     return SSH_OK;
 }
@@ -1197,9 +1274,9 @@ int mock_sftp_rename(const char *file, const int line, const char *func, sftp_se
 {
     int mock_ret;
 
-    if (_mock_libssh != nullptr)
+    if (auto locked_libssh = _mock_libssh.lock())
     {
-        mock_ret = _mock_libssh->sftp_rename(file, line, func, sftp, original, newname);
+        mock_ret = locked_libssh->sftp_rename(file, line, func, sftp, original, newname);
     }
     else
     {
@@ -1232,8 +1309,12 @@ sftp_attributes delegate_fake_sftp_stat(const char *file, const int line, const
     (void)file;
     (void)line;
     (void)func;
-    (void)sftp;
-    (void)path;
+
+    sftp_attributes virtual_ret;
+    if (virtualSftpStat(sftp, path, &virtual_ret))
+    {
+        return virtual_ret;
+    }
 
     sftp_attributes attr = (sftp_attributes)calloc(1, sizeof(struct sftp_attributes_struct));
     return attr;
@@ -1257,9 +1338,9 @@ sftp_attributes mock_sftp_stat(const char *file, const int line, const char *fun
 {
     sftp_attributes mock_ret;
 
-    if (_mock_libssh != nullptr)
+    if (auto locked_libssh = _mock_libssh.lock())
     {
-        mock_ret = _mock_libssh->sftp_stat(file, line, func, sftp, path);
+        mock_ret = locked_libssh->sftp_stat(file, line, func, sftp, path);
     }
     else
     {
@@ -1292,8 +1373,12 @@ sftp_attributes delegate_fake_sftp_lstat(const char *file, const int line, const
     (void)file;
     (void)line;
     (void)func;
-    (void)sftp;
-    (void)path;
+
+    sftp_attributes virtual_ret;
+    if (virtualSftpStat(sftp, path, &virtual_ret))
+    {
+        return virtual_ret;
+    }
 
     sftp_attributes attr = (sftp_attributes)calloc(1, sizeof(struct sftp_attributes_struct));
     return attr;
@@ -1317,9 +1402,9 @@ sftp_attributes mock_sftp_lstat(const char *file, const int line, const char *fu
 {
     sftp_attributes mock_ret;
 
-    if (_mock_libssh != nullptr)
+    if (auto locked_libssh = _mock_libssh.lock())
     {
-        mock_ret = _mock_libssh->sftp_lstat(file, line, func, sftp, path);
+        mock_ret = locked_libssh->sftp_lstat(file, line, func, sftp, path);
     }
     else
     {
@@ -1387,9 +1472,9 @@ void delegate_real_sftp_attributes_free(const char *file, const int line, const
 
 void mock_sftp_attributes_free(const char *file, const int line, const char *func, sftp_attributes attr)
 {
-    if (_mock_libssh != nullptr)
+    if (auto locked_libssh = _mock_libssh.lock())
     {
-        _mock_libssh->sftp_attributes_free(file, line, func, attr);
+        locked_libssh->sftp_attributes_free(file, line, func, attr);
     }
     else
     {
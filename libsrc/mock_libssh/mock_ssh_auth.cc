@@ -40,9 +40,9 @@ int mock_ssh_userauth_password(const char *file, const int line, const char *fun
 {
     int mock_ret;
 
-    if (_mock_libssh != nullptr)
+    if (auto locked_libssh = _mock_libssh.lock())
     {
-        mock_ret = _mock_libssh->ssh_userauth_password(file, line, func, session, username, password);
+        mock_ret = locked_libssh->ssh_userauth_password(file, line, func, session, username, password);
     }
     else
     {
@@ -102,9 +102,9 @@ int mock_ssh_userauth_publickey_auto(const char *file, const int line, const cha
 {
     int mock_ret;
 
-    if (_mock_libssh != nullptr)
+    if (auto locked_libssh = _mock_libssh.lock())
     {
-        mock_ret = _mock_libssh->ssh_userauth_publickey_auto(file, line, func, session, username, passphrase);
+        mock_ret = locked_libssh->ssh_userauth_publickey_auto(file, line, func, session, username, passphrase);
     }
     else
     {
@@ -39,9 +39,9 @@ ssh_channel mock_ssh_channel_new(const char *file, const int line, const char *f
 {
     ssh_channel channel;
 
-    if (_mock_libssh != nullptr)
+    if (auto locked_libssh = _mock_libssh.lock())
     {
-        channel = _mock_libssh->ssh_channel_new(file, line, func, session);
+        channel = locked_libssh->ssh_channel_new(file, line, func, session);
     }
     else
     {
@@ -102,9 +102,9 @@ void delegate_real_ssh_channel_free(const char *file, const int line, const char
 
 void mock_ssh_channel_free(const char *file, const int line, const char *func, ssh_channel channel)
 {
-    if (_mock_libssh != nullptr)
+    if (auto locked_libssh = _mock_libssh.lock())
     {
-        _mock_libssh->ssh_channel_free(file, line, func, channel);
+        locked_libssh->ssh_channel_free(file, line, func, channel);
     }
     else
     {
@@ -156,9 +156,9 @@ int mock_ssh_channel_open_session(const char *file, const int line, const char *
 {
     int mock_ret;
 
-    if (_mock_libssh != nullptr)
+    if (auto locked_libssh = _mock_libssh.lock())
     {
-        mock_ret = _mock_libssh->ssh_channel_open_session(file, line, func, channel);
+        mock_ret = locked_libssh->ssh_channel_open_session(file, line, func, channel);
     }
     else
     {
@@ -212,9 +212,9 @@ int mock_ssh_channel_close(const char *file, const int line, const char *func, s
 {
     int mock_ret;
 
-    if (_mock_libssh != nullptr)
+    if (auto locked_libssh = _mock_libssh.lock())
     {
-        mock_ret = _mock_libssh->ssh_channel_close(file, line, func, channel);
+        mock_ret = locked_libssh->ssh_channel_close(file, line, func, channel);
     }
     else
     {
@@ -272,9 +272,9 @@ int mock_ssh_channel_request_exec(const char *file, const int line, const char *
 {
     int mock_ret;
 
-    if (_mock_libssh != nullptr)
+    if (auto locked_libssh = _mock_libssh.lock())
     {
-        mock_ret = _mock_libssh->ssh_channel_request_exec(file, line, func, channel, cmd);
+        mock_ret = locked_libssh->ssh_channel_request_exec(file, line, func, channel, cmd);
     }
     else
     {
@@ -335,9 +335,9 @@ int mock_ssh_channel_read(const char *file, const int line, const char *func, ss
 {
     int mock_ret;
 
-    if (_mock_libssh != nullptr)
+    if (auto locked_libssh = _mock_libssh.lock())
     {
-        mock_ret = _mock_libssh->ssh_channel_read(file, line, func, channel, dest, count, is_stderr);
+        mock_ret = locked_libssh->ssh_channel_read(file, line, func, channel, dest, count, is_stderr);
     }
     else
     {
@@ -396,9 +396,9 @@ int mock_ssh_channel_write(const char *file, const int line, const char *func, s
 {
     int mock_ret;
 
-    if (_mock_libssh != nullptr)
+    if (auto locked_libssh = _mock_libssh.lock())
     {
-        mock_ret = _mock_libssh->ssh_channel_write(file, line, func, channel, data, len);
+        mock_ret = locked_libssh->ssh_channel_write(file, line, func, channel, data, len);
     }
     else
     {
@@ -452,9 +452,9 @@ int mock_ssh_channel_send_eof(const char *file, const int line, const char *func
 {
     int mock_ret;
 
-    if (_mock_libssh != nullptr)
+    if (auto locked_libssh = _mock_libssh.lock())
     {
-        mock_ret = _mock_libssh->ssh_channel_send_eof(file, line, func, channel);
+        mock_ret = locked_libssh->ssh_channel_send_eof(file, line, func, channel);
     }
     else
     {
@@ -509,9 +509,9 @@ int mock_ssh_channel_is_eof(const char *file, const int line, const char *func,
 {
     int mock_ret;
 
-    if (_mock_libssh != nullptr)
+    if (auto locked_libssh = _mock_libssh.lock())
     {
-        mock_ret = _mock_libssh->ssh_channel_is_eof(file, line, func, channel);
+        mock_ret = locked_libssh->ssh_channel_is_eof(file, line, func, channel);
     }
     else
     {
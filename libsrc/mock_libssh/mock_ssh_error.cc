@@ -37,9 +37,9 @@ const char *mock_ssh_get_error(const char *file, const int line, const char *fun
 {
     const char *mock_ret;
 
-    if (_mock_libssh != nullptr)
+    if (auto locked_libssh = _mock_libssh.lock())
     {
-        mock_ret = _mock_libssh->ssh_get_error(file, line, func, error);
+        mock_ret = locked_libssh->ssh_get_error(file, line, func, error);
     }
     else
     {
@@ -93,9 +93,9 @@ int mock_ssh_get_error_code(const char *file, const int line, const char *func,
 {
     int mock_ret;
 
-    if (_mock_libssh != nullptr)
+    if (auto locked_libssh = _mock_libssh.lock())
     {
-        mock_ret = _mock_libssh->ssh_get_error_code(file, line, func, error);
+        mock_ret = locked_libssh->ssh_get_error_code(file, line, func, error);
     }
     else
     {
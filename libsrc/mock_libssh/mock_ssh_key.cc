@@ -44,9 +44,9 @@ int mock_ssh_get_server_publickey(const char *file, const int line, const char *
 {
     int mock_ret;
 
-    if (_mock_libssh != nullptr)
+    if (auto locked_libssh = _mock_libssh.lock())
     {
-        mock_ret = _mock_libssh->ssh_get_server_publickey(file, line, func, session, key);
+        mock_ret = locked_libssh->ssh_get_server_publickey(file, line, func, session, key);
     }
     else
     {
@@ -114,9 +114,9 @@ int mock_ssh_get_publickey_hash(const char *file, const int line, const char *fu
 {
     int mock_ret;
 
-    if (_mock_libssh != nullptr)
+    if (auto locked_libssh = _mock_libssh.lock())
     {
-        mock_ret = _mock_libssh->ssh_get_publickey_hash(file, line, func, key, type, hash, hlen);
+        mock_ret = locked_libssh->ssh_get_publickey_hash(file, line, func, key, type, hash, hlen);
     }
     else
     {
@@ -170,9 +170,9 @@ void delegate_real_ssh_key_free(const char *file, const int line, const char *fu
 
 void mock_ssh_key_free(const char *file, const int line, const char *func, ssh_key key)
 {
-    if (_mock_libssh != nullptr)
+    if (auto locked_libssh = _mock_libssh.lock())
     {
-        _mock_libssh->ssh_key_free(file, line, func, key);
+        locked_libssh->ssh_key_free(file, line, func, key);
     }
     else
     {
@@ -228,9 +228,9 @@ enum ssh_known_hosts_e mock_ssh_session_is_known_server(const char *file, const
 {
     enum ssh_known_hosts_e mock_ret;
 
-    if (_mock_libssh != nullptr)
+    if (auto locked_libssh = _mock_libssh.lock())
     {
-        mock_ret = _mock_libssh->ssh_session_is_known_server(file, line, func, session);
+        mock_ret = locked_libssh->ssh_session_is_known_server(file, line, func, session);
     }
     else
     {
@@ -285,9 +285,9 @@ void delegate_real_ssh_clean_pubkey_hash(const char *file, const int line, const
 
 void mock_ssh_clean_pubkey_hash(const char *file, const int line, const char *func, unsigned char **hash)
 {
-    if (_mock_libssh != nullptr)
+    if (auto locked_libssh = _mock_libssh.lock())
     {
-        _mock_libssh->ssh_clean_pubkey_hash(file, line, func, hash);
+        locked_libssh->ssh_clean_pubkey_hash(file, line, func, hash);
     }
     else
     {
@@ -342,9 +342,9 @@ int mock_ssh_session_update_known_hosts(const char *file, const int line, const
 {
     int mock_ret;
 
-    if (_mock_libssh != nullptr)
+    if (auto locked_libssh = _mock_libssh.lock())
     {
-        mock_ret = _mock_libssh->ssh_session_update_known_hosts(file, line, func, session);
+        mock_ret = locked_libssh->ssh_session_update_known_hosts(file, line, func, session);
     }
     else
     {
@@ -401,9 +401,9 @@ void delegate_real_ssh_print_hash(const char *file, const int line, const char *
 void mock_ssh_print_hash(const char *file, const int line, const char *func, enum ssh_publickey_hash_type type,
                          unsigned char *hash, size_t len)
 {
-    if (_mock_libssh != nullptr)
+    if (auto locked_libssh = _mock_libssh.lock())
     {
-        _mock_libssh->ssh_print_hash(file, line, func, type, hash, len);
+        locked_libssh->ssh_print_hash(file, line, func, type, hash, len);
     }
     else
     {
@@ -38,9 +38,9 @@ ssh_session mock_ssh_new(const char *file, const int line, const char *func)
 {
     ssh_session session;
 
-    if (_mock_libssh != nullptr)
+    if (auto locked_libssh = _mock_libssh.lock())
     {
-        session = _mock_libssh->ssh_new(file, line, func);
+        session = locked_libssh->ssh_new(file, line, func);
     }
     else
     {
@@ -101,9 +101,9 @@ void delegate_real_ssh_free(const char *file, const int line, const char *func,
 
 void mock_ssh_free(const char *file, const int line, const char *func, ssh_session session)
 {
-    if (_mock_libssh != nullptr)
+    if (auto locked_libssh = _mock_libssh.lock())
     {
-        _mock_libssh->ssh_free(file, line, func, session);
+        locked_libssh->ssh_free(file, line, func, session);
     }
     else
     {
@@ -156,9 +156,9 @@ int mock_ssh_connect(const char *file, const int line, const char *func, ssh_ses
 {
     int mock_ret;
 
-    if (_mock_libssh != nullptr)
+    if (auto locked_libssh = _mock_libssh.lock())
     {
-        mock_ret = _mock_libssh->ssh_connect(file, line, func, session);
+        mock_ret = locked_libssh->ssh_connect(file, line, func, session);
     }
     else
     {
@@ -210,9 +210,9 @@ void delegate_real_ssh_disconnect(const char *file, const int line, const char *
 
 void mock_ssh_disconnect(const char *file, const int line, const char *func, ssh_session session)
 {
-    if (_mock_libssh != nullptr)
+    if (auto locked_libssh = _mock_libssh.lock())
     {
-        _mock_libssh->ssh_disconnect(file, line, func, session);
+        locked_libssh->ssh_disconnect(file, line, func, session);
     }
     else
     {
@@ -270,9 +270,9 @@ int mock_ssh_options_set(const char *file, const int line, const char *func, ssh
 {
     int mock_ret;
 
-    if (_mock_libssh != nullptr)
+    if (auto locked_libssh = _mock_libssh.lock())
     {
-        mock_ret = _mock_libssh->ssh_options_set(file, line, func, session, type, value);
+        mock_ret = locked_libssh->ssh_options_set(file, line, func, session, type, value);
     }
     else
     {
@@ -0,0 +1,950 @@
+/* libssh の SFTP の fake 関数の委譲先とするメモリー上の SFTP サーバー。
+ * ツリーは正規化した絶対パスからノードへの map で、ディレクトリの子は map の前方一致の範囲で列挙する。
+ * ノードは shared_ptr で共有し、開いているハンドルは unlink / rename の後も同じノードを読み書きする (POSIX と同じ)。
+ * ハンドルは従来の fake 関数と同じく malloc したブロックで、サーバーの破棄後に閉じる場合は従来の fake 関数が free する。 */
+
+#include <virtualSftpServer.h>
+#include <mock_instance.h>
+#include <test_com.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace testing
+{
+
+namespace
+{
+
+constexpr uint32_t SFTP_PERMISSION_MASK = 07777;
+constexpr uint32_t SFTP_MODE_DIRECTORY = 0040000;
+constexpr uint32_t SFTP_MODE_REGULAR = 0100000;
+constexpr uint32_t SFTP_OWNER_READ = 0400;
+constexpr uint32_t SFTP_OWNER_WRITE = 0200;
+constexpr uint32_t SFTP_OWNER_ID = 1000;
+constexpr uint64_t SFTP_DIRECTORY_SIZE = 4096;
+
+struct SftpNode
+{
+    bool directory;
+    uint32_t permissions; // 下位 12 ビット
+    string data;          // ファイルの内容
+    uint32_t atime;
+    uint32_t mtime;
+};
+
+struct SftpOpenFile
+{
+    shared_ptr<SftpNode> node;
+    string path;
+    sftp_session session;
+    uint64_t offset;
+    bool readable;
+    bool writable;
+    bool append;
+};
+
+struct SftpDirEntry
+{
+    string name;
+    SftpNode node; // opendir の時点の写し
+};
+
+struct SftpOpenDir
+{
+    vector<SftpDirEntry> entries;
+    size_t next;
+    string path;
+    sftp_session session;
+};
+
+struct SftpFailure
+{
+    int operations;
+    string path;
+    int sftp_error;
+    uint64_t remaining; // 残りの回数 (limited の場合)
+    bool limited;
+    uint64_t skip;      // 失敗させずに通す残りの回数
+};
+
+uint32_t nowSeconds()
+{
+    return (uint32_t)time(nullptr);
+}
+
+// "." / ".." / 連続する '/' を除いた絶対パスにする (相対パスは "/" から)
+string normalizeSftpPath(const string &path)
+{
+    vector<string> components;
+    size_t begin = 0;
+    while (begin <= path.size())
+    {
+        size_t end = path.find('/', begin);
+        if (end == string::npos)
+        {
+            end = path.size();
+        }
+        const string component = path.substr(begin, end - begin);
+        if (component == "..")
+        {
+            if (!components.empty())
+            {
+                components.pop_back();
+            }
+        }
+        else if (!component.empty() && component != ".")
+        {
+            components.push_back(component);
+        }
+        begin = end + 1;
+    }
+    string normalized;
+    for (const string &component : components)
+    {
+        normalized += "/" + component;
+    }
+    return normalized.empty() ? "/" : normalized;
+}
+
+string parentPath(const string &path)
+{
+    const size_t slash = path.rfind('/');
+    return slash == 0 || slash == string::npos ? "/" : path.substr(0, slash);
+}
+
+// path が root またはその配下か
+bool isWithin(const string &path, const string &root)
+{
+    if (root.empty() || root == "/" || path == root)
+    {
+        return true;
+    }
+    return path.size() > root.size() && path.compare(0, root.size(), root) == 0 && path[root.size()] == '/';
+}
+
+char *duplicateString(const string &text)
+{
+    char *copy = static_cast<char *>(malloc(text.size() + 1U));
+    if (copy != nullptr)
+    {
+        memcpy(copy, text.c_str(), text.size() + 1U);
+    }
+    return copy;
+}
+
+string permissionString(const SftpNode &node)
+{
+    static const char BITS[] = "rwxrwxrwx";
+    string text(node.directory ? "d" : "-");
+    for (int i = 0; i < 9; ++i)
+    {
+        text += (node.permissions & (0400U >> i)) != 0U ? BITS[i] : '-';
+    }
+    return text;
+}
+
+// sftp_attributes_free (fake) で解放できる属性を作成する
+sftp_attributes makeAttributes(const SftpNode &node, const string *name)
+{
+    sftp_attributes attr = static_cast<sftp_attributes>(calloc(1, sizeof(struct sftp_attributes_struct)));
+    if (attr == nullptr)
+    {
+        return nullptr;
+    }
+    const uint64_t size = node.directory ? SFTP_DIRECTORY_SIZE : (uint64_t)node.data.size();
+    attr->flags = SSH_FILEXFER_ATTR_SIZE | SSH_FILEXFER_ATTR_UIDGID | SSH_FILEXFER_ATTR_PERMISSIONS |
+                  SSH_FILEXFER_ATTR_ACMODTIME;
+    attr->type = node.directory ? SSH_FILEXFER_TYPE_DIRECTORY : SSH_FILEXFER_TYPE_REGULAR;
+    attr->size = size;
+    attr->uid = SFTP_OWNER_ID;
+    attr->gid = SFTP_OWNER_ID;
+    attr->permissions = (node.directory ? SFTP_MODE_DIRECTORY : SFTP_MODE_REGULAR) | node.permissions;
+    attr->atime = node.atime;
+    attr->atime64 = node.atime;
+    attr->mtime = node.mtime;
+    attr->mtime64 = node.mtime;
+    if (name != nullptr)
+    {
+        char longname[512];
+        snprintf(longname, sizeof(longname), "%s    1 sftp     sftp     %12llu %s", permissionString(node).c_str(),
+                 (unsigned long long)size, name->c_str());
+        attr->name = duplicateString(*name);
+        attr->longname = duplicateString(longname);
+        attr->owner = duplicateString("sftp");
+        attr->group = duplicateString("sftp");
+    }
+    return attr;
+}
+
+} // namespace
+
+struct VirtualSftpServerState
+{
+    VirtualSftpServerState()
+    {
+        const uint32_t now = nowSeconds();
+        nodes["/"] = make_shared<SftpNode>(SftpNode{true, 0755, string(), now, now});
+    }
+
+    shared_ptr<SftpNode> findLocked(const string &path) const
+    {
+        auto it = nodes.find(path);
+        return it == nodes.end() ? nullptr : it->second;
+    }
+
+    // path までの途中のディレクトリを作成する
+    void makeParentsLocked(const string &path)
+    {
+        const string parent = parentPath(path);
+        if (parent == path || findLocked(parent) != nullptr)
+        {
+            return;
+        }
+        makeParentsLocked(parent);
+        const uint32_t now = nowSeconds();
+        nodes[parent] = make_shared<SftpNode>(SftpNode{true, 0755, string(), now, now});
+    }
+
+    void setErrorLocked(sftp_session session, int sftp_error)
+    {
+        if (session != nullptr)
+        {
+            errors[session] = sftp_error;
+        }
+    }
+
+    // 失敗させる場合に session のエラーを設定して true を返す
+    bool injectLocked(int operation, const string &path, sftp_session session)
+    {
+        for (SftpFailure &failure : failures)
+        {
+            if ((failure.operations & operation) == 0 || !isWithin(path, failure.path))
+            {
+                continue;
+            }
+            if (failure.skip > 0U)
+            {
+                --failure.skip;
+                continue;
+            }
+            if (failure.limited)
+            {
+                if (failure.remaining == 0U)
+                {
+                    continue;
+                }
+                --failure.remaining;
+            }
+            ++stats.injected_errors;
+            setErrorLocked(session, failure.sftp_error);
+            return true;
+        }
+        return false;
+    }
+
+    // 新しいエントリー path を作成できるか (失敗時は SSH_FX_* を返す)
+    int checkCreatableLocked(const string &path) const
+    {
+        const shared_ptr<SftpNode> parent = findLocked(parentPath(path));
+        if (parent == nullptr || !parent->directory)
+        {
+            return SSH_FX_NO_SUCH_FILE;
+        }
+        if ((parent->permissions & SFTP_OWNER_WRITE) == 0U)
+        {
+            return SSH_FX_PERMISSION_DENIED;
+        }
+        return SSH_FX_OK;
+    }
+
+    mutable std::mutex mtx;
+    map<string, shared_ptr<SftpNode>> nodes;
+    unordered_map<sftp_session, int> errors; // sftp_get_error の値
+    unordered_map<sftp_file, SftpOpenFile> files;
+    unordered_map<sftp_dir, SftpOpenDir> dirs;
+    vector<SftpFailure> failures;
+    size_t max_transfer = 0;
+    VirtualSftpStats stats;
+};
+
+namespace
+{
+
+testfw::MockSlot<VirtualSftpServerState> s_sftp_server;
+
+} // namespace
+
+VirtualSftpServer::VirtualSftpServer() : state_(new VirtualSftpServerState())
+{
+    if (s_sftp_server.get() != nullptr)
+    {
+        ADD_FAILURE() << "Only one VirtualSftpServer may exist at a time.";
+        return;
+    }
+    s_sftp_server.publish(state_.get());
+}
+
+VirtualSftpServer::~VirtualSftpServer()
+{
+    if (s_sftp_server.get() != state_.get())
+    {
+        return;
+    }
+    if (!s_sftp_server.retire(state_.get(), testfw::internal::kMockRetireTimeout))
+    {
+        ADD_FAILURE() << "Mock calls did not finish within " << testfw::internal::kMockRetireTimeout.count()
+                      << " ms while destroying VirtualSftpServer.";
+        // SFTP の操作中のスレッドが参照している可能性があるため解放しない
+        (void)state_.release();
+    }
+}
+
+VirtualSftpServer &VirtualSftpServer::addDirectory(const string &path, uint32_t permissions)
+{
+    const string normalized = normalizeSftpPath(path);
+    std::lock_guard<std::mutex> lock(state_->mtx);
+    state_->makeParentsLocked(normalized);
+    shared_ptr<SftpNode> &node = state_->nodes[normalized];
+    const uint32_t now = nowSeconds();
+    if (node == nullptr || !node->directory)
+    {
+        node = make_shared<SftpNode>(SftpNode{true, 0, string(), now, now});
+    }
+    node->permissions = permissions & SFTP_PERMISSION_MASK;
+    return *this;
+}
+
+VirtualSftpServer &VirtualSftpServer::addFile(const string &path, const string &content, uint32_t permissions)
+{
+    const string normalized = normalizeSftpPath(path);
+    if (normalized == "/")
+    {
+        ADD_FAILURE() << "VirtualSftpServer::addFile() cannot replace the root directory.";
+        return *this;
+    }
+    std::lock_guard<std::mutex> lock(state_->mtx);
+    state_->makeParentsLocked(normalized);
+    const uint32_t now = nowSeconds();
+    state_->nodes[normalized] =
+        make_shared<SftpNode>(SftpNode{false, permissions & SFTP_PERMISSION_MASK, content, now, now});
+    return *this;
+}
+
+bool VirtualSftpServer::setPermissions(const string &path, uint32_t permissions)
+{
+    std::lock_guard<std::mutex> lock(state_->mtx);
+    const shared_ptr<SftpNode> node = state_->findLocked(normalizeSftpPath(path));
+    if (node == nullptr)
+    {
+        return false;
+    }
+    node->permissions = permissions & SFTP_PERMISSION_MASK;
+    return true;
+}
+
+bool VirtualSftpServer::readFile(const string &path, string *content) const
+{
+    std::lock_guard<std::mutex> lock(state_->mtx);
+    const shared_ptr<SftpNode> node = state_->findLocked(normalizeSftpPath(path));
+    if (node == nullptr || node->directory)
+    {
+        return false;
+    }
+    *content = node->data;
+    return true;
+}
+
+bool VirtualSftpServer::exists(const string &path) const
+{
+    std::lock_guard<std::mutex> lock(state_->mtx);
+    return state_->findLocked(normalizeSftpPath(path)) != nullptr;
+}
+
+VirtualSftpServer &VirtualSftpServer::failOperation(int operations, const string &path, int sftp_error, uint64_t count,
+                                                    uint64_t skip)
+{
+    std::lock_guard<std::mutex> lock(state_->mtx);
+    state_->failures.push_back(SftpFailure{operations, path.empty() ? string() : normalizeSftpPath(path), sftp_error,
+                                           count, count != 0U, skip});
+    return *this;
+}
+
+VirtualSftpServer &VirtualSftpServer::limitTransferSize(size_t max_bytes)
+{
+    std::lock_guard<std::mutex> lock(state_->mtx);
+    state_->max_transfer = max_bytes;
+    return *this;
+}
+
+VirtualSftpStats VirtualSftpServer::stats() const
+{
+    std::lock_guard<std::mutex> lock(state_->mtx);
+    VirtualSftpStats stats = state_->stats;
+    stats.open_handles = state_->files.size() + state_->dirs.size();
+    return stats;
+}
+
+bool virtualSftpGetError(sftp_session sftp, int *result)
+{
+    auto server = s_sftp_server.lock();
+    if (!server)
+    {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(server->mtx);
+    auto it = server->errors.find(sftp);
+    *result = it == server->errors.end() ? SSH_FX_OK : it->second;
+    return true;
+}
+
+void virtualSftpForgetSession(sftp_session sftp)
+{
+    if (auto server = s_sftp_server.lock())
+    {
+        std::lock_guard<std::mutex> lock(server->mtx);
+        (void)server->errors.erase(sftp);
+    }
+}
+
+bool virtualSftpOpen(sftp_session sftp, const char *path, int accesstype, mode_t mode, sftp_file *result)
+{
+    auto server = s_sftp_server.lock();
+    if (!server)
+    {
+        return false;
+    }
+    const string normalized = normalizeSftpPath(path != nullptr ? path : "");
+    const bool readable = (accesstype & O_WRONLY) == 0;
+    const bool writable = (accesstype & (O_WRONLY | O_RDWR)) != 0;
+    *result = nullptr;
+
+    std::lock_guard<std::mutex> lock(server->mtx);
+    if (server->injectLocked(SFTP_OP_OPEN, normalized, sftp))
+    {
+        return true;
+    }
+    shared_ptr<SftpNode> node = server->findLocked(normalized);
+    if (node != nullptr)
+    {
+        if ((accesstype & O_CREAT) != 0 && (accesstype & O_EXCL) != 0)
+        {
+            server->setErrorLocked(sftp, SSH_FX_FILE_ALREADY_EXISTS);
+            return true;
+        }
+        if (node->directory)
+        {
+            server->setErrorLocked(sftp, SSH_FX_FAILURE);
+            return true;
+        }
+        if ((readable && (node->permissions & SFTP_OWNER_READ) == 0U) ||
+            (writable && (node->permissions & SFTP_OWNER_WRITE) == 0U))
+        {
+            server->setErrorLocked(sftp, SSH_FX_PERMISSION_DENIED);
+            return true;
+        }
+        if (writable && (accesstype & O_TRUNC) != 0)
+        {
+            node->data.clear();
+            node->mtime = nowSeconds();
+        }
+    }
+    else
+    {
+        if ((accesstype & O_CREAT) == 0)
+        {
+            server->setErrorLocked(sftp, SSH_FX_NO_SUCH_FILE);
+            return true;
+        }
+        const int error = server->checkCreatableLocked(normalized);
+        if (error != SSH_FX_OK)
+        {
+            server->setErrorLocked(sftp, error);
+            return true;
+        }
+        const uint32_t now = nowSeconds();
+        node = make_shared<SftpNode>(SftpNode{false, (uint32_t)mode & SFTP_PERMISSION_MASK, string(), now, now});
+        server->nodes[normalized] = node;
+    }
+
+    sftp_file handle = static_cast<sftp_file>(malloc(sizeof(struct sftp_file_struct *)));
+    if (handle == nullptr)
+    {
+        server->setErrorLocked(sftp, SSH_FX_FAILURE);
+        return true;
+    }
+    server->files[handle] =
+        SftpOpenFile{node, normalized, sftp, 0, readable, writable, (accesstype & O_APPEND) != 0};
+    ++server->stats.opens;
+    server->setErrorLocked(sftp, SSH_FX_OK);
+    *result = handle;
+    return true;
+}
+
+bool virtualSftpClose(sftp_file file, int *result)
+{
+    auto server = s_sftp_server.lock();
+    if (!server)
+    {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(server->mtx);
+    auto it = server->files.find(file);
+    if (it == server->files.end())
+    {
+        return false;
+    }
+    *result = server->injectLocked(SFTP_OP_CLOSE, it->second.path, it->second.session) ? SSH_ERROR : SSH_OK;
+    server->files.erase(it);
+    free(file);
+    return true;
+}
+
+bool virtualSftpRead(sftp_file file, void *buf, size_t count, ssize_t *result)
+{
+    auto server = s_sftp_server.lock();
+    if (!server)
+    {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(server->mtx);
+    auto it = server->files.find(file);
+    if (it == server->files.end())
+    {
+        return false;
+    }
+    SftpOpenFile &open_file = it->second;
+    *result = -1;
+    if (server->injectLocked(SFTP_OP_READ, open_file.path, open_file.session))
+    {
+        return true;
+    }
+    if (!open_file.readable)
+    {
+        server->setErrorLocked(open_file.session, SSH_FX_PERMISSION_DENIED);
+        return true;
+    }
+    const string &data = open_file.node->data;
+    size_t length = open_file.offset >= data.size() ? 0U : std::min(count, (size_t)(data.size() - open_file.offset));
+    if (server->max_transfer != 0U)
+    {
+        length = std::min(length, server->max_transfer);
+    }
+    if (length == 0U)
+    {
+        server->setErrorLocked(open_file.session, SSH_FX_EOF);
+        *result = 0;
+        return true;
+    }
+    memcpy(buf, data.data() + open_file.offset, length);
+    open_file.offset += length;
+    open_file.node->atime = nowSeconds();
+    ++server->stats.read_calls;
+    server->stats.bytes_read += length;
+    *result = (ssize_t)length;
+    return true;
+}
+
+bool virtualSftpWrite(sftp_file file, const void *buf, size_t count, ssize_t *result)
+{
+    auto server = s_sftp_server.lock();
+    if (!server)
+    {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(server->mtx);
+    auto it = server->files.find(file);
+    if (it == server->files.end())
+    {
+        return false;
+    }
+    SftpOpenFile &open_file = it->second;
+    *result = -1;
+    if (server->injectLocked(SFTP_OP_WRITE, open_file.path, open_file.session))
+    {
+        return true;
+    }
+    if (!open_file.writable)
+    {
+        server->setErrorLocked(open_file.session, SSH_FX_PERMISSION_DENIED);
+        return true;
+    }
+    string &data = open_file.node->data;
+    if (open_file.append)
+    {
+        open_file.offset = data.size();
+    }
+    const size_t length = server->max_transfer != 0U ? std::min(count, server->max_transfer) : count;
+    if (data.size() < open_file.offset + length)
+    {
+        data.resize((size_t)(open_file.offset + length), '\0');
+    }
+    memcpy(&data[(size_t)open_file.offset], buf, length);
+    open_file.offset += length;
+    open_file.node->mtime = nowSeconds();
+    ++server->stats.write_calls;
+    server->stats.bytes_written += length;
+    *result = (ssize_t)length;
+    return true;
+}
+
+bool virtualSftpSeek(sftp_file file, uint64_t offset, int *result)
+{
+    auto server = s_sftp_server.lock();
+    if (!server)
+    {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(server->mtx);
+    auto it = server->files.find(file);
+    if (it == server->files.end())
+    {
+        return false;
+    }
+    it->second.offset = offset;
+    *result = 0;
+    return true;
+}
+
+bool virtualSftpTell(sftp_file file, uint64_t *result)
+{
+    auto server = s_sftp_server.lock();
+    if (!server)
+    {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(server->mtx);
+    auto it = server->files.find(file);
+    if (it == server->files.end())
+    {
+        return false;
+    }
+    *result = it->second.offset;
+    return true;
+}
+
+bool virtualSftpFstat(sftp_file file, sftp_attributes *result)
+{
+    auto server = s_sftp_server.lock();
+    if (!server)
+    {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(server->mtx);
+    auto it = server->files.find(file);
+    if (it == server->files.end())
+    {
+        return false;
+    }
+    *result = server->injectLocked(SFTP_OP_STAT, it->second.path, it->second.session)
+                  ? nullptr
+                  : makeAttributes(*it->second.node, nullptr);
+    return true;
+}
+
+bool virtualSftpOpendir(sftp_session sftp, const char *path, sftp_dir *result)
+{
+    auto server = s_sftp_server.lock();
+    if (!server)
+    {
+        return false;
+    }
+    const string normalized = normalizeSftpPath(path != nullptr ? path : "");
+    *result = nullptr;
+
+    std::lock_guard<std::mutex> lock(server->mtx);
+    if (server->injectLocked(SFTP_OP_OPENDIR, normalized, sftp))
+    {
+        return true;
+    }
+    const shared_ptr<SftpNode> node = server->findLocked(normalized);
+    if (node == nullptr)
+    {
+        server->setErrorLocked(sftp, SSH_FX_NO_SUCH_FILE);
+        return true;
+    }
+    if (!node->directory)
+    {
+        server->setErrorLocked(sftp, SSH_FX_FAILURE);
+        return true;
+    }
+    if ((node->permissions & SFTP_OWNER_READ) == 0U)
+    {
+        server->setErrorLocked(sftp, SSH_FX_PERMISSION_DENIED);
+        return true;
+    }
+
+    // "." / ".." の後に、子を名前順に列挙する
+    SftpOpenDir open_dir{vector<SftpDirEntry>(), 0, normalized, sftp};
+    open_dir.entries.push_back(SftpDirEntry{".", *node});
+    open_dir.entries.push_back(SftpDirEntry{"..", *server->findLocked(parentPath(normalized))});
+    const string prefix = normalized == "/" ? "/" : normalized + "/";
+    for (auto it = server->nodes.lower_bound(prefix); it != server->nodes.end(); ++it)
+    {
+        if (it->first.compare(0, prefix.size(), prefix) != 0)
+        {
+            break;
+        }
+        if (it->first.size() > prefix.size() && it->first.find('/', prefix.size()) == string::npos)
+        {
+            open_dir.entries.push_back(SftpDirEntry{it->first.substr(prefix.size()), *it->second});
+        }
+    }
+
+    sftp_dir handle = static_cast<sftp_dir>(malloc(sizeof(struct sftp_dir_struct *)));
+    if (handle == nullptr)
+    {
+        server->setErrorLocked(sftp, SSH_FX_FAILURE);
+        return true;
+    }
+    server->dirs[handle] = std::move(open_dir);
+    server->setErrorLocked(sftp, SSH_FX_OK);
+    *result = handle;
+    return true;
+}
+
+bool virtualSftpReaddir(sftp_dir dir, sftp_attributes *result)
+{
+    auto server = s_sftp_server.lock();
+    if (!server)
+    {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(server->mtx);
+    auto it = server->dirs.find(dir);
+    if (it == server->dirs.end())
+    {
+        return false;
+    }
+    SftpOpenDir &open_dir = it->second;
+    *result = nullptr;
+    if (server->injectLocked(SFTP_OP_READDIR, open_dir.path, open_dir.session))
+    {
+        return true;
+    }
+    if (open_dir.next >= open_dir.entries.size())
+    {
+        server->setErrorLocked(open_dir.session, SSH_FX_EOF);
+        return true;
+    }
+    const SftpDirEntry &entry = open_dir.entries[open_dir.next++];
+    *result = makeAttributes(entry.node, &entry.name);
+    return true;
+}
+
+bool virtualSftpClosedir(sftp_dir dir, int *result)
+{
+    auto server = s_sftp_server.lock();
+    if (!server)
+    {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(server->mtx);
+    if (server->dirs.erase(dir) == 0U)
+    {
+        return false;
+    }
+    free(dir);
+    *result = SSH_OK;
+    return true;
+}
+
+bool virtualSftpMkdir(sftp_session sftp, const char *path, mode_t mode, int *result)
+{
+    auto server = s_sftp_server.lock();
+    if (!server)
+    {
+        return false;
+    }
+    const string normalized = normalizeSftpPath(path != nullptr ? path : "");
+    *result = -1;
+
+    std::lock_guard<std::mutex> lock(server->mtx);
+    if (server->injectLocked(SFTP_OP_MKDIR, normalized, sftp))
+    {
+        return true;
+    }
+    if (server->findLocked(normalized) != nullptr)
+    {
+        server->setErrorLocked(sftp, SSH_FX_FILE_ALREADY_EXISTS);
+        return true;
+    }
+    const int error = server->checkCreatableLocked(normalized);
+    if (error != SSH_FX_OK)
+    {
+        server->setErrorLocked(sftp, error);
+        return true;
+    }
+    const uint32_t now = nowSeconds();
+    server->nodes[normalized] =
+        make_shared<SftpNode>(SftpNode{true, (uint32_t)mode & SFTP_PERMISSION_MASK, string(), now, now});
+    server->setErrorLocked(sftp, SSH_FX_OK);
+    *result = 0;
+    return true;
+}
+
+bool virtualSftpRmdir(sftp_session sftp, const char *path, int *result)
+{
+    auto server = s_sftp_server.lock();
+    if (!server)
+    {
+        return false;
+    }
+    const string normalized = normalizeSftpPath(path != nullptr ? path : "");
+    *result = -1;
+
+    std::lock_guard<std::mutex> lock(server->mtx);
+    if (server->injectLocked(SFTP_OP_RMDIR, normalized, sftp))
+    {
+        return true;
+    }
+    const shared_ptr<SftpNode> node = server->findLocked(normalized);
+    if (node == nullptr)
+    {
+        server->setErrorLocked(sftp, SSH_FX_NO_SUCH_FILE);
+        return true;
+    }
+    auto child = server->nodes.lower_bound(normalized + "/");
+    if (!node->directory || normalized == "/" ||
+        (child != server->nodes.end() && isWithin(child->first, normalized)))
+    {
+        server->setErrorLocked(sftp, SSH_FX_FAILURE);
+        return true;
+    }
+    if ((server->findLocked(parentPath(normalized))->permissions & SFTP_OWNER_WRITE) == 0U)
+    {
+        server->setErrorLocked(sftp, SSH_FX_PERMISSION_DENIED);
+        return true;
+    }
+    (void)server->nodes.erase(normalized);
+    server->setErrorLocked(sftp, SSH_FX_OK);
+    *result = 0;
+    return true;
+}
+
+bool virtualSftpUnlink(sftp_session sftp, const char *path, int *result)
+{
+    auto server = s_sftp_server.lock();
+    if (!server)
+    {
+        return false;
+    }
+    const string normalized = normalizeSftpPath(path != nullptr ? path : "");
+    *result = -1;
+
+    std::lock_guard<std::mutex> lock(server->mtx);
+    if (server->injectLocked(SFTP_OP_UNLINK, normalized, sftp))
+    {
+        return true;
+    }
+    const shared_ptr<SftpNode> node = server->findLocked(normalized);
+    if (node == nullptr)
+    {
+        server->setErrorLocked(sftp, SSH_FX_NO_SUCH_FILE);
+        return true;
+    }
+    if (node->directory)
+    {
+        server->setErrorLocked(sftp, SSH_FX_FAILURE);
+        return true;
+    }
+    if ((server->findLocked(parentPath(normalized))->permissions & SFTP_OWNER_WRITE) == 0U)
+    {
+        server->setErrorLocked(sftp, SSH_FX_PERMISSION_DENIED);
+        return true;
+    }
+    (void)server->nodes.erase(normalized);
+    server->setErrorLocked(sftp, SSH_FX_OK);
+    *result = 0;
+    return true;
+}
+
+bool virtualSftpRename(sftp_session sftp, const char *original, const char *newname, int *result)
+{
+    auto server = s_sftp_server.lock();
+    if (!server)
+    {
+        return false;
+    }
+    const string from = normalizeSftpPath(original != nullptr ? original : "");
+    const string to = normalizeSftpPath(newname != nullptr ? newname : "");
+    *result = -1;
+
+    std::lock_guard<std::mutex> lock(server->mtx);
+    if (server->injectLocked(SFTP_OP_RENAME, from, sftp))
+    {
+        return true;
+    }
+    if (server->findLocked(from) == nullptr)
+    {
+        server->setErrorLocked(sftp, SSH_FX_NO_SUCH_FILE);
+        return true;
+    }
+    // SFTP v3 の rename は既存のパスを置き換えない
+    if (from == "/" || server->findLocked(to) != nullptr || isWithin(to, from))
+    {
+        server->setErrorLocked(sftp, SSH_FX_FAILURE);
+        return true;
+    }
+    int error = server->checkCreatableLocked(to);
+    if (error == SSH_FX_OK && (server->findLocked(parentPath(from))->permissions & SFTP_OWNER_WRITE) == 0U)
+    {
+        error = SSH_FX_PERMISSION_DENIED;
+    }
+    if (error != SSH_FX_OK)
+    {
+        server->setErrorLocked(sftp, error);
+        return true;
+    }
+
+    // from とその配下を移動する
+    vector<pair<string, shared_ptr<SftpNode>>> moved{{to, server->findLocked(from)}};
+    (void)server->nodes.erase(from);
+    for (auto it = server->nodes.lower_bound(from + "/"); it != server->nodes.end() && isWithin(it->first, from);)
+    {
+        moved.emplace_back(to + it->first.substr(from.size()), it->second);
+        it = server->nodes.erase(it);
+    }
+    for (auto &entry : moved)
+    {
+        server->nodes[entry.first] = entry.second;
+    }
+    server->setErrorLocked(sftp, SSH_FX_OK);
+    *result = 0;
+    return true;
+}
+
+bool virtualSftpStat(sftp_session sftp, const char *path, sftp_attributes *result)
+{
+    auto server = s_sftp_server.lock();
+    if (!server)
+    {
+        return false;
+    }
+    const string normalized = normalizeSftpPath(path != nullptr ? path : "");
+    *result = nullptr;
+
+    std::lock_guard<std::mutex> lock(server->mtx);
+    if (server->injectLocked(SFTP_OP_STAT, normalized, sftp))
+    {
+        return true;
+    }
+    const shared_ptr<SftpNode> node = server->findLocked(normalized);
+    if (node == nullptr)
+    {
+        server->setErrorLocked(sftp, SSH_FX_NO_SUCH_FILE);
+        return true;
+    }
+    server->setErrorLocked(sftp, SSH_FX_OK);
+    *result = makeAttributes(*node, nullptr);
+    return true;
+}
+
+} // namespace testing
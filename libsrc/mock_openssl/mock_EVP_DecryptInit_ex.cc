@@ -17,9 +17,9 @@ int mock_EVP_DecryptInit_ex(const char *file, const int line, const char *func,
 {
     int mock_ret;
 
-    if (_mock_openssl != nullptr)
+    if (auto locked_openssl = _mock_openssl.lock())
     {
-        mock_ret = _mock_openssl->EVP_DecryptInit_ex(file, line, func, ctx, type, impl, key, iv);
+        mock_ret = locked_openssl->EVP_DecryptInit_ex(file, line, func, ctx, type, impl, key, iv);
     }
     else
     {
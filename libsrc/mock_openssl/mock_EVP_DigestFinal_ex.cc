@@ -17,9 +17,9 @@ int mock_EVP_DigestFinal_ex(const char *file, const int line, const char *func,
 {
     int mock_ret;
 
-    if (_mock_openssl != nullptr)
+    if (auto locked_openssl = _mock_openssl.lock())
     {
-        mock_ret = _mock_openssl->EVP_DigestFinal_ex(file, line, func, ctx, md, s);
+        mock_ret = locked_openssl->EVP_DigestFinal_ex(file, line, func, ctx, md, s);
     }
     else
     {
@@ -17,9 +17,9 @@ int mock_EVP_DigestInit_ex(const char *file, const int line, const char *func, E
 {
     int mock_ret;
 
-    if (_mock_openssl != nullptr)
+    if (auto locked_openssl = _mock_openssl.lock())
     {
-        mock_ret = _mock_openssl->EVP_DigestInit_ex(file, line, func, ctx, type, impl);
+        mock_ret = locked_openssl->EVP_DigestInit_ex(file, line, func, ctx, type, impl);
     }
     else
     {
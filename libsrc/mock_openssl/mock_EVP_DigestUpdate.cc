@@ -17,9 +17,9 @@ int mock_EVP_DigestUpdate(const char *file, const int line, const char *func, EV
 {
     int mock_ret;
 
-    if (_mock_openssl != nullptr)
+    if (auto locked_openssl = _mock_openssl.lock())
     {
-        mock_ret = _mock_openssl->EVP_DigestUpdate(file, line, func, ctx, d, cnt);
+        mock_ret = locked_openssl->EVP_DigestUpdate(file, line, func, ctx, d, cnt);
     }
     else
     {
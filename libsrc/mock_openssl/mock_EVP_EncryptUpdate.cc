@@ -17,9 +17,9 @@ int mock_EVP_EncryptUpdate(const char *file, const int line, const char *func, E
 {
     int mock_ret;
 
-    if (_mock_openssl != nullptr)
+    if (auto locked_openssl = _mock_openssl.lock())
     {
-        mock_ret = _mock_openssl->EVP_EncryptUpdate(file, line, func, ctx, out, outl, in, inl);
+        mock_ret = locked_openssl->EVP_EncryptUpdate(file, line, func, ctx, out, outl, in, inl);
     }
     else
     {
@@ -17,9 +17,9 @@ EVP_MD_CTX *mock_EVP_MD_CTX_new(const char *file, const int line, const char *fu
 {
     EVP_MD_CTX *mock_ret;
 
-    if (_mock_openssl != nullptr)
+    if (auto locked_openssl = _mock_openssl.lock())
     {
-        mock_ret = _mock_openssl->EVP_MD_CTX_new(file, line, func);
+        mock_ret = locked_openssl->EVP_MD_CTX_new(file, line, func);
     }
     else
     {
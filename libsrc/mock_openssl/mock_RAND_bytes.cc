@@ -17,9 +17,9 @@ int mock_RAND_bytes(const char *file, const int line, const char *func, unsigned
 {
     int mock_ret;
 
-    if (_mock_openssl != nullptr)
+    if (auto locked_openssl = _mock_openssl.lock())
     {
-        mock_ret = _mock_openssl->RAND_bytes(file, line, func, buf, num);
+        mock_ret = locked_openssl->RAND_bytes(file, line, func, buf, num);
     }
     else
     {
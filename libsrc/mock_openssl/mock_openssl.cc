@@ -3,7 +3,7 @@
 
 using namespace testing;
 
-Mock_openssl *_mock_openssl = nullptr;
+testfw::MockSlot<Mock_openssl> _mock_openssl;
 
 Mock_openssl::Mock_openssl()
 {
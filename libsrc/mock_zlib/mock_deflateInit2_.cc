@@ -20,9 +20,9 @@ int mock_deflateInit2_(const char *file, const int line, const char *func, z_str
 {
     int mock_ret;
 
-    if (_mock_zlib != nullptr)
+    if (auto locked_zlib = _mock_zlib.lock())
     {
-        mock_ret = _mock_zlib->deflateInit2_(file, line, func, strm, level, method, windowBits, memLevel, strategy,
+        mock_ret = locked_zlib->deflateInit2_(file, line, func, strm, level, method, windowBits, memLevel, strategy,
                                            version, stream_size);
     }
     else
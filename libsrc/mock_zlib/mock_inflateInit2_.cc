@@ -19,9 +19,9 @@ int mock_inflateInit2_(const char *file, const int line, const char *func, z_str
 {
     int mock_ret;
 
-    if (_mock_zlib != nullptr)
+    if (auto locked_zlib = _mock_zlib.lock())
     {
-        mock_ret = _mock_zlib->inflateInit2_(file, line, func, strm, windowBits, version, stream_size);
+        mock_ret = locked_zlib->inflateInit2_(file, line, func, strm, windowBits, version, stream_size);
     }
     else
     {
@@ -3,7 +3,7 @@
 
 using namespace testing;
 
-Mock_zlib *_mock_zlib = nullptr;
+testfw::MockSlot<Mock_zlib> _mock_zlib;
 
 Mock_zlib::Mock_zlib()
 {
@@ -0,0 +1,666 @@
+/* mock_malloc などの確保先とするテスト用のバンプ アロケーター。
+ * チャンクはチャンク サイズ境界に揃えて OS から直接取得し、reset() 後はアクセス不可にして保持する
+ * (解放済みの領域を別の確保が再利用しないため、reset() 後の使用を確実に検出できる)。
+ * ARENA_RESET_RECYCLE では、reset() 後のチャンクを以降の確保に再利用する。
+ * 確保はスレッドごとのチャンクから切り出し、free はチャンクのアドレス表を参照するのみで、いずれもロックを取得しない。
+ * ロックを取得するのはチャンクの追加と reset() のみ。 */
+
+#include <allocationArena.h>
+#include <allocationTracker.h>
+#include <mock_instance.h>
+#include <test_com.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#ifndef _WIN32
+    #include <sys/mman.h>
+    #include <unistd.h>
+#else
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+    #ifdef byte
+        #undef byte
+    #endif
+#endif
+
+namespace testing
+{
+
+namespace
+{
+
+// アクセス不可として保持するチャンク数の上限。超えた場合は古いものから返却する
+constexpr size_t MAX_QUARANTINED_CHUNKS = 256;
+
+// チャンクのアドレス表の容量 (2 のべき乗)。使用中とアクセス不可のチャンクの合計はこの半分までとする
+constexpr size_t ARENA_TABLE_CAPACITY = size_t{1} << 16;
+constexpr size_t MIN_CHUNK_SIZE = size_t{64} * 1024;
+
+// アドレス表の要素。チャンクの先頭アドレス (MIN_CHUNK_SIZE 境界) の下位ビットに状態を持つ
+constexpr uintptr_t ARENA_ENTRY_EMPTY = 0U;
+constexpr uintptr_t ARENA_ENTRY_TOMBSTONE = 1U;
+constexpr uintptr_t ARENA_ENTRY_LIVE = 2U;
+constexpr uintptr_t ARENA_ENTRY_QUARANTINED = 4U;
+constexpr uintptr_t ARENA_ENTRY_FLAGS = 7U;
+
+constexpr uint32_t ARENA_BLOCK_MAGIC = 0x41524e41U;
+constexpr uint32_t ARENA_BLOCK_LIVE = 1U;
+constexpr uint32_t ARENA_BLOCK_FREED = 2U;
+
+// 各ブロックの直前に置くヘッダー。16 バイトとして、ブロックを 16 バイト境界に揃える
+struct ArenaBlockHeader
+{
+    uint64_t size;
+    uint32_t magic;
+    uint32_t state;
+};
+static_assert(sizeof(ArenaBlockHeader) == 16, "ArenaBlockHeader must keep 16-byte alignment");
+
+constexpr size_t ARENA_ALIGNMENT = sizeof(ArenaBlockHeader);
+
+struct ArenaChunk
+{
+    char *base;
+    size_t size;
+    bool quarantined;
+};
+
+// releaseChunks() でのチャンクの扱い
+enum ArenaRelease
+{
+    ARENA_RELEASE_UNMAP,
+    ARENA_RELEASE_QUARANTINE,
+    ARENA_RELEASE_RECYCLE
+};
+
+// スレッドが切り出し中のチャンク。generation が AllocationArenaState と一致する間のみ有効
+struct ThreadArenaCache
+{
+    uint64_t generation;
+    char *cursor;
+    char *limit;
+    bool recycled; // 再利用したチャンク (0 で初期化されていない)
+};
+
+thread_local ThreadArenaCache t_arena_cache = {0U, nullptr, nullptr, false};
+
+// AllocationArena の生成と reset() ごとに採番する (0 は未使用)
+std::atomic<uint64_t> s_arena_generation{0U};
+
+size_t getPageSize()
+{
+#ifndef _WIN32
+    static const size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+#else
+    static const size_t page_size = []() {
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        return (size_t)info.dwPageSize;
+    }();
+#endif
+    return page_size;
+}
+
+size_t roundUp(size_t value, size_t unit)
+{
+    return (value + unit - 1U) / unit * unit;
+}
+
+size_t roundUpPowerOfTwo(size_t value)
+{
+    size_t result = MIN_CHUNK_SIZE;
+    while (result < value)
+    {
+        result <<= 1;
+    }
+    return result;
+}
+
+// alignment 境界に揃えた領域を取得する
+char *mapPages(size_t size, size_t alignment)
+{
+#ifndef _WIN32
+    const size_t mapped_size = size + alignment;
+    void *pages = mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (pages == MAP_FAILED)
+    {
+        return nullptr;
+    }
+    char *mapped = (char *)pages;
+    char *aligned = (char *)roundUp((size_t)(uintptr_t)mapped, alignment);
+    if (aligned != mapped)
+    {
+        munmap(mapped, (size_t)(aligned - mapped));
+    }
+    munmap(aligned + size, (size_t)(mapped + mapped_size - (aligned + size)));
+    return aligned;
+#else
+    for (int retry = 0; retry < 8; ++retry)
+    {
+        char *reserved = (char *)VirtualAlloc(nullptr, size + alignment, MEM_RESERVE, PAGE_NOACCESS);
+        if (reserved == nullptr)
+        {
+            return nullptr;
+        }
+        char *aligned = (char *)roundUp((size_t)(uintptr_t)reserved, alignment);
+        VirtualFree(reserved, 0, MEM_RELEASE);
+        // 解放と再取得の間に他のスレッドが取得した場合は取り直す
+        char *pages = (char *)VirtualAlloc(aligned, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+        if (pages != nullptr)
+        {
+            return pages;
+        }
+    }
+    return nullptr;
+#endif
+}
+
+// アドレスは予約したまま、物理メモリーを返却してアクセス不可にする
+void quarantinePages(char *base, size_t size)
+{
+#ifndef _WIN32
+    mprotect(base, size, PROT_NONE);
+    madvise(base, size, MADV_DONTNEED);
+#else
+    VirtualFree(base, size, MEM_DECOMMIT);
+#endif
+}
+
+void unmapPages(char *base, size_t size)
+{
+#ifndef _WIN32
+    munmap(base, size);
+#else
+    (void)size;
+    VirtualFree(base, 0, MEM_RELEASE);
+#endif
+}
+
+size_t tableIndex(uintptr_t base)
+{
+    return (size_t)(((uint64_t)base * 0x9e3779b97f4a7c15ULL) >> 48) & (ARENA_TABLE_CAPACITY - 1U);
+}
+
+enum ArenaBlockLookup
+{
+    ARENA_BLOCK_NOT_OWNED, ///< AllocationArena の領域ではない
+    ARENA_BLOCK_INVALID,   ///< reset() 後・二重解放・不正なポインター (報告済み)
+    ARENA_BLOCK_FOUND      ///< 確保済みのブロック
+};
+
+} // namespace
+
+struct AllocationArenaState
+{
+    AllocationArenaState(size_t chunk_size_value, AllocationArenaResetMode reset_mode_value)
+        : chunk_size(roundUpPowerOfTwo(std::max(chunk_size_value, getPageSize()))), reset_mode(reset_mode_value),
+          table(new std::atomic<uintptr_t>[ARENA_TABLE_CAPACITY]())
+    {
+        generation.store(s_arena_generation.fetch_add(1U) + 1U, std::memory_order_release);
+    }
+
+    ~AllocationArenaState()
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        releaseChunks(ARENA_RELEASE_UNMAP);
+    }
+
+    void reset()
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        releaseChunks(reset_mode == ARENA_RESET_RECYCLE ? ARENA_RELEASE_RECYCLE : ARENA_RELEASE_QUARANTINE);
+        ++resets;
+    }
+
+    void *allocate(size_t size, bool zero_fill);
+    void *allocateChunk(size_t block_size, bool dedicated);
+    uintptr_t findEntry(const void *ptr) const;
+    void setEntry(uintptr_t base, uintptr_t entry);
+    ArenaBlockLookup findLiveBlock(void *ptr, const char *operation, ArenaBlockHeader **header);
+    void releaseChunks(ArenaRelease release);
+
+    const size_t chunk_size;
+    const AllocationArenaResetMode reset_mode;
+    std::atomic<uint64_t> generation{0U};
+    std::atomic<uint64_t> allocations{0U};
+    std::atomic<uint64_t> bytes{0U};
+    std::atomic<uint64_t> invalid_frees{0U};
+    unique_ptr<std::atomic<uintptr_t>[]> table; // 追加・変更は mtx を取得して行い、参照はロックしない
+
+    // 以下は mtx で保護する
+    std::mutex mtx;
+    map<uintptr_t, ArenaChunk> chunks; // アクセス不可としたチャンクを含む
+    deque<uintptr_t> quarantine_order;
+    vector<char *> recycled_chunks;
+    uint64_t resets = 0;
+};
+
+namespace
+{
+
+testfw::MockSlot<AllocationArenaState> s_allocation_arena;
+
+// テストの実行中のみ確保先として公開する。テスト間は本物の malloc を使用する
+class AllocationArenaListener : public EmptyTestEventListener
+{
+  public:
+    AllocationArenaListener(size_t chunk_size, AllocationArenaResetMode reset_mode)
+        : state_(new AllocationArenaState(chunk_size, reset_mode))
+    {
+    }
+
+    void OnTestStart(const TestInfo &) override
+    {
+        if (s_allocation_arena.get() != nullptr)
+        {
+            ADD_FAILURE() << "Only one AllocationArena may exist at a time.";
+            return;
+        }
+        s_allocation_arena.publish(state_.get());
+    }
+
+    // TearDown の後に通知されるため、テスト フィクスチャーの解放処理も AllocationArena を使用できる
+    void OnTestEnd(const TestInfo &) override
+    {
+        if (s_allocation_arena.get() != state_.get())
+        {
+            return;
+        }
+        if (!s_allocation_arena.retire(state_.get(), testfw::internal::kMockRetireTimeout))
+        {
+            ADD_FAILURE() << "Mock calls did not finish within " << testfw::internal::kMockRetireTimeout.count()
+                          << " ms while resetting AllocationArena.";
+            return;
+        }
+        state_->reset();
+    }
+
+  private:
+    unique_ptr<AllocationArenaState> state_;
+};
+
+} // namespace
+
+void *AllocationArenaState::allocate(size_t size, bool zero_fill)
+{
+    const size_t block_size = roundUp(sizeof(ArenaBlockHeader) + size, ARENA_ALIGNMENT);
+    if (block_size < size)
+    {
+        errno = ENOMEM;
+        return nullptr;
+    }
+
+    ArenaBlockHeader *header;
+    bool recycled = false;
+    ThreadArenaCache &cache = t_arena_cache;
+    if (block_size <= chunk_size / 4U && cache.generation == generation.load(std::memory_order_acquire) &&
+        (size_t)(cache.limit - cache.cursor) >= block_size)
+    {
+        header = (ArenaBlockHeader *)(void *)cache.cursor;
+        cache.cursor += block_size;
+        recycled = cache.recycled;
+    }
+    else
+    {
+        // 大きな確保は専用のチャンクとし、スレッドのチャンクの残りを無駄にしない
+        header = (ArenaBlockHeader *)allocateChunk(block_size, block_size > chunk_size / 4U);
+        if (header == nullptr)
+        {
+            errno = ENOMEM;
+            return nullptr;
+        }
+        recycled = cache.recycled && block_size <= chunk_size / 4U;
+    }
+
+    *header = ArenaBlockHeader{size, ARENA_BLOCK_MAGIC, ARENA_BLOCK_LIVE};
+    if (zero_fill && recycled)
+    {
+        memset(header + 1, 0, size);
+    }
+    allocations.fetch_add(1U, std::memory_order_relaxed);
+    bytes.fetch_add(size, std::memory_order_relaxed);
+    return header + 1;
+}
+
+// チャンクを追加し、先頭の block_size バイトを返す。専用でないチャンクはスレッドの切り出し先とする
+void *AllocationArenaState::allocateChunk(size_t block_size, bool dedicated)
+{
+    std::lock_guard<std::mutex> lock(mtx);
+
+    if (!dedicated && !recycled_chunks.empty())
+    {
+        char *base = recycled_chunks.back();
+        recycled_chunks.pop_back();
+        t_arena_cache =
+            ThreadArenaCache{generation.load(std::memory_order_relaxed), base + block_size, base + chunk_size, true};
+        return base;
+    }
+
+    if (chunks.size() >= ARENA_TABLE_CAPACITY / 2U)
+    {
+        ADD_FAILURE() << "AllocationArena has too many chunks; increase the chunk size or call reset().";
+        return nullptr;
+    }
+
+    const size_t size = dedicated ? roundUp(block_size, chunk_size) : chunk_size;
+    char *base = mapPages(size, chunk_size);
+    if (base == nullptr)
+    {
+        return nullptr;
+    }
+    chunks[(uintptr_t)base] = ArenaChunk{base, size, false};
+    setEntry((uintptr_t)base, (uintptr_t)base | ARENA_ENTRY_LIVE);
+
+    if (!dedicated)
+    {
+        t_arena_cache =
+            ThreadArenaCache{generation.load(std::memory_order_relaxed), base + block_size, base + size, false};
+    }
+    return base;
+}
+
+// ptr を含むチャンクの表の要素を返す。無い場合は ARENA_ENTRY_EMPTY を返す
+uintptr_t AllocationArenaState::findEntry(const void *ptr) const
+{
+    const uintptr_t base = (uintptr_t)ptr & ~(uintptr_t)(chunk_size - 1U);
+    size_t index = tableIndex(base);
+    for (size_t probe = 0; probe < ARENA_TABLE_CAPACITY; ++probe)
+    {
+        const uintptr_t entry = table[index].load(std::memory_order_acquire);
+        if (entry == ARENA_ENTRY_EMPTY)
+        {
+            break;
+        }
+        if (entry != ARENA_ENTRY_TOMBSTONE && (entry & ~ARENA_ENTRY_FLAGS) == base)
+        {
+            return entry;
+        }
+        index = (index + 1U) & (ARENA_TABLE_CAPACITY - 1U);
+    }
+    return ARENA_ENTRY_EMPTY;
+}
+
+// mtx を取得して呼び出す。base の要素を entry に置き換える (無い場合は追加する)
+void AllocationArenaState::setEntry(uintptr_t base, uintptr_t entry)
+{
+    size_t index = tableIndex(base);
+    size_t reusable = ARENA_TABLE_CAPACITY;
+    for (size_t probe = 0; probe < ARENA_TABLE_CAPACITY; ++probe)
+    {
+        const uintptr_t current = table[index].load(std::memory_order_relaxed);
+        if (current != ARENA_ENTRY_TOMBSTONE && current != ARENA_ENTRY_EMPTY && (current & ~ARENA_ENTRY_FLAGS) == base)
+        {
+            table[index].store(entry, std::memory_order_release);
+            return;
+        }
+        if (current == ARENA_ENTRY_TOMBSTONE && reusable == ARENA_TABLE_CAPACITY)
+        {
+            reusable = index;
+        }
+        if (current == ARENA_ENTRY_EMPTY)
+        {
+            if (reusable == ARENA_TABLE_CAPACITY)
+            {
+                reusable = index;
+            }
+            break;
+        }
+        index = (index + 1U) & (ARENA_TABLE_CAPACITY - 1U);
+    }
+    if (entry != ARENA_ENTRY_TOMBSTONE && reusable != ARENA_TABLE_CAPACITY)
+    {
+        table[reusable].store(entry, std::memory_order_release);
+    }
+}
+
+ArenaBlockLookup AllocationArenaState::findLiveBlock(void *ptr, const char *operation, ArenaBlockHeader **header)
+{
+    const uintptr_t entry = findEntry(ptr);
+    if (entry == ARENA_ENTRY_EMPTY)
+    {
+        return ARENA_BLOCK_NOT_OWNED;
+    }
+    if ((entry & ARENA_ENTRY_QUARANTINED) != 0U)
+    {
+        invalid_frees.fetch_add(1U, std::memory_order_relaxed);
+        ADD_FAILURE() << operation << "(" << ptr << ") of memory released by AllocationArena::reset().";
+        return ARENA_BLOCK_INVALID;
+    }
+
+    const uintptr_t offset = (uintptr_t)ptr - (entry & ~ARENA_ENTRY_FLAGS);
+    ArenaBlockHeader *found = (ArenaBlockHeader *)ptr - 1;
+    if (offset < sizeof(ArenaBlockHeader) || offset % ARENA_ALIGNMENT != 0U || found->magic != ARENA_BLOCK_MAGIC)
+    {
+        invalid_frees.fetch_add(1U, std::memory_order_relaxed);
+        ADD_FAILURE() << operation << "(" << ptr << ") of a pointer that was not returned by the allocator.";
+        return ARENA_BLOCK_INVALID;
+    }
+    if (found->state != ARENA_BLOCK_LIVE)
+    {
+        invalid_frees.fetch_add(1U, std::memory_order_relaxed);
+        ADD_FAILURE() << operation << "(" << ptr << ") of memory that was already freed.";
+        return ARENA_BLOCK_INVALID;
+    }
+    *header = found;
+    return ARENA_BLOCK_FOUND;
+}
+
+// mtx を取得して呼び出す
+void AllocationArenaState::releaseChunks(ArenaRelease release)
+{
+    // 各スレッドが切り出し中のチャンクを無効にする
+    generation.store(s_arena_generation.fetch_add(1U) + 1U, std::memory_order_release);
+    recycled_chunks.clear();
+
+    for (auto it = chunks.begin(); it != chunks.end();)
+    {
+        ArenaChunk &chunk = it->second;
+        if (!chunk.quarantined)
+        {
+            // 解放していないブロックをメモリー確保の追跡から外す。チャンクは先頭から隙間なく切り出している
+            for (size_t offset = 0; offset + sizeof(ArenaBlockHeader) <= chunk.size;)
+            {
+                ArenaBlockHeader *header = (ArenaBlockHeader *)(void *)(chunk.base + offset);
+                if (header->magic != ARENA_BLOCK_MAGIC)
+                {
+                    break;
+                }
+                if (header->state == ARENA_BLOCK_LIVE)
+                {
+                    trackFree(header + 1);
+                }
+                // 再利用する場合、以前の内容を次の reset() で走査しないよう無効にする
+                header->magic = 0U;
+                offset += roundUp(sizeof(ArenaBlockHeader) + (size_t)header->size, ARENA_ALIGNMENT);
+            }
+        }
+
+        const bool dedicated = chunk.size != chunk_size;
+        if (release == ARENA_RELEASE_UNMAP || (release == ARENA_RELEASE_RECYCLE && dedicated))
+        {
+            setEntry(it->first, ARENA_ENTRY_TOMBSTONE);
+            unmapPages(chunk.base, chunk.size);
+            it = chunks.erase(it);
+            continue;
+        }
+        if (release == ARENA_RELEASE_RECYCLE)
+        {
+            recycled_chunks.push_back(chunk.base);
+        }
+        else if (!chunk.quarantined)
+        {
+            quarantinePages(chunk.base, chunk.size);
+            chunk.quarantined = true;
+            setEntry(it->first, it->first | ARENA_ENTRY_QUARANTINED);
+            quarantine_order.push_back(it->first);
+        }
+        ++it;
+    }
+
+    if (release == ARENA_RELEASE_UNMAP)
+    {
+        quarantine_order.clear();
+    }
+    while (quarantine_order.size() > MAX_QUARANTINED_CHUNKS)
+    {
+        auto oldest = chunks.find(quarantine_order.front());
+        setEntry(oldest->first, ARENA_ENTRY_TOMBSTONE);
+        unmapPages(oldest->second.base, oldest->second.size);
+        chunks.erase(oldest);
+        quarantine_order.pop_front();
+    }
+
+    allocations.store(0U, std::memory_order_relaxed);
+    bytes.store(0U, std::memory_order_relaxed);
+}
+
+AllocationArena::AllocationArena(size_t chunk_size, AllocationArenaResetMode reset_mode)
+    : state_(new AllocationArenaState(chunk_size, reset_mode))
+{
+    if (s_allocation_arena.get() != nullptr)
+    {
+        ADD_FAILURE() << "Only one AllocationArena may exist at a time.";
+        return;
+    }
+    s_allocation_arena.publish(state_.get());
+}
+
+AllocationArena::~AllocationArena()
+{
+    if (s_allocation_arena.get() == state_.get() &&
+        !s_allocation_arena.retire(state_.get(), testfw::internal::kMockRetireTimeout))
+    {
+        ADD_FAILURE() << "Mock calls did not finish within " << testfw::internal::kMockRetireTimeout.count()
+                      << " ms while destroying AllocationArena.";
+        // 確保中のスレッドが参照している可能性があるため解放しない
+        (void)state_.release();
+    }
+}
+
+void AllocationArena::reset()
+{
+    state_->reset();
+}
+
+AllocationArenaStats AllocationArena::stats() const
+{
+    std::lock_guard<std::mutex> lock(state_->mtx);
+    AllocationArenaStats stats;
+    stats.allocations = state_->allocations.load(std::memory_order_relaxed);
+    stats.bytes = state_->bytes.load(std::memory_order_relaxed);
+    stats.chunks = state_->chunks.size() - state_->quarantine_order.size() - state_->recycled_chunks.size();
+    stats.resets = state_->resets;
+    stats.quarantined = state_->quarantine_order.size();
+    stats.invalid_frees = state_->invalid_frees.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void installAllocationArenaListener(size_t chunk_size, AllocationArenaResetMode reset_mode)
+{
+    UnitTest::GetInstance()->listeners().Append(new AllocationArenaListener(chunk_size, reset_mode));
+}
+
+bool allocateFromArena(size_t size, void **allocated)
+{
+    auto locked_arena = s_allocation_arena.lock();
+    if (!locked_arena)
+    {
+        return false;
+    }
+
+    *allocated = locked_arena->allocate(size, false);
+    return true;
+}
+
+bool callocFromArena(size_t nmemb, size_t size, void **allocated)
+{
+    // 乗算が桁あふれする場合は本物の calloc に ENOMEM を返させる
+    if (size != 0U && nmemb > SIZE_MAX / size)
+    {
+        return false;
+    }
+    auto locked_arena = s_allocation_arena.lock();
+    if (!locked_arena)
+    {
+        return false;
+    }
+
+    // OS から取得した直後のチャンクは 0 で初期化済みのため、再利用したチャンクのみ 0 で埋める
+    *allocated = locked_arena->allocate(nmemb * size, true);
+    return true;
+}
+
+bool reallocateFromArena(void *ptr, size_t size, void **allocated)
+{
+    auto locked_arena = s_allocation_arena.lock();
+    if (!locked_arena)
+    {
+        return false;
+    }
+    if (ptr == nullptr)
+    {
+        *allocated = locked_arena->allocate(size, false);
+        return true;
+    }
+
+    ArenaBlockHeader *header = nullptr;
+    switch (locked_arena->findLiveBlock(ptr, "realloc", &header))
+    {
+    case ARENA_BLOCK_NOT_OWNED:
+        // AllocationArena の生成前に確保した領域は本物の realloc で処理する
+        return false;
+    case ARENA_BLOCK_INVALID:
+        *allocated = nullptr;
+        errno = EINVAL;
+        return true;
+    case ARENA_BLOCK_FOUND:
+    default:
+        break;
+    }
+
+    if (size == 0U)
+    {
+        header->state = ARENA_BLOCK_FREED;
+        *allocated = nullptr;
+        return true;
+    }
+
+    void *resized = locked_arena->allocate(size, false);
+    if (resized != nullptr)
+    {
+        memcpy(resized, ptr, std::min<size_t>(size, (size_t)header->size));
+        header->state = ARENA_BLOCK_FREED;
+    }
+    *allocated = resized;
+    return true;
+}
+
+bool freeToArena(void *ptr)
+{
+    if (ptr == nullptr)
+    {
+        return false;
+    }
+    auto locked_arena = s_allocation_arena.lock();
+    if (!locked_arena)
+    {
+        return false;
+    }
+
+    ArenaBlockHeader *header = nullptr;
+    const ArenaBlockLookup lookup = locked_arena->findLiveBlock(ptr, "free", &header);
+    if (lookup == ARENA_BLOCK_FOUND)
+    {
+        header->state = ARENA_BLOCK_FREED;
+    }
+    return lookup != ARENA_BLOCK_NOT_OWNED;
+}
+
+} // namespace testing
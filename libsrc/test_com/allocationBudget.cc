@@ -0,0 +1,91 @@
+/* スコープ内の確保回数の上限 (ALLOCATION_BUDGET / EXPECT_NO_ALLOCATIONS) を確認する。
+ * スコープはスレッドごとに入れ子の連結リストで管理し、確保の計数ではロック・メモリー確保を行わない。 */
+
+#include <test_com.h>
+
+#include <sstream>
+
+namespace testing
+{
+
+namespace
+{
+
+thread_local AllocationBudget *t_allocation_budget = nullptr;
+
+} // namespace
+
+AllocationBudget::AllocationBudget(const char *file, int line, uint64_t max_allocations, uint64_t max_bytes)
+    : file_(file), line_(line), max_allocations_(max_allocations), max_bytes_(max_bytes), sites_(),
+      outer_(t_allocation_budget)
+{
+    t_allocation_budget = this;
+}
+
+AllocationBudget::~AllocationBudget()
+{
+    t_allocation_budget = outer_;
+
+    if (allocations_ <= max_allocations_ && bytes_ <= max_bytes_)
+    {
+        return;
+    }
+
+    ostringstream message;
+    message << "Allocation budget exceeded: " << allocations_ << " allocation(s), " << bytes_ << " byte(s)";
+    message << " (limit: " << max_allocations_ << " allocation(s)";
+    if (max_bytes_ != UINT64_MAX)
+    {
+        message << ", " << max_bytes_ << " byte(s)";
+    }
+    message << ")";
+    for (size_t i = 0; i < site_count_; ++i)
+    {
+        message << "\n  " << sites_[i].file << ":" << sites_[i].line << " (" << sites_[i].caller
+                << "): " << sites_[i].allocations << " allocation(s), " << sites_[i].bytes << " byte(s)";
+    }
+    if (other_site_allocations_ != 0U)
+    {
+        message << "\n  ... " << other_site_allocations_ << " allocation(s) from other call sites";
+    }
+    ADD_FAILURE_AT(file_, line_) << message.str();
+}
+
+void AllocationBudget::record(size_t size, const char *file, int line, const char *caller)
+{
+    for (AllocationBudget *budget = this; budget != nullptr; budget = budget->outer_)
+    {
+        ++budget->allocations_;
+        budget->bytes_ += size;
+
+        size_t i = 0;
+        while (i < budget->site_count_ &&
+               !(budget->sites_[i].file == file && budget->sites_[i].line == line &&
+                 budget->sites_[i].caller == caller))
+        {
+            ++i;
+        }
+        if (i == budget->site_count_)
+        {
+            if (budget->site_count_ == MAX_SITES)
+            {
+                ++budget->other_site_allocations_;
+                continue;
+            }
+            budget->sites_[budget->site_count_++] = Site{file, line, caller, 0U, 0U};
+        }
+        ++budget->sites_[i].allocations;
+        budget->sites_[i].bytes += size;
+    }
+}
+
+void countAllocationBudget(size_t size, const char *file, int line, const char *caller)
+{
+    AllocationBudget *budget = t_allocation_budget;
+    if (budget != nullptr)
+    {
+        budget->record(size, file, line, caller);
+    }
+}
+
+} // namespace testing
@@ -0,0 +1,453 @@
+/* mock_malloc などで確保したメモリーを追跡し、リークとピークを報告する。
+ * 未解放メモリーはアドレスから求めたシャードのハッシュ表に記録する。
+ * 確保元ごとの集計も同じシャードに置くため、解放時に取得するロックはシャード 1 個のみ。 */
+
+#include <allocationTracker.h>
+#include <test_com.h>
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <tuple>
+#include <unordered_map>
+
+namespace testing
+{
+
+namespace
+{
+
+constexpr size_t ALLOCATION_SHARD_BITS = 6;
+constexpr size_t ALLOCATION_SHARD_COUNT = size_t{1} << ALLOCATION_SHARD_BITS;
+
+// 確保元の識別子。__FILE__ / __func__ のアドレスで識別し、集計時に文字列でまとめる。
+struct AllocationSiteKey
+{
+    const char *file;
+    const char *caller;
+    int line;
+
+    bool operator==(const AllocationSiteKey &other) const
+    {
+        return file == other.file && caller == other.caller && line == other.line;
+    }
+};
+
+struct AllocationSiteKeyHash
+{
+    size_t operator()(const AllocationSiteKey &key) const
+    {
+        size_t hash = std::hash<const void *>()(key.file);
+        hash = hash * 31U + std::hash<const void *>()(key.caller);
+        return hash * 31U + (size_t)key.line;
+    }
+};
+
+struct AllocationRecord
+{
+    size_t size;
+    AllocationSiteKey site;
+    uint64_t sequence;
+};
+
+struct AllocationSiteCounter
+{
+    uint64_t allocations = 0;
+    uint64_t allocated_bytes = 0;
+    uint64_t live_allocations = 0;
+    uint64_t live_bytes = 0;
+};
+
+struct AllocationShard
+{
+    std::mutex mtx;
+    unordered_map<const void *, AllocationRecord> live;
+    unordered_map<AllocationSiteKey, AllocationSiteCounter, AllocationSiteKeyHash> sites;
+};
+
+struct AllocationTracker
+{
+    std::atomic<bool> enabled{false};
+    std::atomic<uint64_t> next_sequence{0};
+    std::atomic<uint64_t> allocations{0};
+    std::atomic<uint64_t> frees{0};
+    std::atomic<uint64_t> allocated_bytes{0};
+    std::atomic<uint64_t> live_allocations{0};
+    std::atomic<uint64_t> live_bytes{0};
+    std::atomic<uint64_t> peak_bytes{0};
+    AllocationShard shards[ALLOCATION_SHARD_COUNT];
+};
+
+AllocationTracker &getAllocationTracker()
+{
+    static AllocationTracker tracker;
+    return tracker;
+}
+
+AllocationShard &getShard(AllocationTracker &tracker, const void *ptr)
+{
+    // 下位ビットはアラインメントでほぼ一定のため、乗算の上位ビットで選択する
+    const uint64_t hash = (uint64_t)(uintptr_t)ptr * 0x9e3779b97f4a7c15ULL;
+    return tracker.shards[hash >> (64U - ALLOCATION_SHARD_BITS)];
+}
+
+void addRecord(AllocationTracker &tracker, const void *ptr, const AllocationRecord &record, bool is_new_allocation)
+{
+    {
+        AllocationShard &shard = getShard(tracker, ptr);
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        shard.live[ptr] = record;
+        AllocationSiteCounter &site = shard.sites[record.site];
+        if (is_new_allocation)
+        {
+            ++site.allocations;
+            site.allocated_bytes += record.size;
+        }
+        ++site.live_allocations;
+        site.live_bytes += record.size;
+    }
+
+    if (is_new_allocation)
+    {
+        tracker.allocations.fetch_add(1U, std::memory_order_relaxed);
+        tracker.allocated_bytes.fetch_add(record.size, std::memory_order_relaxed);
+    }
+    tracker.live_allocations.fetch_add(1U, std::memory_order_relaxed);
+    const uint64_t live = tracker.live_bytes.fetch_add(record.size, std::memory_order_relaxed) + record.size;
+    uint64_t peak = tracker.peak_bytes.load(std::memory_order_relaxed);
+    while (live > peak && !tracker.peak_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+    {
+    }
+}
+
+bool removeRecord(AllocationTracker &tracker, const void *ptr, AllocationRecord *removed)
+{
+    {
+        AllocationShard &shard = getShard(tracker, ptr);
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        auto found = shard.live.find(ptr);
+        if (found == shard.live.end())
+        {
+            return false;
+        }
+        *removed = found->second;
+        shard.live.erase(found);
+        AllocationSiteCounter &site = shard.sites[removed->site];
+        --site.live_allocations;
+        site.live_bytes -= removed->size;
+    }
+
+    tracker.live_allocations.fetch_sub(1U, std::memory_order_relaxed);
+    tracker.live_bytes.fetch_sub(removed->size, std::memory_order_relaxed);
+    return true;
+}
+
+string formatLiveAllocations(const vector<LiveAllocation> &allocations, size_t max_reported)
+{
+    map<tuple<string, int, string>, pair<uint64_t, uint64_t>> sites;
+    uint64_t total_bytes = 0;
+    for (const LiveAllocation &allocation : allocations)
+    {
+        pair<uint64_t, uint64_t> &site = sites[make_tuple(allocation.file, allocation.line, allocation.caller)];
+        ++site.first;
+        site.second += allocation.size;
+        total_bytes += allocation.size;
+    }
+
+    vector<pair<tuple<string, int, string>, pair<uint64_t, uint64_t>>> sorted(sites.begin(), sites.end());
+    stable_sort(sorted.begin(), sorted.end(),
+                [](const decltype(sorted)::value_type &a, const decltype(sorted)::value_type &b) {
+                    return a.second.second > b.second.second;
+                });
+
+    ostringstream out;
+    out << allocations.size() << " allocation(s), " << total_bytes << " byte(s) not freed";
+    for (size_t i = 0; i < sorted.size() && i < max_reported; ++i)
+    {
+        out << "\n  " << get<0>(sorted[i].first) << ":" << get<1>(sorted[i].first) << " ("
+            << get<2>(sorted[i].first) << "): " << sorted[i].second.first << " allocation(s), "
+            << sorted[i].second.second << " byte(s)";
+    }
+    if (sorted.size() > max_reported)
+    {
+        out << "\n  ... " << (sorted.size() - max_reported) << " more call site(s)";
+    }
+    return out.str();
+}
+
+void reportAllocationProblem(const TestInfo &test_info, AllocationCheckAction action, const string &message)
+{
+    switch (action)
+    {
+    case ALLOCATION_CHECK_WARN:
+        printf("  > [allocation warning] %s\n", message.c_str());
+        break;
+    case ALLOCATION_CHECK_FAIL:
+        // テストの定義位置を失敗箇所として報告する
+        ADD_FAILURE_AT(test_info.file(), test_info.line()) << message;
+        break;
+    case ALLOCATION_CHECK_IGNORE:
+    default:
+        break;
+    }
+}
+
+class AllocationTrackerListener : public EmptyTestEventListener
+{
+  public:
+    explicit AllocationTrackerListener(const AllocationCheckOptions &options) : options_(options)
+    {
+    }
+
+    void OnTestStart(const TestInfo &) override
+    {
+        start_sequence_ = getAllocationSequence();
+        start_live_bytes_ = getAllocationStats().live_bytes;
+        resetAllocationPeak();
+    }
+
+    // 終了イベントは登録の逆順に通知されるため、既定の出力より前に失敗を追加できる
+    void OnTestEnd(const TestInfo &test_info) override
+    {
+        if (options_.leak_action != ALLOCATION_CHECK_IGNORE)
+        {
+            const vector<LiveAllocation> leaks = getLiveAllocations(start_sequence_);
+            if (!leaks.empty())
+            {
+                reportAllocationProblem(test_info, options_.leak_action,
+                                        "Memory leak: " + formatLiveAllocations(leaks, options_.max_reported));
+            }
+        }
+
+        if (options_.peak_limit_bytes != 0U && options_.peak_action != ALLOCATION_CHECK_IGNORE)
+        {
+            const uint64_t peak_bytes = getAllocationStats().peak_bytes;
+            const uint64_t test_peak = peak_bytes > start_live_bytes_ ? peak_bytes - start_live_bytes_ : 0U;
+            if (test_peak > options_.peak_limit_bytes)
+            {
+                reportAllocationProblem(test_info, options_.peak_action, "Peak heap usage " + to_string(test_peak) +
+                                                                  " byte(s) exceeds the limit of " +
+                                                                  to_string(options_.peak_limit_bytes) + " byte(s)");
+            }
+        }
+    }
+
+  private:
+    AllocationCheckOptions options_;
+    uint64_t start_sequence_ = 0;
+    uint64_t start_live_bytes_ = 0;
+};
+
+} // namespace
+
+void setAllocationTrackingEnabled(bool enabled)
+{
+    getAllocationTracker().enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool isAllocationTrackingEnabled()
+{
+    return getAllocationTracker().enabled.load(std::memory_order_relaxed);
+}
+
+AllocationStats getAllocationStats()
+{
+    AllocationTracker &tracker = getAllocationTracker();
+    AllocationStats stats;
+    stats.allocations = tracker.allocations.load(std::memory_order_relaxed);
+    stats.frees = tracker.frees.load(std::memory_order_relaxed);
+    stats.allocated_bytes = tracker.allocated_bytes.load(std::memory_order_relaxed);
+    stats.live_allocations = tracker.live_allocations.load(std::memory_order_relaxed);
+    stats.live_bytes = tracker.live_bytes.load(std::memory_order_relaxed);
+    stats.peak_bytes = tracker.peak_bytes.load(std::memory_order_relaxed);
+    return stats;
+}
+
+vector<AllocationSiteStats> getAllocationSites()
+{
+    AllocationTracker &tracker = getAllocationTracker();
+    map<tuple<string, int, string>, AllocationSiteStats> merged;
+    for (AllocationShard &shard : tracker.shards)
+    {
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        for (const auto &entry : shard.sites)
+        {
+            const AllocationSiteKey &key = entry.first;
+            AllocationSiteStats &stats = merged[make_tuple(string(key.file), key.line, string(key.caller))];
+            if (stats.file.empty())
+            {
+                stats.file = key.file;
+                stats.line = key.line;
+                stats.caller = key.caller;
+            }
+
+            const AllocationSiteCounter &counter = entry.second;
+            stats.allocations += counter.allocations;
+            stats.allocated_bytes += counter.allocated_bytes;
+            stats.live_allocations += counter.live_allocations;
+            stats.live_bytes += counter.live_bytes;
+        }
+    }
+
+    vector<AllocationSiteStats> result;
+    result.reserve(merged.size());
+    for (auto &entry : merged)
+    {
+        result.push_back(std::move(entry.second));
+    }
+    stable_sort(result.begin(), result.end(), [](const AllocationSiteStats &a, const AllocationSiteStats &b) {
+        return a.allocated_bytes > b.allocated_bytes;
+    });
+
+    return result;
+}
+
+vector<LiveAllocation> getLiveAllocations(uint64_t since_sequence)
+{
+    AllocationTracker &tracker = getAllocationTracker();
+    vector<LiveAllocation> result;
+    for (AllocationShard &shard : tracker.shards)
+    {
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        for (const auto &entry : shard.live)
+        {
+            const AllocationRecord &record = entry.second;
+            if (record.sequence >= since_sequence)
+            {
+                result.push_back(LiveAllocation{entry.first, record.size, record.site.file, record.site.line,
+                                                record.site.caller, record.sequence});
+            }
+        }
+    }
+    sort(result.begin(), result.end(),
+         [](const LiveAllocation &a, const LiveAllocation &b) { return a.sequence < b.sequence; });
+
+    return result;
+}
+
+uint64_t getAllocationSequence()
+{
+    return getAllocationTracker().next_sequence.load(std::memory_order_relaxed);
+}
+
+void resetAllocationPeak()
+{
+    AllocationTracker &tracker = getAllocationTracker();
+    tracker.peak_bytes.store(tracker.live_bytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+void clearAllocationTracking()
+{
+    AllocationTracker &tracker = getAllocationTracker();
+    for (AllocationShard &shard : tracker.shards)
+    {
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        shard.live.clear();
+        shard.sites.clear();
+    }
+    tracker.allocations.store(0U, std::memory_order_relaxed);
+    tracker.frees.store(0U, std::memory_order_relaxed);
+    tracker.allocated_bytes.store(0U, std::memory_order_relaxed);
+    tracker.live_allocations.store(0U, std::memory_order_relaxed);
+    tracker.live_bytes.store(0U, std::memory_order_relaxed);
+    tracker.peak_bytes.store(0U, std::memory_order_relaxed);
+}
+
+void printLiveAllocations(FILE *out, uint64_t since_sequence, size_t max_reported)
+{
+    fprintf(out, "  > %s\n", formatLiveAllocations(getLiveAllocations(since_sequence), max_reported).c_str());
+}
+
+void installAllocationTrackerListener(const AllocationCheckOptions &options)
+{
+    setAllocationTrackingEnabled(true);
+    UnitTest::GetInstance()->listeners().Append(new AllocationTrackerListener(options));
+}
+
+void trackAllocation(const void *ptr, size_t size, const char *file, int line, const char *caller)
+{
+    if (ptr == nullptr)
+    {
+        return;
+    }
+    countAllocationBudget(size, file, line, caller);
+
+    AllocationTracker &tracker = getAllocationTracker();
+    if (!tracker.enabled.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    const uint64_t sequence = tracker.next_sequence.fetch_add(1U, std::memory_order_relaxed);
+    addRecord(tracker, ptr, AllocationRecord{size, AllocationSiteKey{file, caller, line}, sequence}, true);
+}
+
+void trackFree(const void *ptr)
+{
+    AllocationTracker &tracker = getAllocationTracker();
+    if (ptr == nullptr || !tracker.enabled.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    AllocationRecord removed;
+    if (removeRecord(tracker, ptr, &removed))
+    {
+        tracker.frees.fetch_add(1U, std::memory_order_relaxed);
+    }
+}
+
+TrackedReallocation beginTrackReallocation(const void *ptr)
+{
+    TrackedReallocation previous;
+    AllocationTracker &tracker = getAllocationTracker();
+    if (ptr == nullptr || !tracker.enabled.load(std::memory_order_relaxed))
+    {
+        return previous;
+    }
+
+    AllocationRecord removed;
+    if (removeRecord(tracker, ptr, &removed))
+    {
+        previous.ptr = ptr;
+        previous.size = removed.size;
+        previous.file = removed.site.file;
+        previous.line = removed.site.line;
+        previous.caller = removed.site.caller;
+        previous.sequence = removed.sequence;
+        previous.tracked = true;
+    }
+    return previous;
+}
+
+void endTrackReallocation(const TrackedReallocation &previous, const void *new_ptr, size_t size, const char *file,
+                          int line, const char *caller)
+{
+    AllocationTracker &tracker = getAllocationTracker();
+    if (new_ptr == nullptr)
+    {
+        if (previous.tracked && size != 0U)
+        {
+            // 失敗した場合、元のメモリーは解放されていない
+            addRecord(tracker, previous.ptr,
+                      AllocationRecord{previous.size, AllocationSiteKey{previous.file, previous.caller, previous.line},
+                                       previous.sequence},
+                      false);
+        }
+        else if (previous.tracked)
+        {
+            tracker.frees.fetch_add(1U, std::memory_order_relaxed);
+        }
+        return;
+    }
+
+    if (previous.tracked)
+    {
+        tracker.frees.fetch_add(1U, std::memory_order_relaxed);
+    }
+    trackAllocation(new_ptr, size, file, line, caller);
+}
+
+} // namespace testing
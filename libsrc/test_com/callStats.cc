@@ -0,0 +1,266 @@
+/* mock 関数の呼び出し元ごとの呼び出し回数・エラー回数・レイテンシ ヒストグラムを収集する。
+ * 記録はスレッドごとのシャードに行い (シャードのロックは所有スレッドと集計処理のみが取得する)、
+ * 参照時にすべてのシャードを集計する。 */
+
+#include <callStats.h>
+#include <test_com.h>
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <unordered_map>
+
+namespace testing
+{
+
+namespace
+{
+
+// 呼び出し元の識別子。__FILE__ / __func__ のアドレスで識別し、集計時に文字列でまとめる。
+struct CallSiteKey
+{
+    const char *function_name;
+    const char *file;
+    const char *caller;
+    int line;
+
+    bool operator==(const CallSiteKey &other) const
+    {
+        return function_name == other.function_name && file == other.file && caller == other.caller &&
+               line == other.line;
+    }
+};
+
+struct CallSiteKeyHash
+{
+    size_t operator()(const CallSiteKey &key) const
+    {
+        size_t hash = std::hash<const void *>()(key.function_name);
+        hash = hash * 31U + std::hash<const void *>()(key.file);
+        hash = hash * 31U + std::hash<const void *>()(key.caller);
+        return hash * 31U + (size_t)key.line;
+    }
+};
+
+struct CallSiteCounter
+{
+    uint64_t calls = 0;
+    uint64_t errors = 0;
+    uint64_t total_ns = 0;
+    uint64_t max_ns = 0;
+    uint64_t histogram[CALL_STATS_HISTOGRAM_BUCKETS] = {};
+};
+
+struct CallStatsShard
+{
+    std::mutex mtx;
+    unordered_map<CallSiteKey, CallSiteCounter, CallSiteKeyHash> counters;
+};
+
+struct CallStatsRegistry
+{
+    std::atomic<bool> enabled{false};
+    std::mutex mtx;
+    // 終了したスレッドのシャードも集計対象として保持する
+    vector<shared_ptr<CallStatsShard>> shards;
+};
+
+CallStatsRegistry &getCallStatsRegistry()
+{
+    static CallStatsRegistry registry;
+    return registry;
+}
+
+CallStatsShard &getThreadShard()
+{
+    thread_local shared_ptr<CallStatsShard> shard;
+    if (!shard)
+    {
+        shard = make_shared<CallStatsShard>();
+        CallStatsRegistry &registry = getCallStatsRegistry();
+        std::lock_guard<std::mutex> lock(registry.mtx);
+        registry.shards.push_back(shard);
+    }
+    return *shard;
+}
+
+size_t histogramBucket(uint64_t elapsed_ns)
+{
+    size_t bucket = 0;
+    while (elapsed_ns > 1U && bucket + 1U < CALL_STATS_HISTOGRAM_BUCKETS)
+    {
+        elapsed_ns >>= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+
+string formatMicroseconds(uint64_t ns)
+{
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%.1f", (double)ns / 1000.0);
+    return buffer;
+}
+
+class CallStatsListener : public EmptyTestEventListener
+{
+  public:
+    explicit CallStatsListener(size_t top_n) : top_n_(top_n)
+    {
+    }
+
+    void OnTestProgramEnd(const UnitTest &) override
+    {
+        printCallStats(stdout, top_n_);
+    }
+
+  private:
+    size_t top_n_;
+};
+
+} // namespace
+
+uint64_t CallSiteStats::percentileNs(double q) const
+{
+    if (calls == 0)
+    {
+        return 0;
+    }
+
+    const double threshold = q * (double)calls;
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < CALL_STATS_HISTOGRAM_BUCKETS; ++i)
+    {
+        cumulative += histogram[i];
+        if ((double)cumulative >= threshold)
+        {
+            // バケットの上限値。最大値を超える場合は最大値とする
+            const uint64_t upper = (i + 1U < 64U) ? (uint64_t{1} << (i + 1U)) : max_ns;
+            return std::min(upper, max_ns);
+        }
+    }
+    return max_ns;
+}
+
+void setCallStatsEnabled(bool enabled)
+{
+    getCallStatsRegistry().enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool isCallStatsEnabled()
+{
+    return getCallStatsRegistry().enabled.load(std::memory_order_relaxed);
+}
+
+void recordCallStats(const char *function_name, const char *file, int line, const char *caller, uint64_t elapsed_ns,
+                     bool is_error)
+{
+    CallStatsShard &shard = getThreadShard();
+    std::lock_guard<std::mutex> lock(shard.mtx);
+
+    CallSiteCounter &counter = shard.counters[CallSiteKey{function_name, file, caller, line}];
+    ++counter.calls;
+    if (is_error)
+    {
+        ++counter.errors;
+    }
+    counter.total_ns += elapsed_ns;
+    counter.max_ns = std::max(counter.max_ns, elapsed_ns);
+    ++counter.histogram[histogramBucket(elapsed_ns)];
+}
+
+vector<CallSiteStats> getCallStats(const string &function_name)
+{
+    vector<shared_ptr<CallStatsShard>> shards;
+    {
+        CallStatsRegistry &registry = getCallStatsRegistry();
+        std::lock_guard<std::mutex> lock(registry.mtx);
+        shards = registry.shards;
+    }
+
+    map<tuple<string, string, int, string>, CallSiteStats> merged;
+    for (const auto &shard : shards)
+    {
+        std::lock_guard<std::mutex> lock(shard->mtx);
+        for (const auto &entry : shard->counters)
+        {
+            const CallSiteKey &key = entry.first;
+            if (!function_name.empty() && function_name != key.function_name)
+            {
+                continue;
+            }
+
+            CallSiteStats &stats = merged[make_tuple(string(key.function_name), string(key.file), key.line,
+                                                     string(key.caller))];
+            if (stats.calls == 0)
+            {
+                stats.function = key.function_name;
+                stats.file = key.file;
+                stats.line = key.line;
+                stats.caller = key.caller;
+            }
+
+            const CallSiteCounter &counter = entry.second;
+            stats.calls += counter.calls;
+            stats.errors += counter.errors;
+            stats.total_ns += counter.total_ns;
+            stats.max_ns = std::max(stats.max_ns, counter.max_ns);
+            for (size_t i = 0; i < CALL_STATS_HISTOGRAM_BUCKETS; ++i)
+            {
+                stats.histogram[i] += counter.histogram[i];
+            }
+        }
+    }
+
+    vector<CallSiteStats> result;
+    result.reserve(merged.size());
+    for (auto &entry : merged)
+    {
+        result.push_back(std::move(entry.second));
+    }
+    stable_sort(result.begin(), result.end(),
+                [](const CallSiteStats &a, const CallSiteStats &b) { return a.total_ns > b.total_ns; });
+
+    return result;
+}
+
+void resetCallStats()
+{
+    CallStatsRegistry &registry = getCallStatsRegistry();
+    std::lock_guard<std::mutex> lock(registry.mtx);
+    for (const auto &shard : registry.shards)
+    {
+        std::lock_guard<std::mutex> shard_lock(shard->mtx);
+        shard->counters.clear();
+    }
+}
+
+void printCallStats(FILE *out, size_t top_n)
+{
+    const vector<CallSiteStats> stats = getCallStats();
+
+    fprintf(out, "  > call stats hotspots (%zu call sites, top %zu by total time)\n", stats.size(),
+            std::min(top_n, stats.size()));
+    fprintf(out, "  > %-12s %10s %8s %12s %10s %10s %10s %10s  %s\n", "function", "calls", "errors", "total(us)",
+            "avg(us)", "p50(us)", "p99(us)", "max(us)", "call site");
+    for (size_t i = 0; i < stats.size() && i < top_n; ++i)
+    {
+        const CallSiteStats &s = stats[i];
+        fprintf(out, "  > %-12s %10llu %8llu %12s %10s %10s %10s %10s  %s:%d (%s)\n", s.function.c_str(),
+                (unsigned long long)s.calls, (unsigned long long)s.errors, formatMicroseconds(s.total_ns).c_str(),
+                formatMicroseconds(s.total_ns / s.calls).c_str(), formatMicroseconds(s.percentileNs(0.5)).c_str(),
+                formatMicroseconds(s.percentileNs(0.99)).c_str(), formatMicroseconds(s.max_ns).c_str(),
+                s.file.c_str(), s.line, s.caller.c_str());
+    }
+}
+
+void installCallStatsListener(size_t top_n)
+{
+    setCallStatsEnabled(true);
+    UnitTest::GetInstance()->listeners().Append(new CallStatsListener(top_n));
+}
+
+} // namespace testing
@@ -3,20 +3,15 @@
 
 #include <export_check.h>
 
+#include "export_check_impl.h"
 #include <processController.h>
 #include <test_com.h>
 
 #include <cctype>
 #include <cstdlib>
-#include <filesystem>
-#include <fstream>
 #include <regex>
 #include <sstream>
 
-#ifndef _WIN32
-    #include <unistd.h>
-#endif /* _WIN32 */
-
 namespace testing
 {
 
@@ -58,93 +53,59 @@ set<string> parseDumpbinExportNames(const string &stdout_text)
 }
 #endif /* _WIN32 */
 
-#ifndef _WIN32
-// nm -D --defined-only (Linux) の出力からエクスポート シンボル名を抽出する。
-// 例: "0000000000012340 T mylib_open"
-set<string> parseNmExportNames(const string &stdout_text)
-{
-    set<string> names;
-    static const regex line_pattern(R"(^[0-9A-Fa-f]+\s+\S\s+(\S+)\s*$)");
-    istringstream iss(stdout_text);
-    string line;
-    while (getline(iss, line))
-    {
-        smatch m;
-        if (regex_search(line, m, line_pattern))
-        {
-            names.insert(m[1].str());
-        }
-    }
-    return names;
-}
-#endif /* _WIN32 */
+} // namespace
 
-#ifndef _WIN32
-// startProcess (Linux) は execv で子プロセスを起動するため PATH 探索を行わず、
-// 絶対パスの指定を要求する (see: framework/testfw/docs/process-control-api.md)。
-// "nm" のような裸のコマンド名を PATH から解決し、絶対パスへ変換する。
-// 見つからない場合は command をそのまま返し、startProcess 側の失敗として扱う。
-string resolveOnPath(const string &command)
+bool readExportSymbols(const string &dll_or_so_path, vector<ExportSymbolInfo> *symbols, string *diagnostic)
 {
-    const char *path_env = getenv("PATH");
-    if (path_env == nullptr)
+#ifndef _WIN32
+    return readElfDynamicSymbols(dll_or_so_path, symbols, diagnostic);
+#else
+    ProcessOptions opts;
+
+    ProcessResult res = startProcess("dumpbin", {"/exports", dll_or_so_path}, opts);
+    if (res.exit_code != 0)
     {
-        return command;
+        *diagnostic = "dumpbin /exports の実行に失敗しました (exit_code=" + to_string(res.exit_code) +
+                      "): " + res.stderr_out;
+        return false;
     }
-    istringstream iss(path_env);
-    string dir;
-    while (getline(iss, dir, ':'))
+    for (const auto &name : parseDumpbinExportNames(res.stdout_out))
     {
-        if (dir.empty())
-        {
-            continue;
-        }
-        string candidate = dir + "/" + command;
-        if (access(candidate.c_str(), X_OK) == 0)
-        {
-            return candidate;
-        }
+        ExportSymbolInfo info;
+        info.name = name;
+        symbols->push_back(info);
     }
-    return command;
+    return true;
+#endif
 }
-#endif /* _WIN32 */
 
-} // namespace
-
-set<string> getActualExportNames(const string &dll_or_so_path)
+set<string> getActualExportNames(const string &dll_or_so_path, vector<ExportSymbolInfo> *details)
 {
-    ProcessOptions opts;
-
     printf("  > getActualExportNames 対象=\"%s\"\n", dll_or_so_path.c_str());
+#ifdef _WIN32
+    printf("  > getActualExportNames 実行コマンド: dumpbin /exports \"%s\"\n", dll_or_so_path.c_str());
+#endif
 
-#ifndef _WIN32
-    string nm_path = resolveOnPath("nm");
-    printf("  > getActualExportNames 実行コマンド: %s -D --defined-only \"%s\"\n", nm_path.c_str(),
-           dll_or_so_path.c_str());
-    ProcessResult res = startProcess(nm_path, {"-D", "--defined-only", dll_or_so_path}, opts);
-    if (res.exit_code != 0)
+    vector<ExportSymbolInfo> symbols;
+    string diagnostic;
+    if (!readExportSymbols(dll_or_so_path, &symbols, &diagnostic))
     {
-        ADD_FAILURE() << "nm -D --defined-only の実行に失敗しました (exit_code=" << res.exit_code
-                      << "): " << res.stderr_out;
+        ADD_FAILURE() << "エクスポート シンボルの取得に失敗しました: " << diagnostic << " 対象: " << dll_or_so_path;
         return {};
     }
-    set<string> names = parseNmExportNames(res.stdout_out);
-#else
-    printf("  > getActualExportNames 実行コマンド: dumpbin /exports \"%s\"\n", dll_or_so_path.c_str());
-    ProcessResult res = startProcess("dumpbin", {"/exports", dll_or_so_path}, opts);
-    if (res.exit_code != 0)
+    set<string> names;
+    for (const auto &symbol : symbols)
     {
-        ADD_FAILURE() << "dumpbin /exports の実行に失敗しました (exit_code=" << res.exit_code
-                      << "): " << res.stderr_out;
-        return {};
+        names.insert(symbol.name);
+    }
+    if (details != nullptr)
+    {
+        *details = symbols;
     }
-    set<string> names = parseDumpbinExportNames(res.stdout_out);
-#endif
 
     if (names.empty())
     {
-        ADD_FAILURE() << "エクスポート シンボルを 1 件も取得できませんでした。対象: " << dll_or_so_path
-                      << " 出力: " << res.stdout_out;
+        ADD_FAILURE() << "エクスポート シンボルを 1 件も取得できませんでした。対象: " << dll_or_so_path;
     }
 
     printf("  > getActualExportNames 実際のエクスポート シンボル数=%zu\n", names.size());
@@ -156,10 +117,7 @@ set<string> getActualExportNames(const string &dll_or_so_path)
     return names;
 }
 
-namespace
-{
-
-// Linux の nm -D --defined-only が返すリンカー合成シンボル。
+// Linux の動的シンボル表に現れるリンカー合成シンボル。
 // dumpbin /exports には現れないため、両 OS の比較条件を揃える目的で actual から除外する。
 // 公開 API のアンダースコア始まり (_com_util_* 等) は除外しない。
 bool isLinkerSyntheticSymbol(const string &name)
@@ -167,8 +125,6 @@ bool isLinkerSyntheticSymbol(const string &name)
     return name == "__bss_start" || name == "_edata" || name == "_end";
 }
 
-} // namespace
-
 void expectExportNamesMatch(const set<string> &expected, const set<string> &actual,
                             const map<string, string> &signatures)
 {
@@ -220,59 +176,6 @@ void expectExportNamesMatch(const set<string> &expected, const set<string> &actu
     EXPECT_TRUE(extra.empty()) << "想定外のエクスポート: " << joinNames(extra);
 }
 
-vector<string> findUndecoratedExternVariables(const string &include_dir, const string &export_macro_name)
-{
-    vector<string> undecorated;
-    static const regex extern_c_pattern(R"(^\s*extern\s+"C")");
-    static const regex extern_var_pattern(R"(^\s*extern\s+[^()]+;\s*(//.*)?$)");
-
-    printf("  > findUndecoratedExternVariables include_dir=\"%s\" export_macro_name=\"%s\"\n", include_dir.c_str(),
-           export_macro_name.c_str());
-
-    namespace fs = std::filesystem;
-    if (!fs::exists(include_dir))
-    {
-        printf("  > findUndecoratedExternVariables include_dir が存在しないため走査対象なし\n");
-        return undecorated;
-    }
-
-    size_t header_count = 0;
-    for (const auto &entry : fs::recursive_directory_iterator(include_dir))
-    {
-        if (!entry.is_regular_file() || entry.path().extension() != ".h")
-        {
-            continue;
-        }
-        ++header_count;
-        printf("  >   header: %s\n", entry.path().string().c_str());
-
-        ifstream ifs(entry.path());
-        string line;
-        while (getline(ifs, line))
-        {
-            if (regex_search(line, extern_c_pattern))
-            {
-                continue;
-            }
-            if (!regex_search(line, extern_var_pattern))
-            {
-                continue;
-            }
-            bool decorated = line.find(export_macro_name) != string::npos;
-            printf("  >     variable: %s [%s]\n", line.c_str(), decorated ? "OK" : "MISSING_EXPORT");
-            if (!decorated)
-            {
-                undecorated.push_back(entry.path().string() + ": " + line);
-            }
-        }
-    }
-
-    printf("  > findUndecoratedExternVariables 走査したヘッダー数=%zu %s を伴わない extern 変数宣言=%zu 件\n",
-           header_count, export_macro_name.c_str(), undecorated.size());
-
-    return undecorated;
-}
-
 string identManifestSymbolName(const string &target)
 {
     // gen_ident_manifest.py の sanitize_symbol() と同じ規則: [^A-Za-z0-9_] を '_' に置換する。
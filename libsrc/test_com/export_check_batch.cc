@@ -0,0 +1,273 @@
+/* 複数の DLL/SO のエクスポート検証をスレッド プールで並列に行う。
+ * 読み取ったエクスポート表は (パス, デバイス, i-node, サイズ, 更新日時) をキーにプロセス内でキャッシュする。 */
+
+#include "export_check_impl.h"
+#include <test_com.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+
+#ifndef _WIN32
+    #include <cerrno>
+    #include <cstring>
+
+    #include <sys/stat.h>
+#endif
+
+namespace testing
+{
+
+namespace
+{
+
+struct ExportTableCacheEntry
+{
+    uint64_t dev = 0;
+    uint64_t ino = 0;
+    int64_t mtime = 0;
+    uint64_t size = 0;
+    string build_id;
+    set<string> names;
+};
+
+std::mutex &getExportTableCacheMutex()
+{
+    static std::mutex mtx;
+    return mtx;
+}
+
+map<string, ExportTableCacheEntry> &getExportTableCache()
+{
+    static map<string, ExportTableCacheEntry> cache;
+    return cache;
+}
+
+// キャッシュ キーのうち、パス以外の要素 (デバイス, i-node, サイズ, 更新日時) を stat 1 回で取得する。
+bool readFileIdentity(const string &path, ExportTableCacheEntry *identity, string *diagnostic)
+{
+#ifndef _WIN32
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0)
+    {
+        *diagnostic = "ファイルの属性を取得できませんでした: " + string(strerror(errno));
+        return false;
+    }
+    identity->dev = (uint64_t)st.st_dev;
+    identity->ino = (uint64_t)st.st_ino;
+    identity->size = (uint64_t)st.st_size;
+    identity->mtime = (int64_t)st.st_mtim.tv_sec * 1000000000 + (int64_t)st.st_mtim.tv_nsec;
+#else
+    namespace fs = std::filesystem;
+    std::error_code ec;
+
+    identity->size = (uint64_t)fs::file_size(path, ec);
+    if (ec)
+    {
+        *diagnostic = "ファイル サイズを取得できませんでした: " + ec.message();
+        return false;
+    }
+    identity->mtime = (int64_t)fs::last_write_time(path, ec).time_since_epoch().count();
+    if (ec)
+    {
+        *diagnostic = "更新日時を取得できませんでした: " + ec.message();
+        return false;
+    }
+#endif
+
+    return true;
+}
+
+// キャッシュが有効ならそれを、無効なら読み取ってキャッシュに登録したエクスポート表を返す。
+// (デバイス, i-node, サイズ, 更新日時) が一致すればファイルを開かずにヒットとする。
+// 一致しない場合のみビルド ID を読み取り、サイズとビルド ID が一致すれば (内容が同じまま再生成された SO)
+// キーを更新してヒットとする。
+bool loadExportNames(const string &path, set<string> *names, bool *cache_hit, string *diagnostic)
+{
+    ExportTableCacheEntry identity;
+    if (!readFileIdentity(path, &identity, diagnostic))
+    {
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(getExportTableCacheMutex());
+        const auto cached = getExportTableCache().find(path);
+        if (cached != getExportTableCache().end() && cached->second.dev == identity.dev &&
+            cached->second.ino == identity.ino && cached->second.size == identity.size &&
+            cached->second.mtime == identity.mtime)
+        {
+            *names = cached->second.names;
+            *cache_hit = true;
+            return true;
+        }
+    }
+
+#ifndef _WIN32
+    identity.build_id = readElfBuildId(path);
+    if (!identity.build_id.empty())
+    {
+        std::lock_guard<std::mutex> lock(getExportTableCacheMutex());
+        const auto cached = getExportTableCache().find(path);
+        if (cached != getExportTableCache().end() && cached->second.size == identity.size &&
+            cached->second.build_id == identity.build_id)
+        {
+            identity.names = cached->second.names;
+            cached->second = identity;
+            *names = identity.names;
+            *cache_hit = true;
+            return true;
+        }
+    }
+#endif
+
+    vector<ExportSymbolInfo> symbols;
+    if (!readExportSymbols(path, &symbols, diagnostic))
+    {
+        return false;
+    }
+    for (const auto &symbol : symbols)
+    {
+        if (!isLinkerSyntheticSymbol(symbol.name))
+        {
+            identity.names.insert(symbol.name);
+        }
+    }
+    *names = identity.names;
+
+    std::lock_guard<std::mutex> lock(getExportTableCacheMutex());
+    getExportTableCache()[path] = identity;
+
+    return true;
+}
+
+ExportCheckResult verifyOne(const ExportCheckTarget &target)
+{
+    ExportCheckResult result;
+    set<string> actual;
+
+    result.dll_or_so_path = target.dll_or_so_path;
+    if (!loadExportNames(target.dll_or_so_path, &actual, &result.cache_hit, &result.diagnostic))
+    {
+        return result;
+    }
+    result.actual_count = actual.size();
+
+    for (const auto &name : target.expected)
+    {
+        if (actual.find(name) != actual.end())
+        {
+            continue;
+        }
+        auto sig_it = target.signatures.find(name);
+        result.missing.push_back(sig_it != target.signatures.end() ? name + " [" + sig_it->second + "]" : name);
+    }
+    for (const auto &name : actual)
+    {
+        if (target.expected.find(name) == target.expected.end())
+        {
+            result.extra.push_back(name);
+        }
+    }
+
+    result.ok = result.missing.empty() && result.extra.empty();
+    return result;
+}
+
+} // namespace
+
+vector<ExportCheckResult> verifyExportNames(const vector<ExportCheckTarget> &targets, size_t max_threads)
+{
+    vector<ExportCheckResult> results(targets.size());
+
+    if (max_threads == 0)
+    {
+        max_threads = std::max<size_t>(1U, (size_t)std::thread::hardware_concurrency());
+    }
+    const size_t thread_count = std::min(max_threads, targets.size());
+
+    std::atomic<size_t> next_index{0};
+    auto worker = [&]() {
+        for (size_t i = next_index++; i < targets.size(); i = next_index++)
+        {
+            results[i] = verifyOne(targets[i]);
+        }
+    };
+
+    if (thread_count <= 1U)
+    {
+        worker();
+        return results;
+    }
+
+    vector<std::thread> threads;
+    for (size_t i = 0; i < thread_count; ++i)
+    {
+        threads.emplace_back(worker);
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    return results;
+}
+
+void expectAllExportNamesMatch(const vector<ExportCheckTarget> &targets, size_t max_threads)
+{
+    const auto start = std::chrono::steady_clock::now();
+    const vector<ExportCheckResult> results = verifyExportNames(targets, max_threads);
+    const auto elapsed_ms =
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+    size_t ng_count = 0;
+    size_t cache_hit_count = 0;
+    for (const auto &result : results)
+    {
+        if (result.cache_hit)
+        {
+            ++cache_hit_count;
+        }
+        if (result.ok)
+        {
+            continue;
+        }
+
+        ++ng_count;
+        if (!result.diagnostic.empty())
+        {
+            printf("  >   NG %s: %s\n", result.dll_or_so_path.c_str(), result.diagnostic.c_str());
+            ADD_FAILURE() << "エクスポート シンボルの取得に失敗しました: " << result.diagnostic
+                          << " 対象: " << result.dll_or_so_path;
+            continue;
+        }
+        printf("  >   NG %s: missing=%zu extra=%zu\n", result.dll_or_so_path.c_str(), result.missing.size(),
+               result.extra.size());
+        for (const auto &name : result.missing)
+        {
+            printf("  >     missing: %s\n", name.c_str());
+        }
+        for (const auto &name : result.extra)
+        {
+            printf("  >     extra: %s\n", name.c_str());
+        }
+        EXPECT_TRUE(result.missing.empty()) << result.dll_or_so_path
+                                            << " の不足しているエクスポート: " << joinNames(result.missing);
+        EXPECT_TRUE(result.extra.empty()) << result.dll_or_so_path
+                                          << " の想定外のエクスポート: " << joinNames(result.extra);
+    }
+
+    printf("  > expectAllExportNamesMatch 対象=%zu 一致=%zu 不一致=%zu (キャッシュ ヒット=%zu, %lldms)\n",
+           results.size(), results.size() - ng_count, ng_count, cache_hit_count, (long long)elapsed_ms);
+}
+
+void clearExportNamesCache()
+{
+    std::lock_guard<std::mutex> lock(getExportTableCacheMutex());
+    getExportTableCache().clear();
+}
+
+} // namespace testing
@@ -0,0 +1,675 @@
+/* ELF 共有オブジェクトの動的シンボル表をプロセス内で読み取る (getActualExportNames の Linux 実装)。
+ * nm を子プロセスとして起動し stdout を正規表現で解析する方式は、SO ごとのプロセス起動と
+ * 行ごとの正規表現評価が支配的となるため、SO を mmap して .dynsym を直接走査する。 */
+
+#ifndef _WIN32
+
+    #include "export_check_impl.h"
+
+    #include <cstring>
+    #include <map>
+    #include <string>
+    #include <vector>
+
+    #include <elf.h>
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+
+namespace testing
+{
+
+namespace
+{
+
+// 読み取り専用で mmap したファイル。範囲外参照を防ぐため、読み取りはすべて read() / str() を経由する。
+class MappedImage
+{
+  public:
+    MappedImage() = default;
+    MappedImage(const MappedImage &) = delete;
+    MappedImage &operator=(const MappedImage &) = delete;
+
+    ~MappedImage()
+    {
+        if (data_ != nullptr)
+        {
+            munmap(data_, size_);
+        }
+    }
+
+    bool open(const string &path, string *diagnostic)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd == -1)
+        {
+            *diagnostic = "open に失敗しました: " + string(strerror(errno));
+            return false;
+        }
+
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size <= 0)
+        {
+            *diagnostic = "ファイル サイズを取得できませんでした";
+            close(fd);
+            return false;
+        }
+
+        size_ = (size_t)st.st_size;
+        void *mapped = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (mapped == MAP_FAILED)
+        {
+            *diagnostic = "mmap に失敗しました: " + string(strerror(errno));
+            return false;
+        }
+        data_ = mapped;
+
+        return true;
+    }
+
+    template <typename T> bool read(uint64_t offset, T *out) const
+    {
+        if (offset > size_ || size_ - offset < sizeof(T))
+        {
+            return false;
+        }
+        memcpy(out, (const unsigned char *)data_ + offset, sizeof(T));
+        return true;
+    }
+
+    // offset から limit バイト以内の NUL 終端文字列を返す。範囲外や終端なしは空文字列。
+    string str(uint64_t offset, uint64_t limit) const
+    {
+        if (offset >= size_)
+        {
+            return "";
+        }
+        const uint64_t available = size_ - offset;
+        const char *begin = (const char *)data_ + offset;
+        const size_t max_len = (size_t)(limit < available ? limit : available);
+        const size_t len = strnlen(begin, max_len);
+        if (len == max_len)
+        {
+            return "";
+        }
+        return string(begin, len);
+    }
+
+  private:
+    void *data_ = nullptr;
+    size_t size_ = 0;
+};
+
+// .gnu.version の各要素のビット構成 (バージョン インデックスと、既定バージョンでないことを示す hidden ビット)。
+constexpr uint16_t kVersymVersionMask = 0x7fff;
+constexpr uint16_t kVersymHidden = 0x8000;
+
+// 動的シンボル表の所在 (ファイル オフセット)。
+struct DynamicTables
+{
+    uint64_t symtab_offset = 0;
+    uint64_t symtab_count = 0;
+    uint64_t symtab_entsize = 0;
+    uint64_t strtab_offset = 0;
+    uint64_t strtab_size = 0;
+    uint64_t versym_offset = 0; // 0 = .gnu.version なし
+    uint64_t verdef_offset = 0; // 0 = .gnu.version_d なし
+    uint64_t verdef_count = 0;
+    uint64_t verdef_strtab_offset = 0;
+    uint64_t verdef_strtab_size = 0;
+};
+
+struct Elf32Types
+{
+    using Ehdr = Elf32_Ehdr;
+    using Shdr = Elf32_Shdr;
+    using Phdr = Elf32_Phdr;
+    using Dyn = Elf32_Dyn;
+    using Sym = Elf32_Sym;
+};
+
+struct Elf64Types
+{
+    using Ehdr = Elf64_Ehdr;
+    using Shdr = Elf64_Shdr;
+    using Phdr = Elf64_Phdr;
+    using Dyn = Elf64_Dyn;
+    using Sym = Elf64_Sym;
+};
+
+const char *symbolTypeName(unsigned int type)
+{
+    switch (type)
+    {
+    case STT_NOTYPE:
+        return "NOTYPE";
+    case STT_OBJECT:
+        return "OBJECT";
+    case STT_FUNC:
+        return "FUNC";
+    case STT_SECTION:
+        return "SECTION";
+    case STT_FILE:
+        return "FILE";
+    case STT_COMMON:
+        return "COMMON";
+    case STT_TLS:
+        return "TLS";
+    case STT_GNU_IFUNC:
+        return "IFUNC";
+    default:
+        return "UNKNOWN";
+    }
+}
+
+const char *symbolBindingName(unsigned int binding)
+{
+    switch (binding)
+    {
+    case STB_LOCAL:
+        return "LOCAL";
+    case STB_GLOBAL:
+        return "GLOBAL";
+    case STB_WEAK:
+        return "WEAK";
+    case STB_GNU_UNIQUE:
+        return "UNIQUE";
+    default:
+        return "UNKNOWN";
+    }
+}
+
+const char *symbolVisibilityName(unsigned int visibility)
+{
+    switch (visibility)
+    {
+    case STV_DEFAULT:
+        return "DEFAULT";
+    case STV_INTERNAL:
+        return "INTERNAL";
+    case STV_HIDDEN:
+        return "HIDDEN";
+    case STV_PROTECTED:
+        return "PROTECTED";
+    default:
+        return "UNKNOWN";
+    }
+}
+
+// セクション ヘッダーから .dynsym / .dynstr / .gnu.version / .gnu.version_d を探す。
+template <typename Types>
+bool findTablesBySections(const MappedImage &image, const typename Types::Ehdr &ehdr, DynamicTables *tables)
+{
+    using Shdr = typename Types::Shdr;
+
+    if (ehdr.e_shoff == 0 || ehdr.e_shnum == 0 || ehdr.e_shentsize < sizeof(Shdr))
+    {
+        return false;
+    }
+
+    vector<Shdr> sections(ehdr.e_shnum);
+    for (size_t i = 0; i < sections.size(); ++i)
+    {
+        if (!image.read(ehdr.e_shoff + (uint64_t)i * ehdr.e_shentsize, &sections[i]))
+        {
+            return false;
+        }
+    }
+
+    bool found = false;
+    for (const auto &section : sections)
+    {
+        switch (section.sh_type)
+        {
+        case SHT_DYNSYM:
+            if (section.sh_entsize < sizeof(typename Types::Sym) || section.sh_link >= sections.size())
+            {
+                return false;
+            }
+            tables->symtab_offset = section.sh_offset;
+            tables->symtab_entsize = section.sh_entsize;
+            tables->symtab_count = section.sh_size / section.sh_entsize;
+            tables->strtab_offset = sections[section.sh_link].sh_offset;
+            tables->strtab_size = sections[section.sh_link].sh_size;
+            found = true;
+            break;
+        case SHT_GNU_versym:
+            tables->versym_offset = section.sh_offset;
+            break;
+        case SHT_GNU_verdef:
+            if (section.sh_link < sections.size())
+            {
+                tables->verdef_offset = section.sh_offset;
+                tables->verdef_count = section.sh_info;
+                tables->verdef_strtab_offset = sections[section.sh_link].sh_offset;
+                tables->verdef_strtab_size = sections[section.sh_link].sh_size;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    return found;
+}
+
+// 仮想アドレスを PT_LOAD セグメントからファイル オフセットへ変換する。
+template <typename Types> bool vaddrToOffset(const vector<typename Types::Phdr> &loads, uint64_t vaddr, uint64_t *offset)
+{
+    for (const auto &phdr : loads)
+    {
+        if (vaddr >= phdr.p_vaddr && vaddr - phdr.p_vaddr < phdr.p_filesz)
+        {
+            *offset = phdr.p_offset + (vaddr - phdr.p_vaddr);
+            return true;
+        }
+    }
+    return false;
+}
+
+// DT_GNU_HASH から動的シンボル数を求める (最大のバケット値からチェーン終端までを辿る)。
+template <typename Types> bool countSymbolsByGnuHash(const MappedImage &image, uint64_t offset, uint64_t *count)
+{
+    uint32_t header[4]; // nbuckets, symoffset, bloom_size, bloom_shift
+    for (size_t i = 0; i < 4; ++i)
+    {
+        if (!image.read(offset + i * sizeof(uint32_t), &header[i]))
+        {
+            return false;
+        }
+    }
+
+    const uint32_t nbuckets = header[0];
+    const uint32_t symoffset = header[1];
+    const uint64_t bloom_word_size = sizeof(typename Types::Ehdr) == sizeof(Elf64_Ehdr) ? 8U : 4U;
+    const uint64_t buckets_offset = offset + 16U + (uint64_t)header[2] * bloom_word_size;
+    const uint64_t chains_offset = buckets_offset + (uint64_t)nbuckets * sizeof(uint32_t);
+
+    uint32_t max_index = 0;
+    for (uint32_t i = 0; i < nbuckets; ++i)
+    {
+        uint32_t bucket;
+        if (!image.read(buckets_offset + (uint64_t)i * sizeof(uint32_t), &bucket))
+        {
+            return false;
+        }
+        if (bucket > max_index)
+        {
+            max_index = bucket;
+        }
+    }
+
+    if (max_index < symoffset)
+    {
+        *count = symoffset;
+        return true;
+    }
+
+    for (;;)
+    {
+        uint32_t chain;
+        if (!image.read(chains_offset + (uint64_t)(max_index - symoffset) * sizeof(uint32_t), &chain))
+        {
+            return false;
+        }
+        if ((chain & 1U) != 0U)
+        {
+            break;
+        }
+        ++max_index;
+    }
+
+    *count = (uint64_t)max_index + 1U;
+    return true;
+}
+
+// セクション ヘッダーが除去されている SO 向けに、PT_DYNAMIC から動的シンボル表を探す。
+template <typename Types>
+bool findTablesByDynamic(const MappedImage &image, const typename Types::Ehdr &ehdr, DynamicTables *tables)
+{
+    using Phdr = typename Types::Phdr;
+    using Dyn = typename Types::Dyn;
+
+    if (ehdr.e_phoff == 0 || ehdr.e_phnum == 0 || ehdr.e_phentsize < sizeof(Phdr))
+    {
+        return false;
+    }
+
+    vector<Phdr> loads;
+    Phdr dynamic{};
+    bool has_dynamic = false;
+    for (size_t i = 0; i < ehdr.e_phnum; ++i)
+    {
+        Phdr phdr;
+        if (!image.read(ehdr.e_phoff + (uint64_t)i * ehdr.e_phentsize, &phdr))
+        {
+            return false;
+        }
+        if (phdr.p_type == PT_LOAD)
+        {
+            loads.push_back(phdr);
+        }
+        else if (phdr.p_type == PT_DYNAMIC)
+        {
+            dynamic = phdr;
+            has_dynamic = true;
+        }
+    }
+    if (!has_dynamic)
+    {
+        return false;
+    }
+
+    uint64_t symtab = 0, strtab = 0, strsz = 0, syment = sizeof(typename Types::Sym);
+    uint64_t hash = 0, gnu_hash = 0, versym = 0, verdef = 0, verdefnum = 0;
+    for (uint64_t off = dynamic.p_offset; off + sizeof(Dyn) <= dynamic.p_offset + dynamic.p_filesz; off += sizeof(Dyn))
+    {
+        Dyn dyn;
+        if (!image.read(off, &dyn) || dyn.d_tag == DT_NULL)
+        {
+            break;
+        }
+        const uint64_t value = (uint64_t)dyn.d_un.d_val;
+        switch (dyn.d_tag)
+        {
+        case DT_SYMTAB:
+            symtab = value;
+            break;
+        case DT_STRTAB:
+            strtab = value;
+            break;
+        case DT_STRSZ:
+            strsz = value;
+            break;
+        case DT_SYMENT:
+            syment = value;
+            break;
+        case DT_HASH:
+            hash = value;
+            break;
+        case DT_GNU_HASH:
+            gnu_hash = value;
+            break;
+        case DT_VERSYM:
+            versym = value;
+            break;
+        case DT_VERDEF:
+            verdef = value;
+            break;
+        case DT_VERDEFNUM:
+            verdefnum = value;
+            break;
+        default:
+            break;
+        }
+    }
+
+    if (symtab == 0 || strtab == 0 || syment < sizeof(typename Types::Sym) ||
+        !vaddrToOffset<Types>(loads, symtab, &tables->symtab_offset) ||
+        !vaddrToOffset<Types>(loads, strtab, &tables->strtab_offset))
+    {
+        return false;
+    }
+    tables->symtab_entsize = syment;
+    tables->strtab_size = strsz;
+
+    uint64_t hash_offset;
+    if (gnu_hash != 0 && vaddrToOffset<Types>(loads, gnu_hash, &hash_offset))
+    {
+        if (!countSymbolsByGnuHash<Types>(image, hash_offset, &tables->symtab_count))
+        {
+            return false;
+        }
+    }
+    else if (hash != 0 && vaddrToOffset<Types>(loads, hash, &hash_offset))
+    {
+        uint32_t nchain; // DT_HASH: nbucket, nchain, ... (nchain = シンボル数)
+        if (!image.read(hash_offset + sizeof(uint32_t), &nchain))
+        {
+            return false;
+        }
+        tables->symtab_count = nchain;
+    }
+    else
+    {
+        return false;
+    }
+
+    if (versym != 0 && !vaddrToOffset<Types>(loads, versym, &tables->versym_offset))
+    {
+        tables->versym_offset = 0;
+    }
+    if (verdef != 0 && vaddrToOffset<Types>(loads, verdef, &tables->verdef_offset))
+    {
+        tables->verdef_count = verdefnum;
+        tables->verdef_strtab_offset = tables->strtab_offset;
+        tables->verdef_strtab_size = tables->strtab_size;
+    }
+    else
+    {
+        tables->verdef_offset = 0;
+    }
+
+    return true;
+}
+
+// .gnu.version_d からバージョン インデックス → バージョン名を組み立てる。基底バージョン (SO 名) は含めない。
+map<uint16_t, string> readVersionDefinitions(const MappedImage &image, const DynamicTables &tables)
+{
+    map<uint16_t, string> versions;
+    uint64_t offset = tables.verdef_offset;
+
+    for (uint64_t i = 0; i < tables.verdef_count && offset != 0; ++i)
+    {
+        Elf64_Verdef verdef; // Elf32_Verdef と同一レイアウト
+        if (!image.read(offset, &verdef))
+        {
+            break;
+        }
+        Elf64_Verdaux verdaux;
+        if ((verdef.vd_flags & VER_FLG_BASE) == 0 && verdef.vd_cnt > 0 &&
+            image.read(offset + verdef.vd_aux, &verdaux) && verdaux.vda_name < tables.verdef_strtab_size)
+        {
+            versions[verdef.vd_ndx] =
+                image.str(tables.verdef_strtab_offset + verdaux.vda_name, tables.verdef_strtab_size - verdaux.vda_name);
+        }
+        if (verdef.vd_next == 0)
+        {
+            break;
+        }
+        offset += verdef.vd_next;
+    }
+
+    return versions;
+}
+
+template <typename Types>
+bool readSymbols(const MappedImage &image, vector<ExportSymbolInfo> *symbols, string *diagnostic)
+{
+    using Ehdr = typename Types::Ehdr;
+    using Sym = typename Types::Sym;
+
+    Ehdr ehdr;
+    if (!image.read(0, &ehdr))
+    {
+        *diagnostic = "ELF ヘッダーを読み取れませんでした";
+        return false;
+    }
+
+    DynamicTables tables;
+    if (!findTablesBySections<Types>(image, ehdr, &tables) && !findTablesByDynamic<Types>(image, ehdr, &tables))
+    {
+        *diagnostic = "動的シンボル表 (.dynsym) が見つかりませんでした";
+        return false;
+    }
+
+    const map<uint16_t, string> versions = readVersionDefinitions(image, tables);
+
+    // インデックス 0 は常に未定義の NULL シンボル
+    for (uint64_t i = 1; i < tables.symtab_count; ++i)
+    {
+        Sym sym;
+        if (!image.read(tables.symtab_offset + i * tables.symtab_entsize, &sym))
+        {
+            *diagnostic = "動的シンボル表がファイル範囲外を指しています";
+            return false;
+        }
+        if (sym.st_shndx == SHN_UNDEF || sym.st_name >= tables.strtab_size)
+        {
+            continue;
+        }
+
+        ExportSymbolInfo info;
+        info.name = image.str(tables.strtab_offset + sym.st_name, tables.strtab_size - sym.st_name);
+        if (info.name.empty())
+        {
+            continue;
+        }
+        info.type = symbolTypeName(ELF64_ST_TYPE(sym.st_info));
+        info.binding = symbolBindingName(ELF64_ST_BIND(sym.st_info));
+        info.visibility = symbolVisibilityName(ELF64_ST_VISIBILITY(sym.st_other));
+        info.size = (uint64_t)sym.st_size;
+
+        uint16_t versym;
+        if (tables.versym_offset != 0 && image.read(tables.versym_offset + i * sizeof(uint16_t), &versym))
+        {
+            const auto version = versions.find((uint16_t)(versym & kVersymVersionMask));
+            // バージョン定義自身を表すシンボル (名前 = バージョン名) は nm と同様にバージョンを付けない
+            if (version != versions.end() && version->second != info.name)
+            {
+                info.version = version->second;
+                info.default_version = (versym & kVersymHidden) == 0;
+            }
+        }
+
+        symbols->push_back(info);
+    }
+
+    return true;
+}
+
+// PT_NOTE セグメントから NT_GNU_BUILD_ID ノートを探し、16 進文字列で返す。
+template <typename Types> string readBuildId(const MappedImage &image)
+{
+    using Ehdr = typename Types::Ehdr;
+    using Phdr = typename Types::Phdr;
+    static const char hex_digits[] = "0123456789abcdef";
+
+    Ehdr ehdr;
+    if (!image.read(0, &ehdr) || ehdr.e_phoff == 0 || ehdr.e_phentsize < sizeof(Phdr))
+    {
+        return "";
+    }
+
+    for (size_t i = 0; i < ehdr.e_phnum; ++i)
+    {
+        Phdr phdr;
+        if (!image.read(ehdr.e_phoff + (uint64_t)i * ehdr.e_phentsize, &phdr) || phdr.p_type != PT_NOTE)
+        {
+            continue;
+        }
+
+        uint64_t offset = phdr.p_offset;
+        const uint64_t end = phdr.p_offset + phdr.p_filesz;
+        while (offset + sizeof(Elf64_Nhdr) <= end)
+        {
+            Elf64_Nhdr nhdr; // Elf32_Nhdr と同一レイアウト
+            if (!image.read(offset, &nhdr))
+            {
+                break;
+            }
+            const uint64_t name_offset = offset + sizeof(Elf64_Nhdr);
+            const uint64_t desc_offset = name_offset + ((nhdr.n_namesz + 3U) & ~3U);
+            if (nhdr.n_type == NT_GNU_BUILD_ID && nhdr.n_namesz == 4U && image.str(name_offset, 4U) == "GNU")
+            {
+                string build_id;
+                for (uint64_t j = 0; j < nhdr.n_descsz; ++j)
+                {
+                    unsigned char byte;
+                    if (!image.read(desc_offset + j, &byte))
+                    {
+                        return "";
+                    }
+                    build_id += hex_digits[byte >> 4];
+                    build_id += hex_digits[byte & 0x0fU];
+                }
+                return build_id;
+            }
+            offset = desc_offset + ((nhdr.n_descsz + 3U) & ~3U);
+        }
+    }
+
+    return "";
+}
+
+} // namespace
+
+bool readElfDynamicSymbols(const string &so_path, vector<ExportSymbolInfo> *symbols, string *diagnostic)
+{
+    MappedImage image;
+    if (!image.open(so_path, diagnostic))
+    {
+        return false;
+    }
+
+    unsigned char ident[EI_NIDENT];
+    if (!image.read(0, &ident) || memcmp(ident, ELFMAG, SELFMAG) != 0)
+    {
+        *diagnostic = "ELF ファイルではありません";
+        return false;
+    }
+
+    #if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    const unsigned char native_data = ELFDATA2LSB;
+    #else
+    const unsigned char native_data = ELFDATA2MSB;
+    #endif
+    if (ident[EI_DATA] != native_data)
+    {
+        *diagnostic = "ホストと異なるバイト オーダーの ELF には対応していません";
+        return false;
+    }
+
+    switch (ident[EI_CLASS])
+    {
+    case ELFCLASS32:
+        return readSymbols<Elf32Types>(image, symbols, diagnostic);
+    case ELFCLASS64:
+        return readSymbols<Elf64Types>(image, symbols, diagnostic);
+    default:
+        *diagnostic = "未知の ELF クラスです";
+        return false;
+    }
+}
+
+string readElfBuildId(const string &so_path)
+{
+    MappedImage image;
+    string diagnostic;
+    if (!image.open(so_path, &diagnostic))
+    {
+        return "";
+    }
+
+    unsigned char ident[EI_NIDENT];
+    if (!image.read(0, &ident) || memcmp(ident, ELFMAG, SELFMAG) != 0)
+    {
+        return "";
+    }
+
+    switch (ident[EI_CLASS])
+    {
+    case ELFCLASS32:
+        return readBuildId<Elf32Types>(image);
+    case ELFCLASS64:
+        return readBuildId<Elf64Types>(image);
+    default:
+        return "";
+    }
+}
+
+} // namespace testing
+
+#endif /* _WIN32 */
@@ -0,0 +1,49 @@
+#pragma once
+
+/* export_check の内部実装定義。
+ * このヘッダーは export_check*.cc のみが include する非公開ヘッダー。 */
+
+#include <export_check.h>
+
+#include <string>
+#include <vector>
+
+namespace testing
+{
+
+/**
+ * DLL/SO のエクスポート シンボルを取得する (getActualExportNames の本体)。
+ * stdout への出力や gtest への失敗報告は行わないため、ワーカー スレッドから呼び出せる。
+ *
+ * @param dll_or_so_path  対象の DLL/SO のパス
+ * @param symbols         取得したシンボルの格納先
+ * @param diagnostic      失敗時の理由
+ * @return 取得に成功した場合 true
+ */
+extern bool readExportSymbols(const string &dll_or_so_path, vector<ExportSymbolInfo> *symbols, string *diagnostic);
+
+/** 比較対象から除外するリンカー合成シンボル (__bss_start / _edata / _end) か。 */
+extern bool isLinkerSyntheticSymbol(const string &name);
+
+#ifndef _WIN32
+
+/**
+ * ELF 共有オブジェクトを mmap し、動的シンボル表から定義済みシンボルを読み取る。
+ * 未定義シンボル (SHN_UNDEF) と名前が空のシンボルは含めない。
+ *
+ * @param so_path     対象の SO のパス
+ * @param symbols     読み取ったシンボルの格納先 (.dynsym の出現順)
+ * @param diagnostic  失敗時の理由
+ * @return 読み取りに成功した場合 true
+ */
+extern bool readElfDynamicSymbols(const string &so_path, vector<ExportSymbolInfo> *symbols, string *diagnostic);
+
+/**
+ * ELF 共有オブジェクトの GNU ビルド ID (NT_GNU_BUILD_ID) を 16 進文字列で取得する。
+ * ビルド ID を持たない場合や読み取りに失敗した場合は空文字列を返す。
+ */
+extern string readElfBuildId(const string &so_path);
+
+#endif /* _WIN32 */
+
+} // namespace testing
@@ -0,0 +1,476 @@
+/* 公開ヘッダーから export マクロを伴わない extern 変数宣言を検出する (findUndecoratedExternVariables)。
+ * 行単位の std::regex 評価は複数行にまたがる宣言を検出できないため、ヘッダーを mmap して
+ * 1 パスの字句解析で宣言を切り出し、複数のヘッダーを並列に走査する。 */
+
+#include <export_check.h>
+#include <test_com.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#ifndef _WIN32
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif /* _WIN32 */
+
+namespace testing
+{
+
+namespace
+{
+
+// ヘッダーの内容。Linux では mmap、Windows では読み込んだ文字列を参照する。
+class HeaderText
+{
+  public:
+    HeaderText() = default;
+    HeaderText(const HeaderText &) = delete;
+    HeaderText &operator=(const HeaderText &) = delete;
+
+    ~HeaderText()
+    {
+#ifndef _WIN32
+        if (mapped_ != nullptr)
+        {
+            munmap(mapped_, size_);
+        }
+#endif /* _WIN32 */
+    }
+
+    bool open(const string &path)
+    {
+#ifndef _WIN32
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd == -1)
+        {
+            return false;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0)
+        {
+            close(fd);
+            return false;
+        }
+        size_ = (size_t)st.st_size;
+        if (size_ == 0)
+        {
+            close(fd);
+            data_ = "";
+            return true;
+        }
+        void *mapped = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (mapped == MAP_FAILED)
+        {
+            return false;
+        }
+        mapped_ = mapped;
+        data_ = (const char *)mapped;
+#else
+        ifstream ifs(path, ios::binary);
+        if (!ifs)
+        {
+            return false;
+        }
+        ostringstream oss;
+        oss << ifs.rdbuf();
+        buffer_ = oss.str();
+        data_ = buffer_.data();
+        size_ = buffer_.size();
+#endif /* _WIN32 */
+        return true;
+    }
+
+    const char *data() const
+    {
+        return data_;
+    }
+
+    size_t size() const
+    {
+        return size_;
+    }
+
+  private:
+    const char *data_ = nullptr;
+    size_t size_ = 0;
+#ifndef _WIN32
+    void *mapped_ = nullptr;
+#else
+    string buffer_;
+#endif /* _WIN32 */
+};
+
+// 1 件の extern 変数宣言
+struct ExternVariable
+{
+    string text;    ///< 宣言本体 (コメントを除き、空白を 1 個に正規化したもの)
+    bool decorated; ///< export マクロを伴うか
+};
+
+bool isIdentifierChar(char c)
+{
+    return isalnum((unsigned char)c) || c == '_';
+}
+
+// 1 つのヘッダーを字句解析し、ファイル スコープ (extern "C" / namespace ブロック内を含む) の
+// extern 変数宣言を切り出す。コメント・文字列リテラル・プリプロセッサ行は宣言から除外する。
+class ExternDeclarationScanner
+{
+  public:
+    ExternDeclarationScanner(const char *data, size_t size, const string &export_macro_name)
+        : p_(data), end_(data + size), export_macro_name_(export_macro_name)
+    {
+    }
+
+    vector<ExternVariable> scan()
+    {
+        bool at_line_start = true;
+
+        while (p_ < end_)
+        {
+            const char c = *p_;
+
+            if (c == '\n')
+            {
+                appendSpace();
+                at_line_start = true;
+                ++p_;
+                continue;
+            }
+            if (c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\v')
+            {
+                appendSpace();
+                ++p_;
+                continue;
+            }
+            if (c == '#' && at_line_start)
+            {
+                skipPreprocessorLine();
+                continue;
+            }
+            at_line_start = false;
+
+            if (c == '/' && p_ + 1 < end_ && p_[1] == '/')
+            {
+                skipLineComment();
+                continue;
+            }
+            if (c == '/' && p_ + 1 < end_ && p_[1] == '*')
+            {
+                skipBlockComment();
+                continue;
+            }
+            if (c == 'R' && p_ + 1 < end_ && p_[1] == '"' && (statement_.empty() || !isIdentifierChar(statement_.back())))
+            {
+                appendRawStringLiteral();
+                continue;
+            }
+            if (c == '"' || c == '\'')
+            {
+                appendQuotedLiteral(c);
+                continue;
+            }
+            if (isIdentifierChar(c))
+            {
+                appendIdentifier();
+                continue;
+            }
+
+            ++p_;
+            switch (c)
+            {
+            case ';':
+                endStatement();
+                break;
+            case '{':
+                openBlock();
+                break;
+            case '}':
+                closeBlock();
+                break;
+            case '(':
+                has_paren_ = true;
+                statement_ += c;
+                break;
+            default:
+                statement_ += c;
+                break;
+            }
+        }
+
+        return variables_;
+    }
+
+  private:
+    void appendSpace()
+    {
+        if (!statement_.empty() && statement_.back() != ' ')
+        {
+            statement_ += ' ';
+        }
+    }
+
+    void appendIdentifier()
+    {
+        const char *begin = p_;
+        // 数値 (pp-number) の桁区切り (1'000 / 0xff'ff) は文字リテラルの開始ではなく、数値の一部として読む。
+        // 文字リテラルの接頭辞 (L'a' / u8'a') は数字で始まらないため、ここでは区切りとして扱わない。
+        const bool is_number = isdigit((unsigned char)*begin) != 0;
+        while (p_ < end_ &&
+               (isIdentifierChar(*p_) || (is_number && *p_ == '\'' && p_ + 1 < end_ && isIdentifierChar(p_[1]))))
+        {
+            ++p_;
+        }
+        const size_t length = (size_t)(p_ - begin);
+
+        if (statement_.empty())
+        {
+            starts_with_extern_ = length == 6U && memcmp(begin, "extern", 6U) == 0;
+        }
+        if (length == export_macro_name_.size() && memcmp(begin, export_macro_name_.data(), length) == 0)
+        {
+            has_export_macro_ = true;
+        }
+        statement_.append(begin, length);
+    }
+
+    void appendQuotedLiteral(char quote)
+    {
+        const char *begin = p_++;
+        while (p_ < end_ && *p_ != quote && *p_ != '\n')
+        {
+            if (*p_ == '\\' && p_ + 1 < end_)
+            {
+                ++p_;
+            }
+            ++p_;
+        }
+        if (p_ < end_ && *p_ == quote)
+        {
+            ++p_;
+        }
+        // extern "C" の判定に使うため、文字列リテラルは宣言にそのまま残す
+        statement_.append(begin, (size_t)(p_ - begin));
+    }
+
+    void appendRawStringLiteral()
+    {
+        const char *begin = p_;
+        p_ += 2;
+        const char *delimiter_begin = p_;
+        while (p_ < end_ && *p_ != '(')
+        {
+            ++p_;
+        }
+        const string terminator = ")" + string(delimiter_begin, (size_t)(p_ - delimiter_begin)) + "\"";
+        const char *found = std::search(p_, end_, terminator.begin(), terminator.end());
+        p_ = (found == end_) ? end_ : found + terminator.size();
+        statement_.append(begin, (size_t)(p_ - begin));
+    }
+
+    void skipLineComment()
+    {
+        while (p_ < end_ && *p_ != '\n')
+        {
+            // 行末の '\' による継続は行コメントにも適用される
+            if (*p_ == '\\' && p_ + 1 < end_ && p_[1] == '\n')
+            {
+                ++p_;
+            }
+            ++p_;
+        }
+    }
+
+    void skipBlockComment()
+    {
+        p_ += 2;
+        while (p_ + 1 < end_ && !(p_[0] == '*' && p_[1] == '/'))
+        {
+            ++p_;
+        }
+        p_ = (p_ + 1 < end_) ? p_ + 2 : end_;
+        appendSpace();
+    }
+
+    void skipPreprocessorLine()
+    {
+        while (p_ < end_ && *p_ != '\n')
+        {
+            if (*p_ == '\\' && p_ + 1 < end_ && (p_[1] == '\n' || (p_[1] == '\r' && p_ + 2 < end_ && p_[2] == '\n')))
+            {
+                p_ += (p_[1] == '\n') ? 2 : 3;
+                continue;
+            }
+            if (*p_ == '/' && p_ + 1 < end_ && p_[1] == '*')
+            {
+                skipBlockComment();
+                continue;
+            }
+            ++p_;
+        }
+    }
+
+    bool isFileScope() const
+    {
+        return std::all_of(blocks_.begin(), blocks_.end(), [](bool transparent) { return transparent; });
+    }
+
+    bool startsWithExternC() const
+    {
+        return starts_with_extern_ && statement_.compare(0, 10, "extern \"C\"") == 0;
+    }
+
+    void endStatement()
+    {
+        if (starts_with_extern_ && !has_paren_ && !startsWithExternC() && isFileScope())
+        {
+            while (!statement_.empty() && statement_.back() == ' ')
+            {
+                statement_.pop_back();
+            }
+            variables_.push_back({statement_ + ";", has_export_macro_});
+        }
+        resetStatement();
+    }
+
+    void openBlock()
+    {
+        // extern "C" { と namespace xxx { の内側はファイル スコープとして扱う
+        const bool transparent = startsWithExternC() || statement_.compare(0, 9, "namespace") == 0 ||
+                                 statement_.compare(0, 16, "inline namespace") == 0;
+        blocks_.push_back(transparent);
+        resetStatement();
+    }
+
+    void closeBlock()
+    {
+        if (!blocks_.empty())
+        {
+            blocks_.pop_back();
+        }
+        resetStatement();
+    }
+
+    void resetStatement()
+    {
+        statement_.clear();
+        starts_with_extern_ = false;
+        has_paren_ = false;
+        has_export_macro_ = false;
+    }
+
+    const char *p_;
+    const char *end_;
+    const string &export_macro_name_;
+    vector<bool> blocks_; // ブロックごとにファイル スコープとして扱うか
+    string statement_;
+    bool starts_with_extern_ = false;
+    bool has_paren_ = false;
+    bool has_export_macro_ = false;
+    vector<ExternVariable> variables_;
+};
+
+struct HeaderScanResult
+{
+    bool readable = false;
+    vector<ExternVariable> variables;
+};
+
+HeaderScanResult scanHeader(const string &path, const string &export_macro_name)
+{
+    HeaderScanResult result;
+    HeaderText text;
+
+    if (!text.open(path))
+    {
+        return result;
+    }
+    result.readable = true;
+    result.variables = ExternDeclarationScanner(text.data(), text.size(), export_macro_name).scan();
+
+    return result;
+}
+
+} // namespace
+
+vector<string> findUndecoratedExternVariables(const string &include_dir, const string &export_macro_name)
+{
+    vector<string> undecorated;
+
+    printf("  > findUndecoratedExternVariables include_dir=\"%s\" export_macro_name=\"%s\"\n", include_dir.c_str(),
+           export_macro_name.c_str());
+
+    namespace fs = std::filesystem;
+    if (!fs::exists(include_dir))
+    {
+        printf("  > findUndecoratedExternVariables include_dir が存在しないため走査対象なし\n");
+        return undecorated;
+    }
+
+    // 走査順に依存しない結果とするため、パスを整列してから並列に走査し、整列順で集計する
+    vector<string> headers;
+    for (const auto &entry : fs::recursive_directory_iterator(include_dir))
+    {
+        if (entry.is_regular_file() && entry.path().extension() == ".h")
+        {
+            headers.push_back(entry.path().string());
+        }
+    }
+    sort(headers.begin(), headers.end());
+
+    vector<HeaderScanResult> results(headers.size());
+    const size_t thread_count =
+        std::min(headers.size(), std::max<size_t>(1U, (size_t)std::thread::hardware_concurrency()));
+    std::atomic<size_t> next_index{0};
+    auto worker = [&]() {
+        for (size_t i = next_index++; i < headers.size(); i = next_index++)
+        {
+            results[i] = scanHeader(headers[i], export_macro_name);
+        }
+    };
+    if (thread_count <= 1U)
+    {
+        worker();
+    }
+    else
+    {
+        vector<std::thread> threads;
+        for (size_t i = 0; i < thread_count; ++i)
+        {
+            threads.emplace_back(worker);
+        }
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+    for (size_t i = 0; i < headers.size(); ++i)
+    {
+        printf("  >   header: %s%s\n", headers[i].c_str(), results[i].readable ? "" : " [UNREADABLE]");
+        for (const auto &variable : results[i].variables)
+        {
+            printf("  >     variable: %s [%s]\n", variable.text.c_str(), variable.decorated ? "OK" : "MISSING_EXPORT");
+            if (!variable.decorated)
+            {
+                undecorated.push_back(headers[i] + ": " + variable.text);
+            }
+        }
+    }
+
+    printf("  > findUndecoratedExternVariables 走査したヘッダー数=%zu %s を伴わない extern 変数宣言=%zu 件\n",
+           headers.size(), export_macro_name.c_str(), undecorated.size());
+
+    return undecorated;
+}
+
+} // namespace testing
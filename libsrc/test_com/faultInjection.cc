@@ -0,0 +1,317 @@
+/* 規則に基づいて mock 関数へ障害 (errno + 失敗の戻り値) を注入する。
+ * 規則は追加時に関数ごとの配列へ変換して公開し、mock 関数本体からの判定は atomic 操作のみで行う。
+ * 公開済みの配列は FaultInjection の破棄まで解放しない (判定中のスレッドが参照しているため)。 */
+
+#include <faultInjection.h>
+#include "globMatch_impl.h"
+#include <mock_instance.h>
+#include <test_com.h>
+
+#include <atomic>
+#include <cerrno>
+#include <deque>
+#include <mutex>
+
+namespace testing
+{
+
+namespace
+{
+
+const char *const s_fault_function_names[FAULT_FUNCTION_COUNT] = {
+    "malloc", "calloc", "realloc", "open", "close", "read", "write",
+    "fsync",  "unlink", "fopen",   "fclose", "fread", "fwrite", "fflush",
+};
+
+// splitmix64。seed・規則・呼び出し回数のみから決まるため、スレッドの実行順に依存しない。
+uint64_t mixFaultSeed(uint64_t value)
+{
+    value += 0x9e3779b97f4a7c15ULL;
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+    return value ^ (value >> 31);
+}
+
+struct CompiledFaultRule
+{
+    FaultRule rule;
+    size_t rule_index;
+    uint64_t probability_threshold; // probability を 2^64 倍した値 (0 は判定しない)
+    std::atomic<uint64_t> *failures;
+};
+
+// 公開後は変更しない規則の配列
+struct FaultRuleTable
+{
+    vector<CompiledFaultRule> rules[FAULT_FUNCTION_COUNT];
+};
+
+} // namespace
+
+struct FaultInjectionState
+{
+    explicit FaultInjectionState(uint64_t seed_value) : seed(seed_value)
+    {
+    }
+
+    bool evaluate(FaultFunction function, uint64_t bytes, const char *path);
+
+    const uint64_t seed;
+    std::atomic<const FaultRuleTable *> table{nullptr};
+    std::atomic<uint64_t> calls[FAULT_FUNCTION_COUNT] = {};
+    std::atomic<uint64_t> bytes[FAULT_FUNCTION_COUNT] = {};
+
+    // 以下は mtx で保護する (規則の追加と障害の記録のみ)
+    mutable std::mutex mtx;
+    vector<FaultRule> rules;
+    vector<unique_ptr<FaultRuleTable>> tables;
+    deque<std::atomic<uint64_t>> failure_counts;
+    vector<InjectedFault> injected;
+};
+
+namespace
+{
+
+testfw::MockSlot<FaultInjectionState> s_fault_injection;
+
+bool isValidFaultRule(const FaultRule &rule)
+{
+    if (findFaultFunction(rule.function) == FAULT_FUNCTION_COUNT)
+    {
+        ADD_FAILURE() << "Fault injection is not supported for \"" << rule.function << "\".";
+        return false;
+    }
+    if (rule.probability < 0.0 || rule.probability > 1.0)
+    {
+        ADD_FAILURE() << "Fault probability must be within [0.0, 1.0]: " << rule.probability;
+        return false;
+    }
+    return true;
+}
+
+// state.mtx を取得して呼び出す。
+// 公開済みの配列は判定中のスレッドが参照している可能性があるため、作り直して差し替える。
+void publishFaultRuleTable(FaultInjectionState &state)
+{
+    unique_ptr<FaultRuleTable> table(new FaultRuleTable());
+    for (size_t i = 0; i < state.rules.size(); ++i)
+    {
+        const FaultRule &rule = state.rules[i];
+        uint64_t threshold = 0U;
+        if (rule.probability >= 1.0)
+        {
+            threshold = UINT64_MAX;
+        }
+        else if (rule.probability > 0.0)
+        {
+            threshold = (uint64_t)(rule.probability * 18446744073709551616.0);
+        }
+        table->rules[findFaultFunction(rule.function)].push_back(
+            CompiledFaultRule{rule, i, threshold, &state.failure_counts[i]});
+    }
+    state.table.store(table.get(), std::memory_order_release);
+    state.tables.push_back(std::move(table));
+}
+
+} // namespace
+
+bool FaultInjectionState::evaluate(FaultFunction function, uint64_t request_bytes, const char *path)
+{
+    const FaultRuleTable *current = table.load(std::memory_order_acquire);
+    const uint64_t call_index = calls[function].fetch_add(1U, std::memory_order_relaxed) + 1U;
+    // 累積バイト数は UINT64_MAX で飽和させる (桁あふれの要求サイズで小さな値に戻らないようにする)
+    uint64_t total_bytes = bytes[function].load(std::memory_order_relaxed);
+    uint64_t previous_bytes = total_bytes;
+    do
+    {
+        if (__builtin_add_overflow(previous_bytes, request_bytes, &total_bytes))
+        {
+            total_bytes = UINT64_MAX;
+        }
+    } while (!bytes[function].compare_exchange_weak(previous_bytes, total_bytes, std::memory_order_relaxed));
+    if (current == nullptr)
+    {
+        return false;
+    }
+
+    for (const CompiledFaultRule &compiled : current->rules[function])
+    {
+        const FaultRule &rule = compiled.rule;
+        if (rule.every_nth != 0U && call_index % rule.every_nth != 0U)
+        {
+            continue;
+        }
+        if (rule.nth_call != 0U && call_index != rule.nth_call)
+        {
+            continue;
+        }
+        if (rule.bytes_over != 0U && total_bytes <= rule.bytes_over)
+        {
+            continue;
+        }
+        if (!rule.path_glob.empty() && (path == nullptr || !matchGlob(rule.path_glob, path)))
+        {
+            continue;
+        }
+        if (compiled.probability_threshold != 0U &&
+            mixFaultSeed(seed ^ mixFaultSeed(compiled.rule_index ^ (call_index << 16))) >=
+                compiled.probability_threshold)
+        {
+            continue;
+        }
+        if (rule.max_failures != 0U &&
+            compiled.failures->fetch_add(1U, std::memory_order_relaxed) >= rule.max_failures)
+        {
+            continue;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            injected.push_back(InjectedFault{rule.function, call_index, compiled.rule_index, rule.error_number});
+        }
+        errno = rule.error_number;
+        return true;
+    }
+    return false;
+}
+
+FaultInjection::FaultInjection(uint64_t seed) : state_(new FaultInjectionState(seed))
+{
+    // 同時に生成された FaultInjection のうち 1 個のみが登録され、他は失敗として報告する
+    if (!s_fault_injection.tryPublish(state_.get()))
+    {
+        ADD_FAILURE() << "Only one FaultInjection may exist at a time.";
+    }
+}
+
+FaultInjection::~FaultInjection()
+{
+    if (s_fault_injection.get() == state_.get() &&
+        !s_fault_injection.retire(state_.get(), testfw::internal::kMockRetireTimeout))
+    {
+        ADD_FAILURE() << "Mock calls did not finish within " << testfw::internal::kMockRetireTimeout.count()
+                      << " ms while destroying FaultInjection.";
+        // 判定中のスレッドが参照している可能性があるため解放しない
+        (void)state_.release();
+    }
+}
+
+FaultInjection &FaultInjection::addRule(const FaultRule &rule)
+{
+    if (!isValidFaultRule(rule))
+    {
+        return *this;
+    }
+
+    std::lock_guard<std::mutex> lock(state_->mtx);
+    state_->rules.push_back(rule);
+    state_->failure_counts.emplace_back(0U);
+    publishFaultRuleTable(*state_);
+
+    return *this;
+}
+
+FaultInjection &FaultInjection::failEveryNth(const string &function, uint64_t every_nth, int error_number)
+{
+    FaultRule rule;
+    rule.function = function;
+    rule.error_number = error_number;
+    rule.every_nth = every_nth;
+    return addRule(rule);
+}
+
+FaultInjection &FaultInjection::failNthCall(const string &function, uint64_t nth_call, int error_number)
+{
+    FaultRule rule;
+    rule.function = function;
+    rule.error_number = error_number;
+    rule.nth_call = nth_call;
+    return addRule(rule);
+}
+
+FaultInjection &FaultInjection::failAfterBytes(const string &function, uint64_t bytes_over, int error_number)
+{
+    FaultRule rule;
+    rule.function = function;
+    rule.error_number = error_number;
+    rule.bytes_over = bytes_over;
+    return addRule(rule);
+}
+
+FaultInjection &FaultInjection::failPath(const string &function, const string &path_glob, int error_number)
+{
+    FaultRule rule;
+    rule.function = function;
+    rule.error_number = error_number;
+    rule.path_glob = path_glob;
+    return addRule(rule);
+}
+
+FaultInjection &FaultInjection::failWithProbability(const string &function, double probability, int error_number)
+{
+    FaultRule rule;
+    rule.function = function;
+    rule.error_number = error_number;
+    rule.probability = probability;
+    return addRule(rule);
+}
+
+FaultInjection &FaultInjection::replay(const vector<InjectedFault> &faults)
+{
+    std::lock_guard<std::mutex> lock(state_->mtx);
+    for (const InjectedFault &fault : faults)
+    {
+        FaultRule rule;
+        rule.function = fault.function;
+        rule.error_number = fault.error_number;
+        rule.nth_call = fault.call_index;
+        if (isValidFaultRule(rule))
+        {
+            state_->rules.push_back(rule);
+            state_->failure_counts.emplace_back(0U);
+        }
+    }
+    publishFaultRuleTable(*state_);
+    return *this;
+}
+
+vector<InjectedFault> FaultInjection::injectedFaults() const
+{
+    std::lock_guard<std::mutex> lock(state_->mtx);
+    return state_->injected;
+}
+
+uint64_t FaultInjection::callCount(const string &function) const
+{
+    const FaultFunction index = findFaultFunction(function);
+    return index != FAULT_FUNCTION_COUNT ? state_->calls[index].load(std::memory_order_relaxed) : 0U;
+}
+
+uint64_t FaultInjection::seed() const
+{
+    return state_->seed;
+}
+
+FaultFunction findFaultFunction(const string &function)
+{
+    for (size_t i = 0; i < FAULT_FUNCTION_COUNT; ++i)
+    {
+        if (function == s_fault_function_names[i])
+        {
+            return (FaultFunction)i;
+        }
+    }
+    return FAULT_FUNCTION_COUNT;
+}
+
+bool shouldInjectFault(FaultFunction function, uint64_t bytes, const char *path)
+{
+    auto locked_fault_injection = s_fault_injection.lock();
+    if (!locked_fault_injection)
+    {
+        return false;
+    }
+    return locked_fault_injection->evaluate(function, bytes, path);
+}
+
+} // namespace testing
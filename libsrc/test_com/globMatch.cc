@@ -0,0 +1,44 @@
+/* faultInjection.cc / guardedAllocation.cc で共通のパターン照合。 */
+
+#include "globMatch_impl.h"
+
+namespace testing
+{
+
+// '*' は直前の位置のみ記憶して後戻りする。
+bool matchGlob(const string &pattern, const char *text)
+{
+    size_t p = 0;
+    size_t star = string::npos;
+    const char *star_text = nullptr;
+
+    while (*text != '\0')
+    {
+        if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == *text))
+        {
+            ++p;
+            ++text;
+        }
+        else if (p < pattern.size() && pattern[p] == '*')
+        {
+            star = p++;
+            star_text = text;
+        }
+        else if (star != string::npos)
+        {
+            p = star + 1U;
+            text = ++star_text;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    while (p < pattern.size() && pattern[p] == '*')
+    {
+        ++p;
+    }
+    return p == pattern.size();
+}
+
+} // namespace testing
@@ -0,0 +1,16 @@
+#pragma once
+
+/* '*' / '?' を使用するパターンの照合。
+ * このヘッダーは faultInjection.cc / guardedAllocation.cc / networkImpairment.cc / virtualResolver.cc のみが include する非公開ヘッダー。 */
+
+#include <string>
+
+using namespace std;
+
+namespace testing
+{
+
+/** text が pattern ('*' は 0 文字以上、'?' は任意の 1 文字) に一致するか。 */
+extern bool matchGlob(const string &pattern, const char *text);
+
+} // namespace testing
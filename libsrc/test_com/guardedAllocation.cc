@@ -0,0 +1,641 @@
+/* ガード ページ付きの確保 (electric fence 方式)。
+ * 確保ごとに OS から領域を取得し、要求サイズを末尾に右詰めで配置して直後のページをアクセス不可にする。
+ * 確保元の情報は静的な管理表に保持し、SIGSEGV ハンドラー (Windows はベクター例外ハンドラー) は
+ * ロックを取得せずに管理表を走査して、不正なアクセス先を含む確保の file:line を出力する。 */
+
+#include <guardedAllocation.h>
+#include "globMatch_impl.h"
+#include <mock_instance.h>
+#include <test_com.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#ifndef _WIN32
+    #include <signal.h>
+    #include <sys/mman.h>
+    #include <unistd.h>
+#else
+    #define WIN32_LEAN_AND_MEAN
+    #include <io.h>
+    #include <windows.h>
+    #ifdef byte
+        #undef byte
+    #endif
+#endif
+
+namespace testing
+{
+
+namespace
+{
+
+// 管理表の要素数 (未解放と解放後に保持している確保の合計の上限)
+constexpr size_t GUARDED_SLOT_COUNT = 1U << 14;
+
+// 解放後にアクセス不可として保持する確保数の上限。超えた場合は古いものから返却する
+constexpr size_t MAX_QUARANTINED_BLOCKS = 4096;
+
+enum GuardedSlotState
+{
+    GUARDED_SLOT_LIVE = 1,
+    GUARDED_SLOT_FREED = 2
+};
+
+// シグナル ハンドラーから参照するため、静的領域に置き atomic と生ポインターのみで構成する。
+// base を 0 以外にする前に他のメンバーを設定し、返却時は base を先に 0 にする。
+struct GuardedSlot
+{
+    std::atomic<uintptr_t> base; // 取得した領域の先頭 (0 は未使用)
+    std::atomic<size_t> mapping_size;
+    std::atomic<int> state;
+    size_t size;
+    const void *ptr;
+    const char *file;
+    int line;
+    const char *caller;
+    const char *free_file;
+    int free_line;
+};
+
+GuardedSlot s_guarded_slots[GUARDED_SLOT_COUNT];
+
+// 未解放と保持中の確保数。0 の間は freeGuarded / reallocateGuarded がロックを取得しない
+std::atomic<size_t> s_guarded_block_count(0);
+
+size_t getPageSize()
+{
+#ifndef _WIN32
+    static const size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+#else
+    static const size_t page_size = []() {
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        return (size_t)info.dwPageSize;
+    }();
+#endif
+    return page_size;
+}
+
+size_t roundUp(size_t value, size_t unit)
+{
+    return (value + unit - 1U) / unit * unit;
+}
+
+// シグナル ハンドラーから出力するため、書式化は固定長のバッファーへ手作業で行う
+struct FaultMessage
+{
+    char text[512];
+    size_t length = 0;
+
+    void append(const char *value)
+    {
+        while (*value != '\0' && length < sizeof(text))
+        {
+            text[length++] = *value++;
+        }
+    }
+
+    void appendNumber(uint64_t value, unsigned base)
+    {
+        char digits[20];
+        size_t count = 0;
+        do
+        {
+            digits[count++] = "0123456789abcdef"[value % base];
+            value /= base;
+        } while (value != 0U);
+        if (base == 16U)
+        {
+            append("0x");
+        }
+        while (count > 0U && length < sizeof(text))
+        {
+            text[length++] = digits[--count];
+        }
+    }
+
+    void write() const
+    {
+#ifndef _WIN32
+        ssize_t written = ::write(STDERR_FILENO, text, length);
+#else
+        int written = _write(2, text, (unsigned int)length);
+#endif
+        (void)written;
+    }
+};
+
+// 不正なアクセス先を含む確保を出力する。該当が無い場合は何もしない
+void reportGuardFault(uintptr_t address)
+{
+    for (GuardedSlot &slot : s_guarded_slots)
+    {
+        const uintptr_t base = slot.base.load(std::memory_order_acquire);
+        if (base == 0U || address < base || address - base >= slot.mapping_size.load(std::memory_order_relaxed))
+        {
+            continue;
+        }
+
+        const uintptr_t ptr = (uintptr_t)slot.ptr;
+        FaultMessage message;
+        message.append("GuardedAllocation: invalid access to ");
+        message.appendNumber(address, 16U);
+        if (slot.state.load(std::memory_order_relaxed) == GUARDED_SLOT_FREED)
+        {
+            message.append(" (use after free of the ");
+        }
+        else if (address >= ptr)
+        {
+            message.append(" (");
+            message.appendNumber(address - ptr - slot.size, 10U);
+            message.append(" bytes past the end of the ");
+        }
+        else
+        {
+            message.append(" (before the start of the ");
+        }
+        message.appendNumber(slot.size, 10U);
+        message.append("-byte block allocated at ");
+        message.append(slot.file);
+        message.append(":");
+        message.appendNumber((uint64_t)slot.line, 10U);
+        message.append(" in ");
+        message.append(slot.caller);
+        if (slot.state.load(std::memory_order_relaxed) == GUARDED_SLOT_FREED)
+        {
+            message.append(", freed at ");
+            message.append(slot.free_file);
+            message.append(":");
+            message.appendNumber((uint64_t)slot.free_line, 10U);
+        }
+        message.append(")\n");
+        message.write();
+        return;
+    }
+}
+
+#ifndef _WIN32
+
+struct sigaction s_previous_segv_action;
+
+// 出力後に元の動作へ戻して復帰し、同じ命令の再実行で元の動作 (既定では異常終了) とする
+void onGuardFault(int signal_number, siginfo_t *info, void *context)
+{
+    (void)context;
+    reportGuardFault((uintptr_t)info->si_addr);
+    sigaction(signal_number, &s_previous_segv_action, nullptr);
+}
+
+#else
+
+LONG CALLBACK onGuardFault(PEXCEPTION_POINTERS exception)
+{
+    if (exception->ExceptionRecord->ExceptionCode == EXCEPTION_ACCESS_VIOLATION)
+    {
+        reportGuardFault((uintptr_t)exception->ExceptionRecord->ExceptionInformation[1]);
+    }
+    return EXCEPTION_CONTINUE_SEARCH;
+}
+
+#endif
+
+void installGuardFaultHandler()
+{
+    static std::once_flag installed;
+    std::call_once(installed, []() {
+#ifndef _WIN32
+        struct sigaction action;
+        memset(&action, 0, sizeof(action));
+        action.sa_sigaction = onGuardFault;
+        action.sa_flags = SA_SIGINFO | SA_ONSTACK;
+        sigemptyset(&action.sa_mask);
+        sigaction(SIGSEGV, &action, &s_previous_segv_action);
+#else
+        AddVectoredExceptionHandler(1, onGuardFault);
+#endif
+    });
+}
+
+char *mapGuardedPages(size_t data_size, size_t guard_size)
+{
+#ifndef _WIN32
+    void *pages = mmap(nullptr, data_size + guard_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (pages == MAP_FAILED)
+    {
+        return nullptr;
+    }
+    mprotect((char *)pages + data_size, guard_size, PROT_NONE);
+    return (char *)pages;
+#else
+    char *pages = (char *)VirtualAlloc(nullptr, data_size + guard_size, MEM_RESERVE, PAGE_NOACCESS);
+    if (pages != nullptr && data_size != 0U &&
+        VirtualAlloc(pages, data_size, MEM_COMMIT, PAGE_READWRITE) == nullptr)
+    {
+        VirtualFree(pages, 0, MEM_RELEASE);
+        return nullptr;
+    }
+    return pages;
+#endif
+}
+
+// アドレスは予約したまま、物理メモリーを返却してアクセス不可にする
+void quarantineGuardedPages(char *base, size_t size)
+{
+#ifndef _WIN32
+    mprotect(base, size, PROT_NONE);
+    madvise(base, size, MADV_DONTNEED);
+#else
+    VirtualFree(base, size, MEM_DECOMMIT);
+#endif
+}
+
+void unmapGuardedPages(char *base, size_t size)
+{
+#ifndef _WIN32
+    munmap(base, size);
+#else
+    (void)size;
+    VirtualFree(base, 0, MEM_RELEASE);
+#endif
+}
+
+// 管理表の割り当てと、解放後に保持している確保の管理。シグナル ハンドラーからは参照しない
+class GuardedHeap
+{
+  public:
+    static GuardedHeap &instance()
+    {
+        static GuardedHeap heap;
+        return heap;
+    }
+
+    // 管理表が満杯の場合は false を返す (呼び出し元は通常の確保とする)
+    bool allocate(size_t size, size_t alignment, const char *file, int line, const char *caller, void **allocated)
+    {
+        const size_t page_size = getPageSize();
+        const size_t data_size = roundUp(size, alignment);
+        if (data_size < size || data_size > SIZE_MAX - 2U * page_size)
+        {
+            *allocated = nullptr;
+            errno = ENOMEM;
+            return true;
+        }
+        const size_t data_pages = roundUp(data_size, page_size);
+
+        size_t index;
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            if (!acquireSlot(&index))
+            {
+                ++fallbacks_;
+                return false;
+            }
+        }
+
+        char *base = mapGuardedPages(data_pages, page_size);
+        if (base == nullptr)
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            free_slots_.push_back(index);
+            *allocated = nullptr;
+            errno = ENOMEM;
+            return true;
+        }
+
+        char *ptr = base + data_pages - data_size;
+        GuardedSlot &slot = s_guarded_slots[index];
+        slot.size = size;
+        slot.ptr = ptr;
+        slot.file = file;
+        slot.line = line;
+        slot.caller = caller;
+        slot.free_file = nullptr;
+        slot.free_line = 0;
+        slot.state.store(GUARDED_SLOT_LIVE, std::memory_order_relaxed);
+        slot.mapping_size.store(data_pages + page_size, std::memory_order_relaxed);
+        slot.base.store((uintptr_t)base, std::memory_order_release);
+
+        std::lock_guard<std::mutex> lock(mtx_);
+        blocks_[(uintptr_t)ptr] = index;
+        ++allocations_;
+        ++live_;
+        s_guarded_block_count.fetch_add(1U, std::memory_order_relaxed);
+        *allocated = ptr;
+        return true;
+    }
+
+    // ptr がガード ページ付きの領域でない場合は false を返す。
+    // 未解放の場合は *size に要求サイズを設定し、解放済みの場合はテストを失敗させて *size に SIZE_MAX を設定する
+    bool find(const void *ptr, const char *operation, size_t *size)
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        return findLocked(ptr, operation, size);
+    }
+
+    // ptr がガード ページ付きの領域でない場合は false を返す
+    bool release(void *ptr, const char *file, int line)
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        size_t size;
+        if (!findLocked(ptr, "free", &size))
+        {
+            return false;
+        }
+        if (size != SIZE_MAX)
+        {
+            quarantineLocked(ptr, file, line);
+        }
+        return true;
+    }
+
+    // find() で未解放と確認した ptr をアクセス不可にして保持する
+    void quarantine(void *ptr, const char *file, int line)
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        quarantineLocked(ptr, file, line);
+    }
+
+    GuardedAllocationStats stats()
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        GuardedAllocationStats stats;
+        stats.allocations = allocations_;
+        stats.live = live_;
+        stats.quarantined = quarantine_.size();
+        stats.invalid_frees = invalid_frees_;
+        stats.fallbacks = fallbacks_;
+        return stats;
+    }
+
+  private:
+    GuardedHeap() = default;
+
+    // mtx_ を取得して呼び出す
+    bool findLocked(const void *ptr, const char *operation, size_t *size)
+    {
+        auto found = blocks_.find((uintptr_t)ptr);
+        if (found == blocks_.end())
+        {
+            return false;
+        }
+        const GuardedSlot &slot = s_guarded_slots[found->second];
+        if (slot.state.load(std::memory_order_relaxed) == GUARDED_SLOT_FREED)
+        {
+            ++invalid_frees_;
+            ADD_FAILURE() << operation << "(" << ptr << ") of the " << slot.size << "-byte block allocated at "
+                          << slot.file << ":" << slot.line << " that was already freed at " << slot.free_file << ":"
+                          << slot.free_line << ".";
+            *size = SIZE_MAX;
+            return true;
+        }
+        *size = slot.size;
+        return true;
+    }
+
+    // mtx_ を取得して呼び出す
+    void quarantineLocked(void *ptr, const char *file, int line)
+    {
+        const size_t index = blocks_[(uintptr_t)ptr];
+        GuardedSlot &slot = s_guarded_slots[index];
+        slot.free_file = file;
+        slot.free_line = line;
+        slot.state.store(GUARDED_SLOT_FREED, std::memory_order_relaxed);
+        const size_t guard_size = getPageSize();
+        quarantineGuardedPages((char *)slot.base.load(std::memory_order_relaxed),
+                               slot.mapping_size.load(std::memory_order_relaxed) - guard_size);
+        --live_;
+        quarantine_.push_back(index);
+
+        while (quarantine_.size() > MAX_QUARANTINED_BLOCKS)
+        {
+            GuardedSlot &oldest = s_guarded_slots[quarantine_.front()];
+            blocks_.erase((uintptr_t)oldest.ptr);
+            char *base = (char *)oldest.base.exchange(0U, std::memory_order_acq_rel);
+            unmapGuardedPages(base, oldest.mapping_size.load(std::memory_order_relaxed));
+            free_slots_.push_back(quarantine_.front());
+            quarantine_.pop_front();
+            s_guarded_block_count.fetch_sub(1U, std::memory_order_relaxed);
+        }
+    }
+
+    // mtx_ を取得して呼び出す
+    bool acquireSlot(size_t *index)
+    {
+        if (!free_slots_.empty())
+        {
+            *index = free_slots_.back();
+            free_slots_.pop_back();
+            return true;
+        }
+        if (next_unused_slot_ == GUARDED_SLOT_COUNT)
+        {
+            return false;
+        }
+        *index = next_unused_slot_++;
+        return true;
+    }
+
+    std::mutex mtx_;
+    unordered_map<uintptr_t, size_t> blocks_; // 返したアドレス -> 管理表の要素
+    vector<size_t> free_slots_;
+    size_t next_unused_slot_ = 0;
+    deque<size_t> quarantine_;
+    uint64_t allocations_ = 0;
+    uint64_t live_ = 0;
+    uint64_t invalid_frees_ = 0;
+    uint64_t fallbacks_ = 0;
+};
+
+} // namespace
+
+struct GuardedAllocationState
+{
+    GuardedAllocationState(const string &site_pattern, size_t alignment_value)
+        : file_pattern(site_pattern), line_pattern("*"), alignment(alignment_value == 0U ? 1U : alignment_value)
+    {
+        // 末尾の ":行" を分離する (Windows のドライブ名の ':' と区別するため、行の部分は数字と '*' '?' のみ)
+        const size_t colon = site_pattern.rfind(':');
+        if (colon != string::npos && colon + 1U < site_pattern.size() &&
+            site_pattern.find_first_not_of("0123456789*?", colon + 1U) == string::npos)
+        {
+            file_pattern = site_pattern.substr(0, colon);
+            line_pattern = site_pattern.substr(colon + 1U);
+        }
+    }
+
+    bool matches(const char *file, int line) const
+    {
+        if (!matchGlob(file_pattern, file))
+        {
+            return false;
+        }
+        if (line_pattern == "*")
+        {
+            return true;
+        }
+        char line_text[16];
+        snprintf(line_text, sizeof(line_text), "%d", line);
+        return matchGlob(line_pattern, line_text);
+    }
+
+    string file_pattern;
+    string line_pattern;
+    size_t alignment;
+};
+
+namespace
+{
+
+testfw::MockSlot<GuardedAllocationState> s_guarded_allocation;
+
+class GuardedAllocationListener : public EmptyTestEventListener
+{
+  public:
+    GuardedAllocationListener(const string &test_pattern, const string &site_pattern, size_t alignment)
+        : test_pattern_(test_pattern), site_pattern_(site_pattern), alignment_(alignment)
+    {
+    }
+
+    void OnTestStart(const TestInfo &test_info) override
+    {
+        const string test_name = string(test_info.test_suite_name()) + "." + test_info.name();
+        if (matchGlob(test_pattern_, test_name.c_str()))
+        {
+            guarded_.reset(new GuardedAllocation(site_pattern_, alignment_));
+        }
+    }
+
+    void OnTestEnd(const TestInfo &) override
+    {
+        guarded_.reset();
+    }
+
+  private:
+    string test_pattern_;
+    string site_pattern_;
+    size_t alignment_;
+    unique_ptr<GuardedAllocation> guarded_;
+};
+
+} // namespace
+
+GuardedAllocation::GuardedAllocation(const string &site_pattern, size_t alignment)
+    : state_(new GuardedAllocationState(site_pattern, alignment))
+{
+    if (s_guarded_allocation.get() != nullptr)
+    {
+        ADD_FAILURE() << "Only one GuardedAllocation may exist at a time.";
+        return;
+    }
+    installGuardFaultHandler();
+    s_guarded_allocation.publish(state_.get());
+}
+
+GuardedAllocation::~GuardedAllocation()
+{
+    if (s_guarded_allocation.get() == state_.get() &&
+        !s_guarded_allocation.retire(state_.get(), testfw::internal::kMockRetireTimeout))
+    {
+        ADD_FAILURE() << "Mock calls did not finish within " << testfw::internal::kMockRetireTimeout.count()
+                      << " ms while destroying GuardedAllocation.";
+        // 確保中のスレッドが参照している可能性があるため解放しない
+        (void)state_.release();
+    }
+}
+
+GuardedAllocationStats getGuardedAllocationStats()
+{
+    return GuardedHeap::instance().stats();
+}
+
+void installGuardedAllocationListener(const string &test_pattern, const string &site_pattern, size_t alignment)
+{
+    UnitTest::GetInstance()->listeners().Append(
+        new GuardedAllocationListener(test_pattern, site_pattern, alignment));
+}
+
+bool allocateGuarded(size_t size, const char *file, int line, const char *caller, void **allocated)
+{
+    auto locked_guarded = s_guarded_allocation.lock();
+    if (!locked_guarded || !locked_guarded->matches(file, line))
+    {
+        return false;
+    }
+    return GuardedHeap::instance().allocate(size, locked_guarded->alignment, file, line, caller, allocated);
+}
+
+bool callocGuarded(size_t nmemb, size_t size, const char *file, int line, const char *caller, void **allocated)
+{
+    // 乗算が桁あふれする場合は本物の calloc に ENOMEM を返させる。取得直後のページは 0 で初期化済み
+    if (size != 0U && nmemb > SIZE_MAX / size)
+    {
+        return false;
+    }
+    return allocateGuarded(nmemb * size, file, line, caller, allocated);
+}
+
+bool reallocateGuarded(void *ptr, size_t size, const char *file, int line, const char *caller, void **allocated)
+{
+    if (ptr == nullptr)
+    {
+        return allocateGuarded(size, file, line, caller, allocated);
+    }
+    if (s_guarded_block_count.load(std::memory_order_relaxed) == 0U)
+    {
+        return false;
+    }
+
+    GuardedHeap &heap = GuardedHeap::instance();
+    size_t old_size;
+    if (!heap.find(ptr, "realloc", &old_size))
+    {
+        return false;
+    }
+    if (old_size == SIZE_MAX)
+    {
+        *allocated = nullptr;
+        errno = EINVAL;
+        return true;
+    }
+    if (size == 0U)
+    {
+        heap.quarantine(ptr, file, line);
+        *allocated = nullptr;
+        return true;
+    }
+
+    // ガード ページ付きの領域は、GuardedAllocation の有無や確保元に関わらずガード ページ付きで確保し直す
+    void *resized = nullptr;
+    {
+        auto locked_guarded = s_guarded_allocation.lock();
+        const size_t alignment = locked_guarded ? locked_guarded->alignment : GuardedAllocation::DEFAULT_ALIGNMENT;
+        if (!heap.allocate(size, alignment, file, line, caller, &resized))
+        {
+            resized = malloc(size);
+        }
+    }
+    if (resized != nullptr)
+    {
+        memcpy(resized, ptr, size < old_size ? size : old_size);
+        heap.quarantine(ptr, file, line);
+    }
+    *allocated = resized;
+    return true;
+}
+
+bool freeGuarded(void *ptr, const char *file, int line)
+{
+    if (ptr == nullptr || s_guarded_block_count.load(std::memory_order_relaxed) == 0U)
+    {
+        return false;
+    }
+    return GuardedHeap::instance().release(ptr, file, line);
+}
+
+} // namespace testing
@@ -0,0 +1,745 @@
+/* send / recv / sendto / recvfrom の mock 関数に、規則に基づいてネットワークの障害を注入する。
+ * 規則の判定・統計・ソケットごとの状態は 1 個の mutex で保護し、送受信とスリープは mutex を解放して行う。
+ * トークン バケットは規則と方向ごとに持ち、送受信した後に不足分 (負債) だけスリープする。 */
+
+#ifndef _WIN32
+
+    #include <networkImpairment.h>
+    #include "globMatch_impl.h"
+    #include <mock_instance.h>
+    #include <test_com.h>
+    #include <virtualClock.h>
+    #include <virtualNetwork.h>
+
+    #include <algorithm>
+    #include <cerrno>
+    #include <cstring>
+    #include <mutex>
+    #include <unordered_map>
+    #include <vector>
+
+    #include <arpa/inet.h>
+    #include <fcntl.h>
+    #include <netinet/in.h>
+    #include <sys/un.h>
+    #include <time.h>
+
+namespace testing
+{
+
+namespace
+{
+
+constexpr int64_t NANOSECONDS_PER_SECOND = 1000000000;
+
+// 判定の種類。種類ごとに乱数の系列を分ける
+enum ImpairmentRoll
+{
+    ROLL_EAGAIN,
+    ROLL_JITTER,
+    ROLL_PARTIAL,
+    ROLL_LOSS,
+    ROLL_REORDER,
+};
+
+// splitmix64。seed・規則・ソケット・呼び出し回数のみから決まるため、他のソケットの通信の順序に依存しない。
+uint64_t mixImpairmentSeed(uint64_t value)
+{
+    value += 0x9e3779b97f4a7c15ULL;
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+    return value ^ (value >> 31);
+}
+
+// 確率を 2^64 倍した値 (0 は判定しない)
+uint64_t probabilityThreshold(double probability)
+{
+    if (probability >= 1.0)
+    {
+        return UINT64_MAX;
+    }
+    return probability > 0.0 ? (uint64_t)(probability * 18446744073709551616.0) : 0U;
+}
+
+struct TokenBucket
+{
+    double tokens = 0.0;
+    int64_t updated_ns = 0;
+    bool started = false;
+};
+
+struct CompiledImpairmentRule
+{
+    ImpairmentRule rule;
+    uint64_t burst;
+    uint64_t eagain_threshold;
+    uint64_t partial_threshold;
+    uint64_t loss_threshold;
+    uint64_t reorder_threshold;
+    TokenBucket buckets[2]; // 送信 / 受信
+};
+
+// 入れ替えのため保持している送信データグラム
+struct HeldDatagram
+{
+    vector<char> data;
+    struct sockaddr_storage dest;
+    socklen_t addrlen = 0;
+};
+
+struct ImpairedSocket
+{
+    uint64_t calls = 0;
+    uint32_t eagain_left = 0;
+    bool holding = false;
+    HeldDatagram held;
+};
+
+// 1 回の送受信に適用する障害
+struct ImpairmentPlan
+{
+    vector<size_t> rules; // 一致した規則
+    bool eagain = false;
+    int64_t delay_ns = 0;
+    size_t chunk = SIZE_MAX;
+    bool shortened = false; // max_chunk / partial_probability で短縮した
+    bool drop = false;
+    bool reorder = false;
+};
+
+int64_t monotonicNanoseconds()
+{
+    struct timespec now;
+    int result;
+    if (!virtualClockGettime(CLOCK_MONOTONIC, &now, &result))
+    {
+        (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    }
+    return (int64_t)now.tv_sec * NANOSECONDS_PER_SECOND + now.tv_nsec;
+}
+
+// VirtualClock がある場合は仮想時刻でスリープする
+void sleepNanoseconds(int64_t nanoseconds)
+{
+    if (nanoseconds <= 0)
+    {
+        return;
+    }
+    struct timespec request;
+    request.tv_sec = (time_t)(nanoseconds / NANOSECONDS_PER_SECOND);
+    request.tv_nsec = (long)(nanoseconds % NANOSECONDS_PER_SECOND);
+    int result;
+    if (!virtualNanosleep(&request, nullptr, &result))
+    {
+        while (nanosleep(&request, &request) != 0 && errno == EINTR)
+        {
+        }
+    }
+}
+
+// SOCK_STREAM / SOCK_DGRAM (ソケットでない場合は 0)
+int socketType(int fd)
+{
+    int type = 0;
+    socklen_t len = sizeof(type);
+    int result;
+    if (!virtualNetworkGetsockopt(fd, SOL_SOCKET, SO_TYPE, &type, &len, &result))
+    {
+        result = getsockopt(fd, SOL_SOCKET, SO_TYPE, &type, &len);
+    }
+    return result == 0 ? type : 0;
+}
+
+bool isNonblocking(int fd, int flags)
+{
+    if ((flags & MSG_DONTWAIT) != 0)
+    {
+        return true;
+    }
+    int result;
+    if (!virtualNetworkFcntl(fd, F_GETFL, 0, &result))
+    {
+        result = fcntl(fd, F_GETFL);
+    }
+    return result != -1 && (result & O_NONBLOCK) != 0;
+}
+
+// 規則の address と照合する形式 ("127.0.0.1:8080" / "[::1]:53" / UNIX パス、抽象名前空間は "@name")
+string formatAddress(const struct sockaddr *addr, socklen_t len)
+{
+    if (addr == nullptr || len < (socklen_t)sizeof(sa_family_t))
+    {
+        return string();
+    }
+    char text[INET6_ADDRSTRLEN];
+    switch (addr->sa_family)
+    {
+    case AF_INET: {
+        struct sockaddr_in in;
+        if (len < (socklen_t)sizeof(in))
+        {
+            return string();
+        }
+        memcpy(&in, addr, sizeof(in));
+        (void)inet_ntop(AF_INET, &in.sin_addr, text, sizeof(text));
+        return string(text) + ":" + to_string(ntohs(in.sin_port));
+    }
+    case AF_INET6: {
+        struct sockaddr_in6 in6;
+        if (len < (socklen_t)sizeof(in6))
+        {
+            return string();
+        }
+        memcpy(&in6, addr, sizeof(in6));
+        (void)inet_ntop(AF_INET6, &in6.sin6_addr, text, sizeof(text));
+        return "[" + string(text) + "]:" + to_string(ntohs(in6.sin6_port));
+    }
+    case AF_UNIX: {
+        const size_t path_offset = offsetof(struct sockaddr_un, sun_path);
+        if ((size_t)len <= path_offset)
+        {
+            return string();
+        }
+        const char *path = reinterpret_cast<const char *>(addr) + path_offset;
+        const size_t path_len = std::min((size_t)len - path_offset, sizeof(sockaddr_un::sun_path));
+        if (path[0] == '\0')
+        {
+            return "@" + string(path + 1, path_len - 1U);
+        }
+        return string(path, strnlen(path, path_len));
+    }
+    default:
+        return string();
+    }
+}
+
+string peerAddress(int fd)
+{
+    struct sockaddr_storage peer;
+    socklen_t len = sizeof(peer);
+    int result;
+    if (!virtualNetworkGetpeername(fd, reinterpret_cast<struct sockaddr *>(&peer), &len, &result))
+    {
+        result = getpeername(fd, reinterpret_cast<struct sockaddr *>(&peer), &len);
+    }
+    return result == 0 ? formatAddress(reinterpret_cast<struct sockaddr *>(&peer), len) : string();
+}
+
+} // namespace
+
+struct NetworkImpairmentState
+{
+    explicit NetworkImpairmentState(uint64_t seed_value) : seed(seed_value)
+    {
+    }
+
+    // 0 以上 2^64 未満の乱数 (seed・規則・ソケット・呼び出し回数・判定の種類から決まる)
+    uint64_t roll(size_t rule_index, int fd, uint64_t call, ImpairmentRoll kind) const
+    {
+        return mixImpairmentSeed(
+            seed ^ mixImpairmentSeed(rule_index ^ mixImpairmentSeed(call ^ mixImpairmentSeed(
+                                                                        (uint64_t)(uint32_t)fd ^ ((uint64_t)kind << 32)))));
+    }
+
+    /*
+     * mtx を取得して呼び出す。fd の direction の送受信に一致する規則があれば、適用する障害を *plan に設定して true を返す。
+     * address は相手のアドレスを返す関数で、address を指定した規則がある場合のみ呼び出す。
+     */
+    template <typename AddressFunction>
+    bool planLocked(int fd, ImpairmentDirection direction, int type, bool nonblocking, size_t len,
+                    AddressFunction address, ImpairmentPlan *plan)
+    {
+        bool address_resolved = false;
+        string peer;
+        for (size_t i = 0; i < rules.size(); ++i)
+        {
+            const ImpairmentRule &rule = rules[i].rule;
+            if ((rule.direction & direction) == 0 || (rule.fd != -1 && rule.fd != fd))
+            {
+                continue;
+            }
+            if (!rule.address.empty())
+            {
+                if (!address_resolved)
+                {
+                    peer = address();
+                    address_resolved = true;
+                }
+                if (peer.empty() || !matchGlob(rule.address, peer.c_str()))
+                {
+                    continue;
+                }
+            }
+            plan->rules.push_back(i);
+        }
+        if (plan->rules.empty())
+        {
+            return false;
+        }
+
+        ImpairedSocket &sock = sockets[fd];
+        const uint64_t call = ++sock.calls;
+        if (nonblocking)
+        {
+            if (sock.eagain_left == 0U)
+            {
+                for (size_t i : plan->rules)
+                {
+                    const CompiledImpairmentRule &compiled = rules[i];
+                    if (compiled.eagain_threshold != 0U && roll(i, fd, call, ROLL_EAGAIN) < compiled.eagain_threshold)
+                    {
+                        sock.eagain_left = std::max<uint32_t>(compiled.rule.eagain_burst, 1U);
+                        break;
+                    }
+                }
+            }
+            if (sock.eagain_left != 0U)
+            {
+                --sock.eagain_left;
+                ++statistics.eagain;
+                plan->eagain = true;
+                return true;
+            }
+        }
+
+        for (size_t i : plan->rules)
+        {
+            const CompiledImpairmentRule &compiled = rules[i];
+            const ImpairmentRule &rule = compiled.rule;
+            plan->delay_ns += rule.latency.count();
+            if (rule.jitter.count() > 0)
+            {
+                plan->delay_ns += (int64_t)(roll(i, fd, call, ROLL_JITTER) % (uint64_t)rule.jitter.count());
+            }
+            if (type == SOCK_STREAM)
+            {
+                if (rule.bandwidth != 0U)
+                {
+                    plan->chunk = std::min(plan->chunk, (size_t)compiled.burst);
+                }
+                if (rule.max_chunk != 0U && rule.max_chunk < len)
+                {
+                    plan->chunk = std::min(plan->chunk, rule.max_chunk);
+                    plan->shortened = true;
+                }
+                if (compiled.partial_threshold != 0U && len > 1U &&
+                    roll(i, fd, call, ROLL_PARTIAL) < compiled.partial_threshold)
+                {
+                    const uint64_t value = mixImpairmentSeed(roll(i, fd, call, ROLL_PARTIAL));
+                    plan->chunk = std::min(plan->chunk, (size_t)(1U + value % (uint64_t)(len - 1U)));
+                    plan->shortened = true;
+                }
+            }
+            else
+            {
+                if (compiled.loss_threshold != 0U && roll(i, fd, call, ROLL_LOSS) < compiled.loss_threshold)
+                {
+                    plan->drop = true;
+                }
+                if (direction == IMPAIR_SEND && compiled.reorder_threshold != 0U &&
+                    roll(i, fd, call, ROLL_REORDER) < compiled.reorder_threshold)
+                {
+                    plan->reorder = true;
+                }
+            }
+        }
+        if (plan->shortened)
+        {
+            ++statistics.partial_transfers;
+        }
+        if (plan->drop)
+        {
+            ++statistics.dropped_datagrams;
+        }
+        recordDelayLocked(plan->delay_ns);
+        return true;
+    }
+
+    // mtx を取得して呼び出す。受信したデータグラムを破棄するか判定する (データグラムごとに呼び出し回数を進める)
+    bool dropReceivedLocked(int fd, const vector<size_t> &matched)
+    {
+        const uint64_t call = ++sockets[fd].calls;
+        for (size_t i : matched)
+        {
+            if (rules[i].loss_threshold != 0U && roll(i, fd, call, ROLL_LOSS) < rules[i].loss_threshold)
+            {
+                ++statistics.dropped_datagrams;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // mtx を取得して呼び出す。送受信した bytes をトークン バケットから引き、不足分を補うまでの時間を返す
+    int64_t consumeLocked(const vector<size_t> &matched, ImpairmentDirection direction, size_t bytes)
+    {
+        const int64_t now = monotonicNanoseconds();
+        int64_t wait_ns = 0;
+        for (size_t i : matched)
+        {
+            CompiledImpairmentRule &compiled = rules[i];
+            if (compiled.rule.bandwidth == 0U)
+            {
+                continue;
+            }
+            const double rate = (double)compiled.rule.bandwidth;
+            TokenBucket &bucket = compiled.buckets[direction == IMPAIR_SEND ? 0 : 1];
+            if (!bucket.started)
+            {
+                bucket.tokens = (double)compiled.burst;
+                bucket.updated_ns = now;
+                bucket.started = true;
+            }
+            bucket.tokens = std::min((double)compiled.burst,
+                                     bucket.tokens + (double)(now - bucket.updated_ns) * rate / NANOSECONDS_PER_SECOND);
+            bucket.updated_ns = now;
+            bucket.tokens -= (double)bytes;
+            if (bucket.tokens < 0.0)
+            {
+                wait_ns = std::max(wait_ns, (int64_t)(-bucket.tokens * NANOSECONDS_PER_SECOND / rate));
+            }
+        }
+        recordDelayLocked(wait_ns);
+        return wait_ns;
+    }
+
+    void recordDelayLocked(int64_t delay_ns)
+    {
+        if (delay_ns > 0)
+        {
+            ++statistics.delayed_calls;
+            statistics.total_delay += chrono::nanoseconds(delay_ns);
+        }
+    }
+
+    const uint64_t seed;
+    mutable std::mutex mtx;
+    vector<CompiledImpairmentRule> rules;
+    unordered_map<int, ImpairedSocket> sockets;
+    ImpairmentStats statistics;
+};
+
+namespace
+{
+
+testfw::MockSlot<NetworkImpairmentState> s_network_impairment;
+
+// 送受信した bytes の帯域制限の分だけスリープする
+void throttle(NetworkImpairmentState &state, const vector<size_t> &matched, ImpairmentDirection direction,
+              size_t bytes)
+{
+    int64_t wait_ns;
+    {
+        std::lock_guard<std::mutex> lock(state.mtx);
+        wait_ns = state.consumeLocked(matched, direction, bytes);
+    }
+    const int saved_errno = errno;
+    sleepNanoseconds(wait_ns);
+    errno = saved_errno;
+}
+
+} // namespace
+
+NetworkImpairment::NetworkImpairment(uint64_t seed) : state_(new NetworkImpairmentState(seed))
+{
+    if (s_network_impairment.get() != nullptr)
+    {
+        ADD_FAILURE() << "Only one NetworkImpairment may exist at a time.";
+        return;
+    }
+    s_network_impairment.publish(state_.get());
+}
+
+NetworkImpairment::~NetworkImpairment()
+{
+    if (s_network_impairment.get() == state_.get() &&
+        !s_network_impairment.retire(state_.get(), testfw::internal::kMockRetireTimeout))
+    {
+        ADD_FAILURE() << "Mock calls did not finish within " << testfw::internal::kMockRetireTimeout.count()
+                      << " ms while destroying NetworkImpairment.";
+        // 送受信中のスレッドが参照している可能性があるため解放しない
+        (void)state_.release();
+    }
+}
+
+NetworkImpairment &NetworkImpairment::addRule(const ImpairmentRule &rule)
+{
+    for (double probability : {rule.partial_probability, rule.eagain_probability, rule.loss, rule.reorder})
+    {
+        if (probability < 0.0 || probability > 1.0)
+        {
+            ADD_FAILURE() << "Impairment probability must be within [0.0, 1.0]: " << probability;
+            return *this;
+        }
+    }
+    if (rule.latency.count() < 0 || rule.jitter.count() < 0)
+    {
+        ADD_FAILURE() << "Impairment latency and jitter must not be negative.";
+        return *this;
+    }
+
+    CompiledImpairmentRule compiled;
+    compiled.rule = rule;
+    compiled.burst = rule.burst != 0U ? rule.burst : std::max<uint64_t>(rule.bandwidth / 20U, 1U);
+    compiled.eagain_threshold = probabilityThreshold(rule.eagain_probability);
+    compiled.partial_threshold = probabilityThreshold(rule.partial_probability);
+    compiled.loss_threshold = probabilityThreshold(rule.loss);
+    compiled.reorder_threshold = probabilityThreshold(rule.reorder);
+
+    std::lock_guard<std::mutex> lock(state_->mtx);
+    state_->rules.push_back(compiled);
+    return *this;
+}
+
+NetworkImpairment &NetworkImpairment::limitBandwidth(const string &address, uint64_t bytes_per_second)
+{
+    ImpairmentRule rule;
+    rule.address = address;
+    rule.bandwidth = bytes_per_second;
+    return addRule(rule);
+}
+
+NetworkImpairment &NetworkImpairment::addLatency(const string &address, chrono::nanoseconds latency,
+                                                 chrono::nanoseconds jitter)
+{
+    ImpairmentRule rule;
+    rule.address = address;
+    rule.latency = latency;
+    rule.jitter = jitter;
+    return addRule(rule);
+}
+
+NetworkImpairment &NetworkImpairment::splitTransfers(const string &address, size_t max_chunk)
+{
+    ImpairmentRule rule;
+    rule.address = address;
+    rule.max_chunk = max_chunk;
+    return addRule(rule);
+}
+
+NetworkImpairment &NetworkImpairment::injectEagain(const string &address, double probability, uint32_t burst)
+{
+    ImpairmentRule rule;
+    rule.address = address;
+    rule.eagain_probability = probability;
+    rule.eagain_burst = burst;
+    return addRule(rule);
+}
+
+NetworkImpairment &NetworkImpairment::dropDatagrams(const string &address, double probability)
+{
+    ImpairmentRule rule;
+    rule.address = address;
+    rule.loss = probability;
+    return addRule(rule);
+}
+
+NetworkImpairment &NetworkImpairment::reorderDatagrams(const string &address, double probability)
+{
+    ImpairmentRule rule;
+    rule.address = address;
+    rule.direction = IMPAIR_SEND;
+    rule.reorder = probability;
+    return addRule(rule);
+}
+
+ImpairmentStats NetworkImpairment::stats() const
+{
+    std::lock_guard<std::mutex> lock(state_->mtx);
+    return state_->statistics;
+}
+
+uint64_t NetworkImpairment::seed() const
+{
+    return state_->seed;
+}
+
+bool networkImpairmentActive()
+{
+    return s_network_impairment.get() != nullptr;
+}
+
+bool impairSend(int sockfd, const void *buf, size_t len, int flags, const struct sockaddr *dest_addr,
+                socklen_t addrlen, const ImpairedSend &transfer, ssize_t *result)
+{
+    auto locked_impairment = s_network_impairment.lock();
+    if (!locked_impairment)
+    {
+        return false;
+    }
+    const int type = socketType(sockfd);
+    if (type != SOCK_STREAM && type != SOCK_DGRAM)
+    {
+        return false;
+    }
+    const bool nonblocking = isNonblocking(sockfd, flags);
+    ImpairmentPlan plan;
+    {
+        std::lock_guard<std::mutex> lock(locked_impairment->mtx);
+        const bool matched = locked_impairment->planLocked(
+            sockfd, IMPAIR_SEND, type, nonblocking, len,
+            [&] { return dest_addr != nullptr ? formatAddress(dest_addr, addrlen) : peerAddress(sockfd); }, &plan);
+        if (!matched)
+        {
+            return false;
+        }
+    }
+    if (plan.eagain)
+    {
+        errno = EAGAIN;
+        *result = -1;
+        return true;
+    }
+    sleepNanoseconds(plan.delay_ns);
+
+    if (type == SOCK_DGRAM)
+    {
+        if (plan.drop)
+        {
+            *result = (ssize_t)len;
+            return true;
+        }
+        HeldDatagram held;
+        bool flush = false;
+        {
+            std::lock_guard<std::mutex> lock(locked_impairment->mtx);
+            ImpairedSocket &sock = locked_impairment->sockets[sockfd];
+            if (plan.reorder && !sock.holding)
+            {
+                // 次のデータグラムの後に送る
+                const char *data = static_cast<const char *>(buf);
+                sock.held.data.assign(data, data + len);
+                sock.held.addrlen = dest_addr != nullptr ? std::min<socklen_t>(addrlen, sizeof(sock.held.dest)) : 0;
+                if (sock.held.addrlen != 0U)
+                {
+                    memcpy(&sock.held.dest, dest_addr, sock.held.addrlen);
+                }
+                sock.holding = true;
+                ++locked_impairment->statistics.reordered_datagrams;
+                *result = (ssize_t)len;
+                return true;
+            }
+            if (sock.holding)
+            {
+                held = std::move(sock.held);
+                sock.holding = false;
+                flush = true;
+            }
+        }
+        *result = transfer(buf, len, dest_addr, addrlen);
+        const int saved_errno = errno;
+        if (flush)
+        {
+            (void)transfer(held.data.data(), held.data.size(),
+                           held.addrlen != 0U ? reinterpret_cast<const struct sockaddr *>(&held.dest) : nullptr,
+                           held.addrlen);
+        }
+        if (*result > 0)
+        {
+            throttle(*locked_impairment, plan.rules, IMPAIR_SEND, (size_t)*result);
+        }
+        errno = saved_errno;
+        return true;
+    }
+
+    // ストリームは帯域制限のみの場合、ブロッキングの送信をバケットの容量ずつに分けてすべて送信する
+    const char *data = static_cast<const char *>(buf);
+    size_t sent = 0;
+    while (true)
+    {
+        const size_t chunk = std::min(len - sent, plan.chunk);
+        const ssize_t transferred = transfer(data + sent, chunk, dest_addr, addrlen);
+        if (transferred < 0)
+        {
+            if (sent == 0U)
+            {
+                *result = -1;
+                return true;
+            }
+            break;
+        }
+        sent += (size_t)transferred;
+        throttle(*locked_impairment, plan.rules, IMPAIR_SEND, (size_t)transferred);
+        if (sent == len || plan.shortened || nonblocking || (size_t)transferred < chunk)
+        {
+            break;
+        }
+    }
+    *result = (ssize_t)sent;
+    return true;
+}
+
+bool impairRecv(int sockfd, void *buf, size_t len, int flags, const ImpairedRecv &transfer, ssize_t *result)
+{
+    auto locked_impairment = s_network_impairment.lock();
+    if (!locked_impairment)
+    {
+        return false;
+    }
+    const int type = socketType(sockfd);
+    if (type != SOCK_STREAM && type != SOCK_DGRAM)
+    {
+        return false;
+    }
+    const bool nonblocking = isNonblocking(sockfd, flags);
+    ImpairmentPlan plan;
+    {
+        std::lock_guard<std::mutex> lock(locked_impairment->mtx);
+        const bool matched = locked_impairment->planLocked(sockfd, IMPAIR_RECV, type, nonblocking, len,
+                                                           [&] { return peerAddress(sockfd); }, &plan);
+        if (!matched)
+        {
+            return false;
+        }
+    }
+    if (plan.eagain)
+    {
+        errno = EAGAIN;
+        *result = -1;
+        return true;
+    }
+
+    if (type == SOCK_DGRAM)
+    {
+        // 破棄したデータグラムの代わりに次のデータグラムを受信する (MSG_PEEK は破棄しない)
+        bool drop = plan.drop && (flags & MSG_PEEK) == 0;
+        while (true)
+        {
+            *result = transfer(buf, len);
+            if (*result < 0 || !drop)
+            {
+                break;
+            }
+            std::lock_guard<std::mutex> lock(locked_impairment->mtx);
+            drop = locked_impairment->dropReceivedLocked(sockfd, plan.rules);
+        }
+    }
+    else
+    {
+        *result = transfer(buf, std::min(len, plan.chunk));
+    }
+    if (*result > 0)
+    {
+        // 受信したデータが遅れて届いたものとして扱う
+        const int saved_errno = errno;
+        sleepNanoseconds(plan.delay_ns);
+        errno = saved_errno;
+        throttle(*locked_impairment, plan.rules, IMPAIR_RECV, (size_t)*result);
+    }
+    return true;
+}
+
+void forgetImpairedSocket(int fd)
+{
+    auto locked_impairment = s_network_impairment.lock();
+    if (!locked_impairment)
+    {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(locked_impairment->mtx);
+    (void)locked_impairment->sockets.erase(fd);
+}
+
+} // namespace testing
+
+#endif // _WIN32
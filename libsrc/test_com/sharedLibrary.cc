@@ -1,5 +1,6 @@
 #include <sharedLibrary.h>
 
+#include <chrono>
 #include <cstdio>
 #include <cstdlib>
 #include <map>
@@ -44,6 +45,12 @@ std::map<std::string, void *> &getSharedLibrarySymbols()
     return symbols;
 }
 
+std::map<std::string, SharedLibraryStats> &getSharedLibraryStatsMap()
+{
+    static std::map<std::string, SharedLibraryStats> stats;
+    return stats;
+}
+
 #ifdef _WIN32
 static bool utf8_to_utf16(const std::string &src, std::wstring *dst)
 {
@@ -133,87 +140,230 @@ static std::string format_windows_error(const DWORD error_code)
 
 } // namespace
 
-SharedSymbolResult tryResolveSharedSymbol(const std::string &lib_name, const std::string &symbol_name)
+namespace
 {
-    SharedSymbolResult result;
-    const std::string symbol_key = lib_name + "\n" + symbol_name;
-    void *handle = nullptr;
 
-    std::lock_guard<std::mutex> lock(getSharedLibraryMutex());
+uint64_t elapsedNanoseconds(const std::chrono::steady_clock::time_point &start)
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start)
+        .count();
+}
 
-    {
-        const auto cached_symbol = getSharedLibrarySymbols().find(symbol_key);
-        if (cached_symbol != getSharedLibrarySymbols().end())
-        {
-            result.symbol = cached_symbol->second;
-            return result;
-        }
-    }
+SharedLibraryStats &getSharedLibraryStatsEntry(const std::string &lib_name)
+{
+    SharedLibraryStats &stats = getSharedLibraryStatsMap()[lib_name];
+    stats.lib_name = lib_name;
+    return stats;
+}
 
+// ライブラリ ハンドルを取得する (未ロードならロードする)。呼び出し側で mutex を保持していること。
+// ロード済みの場合はバインドの方式を変更しない。glibc はロード済みのオブジェクトを再配置しないため、
+// RTLD_NOW で再度 dlopen しても遅延バインドの PLT エントリは解決されない。
+// プロセスが依存ライブラリ等としてロード済みのライブラリは、RTLD_NOLOAD で検出して遅延バインドとして扱う。
+void *openSharedLibraryLocked(const std::string &lib_name, bool bind_now, std::string *diagnostic)
+{
     {
         const auto cached_handle = getSharedLibraryHandles().find(lib_name);
         if (cached_handle != getSharedLibraryHandles().end())
         {
-            handle = cached_handle->second;
+            return cached_handle->second;
         }
     }
 
+    void *handle = nullptr;
+    const auto start = std::chrono::steady_clock::now();
+#ifndef _WIN32
+    dlerror();
+    handle = dlopen(lib_name.c_str(), RTLD_LAZY | RTLD_LOCAL | RTLD_NOLOAD);
+    if (handle != nullptr)
+    {
+        bind_now = false;
+    }
+    else
+    {
+        handle = dlopen(lib_name.c_str(), (bind_now ? RTLD_NOW : RTLD_LAZY) | RTLD_LOCAL);
+    }
     if (handle == nullptr)
     {
-#ifndef _WIN32
-        dlerror();
-        handle = dlopen(lib_name.c_str(), RTLD_LAZY | RTLD_LOCAL);
-        if (handle == nullptr)
-        {
-            const char *error_message = dlerror();
+        const char *error_message = dlerror();
 
-            result.diagnostic = (error_message != nullptr) ? error_message : "dlopen failed";
-            return result;
-        }
+        *diagnostic = (error_message != nullptr) ? error_message : "dlopen failed";
+        return nullptr;
+    }
 #else
-        std::wstring lib_name_wide;
+    std::wstring lib_name_wide;
 
-        if (!utf8_to_utf16(lib_name, &lib_name_wide))
-        {
-            result.diagnostic = "failed to convert library name from UTF-8 to UTF-16";
-            return result;
-        }
+    if (!utf8_to_utf16(lib_name, &lib_name_wide))
+    {
+        *diagnostic = "failed to convert library name from UTF-8 to UTF-16";
+        return nullptr;
+    }
+
+    // LoadLibraryW はインポートをロード時にすべて解決するため、常に即時バインドとなる。
+    handle = (void *)LoadLibraryW(lib_name_wide.c_str());
+    if (handle == nullptr)
+    {
+        *diagnostic = format_windows_error(GetLastError());
+        return nullptr;
+    }
+    bind_now = true;
+#endif
+
+    SharedLibraryStats &stats = getSharedLibraryStatsEntry(lib_name);
+    stats.load_time_ns += elapsedNanoseconds(start);
+    stats.bind_now = bind_now;
+    getSharedLibraryHandles()[lib_name] = handle;
 
-        handle = (void *)LoadLibraryW(lib_name_wide.c_str());
-        if (handle == nullptr)
+    return handle;
+}
+
+// シンボルを解決してキャッシュに登録する。呼び出し側で mutex を保持していること。
+void *resolveSymbolLocked(const std::string &lib_name, void *handle, const std::string &symbol_name,
+                          std::string *diagnostic)
+{
+    const std::string symbol_key = lib_name + "\n" + symbol_name;
+    void *symbol = nullptr;
+
+    {
+        const auto cached_symbol = getSharedLibrarySymbols().find(symbol_key);
+        if (cached_symbol != getSharedLibrarySymbols().end())
         {
-            result.diagnostic = format_windows_error(GetLastError());
-            return result;
+            return cached_symbol->second;
         }
-#endif
-        getSharedLibraryHandles()[lib_name] = handle;
     }
 
+    const auto start = std::chrono::steady_clock::now();
 #ifndef _WIN32
     dlerror();
-    result.symbol = dlsym(handle, symbol_name.c_str());
+    symbol = dlsym(handle, symbol_name.c_str());
     {
         const char *error_message = dlerror();
-        if (error_message != nullptr || result.symbol == nullptr)
+        if (error_message != nullptr || symbol == nullptr)
         {
-            result.symbol = nullptr;
-            result.diagnostic = (error_message != nullptr) ? error_message : "dlsym failed";
-            return result;
+            *diagnostic = (error_message != nullptr) ? error_message : "dlsym failed";
+            return nullptr;
         }
     }
 #else
-    result.symbol = (void *)GetProcAddress((HMODULE)handle, symbol_name.c_str());
-    if (result.symbol == nullptr)
+    symbol = (void *)GetProcAddress((HMODULE)handle, symbol_name.c_str());
+    if (symbol == nullptr)
     {
-        result.diagnostic = format_windows_error(GetLastError());
-        return result;
+        *diagnostic = format_windows_error(GetLastError());
+        return nullptr;
     }
 #endif
+    const uint64_t resolve_ns = elapsedNanoseconds(start);
+
+    SharedLibraryStats &stats = getSharedLibraryStatsEntry(lib_name);
+    ++stats.symbol_count;
+    stats.total_resolve_ns += resolve_ns;
+    if (resolve_ns > stats.max_resolve_ns)
+    {
+        stats.max_resolve_ns = resolve_ns;
+    }
+
+    getSharedLibrarySymbols()[symbol_key] = symbol;
+    return symbol;
+}
+
+} // namespace
+
+SharedSymbolResult tryResolveSharedSymbol(const std::string &lib_name, const std::string &symbol_name)
+{
+    SharedSymbolResult result;
+
+    std::lock_guard<std::mutex> lock(getSharedLibraryMutex());
+
+    void *handle = openSharedLibraryLocked(lib_name, false, &result.diagnostic);
+    if (handle == nullptr)
+    {
+        return result;
+    }
+
+    result.symbol = resolveSymbolLocked(lib_name, handle, symbol_name, &result.diagnostic);
+    return result;
+}
+
+SharedLibraryPreloadResult preloadSharedLibrary(const std::string &lib_name,
+                                                const std::vector<std::string> &symbol_names, int flags)
+{
+    SharedLibraryPreloadResult result;
+
+    std::lock_guard<std::mutex> lock(getSharedLibraryMutex());
+
+    const bool bind_now = (flags & SHARED_LIBRARY_BIND_NOW) != 0;
+    void *handle = openSharedLibraryLocked(lib_name, bind_now, &result.diagnostic);
+    if (handle == nullptr)
+    {
+        result.missing = symbol_names;
+        return result;
+    }
+    result.loaded = true;
+    result.bind_now = getSharedLibraryStatsEntry(lib_name).bind_now;
+    if (bind_now && !result.bind_now)
+    {
+        result.diagnostic = lib_name + ": already loaded by the process; its binding is not changed";
+    }
+
+    for (const auto &symbol_name : symbol_names)
+    {
+        std::string diagnostic;
+        void *symbol = resolveSymbolLocked(lib_name, handle, symbol_name, &diagnostic);
+        if (symbol == nullptr)
+        {
+            result.missing.push_back(symbol_name);
+            if (!result.diagnostic.empty())
+            {
+                result.diagnostic += "\n";
+            }
+            result.diagnostic += symbol_name + ": " + diagnostic;
+            continue;
+        }
+        result.symbols[symbol_name] = symbol;
+    }
 
-    getSharedLibrarySymbols()[symbol_key] = result.symbol;
     return result;
 }
 
+std::vector<SharedLibraryStats> getSharedLibraryStats()
+{
+    std::vector<SharedLibraryStats> stats;
+
+    std::lock_guard<std::mutex> lock(getSharedLibraryMutex());
+    for (const auto &entry : getSharedLibraryStatsMap())
+    {
+        stats.push_back(entry.second);
+    }
+
+    return stats;
+}
+
+void resetSharedLibraryStats()
+{
+    std::lock_guard<std::mutex> lock(getSharedLibraryMutex());
+    for (auto &entry : getSharedLibraryStatsMap())
+    {
+        const bool bind_now = entry.second.bind_now;
+        entry.second = SharedLibraryStats();
+        entry.second.lib_name = entry.first;
+        entry.second.bind_now = bind_now;
+    }
+}
+
+void printSharedLibraryStats(FILE *fp)
+{
+    const std::vector<SharedLibraryStats> stats = getSharedLibraryStats();
+
+    fprintf(fp, "  > shared library stats (%zu libraries)\n", stats.size());
+    for (const auto &entry : stats)
+    {
+        fprintf(fp, "  >   %s: load=%.3fms bind=%s symbols=%zu resolve_total=%.3fms resolve_max=%.3fms\n",
+                entry.lib_name.c_str(), (double)entry.load_time_ns / 1e6, entry.bind_now ? "now" : "lazy",
+                entry.symbol_count, (double)entry.total_resolve_ns / 1e6, (double)entry.max_resolve_ns / 1e6);
+    }
+    fflush(fp);
+}
+
 void *resolveSharedSymbolOrExit(const std::string &lib_name, const std::string &symbol_name)
 {
     SharedSymbolResult result = tryResolveSharedSymbol(lib_name, symbol_name);
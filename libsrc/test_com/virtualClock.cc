@@ -0,0 +1,1136 @@
+/* 時刻とタイムアウト付きの待機の mock 関数の委譲先とする仮想時刻。
+ * 仮想時刻は生成後の経過時間 (ナノ秒) で表し、各クロックの値は「クロックごとの基準値 + 経過時間」とする。
+ * 待機中のスレッドは期限を階層型タイマー ホイールに登録して停止し、管理対象のスレッドがすべて待機中になった時点で
+ * 最も早い期限まで経過時間を進め、その期限のタイマーの待機のみを起床させる。 */
+
+#ifndef _WIN32
+
+    #include <mock_instance.h>
+    #include <test_com.h>
+    #include <virtualClock.h>
+
+    #include <algorithm>
+    #include <atomic>
+    #include <cerrno>
+    #include <condition_variable>
+    #include <cstdlib>
+    #include <cstring>
+    #include <deque>
+    #include <functional>
+    #include <mutex>
+    #include <sstream>
+    #include <unordered_set>
+    #include <vector>
+
+    #include <sys/syscall.h>
+    #include <unistd.h>
+
+namespace testing
+{
+
+namespace
+{
+
+constexpr int64_t NANOSECONDS_PER_SECOND = 1000000000;
+
+// 仮想時刻で扱うクロックの種類
+enum VirtualClockKind
+{
+    CLOCK_KIND_REALTIME,
+    CLOCK_KIND_MONOTONIC,
+    CLOCK_KIND_BOOTTIME,
+    CLOCK_KIND_COUNT
+};
+
+bool getClockKind(clockid_t clock_id, VirtualClockKind *kind)
+{
+    switch (clock_id)
+    {
+    case CLOCK_REALTIME:
+    case CLOCK_REALTIME_COARSE:
+        *kind = CLOCK_KIND_REALTIME;
+        return true;
+    case CLOCK_MONOTONIC:
+    case CLOCK_MONOTONIC_COARSE:
+    case CLOCK_MONOTONIC_RAW:
+        *kind = CLOCK_KIND_MONOTONIC;
+        return true;
+    case CLOCK_BOOTTIME:
+        *kind = CLOCK_KIND_BOOTTIME;
+        return true;
+    default:
+        return false;
+    }
+}
+
+int64_t toNanoseconds(const struct timespec &value)
+{
+    return (int64_t)value.tv_sec * NANOSECONDS_PER_SECOND + value.tv_nsec;
+}
+
+struct timespec toTimespec(int64_t nanoseconds)
+{
+    struct timespec value;
+    value.tv_sec = (time_t)(nanoseconds / NANOSECONDS_PER_SECOND);
+    value.tv_nsec = (long)(nanoseconds % NANOSECONDS_PER_SECOND);
+    if (value.tv_nsec < 0)
+    {
+        value.tv_sec -= 1;
+        value.tv_nsec += NANOSECONDS_PER_SECOND;
+    }
+    return value;
+}
+
+int64_t realNow(clockid_t clock_id)
+{
+    struct timespec value;
+    clock_gettime(clock_id, &value);
+    return toNanoseconds(value);
+}
+
+struct VirtualClockThread;
+
+// 待機中のスレッドの期限。待機するスレッドのスタック上に置き、VirtualTimerWheel のスロットのリストに連結する
+struct VirtualTimer
+{
+    int64_t deadline = 0;  // 経過時間
+    uint64_t sequence = 0; // 同じ期限のタイマーを登録順に起床させるための番号
+    VirtualTimer *prev = nullptr;
+    VirtualTimer *next = nullptr;
+    VirtualClockThread *blocking = nullptr; // 管理対象のスレッドの待機として blocked_threads に数えている場合のスレッド
+    size_t slot = 0;
+    bool queued = false; // 期限に達し、起床の順番を待っている
+    bool fired = false;  // 起床させた
+};
+
+/*
+ * 階層型タイマー ホイール。期限を SLOT_BITS ビットずつ LEVELS 段に分け、現在時刻と異なる最上位の段の
+ * 期限の桁のスロットに登録する。各段の使用中のスロットはビットマップで管理するため、登録・削除・次の期限の検索は
+ * タイマーの数に関わらずほぼ定数時間で、時刻を進める際は通過したスロットのタイマーのみを下の段に移す。
+ * 現在時刻と LEVELS 段より上で異なる期限 (約 3 日以上先) は OVERFLOW_SLOT に登録する。
+ */
+class VirtualTimerWheel
+{
+  public:
+    static constexpr int SLOT_BITS = 6;
+    static constexpr size_t SLOTS = (size_t)1 << SLOT_BITS;
+    static constexpr int LEVELS = 8;
+    static constexpr size_t OVERFLOW_SLOT = LEVELS * SLOTS;
+
+    int64_t now() const
+    {
+        return now_;
+    }
+
+    bool empty() const
+    {
+        return count_ == 0U;
+    }
+
+    size_t size() const
+    {
+        return count_;
+    }
+
+    // timer->deadline は現在時刻より後であること
+    void add(VirtualTimer *timer)
+    {
+        link(timer, slotOf(timer->deadline));
+        ++count_;
+    }
+
+    void remove(VirtualTimer *timer)
+    {
+        unlink(timer);
+        --count_;
+    }
+
+    // 最も早い期限 (空でないこと)
+    int64_t nextExpiry() const
+    {
+        for (int level = 0; level < LEVELS; ++level)
+        {
+            if (occupied_[level] != 0U)
+            {
+                // 下の段ほど期限が早く、同じ段では桁の小さいスロットほど期限が早い
+                return earliestIn(slots_[(size_t)level * SLOTS + (size_t)__builtin_ctzll(occupied_[level])]);
+            }
+        }
+        return earliestIn(slots_[OVERFLOW_SLOT]);
+    }
+
+    // 現在時刻を to まで進め、期限に達したタイマーを期限と登録の順に返す
+    vector<VirtualTimer *> advance(int64_t to)
+    {
+        vector<VirtualTimer *> moved;
+        for (int level = 0; level < LEVELS; ++level)
+        {
+            const int shift = level * SLOT_BITS;
+            const int upper_shift = shift + SLOT_BITS;
+            uint64_t passed = occupied_[level];
+            if ((now_ >> upper_shift) == (to >> upper_shift))
+            {
+                // 上の段が同じ場合、to の桁より大きいスロットは to に対しても同じスロットのまま
+                const uint64_t digit = (uint64_t)(to >> shift) & (SLOTS - 1U);
+                passed &= digit == SLOTS - 1U ? ~(uint64_t)0 : ((uint64_t)2 << digit) - 1U;
+            }
+            while (passed != 0U)
+            {
+                takeSlot((size_t)level * SLOTS + (size_t)__builtin_ctzll(passed), &moved);
+                passed &= passed - 1U;
+            }
+        }
+        if ((now_ >> (LEVELS * SLOT_BITS)) != (to >> (LEVELS * SLOT_BITS)))
+        {
+            takeSlot(OVERFLOW_SLOT, &moved);
+        }
+
+        now_ = to;
+        vector<VirtualTimer *> expired;
+        for (VirtualTimer *timer : moved)
+        {
+            if (timer->deadline <= now_)
+            {
+                expired.push_back(timer);
+                --count_;
+            }
+            else
+            {
+                link(timer, slotOf(timer->deadline));
+            }
+        }
+        std::sort(expired.begin(), expired.end(), [](const VirtualTimer *a, const VirtualTimer *b) {
+            return a->deadline != b->deadline ? a->deadline < b->deadline : a->sequence < b->sequence;
+        });
+        return expired;
+    }
+
+  private:
+    size_t slotOf(int64_t deadline) const
+    {
+        const uint64_t diff = (uint64_t)(deadline ^ now_);
+        const int level = (63 - __builtin_clzll(diff)) / SLOT_BITS;
+        if (level >= LEVELS)
+        {
+            return OVERFLOW_SLOT;
+        }
+        return (size_t)level * SLOTS + (size_t)((uint64_t)(deadline >> (level * SLOT_BITS)) & (SLOTS - 1U));
+    }
+
+    static int64_t earliestIn(const VirtualTimer *head)
+    {
+        int64_t earliest = head->deadline;
+        for (const VirtualTimer *timer = head->next; timer != nullptr; timer = timer->next)
+        {
+            earliest = std::min(earliest, timer->deadline);
+        }
+        return earliest;
+    }
+
+    void link(VirtualTimer *timer, size_t slot)
+    {
+        timer->slot = slot;
+        timer->prev = nullptr;
+        timer->next = slots_[slot];
+        if (timer->next != nullptr)
+        {
+            timer->next->prev = timer;
+        }
+        slots_[slot] = timer;
+        if (slot != OVERFLOW_SLOT)
+        {
+            occupied_[slot / SLOTS] |= (uint64_t)1 << (slot % SLOTS);
+        }
+    }
+
+    void unlink(VirtualTimer *timer)
+    {
+        if (timer->prev != nullptr)
+        {
+            timer->prev->next = timer->next;
+        }
+        else
+        {
+            slots_[timer->slot] = timer->next;
+        }
+        if (timer->next != nullptr)
+        {
+            timer->next->prev = timer->prev;
+        }
+        if (slots_[timer->slot] == nullptr && timer->slot != OVERFLOW_SLOT)
+        {
+            occupied_[timer->slot / SLOTS] &= ~((uint64_t)1 << (timer->slot % SLOTS));
+        }
+    }
+
+    void takeSlot(size_t slot, vector<VirtualTimer *> *moved)
+    {
+        for (VirtualTimer *timer = slots_[slot]; timer != nullptr; timer = timer->next)
+        {
+            moved->push_back(timer);
+        }
+        slots_[slot] = nullptr;
+        if (slot != OVERFLOW_SLOT)
+        {
+            occupied_[slot / SLOTS] &= ~((uint64_t)1 << (slot % SLOTS));
+        }
+    }
+
+    VirtualTimer *slots_[OVERFLOW_SLOT + 1] = {};
+    uint64_t occupied_[LEVELS] = {};
+    int64_t now_ = 0;
+    size_t count_ = 0;
+};
+
+std::atomic<uint64_t> s_next_clock_id{1};
+
+} // namespace
+
+struct VirtualClockState
+{
+    explicit VirtualClockState(VirtualClock *owner_value)
+        : owner(owner_value), id(s_next_clock_id.fetch_add(1, std::memory_order_relaxed))
+    {
+        base[CLOCK_KIND_REALTIME] = realNow(CLOCK_REALTIME);
+        base[CLOCK_KIND_MONOTONIC] = realNow(CLOCK_MONOTONIC);
+        base[CLOCK_KIND_BOOTTIME] = realNow(CLOCK_BOOTTIME);
+    }
+
+    // mtx を取得して呼び出す
+    int64_t nowLocked(VirtualClockKind kind) const
+    {
+        return base[kind] + timers.now();
+    }
+
+    // mtx を取得して呼び出す。待機の状態の変化を通知する
+    void changedLocked()
+    {
+        ++epoch;
+        cv.notify_all();
+    }
+
+    // mtx を取得して呼び出す。管理対象のスレッドがすべて待機中 (管理対象が無い場合を含む)
+    bool allBlockedLocked() const
+    {
+        return blocked_threads >= attached_threads;
+    }
+
+    // mtx を取得して呼び出す。呼び出したスレッドがこの VirtualClock の管理対象
+    bool attachedLocked() const;
+
+    // mtx を取得して呼び出す。呼び出したスレッドがこの VirtualClock の管理対象の場合はそのスレッド、以外は nullptr
+    VirtualClockThread *currentThreadLocked() const;
+
+    // mtx を取得して呼び出す。管理対象のスレッド thread を待機中とする / 実行中に戻す
+    void blockThreadLocked(VirtualClockThread *thread);
+    void unblockThreadLocked(VirtualClockThread *thread);
+
+    // mtx を取得して呼び出す。待機中でない管理対象のスレッドの一覧 (ウォッチドッグのメッセージ用)
+    string runningThreadsLocked() const;
+
+    /*
+     * mtx を取得して呼び出す。管理対象のスレッドの待機の状態が変化するまで待ち、変化した場合に true を返す。
+     * 実時間で watchdog_timeout の間変化しない場合は、待機しないスレッドを示してテストを失敗させ、false を返す
+     * (同じ状態での失敗は 1 回のみとする)。
+     */
+    bool waitForChangeLocked(std::unique_lock<std::mutex> &lock)
+    {
+        const uint64_t observed = epoch;
+        if (cv.wait_for(lock, watchdog_timeout, [&] { return epoch != observed || closing; }))
+        {
+            return true;
+        }
+        if (stalled_epoch != observed)
+        {
+            stalled_epoch = observed;
+            ADD_FAILURE() << "VirtualClock cannot advance: attached threads did not wait within "
+                          << chrono::duration_cast<chrono::milliseconds>(watchdog_timeout).count()
+                          << " ms: " << runningThreadsLocked();
+        }
+        return false;
+    }
+
+    // mtx を取得して呼び出す。起床させていない待機がある
+    bool hasPendingLocked() const
+    {
+        return !expired.empty() || !timers.empty();
+    }
+
+    /*
+     * mtx を取得して呼び出す。起床させていない待機のうち、期限と登録の順で最初の 1 個を起床させる (hasPendingLocked() であること)。
+     * 期限に達していない場合は経過時間を最も早い期限まで進める。同じ期限の待機も、起床させたスレッドが再び待機するまで
+     * 次を起床させないため、同じ期限の待機の実行順も毎回同じになる。
+     */
+    void wakeNextLocked()
+    {
+        if (expired.empty())
+        {
+            for (VirtualTimer *timer : timers.advance(timers.nextExpiry()))
+            {
+                timer->queued = true;
+                expired.push_back(timer);
+            }
+        }
+        VirtualTimer *timer = expired.front();
+        expired.pop_front();
+        timer->queued = false;
+        timer->fired = true;
+        if (timer->blocking)
+        {
+            // 起床させたスレッドは実行中とし、再び待機するまで次の待機を起床させない
+            unblockThreadLocked(timer->blocking);
+            timer->blocking = nullptr;
+        }
+        changedLocked();
+    }
+
+    /*
+     * mtx を取得して呼び出す。管理対象のスレッドがすべて待機中で、次の期限に進めてよい場合に true を返す。
+     * 事象を待つ待機がある場合は、通知を受けたスレッドが実行を再開する前に進めないよう、
+     * 実時間で idle_wait の間に待機の状態が変化しないことを確認する。
+     */
+    bool quiescentLocked(std::unique_lock<std::mutex> &lock)
+    {
+        if (!allBlockedLocked() || closing)
+        {
+            return false;
+        }
+        if (event_waiters == 0U)
+        {
+            return true;
+        }
+        const uint64_t observed = epoch;
+        const auto until = chrono::steady_clock::now() + idle_wait;
+        while (epoch == observed && !closing && cv.wait_until(lock, until) != std::cv_status::timeout)
+        {
+        }
+        return epoch == observed && allBlockedLocked() && !closing;
+    }
+
+    /*
+     * 経過時間が deadline に達するまで待機する。事象が発生した場合は true、deadline に達した場合は false を返す。
+     * wait_event が空の場合はスリープとする。
+     * wait_event は実時間で idle_wait まで事象を待ち、発生した場合に true を返す (mtx を解放して呼び出す)。
+     */
+    bool waitUntil(int64_t deadline, const function<bool(chrono::nanoseconds)> &wait_event)
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        if (deadline <= timers.now())
+        {
+            return false;
+        }
+        VirtualTimer timer;
+        timer.deadline = deadline;
+        timer.sequence = ++sequence;
+        timer.blocking = currentThreadLocked();
+        if (timer.blocking)
+        {
+            blockThreadLocked(timer.blocking);
+        }
+        if (wait_event)
+        {
+            ++event_waiters;
+        }
+        timers.add(&timer);
+        changedLocked();
+
+        bool happened = false;
+        while (!timer.fired && !closing)
+        {
+            if (wait_event)
+            {
+                // 事象を待つ時間を、待機の状態が変化しないことの確認に兼ねる
+                const uint64_t observed = epoch;
+                const chrono::nanoseconds wait = idle_wait;
+                lock.unlock();
+                happened = wait_event(wait);
+                lock.lock();
+                if (happened)
+                {
+                    break;
+                }
+                if (!timer.fired && epoch == observed && allBlockedLocked() && !closing)
+                {
+                    wakeNextLocked();
+                }
+            }
+            else if (!allBlockedLocked())
+            {
+                if (!waitForChangeLocked(lock))
+                {
+                    // ウォッチドッグでテストを失敗させた。仮想時刻を進めずに待機を終える
+                    break;
+                }
+            }
+            else if (quiescentLocked(lock) && !timer.fired)
+            {
+                wakeNextLocked();
+            }
+        }
+
+        if (timer.queued)
+        {
+            expired.erase(std::find(expired.begin(), expired.end(), &timer));
+        }
+        else if (!timer.fired)
+        {
+            timers.remove(&timer);
+        }
+        if (timer.blocking)
+        {
+            unblockThreadLocked(timer.blocking);
+        }
+        if (wait_event)
+        {
+            --event_waiters;
+        }
+        changedLocked();
+        return happened;
+    }
+
+    // 期限の無い待機 (pthread_join 等) の開始。管理対象のスレッドの場合のみ待機中とし、true を返す
+    bool beginUntimedWait()
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        VirtualClockThread *thread = currentThreadLocked();
+        if (thread == nullptr)
+        {
+            return false;
+        }
+        blockThreadLocked(thread);
+        ++event_waiters;
+        changedLocked();
+        return true;
+    }
+
+    void endUntimedWait()
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        unblockThreadLocked(currentThreadLocked());
+        --event_waiters;
+        changedLocked();
+    }
+
+    // mtx を取得して呼び出す。呼び出したスレッドが管理対象の場合、runUntilIdle の間は待機中とする
+    bool blockCallerLocked()
+    {
+        VirtualClockThread *thread = currentThreadLocked();
+        if (thread == nullptr)
+        {
+            return false;
+        }
+        blockThreadLocked(thread);
+        changedLocked();
+        return true;
+    }
+
+    // mtx を取得して呼び出す
+    void unblockCallerLocked(bool blocked)
+    {
+        if (blocked)
+        {
+            unblockThreadLocked(currentThreadLocked());
+            changedLocked();
+        }
+    }
+
+    // 現在から timeout 後の期限 (経過時間)
+    int64_t deadlineAfter(int64_t timeout)
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        return timers.now() + std::max<int64_t>(timeout, 0);
+    }
+
+    VirtualClock *owner;
+    const uint64_t id; // スレッドの管理対象の VirtualClock を識別する (アドレスは再利用されるため)
+    mutable std::mutex mtx;
+    std::condition_variable cv;
+    int64_t base[CLOCK_KIND_COUNT] = {};
+    VirtualTimerWheel timers;      // 現在時刻は生成後の経過時間
+    deque<VirtualTimer *> expired; // 期限に達し、起床の順番を待つ待機
+    uint64_t sequence = 0;
+    size_t attached_threads = 0;                 // 管理対象のスレッドの数 (生成後、開始前のスレッドを含む)
+    unordered_set<VirtualClockThread *> threads; // 開始済みの管理対象のスレッド
+    size_t blocked_threads = 0;                  // 管理対象のスレッドのうち待機中の数
+    size_t event_waiters = 0;                    // 仮想時刻以外の事象で起床する待機の数
+    uint64_t epoch = 0;                          // 待機の状態が変化するたびに増やす
+    uint64_t stalled_epoch = UINT64_MAX;         // ウォッチドッグでテストを失敗させた時点の epoch
+    chrono::nanoseconds idle_wait = VirtualClock::DEFAULT_IDLE_WAIT;
+    chrono::nanoseconds watchdog_timeout = VirtualClock::DEFAULT_WATCHDOG_TIMEOUT;
+    bool closing = false;
+};
+
+namespace
+{
+
+testfw::MockSlot<VirtualClockState> s_virtual_clock;
+
+// スレッドの管理対象の VirtualClock。スレッドの終了時 (pthread_exit を含む) に管理対象から外す
+struct VirtualClockThread
+{
+    ~VirtualClockThread()
+    {
+        if (clock_id == 0U)
+        {
+            return;
+        }
+        auto locked_clock = s_virtual_clock.lock();
+        if (locked_clock && locked_clock->id == clock_id)
+        {
+            std::lock_guard<std::mutex> lock(locked_clock->mtx);
+            locked_clock->threads.erase(this);
+            --locked_clock->attached_threads;
+            locked_clock->changedLocked();
+        }
+    }
+
+    // clock の mtx を取得して呼び出す。呼び出したスレッドを clock の開始済みの管理対象として登録する
+    void registerLocked(VirtualClockState *clock)
+    {
+        clock_id = clock->id;
+        tid = (pid_t)syscall(SYS_gettid);
+        handle = pthread_self();
+        blocked = 0;
+        clock->threads.insert(this);
+    }
+
+    uint64_t clock_id = 0;
+    pid_t tid = 0;         // ウォッチドッグのメッセージ用
+    pthread_t handle = {}; // ウォッチドッグのメッセージ用 (スレッド名の取得)
+    size_t blocked = 0;    // 待機中の数 (clock_id の VirtualClock の mtx で保護する)
+};
+
+thread_local VirtualClockThread t_virtual_clock_thread;
+
+// VirtualClock の生存期間中に pthread_create で生成したスレッドの開始関数と引数
+struct VirtualThreadStart
+{
+    void *(*start_routine)(void *);
+    void *arg;
+    uint64_t clock_id;
+};
+
+void *startVirtualThread(void *param)
+{
+    const VirtualThreadStart start = *static_cast<VirtualThreadStart *>(param);
+    delete static_cast<VirtualThreadStart *>(param);
+    {
+        // 生成時に管理対象に数えているため、登録のみ行う
+        auto locked_clock = s_virtual_clock.lock();
+        if (locked_clock && locked_clock->id == start.clock_id)
+        {
+            std::lock_guard<std::mutex> lock(locked_clock->mtx);
+            t_virtual_clock_thread.registerLocked(&*locked_clock);
+        }
+        else
+        {
+            t_virtual_clock_thread.clock_id = start.clock_id;
+        }
+    }
+    return start.start_routine(start.arg);
+}
+
+// 期限の無い待機の開始。待機中に VirtualClock を破棄できるよう、待機中は s_virtual_clock のガードを保持しない
+bool enterUntimedWait(uint64_t *clock_id)
+{
+    auto locked_clock = s_virtual_clock.lock();
+    if (!locked_clock || !locked_clock->beginUntimedWait())
+    {
+        return false;
+    }
+    *clock_id = locked_clock->id;
+    return true;
+}
+
+void leaveUntimedWait(uint64_t clock_id)
+{
+    const int saved_errno = errno;
+    auto locked_clock = s_virtual_clock.lock();
+    if (locked_clock && locked_clock->id == clock_id)
+    {
+        locked_clock->endUntimedWait();
+    }
+    errno = saved_errno;
+}
+
+} // namespace
+
+bool VirtualClockState::attachedLocked() const
+{
+    return t_virtual_clock_thread.clock_id == id;
+}
+
+VirtualClockThread *VirtualClockState::currentThreadLocked() const
+{
+    return attachedLocked() ? &t_virtual_clock_thread : nullptr;
+}
+
+void VirtualClockState::blockThreadLocked(VirtualClockThread *thread)
+{
+    ++blocked_threads;
+    ++thread->blocked;
+}
+
+void VirtualClockState::unblockThreadLocked(VirtualClockThread *thread)
+{
+    --blocked_threads;
+    if (thread != nullptr)
+    {
+        --thread->blocked;
+    }
+}
+
+string VirtualClockState::runningThreadsLocked() const
+{
+    vector<pair<pid_t, string>> running;
+    for (const VirtualClockThread *thread : threads)
+    {
+        if (thread->blocked == 0U)
+        {
+            char name[16] = "";
+            (void)pthread_getname_np(thread->handle, name, sizeof(name));
+            running.emplace_back(thread->tid, name);
+        }
+    }
+    std::sort(running.begin(), running.end());
+    std::ostringstream message;
+    const char *separator = "";
+    for (const auto &thread : running)
+    {
+        message << separator << "thread " << thread.first << " (" << thread.second << ")";
+        separator = ", ";
+    }
+    if (attached_threads > threads.size())
+    {
+        message << separator << attached_threads - threads.size() << " thread(s) created by pthread_create not started";
+    }
+    return message.str();
+}
+
+constexpr chrono::nanoseconds VirtualClock::DEFAULT_IDLE_WAIT;
+constexpr chrono::nanoseconds VirtualClock::DEFAULT_WATCHDOG_TIMEOUT;
+
+VirtualClock::VirtualClock() : state_(new VirtualClockState(this))
+{
+    if (s_virtual_clock.get() != nullptr)
+    {
+        ADD_FAILURE() << "Only one VirtualClock may exist at a time.";
+        return;
+    }
+    s_virtual_clock.publish(state_.get());
+}
+
+VirtualClock::VirtualClock(const struct timespec &realtime) : VirtualClock()
+{
+    state_->base[CLOCK_KIND_REALTIME] = toNanoseconds(realtime);
+}
+
+VirtualClock::~VirtualClock()
+{
+    {
+        // 待機中のスレッドを終了させる
+        std::lock_guard<std::mutex> lock(state_->mtx);
+        state_->closing = true;
+        state_->cv.notify_all();
+    }
+    if (t_virtual_clock_thread.clock_id == state_->id)
+    {
+        t_virtual_clock_thread.clock_id = 0;
+    }
+    if (s_virtual_clock.get() == state_.get() &&
+        !s_virtual_clock.retire(state_.get(), testfw::internal::kMockRetireTimeout))
+    {
+        ADD_FAILURE() << "Mock calls did not finish within " << testfw::internal::kMockRetireTimeout.count()
+                      << " ms while destroying VirtualClock.";
+        // 待機中のスレッドが参照している可能性があるため解放しない
+        (void)state_.release();
+    }
+}
+
+void VirtualClock::advance(chrono::nanoseconds duration)
+{
+    // 期限を duration 後とするスリープとして、途中の待機を期限の順に起床させる
+    (void)state_->waitUntil(state_->deadlineAfter(duration.count()), nullptr);
+}
+
+void VirtualClock::setTime(clockid_t clock_id, const struct timespec &value)
+{
+    VirtualClockKind kind;
+    if (getClockKind(clock_id, &kind))
+    {
+        std::lock_guard<std::mutex> lock(state_->mtx);
+        state_->base[kind] = toNanoseconds(value) - state_->timers.now();
+    }
+}
+
+struct timespec VirtualClock::now(clockid_t clock_id) const
+{
+    VirtualClockKind kind = CLOCK_KIND_MONOTONIC;
+    (void)getClockKind(clock_id, &kind);
+    std::lock_guard<std::mutex> lock(state_->mtx);
+    return toTimespec(state_->nowLocked(kind));
+}
+
+chrono::nanoseconds VirtualClock::elapsed() const
+{
+    std::lock_guard<std::mutex> lock(state_->mtx);
+    return chrono::nanoseconds(state_->timers.now());
+}
+
+void VirtualClock::runUntilIdle()
+{
+    std::unique_lock<std::mutex> lock(state_->mtx);
+    const bool blocked = state_->blockCallerLocked();
+    while (!state_->closing)
+    {
+        if (!state_->allBlockedLocked())
+        {
+            if (!state_->waitForChangeLocked(lock))
+            {
+                break;
+            }
+        }
+        else if (state_->hasPendingLocked())
+        {
+            if (state_->quiescentLocked(lock))
+            {
+                state_->wakeNextLocked();
+            }
+        }
+        else
+        {
+            // 管理対象外のスレッドが次の待機を開始する可能性があるため、idle_wait の間は待つ
+            const uint64_t observed = state_->epoch;
+            (void)state_->cv.wait_for(lock, state_->idle_wait);
+            if (state_->epoch == observed && !state_->hasPendingLocked())
+            {
+                break;
+            }
+        }
+    }
+    state_->unblockCallerLocked(blocked);
+}
+
+void VirtualClock::setIdleWait(chrono::nanoseconds wait)
+{
+    std::lock_guard<std::mutex> lock(state_->mtx);
+    state_->idle_wait = wait;
+}
+
+void VirtualClock::setWatchdogTimeout(chrono::nanoseconds timeout)
+{
+    std::lock_guard<std::mutex> lock(state_->mtx);
+    state_->watchdog_timeout = timeout;
+}
+
+size_t VirtualClock::pendingWaiters() const
+{
+    std::lock_guard<std::mutex> lock(state_->mtx);
+    return state_->timers.size() + state_->expired.size();
+}
+
+void VirtualClock::attachCurrentThread()
+{
+    std::lock_guard<std::mutex> lock(state_->mtx);
+    if (t_virtual_clock_thread.clock_id != state_->id)
+    {
+        t_virtual_clock_thread.registerLocked(state_.get());
+        ++state_->attached_threads;
+        state_->changedLocked();
+    }
+}
+
+void VirtualClock::detachCurrentThread()
+{
+    std::lock_guard<std::mutex> lock(state_->mtx);
+    if (t_virtual_clock_thread.clock_id == state_->id)
+    {
+        t_virtual_clock_thread.clock_id = 0;
+        state_->threads.erase(&t_virtual_clock_thread);
+        --state_->attached_threads;
+        state_->changedLocked();
+    }
+}
+
+size_t VirtualClock::attachedThreads() const
+{
+    std::lock_guard<std::mutex> lock(state_->mtx);
+    return state_->attached_threads;
+}
+
+VirtualClock *getVirtualClock()
+{
+    VirtualClockState *state = s_virtual_clock.get();
+    return state == nullptr ? nullptr : state->owner;
+}
+
+bool virtualClockGettime(clockid_t clock_id, struct timespec *tp, int *result)
+{
+    auto locked_clock = s_virtual_clock.lock();
+    VirtualClockKind kind;
+    if (!locked_clock || !getClockKind(clock_id, &kind))
+    {
+        return false;
+    }
+    if (tp == nullptr)
+    {
+        errno = EFAULT;
+        *result = -1;
+        return true;
+    }
+    std::lock_guard<std::mutex> lock(locked_clock->mtx);
+    *tp = toTimespec(locked_clock->nowLocked(kind));
+    *result = 0;
+    return true;
+}
+
+bool virtualNanosleep(const struct timespec *req, struct timespec *rem, int *result)
+{
+    auto locked_clock = s_virtual_clock.lock();
+    if (!locked_clock)
+    {
+        return false;
+    }
+    if (req == nullptr || req->tv_nsec < 0 || req->tv_nsec >= NANOSECONDS_PER_SECOND || req->tv_sec < 0)
+    {
+        errno = EINVAL;
+        *result = -1;
+        return true;
+    }
+    (void)locked_clock->waitUntil(locked_clock->deadlineAfter(toNanoseconds(*req)), nullptr);
+    if (rem != nullptr)
+    {
+        memset(rem, 0, sizeof(*rem));
+    }
+    *result = 0;
+    return true;
+}
+
+bool virtualUsleep(useconds_t usec, int *result)
+{
+    auto locked_clock = s_virtual_clock.lock();
+    if (!locked_clock)
+    {
+        return false;
+    }
+    (void)locked_clock->waitUntil(locked_clock->deadlineAfter((int64_t)usec * 1000), nullptr);
+    *result = 0;
+    return true;
+}
+
+bool virtualCondTimedwait(pthread_cond_t *cond, pthread_mutex_t *mutex, const struct timespec *abstime, int *result)
+{
+    auto locked_clock = s_virtual_clock.lock();
+    if (!locked_clock || abstime == nullptr)
+    {
+        return false;
+    }
+    if (abstime->tv_nsec < 0 || abstime->tv_nsec >= NANOSECONDS_PER_SECOND)
+    {
+        *result = EINVAL;
+        return true;
+    }
+
+    // 条件変数のクロックは取得できないため、仮想時刻が近い方のクロックの時刻とみなす
+    const int64_t target = toNanoseconds(*abstime);
+    int64_t deadline;
+    clockid_t real_clock;
+    {
+        std::lock_guard<std::mutex> lock(locked_clock->mtx);
+        const int64_t realtime = locked_clock->nowLocked(CLOCK_KIND_REALTIME);
+        const int64_t monotonic = locked_clock->nowLocked(CLOCK_KIND_MONOTONIC);
+        const bool is_realtime = std::llabs(target - realtime) <= std::llabs(target - monotonic);
+        real_clock = is_realtime ? CLOCK_REALTIME : CLOCK_MONOTONIC;
+        deadline = locked_clock->timers.now() + (target - (is_realtime ? realtime : monotonic));
+    }
+
+    int wait_ret = 0;
+    const bool signaled = locked_clock->waitUntil(deadline, [&](chrono::nanoseconds wait) {
+        const struct timespec real_abstime = toTimespec(realNow(real_clock) + wait.count());
+        wait_ret = pthread_cond_timedwait(cond, mutex, &real_abstime);
+        return wait_ret != ETIMEDOUT;
+    });
+    *result = signaled ? wait_ret : ETIMEDOUT;
+    return true;
+}
+
+bool virtualCondWait(pthread_cond_t *cond, pthread_mutex_t *mutex, int *result)
+{
+    uint64_t clock_id;
+    if (!enterUntimedWait(&clock_id))
+    {
+        return false;
+    }
+    *result = pthread_cond_wait(cond, mutex);
+    leaveUntimedWait(clock_id);
+    return true;
+}
+
+bool virtualPoll(struct pollfd *fds, nfds_t nfds, int timeout, int *result)
+{
+    if (timeout < 0)
+    {
+        uint64_t clock_id;
+        if (!enterUntimedWait(&clock_id))
+        {
+            return false;
+        }
+        *result = poll(fds, nfds, timeout);
+        leaveUntimedWait(clock_id);
+        return true;
+    }
+    auto locked_clock = s_virtual_clock.lock();
+    if (!locked_clock || timeout == 0)
+    {
+        return false;
+    }
+    int poll_ret = 0;
+    const bool happened =
+        locked_clock->waitUntil(locked_clock->deadlineAfter((int64_t)timeout * 1000000), [&](chrono::nanoseconds wait) {
+            poll_ret = poll(fds, nfds, (int)std::max<int64_t>(chrono::duration_cast<chrono::milliseconds>(wait).count(), 1));
+            return poll_ret != 0;
+        });
+    *result = happened ? poll_ret : 0;
+    return true;
+}
+
+bool virtualSelect(int nfds, fd_set *readfds, fd_set *writefds, fd_set *exceptfds, struct timeval *timeout,
+                   int *result)
+{
+    if (timeout == nullptr)
+    {
+        uint64_t clock_id;
+        if (!enterUntimedWait(&clock_id))
+        {
+            return false;
+        }
+        *result = select(nfds, readfds, writefds, exceptfds, nullptr);
+        leaveUntimedWait(clock_id);
+        return true;
+    }
+    auto locked_clock = s_virtual_clock.lock();
+    if (!locked_clock || (timeout->tv_sec <= 0 && timeout->tv_usec <= 0))
+    {
+        return false;
+    }
+
+    // select は待機のたびに fd_set を書き換えるため、元の集合を保存する
+    fd_set saved[3];
+    fd_set *sets[3] = {readfds, writefds, exceptfds};
+    for (size_t i = 0; i < 3U; ++i)
+    {
+        if (sets[i] != nullptr)
+        {
+            saved[i] = *sets[i];
+        }
+    }
+    const int64_t deadline =
+        locked_clock->deadlineAfter((int64_t)timeout->tv_sec * NANOSECONDS_PER_SECOND + (int64_t)timeout->tv_usec * 1000);
+    int select_ret = 0;
+    const bool happened = locked_clock->waitUntil(deadline, [&](chrono::nanoseconds wait) {
+        for (size_t i = 0; i < 3U; ++i)
+        {
+            if (sets[i] != nullptr)
+            {
+                *sets[i] = saved[i];
+            }
+        }
+        struct timeval slice;
+        slice.tv_sec = (time_t)(wait.count() / NANOSECONDS_PER_SECOND);
+        slice.tv_usec = (suseconds_t)std::max<int64_t>((wait.count() % NANOSECONDS_PER_SECOND) / 1000, 1);
+        select_ret = select(nfds, readfds, writefds, exceptfds, &slice);
+        return select_ret != 0;
+    });
+
+    // Linux と同様に残り時間を設定する
+    int64_t remaining;
+    {
+        std::lock_guard<std::mutex> lock(locked_clock->mtx);
+        remaining = std::max<int64_t>(deadline - locked_clock->timers.now(), 0);
+    }
+    timeout->tv_sec = (time_t)(remaining / NANOSECONDS_PER_SECOND);
+    timeout->tv_usec = (suseconds_t)((remaining % NANOSECONDS_PER_SECOND) / 1000);
+    if (!happened)
+    {
+        for (fd_set *set : sets)
+        {
+            if (set != nullptr)
+            {
+                FD_ZERO(set);
+            }
+        }
+    }
+    *result = happened ? select_ret : 0;
+    return true;
+}
+
+bool virtualPthreadCreate(pthread_t *thread, const pthread_attr_t *attr, void *(*start_routine)(void *), void *arg,
+                          int *result)
+{
+    auto locked_clock = s_virtual_clock.lock();
+    if (!locked_clock)
+    {
+        return false;
+    }
+    {
+        // 生成したスレッドが開始する前に次の期限に進めないよう、生成時から管理対象に数える
+        std::lock_guard<std::mutex> lock(locked_clock->mtx);
+        ++locked_clock->attached_threads;
+        locked_clock->changedLocked();
+    }
+    VirtualThreadStart *start = new VirtualThreadStart{start_routine, arg, locked_clock->id};
+    *result = pthread_create(thread, attr, startVirtualThread, start);
+    if (*result != 0)
+    {
+        delete start;
+        std::lock_guard<std::mutex> lock(locked_clock->mtx);
+        --locked_clock->attached_threads;
+        locked_clock->changedLocked();
+    }
+    return true;
+}
+
+bool virtualPthreadJoin(pthread_t thread, void **value, int *result)
+{
+    uint64_t clock_id;
+    if (!enterUntimedWait(&clock_id))
+    {
+        return false;
+    }
+    *result = pthread_join(thread, value);
+    leaveUntimedWait(clock_id);
+    return true;
+}
+
+bool virtualWaitFor(chrono::nanoseconds timeout, const function<bool(chrono::nanoseconds)> &wait_event,
+                    bool *happened)
+{
+    auto locked_clock = s_virtual_clock.lock();
+    if (!locked_clock)
+    {
+        return false;
+    }
+    if (timeout.count() <= 0)
+    {
+        *happened = wait_event(chrono::nanoseconds(0));
+        return true;
+    }
+    *happened = locked_clock->waitUntil(locked_clock->deadlineAfter(timeout.count()), wait_event);
+    return true;
+}
+
+bool virtualUntimedWait(const function<void()> &wait)
+{
+    uint64_t clock_id;
+    if (!enterUntimedWait(&clock_id))
+    {
+        return false;
+    }
+    wait();
+    leaveUntimedWait(clock_id);
+    return true;
+}
+
+} // namespace testing
+
+#endif // _WIN32
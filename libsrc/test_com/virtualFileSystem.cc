@@ -0,0 +1,1822 @@
+/* stdio / unistd の mock 関数の委譲先とするメモリー上のファイル システム。
+ * ファイル ツリーは inode の木構造で、ファイルの内容は固定長のエクステント単位で保持する (未書き込みの範囲は 0 として読む)。
+ * スナップショットはファイル ツリーを共有する (copy-on-write)。スナップショットの作成・復元ごとに世代を進め、
+ * 古い世代の inode / エクステントは変更する時に複製するため、作成・復元は O(1)、変更は変更した範囲のみ複製する。
+ * ファイル記述子と FILE * は開いたファイルの記述 (位置・アクセス モード) を共有し、操作はすべて 1 個の mutex で直列化する。
+ * FILE * は fopencookie で作成した本物のストリームで、読み書き・シーク・クローズを関数経由でファイル ツリーに委譲する。
+ * mmap はマップする範囲の内容を memfd に設定して本物の mmap でマップし、MAP_SHARED の変更は msync / munmap で書き戻す。
+ * 合成ファイル (writeSyntheticFile) は、エクステントの無い範囲の内容を読み込み時に生成する。 */
+
+#ifndef _WIN32
+
+    #include <mock_instance.h>
+    #include <test_com.h>
+    #include <virtualFileSystem.h>
+
+    #include <algorithm>
+    #include <cerrno>
+    #include <cstring>
+    #include <ctime>
+    #include <limits>
+    #include <map>
+    #include <mutex>
+    #include <unordered_map>
+    #include <unordered_set>
+
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <unistd.h>
+
+namespace testing
+{
+
+namespace
+{
+
+// エクステントの大きさ。末尾のエクステントは書き込んだ範囲のみ確保する
+constexpr uint64_t EXTENT_SIZE = 16U * 1024U;
+
+// st_dev に設定する値 (本物のファイルと区別するため)
+constexpr dev_t VIRTUAL_DEVICE = 0x7646;
+
+struct VirtualInode
+{
+    uint64_t generation = 0; // 作成・複製した世代。現在の世代より古い場合はスナップショットと共有している
+    bool directory = false;
+    mode_t mode = 0;
+    ino_t ino = 0;
+    uint64_t size = 0;
+    map<uint64_t, shared_ptr<vector<char>>> extents; // エクステント番号 -> 内容
+    map<string, shared_ptr<VirtualInode>> children;  // ディレクトリの要素
+    shared_ptr<const SyntheticFileContent> synthetic; // エクステントの無い範囲の内容 (合成ファイルのみ)
+    uint64_t synthetic_size = 0;                      // synthetic から生成する範囲の大きさ
+    struct timespec atime = {0, 0};
+    struct timespec mtime = {0, 0};
+    struct timespec ctime = {0, 0};
+};
+
+// open / fopen ごとの記述。dup 等で共有しないため、ファイル記述子と FILE * で 1 対 1
+struct VirtualOpenFile
+{
+    shared_ptr<VirtualInode> inode;
+    vector<string> path; // 開いたパス (mount_point からの相対。rename で付け替える)
+    uint64_t offset = 0;
+    bool readable = false;
+    bool writable = false;
+    bool append = false;
+    uint64_t sequence = 0; // 開いた順序 (リスナーがテスト中に開いたファイルを判定する)
+};
+
+// fopencookie の cookie。FILE * が所有し、クローズ関数で解放する。
+// VirtualFileSystem が閉じた (登録を外した) 後の読み書きは EBADF で失敗する
+struct VirtualStream
+{
+    VirtualOpenFile file;
+};
+
+// mmap したマッピングの内容を保持する memfd。munmap で分割したマッピングで共有する
+struct VirtualMappingBacking
+{
+    explicit VirtualMappingBacking(int fd_value) : fd(fd_value)
+    {
+    }
+    ~VirtualMappingBacking()
+    {
+        close(fd);
+    }
+    VirtualMappingBacking(const VirtualMappingBacking &) = delete;
+    VirtualMappingBacking &operator=(const VirtualMappingBacking &) = delete;
+
+    int fd;
+};
+
+struct VirtualMapping
+{
+    shared_ptr<VirtualInode> inode;
+    vector<string> path; // マップしたファイルのパス (VirtualOpenFile::path と同じ)
+    shared_ptr<VirtualMappingBacking> backing;
+    uint64_t offset = 0; // ファイル (memfd) 上の位置
+    size_t length = 0;   // ページ単位
+    bool write_back = false; // MAP_SHARED かつ PROT_WRITE
+};
+
+struct ResolvedPath
+{
+    vector<string> components; // mount_point からの相対
+    bool trailing_slash = false;
+};
+
+size_t pageSize()
+{
+    static const size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+    return page_size;
+}
+
+struct timespec currentTime()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    return now;
+}
+
+// '.' / '..' / 連続した '/' を解決して components に追加する。'..' は components の先頭より上に戻らない
+void appendPathComponents(const string &path, vector<string> *components)
+{
+    size_t begin = 0;
+    while (begin <= path.size())
+    {
+        size_t end = path.find('/', begin);
+        if (end == string::npos)
+        {
+            end = path.size();
+        }
+        const string component = path.substr(begin, end - begin);
+        if (component == "..")
+        {
+            if (!components->empty())
+            {
+                components->pop_back();
+            }
+        }
+        else if (!component.empty() && component != ".")
+        {
+            components->push_back(component);
+        }
+        begin = end + 1U;
+    }
+}
+
+// 他の inode (スナップショット) と共有しているエクステントを複製する
+void ownExtent(shared_ptr<vector<char>> &extent)
+{
+    if (extent.use_count() > 1)
+    {
+        extent = make_shared<vector<char>>(*extent);
+    }
+}
+
+void fillStat(const VirtualInode &inode, struct stat *buf)
+{
+    memset(buf, 0, sizeof(*buf));
+    buf->st_dev = VIRTUAL_DEVICE;
+    buf->st_ino = inode.ino;
+    buf->st_mode = (inode.directory ? S_IFDIR : S_IFREG) | inode.mode;
+    buf->st_nlink = 1;
+    if (inode.directory)
+    {
+        buf->st_nlink = 2;
+        for (const auto &child : inode.children)
+        {
+            buf->st_nlink += child.second->directory ? 1U : 0U;
+        }
+    }
+    buf->st_uid = geteuid();
+    buf->st_gid = getegid();
+    buf->st_size = (off_t)inode.size;
+    buf->st_blksize = (blksize_t)EXTENT_SIZE;
+    uint64_t allocated = 0;
+    for (const auto &extent : inode.extents)
+    {
+        allocated += extent.second->size();
+    }
+    buf->st_blocks = (blkcnt_t)((allocated + 511U) / 512U);
+    buf->st_atim = inode.atime;
+    buf->st_mtim = inode.mtime;
+    buf->st_ctim = inode.ctime;
+}
+
+// エクステントの無い範囲の内容 (合成ファイルは生成した内容、それ以外は 0) を設定する
+void fillUnstored(const VirtualInode &inode, uint64_t offset, char *buf, size_t count)
+{
+    size_t generated = 0;
+    if (inode.synthetic && offset < inode.synthetic_size)
+    {
+        generated = (size_t)std::min<uint64_t>(count, inode.synthetic_size - offset);
+        inode.synthetic->generate(offset, buf, generated);
+    }
+    memset(buf + generated, 0, count - generated);
+}
+
+size_t readContents(const VirtualInode &inode, uint64_t offset, void *buf, size_t count)
+{
+    if (offset >= inode.size)
+    {
+        return 0;
+    }
+    const size_t total = (size_t)std::min<uint64_t>(count, inode.size - offset);
+    char *out = (char *)buf;
+    size_t done = 0;
+    while (done < total)
+    {
+        const uint64_t position = offset + done;
+        const uint64_t index = position / EXTENT_SIZE;
+        const size_t within = (size_t)(position % EXTENT_SIZE);
+        const size_t chunk = std::min<size_t>(total - done, (size_t)(EXTENT_SIZE - within));
+        auto extent = inode.extents.find(index);
+        const size_t stored =
+            extent == inode.extents.end() || extent->second->size() <= within ? 0U : extent->second->size() - within;
+        const size_t copied = std::min(chunk, stored);
+        if (copied != 0U)
+        {
+            memcpy(out + done, extent->second->data() + within, copied);
+        }
+        fillUnstored(inode, position + copied, out + done + copied, chunk - copied);
+        done += chunk;
+    }
+    return total;
+}
+
+void writeContents(VirtualInode &inode, uint64_t offset, const void *buf, size_t count)
+{
+    const char *in = (const char *)buf;
+    size_t done = 0;
+    while (done < count)
+    {
+        const uint64_t position = offset + done;
+        const uint64_t index = position / EXTENT_SIZE;
+        const size_t within = (size_t)(position % EXTENT_SIZE);
+        const size_t chunk = std::min<size_t>(count - done, (size_t)(EXTENT_SIZE - within));
+        shared_ptr<vector<char>> &extent = inode.extents[index];
+        if (!extent)
+        {
+            extent = make_shared<vector<char>>();
+        }
+        ownExtent(extent);
+        if (extent->size() < within + chunk)
+        {
+            // 書き込む位置までの隙間は、書き込む前の内容 (合成ファイルは生成した内容) とする
+            const size_t stored = extent->size();
+            extent->resize(within + chunk);
+            if (stored < within)
+            {
+                fillUnstored(inode, index * EXTENT_SIZE + stored, extent->data() + stored, within - stored);
+            }
+        }
+        memcpy(extent->data() + within, in + done, chunk);
+        done += chunk;
+    }
+    inode.size = std::max<uint64_t>(inode.size, offset + count);
+    inode.mtime = inode.ctime = currentTime();
+}
+
+void truncateContents(VirtualInode &inode, uint64_t length)
+{
+    for (auto it = inode.extents.lower_bound(length / EXTENT_SIZE); it != inode.extents.end();)
+    {
+        const uint64_t begin = it->first * EXTENT_SIZE;
+        if (begin >= length)
+        {
+            it = inode.extents.erase(it);
+            continue;
+        }
+        if (it->second->size() > length - begin)
+        {
+            ownExtent(it->second);
+            it->second->resize((size_t)(length - begin));
+        }
+        ++it;
+    }
+    inode.size = length;
+    inode.synthetic_size = std::min(inode.synthetic_size, length);
+    inode.mtime = inode.ctime = currentTime();
+}
+
+// fopen のモード文字列を open のフラグに変換する。不正な場合は -1
+int parseStreamModes(const char *modes)
+{
+    int flags;
+    switch (modes[0])
+    {
+    case 'r':
+        flags = O_RDONLY;
+        break;
+    case 'w':
+        flags = O_WRONLY | O_CREAT | O_TRUNC;
+        break;
+    case 'a':
+        flags = O_WRONLY | O_CREAT | O_APPEND;
+        break;
+    default:
+        return -1;
+    }
+    for (const char *mode = modes + 1; *mode != '\0' && *mode != ','; ++mode)
+    {
+        if (*mode == '+')
+        {
+            flags = (flags & ~O_ACCMODE) | O_RDWR;
+        }
+        else if (*mode == 'x')
+        {
+            flags |= O_EXCL;
+        }
+    }
+    return flags;
+}
+
+} // namespace
+
+struct VirtualFileSystemSnapshot
+{
+    shared_ptr<VirtualInode> root;
+};
+
+struct VirtualFileSystemState
+{
+    VirtualFileSystemState(VirtualFileSystem *owner_value, const string &mount_point) : owner(owner_value)
+    {
+        appendPathComponents(mount_point, &mount);
+        root = makeInode(true, 0755);
+    }
+
+    // path が mount_point 配下 (または相対パス) の場合に true を返す
+    bool resolve(const char *path, ResolvedPath *resolved) const
+    {
+        if (path == nullptr)
+        {
+            return false;
+        }
+        const string text(path);
+        resolved->trailing_slash = !text.empty() && text.back() == '/';
+        if (text.empty() || text[0] != '/')
+        {
+            resolved->components = cwd;
+            appendPathComponents(text, &resolved->components);
+            return true;
+        }
+
+        vector<string> absolute;
+        appendPathComponents(text, &absolute);
+        if (absolute.size() < mount.size() || !std::equal(mount.begin(), mount.end(), absolute.begin()))
+        {
+            return false;
+        }
+        resolved->components.assign(absolute.begin() + (ptrdiff_t)mount.size(), absolute.end());
+        return true;
+    }
+
+    shared_ptr<VirtualInode> makeInode(bool directory, mode_t mode)
+    {
+        auto inode = make_shared<VirtualInode>();
+        inode->generation = generation;
+        inode->directory = directory;
+        inode->mode = mode & 07777;
+        inode->ino = next_ino++;
+        inode->atime = inode->mtime = inode->ctime = currentTime();
+        return inode;
+    }
+
+    // mtx を取得して呼び出す。inode が古い世代の場合は複製し、開いているファイルの参照も付け替える
+    shared_ptr<VirtualInode> own(shared_ptr<VirtualInode> inode)
+    {
+        if (inode->generation == generation)
+        {
+            return inode;
+        }
+        auto copy = make_shared<VirtualInode>(*inode);
+        copy->generation = generation;
+        for (auto &entry : descriptors)
+        {
+            if (entry.second.inode == inode)
+            {
+                entry.second.inode = copy;
+            }
+        }
+        for (VirtualStream *stream : streams)
+        {
+            if (stream->file.inode == inode)
+            {
+                stream->file.inode = copy;
+            }
+        }
+        for (auto &entry : mappings)
+        {
+            if (entry.second.inode == inode)
+            {
+                entry.second.inode = copy;
+            }
+        }
+        return copy;
+    }
+
+    // mtx を取得して呼び出す。parent の要素 name を現在の世代にして返す
+    shared_ptr<VirtualInode> ownChild(const shared_ptr<VirtualInode> &parent, const string &name)
+    {
+        shared_ptr<VirtualInode> &child = parent->children[name];
+        child = own(child);
+        return child;
+    }
+
+    // mtx を取得して呼び出す。ファイル記述子 / FILE * / マッピング経由で変更する inode を現在の世代にする。
+    // path は開いたパスで、ファイル ツリーのそのパスが inode の場合のみツリー側も付け替える
+    VirtualInode &ownOpenInode(shared_ptr<VirtualInode> &inode, const vector<string> &path)
+    {
+        if (inode->generation != generation)
+        {
+            shared_ptr<VirtualInode> parent;
+            bool in_tree = !path.empty() && lookupParent(path, false, &parent) == 0;
+            if (in_tree)
+            {
+                auto child = parent->children.find(path.back());
+                in_tree = child != parent->children.end() && child->second == inode;
+            }
+            if (in_tree && lookupParent(path, true, &parent) == 0)
+            {
+                inode = ownChild(parent, path.back());
+            }
+            else
+            {
+                // 削除済み (または復元前) のファイルは、ファイル ツリーに戻さずに複製する
+                inode = own(inode);
+            }
+        }
+        return *inode;
+    }
+
+    // mtx を取得して呼び出す。rename した from 配下を開いているファイルのパスを to に付け替える
+    void renameOpenPaths(const vector<string> &from, const vector<string> &to)
+    {
+        auto rename_path = [&](vector<string> &path) {
+            if (path.size() >= from.size() && std::equal(from.begin(), from.end(), path.begin()))
+            {
+                path.erase(path.begin(), path.begin() + (ptrdiff_t)from.size());
+                path.insert(path.begin(), to.begin(), to.end());
+            }
+        };
+        for (auto &entry : descriptors)
+        {
+            rename_path(entry.second.path);
+        }
+        for (VirtualStream *stream : streams)
+        {
+            rename_path(stream->file.path);
+        }
+        for (auto &entry : mappings)
+        {
+            rename_path(entry.second.path);
+        }
+    }
+
+    // mtx を取得して呼び出す。components の末尾を除くディレクトリを返す (失敗時は errno の値を返す)。
+    // for_update の場合は経路上の inode を現在の世代にする
+    int lookupParent(const vector<string> &components, bool for_update, shared_ptr<VirtualInode> *parent)
+    {
+        if (for_update)
+        {
+            root = own(root);
+        }
+        shared_ptr<VirtualInode> current = root;
+        for (size_t i = 0; i + 1U < components.size(); ++i)
+        {
+            auto child = current->children.find(components[i]);
+            if (child == current->children.end())
+            {
+                return ENOENT;
+            }
+            if (!child->second->directory)
+            {
+                return ENOTDIR;
+            }
+            if (for_update)
+            {
+                child->second = own(child->second);
+            }
+            current = child->second;
+        }
+        *parent = current;
+        return 0;
+    }
+
+    // mtx を取得して呼び出す。存在しない場合は *inode を nullptr とし 0 を返す。
+    // for_update の場合は *parent までの経路を現在の世代にする (*inode は変更しない)
+    int lookup(const ResolvedPath &path, shared_ptr<VirtualInode> *parent, shared_ptr<VirtualInode> *inode,
+               bool for_update = false)
+    {
+        if (path.components.empty())
+        {
+            if (for_update)
+            {
+                root = own(root);
+            }
+            *parent = root;
+            *inode = root;
+            return 0;
+        }
+        const int error = lookupParent(path.components, for_update, parent);
+        if (error != 0)
+        {
+            return error;
+        }
+        auto child = (*parent)->children.find(path.components.back());
+        *inode = child == (*parent)->children.end() ? nullptr : child->second;
+        if (*inode != nullptr && path.trailing_slash && !(*inode)->directory)
+        {
+            return ENOTDIR;
+        }
+        return 0;
+    }
+
+    // mtx を取得して呼び出す。失敗時は errno の値を返す
+    int openFile(const ResolvedPath &path, int flags, mode_t mode, VirtualOpenFile *file)
+    {
+        shared_ptr<VirtualInode> parent;
+        shared_ptr<VirtualInode> inode;
+        int error = lookup(path, &parent, &inode, (flags & (O_CREAT | O_TRUNC)) != 0);
+        if (error != 0)
+        {
+            return error;
+        }
+
+        const int access_mode = flags & O_ACCMODE;
+        file->readable = access_mode == O_RDONLY || access_mode == O_RDWR;
+        file->writable = access_mode == O_WRONLY || access_mode == O_RDWR;
+        file->append = (flags & O_APPEND) != 0;
+
+        if (inode == nullptr)
+        {
+            if ((flags & O_CREAT) == 0)
+            {
+                return ENOENT;
+            }
+            if (path.trailing_slash)
+            {
+                return EISDIR;
+            }
+            if ((parent->mode & S_IWUSR) == 0U)
+            {
+                return EACCES;
+            }
+            inode = makeInode(false, mode);
+            parent->children[path.components.back()] = inode;
+            parent->mtime = parent->ctime = inode->mtime;
+        }
+        else
+        {
+            if ((flags & (O_CREAT | O_EXCL)) == (O_CREAT | O_EXCL))
+            {
+                return EEXIST;
+            }
+            if (inode->directory && file->writable)
+            {
+                return EISDIR;
+            }
+            if ((flags & O_DIRECTORY) != 0 && !inode->directory)
+            {
+                return ENOTDIR;
+            }
+            if ((file->readable && (inode->mode & S_IRUSR) == 0U) || (file->writable && (inode->mode & S_IWUSR) == 0U))
+            {
+                return EACCES;
+            }
+            if ((flags & O_TRUNC) != 0 && file->writable)
+            {
+                inode = ownChild(parent, path.components.back());
+                truncateContents(*inode, 0U);
+            }
+        }
+
+        file->inode = inode;
+        file->path = path.components;
+        file->offset = 0;
+        file->sequence = next_sequence++;
+        return 0;
+    }
+
+    // mtx を取得して呼び出す
+    ssize_t readFile(VirtualOpenFile &file, void *buf, size_t count)
+    {
+        if (!file.readable)
+        {
+            errno = EBADF;
+            return -1;
+        }
+        if (file.inode->directory)
+        {
+            errno = EISDIR;
+            return -1;
+        }
+        const size_t done = readContents(*file.inode, file.offset, buf, std::min<size_t>(count, SSIZE_MAX));
+        file.offset += done;
+        return (ssize_t)done;
+    }
+
+    // mtx を取得して呼び出す
+    ssize_t writeFile(VirtualOpenFile &file, const void *buf, size_t count)
+    {
+        if (!file.writable)
+        {
+            errno = EBADF;
+            return -1;
+        }
+        VirtualInode &inode = ownOpenInode(file.inode, file.path);
+        if (file.append)
+        {
+            file.offset = inode.size;
+        }
+        count = std::min<size_t>(count, SSIZE_MAX);
+        if (file.offset + count > (uint64_t)std::numeric_limits<off_t>::max())
+        {
+            errno = EFBIG;
+            return -1;
+        }
+        writeContents(inode, file.offset, buf, count);
+        file.offset += count;
+        return (ssize_t)count;
+    }
+
+    // mtx を取得して呼び出す
+    off_t seekFile(VirtualOpenFile &file, off_t offset, int whence)
+    {
+        int64_t base;
+        switch (whence)
+        {
+        case SEEK_SET:
+            base = 0;
+            break;
+        case SEEK_CUR:
+            base = (int64_t)file.offset;
+            break;
+        case SEEK_END:
+            base = (int64_t)file.inode->size;
+            break;
+        default:
+            errno = EINVAL;
+            return -1;
+        }
+        if ((offset > 0 && base > std::numeric_limits<off_t>::max() - offset) || base + offset < 0)
+        {
+            errno = offset > 0 ? EOVERFLOW : EINVAL;
+            return -1;
+        }
+        file.offset = (uint64_t)(base + offset);
+        return (off_t)file.offset;
+    }
+
+    // mtx を取得して呼び出す
+    int removeEntry(const ResolvedPath &path, bool directory)
+    {
+        shared_ptr<VirtualInode> parent;
+        shared_ptr<VirtualInode> inode;
+        int error = lookup(path, &parent, &inode, true);
+        if (error == 0 && inode == nullptr)
+        {
+            error = ENOENT;
+        }
+        else if (error == 0 && path.components.empty())
+        {
+            error = directory ? EBUSY : EISDIR;
+        }
+        else if (error == 0 && directory && !inode->directory)
+        {
+            error = ENOTDIR;
+        }
+        else if (error == 0 && !directory && inode->directory)
+        {
+            error = EISDIR;
+        }
+        else if (error == 0 && directory && !inode->children.empty())
+        {
+            error = ENOTEMPTY;
+        }
+        if (error != 0)
+        {
+            errno = error;
+            return -1;
+        }
+        parent->children.erase(path.components.back());
+        parent->mtime = parent->ctime = currentTime();
+        return 0;
+    }
+
+    // mtx を取得して呼び出す
+    int renameEntry(const ResolvedPath &from, const ResolvedPath &to)
+    {
+        shared_ptr<VirtualInode> from_parent;
+        shared_ptr<VirtualInode> source;
+        shared_ptr<VirtualInode> to_parent;
+        shared_ptr<VirtualInode> target;
+        int error = lookup(from, &from_parent, &source, true);
+        if (error == 0 && source == nullptr)
+        {
+            error = ENOENT;
+        }
+        if (error == 0)
+        {
+            error = lookup(to, &to_parent, &target, true);
+        }
+        if (error == 0 && (from.components.empty() || to.components.empty()))
+        {
+            error = EBUSY;
+        }
+        if (error == 0 && source->directory && to.components.size() > from.components.size() &&
+            std::equal(from.components.begin(), from.components.end(), to.components.begin()))
+        {
+            error = EINVAL;
+        }
+        if (error == 0 && target != nullptr && target != source)
+        {
+            if (source->directory && !target->directory)
+            {
+                error = ENOTDIR;
+            }
+            else if (!source->directory && target->directory)
+            {
+                error = EISDIR;
+            }
+            else if (target->directory && !target->children.empty())
+            {
+                error = ENOTEMPTY;
+            }
+        }
+        if (error != 0)
+        {
+            errno = error;
+            return -1;
+        }
+        if (target == source)
+        {
+            return 0;
+        }
+
+        source = own(source);
+        from_parent->children.erase(from.components.back());
+        to_parent->children[to.components.back()] = source;
+        from_parent->mtime = from_parent->ctime = to_parent->mtime = to_parent->ctime = source->ctime = currentTime();
+        renameOpenPaths(from.components, to.components);
+        return 0;
+    }
+
+    // mtx を取得して呼び出す。fd の最小の空きを割り当てる
+    int allocateDescriptor(const VirtualOpenFile &file)
+    {
+        int fd = VirtualFileSystem::FD_BASE;
+        for (const auto &entry : descriptors)
+        {
+            if (entry.first != fd)
+            {
+                break;
+            }
+            ++fd;
+        }
+        descriptors[fd] = file;
+        return fd;
+    }
+
+    VirtualOpenFile *findDescriptor(int fd)
+    {
+        auto found = descriptors.find(fd);
+        return found == descriptors.end() ? nullptr : &found->second;
+    }
+
+    // mtx を取得して呼び出す。sequence 以降に開いたファイルを閉じる。
+    // FILE * はテスト対象コードが保持している可能性があるため解放せず、登録を外して以降の読み書きを失敗させる
+    // (fclose で解放する)
+    void closeOpenedSince(uint64_t sequence)
+    {
+        for (auto it = descriptors.begin(); it != descriptors.end();)
+        {
+            it = it->second.sequence >= sequence ? descriptors.erase(it) : std::next(it);
+        }
+        for (auto it = streams.begin(); it != streams.end();)
+        {
+            if ((*it)->file.sequence >= sequence)
+            {
+                (*it)->file.inode.reset();
+                it = streams.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    // mtx を取得して呼び出す。MAP_SHARED のマッピングの [begin, end) (マッピングの先頭からの位置) をファイルに書き戻す。
+    // memfd のデータのある範囲のみ、内容が異なる部分を書き込む
+    void writeBack(VirtualMapping &mapping, size_t begin, size_t end)
+    {
+        const int fd = mapping.backing->fd;
+        uint64_t position = mapping.offset + begin;
+        const uint64_t stop = std::min<uint64_t>(mapping.offset + end, mapping.inode->size);
+        vector<char> mapped(EXTENT_SIZE);
+        vector<char> stored(EXTENT_SIZE);
+        while (position < stop)
+        {
+            const off_t data = lseek(fd, (off_t)position, SEEK_DATA);
+            if (data < 0 || (uint64_t)data >= stop)
+            {
+                break;
+            }
+            const off_t hole = lseek(fd, data, SEEK_HOLE);
+            const uint64_t data_end = hole < 0 ? stop : std::min<uint64_t>((uint64_t)hole, stop);
+            for (position = (uint64_t)data; position < data_end;)
+            {
+                const size_t chunk = (size_t)std::min<uint64_t>(data_end - position, EXTENT_SIZE);
+                if (pread(fd, mapped.data(), chunk, (off_t)position) != (ssize_t)chunk)
+                {
+                    return;
+                }
+                readContents(*mapping.inode, position, stored.data(), chunk);
+                if (memcmp(mapped.data(), stored.data(), chunk) != 0)
+                {
+                    writeContents(ownOpenInode(mapping.inode, mapping.path), position, mapped.data(), chunk);
+                    mapping_stats.written_back_bytes += chunk;
+                }
+                position += chunk;
+            }
+        }
+    }
+
+    // mtx を取得して呼び出す。[begin, end) と重なるマッピングのアドレスを返す
+    vector<uintptr_t> findMappings(uintptr_t begin, uintptr_t end) const
+    {
+        vector<uintptr_t> found;
+        auto it = mappings.upper_bound(begin);
+        if (it != mappings.begin())
+        {
+            --it;
+        }
+        for (; it != mappings.end() && it->first < end; ++it)
+        {
+            if (it->first + it->second.length > begin)
+            {
+                found.push_back(it->first);
+            }
+        }
+        return found;
+    }
+
+    // mtx を取得して呼び出す。[begin, end) のマッピングを書き戻して管理対象から外す。
+    // 範囲外の部分は別のマッピングとして残す。重なるマッピングが無い場合は false を返す
+    bool unmapRange(uintptr_t begin, uintptr_t end)
+    {
+        const vector<uintptr_t> found = findMappings(begin, end);
+        for (const uintptr_t start : found)
+        {
+            VirtualMapping mapping = mappings[start];
+            const uintptr_t unmap_begin = std::max(start, begin);
+            const uintptr_t unmap_end = std::min<uintptr_t>(start + mapping.length, end);
+            if (mapping.write_back)
+            {
+                writeBack(mapping, unmap_begin - start, unmap_end - start);
+            }
+            mappings.erase(start);
+            if (start < unmap_begin)
+            {
+                VirtualMapping &head = mappings[start];
+                head = mapping;
+                head.length = unmap_begin - start;
+            }
+            if (unmap_end < start + mapping.length)
+            {
+                VirtualMapping &rest = mappings[unmap_end];
+                rest = mapping;
+                rest.offset = mapping.offset + (unmap_end - start);
+                rest.length = start + mapping.length - unmap_end;
+            }
+            mapping_stats.mapped_bytes -= unmap_end - unmap_begin;
+        }
+        return !found.empty();
+    }
+
+    VirtualFileSystem *owner;
+    vector<string> mount; // mount_point の構成要素
+    vector<string> cwd;   // 作業ディレクトリ (mount_point からの相対)
+    mutable std::mutex mtx;
+    shared_ptr<VirtualInode> root;
+    map<int, VirtualOpenFile> descriptors;
+    unordered_set<VirtualStream *> streams; // 開いている FILE * の cookie (所有しない)
+    map<uintptr_t, VirtualMapping> mappings; // 先頭アドレス -> マッピング
+    VirtualMappingStats mapping_stats;
+    ino_t next_ino = 2;
+    uint64_t next_sequence = 1;
+    uint64_t generation = 1; // スナップショットの作成・復元ごとに進める
+};
+
+namespace
+{
+
+testfw::MockSlot<VirtualFileSystemState> s_virtual_file_system;
+
+class VirtualFileSystemListener : public EmptyTestEventListener
+{
+  public:
+    explicit VirtualFileSystemListener(const string &mount_point) : vfs_(new VirtualFileSystem(mount_point))
+    {
+    }
+
+    void OnTestStart(const TestInfo &) override
+    {
+        snapshot_ = vfs_->snapshot();
+        auto locked_vfs = s_virtual_file_system.lock();
+        if (locked_vfs)
+        {
+            std::lock_guard<std::mutex> lock(locked_vfs->mtx);
+            sequence_ = locked_vfs->next_sequence;
+        }
+    }
+
+    void OnTestEnd(const TestInfo &) override
+    {
+        auto locked_vfs = s_virtual_file_system.lock();
+        if (locked_vfs)
+        {
+            std::lock_guard<std::mutex> lock(locked_vfs->mtx);
+            locked_vfs->closeOpenedSince(sequence_);
+        }
+        if (snapshot_)
+        {
+            vfs_->restore(snapshot_);
+        }
+    }
+
+    void OnTestProgramEnd(const UnitTest &) override
+    {
+        vfs_.reset();
+    }
+
+  private:
+    unique_ptr<VirtualFileSystem> vfs_;
+    shared_ptr<const VirtualFileSystemSnapshot> snapshot_;
+    uint64_t sequence_ = 0;
+};
+
+// errno を設定して value を返す
+template <typename T> T failWith(int error, T value)
+{
+    errno = error;
+    return value;
+}
+
+// 以下は fopencookie の関数。VirtualFileSystem が無い場合と、登録を外した (閉じた) ストリームは EBADF で失敗する
+
+ssize_t readVirtualStream(void *cookie, char *buf, size_t size)
+{
+    VirtualStream *stream = static_cast<VirtualStream *>(cookie);
+    auto locked_vfs = s_virtual_file_system.lock();
+    if (!locked_vfs)
+    {
+        return failWith(EBADF, (ssize_t)-1);
+    }
+    std::lock_guard<std::mutex> lock(locked_vfs->mtx);
+    if (locked_vfs->streams.count(stream) == 0U)
+    {
+        return failWith(EBADF, (ssize_t)-1);
+    }
+    return locked_vfs->readFile(stream->file, buf, size);
+}
+
+// 失敗時は 0 を返す (fopencookie の書き込み関数は負の値を返してはならない)
+ssize_t writeVirtualStream(void *cookie, const char *buf, size_t size)
+{
+    VirtualStream *stream = static_cast<VirtualStream *>(cookie);
+    auto locked_vfs = s_virtual_file_system.lock();
+    if (!locked_vfs)
+    {
+        return failWith(EBADF, (ssize_t)0);
+    }
+    std::lock_guard<std::mutex> lock(locked_vfs->mtx);
+    if (locked_vfs->streams.count(stream) == 0U)
+    {
+        return failWith(EBADF, (ssize_t)0);
+    }
+    const ssize_t done = locked_vfs->writeFile(stream->file, buf, size);
+    return done < 0 ? 0 : done;
+}
+
+int seekVirtualStream(void *cookie, off64_t *offset, int whence)
+{
+    VirtualStream *stream = static_cast<VirtualStream *>(cookie);
+    auto locked_vfs = s_virtual_file_system.lock();
+    if (!locked_vfs)
+    {
+        return failWith(EBADF, -1);
+    }
+    std::lock_guard<std::mutex> lock(locked_vfs->mtx);
+    if (locked_vfs->streams.count(stream) == 0U)
+    {
+        return failWith(EBADF, -1);
+    }
+    const off_t position = locked_vfs->seekFile(stream->file, (off_t)*offset, whence);
+    if (position < 0)
+    {
+        return -1;
+    }
+    *offset = position;
+    return 0;
+}
+
+// fclose から呼び出される。VirtualFileSystem の破棄後も cookie を解放する
+int closeVirtualStream(void *cookie)
+{
+    VirtualStream *stream = static_cast<VirtualStream *>(cookie);
+    auto locked_vfs = s_virtual_file_system.lock();
+    if (locked_vfs)
+    {
+        std::lock_guard<std::mutex> lock(locked_vfs->mtx);
+        locked_vfs->streams.erase(stream);
+    }
+    delete stream;
+    return 0;
+}
+
+const cookie_io_functions_t kVirtualStreamFunctions = {readVirtualStream, writeVirtualStream, seekVirtualStream,
+                                                       closeVirtualStream};
+
+} // namespace
+
+namespace
+{
+
+// word の within バイト目以降をリトル エンディアンで buf[done] 以降 (length まで) に設定し、設定後の done を返す
+size_t storeWord(uint64_t word, size_t within, char *buf, size_t done, size_t length)
+{
+    #if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    if (within == 0U && length - done >= 8U)
+    {
+        memcpy(buf + done, &word, 8U);
+        return done + 8U;
+    }
+    #endif
+    for (; within < 8U && done < length; ++within, ++done)
+    {
+        buf[done] = (char)(uint8_t)(word >> (8U * within));
+    }
+    return done;
+}
+
+} // namespace
+
+SyntheticFileContent::SyntheticFileContent(Filler fill) : fill_(std::move(fill))
+{
+}
+
+SyntheticFileContent SyntheticFileContent::constant(char value)
+{
+    return SyntheticFileContent([value](uint64_t, char *buf, size_t length) { memset(buf, value, length); });
+}
+
+SyntheticFileContent SyntheticFileContent::counter(uint64_t start)
+{
+    return SyntheticFileContent([start](uint64_t offset, char *buf, size_t length) {
+        uint64_t word_index = offset / 8U;
+        size_t within = (size_t)(offset % 8U);
+        for (size_t done = 0; done < length; ++word_index, within = 0)
+        {
+            done = storeWord(start + word_index, within, buf, done, length);
+        }
+    });
+}
+
+SyntheticFileContent SyntheticFileContent::random(uint64_t seed)
+{
+    return SyntheticFileContent([seed](uint64_t offset, char *buf, size_t length) {
+        uint64_t word_index = offset / 8U;
+        size_t within = (size_t)(offset % 8U);
+        for (size_t done = 0; done < length; ++word_index, within = 0)
+        {
+            // splitmix64 (8 バイトごとに位置から独立して求めるため、シークは O(1))
+            uint64_t word = seed + word_index * 0x9e3779b97f4a7c15ULL;
+            word = (word ^ (word >> 30U)) * 0xbf58476d1ce4e5b9ULL;
+            word = (word ^ (word >> 27U)) * 0x94d049bb133111ebULL;
+            word ^= word >> 31U;
+            done = storeWord(word, within, buf, done, length);
+        }
+    });
+}
+
+SyntheticFileContent SyntheticFileContent::repeat(const string &pattern)
+{
+    if (pattern.empty())
+    {
+        return constant('\0');
+    }
+    return SyntheticFileContent([pattern](uint64_t offset, char *buf, size_t length) {
+        size_t within = (size_t)(offset % pattern.size());
+        for (size_t done = 0; done < length; within = 0)
+        {
+            const size_t chunk = std::min(length - done, pattern.size() - within);
+            memcpy(buf + done, pattern.data() + within, chunk);
+            done += chunk;
+        }
+    });
+}
+
+SyntheticFileContent SyntheticFileContent::records(size_t record_size, RecordGenerator generator)
+{
+    if (record_size == 0U)
+    {
+        return constant('\0');
+    }
+    return SyntheticFileContent([record_size, generator](uint64_t offset, char *buf, size_t length) {
+        vector<char> record(record_size);
+        uint64_t index = offset / record_size;
+        size_t within = (size_t)(offset % record_size);
+        for (size_t done = 0; done < length; ++index, within = 0)
+        {
+            const size_t chunk = std::min(length - done, record_size - within);
+            if (within == 0U && chunk == record_size)
+            {
+                generator(index, buf + done);
+            }
+            else
+            {
+                generator(index, record.data());
+                memcpy(buf + done, record.data() + within, chunk);
+            }
+            done += chunk;
+        }
+    });
+}
+
+void SyntheticFileContent::generate(uint64_t offset, char *buf, size_t length) const
+{
+    fill_(offset, buf, length);
+}
+
+VirtualFileSystem::VirtualFileSystem(const string &mount_point)
+    : state_(new VirtualFileSystemState(this, mount_point))
+{
+    if (s_virtual_file_system.get() != nullptr)
+    {
+        ADD_FAILURE() << "Only one VirtualFileSystem may exist at a time.";
+        return;
+    }
+    s_virtual_file_system.publish(state_.get());
+}
+
+VirtualFileSystem::~VirtualFileSystem()
+{
+    if (s_virtual_file_system.get() == state_.get() &&
+        !s_virtual_file_system.retire(state_.get(), testfw::internal::kMockRetireTimeout))
+    {
+        ADD_FAILURE() << "Mock calls did not finish within " << testfw::internal::kMockRetireTimeout.count()
+                      << " ms while destroying VirtualFileSystem.";
+        // ファイル操作中のスレッドが参照している可能性があるため解放しない
+        (void)state_.release();
+    }
+}
+
+bool VirtualFileSystem::writeFile(const string &path, const string &contents, mode_t mode)
+{
+    ResolvedPath resolved;
+    if (!state_->resolve(path.c_str(), &resolved) || resolved.components.empty())
+    {
+        return false;
+    }
+    const size_t slash = path.rfind('/');
+    if (slash != string::npos && slash != 0U && !makeDirectories(path.substr(0, slash)))
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(state_->mtx);
+    shared_ptr<VirtualInode> parent;
+    shared_ptr<VirtualInode> inode;
+    if (state_->lookup(resolved, &parent, &inode, true) != 0 || (inode != nullptr && inode->directory))
+    {
+        return false;
+    }
+    inode = state_->makeInode(false, mode);
+    writeContents(*inode, 0U, contents.data(), contents.size());
+    parent->children[resolved.components.back()] = inode;
+    return true;
+}
+
+bool VirtualFileSystem::writeSyntheticFile(const string &path, uint64_t size, const SyntheticFileContent &content,
+                                           mode_t mode)
+{
+    ResolvedPath resolved;
+    if (!writeFile(path, string(), mode) || !state_->resolve(path.c_str(), &resolved))
+    {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(state_->mtx);
+    shared_ptr<VirtualInode> parent;
+    shared_ptr<VirtualInode> inode;
+    if (state_->lookup(resolved, &parent, &inode, true) != 0 || inode == nullptr)
+    {
+        return false;
+    }
+    inode = state_->ownChild(parent, resolved.components.back());
+    inode->synthetic = make_shared<SyntheticFileContent>(content);
+    inode->synthetic_size = size;
+    inode->size = size;
+    return true;
+}
+
+bool VirtualFileSystem::readFile(const string &path, string *contents) const
+{
+    ResolvedPath resolved;
+    if (!state_->resolve(path.c_str(), &resolved))
+    {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(state_->mtx);
+    shared_ptr<VirtualInode> parent;
+    shared_ptr<VirtualInode> inode;
+    if (state_->lookup(resolved, &parent, &inode) != 0 || inode == nullptr || inode->directory)
+    {
+        return false;
+    }
+    contents->resize((size_t)inode->size);
+    readContents(*inode, 0U, &(*contents)[0], contents->size());
+    return true;
+}
+
+bool VirtualFileSystem::exists(const string &path) const
+{
+    ResolvedPath resolved;
+    if (!state_->resolve(path.c_str(), &resolved))
+    {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(state_->mtx);
+    shared_ptr<VirtualInode> parent;
+    shared_ptr<VirtualInode> inode;
+    return state_->lookup(resolved, &parent, &inode) == 0 && inode != nullptr;
+}
+
+bool VirtualFileSystem::makeDirectories(const string &path, mode_t mode)
+{
+    ResolvedPath resolved;
+    if (!state_->resolve(path.c_str(), &resolved))
+    {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(state_->mtx);
+    state_->root = state_->own(state_->root);
+    shared_ptr<VirtualInode> current = state_->root;
+    for (const string &component : resolved.components)
+    {
+        shared_ptr<VirtualInode> &child = current->children[component];
+        if (!child)
+        {
+            child = state_->makeInode(true, mode);
+        }
+        else if (!child->directory)
+        {
+            return false;
+        }
+        child = state_->own(child);
+        current = child;
+    }
+    return true;
+}
+
+vector<string> VirtualFileSystem::listDirectory(const string &path) const
+{
+    vector<string> names;
+    ResolvedPath resolved;
+    if (!state_->resolve(path.c_str(), &resolved))
+    {
+        return names;
+    }
+    std::lock_guard<std::mutex> lock(state_->mtx);
+    shared_ptr<VirtualInode> parent;
+    shared_ptr<VirtualInode> inode;
+    if (state_->lookup(resolved, &parent, &inode) == 0 && inode != nullptr)
+    {
+        for (const auto &child : inode->children)
+        {
+            names.push_back(child.first);
+        }
+    }
+    return names;
+}
+
+void VirtualFileSystem::setWorkingDirectory(const string &path)
+{
+    ResolvedPath resolved;
+    if (state_->resolve(path.c_str(), &resolved))
+    {
+        std::lock_guard<std::mutex> lock(state_->mtx);
+        state_->cwd = resolved.components;
+    }
+}
+
+shared_ptr<const VirtualFileSystemSnapshot> VirtualFileSystem::snapshot() const
+{
+    std::lock_guard<std::mutex> lock(state_->mtx);
+    auto saved = make_shared<VirtualFileSystemSnapshot>();
+    saved->root = state_->root;
+    // 以降の変更では共有している inode を複製する
+    ++state_->generation;
+    return saved;
+}
+
+void VirtualFileSystem::restore(const shared_ptr<const VirtualFileSystemSnapshot> &snapshot)
+{
+    std::lock_guard<std::mutex> lock(state_->mtx);
+    state_->root = snapshot->root;
+    ++state_->generation;
+}
+
+size_t VirtualFileSystem::openFileCount() const
+{
+    std::lock_guard<std::mutex> lock(state_->mtx);
+    return state_->descriptors.size() + state_->streams.size();
+}
+
+VirtualMappingStats VirtualFileSystem::mappingStats() const
+{
+    std::lock_guard<std::mutex> lock(state_->mtx);
+    return state_->mapping_stats;
+}
+
+VirtualFileSystem *getVirtualFileSystem()
+{
+    VirtualFileSystemState *state = s_virtual_file_system.get();
+    return state == nullptr ? nullptr : state->owner;
+}
+
+void installVirtualFileSystemListener(const string &mount_point)
+{
+    UnitTest::GetInstance()->listeners().Append(new VirtualFileSystemListener(mount_point));
+}
+
+bool virtualOpen(const char *path, int flags, int mode, int *result)
+{
+    auto locked_vfs = s_virtual_file_system.lock();
+    ResolvedPath resolved;
+    if (!locked_vfs || !locked_vfs->resolve(path, &resolved))
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(locked_vfs->mtx);
+    VirtualOpenFile file;
+    const int error = locked_vfs->openFile(resolved, flags, (mode_t)mode, &file);
+    *result = error != 0 ? failWith(error, -1) : locked_vfs->allocateDescriptor(file);
+    return true;
+}
+
+bool virtualClose(int fd, int *result)
+{
+    auto locked_vfs = s_virtual_file_system.lock();
+    if (fd < VirtualFileSystem::FD_BASE || !locked_vfs)
+    {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(locked_vfs->mtx);
+    if (locked_vfs->descriptors.erase(fd) == 0U)
+    {
+        return false;
+    }
+    *result = 0;
+    return true;
+}
+
+bool virtualRead(int fd, void *buf, size_t count, ssize_t *result)
+{
+    auto locked_vfs = s_virtual_file_system.lock();
+    if (fd < VirtualFileSystem::FD_BASE || !locked_vfs)
+    {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(locked_vfs->mtx);
+    VirtualOpenFile *file = locked_vfs->findDescriptor(fd);
+    if (file == nullptr)
+    {
+        return false;
+    }
+    *result = locked_vfs->readFile(*file, buf, count);
+    return true;
+}
+
+bool virtualWrite(int fd, const void *buf, size_t count, ssize_t *result)
+{
+    auto locked_vfs = s_virtual_file_system.lock();
+    if (fd < VirtualFileSystem::FD_BASE || !locked_vfs)
+    {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(locked_vfs->mtx);
+    VirtualOpenFile *file = locked_vfs->findDescriptor(fd);
+    if (file == nullptr)
+    {
+        return false;
+    }
+    *result = locked_vfs->writeFile(*file, buf, count);
+    return true;
+}
+
+bool virtualLseek(int fd, off_t offset, int whence, off_t *result)
+{
+    auto locked_vfs = s_virtual_file_system.lock();
+    if (fd < VirtualFileSystem::FD_BASE || !locked_vfs)
+    {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(locked_vfs->mtx);
+    VirtualOpenFile *file = locked_vfs->findDescriptor(fd);
+    if (file == nullptr)
+    {
+        return false;
+    }
+    *result = locked_vfs->seekFile(*file, offset, whence);
+    return true;
+}
+
+bool virtualFstat(int fd, struct stat *buf, int *result)
+{
+    auto locked_vfs = s_virtual_file_system.lock();
+    if (fd < VirtualFileSystem::FD_BASE || !locked_vfs)
+    {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(locked_vfs->mtx);
+    VirtualOpenFile *file = locked_vfs->findDescriptor(fd);
+    if (file == nullptr)
+    {
+        return false;
+    }
+    fillStat(*file->inode, buf);
+    *result = 0;
+    return true;
+}
+
+bool virtualFsync(int fd, int *result)
+{
+    auto locked_vfs = s_virtual_file_system.lock();
+    if (fd < VirtualFileSystem::FD_BASE || !locked_vfs)
+    {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(locked_vfs->mtx);
+    if (locked_vfs->findDescriptor(fd) == nullptr)
+    {
+        return false;
+    }
+    *result = 0;
+    return true;
+}
+
+bool virtualFtruncate(int fd, off_t length, int *result)
+{
+    auto locked_vfs = s_virtual_file_system.lock();
+    if (fd < VirtualFileSystem::FD_BASE || !locked_vfs)
+    {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(locked_vfs->mtx);
+    VirtualOpenFile *file = locked_vfs->findDescriptor(fd);
+    if (file == nullptr)
+    {
+        return false;
+    }
+    if (length < 0 || !file->writable || file->inode->directory)
+    {
+        *result = failWith(EINVAL, -1);
+        return true;
+    }
+    truncateContents(locked_vfs->ownOpenInode(file->inode, file->path), (uint64_t)length);
+    *result = 0;
+    return true;
+}
+
+bool virtualStat(const char *path, struct stat *buf, int *result)
+{
+    auto locked_vfs = s_virtual_file_system.lock();
+    ResolvedPath resolved;
+    if (!locked_vfs || !locked_vfs->resolve(path, &resolved))
+    {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(locked_vfs->mtx);
+    shared_ptr<VirtualInode> parent;
+    shared_ptr<VirtualInode> inode;
+    const int error = locked_vfs->lookup(resolved, &parent, &inode);
+    if (error != 0 || inode == nullptr)
+    {
+        *result = failWith(error != 0 ? error : ENOENT, -1);
+        return true;
+    }
+    fillStat(*inode, buf);
+    *result = 0;
+    return true;
+}
+
+bool virtualAccess(const char *path, int amode, int *result)
+{
+    auto locked_vfs = s_virtual_file_system.lock();
+    ResolvedPath resolved;
+    if (!locked_vfs || !locked_vfs->resolve(path, &resolved))
+    {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(locked_vfs->mtx);
+    shared_ptr<VirtualInode> parent;
+    shared_ptr<VirtualInode> inode;
+    const int error = locked_vfs->lookup(resolved, &parent, &inode);
+    if (error != 0 || inode == nullptr)
+    {
+        *result = failWith(error != 0 ? error : ENOENT, -1);
+        return true;
+    }
+    const bool denied = ((amode & R_OK) != 0 && (inode->mode & S_IRUSR) == 0U) ||
+                        ((amode & W_OK) != 0 && (inode->mode & S_IWUSR) == 0U) ||
+                        ((amode & X_OK) != 0 && (inode->mode & S_IXUSR) == 0U);
+    *result = denied ? failWith(EACCES, -1) : 0;
+    return true;
+}
+
+bool virtualUnlink(const char *path, int *result)
+{
+    auto locked_vfs = s_virtual_file_system.lock();
+    ResolvedPath resolved;
+    if (!locked_vfs || !locked_vfs->resolve(path, &resolved))
+    {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(locked_vfs->mtx);
+    *result = locked_vfs->removeEntry(resolved, false);
+    return true;
+}
+
+bool virtualRename(const char *oldpath, const char *newpath, int *result)
+{
+    auto locked_vfs = s_virtual_file_system.lock();
+    if (!locked_vfs)
+    {
+        return false;
+    }
+    ResolvedPath from;
+    ResolvedPath to;
+    const bool from_virtual = locked_vfs->resolve(oldpath, &from);
+    const bool to_virtual = locked_vfs->resolve(newpath, &to);
+    if (!from_virtual && !to_virtual)
+    {
+        return false;
+    }
+    if (from_virtual != to_virtual)
+    {
+        *result = failWith(EXDEV, -1);
+        return true;
+    }
+    std::lock_guard<std::mutex> lock(locked_vfs->mtx);
+    *result = locked_vfs->renameEntry(from, to);
+    return true;
+}
+
+bool virtualMkdir(const char *path, mode_t mode, int *result)
+{
+    auto locked_vfs = s_virtual_file_system.lock();
+    ResolvedPath resolved;
+    if (!locked_vfs || !locked_vfs->resolve(path, &resolved))
+    {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(locked_vfs->mtx);
+    shared_ptr<VirtualInode> parent;
+    shared_ptr<VirtualInode> inode;
+    int error = locked_vfs->lookup(resolved, &parent, &inode, true);
+    if (error == 0 && (inode != nullptr || resolved.components.empty()))
+    {
+        error = EEXIST;
+    }
+    if (error == 0 && (parent->mode & S_IWUSR) == 0U)
+    {
+        error = EACCES;
+    }
+    if (error != 0)
+    {
+        *result = failWith(error, -1);
+        return true;
+    }
+    inode = locked_vfs->makeInode(true, mode);
+    parent->children[resolved.components.back()] = inode;
+    parent->mtime = parent->ctime = inode->mtime;
+    *result = 0;
+    return true;
+}
+
+bool virtualRmdir(const char *path, int *result)
+{
+    auto locked_vfs = s_virtual_file_system.lock();
+    ResolvedPath resolved;
+    if (!locked_vfs || !locked_vfs->resolve(path, &resolved))
+    {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(locked_vfs->mtx);
+    *result = locked_vfs->removeEntry(resolved, true);
+    return true;
+}
+
+bool virtualRemove(const char *path, int *result)
+{
+    auto locked_vfs = s_virtual_file_system.lock();
+    ResolvedPath resolved;
+    if (!locked_vfs || !locked_vfs->resolve(path, &resolved))
+    {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(locked_vfs->mtx);
+    shared_ptr<VirtualInode> parent;
+    shared_ptr<VirtualInode> inode;
+    const bool directory = locked_vfs->lookup(resolved, &parent, &inode) == 0 && inode != nullptr && inode->directory;
+    *result = locked_vfs->removeEntry(resolved, directory);
+    return true;
+}
+
+bool virtualFopen(const char *path, const char *modes, FILE **result)
+{
+    auto locked_vfs = s_virtual_file_system.lock();
+    ResolvedPath resolved;
+    if (!locked_vfs || !locked_vfs->resolve(path, &resolved))
+    {
+        return false;
+    }
+    const int flags = parseStreamModes(modes);
+    if (flags < 0)
+    {
+        *result = failWith(EINVAL, (FILE *)nullptr);
+        return true;
+    }
+
+    std::lock_guard<std::mutex> lock(locked_vfs->mtx);
+    unique_ptr<VirtualStream> stream(new VirtualStream());
+    const int error = locked_vfs->openFile(resolved, flags, 0666, &stream->file);
+    if (error != 0)
+    {
+        *result = failWith(error, (FILE *)nullptr);
+        return true;
+    }
+    // fopencookie はモード文字列の先頭 ("r" / "w" / "a" と "+") のみ参照する
+    FILE *handle = fopencookie(stream.get(), modes, kVirtualStreamFunctions);
+    if (handle == nullptr)
+    {
+        *result = nullptr;
+        return true;
+    }
+    // バッファーを持たせず、書き込みを直ちにファイル ツリーに反映する (ファイル記述子経由の読み書きと混在できる)
+    setvbuf(handle, nullptr, _IONBF, 0);
+    locked_vfs->streams.insert(stream.release());
+    *result = handle;
+    return true;
+}
+
+bool virtualMmap(void *addr, size_t length, int prot, int flags, int fd, off_t offset, void **result)
+{
+    auto locked_vfs = s_virtual_file_system.lock();
+    if (fd < VirtualFileSystem::FD_BASE || (flags & MAP_ANONYMOUS) != 0 || !locked_vfs)
+    {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(locked_vfs->mtx);
+    VirtualOpenFile *file = locked_vfs->findDescriptor(fd);
+    if (file == nullptr)
+    {
+        return false;
+    }
+
+    const bool shared = (flags & MAP_PRIVATE) == 0;
+    int error = 0;
+    if (length == 0U || offset < 0 || (size_t)offset % pageSize() != 0U || length > SIZE_MAX - pageSize())
+    {
+        error = EINVAL;
+    }
+    else if (file->inode->directory)
+    {
+        error = ENODEV;
+    }
+    else if (!file->readable || (shared && (prot & PROT_WRITE) != 0 && !file->writable))
+    {
+        error = EACCES;
+    }
+    const size_t mapped_length = (length + pageSize() - 1U) / pageSize() * pageSize();
+    const VirtualInode &inode = *file->inode;
+    const uint64_t begin = (uint64_t)offset;
+    const uint64_t end = std::min<uint64_t>(begin + mapped_length, inode.size);
+    const uint64_t synthetic_end = inode.synthetic ? std::min(end, inode.synthetic_size) : 0U;
+    if (error == 0 && synthetic_end > begin && synthetic_end - begin > VirtualFileSystem::MAX_SYNTHETIC_MAP_SIZE)
+    {
+        // 合成ファイルは範囲の内容をすべて生成してメモリーに置くため、上限を超える範囲はマップしない
+        error = ENOMEM;
+    }
+    if (error != 0)
+    {
+        *result = failWith(error, MAP_FAILED);
+        return true;
+    }
+
+    // ファイル上の位置に合わせて内容を設定する。穴と未設定の範囲はメモリーを消費しない
+    const int memfd = memfd_create("virtual-file-system", MFD_CLOEXEC);
+    if (memfd < 0)
+    {
+        *result = failWith(ENODEV, MAP_FAILED);
+        return true;
+    }
+    auto backing = make_shared<VirtualMappingBacking>(memfd);
+    if (ftruncate(memfd, (off_t)(begin + mapped_length)) != 0)
+    {
+        *result = MAP_FAILED;
+        return true;
+    }
+    if (begin < synthetic_end)
+    {
+        // 合成ファイルはマップする範囲の内容を生成する
+        vector<char> generated(EXTENT_SIZE * 64U);
+        for (uint64_t position = begin; position < synthetic_end;)
+        {
+            const size_t chunk = (size_t)std::min<uint64_t>(synthetic_end - position, generated.size());
+            inode.synthetic->generate(position, generated.data(), chunk);
+            if (pwrite(memfd, generated.data(), chunk, (off_t)position) != (ssize_t)chunk)
+            {
+                *result = MAP_FAILED;
+                return true;
+            }
+            position += chunk;
+        }
+    }
+    for (auto it = inode.extents.lower_bound(begin / EXTENT_SIZE);
+         it != inode.extents.end() && it->first * EXTENT_SIZE < end; ++it)
+    {
+        const uint64_t extent_begin = std::max<uint64_t>(it->first * EXTENT_SIZE, begin);
+        const uint64_t extent_end = std::min<uint64_t>(it->first * EXTENT_SIZE + it->second->size(), end);
+        if (extent_begin < extent_end &&
+            pwrite(memfd, it->second->data() + (extent_begin - it->first * EXTENT_SIZE),
+                   (size_t)(extent_end - extent_begin), (off_t)extent_begin) != (ssize_t)(extent_end - extent_begin))
+        {
+            *result = MAP_FAILED;
+            return true;
+        }
+    }
+
+    if ((flags & MAP_FIXED) != 0)
+    {
+        // 置き換えるマッピングの変更を書き戻す
+        (void)locked_vfs->unmapRange((uintptr_t)addr, (uintptr_t)addr + mapped_length);
+    }
+    void *mapped = mmap(addr, length, prot, flags, memfd, offset);
+    if (mapped != MAP_FAILED)
+    {
+        VirtualMapping &mapping = locked_vfs->mappings[(uintptr_t)mapped];
+        mapping.inode = file->inode;
+        mapping.path = file->path;
+        mapping.backing = backing;
+        mapping.offset = begin;
+        mapping.length = mapped_length;
+        mapping.write_back = shared && (prot & PROT_WRITE) != 0;
+        ++locked_vfs->mapping_stats.maps;
+        locked_vfs->mapping_stats.mapped_bytes += mapped_length;
+    }
+    *result = mapped;
+    return true;
+}
+
+bool virtualMunmap(void *addr, size_t length, int *result)
+{
+    auto locked_vfs = s_virtual_file_system.lock();
+    if (!locked_vfs)
+    {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(locked_vfs->mtx);
+    const uintptr_t begin = (uintptr_t)addr;
+    const uintptr_t end = begin + std::min<size_t>(length, UINTPTR_MAX - begin);
+    if (!locked_vfs->unmapRange(begin, end))
+    {
+        return false;
+    }
+    ++locked_vfs->mapping_stats.unmaps;
+    *result = munmap(addr, length);
+    return true;
+}
+
+bool virtualMsync(void *addr, size_t length, int flags, int *result)
+{
+    auto locked_vfs = s_virtual_file_system.lock();
+    if (!locked_vfs)
+    {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(locked_vfs->mtx);
+    const uintptr_t begin = (uintptr_t)addr;
+    const uintptr_t end = begin + std::min<size_t>(length, UINTPTR_MAX - begin);
+    const vector<uintptr_t> found = locked_vfs->findMappings(begin, end);
+    if (found.empty())
+    {
+        return false;
+    }
+
+    *result = msync(addr, length, flags);
+    if (*result == 0)
+    {
+        for (const uintptr_t start : found)
+        {
+            VirtualMapping &mapping = locked_vfs->mappings[start];
+            if (mapping.write_back)
+            {
+                locked_vfs->writeBack(mapping, std::max(start, begin) - start,
+                                      std::min<uintptr_t>(start + mapping.length, end) - start);
+            }
+        }
+        ++locked_vfs->mapping_stats.msyncs;
+    }
+    return true;
+}
+
+} // namespace testing
+
+#endif // _WIN32
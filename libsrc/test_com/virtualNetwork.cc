@@ -0,0 +1,1647 @@
+/* sys/socket の mock 関数の委譲先とするプロセス内のソケット。
+ * ソケットはファイル記述子の表で、bind したアドレスはプロトコルとポート (AF_UNIX はパス) ごとの表で管理する。
+ * 接続したストリームは方向ごとのリング バッファーを両端のソケットで共有し、データグラムは宛先のソケットの受信キューに複製する。
+ * 操作はすべて 1 個の mutex で直列化し、待機は 1 個の条件変数で状態の変化を待つ (VirtualClock がある場合は仮想時刻で待つ)。 */
+
+#ifndef _WIN32
+
+    #include <mock_instance.h>
+    #include <test_com.h>
+    #include <virtualClock.h>
+    #include <virtualNetwork.h>
+
+    #include <algorithm>
+    #include <cerrno>
+    #include <chrono>
+    #include <condition_variable>
+    #include <cstddef>
+    #include <cstring>
+    #include <deque>
+    #include <functional>
+    #include <map>
+    #include <mutex>
+    #include <string>
+    #include <unordered_map>
+    #include <vector>
+
+    #include <fcntl.h>
+    #include <netinet/in.h>
+    #include <sys/eventfd.h>
+    #include <sys/un.h>
+    #include <unistd.h>
+
+namespace testing
+{
+
+namespace
+{
+
+// 本物のファイル記述子を含む poll / select で、本物のファイル記述子を確認する間隔
+constexpr chrono::milliseconds REAL_FD_POLL_INTERVAL(1);
+
+// 一時ポートの範囲 (Linux の既定値)
+constexpr uint16_t EPHEMERAL_PORT_FIRST = 32768;
+constexpr uint16_t EPHEMERAL_PORT_LAST = 60999;
+
+// UDP のデータグラムの最大長
+constexpr size_t MAX_UDP_PAYLOAD = 65507;
+
+constexpr int64_t NANOSECONDS_PER_SECOND = 1000000000;
+
+// ソケットのアドレス。IPv4 アドレスは IPv4 射影 IPv6 アドレス (0.0.0.0 は ::) として保持する
+struct VirtualAddress
+{
+    bool isWildcard() const
+    {
+        return std::all_of(ip, ip + sizeof(ip), [](uint8_t b) { return b == 0U; });
+    }
+
+    bool isV4() const
+    {
+        return std::all_of(ip, ip + 10, [](uint8_t b) { return b == 0U; }) && ip[10] == 0xffU && ip[11] == 0xffU;
+    }
+
+    bool sameHost(const VirtualAddress &other) const
+    {
+        return memcmp(ip, other.ip, sizeof(ip)) == 0;
+    }
+
+    bool operator==(const VirtualAddress &other) const
+    {
+        return sameHost(other) && port == other.port && path == other.path;
+    }
+
+    sa_family_t family = AF_UNSPEC;
+    uint8_t ip[16] = {};
+    uint16_t port = 0; // ホスト バイト順
+    string path;       // AF_UNIX (先頭が '\0' の場合は抽象名前空間)
+};
+
+void setV4Address(const struct in_addr &in, VirtualAddress *address)
+{
+    memset(address->ip, 0, sizeof(address->ip));
+    if (in.s_addr != htonl(INADDR_ANY))
+    {
+        address->ip[10] = 0xffU;
+        address->ip[11] = 0xffU;
+        memcpy(address->ip + 12, &in, sizeof(in));
+    }
+}
+
+// addr を domain のソケットのアドレスとして解釈する。失敗した場合は errno の値を返す
+int parseAddress(int domain, const struct sockaddr *addr, socklen_t len, VirtualAddress *address)
+{
+    if (addr == nullptr)
+    {
+        return EFAULT;
+    }
+    if (len < (socklen_t)sizeof(sa_family_t))
+    {
+        return EINVAL;
+    }
+    if (addr->sa_family != domain)
+    {
+        return EAFNOSUPPORT;
+    }
+    address->family = addr->sa_family;
+    switch (domain)
+    {
+    case AF_INET: {
+        struct sockaddr_in in;
+        if (len < (socklen_t)sizeof(in))
+        {
+            return EINVAL;
+        }
+        memcpy(&in, addr, sizeof(in));
+        setV4Address(in.sin_addr, address);
+        address->port = ntohs(in.sin_port);
+        return 0;
+    }
+    case AF_INET6: {
+        struct sockaddr_in6 in6;
+        if (len < (socklen_t)sizeof(in6))
+        {
+            return EINVAL;
+        }
+        memcpy(&in6, addr, sizeof(in6));
+        memcpy(address->ip, &in6.sin6_addr, sizeof(address->ip));
+        if (address->isV4() && address->ip[12] == 0U && address->ip[13] == 0U && address->ip[14] == 0U &&
+            address->ip[15] == 0U)
+        {
+            memset(address->ip, 0, sizeof(address->ip));
+        }
+        address->port = ntohs(in6.sin6_port);
+        return 0;
+    }
+    default: {
+        const size_t path_offset = offsetof(struct sockaddr_un, sun_path);
+        if ((size_t)len <= path_offset || (size_t)len > sizeof(struct sockaddr_un))
+        {
+            return EINVAL;
+        }
+        const char *path = reinterpret_cast<const char *>(addr) + path_offset;
+        const size_t path_len = (size_t)len - path_offset;
+        address->path = path[0] == '\0' ? string(path, path_len) : string(path, strnlen(path, path_len));
+        return 0;
+    }
+    }
+}
+
+// address を domain のソケットのアドレスとして addr に設定する (*len より長い場合は切り詰め、*len に本来の長さを設定する)
+void storeAddress(int domain, const VirtualAddress &address, struct sockaddr *addr, socklen_t *len)
+{
+    if (addr == nullptr || len == nullptr)
+    {
+        return;
+    }
+    struct sockaddr_storage storage;
+    memset(&storage, 0, sizeof(storage));
+    size_t full_len;
+    switch (domain)
+    {
+    case AF_INET: {
+        struct sockaddr_in in;
+        memset(&in, 0, sizeof(in));
+        in.sin_family = AF_INET;
+        in.sin_port = htons(address.port);
+        memcpy(&in.sin_addr, address.ip + 12, sizeof(in.sin_addr));
+        memcpy(&storage, &in, sizeof(in));
+        full_len = sizeof(in);
+        break;
+    }
+    case AF_INET6: {
+        struct sockaddr_in6 in6;
+        memset(&in6, 0, sizeof(in6));
+        in6.sin6_family = AF_INET6;
+        in6.sin6_port = htons(address.port);
+        memcpy(&in6.sin6_addr, address.ip, sizeof(in6.sin6_addr));
+        memcpy(&storage, &in6, sizeof(in6));
+        full_len = sizeof(in6);
+        break;
+    }
+    default: {
+        struct sockaddr_un un;
+        memset(&un, 0, sizeof(un));
+        un.sun_family = AF_UNIX;
+        const size_t path_len = std::min(address.path.size(), sizeof(un.sun_path));
+        memcpy(un.sun_path, address.path.data(), path_len);
+        memcpy(&storage, &un, sizeof(un));
+        full_len = offsetof(struct sockaddr_un, sun_path) + path_len;
+        if (path_len != 0U && address.path[0] != '\0' && path_len < sizeof(un.sun_path))
+        {
+            full_len += 1U;
+        }
+        break;
+    }
+    }
+    memcpy(addr, &storage, std::min((size_t)*len, full_len));
+    *len = (socklen_t)full_len;
+}
+
+// ストリームの一方向のリング バッファー。送信側と受信側のソケットで共有する
+struct VirtualStreamBuffer
+{
+    explicit VirtualStreamBuffer(size_t capacity_value) : capacity(capacity_value)
+    {
+    }
+
+    size_t space() const
+    {
+        return capacity > size ? capacity - size : 0U;
+    }
+
+    // 容量を変更する (格納中のデータより小さくはしない)
+    void resize(size_t new_capacity)
+    {
+        new_capacity = std::max(new_capacity, size);
+        if (!ring.empty())
+        {
+            vector<char> resized(new_capacity);
+            (void)read(resized.data(), size, true);
+            ring.swap(resized);
+            head = 0;
+        }
+        capacity = new_capacity;
+    }
+
+    size_t write(const char *data, size_t length)
+    {
+        length = std::min(length, space());
+        if (length != 0U && ring.size() != capacity)
+        {
+            resize(capacity);
+            ring.resize(capacity);
+        }
+        size_t written = 0;
+        while (written < length)
+        {
+            const size_t tail = (head + size) % ring.size();
+            const size_t chunk = std::min(length - written, ring.size() - tail);
+            memcpy(&ring[tail], data + written, chunk);
+            size += chunk;
+            written += chunk;
+        }
+        return written;
+    }
+
+    size_t read(char *data, size_t length, bool peek)
+    {
+        length = std::min(length, size);
+        size_t done = 0;
+        size_t position = head;
+        while (done < length)
+        {
+            const size_t chunk = std::min(length - done, ring.size() - position);
+            memcpy(data + done, &ring[position], chunk);
+            done += chunk;
+            position = (position + chunk) % ring.size();
+        }
+        if (!peek)
+        {
+            size -= length;
+            head = size == 0U ? 0U : position;
+        }
+        return length;
+    }
+
+    vector<char> ring; // 最初の書き込みで容量まで確保する
+    size_t capacity;
+    size_t head = 0;
+    size_t size = 0;
+    bool write_closed = false; // 送信側が shutdown(SHUT_WR) / close した (データの後は EOF)
+    bool read_closed = false;  // 受信側が close した (送信は EPIPE)
+    bool reset = false;        // 接続がリセットされた (受信は ECONNRESET)
+};
+
+struct VirtualDatagram
+{
+    vector<char> data;
+    VirtualAddress from;
+};
+
+struct VirtualSocket
+{
+    int fd = -1; // accept されていない接続は -1
+    int domain = AF_UNSPEC;
+    int type = SOCK_STREAM;
+    bool nonblocking = false;
+    bool bound = false;         // アドレスの表に登録している
+    VirtualAddress local;
+    bool connected = false;
+    VirtualAddress peer;
+    bool listening = false;
+    size_t backlog = 0;
+    deque<shared_ptr<VirtualSocket>> pending; // accept されていない接続
+    shared_ptr<VirtualStreamBuffer> rx;       // 受信 (相手の tx)
+    shared_ptr<VirtualStreamBuffer> tx;       // 送信 (相手の rx)
+    deque<VirtualDatagram> datagrams;
+    size_t queued_bytes = 0;
+    bool shut_read = false;
+    bool shut_write = false;
+    int64_t recv_timeout = 0; // ナノ秒 (0 は無期限)
+    int64_t send_timeout = 0;
+    size_t rcvbuf = 0;
+    size_t sndbuf = 0;
+    int error = 0;
+    map<pair<int, int>, vector<char>> options; // setsockopt で設定した値
+};
+
+// bind したアドレスの表のキー (プロトコルとポート、AF_UNIX はパス)
+string bindingKey(int type, const VirtualAddress &address)
+{
+    string key(type == SOCK_STREAM ? "s" : "d");
+    if (address.family == AF_UNIX)
+    {
+        return key + "u" + address.path;
+    }
+    return key + "p" + to_string(address.port);
+}
+
+// IPv4 のソケットには IPv4 のアドレス (とワイルドカード) でのみ到達できる
+bool reachable(const VirtualSocket &sock, const VirtualAddress &address)
+{
+    return sock.domain != AF_INET || address.isV4() || address.isWildcard();
+}
+
+bool hasOption(const VirtualSocket &sock, int level, int optname)
+{
+    auto it = sock.options.find(make_pair(level, optname));
+    if (it == sock.options.end() || it->second.size() < sizeof(int))
+    {
+        return false;
+    }
+    int value;
+    memcpy(&value, it->second.data(), sizeof(value));
+    return value != 0;
+}
+
+// getsockopt の結果を設定する
+void storeOption(const void *value, size_t size, void *optval, socklen_t *optlen)
+{
+    memcpy(optval, value, std::min((size_t)*optlen, size));
+    *optlen = (socklen_t)size;
+}
+
+int64_t toNanoseconds(const struct timeval &value)
+{
+    return (int64_t)value.tv_sec * NANOSECONDS_PER_SECOND + (int64_t)value.tv_usec * 1000;
+}
+
+struct timeval toTimeval(int64_t nanoseconds)
+{
+    struct timeval value;
+    value.tv_sec = (time_t)(nanoseconds / NANOSECONDS_PER_SECOND);
+    value.tv_usec = (suseconds_t)((nanoseconds % NANOSECONDS_PER_SECOND) / 1000);
+    return value;
+}
+
+} // namespace
+
+struct VirtualNetworkState
+{
+    explicit VirtualNetworkState(VirtualNetwork *owner_value) : owner(owner_value)
+    {
+    }
+
+    ~VirtualNetworkState()
+    {
+        for (const auto &entry : sockets)
+        {
+            (void)close(entry.first);
+        }
+    }
+
+    shared_ptr<VirtualSocket> find(int fd) const
+    {
+        auto it = sockets.find(fd);
+        return it == sockets.end() ? nullptr : it->second;
+    }
+
+    /*
+     * ready が成立するまで待つ (mtx を取得して呼び出す)。timeout_ns が負の場合は無期限。
+     * 成立した場合は true、タイムアウトした場合と VirtualNetwork を破棄する場合は false を返す。
+     * poll_real は ready が本物のファイル記述子を確認する場合に指定し、REAL_FD_POLL_INTERVAL ごとに ready を評価する。
+     */
+    bool waitLocked(std::unique_lock<std::mutex> &lock, int64_t timeout_ns, bool poll_real,
+                    const function<bool()> &ready)
+    {
+        if (ready())
+        {
+            return true;
+        }
+        if (timeout_ns == 0 || closing)
+        {
+            return false;
+        }
+
+        // lock を保持して呼び出し、状態の変化を最大 wait だけ待つ (lock を解放していた間の変化は待たずに返す)
+        const auto wait_slice = [&](chrono::nanoseconds wait) {
+            if (closing || ready())
+            {
+                return true;
+            }
+            if (poll_real)
+            {
+                wait = std::min<chrono::nanoseconds>(wait, REAL_FD_POLL_INTERVAL);
+            }
+            (void)cv.wait_for(lock, wait);
+            return closing || ready();
+        };
+        lock.unlock();
+        bool handled;
+        if (timeout_ns < 0)
+        {
+            handled = virtualUntimedWait([&] {
+                lock.lock();
+                while (!wait_slice(chrono::hours(1)))
+                {
+                }
+                lock.unlock();
+            });
+        }
+        else
+        {
+            bool happened = false;
+            handled = virtualWaitFor(
+                chrono::nanoseconds(timeout_ns),
+                [&](chrono::nanoseconds wait) {
+                    lock.lock();
+                    const bool changed = wait_slice(wait);
+                    lock.unlock();
+                    return changed;
+                },
+                &happened);
+        }
+        lock.lock();
+
+        if (!handled)
+        {
+            // VirtualClock が無い (または管理対象外のスレッドの無期限の待機) 場合は実時間で待つ
+            if (timeout_ns < 0)
+            {
+                while (!wait_slice(chrono::hours(1)))
+                {
+                }
+            }
+            else
+            {
+                const auto deadline = chrono::steady_clock::now() + chrono::nanoseconds(timeout_ns);
+                while (!wait_slice(deadline - chrono::steady_clock::now()) && chrono::steady_clock::now() < deadline)
+                {
+                }
+            }
+        }
+        return !closing && ready();
+    }
+
+    // ソケットのファイル記述子を予約する
+    static int reserveDescriptor(bool cloexec)
+    {
+        return eventfd(0, cloexec ? EFD_CLOEXEC : 0);
+    }
+
+    // 一時ポートを割り当てる。空きが無い場合は 0 を返す
+    uint16_t allocatePort(int type)
+    {
+        VirtualAddress address;
+        address.family = AF_INET;
+        for (int n = 0; n <= EPHEMERAL_PORT_LAST - EPHEMERAL_PORT_FIRST; ++n)
+        {
+            address.port = next_port;
+            next_port = next_port == EPHEMERAL_PORT_LAST ? EPHEMERAL_PORT_FIRST : (uint16_t)(next_port + 1U);
+            if (bindings.find(bindingKey(type, address)) == bindings.end())
+            {
+                return address.port;
+            }
+        }
+        return 0;
+    }
+
+    // アドレスの表に登録する。失敗した場合は errno の値を返す
+    int bindLocked(VirtualSocket &sock, VirtualAddress address)
+    {
+        if (address.family == AF_UNIX)
+        {
+            if (address.path.empty())
+            {
+                // Linux と同様に抽象名前空間の名前を割り当てる
+                char name[8];
+                snprintf(name, sizeof(name), "%05x", next_autobind++ & 0xfffffU);
+                address.path = string(1, '\0') + name;
+            }
+        }
+        else if (address.port == 0U)
+        {
+            address.port = allocatePort(sock.type);
+            if (address.port == 0U)
+            {
+                return EADDRINUSE;
+            }
+        }
+
+        vector<VirtualSocket *> &bound = bindings[bindingKey(sock.type, address)];
+        for (const VirtualSocket *other : bound)
+        {
+            const bool overlap = address.family == AF_UNIX || other->local.sameHost(address) ||
+                                 other->local.isWildcard() || address.isWildcard();
+            if (overlap && !(hasOption(sock, SOL_SOCKET, SO_REUSEPORT) && hasOption(*other, SOL_SOCKET, SO_REUSEPORT)))
+            {
+                return EADDRINUSE;
+            }
+        }
+        bound.push_back(&sock);
+        sock.bound = true;
+        sock.local = address;
+        return 0;
+    }
+
+    // 未登録の場合、toward 宛ての送信元のアドレスを割り当てる (AF_UNIX は名前の無いソケットのまま)
+    int autobindLocked(VirtualSocket &sock, const VirtualAddress &toward)
+    {
+        if (sock.bound)
+        {
+            return 0;
+        }
+        VirtualAddress local;
+        local.family = (sa_family_t)sock.domain;
+        if (sock.domain == AF_UNIX)
+        {
+            sock.local = local;
+            return 0;
+        }
+        if (!toward.isWildcard())
+        {
+            memcpy(local.ip, toward.ip, sizeof(local.ip));
+        }
+        else if (sock.domain == AF_INET)
+        {
+            struct in_addr loopback;
+            loopback.s_addr = htonl(INADDR_LOOPBACK);
+            setV4Address(loopback, &local);
+        }
+        else
+        {
+            local.ip[15] = 1U;
+        }
+        return bindLocked(sock, local);
+    }
+
+    void unbindLocked(VirtualSocket &sock)
+    {
+        const string key = bindingKey(sock.type, sock.local);
+        auto it = bindings.find(key);
+        if (it != bindings.end())
+        {
+            it->second.erase(std::remove(it->second.begin(), it->second.end(), &sock), it->second.end());
+            if (it->second.empty())
+            {
+                bindings.erase(it);
+            }
+        }
+        sock.bound = false;
+    }
+
+    // address に bind しているソケット (ストリームは listen 中か否かを問わない)
+    VirtualSocket *lookupBinding(int type, const VirtualAddress &address) const
+    {
+        auto it = bindings.find(bindingKey(type, address));
+        if (it == bindings.end())
+        {
+            return nullptr;
+        }
+        VirtualSocket *wildcard = nullptr;
+        for (VirtualSocket *sock : it->second)
+        {
+            if (!reachable(*sock, address))
+            {
+                continue;
+            }
+            if (address.family == AF_UNIX || sock->local.sameHost(address))
+            {
+                return sock;
+            }
+            // 宛先がワイルドカードの場合は、ループバック宛てとみなして同じポートのソケットに届ける
+            if (sock->local.isWildcard() || address.isWildcard())
+            {
+                wildcard = sock;
+            }
+        }
+        return wildcard;
+    }
+
+    // ソケットを閉じ、接続の相手に通知する
+    void closeSocketLocked(VirtualSocket &sock)
+    {
+        if (sock.bound)
+        {
+            unbindLocked(sock);
+        }
+        if (sock.listening)
+        {
+            sock.listening = false;
+            // accept されていない接続はリセットする
+            for (const shared_ptr<VirtualSocket> &connection : sock.pending)
+            {
+                connection->tx->reset = true;
+                closeSocketLocked(*connection);
+            }
+            sock.pending.clear();
+        }
+        if (sock.tx)
+        {
+            sock.tx->write_closed = true;
+        }
+        if (sock.rx)
+        {
+            // 未読のデータを残して閉じた場合は、Linux と同様に接続をリセットする
+            if (sock.rx->size != 0U && sock.tx)
+            {
+                sock.tx->reset = true;
+            }
+            sock.rx->read_closed = true;
+        }
+        sock.shut_read = true;
+        sock.shut_write = true;
+        cv.notify_all();
+    }
+
+    // poll の revents
+    short eventsLocked(const VirtualSocket &sock) const
+    {
+        if (sock.listening)
+        {
+            return sock.pending.empty() ? 0 : (short)(POLLIN | POLLRDNORM);
+        }
+        short events = 0;
+        if (sock.type == SOCK_DGRAM)
+        {
+            if (!sock.datagrams.empty() || sock.shut_read)
+            {
+                events |= POLLIN | POLLRDNORM;
+            }
+            if (!sock.shut_write)
+            {
+                events |= POLLOUT | POLLWRNORM;
+            }
+            return events;
+        }
+        if (!sock.connected)
+        {
+            return (short)(POLLOUT | POLLHUP);
+        }
+        if (sock.rx->size != 0U || sock.rx->write_closed || sock.shut_read)
+        {
+            events |= POLLIN | POLLRDNORM;
+        }
+        if (sock.rx->write_closed)
+        {
+            events |= POLLRDHUP;
+        }
+        if (sock.rx->reset)
+        {
+            events |= POLLERR;
+        }
+        if (sock.tx->read_closed || (!sock.shut_write && sock.tx->space() != 0U))
+        {
+            events |= POLLOUT | POLLWRNORM;
+        }
+        if (sock.rx->write_closed && (sock.shut_write || sock.tx->read_closed))
+        {
+            events |= POLLHUP;
+        }
+        return events;
+    }
+
+    // fds の revents を設定し、revents が 0 でない数を返す
+    int evaluatePollLocked(struct pollfd *fds, nfds_t nfds, bool *has_real) const
+    {
+        vector<struct pollfd> real;
+        vector<nfds_t> real_index;
+        for (nfds_t i = 0; i < nfds; ++i)
+        {
+            fds[i].revents = 0;
+            if (fds[i].fd < 0)
+            {
+                continue;
+            }
+            const shared_ptr<VirtualSocket> sock = find(fds[i].fd);
+            if (sock)
+            {
+                fds[i].revents = (short)(eventsLocked(*sock) & (fds[i].events | POLLERR | POLLHUP));
+            }
+            else
+            {
+                real.push_back(fds[i]);
+                real_index.push_back(i);
+            }
+        }
+        *has_real = !real.empty();
+        if (!real.empty())
+        {
+            (void)poll(real.data(), (nfds_t)real.size(), 0);
+            for (size_t i = 0; i < real.size(); ++i)
+            {
+                fds[real_index[i]].revents = real[i].revents;
+            }
+        }
+        return (int)std::count_if(fds, fds + nfds, [](const struct pollfd &fd) { return fd.revents != 0; });
+    }
+
+    // 対象のソケットを含む場合に poll を処理する
+    bool pollLocked(std::unique_lock<std::mutex> &lock, struct pollfd *fds, nfds_t nfds, int64_t timeout_ns,
+                    int *result)
+    {
+        if (std::none_of(fds, fds + nfds, [&](const struct pollfd &fd) { return sockets.count(fd.fd) != 0U; }))
+        {
+            return false;
+        }
+        bool has_real = false;
+        int ready = evaluatePollLocked(fds, nfds, &has_real);
+        (void)waitLocked(lock, timeout_ns, has_real, [&] {
+            ready = evaluatePollLocked(fds, nfds, &has_real);
+            return ready != 0;
+        });
+        *result = ready;
+        return true;
+    }
+
+    // ストリームの送信。送信したバイト数を返す (失敗した場合は *error を設定して -1 を返す)
+    ssize_t sendStreamLocked(std::unique_lock<std::mutex> &lock, const shared_ptr<VirtualSocket> &sock,
+                             const char *data, size_t len, int flags, int *error)
+    {
+        if (!sock->connected)
+        {
+            *error = ENOTCONN;
+            return -1;
+        }
+        const bool dontwait = sock->nonblocking || (flags & MSG_DONTWAIT) != 0;
+        size_t sent = 0;
+        while (true)
+        {
+            if (sock->shut_write || sock->tx->read_closed)
+            {
+                if (sent != 0U)
+                {
+                    break;
+                }
+                *error = sock->rx->reset ? ECONNRESET : EPIPE;
+                return -1;
+            }
+            const size_t written = sock->tx->write(data + sent, len - sent);
+            if (written != 0U)
+            {
+                sent += written;
+                cv.notify_all();
+            }
+            if (sent == len)
+            {
+                break;
+            }
+            const bool ready = waitLocked(lock, dontwait ? 0 : (sock->send_timeout != 0 ? sock->send_timeout : -1),
+                                          false, [&] {
+                                              return sock->tx->space() != 0U || sock->tx->read_closed ||
+                                                     sock->shut_write;
+                                          });
+            if (!ready)
+            {
+                if (sent != 0U)
+                {
+                    break;
+                }
+                *error = EAGAIN;
+                return -1;
+            }
+        }
+        statistics.stream_bytes += sent;
+        return (ssize_t)sent;
+    }
+
+    // ストリームの受信
+    ssize_t recvStreamLocked(std::unique_lock<std::mutex> &lock, const shared_ptr<VirtualSocket> &sock, char *data,
+                             size_t len, int flags, int *error)
+    {
+        if (!sock->connected)
+        {
+            *error = ENOTCONN;
+            return -1;
+        }
+        if (len == 0U)
+        {
+            return 0;
+        }
+        const bool dontwait = sock->nonblocking || (flags & MSG_DONTWAIT) != 0;
+        const bool peek = (flags & MSG_PEEK) != 0;
+        const bool waitall = (flags & MSG_WAITALL) != 0 && !peek;
+        size_t received = 0;
+        while (true)
+        {
+            if (sock->rx->reset)
+            {
+                if (received != 0U)
+                {
+                    break;
+                }
+                *error = ECONNRESET;
+                return -1;
+            }
+            received += sock->rx->read(data + received, len - received, peek);
+            if ((received != 0U && (!waitall || received == len)) || sock->rx->write_closed || sock->shut_read)
+            {
+                break;
+            }
+            const bool ready = waitLocked(lock, dontwait ? 0 : (sock->recv_timeout != 0 ? sock->recv_timeout : -1),
+                                          false, [&] {
+                                              return sock->rx->size != 0U || sock->rx->write_closed ||
+                                                     sock->rx->reset || sock->shut_read;
+                                          });
+            if (!ready)
+            {
+                if (received != 0U)
+                {
+                    break;
+                }
+                *error = EAGAIN;
+                return -1;
+            }
+        }
+        if (received != 0U && !peek)
+        {
+            cv.notify_all();
+        }
+        return (ssize_t)received;
+    }
+
+    // データグラムの送信
+    ssize_t sendDatagramLocked(std::unique_lock<std::mutex> &lock, const shared_ptr<VirtualSocket> &sock,
+                               const char *data, size_t len, int flags, const struct sockaddr *dest_addr,
+                               socklen_t addrlen, int *error)
+    {
+        VirtualAddress dest;
+        if (dest_addr != nullptr)
+        {
+            *error = parseAddress(sock->domain, dest_addr, addrlen, &dest);
+            if (*error != 0)
+            {
+                return -1;
+            }
+        }
+        else if (sock->connected)
+        {
+            dest = sock->peer;
+        }
+        else
+        {
+            *error = sock->domain == AF_UNIX ? ENOTCONN : EDESTADDRREQ;
+            return -1;
+        }
+        if (sock->shut_write)
+        {
+            *error = EPIPE;
+            return -1;
+        }
+        if (sock->domain != AF_UNIX && len > MAX_UDP_PAYLOAD)
+        {
+            *error = EMSGSIZE;
+            return -1;
+        }
+        *error = autobindLocked(*sock, dest);
+        if (*error != 0)
+        {
+            return -1;
+        }
+
+        const bool dontwait = sock->nonblocking || (flags & MSG_DONTWAIT) != 0;
+        while (true)
+        {
+            VirtualSocket *target = lookupBinding(SOCK_DGRAM, dest);
+            if (target == nullptr || (target->connected && !(target->peer == sock->local)))
+            {
+                // UDP は宛先が無くても送信に成功する
+                if (sock->domain != AF_UNIX)
+                {
+                    ++statistics.dropped_datagrams;
+                    return (ssize_t)len;
+                }
+                ++statistics.refused;
+                *error = target == nullptr ? ECONNREFUSED : EPERM;
+                return -1;
+            }
+            if (target->shut_read || target->queued_bytes + len <= target->rcvbuf || target->datagrams.empty())
+            {
+                if (!target->shut_read)
+                {
+                    target->datagrams.push_back(VirtualDatagram{vector<char>(data, data + len), sock->local});
+                    target->queued_bytes += len;
+                    cv.notify_all();
+                }
+                ++statistics.datagrams;
+                return (ssize_t)len;
+            }
+            if (sock->domain != AF_UNIX)
+            {
+                // UDP は受信バッファーが一杯の場合に破棄する
+                ++statistics.dropped_datagrams;
+                return (ssize_t)len;
+            }
+            const bool ready = waitLocked(lock, dontwait ? 0 : (sock->send_timeout != 0 ? sock->send_timeout : -1),
+                                          false, [&] {
+                                              VirtualSocket *current = lookupBinding(SOCK_DGRAM, dest);
+                                              return current == nullptr ||
+                                                     current->queued_bytes + len <= current->rcvbuf;
+                                          });
+            if (!ready)
+            {
+                *error = EAGAIN;
+                return -1;
+            }
+        }
+    }
+
+    // データグラムの受信
+    ssize_t recvDatagramLocked(std::unique_lock<std::mutex> &lock, const shared_ptr<VirtualSocket> &sock, char *data,
+                               size_t len, int flags, struct sockaddr *src_addr, socklen_t *addrlen, int *error)
+    {
+        const bool dontwait = sock->nonblocking || (flags & MSG_DONTWAIT) != 0;
+        const bool ready = waitLocked(lock, dontwait ? 0 : (sock->recv_timeout != 0 ? sock->recv_timeout : -1), false,
+                                      [&] { return !sock->datagrams.empty() || sock->shut_read; });
+        if (!ready)
+        {
+            *error = EAGAIN;
+            return -1;
+        }
+        if (sock->datagrams.empty())
+        {
+            return 0;
+        }
+        const VirtualDatagram &datagram = sock->datagrams.front();
+        const size_t full_len = datagram.data.size();
+        const size_t copied = std::min(len, full_len);
+        memcpy(data, datagram.data.data(), copied);
+        storeAddress(sock->domain, datagram.from, src_addr, addrlen);
+        if ((flags & MSG_PEEK) == 0)
+        {
+            sock->queued_bytes -= full_len;
+            sock->datagrams.pop_front();
+            cv.notify_all();
+        }
+        return (ssize_t)((flags & MSG_TRUNC) != 0 ? full_len : copied);
+    }
+
+    VirtualNetwork *owner;
+    mutable std::mutex mtx;
+    std::condition_variable cv;
+    unordered_map<int, shared_ptr<VirtualSocket>> sockets; // ファイル記述子の表
+    map<string, vector<VirtualSocket *>> bindings;         // bind したアドレスの表
+    uint16_t next_port = EPHEMERAL_PORT_FIRST;
+    uint32_t next_autobind = 0;
+    size_t buffer_size = VirtualNetwork::DEFAULT_BUFFER_SIZE;
+    VirtualNetworkStats statistics;
+    bool closing = false;
+};
+
+namespace
+{
+
+testfw::MockSlot<VirtualNetworkState> s_virtual_network;
+
+/*
+ * fd が VirtualNetwork のソケットの場合に operation(state, lock, sock, result) を mutex を取得して呼び出し、true を返す。
+ * operation は成功した場合に *result を設定して 0 を、失敗した場合に errno の値を返す。
+ */
+template <typename Result, typename Operation> bool withSocket(int fd, Result *result, Operation operation)
+{
+    auto locked_network = s_virtual_network.lock();
+    if (!locked_network)
+    {
+        return false;
+    }
+    std::unique_lock<std::mutex> lock(locked_network->mtx);
+    const shared_ptr<VirtualSocket> sock = locked_network->find(fd);
+    if (!sock)
+    {
+        return false;
+    }
+    const int error = operation(*locked_network, lock, sock, result);
+    if (error != 0)
+    {
+        errno = error;
+        *result = -1;
+    }
+    return true;
+}
+
+// 送受信の結果を withSocket の operation の戻り値に変換する
+template <typename Result> int finishTransfer(ssize_t transferred, int error, Result *result)
+{
+    if (transferred < 0)
+    {
+        return error;
+    }
+    *result = transferred;
+    return 0;
+}
+
+} // namespace
+
+constexpr size_t VirtualNetwork::DEFAULT_BUFFER_SIZE;
+
+VirtualNetwork::VirtualNetwork() : state_(new VirtualNetworkState(this))
+{
+    if (s_virtual_network.get() != nullptr)
+    {
+        ADD_FAILURE() << "Only one VirtualNetwork may exist at a time.";
+        return;
+    }
+    s_virtual_network.publish(state_.get());
+}
+
+VirtualNetwork::~VirtualNetwork()
+{
+    {
+        // 待機中のスレッドを終了させる
+        std::lock_guard<std::mutex> lock(state_->mtx);
+        state_->closing = true;
+        state_->cv.notify_all();
+    }
+    if (s_virtual_network.get() == state_.get() &&
+        !s_virtual_network.retire(state_.get(), testfw::internal::kMockRetireTimeout))
+    {
+        ADD_FAILURE() << "Mock calls did not finish within " << testfw::internal::kMockRetireTimeout.count()
+                      << " ms while destroying VirtualNetwork.";
+        // 通信中のスレッドが参照している可能性があるため解放しない
+        (void)state_.release();
+    }
+}
+
+void VirtualNetwork::setBufferSize(size_t bytes)
+{
+    std::lock_guard<std::mutex> lock(state_->mtx);
+    state_->buffer_size = bytes;
+}
+
+size_t VirtualNetwork::openSocketCount() const
+{
+    std::lock_guard<std::mutex> lock(state_->mtx);
+    return state_->sockets.size();
+}
+
+VirtualNetworkStats VirtualNetwork::stats() const
+{
+    std::lock_guard<std::mutex> lock(state_->mtx);
+    return state_->statistics;
+}
+
+VirtualNetwork *getVirtualNetwork()
+{
+    VirtualNetworkState *state = s_virtual_network.get();
+    return state == nullptr ? nullptr : state->owner;
+}
+
+bool virtualNetworkSocket(int domain, int type, int protocol, int *result)
+{
+    auto locked_network = s_virtual_network.lock();
+    const int base_type = type & ~(SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (!locked_network || (domain != AF_INET && domain != AF_INET6 && domain != AF_UNIX) ||
+        (base_type != SOCK_STREAM && base_type != SOCK_DGRAM))
+    {
+        return false;
+    }
+    const int default_protocol = domain == AF_UNIX ? 0 : (base_type == SOCK_STREAM ? IPPROTO_TCP : IPPROTO_UDP);
+    if (protocol != 0 && protocol != default_protocol)
+    {
+        errno = EPROTONOSUPPORT;
+        *result = -1;
+        return true;
+    }
+
+    std::lock_guard<std::mutex> lock(locked_network->mtx);
+    const int fd = VirtualNetworkState::reserveDescriptor((type & SOCK_CLOEXEC) != 0);
+    if (fd < 0)
+    {
+        *result = -1;
+        return true;
+    }
+    auto sock = make_shared<VirtualSocket>();
+    sock->fd = fd;
+    sock->domain = domain;
+    sock->type = base_type;
+    sock->nonblocking = (type & SOCK_NONBLOCK) != 0;
+    sock->local.family = (sa_family_t)domain;
+    sock->rcvbuf = locked_network->buffer_size;
+    sock->sndbuf = locked_network->buffer_size;
+    locked_network->sockets[fd] = sock;
+    *result = fd;
+    return true;
+}
+
+bool virtualNetworkBind(int sockfd, const struct sockaddr *addr, socklen_t addrlen, int *result)
+{
+    return withSocket(sockfd, result,
+                      [&](VirtualNetworkState &state, std::unique_lock<std::mutex> &, const shared_ptr<VirtualSocket> &sock,
+                          int *ret) {
+                          VirtualAddress address;
+                          int error = parseAddress(sock->domain, addr, addrlen, &address);
+                          if (error == 0)
+                          {
+                              error = sock->bound ? EINVAL : state.bindLocked(*sock, address);
+                          }
+                          *ret = 0;
+                          return error;
+                      });
+}
+
+bool virtualNetworkListen(int sockfd, int backlog, int *result)
+{
+    return withSocket(sockfd, result,
+                      [&](VirtualNetworkState &state, std::unique_lock<std::mutex> &, const shared_ptr<VirtualSocket> &sock,
+                          int *ret) {
+                          if (sock->type != SOCK_STREAM)
+                          {
+                              return EOPNOTSUPP;
+                          }
+                          if (sock->connected)
+                          {
+                              return EINVAL;
+                          }
+                          if (!sock->bound)
+                          {
+                              VirtualAddress any;
+                              any.family = (sa_family_t)sock->domain;
+                              const int error = state.bindLocked(*sock, any);
+                              if (error != 0)
+                              {
+                                  return error;
+                              }
+                          }
+                          // Linux と同様に backlog + 1 個まで接続を保留する
+                          sock->backlog = (size_t)std::min(std::max(backlog, 0), SOMAXCONN);
+                          sock->listening = true;
+                          state.cv.notify_all();
+                          *ret = 0;
+                          return 0;
+                      });
+}
+
+bool virtualNetworkAccept(int sockfd, struct sockaddr *addr, socklen_t *addrlen, int *result)
+{
+    return withSocket(sockfd, result,
+                      [&](VirtualNetworkState &state, std::unique_lock<std::mutex> &lock,
+                          const shared_ptr<VirtualSocket> &sock, int *ret) {
+                          if (!sock->listening)
+                          {
+                              return EINVAL;
+                          }
+                          const int64_t timeout =
+                              sock->nonblocking ? 0 : (sock->recv_timeout != 0 ? sock->recv_timeout : -1);
+                          if (!state.waitLocked(lock, timeout, false,
+                                                [&] { return !sock->pending.empty() || !sock->listening; }))
+                          {
+                              return state.closing ? EBADF : EAGAIN;
+                          }
+                          if (!sock->listening)
+                          {
+                              return EINVAL;
+                          }
+                          const int fd = VirtualNetworkState::reserveDescriptor(false);
+                          if (fd < 0)
+                          {
+                              return errno;
+                          }
+                          shared_ptr<VirtualSocket> connection = sock->pending.front();
+                          sock->pending.pop_front();
+                          connection->fd = fd;
+                          state.sockets[fd] = connection;
+                          storeAddress(connection->domain, connection->peer, addr, addrlen);
+                          state.cv.notify_all();
+                          *ret = fd;
+                          return 0;
+                      });
+}
+
+bool virtualNetworkConnect(int sockfd, const struct sockaddr *addr, socklen_t addrlen, int *result)
+{
+    return withSocket(sockfd, result, [&](VirtualNetworkState &state, std::unique_lock<std::mutex> &lock,
+                                          const shared_ptr<VirtualSocket> &sock, int *ret) {
+        *ret = 0;
+        if (sock->type == SOCK_DGRAM && addr != nullptr && addrlen >= (socklen_t)sizeof(sa_family_t) &&
+            addr->sa_family == AF_UNSPEC)
+        {
+            // AF_UNSPEC は接続の解除
+            sock->connected = false;
+            return 0;
+        }
+        VirtualAddress address;
+        const int parse_error = parseAddress(sock->domain, addr, addrlen, &address);
+        if (parse_error != 0)
+        {
+            return parse_error;
+        }
+        if (sock->type == SOCK_DGRAM)
+        {
+            const int error = state.autobindLocked(*sock, address);
+            if (error == 0)
+            {
+                sock->connected = true;
+                sock->peer = address;
+            }
+            return error;
+        }
+
+        if (sock->listening)
+        {
+            return EINVAL;
+        }
+        if (sock->connected)
+        {
+            return EISCONN;
+        }
+        VirtualSocket *listener = nullptr;
+        const int64_t timeout = sock->nonblocking ? 0 : (sock->send_timeout != 0 ? sock->send_timeout : -1);
+        const bool ready = state.waitLocked(lock, timeout, false, [&] {
+            listener = state.lookupBinding(SOCK_STREAM, address);
+            return listener == nullptr || !listener->listening || listener->pending.size() <= listener->backlog;
+        });
+        if (state.closing)
+        {
+            return EBADF;
+        }
+        if (sock->connected)
+        {
+            return EISCONN;
+        }
+        if (listener == nullptr || !listener->listening)
+        {
+            ++state.statistics.refused;
+            return address.family == AF_UNIX && listener == nullptr ? ENOENT : ECONNREFUSED;
+        }
+        if (!ready)
+        {
+            return sock->nonblocking ? EAGAIN : ETIMEDOUT;
+        }
+        const int error = state.autobindLocked(*sock, address);
+        if (error != 0)
+        {
+            return error;
+        }
+
+        // サーバー側のソケットは accept までファイル記述子を割り当てない
+        auto server = make_shared<VirtualSocket>();
+        server->domain = listener->domain;
+        server->type = SOCK_STREAM;
+        server->local = listener->local;
+        if (address.family != AF_UNIX && server->local.isWildcard())
+        {
+            memcpy(server->local.ip, address.ip, sizeof(server->local.ip));
+        }
+        server->connected = true;
+        server->peer = sock->local;
+        server->rcvbuf = listener->rcvbuf;
+        server->sndbuf = listener->sndbuf;
+        server->rx = make_shared<VirtualStreamBuffer>(server->rcvbuf);
+        server->tx = make_shared<VirtualStreamBuffer>(sock->rcvbuf);
+        sock->rx = server->tx;
+        sock->tx = server->rx;
+        sock->connected = true;
+        sock->peer = address;
+        listener->pending.push_back(server);
+        ++state.statistics.connections;
+        state.cv.notify_all();
+        return 0;
+    });
+}
+
+bool virtualNetworkShutdown(int sockfd, int how, int *result)
+{
+    return withSocket(sockfd, result,
+                      [&](VirtualNetworkState &state, std::unique_lock<std::mutex> &, const shared_ptr<VirtualSocket> &sock,
+                          int *ret) {
+                          if (how != SHUT_RD && how != SHUT_WR && how != SHUT_RDWR)
+                          {
+                              return EINVAL;
+                          }
+                          if (!sock->connected)
+                          {
+                              return ENOTCONN;
+                          }
+                          if (how != SHUT_WR)
+                          {
+                              sock->shut_read = true;
+                          }
+                          if (how != SHUT_RD)
+                          {
+                              sock->shut_write = true;
+                              if (sock->tx)
+                              {
+                                  sock->tx->write_closed = true;
+                              }
+                          }
+                          state.cv.notify_all();
+                          *ret = 0;
+                          return 0;
+                      });
+}
+
+bool virtualNetworkSetsockopt(int sockfd, int level, int optname, const void *optval, socklen_t optlen, int *result)
+{
+    return withSocket(sockfd, result,
+                      [&](VirtualNetworkState &state, std::unique_lock<std::mutex> &, const shared_ptr<VirtualSocket> &sock,
+                          int *ret) {
+                          if (optval == nullptr && optlen != 0U)
+                          {
+                              return EFAULT;
+                          }
+                          if (level == SOL_SOCKET && (optname == SO_RCVTIMEO || optname == SO_SNDTIMEO))
+                          {
+                              struct timeval value;
+                              if (optlen < (socklen_t)sizeof(value))
+                              {
+                                  return EINVAL;
+                              }
+                              memcpy(&value, optval, sizeof(value));
+                              if (value.tv_usec < 0 || value.tv_usec >= 1000000)
+                              {
+                                  return EDOM;
+                              }
+                              (optname == SO_RCVTIMEO ? sock->recv_timeout : sock->send_timeout) =
+                                  std::max<int64_t>(toNanoseconds(value), 0);
+                          }
+                          else if (level == SOL_SOCKET && (optname == SO_RCVBUF || optname == SO_SNDBUF))
+                          {
+                              int value;
+                              if (optlen < (socklen_t)sizeof(value))
+                              {
+                                  return EINVAL;
+                              }
+                              memcpy(&value, optval, sizeof(value));
+                              // Linux と同様に管理領域の分として 2 倍にする
+                              const size_t size = (size_t)std::max(value, 1024) * 2U;
+                              if (optname == SO_RCVBUF)
+                              {
+                                  sock->rcvbuf = size;
+                                  if (sock->rx)
+                                  {
+                                      sock->rx->resize(size);
+                                      state.cv.notify_all();
+                                  }
+                              }
+                              else
+                              {
+                                  sock->sndbuf = size;
+                              }
+                          }
+                          else
+                          {
+                              const char *bytes = static_cast<const char *>(optval);
+                              sock->options[make_pair(level, optname)] = vector<char>(bytes, bytes + optlen);
+                          }
+                          *ret = 0;
+                          return 0;
+                      });
+}
+
+bool virtualNetworkGetsockopt(int sockfd, int level, int optname, void *optval, socklen_t *optlen, int *result)
+{
+    return withSocket(sockfd, result,
+                      [&](VirtualNetworkState &, std::unique_lock<std::mutex> &, const shared_ptr<VirtualSocket> &sock,
+                          int *ret) {
+                          if (optval == nullptr || optlen == nullptr)
+                          {
+                              return EFAULT;
+                          }
+                          int value = 0;
+                          if (level == SOL_SOCKET)
+                          {
+                              switch (optname)
+                              {
+                              case SO_ERROR:
+                                  value = sock->error;
+                                  sock->error = 0;
+                                  break;
+                              case SO_TYPE:
+                                  value = sock->type;
+                                  break;
+                              case SO_DOMAIN:
+                                  value = sock->domain;
+                                  break;
+                              case SO_PROTOCOL:
+                                  value = sock->domain == AF_UNIX
+                                              ? 0
+                                              : (sock->type == SOCK_STREAM ? IPPROTO_TCP : IPPROTO_UDP);
+                                  break;
+                              case SO_ACCEPTCONN:
+                                  value = sock->listening ? 1 : 0;
+                                  break;
+                              case SO_RCVBUF:
+                                  value = (int)sock->rcvbuf;
+                                  break;
+                              case SO_SNDBUF:
+                                  value = (int)sock->sndbuf;
+                                  break;
+                              case SO_RCVTIMEO:
+                              case SO_SNDTIMEO: {
+                                  const struct timeval timeout =
+                                      toTimeval(optname == SO_RCVTIMEO ? sock->recv_timeout : sock->send_timeout);
+                                  storeOption(&timeout, sizeof(timeout), optval, optlen);
+                                  *ret = 0;
+                                  return 0;
+                              }
+                              default: {
+                                  auto it = sock->options.find(make_pair(level, optname));
+                                  if (it != sock->options.end())
+                                  {
+                                      storeOption(it->second.data(), it->second.size(), optval, optlen);
+                                      *ret = 0;
+                                      return 0;
+                                  }
+                                  break;
+                              }
+                              }
+                          }
+                          else
+                          {
+                              auto it = sock->options.find(make_pair(level, optname));
+                              if (it != sock->options.end())
+                              {
+                                  storeOption(it->second.data(), it->second.size(), optval, optlen);
+                                  *ret = 0;
+                                  return 0;
+                              }
+                          }
+                          storeOption(&value, sizeof(value), optval, optlen);
+                          *ret = 0;
+                          return 0;
+                      });
+}
+
+bool virtualNetworkSendto(int sockfd, const void *buf, size_t len, int flags, const struct sockaddr *dest_addr,
+                          socklen_t addrlen, ssize_t *result)
+{
+    return withSocket(sockfd, result, [&](VirtualNetworkState &state, std::unique_lock<std::mutex> &lock,
+                                          const shared_ptr<VirtualSocket> &sock, ssize_t *ret) {
+        if (sock->listening)
+        {
+            return ENOTCONN;
+        }
+        int error = 0;
+        const char *data = static_cast<const char *>(buf);
+        const ssize_t sent =
+            sock->type == SOCK_STREAM
+                ? state.sendStreamLocked(lock, sock, data, len, flags, &error)
+                : state.sendDatagramLocked(lock, sock, data, len, flags, dest_addr, addrlen, &error);
+        return finishTransfer(sent, error, ret);
+    });
+}
+
+bool virtualNetworkRecvfrom(int sockfd, void *buf, size_t len, int flags, struct sockaddr *src_addr,
+                            socklen_t *addrlen, ssize_t *result)
+{
+    return withSocket(sockfd, result, [&](VirtualNetworkState &state, std::unique_lock<std::mutex> &lock,
+                                          const shared_ptr<VirtualSocket> &sock, ssize_t *ret) {
+        if (sock->listening)
+        {
+            return ENOTCONN;
+        }
+        int error = 0;
+        char *data = static_cast<char *>(buf);
+        const ssize_t received =
+            sock->type == SOCK_STREAM
+                ? state.recvStreamLocked(lock, sock, data, len, flags, &error)
+                : state.recvDatagramLocked(lock, sock, data, len, flags, src_addr, addrlen, &error);
+        return finishTransfer(received, error, ret);
+    });
+}
+
+bool virtualNetworkSend(int sockfd, const void *buf, size_t len, int flags, ssize_t *result)
+{
+    return virtualNetworkSendto(sockfd, buf, len, flags, nullptr, 0, result);
+}
+
+bool virtualNetworkRecv(int sockfd, void *buf, size_t len, int flags, ssize_t *result)
+{
+    return virtualNetworkRecvfrom(sockfd, buf, len, flags, nullptr, nullptr, result);
+}
+
+bool virtualNetworkRead(int fd, void *buf, size_t count, ssize_t *result)
+{
+    return virtualNetworkRecvfrom(fd, buf, count, 0, nullptr, nullptr, result);
+}
+
+bool virtualNetworkWrite(int fd, const void *buf, size_t count, ssize_t *result)
+{
+    return virtualNetworkSendto(fd, buf, count, 0, nullptr, 0, result);
+}
+
+bool virtualNetworkClose(int fd, int *result)
+{
+    return withSocket(fd, result,
+                      [&](VirtualNetworkState &state, std::unique_lock<std::mutex> &, const shared_ptr<VirtualSocket> &sock,
+                          int *ret) {
+                          state.sockets.erase(fd);
+                          state.closeSocketLocked(*sock);
+                          *ret = close(fd);
+                          return 0;
+                      });
+}
+
+bool virtualNetworkGetpeername(int sockfd, struct sockaddr *addr, socklen_t *addrlen, int *result)
+{
+    return withSocket(sockfd, result,
+                      [&](VirtualNetworkState &, std::unique_lock<std::mutex> &, const shared_ptr<VirtualSocket> &sock,
+                          int *ret) {
+                          if (!sock->connected)
+                          {
+                              return ENOTCONN;
+                          }
+                          if (addr == nullptr || addrlen == nullptr)
+                          {
+                              return EFAULT;
+                          }
+                          storeAddress(sock->domain, sock->peer, addr, addrlen);
+                          *ret = 0;
+                          return 0;
+                      });
+}
+
+bool virtualNetworkFcntl(int fd, int cmd, intptr_t arg, int *result)
+{
+    if (cmd != F_GETFL && cmd != F_SETFL)
+    {
+        return false;
+    }
+    return withSocket(fd, result,
+                      [&](VirtualNetworkState &state, std::unique_lock<std::mutex> &, const shared_ptr<VirtualSocket> &sock,
+                          int *ret) {
+                          if (cmd == F_GETFL)
+                          {
+                              *ret = O_RDWR | (sock->nonblocking ? O_NONBLOCK : 0);
+                          }
+                          else
+                          {
+                              sock->nonblocking = (arg & O_NONBLOCK) != 0;
+                              state.cv.notify_all();
+                              *ret = 0;
+                          }
+                          return 0;
+                      });
+}
+
+bool virtualNetworkPoll(struct pollfd *fds, nfds_t nfds, int timeout, int *result)
+{
+    auto locked_network = s_virtual_network.lock();
+    if (!locked_network || fds == nullptr)
+    {
+        return false;
+    }
+    std::unique_lock<std::mutex> lock(locked_network->mtx);
+    return locked_network->pollLocked(lock, fds, nfds, timeout < 0 ? -1 : (int64_t)timeout * 1000000, result);
+}
+
+bool virtualNetworkSelect(int nfds, fd_set *readfds, fd_set *writefds, fd_set *exceptfds, struct timeval *timeout,
+                          int *result)
+{
+    auto locked_network = s_virtual_network.lock();
+    if (!locked_network || nfds <= 0 || nfds > FD_SETSIZE)
+    {
+        return false;
+    }
+    // select の集合を poll の配列に変換する
+    vector<struct pollfd> fds;
+    for (int fd = 0; fd < nfds; ++fd)
+    {
+        short events = 0;
+        if (readfds != nullptr && FD_ISSET(fd, readfds))
+        {
+            events |= POLLIN;
+        }
+        if (writefds != nullptr && FD_ISSET(fd, writefds))
+        {
+            events |= POLLOUT;
+        }
+        if (exceptfds != nullptr && FD_ISSET(fd, exceptfds))
+        {
+            events |= POLLPRI;
+        }
+        if (events != 0)
+        {
+            fds.push_back(pollfd{fd, events, 0});
+        }
+    }
+    if (timeout != nullptr && (timeout->tv_sec < 0 || timeout->tv_usec < 0 || timeout->tv_usec >= 1000000))
+    {
+        return false;
+    }
+
+    std::unique_lock<std::mutex> lock(locked_network->mtx);
+    int ready;
+    if (!locked_network->pollLocked(lock, fds.data(), (nfds_t)fds.size(),
+                                    timeout == nullptr ? -1 : toNanoseconds(*timeout), &ready))
+    {
+        return false;
+    }
+    lock.unlock();
+
+    if (std::any_of(fds.begin(), fds.end(), [](const struct pollfd &fd) { return (fd.revents & POLLNVAL) != 0; }))
+    {
+        errno = EBADF;
+        *result = -1;
+        return true;
+    }
+    fd_set *sets[3] = {readfds, writefds, exceptfds};
+    for (fd_set *set : sets)
+    {
+        if (set != nullptr)
+        {
+            FD_ZERO(set);
+        }
+    }
+    int count = 0;
+    for (const struct pollfd &fd : fds)
+    {
+        if (readfds != nullptr && (fd.events & POLLIN) != 0 && (fd.revents & (POLLIN | POLLHUP | POLLERR)) != 0)
+        {
+            FD_SET(fd.fd, readfds);
+            ++count;
+        }
+        if (writefds != nullptr && (fd.events & POLLOUT) != 0 && (fd.revents & (POLLOUT | POLLERR)) != 0)
+        {
+            FD_SET(fd.fd, writefds);
+            ++count;
+        }
+        if (exceptfds != nullptr && (fd.events & POLLPRI) != 0 && (fd.revents & POLLPRI) != 0)
+        {
+            FD_SET(fd.fd, exceptfds);
+            ++count;
+        }
+    }
+    if (count == 0 && timeout != nullptr)
+    {
+        timeout->tv_sec = 0;
+        timeout->tv_usec = 0;
+    }
+    *result = count;
+    return true;
+}
+
+} // namespace testing
+
+#endif // _WIN32
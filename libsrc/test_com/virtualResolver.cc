@@ -0,0 +1,702 @@
+/* getaddrinfo / freeaddrinfo の mock 関数の委譲先とする名前の表。
+ * 名前は小文字に正規化した名前ごとにアドレスの配列を持ち、解決ごとに遅延と失敗の規則を適用する。
+ * 結果の addrinfo の連結リストは addrinfo・sockaddr・ai_canonname を 1 個のブロックに格納し、
+ * ブロックは大きさの区分ごとのプロセス全体のプールで再利用する (VirtualResolver の破棄後の freeaddrinfo にも対応するため)。 */
+
+#ifndef _WIN32
+
+    #include <virtualResolver.h>
+    #include "globMatch_impl.h"
+    #include <mock_instance.h>
+    #include <test_com.h>
+    #include <virtualClock.h>
+
+    #include <algorithm>
+    #include <cctype>
+    #include <cerrno>
+    #include <cstdlib>
+    #include <cstring>
+    #include <fstream>
+    #include <map>
+    #include <mutex>
+    #include <sstream>
+    #include <unordered_map>
+    #include <vector>
+
+    #include <arpa/inet.h>
+    #include <netinet/in.h>
+    #include <time.h>
+
+namespace testing
+{
+
+namespace
+{
+
+constexpr int64_t NANOSECONDS_PER_SECOND = 1000000000;
+
+// 小さい方から 2^8 ... 2^(8 + POOL_CLASS_COUNT - 1) バイトの区分で再利用する (それより大きいブロックは再利用しない)
+constexpr size_t POOL_MIN_SHIFT = 8;
+constexpr size_t POOL_CLASS_COUNT = 12;
+constexpr size_t POOL_MAX_FREE_BLOCKS = 64; // 区分ごとに保持する空きブロックの上限
+
+// splitmix64 (faultInjection.cc と同じ)
+uint64_t mixResolverSeed(uint64_t value)
+{
+    value += 0x9e3779b97f4a7c15ULL;
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+    return value ^ (value >> 31);
+}
+
+// addrinfo の連結リストを格納するブロックのプール
+class AddrinfoPool
+{
+  public:
+    static AddrinfoPool &instance()
+    {
+        static AddrinfoPool pool;
+        return pool;
+    }
+
+    ~AddrinfoPool()
+    {
+        for (vector<void *> &blocks : free_blocks_)
+        {
+            for (void *block : blocks)
+            {
+                free(block);
+            }
+        }
+    }
+
+    // size バイトのブロックを確保する。失敗した場合は nullptr を返す
+    void *allocate(size_t size)
+    {
+        const size_t size_class = classOf(size);
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            if (size_class < POOL_CLASS_COUNT && !free_blocks_[size_class].empty())
+            {
+                void *block = free_blocks_[size_class].back();
+                free_blocks_[size_class].pop_back();
+                outstanding_[block] = size_class;
+                return block;
+            }
+        }
+        void *block = malloc(size_class < POOL_CLASS_COUNT ? (size_t)1U << (size_class + POOL_MIN_SHIFT) : size);
+        if (block != nullptr)
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            outstanding_[block] = size_class;
+        }
+        return block;
+    }
+
+    // allocate したブロックの場合に解放して true を返す
+    bool release(void *block)
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        auto it = outstanding_.find(block);
+        if (it == outstanding_.end())
+        {
+            return false;
+        }
+        const size_t size_class = it->second;
+        outstanding_.erase(it);
+        if (size_class < POOL_CLASS_COUNT && free_blocks_[size_class].size() < POOL_MAX_FREE_BLOCKS)
+        {
+            free_blocks_[size_class].push_back(block);
+        }
+        else
+        {
+            free(block);
+        }
+        return true;
+    }
+
+    size_t outstanding() const
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        return outstanding_.size();
+    }
+
+  private:
+    AddrinfoPool() = default;
+
+    static size_t classOf(size_t size)
+    {
+        size_t size_class = 0;
+        while (size_class < POOL_CLASS_COUNT && ((size_t)1U << (size_class + POOL_MIN_SHIFT)) < size)
+        {
+            ++size_class;
+        }
+        return size_class;
+    }
+
+    mutable std::mutex mtx_;
+    vector<void *> free_blocks_[POOL_CLASS_COUNT];
+    unordered_map<void *, size_t> outstanding_; // 確保中のブロックと区分
+};
+
+struct ResolvedAddress
+{
+    int family;
+    uint8_t bytes[16]; // AF_INET は先頭 4 バイト
+};
+
+struct ResolverHost
+{
+    vector<ResolvedAddress> addresses;
+    string canonical; // 正式名
+};
+
+struct ResolverFailure
+{
+    string name_glob;
+    int eai_error;
+    uint64_t remaining;             // 残りの回数 (limited の場合)
+    bool limited;
+    uint64_t probability_threshold; // 確率を 2^64 倍した値 (0 は判定しない)
+};
+
+// 名前を小文字にし、末尾の '.' を除く
+string normalizeName(const string &name)
+{
+    string normalized(name);
+    while (!normalized.empty() && normalized.back() == '.')
+    {
+        normalized.pop_back();
+    }
+    std::transform(normalized.begin(), normalized.end(), normalized.begin(),
+                   [](unsigned char c) { return (char)std::tolower(c); });
+    return normalized;
+}
+
+bool parseNumericAddress(const char *text, ResolvedAddress *address)
+{
+    memset(address->bytes, 0, sizeof(address->bytes));
+    if (inet_pton(AF_INET, text, address->bytes) == 1)
+    {
+        address->family = AF_INET;
+        return true;
+    }
+    if (inet_pton(AF_INET6, text, address->bytes) == 1)
+    {
+        address->family = AF_INET6;
+        return true;
+    }
+    return false;
+}
+
+// service をポート番号 (ホスト バイト順) に変換する。失敗した場合は EAI_* の値を返す
+int parseService(const char *service, int flags, int socktype, uint16_t *port)
+{
+    if (service == nullptr)
+    {
+        *port = 0;
+        return 0;
+    }
+    char *end = nullptr;
+    errno = 0;
+    const unsigned long value = strtoul(service, &end, 10);
+    if (*service != '\0' && *end == '\0' && errno == 0)
+    {
+        if (value > 65535U)
+        {
+            return EAI_SERVICE;
+        }
+        *port = (uint16_t)value;
+        return 0;
+    }
+    if ((flags & AI_NUMERICSERV) != 0)
+    {
+        return EAI_NONAME;
+    }
+    struct servent entry;
+    struct servent *found = nullptr;
+    char buffer[1024];
+    if (getservbyname_r(service, socktype == SOCK_DGRAM ? "udp" : "tcp", &entry, buffer, sizeof(buffer), &found) !=
+            0 ||
+        found == nullptr)
+    {
+        return EAI_SERVICE;
+    }
+    *port = ntohs((uint16_t)found->s_port);
+    return 0;
+}
+
+void sleepNanoseconds(int64_t nanoseconds)
+{
+    if (nanoseconds <= 0)
+    {
+        return;
+    }
+    struct timespec request;
+    request.tv_sec = (time_t)(nanoseconds / NANOSECONDS_PER_SECOND);
+    request.tv_nsec = (long)(nanoseconds % NANOSECONDS_PER_SECOND);
+    int result;
+    if (!virtualNanosleep(&request, nullptr, &result))
+    {
+        while (nanosleep(&request, &request) != 0 && errno == EINTR)
+        {
+        }
+    }
+}
+
+/*
+ * addresses × socktypes の addrinfo の連結リストを 1 個のブロックに格納する。
+ * ブロックの先頭が連結リストの先頭の addrinfo で、その後に sockaddr と ai_canonname を置く。
+ */
+struct addrinfo *buildAddrinfo(const vector<ResolvedAddress> &addresses, const vector<int> &socktypes,
+                               const uint16_t *ports, int flags, const string *canonical)
+{
+    const size_t count = addresses.size() * socktypes.size();
+    const size_t canonical_size = canonical != nullptr ? canonical->size() + 1U : 0U;
+    const size_t size = count * (sizeof(struct addrinfo) + sizeof(struct sockaddr_in6)) + canonical_size;
+    char *block = static_cast<char *>(AddrinfoPool::instance().allocate(size));
+    if (block == nullptr)
+    {
+        return nullptr;
+    }
+    memset(block, 0, size);
+    struct addrinfo *infos = reinterpret_cast<struct addrinfo *>(block);
+    char *sockaddrs = block + count * sizeof(struct addrinfo);
+    char *canonname = sockaddrs + count * sizeof(struct sockaddr_in6);
+    if (canonical != nullptr)
+    {
+        memcpy(canonname, canonical->c_str(), canonical_size);
+    }
+
+    size_t index = 0;
+    for (const ResolvedAddress &address : addresses)
+    {
+        for (size_t t = 0; t < socktypes.size(); ++t)
+        {
+            struct addrinfo &info = infos[index];
+            char *storage = sockaddrs + index * sizeof(struct sockaddr_in6);
+            info.ai_flags = flags;
+            info.ai_family = address.family;
+            info.ai_socktype = socktypes[t];
+            info.ai_protocol = socktypes[t] == SOCK_DGRAM ? IPPROTO_UDP : IPPROTO_TCP;
+            if (address.family == AF_INET)
+            {
+                struct sockaddr_in in;
+                memset(&in, 0, sizeof(in));
+                in.sin_family = AF_INET;
+                in.sin_port = htons(ports[t]);
+                memcpy(&in.sin_addr, address.bytes, sizeof(in.sin_addr));
+                memcpy(storage, &in, sizeof(in));
+                info.ai_addrlen = sizeof(in);
+            }
+            else
+            {
+                struct sockaddr_in6 in6;
+                memset(&in6, 0, sizeof(in6));
+                in6.sin6_family = AF_INET6;
+                in6.sin6_port = htons(ports[t]);
+                memcpy(&in6.sin6_addr, address.bytes, sizeof(in6.sin6_addr));
+                memcpy(storage, &in6, sizeof(in6));
+                info.ai_addrlen = sizeof(in6);
+            }
+            info.ai_addr = reinterpret_cast<struct sockaddr *>(storage);
+            info.ai_canonname = index == 0U && canonical != nullptr ? canonname : nullptr;
+            info.ai_next = index + 1U < count ? &infos[index + 1U] : nullptr;
+            ++index;
+        }
+    }
+    return infos;
+}
+
+} // namespace
+
+struct VirtualResolverState
+{
+    VirtualResolverState(VirtualResolver *owner_value, uint64_t seed_value) : owner(owner_value), seed(seed_value)
+    {
+    }
+
+    void addLocked(const string &name, const ResolvedAddress &address, const string &canonical)
+    {
+        ResolverHost &host = hosts[normalizeName(name)];
+        if (host.addresses.empty())
+        {
+            host.canonical = canonical;
+        }
+        host.addresses.push_back(address);
+    }
+
+    // mtx を取得して呼び出す。失敗させる場合は EAI_* の値を返す
+    int failureLocked(const string &name, uint64_t lookup_index)
+    {
+        for (size_t i = 0; i < failures.size(); ++i)
+        {
+            ResolverFailure &failure = failures[i];
+            if (!matchGlob(failure.name_glob, name.c_str()))
+            {
+                continue;
+            }
+            if (failure.probability_threshold != 0U &&
+                mixResolverSeed(seed ^ mixResolverSeed(i ^ mixResolverSeed(lookup_index ^ std::hash<string>()(name)))) >=
+                    failure.probability_threshold)
+            {
+                continue;
+            }
+            if (failure.limited)
+            {
+                if (failure.remaining == 0U)
+                {
+                    continue;
+                }
+                --failure.remaining;
+            }
+            return failure.eai_error;
+        }
+        return 0;
+    }
+
+    VirtualResolver *owner;
+    const uint64_t seed;
+    mutable std::mutex mtx;
+    map<string, ResolverHost> hosts;
+    vector<ResolverFailure> failures;
+    int64_t latency_ns = 0;
+    int64_t jitter_ns = 0;
+    bool fallback = false;
+    unordered_map<string, uint64_t> lookups;
+    uint64_t total_lookups = 0;
+};
+
+namespace
+{
+
+testfw::MockSlot<VirtualResolverState> s_virtual_resolver;
+
+} // namespace
+
+VirtualResolver::VirtualResolver(uint64_t seed) : state_(new VirtualResolverState(this, seed))
+{
+    // hosts ファイルの既定の内容
+    ResolvedAddress loopback;
+    (void)parseNumericAddress("127.0.0.1", &loopback);
+    state_->addLocked("localhost", loopback, "localhost");
+    (void)parseNumericAddress("::1", &loopback);
+    state_->addLocked("localhost", loopback, "localhost");
+
+    if (s_virtual_resolver.get() != nullptr)
+    {
+        ADD_FAILURE() << "Only one VirtualResolver may exist at a time.";
+        return;
+    }
+    s_virtual_resolver.publish(state_.get());
+}
+
+VirtualResolver::~VirtualResolver()
+{
+    if (s_virtual_resolver.get() == state_.get() &&
+        !s_virtual_resolver.retire(state_.get(), testfw::internal::kMockRetireTimeout))
+    {
+        ADD_FAILURE() << "Mock calls did not finish within " << testfw::internal::kMockRetireTimeout.count()
+                      << " ms while destroying VirtualResolver.";
+        // 名前解決中のスレッドが参照している可能性があるため解放しない
+        (void)state_.release();
+    }
+}
+
+VirtualResolver &VirtualResolver::addHost(const string &name, const string &address)
+{
+    ResolvedAddress resolved;
+    if (!parseNumericAddress(address.c_str(), &resolved))
+    {
+        ADD_FAILURE() << "Invalid address for VirtualResolver: \"" << address << "\"";
+        return *this;
+    }
+    std::lock_guard<std::mutex> lock(state_->mtx);
+    state_->addLocked(name, resolved, name);
+    return *this;
+}
+
+VirtualResolver &VirtualResolver::removeHost(const string &name)
+{
+    std::lock_guard<std::mutex> lock(state_->mtx);
+    (void)state_->hosts.erase(normalizeName(name));
+    return *this;
+}
+
+VirtualResolver &VirtualResolver::loadHosts(const string &text)
+{
+    std::istringstream lines(text);
+    string line;
+    std::lock_guard<std::mutex> lock(state_->mtx);
+    while (std::getline(lines, line))
+    {
+        const size_t comment = line.find('#');
+        if (comment != string::npos)
+        {
+            line.erase(comment);
+        }
+        std::istringstream fields(line);
+        string address;
+        string canonical;
+        if (!(fields >> address >> canonical))
+        {
+            continue;
+        }
+        ResolvedAddress resolved;
+        if (!parseNumericAddress(address.c_str(), &resolved))
+        {
+            ADD_FAILURE() << "Invalid address in hosts: \"" << address << "\"";
+            continue;
+        }
+        state_->addLocked(canonical, resolved, canonical);
+        string alias;
+        while (fields >> alias)
+        {
+            state_->addLocked(alias, resolved, canonical);
+        }
+    }
+    return *this;
+}
+
+bool VirtualResolver::loadHostsFile(const string &path)
+{
+    std::ifstream file(path);
+    if (!file)
+    {
+        return false;
+    }
+    std::ostringstream text;
+    text << file.rdbuf();
+    (void)loadHosts(text.str());
+    return true;
+}
+
+VirtualResolver &VirtualResolver::setLatency(chrono::nanoseconds latency, chrono::nanoseconds jitter)
+{
+    std::lock_guard<std::mutex> lock(state_->mtx);
+    state_->latency_ns = std::max<int64_t>(latency.count(), 0);
+    state_->jitter_ns = std::max<int64_t>(jitter.count(), 0);
+    return *this;
+}
+
+VirtualResolver &VirtualResolver::failLookups(const string &name_glob, int eai_error, uint64_t count)
+{
+    std::lock_guard<std::mutex> lock(state_->mtx);
+    state_->failures.push_back(ResolverFailure{normalizeName(name_glob), eai_error, count, count != 0U, 0U});
+    return *this;
+}
+
+VirtualResolver &VirtualResolver::failWithProbability(const string &name_glob, int eai_error, double probability)
+{
+    if (probability < 0.0 || probability > 1.0)
+    {
+        ADD_FAILURE() << "Lookup failure probability must be within [0.0, 1.0]: " << probability;
+        return *this;
+    }
+    const uint64_t threshold =
+        probability >= 1.0 ? UINT64_MAX : (uint64_t)(probability * 18446744073709551616.0);
+    if (threshold == 0U)
+    {
+        return *this;
+    }
+    std::lock_guard<std::mutex> lock(state_->mtx);
+    state_->failures.push_back(ResolverFailure{normalizeName(name_glob), eai_error, 0U, false, threshold});
+    return *this;
+}
+
+VirtualResolver &VirtualResolver::setFallbackToSystem(bool fallback)
+{
+    std::lock_guard<std::mutex> lock(state_->mtx);
+    state_->fallback = fallback;
+    return *this;
+}
+
+uint64_t VirtualResolver::lookupCount(const string &name) const
+{
+    std::lock_guard<std::mutex> lock(state_->mtx);
+    auto it = state_->lookups.find(normalizeName(name));
+    return it == state_->lookups.end() ? 0U : it->second;
+}
+
+uint64_t VirtualResolver::totalLookups() const
+{
+    std::lock_guard<std::mutex> lock(state_->mtx);
+    return state_->total_lookups;
+}
+
+size_t VirtualResolver::outstandingResults() const
+{
+    return AddrinfoPool::instance().outstanding();
+}
+
+VirtualResolver *getVirtualResolver()
+{
+    VirtualResolverState *state = s_virtual_resolver.get();
+    return state == nullptr ? nullptr : state->owner;
+}
+
+bool virtualGetaddrinfo(const char *node, const char *service, const struct addrinfo *hints, struct addrinfo **res,
+                        int *result)
+{
+    auto locked_resolver = s_virtual_resolver.lock();
+    if (!locked_resolver)
+    {
+        return false;
+    }
+
+    const int family = hints != nullptr ? hints->ai_family : AF_UNSPEC;
+    const int socktype = hints != nullptr ? hints->ai_socktype : 0;
+    const int flags = hints != nullptr ? hints->ai_flags : (AI_V4MAPPED | AI_ADDRCONFIG);
+    if (node == nullptr && service == nullptr)
+    {
+        *result = EAI_NONAME;
+        return true;
+    }
+    if (family != AF_UNSPEC && family != AF_INET && family != AF_INET6)
+    {
+        *result = EAI_FAMILY;
+        return true;
+    }
+    if (socktype != 0 && socktype != SOCK_STREAM && socktype != SOCK_DGRAM)
+    {
+        *result = EAI_SOCKTYPE;
+        return true;
+    }
+
+    // socktype が 0 の場合は SOCK_STREAM と SOCK_DGRAM のうち、service のポート番号があるものを返す
+    vector<int> socktypes;
+    uint16_t ports[2] = {0, 0};
+    int service_error = 0;
+    for (int candidate : socktype != 0 ? vector<int>{socktype} : vector<int>{SOCK_STREAM, SOCK_DGRAM})
+    {
+        const int error = parseService(service, flags, candidate, &ports[socktypes.size()]);
+        if (error != 0)
+        {
+            service_error = error;
+            continue;
+        }
+        socktypes.push_back(candidate);
+    }
+    if (socktypes.empty())
+    {
+        *result = service_error;
+        return true;
+    }
+
+    vector<ResolvedAddress> candidates;
+    string canonical;
+    ResolvedAddress numeric;
+    if (node == nullptr)
+    {
+        // AI_PASSIVE はワイルドカード、それ以外はループバック
+        const bool passive = (flags & AI_PASSIVE) != 0;
+        (void)parseNumericAddress(passive ? "0.0.0.0" : "127.0.0.1", &numeric);
+        candidates.push_back(numeric);
+        (void)parseNumericAddress(passive ? "::" : "::1", &numeric);
+        candidates.push_back(numeric);
+    }
+    else if (parseNumericAddress(node, &numeric))
+    {
+        candidates.push_back(numeric);
+        canonical = node;
+    }
+    else if ((flags & AI_NUMERICHOST) != 0)
+    {
+        *result = EAI_NONAME;
+        return true;
+    }
+    else
+    {
+        const string name = normalizeName(node);
+        int64_t delay_ns;
+        int failure;
+        bool found;
+        {
+            std::lock_guard<std::mutex> lock(locked_resolver->mtx);
+            const uint64_t lookup_index = ++locked_resolver->lookups[name];
+            ++locked_resolver->total_lookups;
+            delay_ns = locked_resolver->latency_ns;
+            if (locked_resolver->jitter_ns > 0)
+            {
+                delay_ns += (int64_t)(mixResolverSeed(locked_resolver->seed ^ mixResolverSeed(lookup_index) ^
+                                                      std::hash<string>()(name)) %
+                                      (uint64_t)locked_resolver->jitter_ns);
+            }
+            failure = locked_resolver->failureLocked(name, lookup_index);
+            auto it = locked_resolver->hosts.find(name);
+            found = it != locked_resolver->hosts.end();
+            if (found)
+            {
+                candidates = it->second.addresses;
+                canonical = it->second.canonical;
+            }
+            else if (failure == 0 && locked_resolver->fallback)
+            {
+                delay_ns = 0;
+            }
+        }
+        sleepNanoseconds(delay_ns);
+        if (failure != 0)
+        {
+            *result = failure;
+            return true;
+        }
+        if (!found)
+        {
+            if (locked_resolver->fallback)
+            {
+                return false;
+            }
+            *result = EAI_NONAME;
+            return true;
+        }
+    }
+
+    // hints の ai_family で選択する (AF_INET6 で AI_V4MAPPED の場合、IPv6 アドレスが無ければ IPv4 射影アドレスにする)
+    vector<ResolvedAddress> addresses;
+    for (const ResolvedAddress &candidate : candidates)
+    {
+        if (family == AF_UNSPEC || candidate.family == family)
+        {
+            addresses.push_back(candidate);
+        }
+    }
+    if (addresses.empty() && family == AF_INET6 && (flags & AI_V4MAPPED) != 0)
+    {
+        for (const ResolvedAddress &candidate : candidates)
+        {
+            ResolvedAddress mapped;
+            memset(mapped.bytes, 0, sizeof(mapped.bytes));
+            mapped.family = AF_INET6;
+            mapped.bytes[10] = 0xffU;
+            mapped.bytes[11] = 0xffU;
+            memcpy(mapped.bytes + 12, candidate.bytes, 4);
+            addresses.push_back(mapped);
+        }
+    }
+    if (addresses.empty())
+    {
+        *result = node != nullptr && canonical == node ? EAI_ADDRFAMILY : EAI_NONAME;
+        return true;
+    }
+
+    const bool with_canonical = (flags & AI_CANONNAME) != 0 && node != nullptr;
+    struct addrinfo *head = buildAddrinfo(addresses, socktypes, ports, flags, with_canonical ? &canonical : nullptr);
+    if (head == nullptr)
+    {
+        *result = EAI_MEMORY;
+        return true;
+    }
+    *res = head;
+    *result = 0;
+    return true;
+}
+
+bool virtualFreeaddrinfo(struct addrinfo *res)
+{
+    return res != nullptr && AddrinfoPool::instance().release(res);
+}
+
+} // namespace testing
+
+#endif // _WIN32
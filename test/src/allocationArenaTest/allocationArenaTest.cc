@@ -0,0 +1,91 @@
+#include <testfw.h>
+#include <gtest/gtest-spi.h>
+#include <mock_stdlib.h>
+
+#include <cstring>
+
+#ifndef _WIN32
+
+// ARENA_RESET_QUARANTINE の reset() 後の領域をアクセス不可として保持し、free を失敗として検出することの確認
+TEST(allocationArenaTest, quarantine_detects_use_and_free_after_reset)
+{
+    // Arrange
+    AllocationArena allocation_arena(AllocationArena::DEFAULT_CHUNK_SIZE, ARENA_RESET_QUARANTINE);
+    char *ptr = static_cast<char *>(mock_malloc(__FILE__, __LINE__, __func__, 64));
+    ASSERT_NE(nullptr, ptr);
+    memset(ptr, 'a', 64);
+
+    // Pre-Assert
+    ASSERT_EQ(1U, allocation_arena.stats().allocations);
+
+    // Act
+    allocation_arena.reset(); // [手順] - 未解放の領域を残したまま reset() する。
+
+    // Assert
+    const AllocationArenaStats stats = allocation_arena.stats();
+    EXPECT_EQ(1U, stats.resets);      // [確認_正常系] - reset() を数えること。
+    EXPECT_EQ(0U, stats.allocations); // [確認_正常系] - 確保回数を reset() 以降の値に戻すこと。
+    EXPECT_LE(1U, stats.quarantined); // [確認_正常系] - 解放したチャンクを保持すること。
+    EXPECT_DEATH(
+        {
+            volatile char value = *ptr;
+            (void)value;
+        },
+        ""); // [確認_異常系] - reset() 後の読み込みを SIGSEGV とすること。
+    EXPECT_NONFATAL_FAILURE(mock_free(__FILE__, __LINE__, __func__, ptr),
+                            "of memory released by AllocationArena::reset()."); // [確認_異常系] - free を検出すること。
+    EXPECT_EQ(1U, allocation_arena.stats().invalid_frees); // [確認_異常系] - 不正な解放を数えること。
+}
+
+// ARENA_RESET_RECYCLE の reset() 後は、解放したチャンクを以降の確保に再利用することの確認
+TEST(allocationArenaTest, recycle_reuses_chunks_after_reset)
+{
+    // Arrange
+    AllocationArena allocation_arena(AllocationArena::DEFAULT_CHUNK_SIZE, ARENA_RESET_RECYCLE);
+    void *before_reset = mock_malloc(__FILE__, __LINE__, __func__, 64);
+    ASSERT_NE(nullptr, before_reset);
+
+    // Pre-Assert
+
+    // Act
+    allocation_arena.reset(); // [手順] - 確保した領域を解放する。
+    char *after_reset = static_cast<char *>(mock_malloc(__FILE__, __LINE__, __func__, 64));
+    ASSERT_NE(nullptr, after_reset);
+    memset(after_reset, 'b', 64); // [手順] - 再確保した領域に書き込む。
+    mock_free(__FILE__, __LINE__, __func__, after_reset);
+
+    // Assert
+    const AllocationArenaStats stats = allocation_arena.stats();
+    EXPECT_EQ(before_reset, after_reset); // [確認_正常系] - 同じチャンクの先頭から再び切り出すこと。
+    EXPECT_EQ(0U, stats.quarantined);     // [確認_正常系] - アクセス不可として保持しないこと。
+    EXPECT_EQ(1U, stats.chunks);          // [確認_正常系] - 新しいチャンクを確保しないこと。
+    EXPECT_EQ(0U, stats.invalid_frees);   // [確認_正常系] - 再確保した領域の解放を受け付けること。
+}
+
+// Mock_stdlib の生存中も、AllocationArena の領域の realloc / free を AllocationArena へ戻すことの確認
+TEST(allocationArenaTest, arena_blocks_return_to_arena_while_mock_stdlib_is_alive)
+{
+    // Arrange
+    AllocationArena allocation_arena;
+    char *ptr = static_cast<char *>(mock_malloc(__FILE__, __LINE__, __func__, 16));
+    ASSERT_NE(nullptr, ptr);
+    strcpy(ptr, "arena");
+    NiceMock<Mock_stdlib> mock_stdlib; // [手順] - getenv のみを設定した Mock_stdlib を生成する。
+    ON_CALL(mock_stdlib, getenv(_, _, _, _)).WillByDefault(Return(nullptr));
+
+    // Pre-Assert
+
+    // Act
+    char *resized = static_cast<char *>(mock_realloc(__FILE__, __LINE__, __func__, ptr, 64));
+    ASSERT_NE(nullptr, resized);
+    const string content = resized;
+    mock_free(__FILE__, __LINE__, __func__, resized); // [手順] - AllocationArena の領域を解放する。
+
+    // Assert
+    const AllocationArenaStats stats = allocation_arena.stats();
+    EXPECT_EQ("arena", content);        // [確認_正常系] - 内容を引き継いで確保し直すこと。
+    EXPECT_EQ(2U, stats.allocations);   // [確認_正常系] - realloc も AllocationArena から確保すること。
+    EXPECT_EQ(0U, stats.invalid_frees); // [確認_正常系] - 解放を AllocationArena が受け付けること。
+}
+
+#endif // _WIN32
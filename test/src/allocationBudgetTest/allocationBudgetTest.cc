@@ -0,0 +1,115 @@
+#include <testfw.h>
+#include <gtest/gtest-spi.h>
+#include <mock_stdlib.h>
+
+#include <thread>
+
+#ifndef _WIN32
+
+namespace
+{
+
+void *allocate(size_t size)
+{
+    return mock_malloc(__FILE__, __LINE__, __func__, size);
+}
+
+void release(void *ptr)
+{
+    mock_free(__FILE__, __LINE__, __func__, ptr);
+}
+
+} // namespace
+
+// 上限以内の確保では失敗とせず、上限を超えた確保を回数と確保元とともに失敗として報告することの確認
+TEST(allocationBudgetTest, breach_fails_with_count_and_site)
+{
+    // Arrange
+    void *first = nullptr;
+    void *second = nullptr;
+    void *third = nullptr;
+
+    // Pre-Assert
+
+    // Act & Assert
+    EXPECT_MAX_ALLOCATIONS(1, first = allocate(8)); // [確認_正常系] - 上限以内の確保は失敗としないこと。
+    EXPECT_NO_ALLOCATIONS(release(first));          // [確認_正常系] - 解放は数えないこと。
+    // [確認_異常系] - 上限を超えた場合は、確保の回数と上限、確保元を示して失敗とすること。
+    EXPECT_NONFATAL_FAILURE(EXPECT_MAX_ALLOCATIONS(1, second = allocate(8), third = allocate(8)),
+                            "Allocation budget exceeded: 2 allocation(s), 16 byte(s) (limit: 1 allocation(s))\n"
+                            "  " __FILE__);
+    release(second);
+    release(third);
+}
+
+// バイト数の上限を超えた確保を失敗として報告することの確認
+TEST(allocationBudgetTest, byte_limit_breach_fails)
+{
+    // Arrange
+    void *ptr = nullptr;
+
+    // Pre-Assert
+
+    // Act & Assert
+    EXPECT_NONFATAL_FAILURE(
+        {
+            AllocationBudget budget(__FILE__, __LINE__, 10, 16); // [手順] - 16 バイトを上限とする。
+            ptr = allocate(32);
+        },
+        "(limit: 10 allocation(s), 16 byte(s))"); // [確認_異常系] - バイト数の上限を示すこと。
+    release(ptr);
+}
+
+// 入れ子のスコープの確保を外側のスコープにも数え、内側のスコープの終了後は外側のみに数えることの確認
+TEST(allocationBudgetTest, nested_scope_counts_into_outer_scope)
+{
+    // Arrange
+    AllocationBudget outer(__FILE__, __LINE__, 10);
+    uint64_t inner_allocations = 0;
+    uint64_t outer_after_inner = 0;
+    void *inner_ptr = nullptr;
+
+    // Pre-Assert
+
+    // Act
+    {
+        AllocationBudget inner(__FILE__, __LINE__, 10); // [手順] - 入れ子のスコープで確保する。
+        inner_ptr = allocate(24);
+        inner_allocations = inner.allocations();
+        outer_after_inner = outer.allocations();
+    }
+    void *outer_ptr = allocate(8); // [手順] - 内側のスコープの終了後に確保する。
+    release(inner_ptr);
+    release(outer_ptr);
+
+    // Assert
+    EXPECT_EQ(1U, inner_allocations);   // [確認_正常系] - 内側のスコープに数えること。
+    EXPECT_EQ(1U, outer_after_inner);   // [確認_正常系] - 外側のスコープにも数えること。
+    EXPECT_EQ(2U, outer.allocations()); // [確認_正常系] - 内側の終了後は外側に数えること。
+    EXPECT_EQ(32U, outer.bytes());
+}
+
+// 他のスレッドの確保を数えず、スレッドごとのスコープに数えることの確認
+TEST(allocationBudgetTest, counts_stay_per_thread)
+{
+    // Arrange
+    AllocationBudget main_budget(__FILE__, __LINE__, 0); // [手順] - テストのスレッドは確保しない上限とする。
+    uint64_t worker_allocations = 0;
+
+    // Pre-Assert
+
+    // Act
+    std::thread worker([&worker_allocations]() {
+        AllocationBudget worker_budget(__FILE__, __LINE__, 2);
+        release(allocate(16)); // [手順] - 別のスレッドで確保する。
+        release(allocate(16));
+        worker_allocations = worker_budget.allocations();
+    });
+    worker.join();
+
+    // Assert
+    EXPECT_EQ(2U, worker_allocations);        // [確認_正常系] - 確保したスレッドのスコープに数えること。
+    EXPECT_EQ(0U, main_budget.allocations()); // [確認_正常系] - 他のスレッドの確保を数えないこと。
+}
+
+#endif // _WIN32
@@ -0,0 +1,22 @@
+// テスト対象のソース (TEST_SRCS) と同じく、override ヘッダーで malloc / free を mock 関数へ置き換えるソース。
+// <cstdlib> は libstdc++ がマクロを #undef するため、置き換えの前に取り込む。
+#include <cstdlib>
+
+#define _IN_OVERRIDE_HEADER_STDLIB_H
+#include <mock_stdlib.h>
+#undef _IN_OVERRIDE_HEADER_STDLIB_H
+
+void *targetAllocate(size_t size)
+{
+    return malloc(size);
+}
+
+void targetRelease(void *ptr)
+{
+    free(ptr);
+}
+
+void targetReleaseWithStd(void *ptr)
+{
+    std::free(ptr);
+}
@@ -0,0 +1,123 @@
+#include <testfw.h>
+#include <mock_stdlib.h>
+
+#include <cstdlib>
+
+// allocationTrackingTarget.cc (置換マクロを適用したソース) の関数
+extern void *targetAllocate(size_t size);
+extern void targetRelease(void *ptr);
+extern void targetReleaseWithStd(void *ptr);
+
+namespace
+{
+
+class allocationTrackingTest : public Test
+{
+  protected:
+    void SetUp() override
+    {
+        setAllocationTrackingEnabled(true);
+        sequence_ = getAllocationSequence();
+    }
+
+    void TearDown() override
+    {
+        setAllocationTrackingEnabled(false);
+        clearAllocationTracking();
+    }
+
+    uint64_t sequence_ = 0;
+};
+
+} // namespace
+
+// 置換マクロを適用したソースでの確保と解放を対にして記録することの確認
+TEST_F(allocationTrackingTest, pair_in_override_source_is_balanced)
+{
+    // Arrange
+    const uint64_t frees_before = getAllocationStats().frees;
+
+    // Pre-Assert
+
+    // Act
+    void *ptr = targetAllocate(32); // [手順] - 置換マクロを適用したソースで確保する。
+    const size_t live_after_allocate = getLiveAllocations(sequence_).size();
+    targetRelease(ptr); // [手順] - 同じソースで解放する。
+
+    // Assert
+    EXPECT_EQ(1U, live_after_allocate);                       // [確認_正常系] - 確保を記録すること。
+    EXPECT_TRUE(getLiveAllocations(sequence_).empty());       // [確認_正常系] - 解放で記録を削除すること。
+    EXPECT_EQ(frees_before + 1U, getAllocationStats().frees); // [確認_正常系] - 解放を数えること。
+}
+
+// std::free も置換マクロで mock 関数を経由し、解放を記録することの確認
+TEST_F(allocationTrackingTest, std_free_in_override_source_is_tracked)
+{
+    // Arrange
+    void *ptr = targetAllocate(16);
+
+    // Pre-Assert
+    ASSERT_EQ(1U, getLiveAllocations(sequence_).size());
+
+    // Act
+    targetReleaseWithStd(ptr); // [手順] - std::free で解放する。
+
+    // Assert
+    EXPECT_TRUE(getLiveAllocations(sequence_).empty()); // [確認_正常系] - std::free の解放を記録すること。
+}
+
+// 置換マクロを適用したソースで確保し、本物の free で解放した領域を未解放として報告することの確認
+TEST_F(allocationTrackingTest, allocation_freed_by_real_free_is_reported)
+{
+    // Arrange
+    void *ptr = targetAllocate(24);
+
+    // Pre-Assert
+
+    // Act
+    free(ptr); // [手順] - テスト コード (置換マクロを適用しないソース) で解放する。
+
+    // Assert
+    const vector<LiveAllocation> live = getLiveAllocations(sequence_);
+    ASSERT_EQ(1U, live.size());                                 // [確認_正常系] - 解放を記録しないこと。
+    EXPECT_EQ(24U, live[0].size);                               // [確認_正常系] - 確保の要求サイズを保持すること。
+    EXPECT_NE(string::npos, live[0].file.find("allocationTrackingTarget.cc")); // [確認_正常系] - 確保元を保持すること。
+}
+
+// 本物の malloc で確保し、置換マクロを適用したソースで解放した領域を無視することの確認
+TEST_F(allocationTrackingTest, real_allocation_freed_in_override_source_is_ignored)
+{
+    // Arrange
+    void *ptr = malloc(8); // [手順] - テスト コードで確保する。
+    const AllocationStats before = getAllocationStats();
+
+    // Pre-Assert
+
+    // Act
+    targetRelease(ptr); // [手順] - 置換マクロを適用したソースで解放する。
+
+    // Assert
+    const AllocationStats after = getAllocationStats();
+    EXPECT_EQ(before.frees, after.frees);                       // [確認_正常系] - 追跡していない解放を数えないこと。
+    EXPECT_EQ(before.live_allocations, after.live_allocations); // [確認_正常系] - 未解放の確保数を変えないこと。
+}
+
+// AllocationArena の領域も確保と解放を記録し、解放を AllocationArena に戻すことの確認
+TEST_F(allocationTrackingTest, arena_allocation_is_tracked_and_returned_to_arena)
+{
+    // Arrange
+    AllocationArena allocation_arena;
+
+    // Pre-Assert
+
+    // Act
+    void *ptr = targetAllocate(40); // [手順] - AllocationArena の生存中に確保する。
+    const size_t live_after_allocate = getLiveAllocations(sequence_).size();
+    targetRelease(ptr);
+
+    // Assert
+    EXPECT_EQ(1U, allocation_arena.stats().allocations);   // [確認_正常系] - AllocationArena から確保すること。
+    EXPECT_EQ(1U, live_after_allocate);                    // [確認_正常系] - AllocationArena の確保も記録すること。
+    EXPECT_TRUE(getLiveAllocations(sequence_).empty());    // [確認_正常系] - 解放で記録を削除すること。
+    EXPECT_EQ(0U, allocation_arena.stats().invalid_frees); // [確認_正常系] - 解放を AllocationArena が受け付けること。
+}
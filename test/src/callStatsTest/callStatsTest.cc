@@ -0,0 +1,102 @@
+#include <testfw.h>
+#include <mock_stdio.h>
+
+#include <cstdio>
+#include <cstdlib>
+
+#ifndef _WIN32
+    #include <unistd.h>
+#endif
+
+#ifndef _WIN32
+
+namespace
+{
+
+class callStatsTest : public Test
+{
+  protected:
+    void SetUp() override
+    {
+        char path_template[] = "/tmp/callStatsTest.XXXXXX";
+        const int fd = mkstemp(path_template);
+        ASSERT_NE(-1, fd);
+        close(fd);
+        path_ = path_template;
+
+        FILE *fp = fopen(path_.c_str(), "wb");
+        ASSERT_NE(nullptr, fp);
+        fputs("0123456789", fp);
+        fclose(fp);
+
+        setCallStatsEnabled(true);
+        resetCallStats();
+    }
+
+    void TearDown() override
+    {
+        setCallStatsEnabled(false);
+        resetCallStats();
+        unlink(path_.c_str());
+    }
+
+    string path_;
+};
+
+} // namespace
+
+// ファイルの終端までの fread の不足 (EOF) をエラーとして数えないことの確認
+TEST_F(callStatsTest, fread_to_eof_is_not_an_error)
+{
+    // Arrange
+    FILE *fp = fopen(path_.c_str(), "rb");
+    ASSERT_NE(nullptr, fp);
+    char buffer[64];
+
+    // Pre-Assert
+
+    // Act
+    // [手順] - 大きさより多くの要素を要求して終端まで読み、続けて終端で読む。
+    const size_t first_ret = mock_fread(__FILE__, __LINE__, __func__, buffer, 1, sizeof(buffer), fp);
+    const size_t second_ret = mock_fread(__FILE__, __LINE__, __func__, buffer, 1, sizeof(buffer), fp);
+    fclose(fp);
+
+    // Assert
+    EXPECT_EQ(10U, first_ret);
+    EXPECT_EQ(0U, second_ret);
+    const vector<CallSiteStats> stats = getCallStats("fread");
+    uint64_t calls = 0;
+    uint64_t errors = 0;
+    for (const auto &site : stats)
+    {
+        calls += site.calls;
+        errors += site.errors;
+    }
+    EXPECT_EQ(2U, calls);  // [確認_正常系] - 呼び出しを数えること。
+    EXPECT_EQ(0U, errors); // [確認_正常系] - EOF による要素数の不足はエラーとしないこと。
+}
+
+// ストリームのエラー (ferror) による fread の不足をエラーとして数えることの確認
+TEST_F(callStatsTest, fread_stream_error_is_an_error)
+{
+    // Arrange
+    FILE *fp = fopen(path_.c_str(), "wb"); // [手順] - 書き込み専用で開き、読み込みをエラーとする。
+    ASSERT_NE(nullptr, fp);
+    char buffer[64];
+
+    // Pre-Assert
+
+    // Act
+    const size_t actual_ret = mock_fread(__FILE__, __LINE__, __func__, buffer, 1, sizeof(buffer), fp);
+    const bool stream_error = ferror(fp) != 0;
+    fclose(fp);
+
+    // Assert
+    EXPECT_EQ(0U, actual_ret);
+    ASSERT_TRUE(stream_error);
+    const vector<CallSiteStats> stats = getCallStats("fread");
+    ASSERT_EQ(1U, stats.size());
+    EXPECT_EQ(1U, stats[0].errors); // [確認_異常系] - ferror が設定された不足はエラーとすること。
+}
+
+#endif // _WIN32
@@ -0,0 +1,228 @@
+#include <testfw.h>
+
+#include <cstdlib>
+#include <fstream>
+
+#ifndef _WIN32
+    #include <fcntl.h>
+    #include <sys/stat.h>
+#endif
+
+#ifndef _WIN32
+
+namespace
+{
+
+// バージョン付き (既定 / 非既定)・隠蔽 (hidden)・weak のシンボルを持つ fixture の SO のソース
+const char *const kFixtureSource = "__attribute__((visibility(\"hidden\"))) int hidden_helper(void) { return 3; }\n"
+                                   "int current_api(void) { return hidden_helper(); }\n"
+                                   "int compat_api_v1(void) { return 1; }\n"
+                                   "int compat_api_v2(void) { return 2; }\n"
+                                   "__asm__(\".symver compat_api_v1,compat_api@FIXTURE_1\");\n"
+                                   "__asm__(\".symver compat_api_v2,compat_api@@FIXTURE_2\");\n"
+                                   "__attribute__((weak)) int weak_hook(void) { return 4; }\n"
+                                   "int exported_data = 5;\n";
+
+const char *const kFixtureVersionScript =
+    "FIXTURE_1 { global: compat_api; current_api; weak_hook; exported_data; local: *; };\n"
+    "FIXTURE_2 { global: compat_api; } FIXTURE_1;\n";
+
+class exportCheckTest : public Test
+{
+  protected:
+    void SetUp() override
+    {
+        char dir_template[] = "/tmp/exportCheckTest.XXXXXX";
+        ASSERT_NE(nullptr, mkdtemp(dir_template));
+        work_dir_ = dir_template;
+    }
+
+    void TearDown() override
+    {
+        if (!work_dir_.empty())
+        {
+            startProcess("/bin/rm", {"-rf", work_dir_});
+        }
+    }
+
+    void writeFile(const string &name, const string &content)
+    {
+        std::ofstream out(work_dir_ + "/" + name, std::ios::binary);
+        out << content;
+    }
+
+    // cc で fixture の SO をビルドする (extra_api を指定すると、その名前の関数を FIXTURE_1 に追加する)。
+    // ビルドできない場合は空文字列を返し、呼び出し側でテストをスキップする。
+    string buildFixture(const string &extra_api = "")
+    {
+        string source = kFixtureSource;
+        string version_script = kFixtureVersionScript;
+        if (!extra_api.empty())
+        {
+            source += "int " + extra_api + "(void) { return 0; }\n";
+            version_script.insert(version_script.find("local:"), extra_api + "; ");
+        }
+        writeFile("fixture.c", source);
+        writeFile("fixture.map", version_script);
+        const string so_path = work_dir_ + "/libfixture.so";
+        ProcessResult res =
+            startProcess("/bin/sh", {"-c", "cc -shared -fPIC -Wl,--version-script=" + work_dir_ + "/fixture.map -o " +
+                                               so_path + " " + work_dir_ + "/fixture.c"});
+        if (res.exit_code != 0)
+        {
+            return "";
+        }
+        return so_path;
+    }
+
+    string work_dir_;
+};
+
+const ExportSymbolInfo *findSymbol(const vector<ExportSymbolInfo> &details, const string &name, const string &version)
+{
+    for (const auto &info : details)
+    {
+        if (info.name == name && info.version == version)
+        {
+            return &info;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace
+
+// バージョン付き・隠蔽・weak のシンボルを .dynsym から読み取り、名前からバージョンの接尾辞を除くことの確認
+TEST_F(exportCheckTest, reads_versioned_hidden_and_weak_symbols)
+{
+    // Arrange
+    const string so_path = buildFixture(); // [手順] - バージョン スクリプト付きで fixture の SO をビルドする。
+    if (so_path.empty())
+    {
+        GTEST_SKIP() << "cc で fixture の SO をビルドできませんでした";
+    }
+    vector<ExportSymbolInfo> details;
+
+    // Pre-Assert
+
+    // Act
+    const set<string> names = getActualExportNames(so_path, &details); // [手順] - エクスポート シンボルを取得する。
+
+    // Assert
+    const set<string> expected = {"FIXTURE_1", "FIXTURE_2", "compat_api", "current_api", "exported_data", "weak_hook"};
+    EXPECT_EQ(expected, names); // [確認_正常系] - 名前は "@@VER" / "@VER" を付けず、hidden のシンボルを含まないこと。
+
+    const ExportSymbolInfo *compat_v1 = findSymbol(details, "compat_api", "FIXTURE_1");
+    const ExportSymbolInfo *compat_v2 = findSymbol(details, "compat_api", "FIXTURE_2");
+    ASSERT_NE(nullptr, compat_v1);            // [確認_正常系] - 非既定バージョンの定義も details に含むこと。
+    ASSERT_NE(nullptr, compat_v2);            // [確認_正常系] - 既定バージョンの定義を details に含むこと。
+    EXPECT_FALSE(compat_v1->default_version); // [確認_正常系] - "compat_api@FIXTURE_1" は既定バージョンでないこと。
+    EXPECT_TRUE(compat_v2->default_version);  // [確認_正常系] - "compat_api@@FIXTURE_2" は既定バージョンであること。
+    EXPECT_EQ("FUNC", compat_v2->type);       // [確認_正常系] - 種別を読み取ること。
+
+    const ExportSymbolInfo *weak_hook = findSymbol(details, "weak_hook", "FIXTURE_1");
+    ASSERT_NE(nullptr, weak_hook);
+    EXPECT_EQ("WEAK", weak_hook->binding); // [確認_正常系] - weak のバインディングを読み取ること。
+
+    const ExportSymbolInfo *exported_data = findSymbol(details, "exported_data", "FIXTURE_1");
+    ASSERT_NE(nullptr, exported_data);
+    EXPECT_EQ("OBJECT", exported_data->type);    // [確認_正常系] - 変数の種別を読み取ること。
+    EXPECT_EQ(sizeof(int), exported_data->size); // [確認_正常系] - 変数のサイズを読み取ること。
+
+    const ExportSymbolInfo *version_node = findSymbol(details, "FIXTURE_2", "");
+    ASSERT_NE(nullptr, version_node); // [確認_正常系] - バージョン定義のシンボルはバージョンを付けないこと。
+}
+
+// verifyExportNames のキャッシュが、ファイルの属性の一致でヒットし、内容の変更で再読み取りすることの確認
+TEST_F(exportCheckTest, batch_cache_hits_and_misses)
+{
+    // Arrange
+    const string so_path = buildFixture();
+    if (so_path.empty())
+    {
+        GTEST_SKIP() << "cc で fixture の SO をビルドできませんでした";
+    }
+    ExportCheckTarget target;
+    target.dll_or_so_path = so_path;
+    target.expected = {"FIXTURE_1", "FIXTURE_2", "compat_api", "current_api", "exported_data", "weak_hook"};
+    clearExportNamesCache();
+
+    // Pre-Assert
+
+    // Act
+    const ExportCheckResult first = verifyExportNames({target})[0];  // [手順] - 初回の検査を行う。
+    const ExportCheckResult second = verifyExportNames({target})[0]; // [手順] - 変更せずに再度検査する。
+    const struct timespec times[2] = {{0, UTIME_NOW}, {0, UTIME_NOW}};
+    ASSERT_EQ(0, utimensat(AT_FDCWD, so_path.c_str(), times, 0)); // [手順] - 内容を変えずに更新日時のみ変更する。
+    const ExportCheckResult touched = verifyExportNames({target})[0];
+    ASSERT_FALSE(buildFixture("added_api").empty()); // [手順] - シンボルを追加して再ビルドする。
+    const ExportCheckResult rebuilt = verifyExportNames({target})[0];
+    clearExportNamesCache(); // [手順] - キャッシュを破棄する。
+    const ExportCheckResult cleared = verifyExportNames({target})[0];
+
+    // Assert
+    EXPECT_TRUE(first.ok);                                 // [確認_正常系] - 初回の検査が一致すること。
+    EXPECT_FALSE(first.cache_hit);                         // [確認_正常系] - 初回はキャッシュを利用しないこと。
+    EXPECT_TRUE(second.ok);                                // [確認_正常系] - 再検査が一致すること。
+    EXPECT_TRUE(second.cache_hit);                         // [確認_正常系] - 属性が同じ場合はキャッシュを利用すること。
+    EXPECT_TRUE(touched.cache_hit);                        // [確認_正常系] - 更新日時の変更はビルド ID で判定すること。
+    EXPECT_FALSE(rebuilt.cache_hit);                       // [確認_正常系] - 内容が変わった場合は再読み取りすること。
+    EXPECT_FALSE(cleared.cache_hit);                       // [確認_正常系] - キャッシュの破棄後は再読み取りすること。
+    EXPECT_EQ(vector<string>{"added_api"}, rebuilt.extra); // [確認_正常系] - 再読み取りした内容で判定すること。
+}
+
+// ヘッダーの字句解析が、コメント・文字列・関数・ブロック内の宣言を除外し、複数行の宣言を検出することの確認
+TEST_F(exportCheckTest, scanner_reports_undecorated_file_scope_variables)
+{
+    // Arrange
+    writeFile("api.h", "// extern int in_line_comment;\n"
+                       "/* extern int in_block_comment; */\n"
+                       "#define DECLARE extern int in_macro;\n"
+                       "static const char *kText = \"extern int in_string;\";\n"
+                       "extern int MYLIB_EXPORT decorated;\n"
+                       "extern int undecorated;\n"
+                       "extern const char *\n"
+                       "    multi_line;\n"
+                       "extern int function(int value);\n"
+                       "extern \"C\" {\n"
+                       "extern int in_extern_c;\n"
+                       "}\n"
+                       "struct Holder { extern int in_struct; };\n"); // [手順] - 宣言を含むヘッダーを作成する。
+
+    // Pre-Assert
+
+    // Act
+    const vector<string> actual = findUndecoratedExternVariables(work_dir_, "MYLIB_EXPORT");
+
+    // Assert
+    const string header = work_dir_ + "/api.h";
+    const vector<string> expected = {header + ": extern int undecorated;", header + ": extern const char * multi_line;",
+                                     header + ": extern int in_extern_c;"};
+    EXPECT_EQ(expected, actual); // [確認_正常系] - ファイル スコープの export マクロの無い変数宣言のみを検出すること。
+}
+
+// 数値の桁区切りの ' を文字リテラルの開始として扱わず、後続の宣言を検出することの確認
+TEST_F(exportCheckTest, scanner_treats_digit_separator_as_part_of_number)
+{
+    // Arrange
+    writeFile("limits.h", "constexpr int kLimit = 1'000'000; extern int after_separator;\n"
+                          "constexpr unsigned kMask = 0xff'ff; extern int after_hex_separator;\n"
+                          "static const char kQuote = '\"'; extern int after_char_literal;\n"
+                          "static const wchar_t kWideQuote = L'\"'; extern int after_wide_char_literal;\n");
+    // [手順] - 桁区切りと文字リテラルの後に、同じ行で宣言するヘッダーを作成する。
+
+    // Pre-Assert
+
+    // Act
+    const vector<string> actual = findUndecoratedExternVariables(work_dir_, "MYLIB_EXPORT");
+
+    // Assert
+    const string header = work_dir_ + "/limits.h";
+    const vector<string> expected = {header + ": extern int after_separator;",
+                                     header + ": extern int after_hex_separator;",
+                                     header + ": extern int after_char_literal;",
+                                     header + ": extern int after_wide_char_literal;"};
+    EXPECT_EQ(expected, actual); // [確認_正常系] - 桁区切りの後も行の残りを字句解析すること。
+}
+
+#endif // _WIN32
@@ -0,0 +1,120 @@
+#include <testfw.h>
+#include <gtest/gtest-spi.h>
+#include <mock_stdlib.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <thread>
+
+namespace
+{
+
+// 2 個のスレッドで同時に FaultInjection を生成し、登録された (呼び出しを数えた) FaultInjection の数を返す。
+int createFaultInjectionsConcurrently()
+{
+    std::atomic<bool> start{false};
+    std::atomic<bool> checked{false};
+    std::atomic<int> created{0};
+    FaultInjection *fault_injections[2] = {nullptr, nullptr};
+    auto create = [&](int index) {
+        while (!start)
+        {
+            std::this_thread::yield();
+        }
+        FaultInjection fault_injection;
+        fault_injections[index] = &fault_injection;
+        ++created;
+        // 両方の FaultInjection が生存している間に判定する
+        while (!checked)
+        {
+            std::this_thread::yield();
+        }
+    };
+    std::thread first(create, 0);
+    std::thread second(create, 1);
+    start = true;
+    while (created < 2)
+    {
+        std::this_thread::yield();
+    }
+    (void)shouldInjectFault(FAULT_MALLOC, 1U);
+    int installed = 0;
+    for (FaultInjection *fault_injection : fault_injections)
+    {
+        if (fault_injection->callCount("malloc") == 1U)
+        {
+            ++installed;
+        }
+    }
+    checked = true;
+    first.join();
+    second.join();
+    return installed;
+}
+
+} // namespace
+
+// calloc の累積バイト数の規則を、要素数と要素サイズの積で判定することの確認
+TEST(faultInjectionTest, calloc_bytes_rule_matches_requested_size)
+{
+    // Arrange
+    FaultInjection fault_injection;
+    fault_injection.failAfterBytes("calloc", 1000, ENOMEM); // [手順] - 累積 1000 バイトを超えたら失敗させる。
+
+    // Pre-Assert
+
+    // Act
+    void *within = mock_calloc(__FILE__, __LINE__, __func__, 10, 50); // [手順] - 累積 500 バイトを要求する。
+    errno = 0;
+    void *over = mock_calloc(__FILE__, __LINE__, __func__, 10, 60); // [手順] - 累積 1100 バイトを要求する。
+    const int over_errno = errno;
+    mock_free(__FILE__, __LINE__, __func__, within);
+    mock_free(__FILE__, __LINE__, __func__, over);
+
+    // Assert
+    EXPECT_NE(nullptr, within);    // [確認_正常系] - 閾値以下の要求は失敗させないこと。
+    EXPECT_EQ(nullptr, over);      // [確認_正常系] - 閾値を超えた要求を失敗させること。
+    EXPECT_EQ(ENOMEM, over_errno); // [確認_正常系] - 規則の errno を設定すること。
+    ASSERT_EQ(1U, fault_injection.injectedFaults().size());
+    EXPECT_EQ(2U, fault_injection.injectedFaults()[0].call_index); // [確認_正常系] - 2 回目の呼び出しを記録すること。
+}
+
+// 乗算が桁あふれする calloc の要求サイズを、小さな値に戻さず上限として判定することの確認
+TEST(faultInjectionTest, calloc_overflowing_size_saturates)
+{
+    // Arrange
+    FaultInjection fault_injection;
+    fault_injection.failAfterBytes("calloc", 1024 * 1024, ENOMEM);
+    const size_t nmemb = (SIZE_MAX >> 1) + 1U; // [手順] - 要素サイズ 2 との積が 0 に桁あふれする要素数とする。
+
+    // Pre-Assert
+
+    // Act
+    void *actual = mock_calloc(__FILE__, __LINE__, __func__, nmemb, 2);
+    void *after = mock_calloc(__FILE__, __LINE__, __func__, 1, 1); // [手順] - 続けて小さな要求をする。
+    mock_free(__FILE__, __LINE__, __func__, after);
+
+    // Assert
+    EXPECT_EQ(nullptr, actual);                             // [確認_正常系] - 桁あふれする要求を失敗させること。
+    ASSERT_EQ(2U, fault_injection.injectedFaults().size()); // [確認_正常系] - 本物でなく規則で失敗させること。
+    EXPECT_EQ(nullptr, after); // [確認_正常系] - 累積バイト数が上限で飽和し、0 付近に戻らないこと。
+}
+
+// FaultInjection を同時に生成した場合に 1 個のみが有効になり、他を失敗として報告することの確認
+TEST(faultInjectionTest, concurrent_fault_injection_has_one_winner)
+{
+    // Arrange
+    int installed = 0;
+
+    // Pre-Assert
+
+    // Act
+    EXPECT_NONFATAL_FAILURE_ON_ALL_THREADS(installed = createFaultInjectionsConcurrently(),
+                                           "Only one FaultInjection may exist at a time.");
+    // [手順] - 2 個のスレッドで同時に FaultInjection を生成する。
+
+    // Assert
+    EXPECT_EQ(1, installed);                           // [確認_異常系] - 1 個のみが登録されること。
+    EXPECT_FALSE(shouldInjectFault(FAULT_MALLOC, 1U)); // [確認_正常系] - 両方の破棄後は障害を注入しないこと。
+}
@@ -0,0 +1,95 @@
+#include <testfw.h>
+#include <gtest/gtest-spi.h>
+#include <mock_stdlib.h>
+
+#ifndef _WIN32
+
+// 確保の末尾を超える書き込みを SIGSEGV とし、確保元を出力することの確認
+TEST(guardedAllocationTest, overrun_is_reported_with_allocation_site)
+{
+    // Arrange
+
+    // Pre-Assert
+
+    // Act & Assert
+    EXPECT_DEATH(
+        {
+            GuardedAllocation guarded("*", 1); // [手順] - 1 バイトの超過も検出する境界とする。
+            char *ptr = static_cast<char *>(mock_malloc(__FILE__, __LINE__, __func__, 32));
+            ptr[32] = 'x'; // [手順] - 確保の直後に書き込む。
+        },
+        // [確認_異常系] - 確保元を出力すること。
+        "past the end of the 32-byte block allocated at .*guardedAllocationTest.cc");
+}
+
+// 解放後の読み込みを SIGSEGV とし、確保元と解放元を出力することの確認
+TEST(guardedAllocationTest, use_after_free_is_reported_with_free_site)
+{
+    // Arrange
+
+    // Pre-Assert
+
+    // Act & Assert
+    EXPECT_DEATH(
+        {
+            GuardedAllocation guarded;
+            char *ptr = static_cast<char *>(mock_malloc(__FILE__, __LINE__, __func__, 16));
+            mock_free(__FILE__, __LINE__, __func__, ptr);
+            volatile char value = ptr[0]; // [手順] - 解放した領域を読み込む。
+            (void)value;
+        },
+        // [確認_異常系] - 解放元を出力すること。
+        "use after free of the 16-byte block .* freed at .*guardedAllocationTest.cc");
+}
+
+// 保持中の領域の二重解放をテストの失敗として検出し、数えることの確認
+TEST(guardedAllocationTest, double_free_fails_the_test)
+{
+    // Arrange
+    GuardedAllocation guarded;
+    void *ptr = mock_malloc(__FILE__, __LINE__, __func__, 24);
+    ASSERT_NE(nullptr, ptr);
+    mock_free(__FILE__, __LINE__, __func__, ptr);
+    const GuardedAllocationStats before = getGuardedAllocationStats();
+
+    // Pre-Assert
+    EXPECT_LE(1U, before.quarantined); // [確認_正常系] - 解放した領域を保持すること。
+
+    // Act
+    EXPECT_NONFATAL_FAILURE(mock_free(__FILE__, __LINE__, __func__, ptr),
+                            "-byte block allocated at"); // [手順] - 同じ領域を再度解放する。
+
+    // Assert
+    const GuardedAllocationStats after = getGuardedAllocationStats();
+    EXPECT_EQ(before.invalid_frees + 1U, after.invalid_frees); // [確認_異常系] - 二重解放を数えること。
+}
+
+// Mock_stdlib の生存中も、既定の動作の realloc / free がガード ページ付きの領域を受け付けることの確認
+TEST(guardedAllocationTest, guarded_blocks_are_handled_while_mock_stdlib_is_alive)
+{
+    // Arrange
+    GuardedAllocation guarded;
+    char *ptr = static_cast<char *>(mock_malloc(__FILE__, __LINE__, __func__, 16));
+    ASSERT_NE(nullptr, ptr);
+    strcpy(ptr, "guarded");
+    NiceMock<Mock_stdlib> mock_stdlib; // [手順] - getenv のみを設定した Mock_stdlib を生成する。
+    ON_CALL(mock_stdlib, getenv(_, _, _, _)).WillByDefault(Return(nullptr));
+    const GuardedAllocationStats before = getGuardedAllocationStats();
+
+    // Pre-Assert
+
+    // Act
+    char *resized = static_cast<char *>(mock_realloc(__FILE__, __LINE__, __func__, ptr, 64));
+    ASSERT_NE(nullptr, resized);
+    const string content = resized;
+    mock_free(__FILE__, __LINE__, __func__, resized); // [手順] - ガード ページ付きの領域を解放する。
+
+    // Assert
+    const GuardedAllocationStats after = getGuardedAllocationStats();
+    EXPECT_EQ("guarded", content);                         // [確認_正常系] - 内容を引き継いで確保し直すこと。
+    EXPECT_EQ(before.allocations + 1U, after.allocations); // [確認_正常系] - realloc もガード ページ付きとすること。
+    EXPECT_EQ(before.live - 1U, after.live);               // [確認_正常系] - 解放を受け付けること。
+    EXPECT_EQ(before.invalid_frees, after.invalid_frees);
+}
+
+#endif // _WIN32
@@ -1,6 +1,9 @@
 # framework 配下のテストには app/makepart.mk が適用されないため、Google Test のリンクを明示する。
 LINK_TEST = 1
 
+# MockSlot のメソッド単位の委譲を Mock_stdlib で確認するため、mock_libc をリンクする。
+LIBS += mock_libc
+
 ifdef PLATFORM_LINUX
     LIBSDIR += $(TESTFW_HOME)/lib/$(TARGET_ARCH)
 else ifdef PLATFORM_WINDOWS
@@ -1,5 +1,13 @@
 #include <testfw.h>
 #include <gtest/gtest-spi.h>
+#include <mock_stdlib.h>
+
+#include "mock_add1.h"
+
+#include <atomic>
+#include <future>
+#include <memory>
+#include <thread>
 
 namespace
 {
@@ -21,6 +29,62 @@ class Mock_testfw
     }
 };
 
+class Mock_testfw_slot;
+testfw::MockSlot<Mock_testfw_slot> s_mock_testfw_slot;
+
+class Mock_testfw_slot
+{
+  public:
+    Mock_testfw_slot()
+    {
+        TESTFW_REGISTER_MOCK_INSTANCE(s_mock_testfw_slot);
+    }
+
+    ~Mock_testfw_slot()
+    {
+        TESTFW_UNREGISTER_MOCK_INSTANCE(s_mock_testfw_slot);
+    }
+};
+
+testfw::FakeSlot<int(int)> s_fake_testfw;
+using Fake_testfw = testfw::FakeFunction<int(int), s_fake_testfw>;
+
+int twice(int value)
+{
+    return value * 2;
+}
+
+// 2 個のスレッドで同時に Fake_testfw を生成し、登録された fake の数を返す。
+int installFakesConcurrently()
+{
+    std::atomic<bool> start{false};
+    std::atomic<int> checked{0};
+    std::atomic<int> installed{0};
+    auto install = [&]() {
+        while (!start)
+        {
+            std::this_thread::yield();
+        }
+        Fake_testfw fake_testfw(twice);
+        if (s_fake_testfw.get() == &fake_testfw)
+        {
+            ++installed;
+        }
+        // 両方の fake が生存している間に判定する
+        ++checked;
+        while (checked < 2)
+        {
+            std::this_thread::yield();
+        }
+    };
+    std::thread first(install);
+    std::thread second(install);
+    start = true;
+    first.join();
+    second.join();
+    return installed;
+}
+
 } // namespace
 
 // 同じクラスの mock を同時に生成した場合にテストが失敗し、最初の注入が維持されることの確認
@@ -64,3 +128,249 @@ TEST(mockInstanceTest, allows_sequential_instances)
     EXPECT_EQ(&second_mock_testfw,
               s_mock_testfw); // [確認_正常系] - 1 個目の破棄後は 2 個目の Mock_testfw が注入されること。
 }
+
+// MockSlot は mock の生存中のみ lock() でガードを返すことの確認
+TEST(mockInstanceTest, slot_lock_follows_lifetime)
+{
+    // Arrange
+    EXPECT_FALSE(s_mock_testfw_slot.lock()); // [状態確認] - mock 生成前は空のガードが返ること。
+    const Mock_testfw_slot *created_mock_testfw_slot = nullptr;
+    const Mock_testfw_slot *locked_while_alive = nullptr;
+
+    // Pre-Assert
+
+    // Act
+    {
+        Mock_testfw_slot mock_testfw_slot;
+        created_mock_testfw_slot = &mock_testfw_slot;
+        locked_while_alive = s_mock_testfw_slot.lock().get(); // [手順] - mock の生存中にガードを取得する。
+    } // [手順] - mock を破棄する。
+
+    // Assert
+    EXPECT_EQ(created_mock_testfw_slot, locked_while_alive); // [確認_正常系] - 生存中はガードが mock を指すこと。
+    EXPECT_FALSE(s_mock_testfw_slot.lock());                 // [確認_正常系] - mock 破棄後は空のガードが返ること。
+}
+
+// mock の破棄が、別スレッドで lock() 済みの呼び出しの完了を待つことの確認
+TEST(mockInstanceTest, slot_retire_waits_for_in_flight_call)
+{
+    // Arrange
+    std::promise<void> locked;
+    std::promise<void> release;
+    std::shared_future<void> release_future = release.get_future().share();
+    std::atomic<bool> call_finished{false};
+    bool finished_before_destroyed = false;
+    auto mock_testfw_slot = std::make_unique<Mock_testfw_slot>();
+    std::thread caller([&]() {
+        auto locked_testfw_slot = s_mock_testfw_slot.lock(); // [手順] - 別スレッドで mock 呼び出しを開始する。
+        locked.set_value();
+        release_future.wait();
+        call_finished = true;
+    });
+    locked.get_future().wait();
+
+    // Pre-Assert
+
+    // Act
+    std::future<void> destroyed = std::async(std::launch::async, [&]() {
+        mock_testfw_slot.reset(); // [手順] - 呼び出し中に別スレッドで mock を破棄する。
+        finished_before_destroyed = call_finished;
+    });
+    const std::future_status status_while_calling = destroyed.wait_for(std::chrono::milliseconds(200));
+    release.set_value(); // [手順] - 破棄が待機していることを確認した後に呼び出しを完了させる。
+    destroyed.wait();
+    caller.join();
+
+    // Assert
+    EXPECT_EQ(std::future_status::timeout, status_while_calling); // [確認_正常系] - 呼び出し中は破棄が完了しないこと。
+    EXPECT_TRUE(finished_before_destroyed);                       // [確認_正常系] - 呼び出しの完了後に破棄されること。
+    EXPECT_FALSE(s_mock_testfw_slot.lock());                      // [確認_正常系] - 破棄後は空のガードが返ること。
+}
+
+// fake は生存中のみ呼び出しを受け、呼び出し回数と引数を記録することの確認
+TEST(mockInstanceTest, fake_records_calls_while_installed)
+{
+    // Arrange
+    int actual_ret_first = 0;
+    int actual_ret_second = 0;
+    uint64_t call_count = 0;
+    uint64_t dropped_count = 0;
+    vector<Fake_testfw::Call> calls;
+
+    // Pre-Assert
+
+    // Act
+    {
+        Fake_testfw fake_testfw(twice, 1);
+        auto locked_fake = s_fake_testfw.lock();
+        actual_ret_first = locked_fake->call(__FILE__, __LINE__, __func__, 3); // [手順] - 関数ポインターへ委譲する。
+        fake_testfw.setFunction([](int value) { return value + 1; });          // [手順] - 関数ポインターを差し替える。
+        actual_ret_second = locked_fake->call(__FILE__, __LINE__, __func__, 5);
+        call_count = fake_testfw.callCount();
+        dropped_count = fake_testfw.droppedCount();
+        calls = fake_testfw.calls();
+    } // [手順] - fake を破棄する。
+
+    // Assert
+    EXPECT_EQ(6, actual_ret_first);           // [確認_正常系] - 登録した関数の戻り値が返ること。
+    EXPECT_EQ(6, actual_ret_second);          // [確認_正常系] - 差し替えた関数の戻り値が返ること。
+    EXPECT_EQ(2U, call_count);                // [確認_正常系] - 呼び出し回数が計数されること。
+    EXPECT_EQ(1U, dropped_count);             // [確認_正常系] - 記録数を超えた呼び出しが計数されること。
+    ASSERT_EQ(1U, calls.size());              // [確認_正常系] - 記録数までの呼び出しが記録されること。
+    EXPECT_EQ(3, std::get<0>(calls[0].args)); // [確認_正常系] - 引数が記録されること。
+    EXPECT_FALSE(s_fake_testfw.lock());       // [確認_正常系] - fake 破棄後は呼び出しを受けないこと。
+}
+
+// setFunction(nullptr) が、関数ポインターで生成した fake の委譲先を生成時の関数へ戻すことの確認
+TEST(mockInstanceTest, fake_set_function_nullptr_restores_initial_function)
+{
+    // Arrange
+    Fake_testfw fake_testfw(twice);
+    auto locked_fake = s_fake_testfw.lock();
+    fake_testfw.setFunction([](int value) { return value + 1; }); // [手順] - 委譲先を差し替える。
+
+    // Pre-Assert
+    EXPECT_EQ(4, locked_fake->call(__FILE__, __LINE__, __func__, 3));
+
+    // Act
+    fake_testfw.setFunction(nullptr); // [手順] - nullptr を指定する。
+    const int actual_ret = locked_fake->call(__FILE__, __LINE__, __func__, 3);
+
+    // Assert
+    EXPECT_EQ(6, actual_ret); // [確認_正常系] - 生成時の関数へ委譲すること。
+    EXPECT_EQ(2U, fake_testfw.callCount());
+}
+
+// 同時に生成した fake は 1 個のみが登録され、もう 1 個は失敗として報告されることの確認
+TEST(mockInstanceTest, concurrent_fake_install_has_one_winner)
+{
+    // Arrange
+    int installed = 0;
+
+    // Pre-Assert
+
+    // Act
+    EXPECT_NONFATAL_FAILURE_ON_ALL_THREADS(installed = installFakesConcurrently(),
+                                           "Only one fake may be installed for the same function at a time.");
+    // [手順] - 2 個のスレッドで同時に fake を生成する。
+
+    // Assert
+    EXPECT_EQ(1, installed);            // [確認_異常系] - 1 個のみが登録されること。
+    EXPECT_FALSE(s_fake_testfw.lock()); // [確認_正常系] - 両方の破棄後は呼び出しを受けないこと。
+}
+
+// 既定では設定していないメソッドも gmock を経由し、StrictMock が未設定の呼び出しを検出することの確認
+TEST(mockInstanceTest, strict_mock_sees_unconfigured_methods_by_default)
+{
+    // Arrange
+    StrictMock<Mock_stdlib> mock_stdlib;
+    void *ptr = nullptr;
+
+    // Pre-Assert
+
+    // Act
+    EXPECT_NONFATAL_FAILURE(ptr = mock_malloc(__FILE__, __LINE__, __func__, 16),
+                            "Uninteresting mock function call"); // [手順] - 設定していない malloc を呼び出す。
+    delegate_real_free(__FILE__, __LINE__, __func__, ptr);
+
+    // Assert
+    EXPECT_TRUE(_mock_stdlib.lock(Mock_stdlib::METHOD_malloc)); // [確認_正常系] - malloc が gmock 経由であること。
+}
+
+// bypass_unconfigured_methods() の後は、設定していない malloc は gmock を経由せず、設定した malloc は経由することの確認
+TEST(mockInstanceTest, bypass_routes_only_configured_methods)
+{
+    // Arrange
+    char marker[16];
+    void *untouched_ret = nullptr;
+    void *configured_ret = nullptr;
+    bool untouched_intercepted = true;
+
+    // Pre-Assert
+
+    // Act
+    {
+        Mock_stdlib mock_stdlib;
+        mock_stdlib.bypass_unconfigured_methods(); // [手順] - 設定していないメソッドを本物へ委譲する。
+        untouched_intercepted = static_cast<bool>(_mock_stdlib.lock(Mock_stdlib::METHOD_malloc));
+        untouched_ret = mock_malloc(__FILE__, __LINE__, __func__, 16); // [手順] - 設定していない malloc を呼び出す。
+        mock_free(__FILE__, __LINE__, __func__, untouched_ret);
+
+        EXPECT_CALL(mock_stdlib, malloc(_, _, _, 16)).WillOnce(Return(marker)); // [手順] - malloc を設定する。
+        configured_ret = mock_malloc(__FILE__, __LINE__, __func__, 16);
+    }
+
+    // Assert
+    EXPECT_FALSE(untouched_intercepted); // [確認_正常系] - 設定していない malloc は gmock を経由しないこと。
+    EXPECT_NE(nullptr, untouched_ret);   // [確認_正常系] - 設定していない malloc は本物が確保すること。
+    EXPECT_EQ(marker, configured_ret);   // [確認_正常系] - EXPECT_CALL した malloc は gmock を経由すること。
+}
+
+// 多重生成で登録されなかった mock の ON_CALL が、登録中の mock のメソッドを gmock 経由にしないことの確認
+TEST(mockInstanceTest, rejected_instance_does_not_mark_methods)
+{
+    // Arrange
+    Mock_stdlib mock_stdlib;
+    mock_stdlib.bypass_unconfigured_methods();
+
+    // Pre-Assert
+    ASSERT_FALSE(_mock_stdlib.lock(Mock_stdlib::METHOD_getenv));
+
+    // Act
+    EXPECT_NONFATAL_FAILURE(
+        {
+            Mock_stdlib duplicate_mock_stdlib;
+            ON_CALL(duplicate_mock_stdlib, getenv(_, _, _, _)).WillByDefault(Return(nullptr)); // [手順] - 設定する。
+        },
+        "Only one mock instance may exist for _mock_stdlib at a time."); // [手順] - 2 個目の Mock_stdlib を生成する。
+
+    // Assert
+    EXPECT_EQ(&mock_stdlib, _mock_stdlib.get());                 // [確認_異常系] - 最初の mock が登録中であること。
+    EXPECT_FALSE(_mock_stdlib.lock(Mock_stdlib::METHOD_getenv)); // [確認_異常系] - getenv は gmock 経由でないこと。
+    EXPECT_FALSE(_mock_stdlib.lock(Mock_stdlib::METHOD_malloc)); // [確認_異常系] - 既定の ON_CALL も記録しないこと。
+}
+
+// FAST_C_METHOD の関数が、mock の生存中のみ gmock を経由し、それ以外はデフォルトのラムダ式を呼び出すことの確認
+TEST(mockInstanceTest, fast_method_dispatches_only_while_mocked)
+{
+    // Arrange
+    int mocked_ret = 0;
+
+    // Pre-Assert
+    ASSERT_EQ(2, add1(1)); // [確認_正常系] - mock の生成前はデフォルトのラムダ式を呼び出すこと。
+
+    // Act
+    {
+        Mock_add1 mock_add1;
+        EXPECT_CALL(mock_add1, add1(1)).WillOnce(Return(100));
+        mocked_ret = add1(1); // [手順] - mock の生存中に呼び出す。
+    }
+    const int unmocked_ret = add1(1); // [手順] - mock の破棄後に呼び出す。
+
+    // Assert
+    EXPECT_EQ(100, mocked_ret); // [確認_正常系] - mock の生存中は gmock を経由すること。
+    EXPECT_EQ(2, unmocked_ret); // [確認_正常系] - mock の破棄後はデフォルトのラムダ式に戻ること。
+}
+
+// 多重生成で登録されなかった FAST_C_METHOD の mock の生成と破棄が、登録中の mock への振り分けを変えないことの確認
+TEST(mockInstanceTest, fast_method_keeps_dispatch_after_rejected_duplicate)
+{
+    // Arrange
+    Mock_add1 mock_add1;
+    EXPECT_CALL(mock_add1, add1(1)).WillRepeatedly(Return(100));
+
+    // Pre-Assert
+    ASSERT_EQ(100, add1(1));
+
+    // Act
+    EXPECT_NONFATAL_FAILURE(
+        {
+            Mock_add1 duplicate_mock_add1;
+            (void)duplicate_mock_add1;
+        },
+        "Only one mock instance may exist for _mock_add1 at a time."); // [手順] - 2 個目を生成して破棄する。
+    const int actual_ret = add1(1);
+
+    // Assert
+    EXPECT_EQ(100, actual_ret); // [確認_異常系] - 重複の破棄後も登録中の mock を経由すること。
+}
@@ -0,0 +1,3 @@
+// mock_add1.h の Mock_add1 クラスと add1 関数を定義する
+#define _IN_MOCK_FACTORY_SRC_
+#include "mock_add1.h"
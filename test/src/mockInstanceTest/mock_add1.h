@@ -0,0 +1,13 @@
+#ifndef _MOCK_ADD1_H
+#define _MOCK_ADD1_H
+
+// FAST_C_METHOD の確認に使用する mock 対象の関数
+extern int add1(int value);
+
+#include <mock_factory_head.h>
+
+FAST_C_METHOD(int, add1, int, [](int value) { return value + 1; });
+
+#include <mock_factory_tail.h>
+
+#endif // _MOCK_ADD1_H
@@ -0,0 +1,145 @@
+#include <testfw.h>
+#include <mock_unistd.h>
+#include <sys/mock_socket.h>
+
+#include <cerrno>
+#include <cstring>
+
+#ifndef _WIN32
+    #include <arpa/inet.h>
+    #include <netinet/in.h>
+#endif
+
+#ifndef _WIN32
+
+namespace
+{
+
+struct sockaddr_in loopback(uint16_t port)
+{
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    return address;
+}
+
+// port に bind した UDP のソケット (port が 0 の場合は bind しない)
+int udpSocket(uint16_t port)
+{
+    const int fd = mock_socket(__FILE__, __LINE__, __func__, AF_INET, SOCK_DGRAM, 0);
+    if (fd >= 0 && port != 0U)
+    {
+        const struct sockaddr_in address = loopback(port);
+        (void)mock_bind(__FILE__, __LINE__, __func__, fd, reinterpret_cast<const struct sockaddr *>(&address),
+                        sizeof(address));
+    }
+    return fd;
+}
+
+ssize_t sendTo(int fd, const char *data, uint16_t port)
+{
+    const struct sockaddr_in address = loopback(port);
+    return mock_sendto(__FILE__, __LINE__, __func__, fd, data, strlen(data), 0,
+                       reinterpret_cast<const struct sockaddr *>(&address), sizeof(address));
+}
+
+string receive(int fd)
+{
+    char buffer[16];
+    const ssize_t received =
+        mock_recvfrom(__FILE__, __LINE__, __func__, fd, buffer, sizeof(buffer), 0, nullptr, nullptr);
+    return received < 0 ? string() : string(buffer, (size_t)received);
+}
+
+} // namespace
+
+// 損失の確率が 1 の規則に一致するデータグラムを、送信は成功させて破棄することの確認
+TEST(networkImpairmentTest, drop_datagrams_discards_matching_sends)
+{
+    // Arrange
+    VirtualNetwork network;
+    NetworkImpairment impairment;
+    impairment.dropDatagrams("127.0.0.1:5353", 1.0); // [手順] - 5353 番宛てをすべて破棄する。
+    const int receiver = udpSocket(5353);
+    const int sender = udpSocket(0);
+    ASSERT_LE(0, receiver);
+    ASSERT_LE(0, sender);
+
+    // Pre-Assert
+
+    // Act
+    const ssize_t send_ret = sendTo(sender, "lost", 5353);
+    mock_close(__FILE__, __LINE__, __func__, sender);
+    mock_close(__FILE__, __LINE__, __func__, receiver);
+
+    // Assert
+    EXPECT_EQ(4, send_ret);                              // [確認_正常系] - 送信は成功とすること。
+    EXPECT_EQ(1U, impairment.stats().dropped_datagrams); // [確認_正常系] - 破棄した数を数えること。
+    EXPECT_EQ(0U, network.stats().datagrams);            // [確認_正常系] - 宛先に配送しないこと。
+}
+
+// 遅延の規則に一致する送信を、VirtualClock の仮想時刻で遅延させることの確認
+TEST(networkImpairmentTest, latency_delays_send_in_virtual_time)
+{
+    // Arrange
+    VirtualClock clock;
+    VirtualNetwork network;
+    NetworkImpairment impairment;
+    impairment.addLatency("127.0.0.1:5353", chrono::milliseconds(40)); // [手順] - 40 ms の遅延を設定する。
+    const int receiver = udpSocket(5353);
+    const int sender = udpSocket(0);
+    ASSERT_LE(0, receiver);
+    ASSERT_LE(0, sender);
+
+    // Pre-Assert
+
+    // Act
+    const ssize_t send_ret = sendTo(sender, "late", 5353);
+    const chrono::nanoseconds elapsed = clock.elapsed();
+    const string received = receive(receiver);
+    mock_close(__FILE__, __LINE__, __func__, sender);
+    mock_close(__FILE__, __LINE__, __func__, receiver);
+
+    // Assert
+    EXPECT_EQ(4, send_ret);
+    EXPECT_EQ("late", received);                  // [確認_正常系] - 遅延後に配送すること。
+    EXPECT_EQ(chrono::milliseconds(40), elapsed); // [確認_正常系] - 仮想時刻で遅延すること。
+    EXPECT_EQ(1U, impairment.stats().delayed_calls);
+    EXPECT_EQ(chrono::nanoseconds(chrono::milliseconds(40)), impairment.stats().total_delay);
+}
+
+// 障害注入で失敗させた close は、入れ替えのため保持しているデータグラムを破棄しないことの確認
+TEST(networkImpairmentTest, failed_close_keeps_held_datagram)
+{
+    // Arrange
+    VirtualNetwork network;
+    NetworkImpairment impairment;
+    impairment.reorderDatagrams("127.0.0.1:5353", 1.0); // [手順] - データグラムを次のデータグラムの後に送る。
+    const int receiver = udpSocket(5353);
+    const int sender = udpSocket(0);
+    ASSERT_LE(0, receiver);
+    ASSERT_LE(0, sender);
+    FaultInjection fault_injection;
+    fault_injection.failNthCall("close", 1, EIO); // [手順] - 最初の close を失敗させる。
+
+    // Pre-Assert
+
+    // Act
+    sendTo(sender, "first", 5353); // [手順] - 次の送信まで保持させる。
+    const int failed_close_ret = mock_close(__FILE__, __LINE__, __func__, sender);
+    sendTo(sender, "second", 5353);
+    const string first_received = receive(receiver);
+    const string second_received = receive(receiver);
+    mock_close(__FILE__, __LINE__, __func__, sender);
+    mock_close(__FILE__, __LINE__, __func__, receiver);
+
+    // Assert
+    EXPECT_EQ(-1, failed_close_ret);     // [確認_異常系] - close が失敗すること。
+    EXPECT_EQ("second", first_received); // [確認_正常系] - 後のデータグラムを先に配送すること。
+    EXPECT_EQ("first", second_received); // [確認_正常系] - 失敗した close の後も保持したデータグラムを送ること。
+    EXPECT_EQ(1U, impairment.stats().reordered_datagrams);
+}
+
+#endif // _WIN32
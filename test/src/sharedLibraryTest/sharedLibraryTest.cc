@@ -0,0 +1,219 @@
+#include <testfw.h>
+
+#include <fstream>
+#include <thread>
+
+#ifndef _WIN32
+    #include <unistd.h>
+#endif
+
+#ifndef _WIN32
+
+namespace
+{
+
+// ロード済みの libm / libc を使用する (テストの実行ファイルは libm / libc に依存する)
+const char *const kLibm = "libm.so.6";
+const char *const kLibc = "libc.so.6";
+
+const SharedLibraryStats *findStats(const vector<SharedLibraryStats> &stats, const string &lib_name)
+{
+    for (const auto &entry : stats)
+    {
+        if (entry.lib_name == lib_name)
+        {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+class sharedLibraryPreloadTest : public Test
+{
+  protected:
+    void SetUp() override
+    {
+        char dir_template[] = "/tmp/sharedLibraryTest.XXXXXX";
+        ASSERT_NE(nullptr, mkdtemp(dir_template));
+        work_dir_ = dir_template;
+    }
+
+    void TearDown() override
+    {
+        if (!work_dir_.empty())
+        {
+            startProcess("/bin/rm", {"-rf", work_dir_});
+        }
+    }
+
+    // cc で fixture の SO をビルドする。ビルドできない場合は空文字列を返し、呼び出し側でテストをスキップする。
+    string buildFixture()
+    {
+        {
+            std::ofstream out(work_dir_ + "/fixture.c", std::ios::binary);
+            out << "int fixture_add(int a, int b) { return a + b; }\n";
+        }
+        const string so_path = work_dir_ + "/libfixture.so";
+        ProcessResult res =
+            startProcess("/bin/sh", {"-c", "cc -shared -fPIC -o " + so_path + " " + work_dir_ + "/fixture.c"});
+        if (res.exit_code != 0)
+        {
+            return "";
+        }
+        return so_path;
+    }
+
+    string work_dir_;
+};
+
+} // namespace
+
+// 複数のスレッドから初回呼び出しをしても 1 度だけ解決し、以降は同じ関数ポインターを呼び出すことの確認
+TEST(sharedLibraryTest, shared_symbol_resolves_once_across_threads)
+{
+    // Arrange
+    SharedSymbol<double(double)> shared_cos(kLibm, "cos");
+    vector<double (*)(double)> resolved(8, nullptr);
+    vector<thread> threads;
+
+    // Pre-Assert
+
+    // Act
+    for (size_t i = 0; i < resolved.size(); ++i)
+    {
+        threads.emplace_back([&shared_cos, &resolved, i]() {
+            resolved[i] = shared_cos.get(); // [手順] - 各スレッドから同時に解決させる。
+        });
+    }
+    for (thread &worker : threads)
+    {
+        worker.join();
+    }
+    const double value = shared_cos(0.0);
+
+    // Assert
+    for (double (*fn)(double) : resolved)
+    {
+        EXPECT_EQ(resolved[0], fn); // [確認_正常系] - すべてのスレッドが同じ関数ポインターを得ること。
+    }
+    EXPECT_EQ(tryResolveSharedSymbol(kLibm, "cos").symbol, reinterpret_cast<void *>(resolved[0]));
+    EXPECT_EQ(1.0, value); // [確認_正常系] - 解決した関数を呼び出すこと。
+    EXPECT_EQ("cos", shared_cos.symbolName());
+}
+
+// 解決できないシンボルの初回呼び出しで、ライブラリ名とシンボル名を出力して終了することの確認
+TEST(sharedLibraryTest, shared_symbol_exits_when_symbol_is_missing)
+{
+    // Arrange
+    SharedSymbol<int(void)> missing(kLibm, "testfw_no_such_symbol");
+
+    // Pre-Assert
+
+    // Act & Assert
+    // [確認_異常系] - 終了コード 1 で終了し、ライブラリ名とシンボル名を出力すること。
+    EXPECT_EXIT(missing(), ExitedWithCode(1), "shared library resolve failed: libm.so.6!testfw_no_such_symbol");
+}
+
+// noexcept で宣言された関数 (glibc の getpid) の型を、マクロで検証・導出できることの確認
+TEST(sharedLibraryTest, macros_accept_noexcept_prototype)
+{
+    // Arrange
+    TESTFW_SHARED_SYMBOL_STATIC_ASSERT(getpid, pid_t(void)) // [確認_正常系] - noexcept の有無を比較しないこと。
+    auto shared_getpid = TESTFW_SHARED_SYMBOL(kLibc, getpid);
+
+    // Pre-Assert
+
+    // Act
+    const pid_t pid = shared_getpid();
+
+    // Assert
+    EXPECT_EQ(getpid(), pid); // [確認_正常系] - 宣言から導出した型で呼び出せること。
+    EXPECT_EQ("libc.so.6", shared_getpid.libName());
+    EXPECT_EQ("getpid", shared_getpid.symbolName()); // [確認_正常系] - 関数名をシンボル名とすること。
+}
+
+// 未ロードのライブラリを即時バインドでロードし、シンボルをまとめて解決して計測値に記録することの確認
+TEST_F(sharedLibraryPreloadTest, preload_binds_now_and_records_stats)
+{
+    // Arrange
+    const string so_path = buildFixture(); // [手順] - プロセスが未ロードの fixture の SO をビルドする。
+    if (so_path.empty())
+    {
+        GTEST_SKIP() << "cc で fixture の SO をビルドできませんでした";
+    }
+
+    // Pre-Assert
+    EXPECT_EQ(nullptr, findStats(getSharedLibraryStats(), so_path));
+
+    // Act
+    const SharedLibraryPreloadResult result =
+        preloadSharedLibrary(so_path, {"fixture_add", "fixture_missing"}, SHARED_LIBRARY_BIND_NOW);
+    const vector<SharedLibraryStats> stats = getSharedLibraryStats();
+
+    // Assert
+    EXPECT_TRUE(result.loaded);
+    EXPECT_TRUE(result.bind_now); // [確認_正常系] - 即時バインドでロードすること。
+    ASSERT_EQ(1U, result.symbols.count("fixture_add"));
+    EXPECT_EQ(tryResolveSharedSymbol(so_path, "fixture_add").symbol, result.symbols.at("fixture_add"));
+    EXPECT_EQ(vector<string>{"fixture_missing"}, result.missing); // [確認_異常系] - 解決できない名前を返すこと。
+    EXPECT_THAT(result.diagnostic, HasSubstr("fixture_missing: "));
+    const SharedLibraryStats *entry = findStats(stats, so_path);
+    ASSERT_NE(nullptr, entry);
+    EXPECT_TRUE(entry->bind_now);
+    EXPECT_EQ(1U, entry->symbol_count); // [確認_正常系] - 解決したシンボルのみを数えること。
+    EXPECT_LT(0U, entry->load_time_ns);
+    EXPECT_LE(entry->max_resolve_ns, entry->total_resolve_ns);
+}
+
+// プロセスがロード済みのライブラリは、即時バインドを指定しても bind_now を false とし、その旨を診断することの確認
+TEST_F(sharedLibraryPreloadTest, preload_reports_resident_library_as_lazy)
+{
+    // Arrange
+    const char *const lib_name = "libstdc++.so.6"; // [手順] - テストの実行ファイルが依存するライブラリとする。
+
+    // Pre-Assert
+    EXPECT_EQ(nullptr, findStats(getSharedLibraryStats(), lib_name));
+
+    // Act
+    const SharedLibraryPreloadResult result = preloadSharedLibrary(lib_name, {"__cxa_demangle"});
+    const SharedLibraryStats *entry = findStats(getSharedLibraryStats(), lib_name);
+
+    // Assert
+    EXPECT_TRUE(result.loaded);
+    EXPECT_FALSE(result.bind_now); // [確認_正常系] - ロード済みのライブラリは即時バインドとしないこと。
+    EXPECT_THAT(result.diagnostic, HasSubstr("already loaded")); // [確認_正常系] - その旨を診断すること。
+    EXPECT_EQ(1U, result.symbols.size());
+    EXPECT_TRUE(result.missing.empty());
+    ASSERT_NE(nullptr, entry);
+    EXPECT_FALSE(entry->bind_now);
+}
+
+// resetSharedLibraryStats が計測値のみを 0 とし、バインドの方式とシンボルのキャッシュを維持することの確認
+TEST_F(sharedLibraryPreloadTest, reset_clears_counters_and_keeps_cache)
+{
+    // Arrange
+    const string so_path = buildFixture();
+    if (so_path.empty())
+    {
+        GTEST_SKIP() << "cc で fixture の SO をビルドできませんでした";
+    }
+    const SharedLibraryPreloadResult first = preloadSharedLibrary(so_path, {"fixture_add"});
+    ASSERT_TRUE(first.bind_now);
+
+    // Pre-Assert
+
+    // Act
+    resetSharedLibraryStats(); // [手順] - 計測値をリセットする。
+    const SharedSymbolResult cached = tryResolveSharedSymbol(so_path, "fixture_add");
+    const SharedLibraryStats *entry = findStats(getSharedLibraryStats(), so_path);
+
+    // Assert
+    EXPECT_EQ(first.symbols.at("fixture_add"), cached.symbol); // [確認_正常系] - キャッシュを維持すること。
+    ASSERT_NE(nullptr, entry);
+    EXPECT_TRUE(entry->bind_now);       // [確認_正常系] - バインドの方式を維持すること。
+    EXPECT_EQ(0U, entry->load_time_ns); // [確認_正常系] - 計測値を 0 とすること。
+    EXPECT_EQ(0U, entry->symbol_count); // [確認_正常系] - キャッシュ ヒットは数えないこと。
+    EXPECT_EQ(0U, entry->total_resolve_ns);
+}
+
+#endif // _WIN32
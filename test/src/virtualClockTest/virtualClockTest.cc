@@ -0,0 +1,236 @@
+#include <testfw.h>
+#include <gtest/gtest-spi.h>
+#include <mock_pthread.h>
+#include <mock_time.h>
+#include <mock_unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <mutex>
+
+#ifndef _WIN32
+
+namespace
+{
+
+int64_t toNanoseconds(const struct timespec &value)
+{
+    return (int64_t)value.tv_sec * 1000000000 + value.tv_nsec;
+}
+
+// 1 秒のスリープを 10 回繰り返すスレッドの開始関数
+void *sleepTenTimes(void *arg)
+{
+    int *count = static_cast<int *>(arg);
+    for (int i = 0; i < 10; ++i)
+    {
+        mock_usleep(__FILE__, __LINE__, __func__, 1000000);
+        ++*count;
+    }
+    return nullptr;
+}
+
+// 指定した時間だけスリープし、起床した時刻を記録するスレッド
+struct Sleeper
+{
+    int64_t duration_ns;
+    size_t index;
+    std::mutex *mtx;
+    vector<pair<int64_t, size_t>> *woken; // (起床した経過時間, index)
+};
+
+void *sleepAndRecord(void *arg)
+{
+    const Sleeper *sleeper = static_cast<const Sleeper *>(arg);
+    const struct timespec duration = {(time_t)(sleeper->duration_ns / 1000000000), sleeper->duration_ns % 1000000000};
+    mock_nanosleep(__FILE__, __LINE__, __func__, &duration, nullptr);
+    std::lock_guard<std::mutex> lock(*sleeper->mtx);
+    sleeper->woken->emplace_back(getVirtualClock()->elapsed().count(), sleeper->index);
+    return nullptr;
+}
+
+// 名前を付け、停止を指示されるまで待機せずに実行を続けるスレッド
+void *spinUntilStopped(void *arg)
+{
+    std::atomic<int> *state = static_cast<std::atomic<int> *>(arg);
+    pthread_setname_np(pthread_self(), "spinner");
+    state->store(1);
+    while (state->load() != 2)
+    {
+    }
+    return nullptr;
+}
+
+} // namespace
+
+// スリープが実時間で待機せずに仮想時刻を進め、clock_gettime が仮想時刻を返すことの確認
+TEST(virtualClockTest, sleep_advances_virtual_time_without_waiting)
+{
+    // Arrange
+    VirtualClock clock({1000000, 0}); // [手順] - CLOCK_REALTIME の初期値を指定する。
+    const auto real_start = chrono::steady_clock::now();
+    const struct timespec five_seconds = {5, 0};
+    struct timespec realtime = {};
+    struct timespec monotonic_before = {};
+    struct timespec monotonic_after = {};
+
+    // Pre-Assert
+
+    // Act
+    mock_clock_gettime(__FILE__, __LINE__, __func__, CLOCK_MONOTONIC, &monotonic_before);
+    const int nanosleep_ret = mock_nanosleep(__FILE__, __LINE__, __func__, &five_seconds, nullptr);
+    const int usleep_ret = mock_usleep(__FILE__, __LINE__, __func__, 1500000);
+    mock_clock_gettime(__FILE__, __LINE__, __func__, CLOCK_REALTIME, &realtime);
+    mock_clock_gettime(__FILE__, __LINE__, __func__, CLOCK_MONOTONIC, &monotonic_after);
+    const auto real_elapsed = chrono::steady_clock::now() - real_start;
+
+    // Assert
+    EXPECT_EQ(0, nanosleep_ret);
+    EXPECT_EQ(0, usleep_ret);
+    EXPECT_EQ(chrono::milliseconds(6500), clock.elapsed()); // [確認_正常系] - スリープの合計だけ進めること。
+    EXPECT_EQ(1000006, realtime.tv_sec);                    // [確認_正常系] - 初期値に経過時間を加えること。
+    EXPECT_EQ(500000000, realtime.tv_nsec);
+    EXPECT_EQ(6500000000, toNanoseconds(monotonic_after) - toNanoseconds(monotonic_before));
+    EXPECT_GT(chrono::seconds(1), real_elapsed); // [確認_正常系] - 実時間で待機しないこと。
+}
+
+// setTime が指定したクロックのみを変更することの確認
+TEST(virtualClockTest, set_time_changes_only_the_given_clock)
+{
+    // Arrange
+    VirtualClock clock;
+    const struct timespec monotonic_before = clock.now(CLOCK_MONOTONIC);
+
+    // Pre-Assert
+
+    // Act
+    clock.setTime(CLOCK_REALTIME, {2000000000, 0}); // [手順] - CLOCK_REALTIME のみ時刻合わせする。
+    clock.advance(chrono::seconds(3));
+    const int64_t monotonic_elapsed = toNanoseconds(clock.now(CLOCK_MONOTONIC)) - toNanoseconds(monotonic_before);
+
+    // Assert
+    EXPECT_EQ(2000000003, clock.now(CLOCK_REALTIME).tv_sec);        // [確認_正常系] - 変更後の時刻から進むこと。
+    EXPECT_EQ(2000000003, clock.now(CLOCK_REALTIME_COARSE).tv_sec); // [確認_正常系] - _COARSE も同じ値とすること。
+    EXPECT_EQ(3000000000, monotonic_elapsed);                       // [確認_正常系] - 他のクロックは変更しないこと。
+}
+
+// 通知の無い pthread_cond_timedwait が、仮想時刻を期限まで進めて ETIMEDOUT を返すことの確認
+TEST(virtualClockTest, cond_timedwait_times_out_at_virtual_deadline)
+{
+    // Arrange
+    VirtualClock clock;
+    pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+    pthread_cond_t cond = PTHREAD_COND_INITIALIZER;
+    struct timespec abstime = clock.now(CLOCK_REALTIME);
+    abstime.tv_sec += 30; // [手順] - 30 秒後を期限とする。
+
+    // Pre-Assert
+
+    // Act
+    pthread_mutex_lock(&mutex);
+    const int wait_ret = mock_pthread_cond_timedwait(__FILE__, __LINE__, __func__, &cond, &mutex, &abstime);
+    pthread_mutex_unlock(&mutex);
+
+    // Assert
+    EXPECT_EQ(ETIMEDOUT, wait_ret);                  // [確認_正常系] - タイムアウトすること。
+    EXPECT_EQ(chrono::seconds(30), clock.elapsed()); // [確認_正常系] - 期限まで進めること。
+    EXPECT_EQ(0U, clock.pendingWaiters());           // [確認_正常系] - 待機を残さないこと。
+}
+
+// pthread_create で生成したスレッドのスリープを、runUntilIdle が終了まで進めることの確認
+TEST(virtualClockTest, run_until_idle_drives_created_thread)
+{
+    // Arrange
+    VirtualClock clock;
+    clock.attachCurrentThread(); // [手順] - runUntilIdle を呼び出すまで仮想時刻を進めない。
+    int count = 0;
+    pthread_t thread;
+
+    // Pre-Assert
+
+    // Act
+    ASSERT_EQ(0, mock_pthread_create(__FILE__, __LINE__, __func__, &thread, nullptr, sleepTenTimes, &count));
+    const size_t attached = clock.attachedThreads();
+    clock.runUntilIdle(); // [手順] - 待機が無くなるまで仮想時刻を進める。
+    mock_pthread_join(__FILE__, __LINE__, __func__, thread, nullptr);
+    clock.detachCurrentThread();
+
+    // Assert
+    EXPECT_EQ(2U, attached);                         // [確認_正常系] - 生成したスレッドを管理対象にすること。
+    EXPECT_EQ(10, count);                            // [確認_正常系] - すべてのスリープを終えること。
+    EXPECT_EQ(chrono::seconds(10), clock.elapsed()); // [確認_正常系] - スリープの合計だけ進めること。
+    EXPECT_EQ(0U, clock.attachedThreads());          // [確認_正常系] - 終了したスレッドを管理対象から外すこと。
+}
+
+// タイマー ホイールの段をまたぐ期限の待機を、advance が期限の順に起床させ、範囲外の期限を残すことの確認
+TEST(virtualClockTest, advance_wakes_wheel_timers_in_deadline_order)
+{
+    // Arrange
+    VirtualClock clock;
+    clock.attachCurrentThread(); // [手順] - advance を呼び出すまで仮想時刻を進めない。
+    const int64_t ms = 1000000;
+    const int64_t hour = 3600000 * ms;
+    const int64_t day = 24 * hour;
+    // [手順] - 1 段目から最上位の段を超える (約 3 日以上先) 期限まで、登録の順と異なる順の期限とする。
+    const int64_t durations[] = {hour, 1 * ms, 4 * day, 70 * ms, 6 * day, 5000 * ms, 64 * ms};
+    std::mutex mtx;
+    vector<pair<int64_t, size_t>> woken;
+    vector<Sleeper> sleepers;
+    for (size_t i = 0; i < sizeof(durations) / sizeof(durations[0]); ++i)
+    {
+        sleepers.push_back({durations[i], i, &mtx, &woken});
+    }
+    vector<pthread_t> threads(sleepers.size());
+    for (size_t i = 0; i < sleepers.size(); ++i)
+    {
+        ASSERT_EQ(0, mock_pthread_create(__FILE__, __LINE__, __func__, &threads[i], nullptr, sleepAndRecord,
+                                         &sleepers[i]));
+    }
+
+    // Pre-Assert
+
+    // Act
+    clock.advance(chrono::hours(24 * 5)); // [手順] - 6 日後の期限の手前まで進める。
+    const vector<pair<int64_t, size_t>> woken_in_range = woken;
+    const size_t pending = clock.pendingWaiters();
+    clock.advance(chrono::hours(24));
+    for (pthread_t thread : threads)
+    {
+        mock_pthread_join(__FILE__, __LINE__, __func__, thread, nullptr);
+    }
+    clock.detachCurrentThread();
+
+    // Assert
+    const vector<pair<int64_t, size_t>> expected = {{1 * ms, 1},    {64 * ms, 6}, {70 * ms, 3},
+                                                    {5000 * ms, 5}, {hour, 0},    {4 * day, 2}};
+    EXPECT_EQ(expected, woken_in_range); // [確認_正常系] - 期限の順に、期限の時刻に起床させること。
+    EXPECT_EQ(1U, pending);              // [確認_正常系] - advance の範囲外の期限は起床させないこと。
+    ASSERT_EQ(7U, woken.size());
+    EXPECT_EQ(make_pair(6 * day, (size_t)4), woken.back()); // [確認_正常系] - 次の advance で起床させること。
+}
+
+// 待機しない管理対象のスレッドがある場合に、ウォッチドッグがスレッド名を示してテストを失敗させることの確認
+TEST(virtualClockTest, watchdog_names_thread_that_never_waits)
+{
+    // Arrange
+    VirtualClock clock;
+    clock.attachCurrentThread();
+    clock.setWatchdogTimeout(chrono::milliseconds(100)); // [手順] - ウォッチドッグの時間を短くする。
+    std::atomic<int> state{0};
+    pthread_t thread;
+    ASSERT_EQ(0, mock_pthread_create(__FILE__, __LINE__, __func__, &thread, nullptr, spinUntilStopped, &state));
+    while (state.load() != 1)
+    {
+    }
+
+    // Pre-Assert
+
+    // Act & Assert
+    EXPECT_NONFATAL_FAILURE(clock.advance(chrono::seconds(1)), "(spinner)"); // [確認_異常系] - スレッド名を示すこと。
+    EXPECT_EQ(chrono::nanoseconds(0), clock.elapsed()); // [確認_異常系] - 仮想時刻を進めずに advance を終えること。
+    state.store(2);
+    mock_pthread_join(__FILE__, __LINE__, __func__, thread, nullptr);
+    clock.detachCurrentThread();
+}
+
+#endif // _WIN32
@@ -0,0 +1,341 @@
+#include <testfw.h>
+#include <mock_fcntl.h>
+#include <mock_stdio.h>
+#include <mock_unistd.h>
+#include <sys/mock_mman.h>
+#include <sys/mock_stat.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#ifndef _WIN32
+
+// fopen が返す FILE * を、mock を経由しない stdio 関数でも読み込めることの確認
+TEST(virtualFileSystemTest, fopen_returns_stream_usable_by_unrouted_stdio)
+{
+    // Arrange
+    VirtualFileSystem vfs("/vfs");
+    vfs.writeFile("/vfs/data.txt", "ab\ncd\n");
+    FILE *fp = mock_fopen(__FILE__, __LINE__, __func__, "/vfs/data.txt", "r");
+    ASSERT_NE(nullptr, fp);
+    char line[8] = {};
+
+    // Pre-Assert
+    EXPECT_EQ(1U, vfs.openFileCount());
+
+    // Act
+    const int first = fgetc(fp); // [手順] - mock を経由しない fgetc で読み込む。
+    errno = 0;
+    const int fd = fileno(fp); // [手順] - mock を経由しない fileno を呼び出す。
+    const int fileno_errno = errno;
+    char *const rest = mock_fgets(__FILE__, __LINE__, __func__, line, sizeof(line), fp); // [手順] - 続きを読み込む。
+    const int close_ret = mock_fclose(__FILE__, __LINE__, __func__, fp);
+
+    // Assert
+    EXPECT_EQ('a', first);              // [確認_正常系] - ファイル ツリーの内容を読み込むこと。
+    EXPECT_EQ(-1, fd);                  // [確認_正常系] - fileno はファイル記述子を持たないことを返すこと。
+    EXPECT_EQ(EBADF, fileno_errno);     // [確認_正常系] - fileno は EBADF を設定すること。
+    EXPECT_EQ(line, rest);              // [確認_正常系] - fgetc の続きから読み込むこと。
+    EXPECT_STREQ("b\n", line);          // [確認_正常系] - 1 行を読み込むこと。
+    EXPECT_EQ(0, close_ret);            // [確認_正常系] - fclose が成功すること。
+    EXPECT_EQ(0U, vfs.openFileCount()); // [確認_正常系] - 閉じた FILE * を数えないこと。
+}
+
+// mock を経由しない stdio 関数の書き込みを、直ちにファイル ツリーに反映することの確認
+TEST(virtualFileSystemTest, unrouted_writes_reach_the_tree_immediately)
+{
+    // Arrange
+    VirtualFileSystem vfs("/vfs");
+    FILE *fp = mock_fopen(__FILE__, __LINE__, __func__, "/vfs/out.txt", "w");
+    ASSERT_NE(nullptr, fp);
+    string contents;
+
+    // Pre-Assert
+
+    // Act
+    fputs("hello", fp); // [手順] - mock を経由しない fputs で書き込む。
+    fputc('!', fp);
+    const bool read_ok = vfs.readFile("/vfs/out.txt", &contents); // [手順] - 閉じる前に内容を取得する。
+    mock_fclose(__FILE__, __LINE__, __func__, fp);
+
+    // Assert
+    EXPECT_TRUE(read_ok);
+    EXPECT_EQ("hello!", contents); // [確認_正常系] - 閉じる前に書き込みを反映すること。
+}
+
+// VirtualFileSystem の破棄後も、保持している FILE * の読み込みが失敗し、fclose で閉じられることの確認
+TEST(virtualFileSystemTest, stream_held_after_teardown_can_be_closed)
+{
+    // Arrange
+    FILE *fp = nullptr;
+    {
+        VirtualFileSystem vfs("/vfs");
+        vfs.writeFile("/vfs/data.txt", "abc");
+        fp = mock_fopen(__FILE__, __LINE__, __func__, "/vfs/data.txt", "r");
+        ASSERT_NE(nullptr, fp);
+    } // [手順] - FILE * を閉じずに VirtualFileSystem を破棄する。
+
+    // Pre-Assert
+
+    // Act
+    const int read_ret = fgetc(fp); // [手順] - 破棄後に読み込む。
+    const bool has_error = ferror(fp) != 0;
+    const int close_ret = mock_fclose(__FILE__, __LINE__, __func__, fp); // [手順] - 破棄後に閉じる。
+
+    // Assert
+    EXPECT_EQ(EOF, read_ret); // [確認_異常系] - 閉じたファイルを読み込まないこと。
+    EXPECT_TRUE(has_error);   // [確認_異常系] - エラーとすること。
+    EXPECT_EQ(0, close_ret);  // [確認_正常系] - 破棄後も fclose で解放できること。
+}
+
+// スナップショットの保存後に開いているファイル記述子で書き込んだ内容を、restore で保存時の内容に戻すことの確認
+TEST(virtualFileSystemTest, restore_discards_writes_through_open_descriptor)
+{
+    // Arrange
+    VirtualFileSystem vfs("/vfs");
+    vfs.writeFile("/vfs/data.txt", "before");
+    const int fd = mock_open(__FILE__, __LINE__, __func__, "/vfs/data.txt", O_WRONLY, 0);
+    ASSERT_LE(0, fd);
+    const auto saved = vfs.snapshot(); // [手順] - ファイルを開いたままスナップショットを保存する。
+    string modified;
+    string restored;
+    string restored_again;
+
+    // Pre-Assert
+
+    // Act
+    const ssize_t write_ret = mock_write(__FILE__, __LINE__, __func__, fd, "AFTER!", 6); // [手順] - 保存後に書き込む。
+    vfs.readFile("/vfs/data.txt", &modified);
+    vfs.restore(saved); // [手順] - 保存時のファイル ツリーに戻す。
+    vfs.readFile("/vfs/data.txt", &restored);
+    mock_write(__FILE__, __LINE__, __func__, fd, "X", 1); // [手順] - 戻した後に、戻す前のファイルに書き込む。
+    vfs.restore(saved);                                   // [手順] - 同じスナップショットに再度戻す。
+    vfs.readFile("/vfs/data.txt", &restored_again);
+    mock_close(__FILE__, __LINE__, __func__, fd);
+
+    // Assert
+    EXPECT_EQ(6, write_ret);
+    EXPECT_EQ("AFTER!", modified);       // [確認_正常系] - 保存後の書き込みをファイル ツリーに反映すること。
+    EXPECT_EQ("before", restored);       // [確認_正常系] - 保存時の内容に戻すこと。
+    EXPECT_EQ("before", restored_again); // [確認_正常系] - スナップショットは以降の書き込みで変わらないこと。
+}
+
+// 開いた後に rename したファイルへの書き込みを、スナップショットと共有せずに rename 先へ反映することの確認
+TEST(virtualFileSystemTest, write_after_snapshot_follows_renamed_path)
+{
+    // Arrange
+    VirtualFileSystem vfs("/vfs");
+    vfs.makeDirectories("/vfs/old");
+    vfs.writeFile("/vfs/old/data.txt", "abc");
+    FILE *fp = mock_fopen(__FILE__, __LINE__, __func__, "/vfs/old/data.txt", "a");
+    ASSERT_NE(nullptr, fp);
+    ASSERT_EQ(0, mock_rename(__FILE__, __LINE__, __func__, "/vfs/old", "/vfs/new")); // [手順] - 開いたまま移動する。
+    const auto saved = vfs.snapshot();
+    string renamed;
+    string restored;
+
+    // Pre-Assert
+
+    // Act
+    fputs("def", fp); // [手順] - 保存後に、rename 前のパスで開いた FILE * で書き込む。
+    vfs.readFile("/vfs/new/data.txt", &renamed);
+    mock_fclose(__FILE__, __LINE__, __func__, fp);
+    vfs.restore(saved);
+    vfs.readFile("/vfs/new/data.txt", &restored);
+
+    // Assert
+    EXPECT_EQ("abcdef", renamed);                  // [確認_正常系] - rename 先に書き込みを反映すること。
+    EXPECT_FALSE(vfs.exists("/vfs/old/data.txt")); // [確認_正常系] - rename 前のパスに作成しないこと。
+    EXPECT_EQ("abc", restored);                    // [確認_正常系] - スナップショットの内容は変わらないこと。
+}
+
+// MAP_SHARED のマッピングへの書き込みを、msync と munmap でファイルに書き戻すことの確認
+TEST(virtualFileSystemTest, shared_mapping_writes_back_on_msync_and_munmap)
+{
+    // Arrange
+    VirtualFileSystem vfs("/vfs");
+    vfs.writeFile("/vfs/data.bin", string(8192, 'a'));
+    const int fd = mock_open(__FILE__, __LINE__, __func__, "/vfs/data.bin", O_RDWR, 0);
+    ASSERT_LE(0, fd);
+    char *const addr = static_cast<char *>(
+        mock_mmap(__FILE__, __LINE__, __func__, nullptr, 8192, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0));
+    ASSERT_NE(MAP_FAILED, static_cast<void *>(addr));
+    mock_close(__FILE__, __LINE__, __func__, fd); // [手順] - ファイル記述子を閉じてもマッピングは有効とする。
+    string before_sync;
+    string after_sync;
+    string after_unmap;
+
+    // Pre-Assert
+    EXPECT_EQ('a', addr[4096]); // [確認_正常系] - ファイルの内容をマップすること。
+
+    // Act
+    memcpy(addr, "head", 4); // [手順] - 先頭のページに書き込む。
+    vfs.readFile("/vfs/data.bin", &before_sync);
+    const int msync_ret = mock_msync(__FILE__, __LINE__, __func__, addr, 4096, MS_SYNC);
+    vfs.readFile("/vfs/data.bin", &after_sync);
+    memcpy(addr + 4096, "tail", 4); // [手順] - msync していないページに書き込む。
+    const VirtualMappingStats mapped_stats = vfs.mappingStats();
+    const int munmap_ret = mock_munmap(__FILE__, __LINE__, __func__, addr, 8192);
+    vfs.readFile("/vfs/data.bin", &after_unmap);
+
+    // Assert
+    EXPECT_EQ("aaaa", before_sync.substr(0, 4)); // [確認_正常系] - msync 前はファイルに反映しないこと。
+    EXPECT_EQ(0, msync_ret);
+    EXPECT_EQ("head", after_sync.substr(0, 4)); // [確認_正常系] - msync でファイルに書き戻すこと。
+    EXPECT_EQ(0, munmap_ret);
+    EXPECT_EQ("head", after_unmap.substr(0, 4));
+    EXPECT_EQ("tail", after_unmap.substr(4096, 4)); // [確認_正常系] - munmap で残りの変更を書き戻すこと。
+    EXPECT_EQ(8192U, after_unmap.size());           // [確認_正常系] - ファイルの大きさを変えないこと。
+    EXPECT_EQ(1U, mapped_stats.maps);
+    EXPECT_EQ(8192U, mapped_stats.mapped_bytes);
+    const VirtualMappingStats unmapped_stats = vfs.mappingStats();
+    EXPECT_EQ(1U, unmapped_stats.unmaps);
+    EXPECT_EQ(1U, unmapped_stats.msyncs);
+    EXPECT_EQ(0U, unmapped_stats.mapped_bytes); // [確認_正常系] - munmap でマップ中のバイト数から除くこと。
+}
+
+// MAP_PRIVATE のマッピングへの書き込みを、ファイルに書き戻さないことの確認
+TEST(virtualFileSystemTest, private_mapping_writes_stay_private)
+{
+    // Arrange
+    VirtualFileSystem vfs("/vfs");
+    vfs.writeFile("/vfs/data.bin", "0123456789");
+    const int fd = mock_open(__FILE__, __LINE__, __func__, "/vfs/data.bin", O_RDONLY, 0);
+    ASSERT_LE(0, fd);
+    string contents;
+
+    // Pre-Assert
+
+    // Act
+    char *const addr = static_cast<char *>(
+        mock_mmap(__FILE__, __LINE__, __func__, nullptr, 10, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0));
+    ASSERT_NE(MAP_FAILED, static_cast<void *>(addr));
+    const string mapped(addr, 10);
+    addr[0] = 'X'; // [手順] - 読み込み専用で開いたファイルの MAP_PRIVATE のマッピングに書き込む。
+    mock_munmap(__FILE__, __LINE__, __func__, addr, 10);
+    mock_close(__FILE__, __LINE__, __func__, fd);
+    vfs.readFile("/vfs/data.bin", &contents);
+
+    // Assert
+    EXPECT_EQ("0123456789", mapped);   // [確認_正常系] - ファイルの内容をマップすること。
+    EXPECT_EQ("0123456789", contents); // [確認_正常系] - MAP_PRIVATE の変更はファイルに反映しないこと。
+    EXPECT_EQ(0U, vfs.mappingStats().written_back_bytes);
+}
+
+// 巨大な生成ファイルの任意の位置を、書き込んだ範囲を重ねて読み込めることの確認
+TEST(virtualFileSystemTest, synthetic_file_reads_generated_and_written_ranges)
+{
+    // Arrange
+    const uint64_t size = 1ULL << 40; // [手順] - メモリーに保持できない 1 TiB のファイルを作成する。
+    VirtualFileSystem vfs("/vfs");
+    ASSERT_TRUE(vfs.writeSyntheticFile("/vfs/huge.bin", size, SyntheticFileContent::repeat("0123456789")));
+    const int fd = mock_open(__FILE__, __LINE__, __func__, "/vfs/huge.bin", O_RDWR, 0);
+    ASSERT_LE(0, fd);
+    struct stat st = {};
+    char generated[8] = {};
+    char overlaid[8] = {};
+    char tail[8] = {};
+
+    // Pre-Assert
+    ASSERT_EQ(0, mock_fstat(__FILE__, __LINE__, __func__, fd, &st));
+    EXPECT_EQ((off_t)size, st.st_size); // [確認_正常系] - 指定した大きさとすること。
+
+    // Act
+    const off_t offset = (off_t)(size - 1006); // 10 の倍数の位置 (2^40 は 10 で割ると 6 余る)
+    mock_lseek(__FILE__, __LINE__, __func__, fd, offset, SEEK_SET);
+    const ssize_t read_ret = mock_read(__FILE__, __LINE__, __func__, fd, generated, sizeof(generated));
+    mock_lseek(__FILE__, __LINE__, __func__, fd, offset + 2, SEEK_SET);
+    mock_write(__FILE__, __LINE__, __func__, fd, "ab", 2); // [手順] - 生成した範囲の途中に書き込む。
+    mock_lseek(__FILE__, __LINE__, __func__, fd, offset, SEEK_SET);
+    mock_read(__FILE__, __LINE__, __func__, fd, overlaid, sizeof(overlaid));
+    mock_lseek(__FILE__, __LINE__, __func__, fd, (off_t)size - 2, SEEK_SET);
+    const ssize_t tail_ret = mock_read(__FILE__, __LINE__, __func__, fd, tail, sizeof(tail)); // [手順] - 終端まで読む。
+    mock_close(__FILE__, __LINE__, __func__, fd);
+
+    // Assert
+    EXPECT_EQ(8, read_ret);
+    EXPECT_EQ(string("01234567"), string(generated, 8)); // [確認_正常系] - 位置に応じた内容を生成すること。
+    EXPECT_EQ(string("01ab4567"), string(overlaid, 8));  // [確認_正常系] - 書き込んだ範囲のみ置き換えること。
+    EXPECT_EQ(2, tail_ret);                              // [確認_正常系] - 終端までの大きさのみ読み込むこと。
+    EXPECT_EQ(string("45"), string(tail, 2));
+}
+
+// ftruncate で縮めた後に伸ばした範囲を 0 とし、生成した内容を復活させないことの確認
+TEST(virtualFileSystemTest, synthetic_file_regrown_range_is_zero)
+{
+    // Arrange
+    VirtualFileSystem vfs("/vfs");
+    ASSERT_TRUE(vfs.writeSyntheticFile("/vfs/data.bin", 16, SyntheticFileContent::constant('x')));
+    const int fd = mock_open(__FILE__, __LINE__, __func__, "/vfs/data.bin", O_RDWR, 0);
+    ASSERT_LE(0, fd);
+    string contents;
+
+    // Pre-Assert
+
+    // Act
+    mock_ftruncate(__FILE__, __LINE__, __func__, fd, 4); // [手順] - 縮める。
+    mock_ftruncate(__FILE__, __LINE__, __func__, fd, 8); // [手順] - 元の大きさより小さく伸ばす。
+    mock_close(__FILE__, __LINE__, __func__, fd);
+    vfs.readFile("/vfs/data.bin", &contents);
+
+    // Assert
+    EXPECT_EQ(string("xxxx") + string(4, '\0'), contents); // [確認_正常系] - 伸ばした範囲は 0 とすること。
+}
+
+// レコード生成関数と counter が、読み込む位置に関わらず同じ内容を生成することの確認
+TEST(virtualFileSystemTest, synthetic_content_is_position_independent)
+{
+    // Arrange
+    const SyntheticFileContent records =
+        SyntheticFileContent::records(4, [](uint64_t index, char *record) { memset(record, 'a' + (int)index, 4); });
+    const SyntheticFileContent counter = SyntheticFileContent::counter(7);
+    char whole[12] = {};
+    char part[5] = {};
+    uint64_t value = 0;
+
+    // Pre-Assert
+
+    // Act
+    records.generate(0, whole, sizeof(whole));
+    records.generate(3, part, sizeof(part)); // [手順] - レコードの途中から、レコードをまたいで生成する。
+    counter.generate(8 * 5, reinterpret_cast<char *>(&value), sizeof(value));
+
+    // Assert
+    EXPECT_EQ(string("aaaabbbbcccc"), string(whole, sizeof(whole)));
+    EXPECT_EQ(string("abbbb"), string(part, sizeof(part))); // [確認_正常系] - 途中から生成しても同じ内容とすること。
+    EXPECT_EQ(12U, value);                                  // [確認_正常系] - 8 バイトごとに 1 ずつ増えること。
+}
+
+// 合成ファイルの mmap は、生成する範囲が上限を超える場合に ENOMEM で失敗し、上限以内の範囲はマップすることの確認
+TEST(virtualFileSystemTest, synthetic_mapping_over_limit_fails_with_enomem)
+{
+    // Arrange
+    const uint64_t size = 1ULL << 40;
+    VirtualFileSystem vfs("/vfs");
+    ASSERT_TRUE(vfs.writeSyntheticFile("/vfs/huge.bin", size, SyntheticFileContent::repeat("0123456789")));
+    const int fd = mock_open(__FILE__, __LINE__, __func__, "/vfs/huge.bin", O_RDONLY, 0);
+    ASSERT_LE(0, fd);
+    const size_t over_limit = (size_t)VirtualFileSystem::MAX_SYNTHETIC_MAP_SIZE + 4096U;
+
+    // Pre-Assert
+
+    // Act
+    errno = 0;
+    void *const over = mock_mmap(__FILE__, __LINE__, __func__, nullptr, over_limit, PROT_READ, MAP_PRIVATE, fd, 0);
+    const int over_errno = errno;
+    char *const window = static_cast<char *>(
+        mock_mmap(__FILE__, __LINE__, __func__, nullptr, 4096, PROT_READ, MAP_PRIVATE, fd, (off_t)(size - 4096U)));
+    ASSERT_NE(MAP_FAILED, static_cast<void *>(window)); // [手順] - 末尾の 1 ページのみをマップする。
+    const string tail(window + 4096 - 6, 6);
+    mock_munmap(__FILE__, __LINE__, __func__, window, 4096);
+    mock_close(__FILE__, __LINE__, __func__, fd);
+
+    // Assert
+    EXPECT_EQ(MAP_FAILED, over);            // [確認_異常系] - 上限を超える範囲はマップしないこと。
+    EXPECT_EQ(ENOMEM, over_errno);          // [確認_異常系] - errno を ENOMEM とすること。
+    EXPECT_EQ("012345", tail);              // [確認_正常系] - 上限以内の範囲は生成した内容をマップすること。
+    EXPECT_EQ(1U, vfs.mappingStats().maps); // [確認_正常系] - 失敗した mmap は数えないこと。
+}
+
+#endif // _WIN32
@@ -0,0 +1,108 @@
+#include <testfw.h>
+#include <mock_unistd.h>
+#include <sys/mock_socket.h>
+
+#include <cerrno>
+#include <cstring>
+
+#ifndef _WIN32
+    #include <arpa/inet.h>
+    #include <netinet/in.h>
+#endif
+
+#ifndef _WIN32
+
+namespace
+{
+
+struct sockaddr_in loopback(uint16_t port)
+{
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    return address;
+}
+
+int bindTo(int fd, uint16_t port)
+{
+    const struct sockaddr_in address = loopback(port);
+    return mock_bind(__FILE__, __LINE__, __func__, fd, reinterpret_cast<const struct sockaddr *>(&address),
+                     sizeof(address));
+}
+
+} // namespace
+
+// ループバックのアドレスに listen したソケットへ connect し、双方向に送受信できることの確認
+TEST(virtualNetworkTest, loopback_connect_send_and_recv)
+{
+    // Arrange
+    VirtualNetwork network;
+    const int server = mock_socket(__FILE__, __LINE__, __func__, AF_INET, SOCK_STREAM, 0);
+    ASSERT_LE(0, server);
+    ASSERT_EQ(0, bindTo(server, 8080));
+    ASSERT_EQ(0, mock_listen(__FILE__, __LINE__, __func__, server, 1));
+    const int client = mock_socket(__FILE__, __LINE__, __func__, AF_INET, SOCK_STREAM, 0);
+    ASSERT_LE(0, client);
+    const struct sockaddr_in address = loopback(8080);
+    char request[16] = {};
+    char response[16] = {};
+
+    // Pre-Assert
+
+    // Act
+    const int connect_ret = mock_connect(__FILE__, __LINE__, __func__, client,
+                                         reinterpret_cast<const struct sockaddr *>(&address), sizeof(address));
+    const int accepted = mock_accept(__FILE__, __LINE__, __func__, server, nullptr, nullptr);
+    const ssize_t send_ret = mock_send(__FILE__, __LINE__, __func__, client, "hello", 5, 0); // [手順] - 送信する。
+    const ssize_t recv_ret = mock_recv(__FILE__, __LINE__, __func__, accepted, request, sizeof(request), 0);
+    mock_send(__FILE__, __LINE__, __func__, accepted, "world", 5, 0); // [手順] - 応答を送信する。
+    const ssize_t reply_ret = mock_recv(__FILE__, __LINE__, __func__, client, response, sizeof(response), 0);
+    mock_close(__FILE__, __LINE__, __func__, accepted); // [手順] - 接続を閉じる。
+    const ssize_t eof_ret = mock_recv(__FILE__, __LINE__, __func__, client, response, sizeof(response), 0);
+    mock_close(__FILE__, __LINE__, __func__, client);
+    mock_close(__FILE__, __LINE__, __func__, server);
+
+    // Assert
+    EXPECT_EQ(0, connect_ret); // [確認_正常系] - listen したアドレスに接続できること。
+    EXPECT_LE(0, accepted);    // [確認_正常系] - 接続を受け付けること。
+    EXPECT_EQ(5, send_ret);
+    EXPECT_EQ(5, recv_ret);
+    EXPECT_STREQ("hello", request); // [確認_正常系] - 送信した内容を受信すること。
+    EXPECT_EQ(5, reply_ret);
+    EXPECT_STREQ("world", response);          // [確認_正常系] - 逆方向にも送受信できること。
+    EXPECT_EQ(0, eof_ret);                    // [確認_正常系] - 相手が閉じた後は EOF とすること。
+    EXPECT_EQ(0U, network.openSocketCount()); // [確認_正常系] - 閉じたソケットを数えないこと。
+    EXPECT_EQ(1U, network.stats().connections);
+    EXPECT_EQ(10U, network.stats().stream_bytes);
+}
+
+// 使用中のアドレスへの bind が EADDRINUSE で失敗し、閉じた後は bind できることの確認
+TEST(virtualNetworkTest, bind_to_address_in_use_fails_until_closed)
+{
+    // Arrange
+    VirtualNetwork network;
+    const int first = mock_socket(__FILE__, __LINE__, __func__, AF_INET, SOCK_STREAM, 0);
+    const int second = mock_socket(__FILE__, __LINE__, __func__, AF_INET, SOCK_STREAM, 0);
+    ASSERT_LE(0, first);
+    ASSERT_LE(0, second);
+    ASSERT_EQ(0, bindTo(first, 9000));
+
+    // Pre-Assert
+
+    // Act
+    errno = 0;
+    const int in_use_ret = bindTo(second, 9000); // [手順] - 使用中のアドレスに bind する。
+    const int in_use_errno = errno;
+    mock_close(__FILE__, __LINE__, __func__, first); // [手順] - 使用中のソケットを閉じる。
+    const int rebind_ret = bindTo(second, 9000);
+    mock_close(__FILE__, __LINE__, __func__, second);
+
+    // Assert
+    EXPECT_EQ(-1, in_use_ret);           // [確認_異常系] - 失敗すること。
+    EXPECT_EQ(EADDRINUSE, in_use_errno); // [確認_異常系] - EADDRINUSE とすること。
+    EXPECT_EQ(0, rebind_ret);            // [確認_正常系] - 閉じた後は bind できること。
+}
+
+#endif // _WIN32
@@ -0,0 +1,113 @@
+#include <testfw.h>
+#include <mock_netdb.h>
+
+#include <cstring>
+
+#ifndef _WIN32
+    #include <arpa/inet.h>
+    #include <netinet/in.h>
+#endif
+
+#ifndef _WIN32
+
+namespace
+{
+
+// addrinfo のアドレスを "address:port" の形式にする
+string formatAddress(const struct addrinfo *info)
+{
+    char text[INET6_ADDRSTRLEN] = "";
+    uint16_t port = 0;
+    if (info->ai_family == AF_INET)
+    {
+        const struct sockaddr_in *address = reinterpret_cast<const struct sockaddr_in *>(info->ai_addr);
+        inet_ntop(AF_INET, &address->sin_addr, text, sizeof(text));
+        port = ntohs(address->sin_port);
+    }
+    else if (info->ai_family == AF_INET6)
+    {
+        const struct sockaddr_in6 *address = reinterpret_cast<const struct sockaddr_in6 *>(info->ai_addr);
+        inet_ntop(AF_INET6, &address->sin6_addr, text, sizeof(text));
+        port = ntohs(address->sin6_port);
+    }
+    return string(text) + ":" + std::to_string(port);
+}
+
+} // namespace
+
+// 表に登録した名前を、登録順のアドレスと指定したポートで解決することの確認
+TEST(virtualResolverTest, getaddrinfo_returns_table_entries_in_order)
+{
+    // Arrange
+    VirtualResolver resolver;
+    resolver.addHost("db.example.test", "192.0.2.10").addHost("db.example.test", "2001:db8::10");
+    resolver.loadHosts("192.0.2.20 api.example.test api # 別名付き\n"); // [手順] - hosts 形式で別名を登録する。
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_socktype = SOCK_STREAM;
+    struct addrinfo *db = nullptr;
+    struct addrinfo *api = nullptr;
+
+    // Pre-Assert
+
+    // Act
+    const int db_ret = mock_getaddrinfo(__FILE__, __LINE__, __func__, "db.example.test", "5432", &hints, &db);
+    hints.ai_flags = AI_CANONNAME; // [手順] - 正式名を要求して、別名で解決する。
+    const int api_ret = mock_getaddrinfo(__FILE__, __LINE__, __func__, "api", "443", &hints, &api);
+    vector<string> db_addresses;
+    for (const struct addrinfo *info = db; info != nullptr; info = info->ai_next)
+    {
+        db_addresses.push_back(formatAddress(info));
+    }
+    const string api_address = api != nullptr ? formatAddress(api) : "";
+    const string api_canonname = api != nullptr && api->ai_canonname != nullptr ? api->ai_canonname : "";
+    const size_t outstanding = resolver.outstandingResults();
+    mock_freeaddrinfo(__FILE__, __LINE__, __func__, db);
+    mock_freeaddrinfo(__FILE__, __LINE__, __func__, api);
+
+    // Assert
+    EXPECT_EQ(0, db_ret);
+    const vector<string> expected = {"192.0.2.10:5432", "2001:db8::10:5432"};
+    EXPECT_EQ(expected, db_addresses); // [確認_正常系] - 登録順のアドレスとすること。
+    EXPECT_EQ(0, api_ret);
+    EXPECT_EQ("192.0.2.20:443", api_address);
+    EXPECT_EQ("api.example.test", api_canonname);           // [確認_正常系] - 正式名を返すこと。
+    EXPECT_EQ(1U, resolver.lookupCount("db.example.test")); // [確認_正常系] - 名前ごとに解決の回数を数えること。
+    EXPECT_EQ(2U, resolver.totalLookups());
+    EXPECT_EQ(2U, outstanding);                   // [確認_正常系] - 返した結果を数えること。
+    EXPECT_EQ(0U, resolver.outstandingResults()); // [確認_正常系] - freeaddrinfo で解放すること。
+}
+
+// 表に無い名前と、失敗を設定した名前の解決が失敗することの確認
+TEST(virtualResolverTest, getaddrinfo_fails_for_missing_and_failing_names)
+{
+    // Arrange
+    VirtualResolver resolver;
+    resolver.addHost("flaky.example.test", "192.0.2.30");
+    resolver.failLookups("flaky.*", EAI_AGAIN, 1); // [手順] - 1 回のみ EAI_AGAIN で失敗させる。
+    struct addrinfo *missing = nullptr;
+    struct addrinfo *first = nullptr;
+    struct addrinfo *second = nullptr;
+
+    // Pre-Assert
+
+    // Act
+    const int missing_ret = mock_getaddrinfo(__FILE__, __LINE__, __func__, "missing.example.test", nullptr, nullptr,
+                                             &missing);
+    const int first_ret =
+        mock_getaddrinfo(__FILE__, __LINE__, __func__, "flaky.example.test", nullptr, nullptr, &first);
+    const int second_ret =
+        mock_getaddrinfo(__FILE__, __LINE__, __func__, "flaky.example.test", nullptr, nullptr, &second);
+    if (second != nullptr)
+    {
+        mock_freeaddrinfo(__FILE__, __LINE__, __func__, second);
+    }
+
+    // Assert
+    EXPECT_EQ(EAI_NONAME, missing_ret); // [確認_異常系] - 表に無い名前は EAI_NONAME とすること。
+    EXPECT_EQ(EAI_AGAIN, first_ret);    // [確認_異常系] - 設定したエラーで失敗させること。
+    EXPECT_EQ(0, second_ret);           // [確認_正常系] - 設定した回数の後は表から解決すること。
+    EXPECT_EQ(2U, resolver.lookupCount("flaky.example.test"));
+}
+
+#endif // _WIN32
@@ -0,0 +1,105 @@
+#include <testfw.h>
+#include <virtualSftpServer.h>
+
+#include <fcntl.h>
+
+#ifndef _WIN32
+
+namespace
+{
+
+class virtualSftpServerTest : public Test
+{
+  protected:
+    void SetUp() override
+    {
+        session_ = mock_ssh_new(__FILE__, __LINE__, __func__);
+        sftp_ = mock_sftp_new(__FILE__, __LINE__, __func__, session_);
+        ASSERT_NE(nullptr, sftp_);
+        ASSERT_EQ(0, mock_sftp_init(__FILE__, __LINE__, __func__, sftp_));
+    }
+
+    void TearDown() override
+    {
+        mock_sftp_free(__FILE__, __LINE__, __func__, sftp_);
+        mock_ssh_free(__FILE__, __LINE__, __func__, session_);
+    }
+
+    ssh_session session_ = nullptr;
+    sftp_session sftp_ = nullptr;
+};
+
+} // namespace
+
+// 登録したファイルを sftp_open / sftp_read で読み込み、sftp_stat で属性を取得できることの確認
+TEST_F(virtualSftpServerTest, open_read_and_stat_registered_file)
+{
+    // Arrange
+    VirtualSftpServer server;
+    server.addFile("/data/in.txt", "hello world", 0640); // [手順] - 途中のディレクトリを含めて作成する。
+    server.limitTransferSize(8);                         // [手順] - 1 回の読み込みを 8 バイトまでとする。
+    string content;
+    char buffer[32];
+
+    // Pre-Assert
+
+    // Act
+    sftp_file file = mock_sftp_open(__FILE__, __LINE__, __func__, sftp_, "/data/../data/in.txt", O_RDONLY, 0);
+    ASSERT_NE(nullptr, file);
+    ssize_t read_ret;
+    vector<ssize_t> read_sizes;
+    while ((read_ret = mock_sftp_read(__FILE__, __LINE__, __func__, file, buffer, sizeof(buffer))) > 0)
+    {
+        read_sizes.push_back(read_ret);
+        content.append(buffer, (size_t)read_ret);
+    }
+    const uint64_t handles_while_open = server.stats().open_handles;
+    const int close_ret = mock_sftp_close(__FILE__, __LINE__, __func__, file);
+    sftp_attributes attributes = mock_sftp_stat(__FILE__, __LINE__, __func__, sftp_, "/data/in.txt");
+    ASSERT_NE(nullptr, attributes);
+    const uint8_t type = attributes->type;
+    const uint64_t size = attributes->size;
+    const uint32_t permissions = attributes->permissions;
+    mock_sftp_attributes_free(__FILE__, __LINE__, __func__, attributes);
+
+    // Assert
+    EXPECT_EQ("hello world", content);              // [確認_正常系] - パスを正規化して内容を読み込むこと。
+    EXPECT_EQ(vector<ssize_t>({8, 3}), read_sizes); // [確認_正常系] - 転送の最大バイト数ずつ読み込むこと。
+    EXPECT_EQ(0, read_ret);                         // [確認_正常系] - 終端では 0 を返すこと。
+    EXPECT_EQ(1U, handles_while_open);
+    EXPECT_EQ(0, close_ret);
+    EXPECT_EQ(SSH_FILEXFER_TYPE_REGULAR, type); // [確認_正常系] - 種類を返すこと。
+    EXPECT_EQ(11U, size);                       // [確認_正常系] - 大きさを返すこと。
+    EXPECT_EQ(0100640U, permissions);           // [確認_正常系] - 種類のビットを含むパーミッションを返すこと。
+    const VirtualSftpStats stats = server.stats();
+    EXPECT_EQ(1U, stats.opens);
+    EXPECT_EQ(11U, stats.bytes_read);
+    EXPECT_EQ(0U, stats.open_handles); // [確認_正常系] - 閉じたハンドルを数えないこと。
+}
+
+// 存在しないファイルと、読み込みの権限が無いファイルの sftp_open が、SSH_FX_* を設定して失敗することの確認
+TEST_F(virtualSftpServerTest, open_reports_missing_and_unreadable_files)
+{
+    // Arrange
+    VirtualSftpServer server;
+    server.addFile("/secret.txt", "top secret", 0200); // [手順] - 所有者の読み込みの権限を外す。
+
+    // Pre-Assert
+
+    // Act
+    sftp_file missing = mock_sftp_open(__FILE__, __LINE__, __func__, sftp_, "/missing.txt", O_RDONLY, 0);
+    const int missing_error = mock_sftp_get_error(__FILE__, __LINE__, __func__, sftp_);
+    sftp_file secret = mock_sftp_open(__FILE__, __LINE__, __func__, sftp_, "/secret.txt", O_RDONLY, 0);
+    const int secret_error = mock_sftp_get_error(__FILE__, __LINE__, __func__, sftp_);
+    sftp_attributes attributes = mock_sftp_stat(__FILE__, __LINE__, __func__, sftp_, "/missing.txt");
+
+    // Assert
+    EXPECT_EQ(nullptr, missing);
+    EXPECT_EQ(SSH_FX_NO_SUCH_FILE, missing_error); // [確認_異常系] - 存在しない場合の値とすること。
+    EXPECT_EQ(nullptr, secret);
+    EXPECT_EQ(SSH_FX_PERMISSION_DENIED, secret_error); // [確認_異常系] - 権限が無い場合の値とすること。
+    EXPECT_EQ(nullptr, attributes);                    // [確認_異常系] - sftp_stat も失敗すること。
+    EXPECT_EQ(0U, server.stats().opens);
+}
+
+#endif // _WIN32